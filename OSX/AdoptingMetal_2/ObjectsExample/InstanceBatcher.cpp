@@ -0,0 +1,394 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Compact per-object constants and automatic instancing. ObjectData is padded to 256 bytes, so 200k
+ objects with three frames in flight take about 150 MB of constant buffers, and every object is
+ drawn on its own. Objects here are kept in structure-of-arrays form sorted by (pipeline, mesh),
+ each frame writes one 48 byte InstanceData record per object and every run of objects sharing a
+ pipeline and a mesh becomes one instanced draw.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "InstanceBatcher.h"
+
+#if defined(__APPLE__)
+    #include "SharedObjectsBridge.h"
+
+    static_assert(sizeof(InstanceData) == sizeof(Objects::Instance), "InstanceData layout mismatch");
+#endif
+
+static_assert(sizeof(Objects::Instance) == 48, "Instance records are 48 bytes");
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace Objects
+{
+    static uint64_t key(const uint32_t& pipeline, const uint32_t& mesh)
+    {
+        return (uint64_t(pipeline) << 32) | uint64_t(mesh);
+    }
+
+    static uint32_t unorm8(const float& value)
+    {
+        const float clamped = std::min(std::max(value, 0.0f), 1.0f);
+
+        return uint32_t(clamped * 255.0f + 0.5f);
+    }
+
+    // Reorder values so that element i comes from source[i]
+    template <typename T>
+    static void gather(std::vector<T>& rValues, const std::vector<uint32_t>& source)
+    {
+        std::vector<T> result(rValues.size());
+
+        for(size_t i = 0; i < rValues.size(); ++i)
+        {
+            result[i] = rValues[source[i]];
+        }
+
+        rValues.swap(result);
+    }
+} // Objects
+
+#pragma mark -
+#pragma mark Public - Records
+
+uint32_t Objects::packColor(const float& r, const float& g, const float& b, const float& a)
+{
+    return unorm8(r) | (unorm8(g) << 8) | (unorm8(b) << 16) | (unorm8(a) << 24);
+}
+
+void Objects::quaternion(const Float3& angles, float* pQuaternion)
+{
+    const float sx = std::sin(0.5f * angles.x);
+    const float cx = std::cos(0.5f * angles.x);
+    const float sy = std::sin(0.5f * angles.y);
+    const float cy = std::cos(0.5f * angles.y);
+    const float sz = std::sin(0.5f * angles.z);
+    const float cz = std::cos(0.5f * angles.z);
+
+    // qz * qy * qx expanded
+    pQuaternion[0] = cz * cy * sx - sz * sy * cx;
+    pQuaternion[1] = cz * sy * cx + sz * cy * sx;
+    pQuaternion[2] = sz * cy * cx - cz * sy * sx;
+    pQuaternion[3] = cz * cy * cx + sz * sy * sx;
+}
+
+void Objects::localToWorld(const Instance& rInstance, float* pMatrix)
+{
+    const float x = rInstance.rotation[0];
+    const float y = rInstance.rotation[1];
+    const float z = rInstance.rotation[2];
+    const float w = rInstance.rotation[3];
+
+    const float columns[3][3] =
+    {
+        {1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z),        2.0f * (x * z - w * y)},
+        {2.0f * (x * y - w * z),        1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x)},
+        {2.0f * (x * z + w * y),        2.0f * (y * z - w * x),        1.0f - 2.0f * (x * x + y * y)}
+    };
+
+    for(size_t c = 0; c < 3; ++c)
+    {
+        pMatrix[4 * c + 0] = columns[c][0] * rInstance.scale[c];
+        pMatrix[4 * c + 1] = columns[c][1] * rInstance.scale[c];
+        pMatrix[4 * c + 2] = columns[c][2] * rInstance.scale[c];
+        pMatrix[4 * c + 3] = 0.0f;
+    }
+
+    pMatrix[12] = rInstance.translation[0];
+    pMatrix[13] = rInstance.translation[1];
+    pMatrix[14] = rInstance.translation[2];
+    pMatrix[15] = 1.0f;
+}
+
+#pragma mark -
+#pragma mark Public - Batcher
+
+Objects::InstanceBatcher::InstanceBatcher()
+: mbDirty(false)
+{
+}
+
+void Objects::InstanceBatcher::reserve(const size_t& count)
+{
+    m_Pipeline.reserve(count);
+    m_Mesh.reserve(count);
+    m_Handle.reserve(count);
+    m_Color.reserve(count);
+    m_Index.reserve(count);
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        m_Position[i].reserve(count);
+        m_Scale[i].reserve(count);
+        m_Rotation[i].reserve(count);
+        m_RotationRate[i].reserve(count);
+    }
+}
+
+void Objects::InstanceBatcher::clear()
+{
+    m_Pipeline.clear();
+    m_Mesh.clear();
+    m_Handle.clear();
+    m_Color.clear();
+    m_Index.clear();
+    m_Batches.clear();
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        m_Position[i].clear();
+        m_Scale[i].clear();
+        m_Rotation[i].clear();
+        m_RotationRate[i].clear();
+    }
+
+    mbDirty = false;
+}
+
+Objects::InstanceBatcher::Handle Objects::InstanceBatcher::add(const uint32_t& pipeline,
+                                                               const uint32_t& mesh,
+                                                               const Float3& position,
+                                                               const Float3& scale,
+                                                               const Float3& rotationRate,
+                                                               const uint32_t& color)
+{
+    const Handle handle = Handle(m_Index.size());
+
+    // Appending to the last batch keeps the order sorted
+    if(m_Batches.empty() || (m_Batches.back().pipeline != pipeline) || (m_Batches.back().mesh != mesh))
+    {
+        mbDirty = true;
+    }
+    else if(!mbDirty)
+    {
+        m_Batches.back().instanceCount++;
+    }
+
+    m_Index.push_back(uint32_t(m_Handle.size()));
+
+    m_Pipeline.push_back(pipeline);
+    m_Mesh.push_back(mesh);
+    m_Handle.push_back(handle);
+    m_Color.push_back(color);
+
+    m_Position[0].push_back(position.x);
+    m_Position[1].push_back(position.y);
+    m_Position[2].push_back(position.z);
+
+    m_Scale[0].push_back(scale.x);
+    m_Scale[1].push_back(scale.y);
+    m_Scale[2].push_back(scale.z);
+
+    m_RotationRate[0].push_back(rotationRate.x);
+    m_RotationRate[1].push_back(rotationRate.y);
+    m_RotationRate[2].push_back(rotationRate.z);
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        m_Rotation[i].push_back(0.0f);
+    }
+
+    return handle;
+}
+
+void Objects::InstanceBatcher::setMaterial(const Handle& handle, const uint32_t& pipeline, const uint32_t& mesh)
+{
+    const uint32_t index = m_Index[handle];
+
+    if((m_Pipeline[index] != pipeline) || (m_Mesh[index] != mesh))
+    {
+        m_Pipeline[index] = pipeline;
+        m_Mesh[index]     = mesh;
+
+        mbDirty = true;
+    }
+}
+
+void Objects::InstanceBatcher::setRotation(const Handle& handle, const Float3& rotation)
+{
+    const uint32_t index = m_Index[handle];
+
+    m_Rotation[0][index] = rotation.x;
+    m_Rotation[1][index] = rotation.y;
+    m_Rotation[2][index] = rotation.z;
+}
+
+size_t Objects::InstanceBatcher::count() const
+{
+    return m_Handle.size();
+}
+
+uint32_t Objects::InstanceBatcher::instanceIndex(const Handle& handle)
+{
+    if(mbDirty)
+    {
+        rebatch();
+    }
+
+    return m_Index[handle];
+}
+
+const std::vector<Objects::DrawBatch>& Objects::InstanceBatcher::batches()
+{
+    if(mbDirty)
+    {
+        rebatch();
+    }
+
+    return m_Batches;
+}
+
+void Objects::InstanceBatcher::update(const float& deltaTime, Instance* pInstances)
+{
+    if(mbDirty)
+    {
+        rebatch();
+    }
+
+    update(deltaTime, pInstances, 0, count());
+}
+
+void Objects::InstanceBatcher::update(const float& deltaTime,
+                                      Instance* pInstances,
+                                      const size_t& first,
+                                      const size_t& last)
+{
+    float* pRotationX = m_Rotation[0].data();
+    float* pRotationY = m_Rotation[1].data();
+    float* pRotationZ = m_Rotation[2].data();
+
+    const float* pRateX = m_RotationRate[0].data();
+    const float* pRateY = m_RotationRate[1].data();
+    const float* pRateZ = m_RotationRate[2].data();
+
+    for(size_t i = first; i < last; ++i)
+    {
+        const Float3 angles = {pRotationX[i] + pRateX[i] * deltaTime,
+                               pRotationY[i] + pRateY[i] * deltaTime,
+                               pRotationZ[i] + pRateZ[i] * deltaTime};
+
+        pRotationX[i] = angles.x;
+        pRotationY[i] = angles.y;
+        pRotationZ[i] = angles.z;
+
+        Instance& rInstance = pInstances[i];
+
+        quaternion(angles, rInstance.rotation);
+
+        rInstance.translation[0] = m_Position[0][i];
+        rInstance.translation[1] = m_Position[1][i];
+        rInstance.translation[2] = m_Position[2][i];
+        rInstance.translation[3] = 1.0f;
+
+        rInstance.scale[0] = m_Scale[0][i];
+        rInstance.scale[1] = m_Scale[1][i];
+        rInstance.scale[2] = m_Scale[2][i];
+
+        rInstance.color = m_Color[i];
+    }
+}
+
+#pragma mark -
+#pragma mark Private - Batcher
+
+// Stable counting sort of the objects by (pipeline, mesh)
+void Objects::InstanceBatcher::rebatch()
+{
+    const size_t count = m_Handle.size();
+
+    std::unordered_map<uint64_t, uint32_t> lookup;
+    std::vector<uint32_t>                  group(count);
+
+    m_Batches.clear();
+
+    uint64_t previous = ~uint64_t(0);
+    uint32_t current  = 0;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const uint64_t objectKey = key(m_Pipeline[i], m_Mesh[i]);
+
+        // Objects mostly arrive in runs, so the map is only consulted when the key changes
+        if(objectKey != previous)
+        {
+            const std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> entry =
+                lookup.insert({objectKey, uint32_t(m_Batches.size())});
+
+            if(entry.second)
+            {
+                m_Batches.push_back({m_Pipeline[i], m_Mesh[i], 0, 0});
+            }
+
+            previous = objectKey;
+            current  = entry.first->second;
+        }
+
+        group[i] = current;
+
+        m_Batches[current].instanceCount++;
+    }
+
+    // Batches in key order, so pipeline state changes are grouped together
+    std::vector<uint32_t> order(m_Batches.size());
+
+    for(uint32_t b = 0; b < order.size(); ++b)
+    {
+        order[b] = b;
+    }
+
+    std::sort(order.begin(), order.end(), [&](const uint32_t& a, const uint32_t& b) {
+        return key(m_Batches[a].pipeline, m_Batches[a].mesh) < key(m_Batches[b].pipeline, m_Batches[b].mesh);
+    });
+
+    std::vector<DrawBatch> sorted(m_Batches.size());
+    std::vector<uint32_t>  cursor(m_Batches.size());
+
+    uint32_t first = 0;
+
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        const uint32_t b = order[i];
+
+        sorted[i]               = m_Batches[b];
+        sorted[i].firstInstance = first;
+
+        cursor[b] = first;
+        first    += m_Batches[b].instanceCount;
+    }
+
+    m_Batches.swap(sorted);
+
+    std::vector<uint32_t> source(count);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        source[cursor[group[i]]++] = uint32_t(i);
+    }
+
+    gather(m_Pipeline, source);
+    gather(m_Mesh, source);
+    gather(m_Handle, source);
+    gather(m_Color, source);
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        gather(m_Position[i], source);
+        gather(m_Scale[i], source);
+        gather(m_Rotation[i], source);
+        gather(m_RotationRate[i], source);
+    }
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        m_Index[m_Handle[i]] = uint32_t(i);
+    }
+
+    mbDirty = false;
+}
@@ -0,0 +1,119 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Compact per-object constants and automatic instancing. ObjectData is padded to 256 bytes, so 200k
+ objects with three frames in flight take about 150 MB of constant buffers, and every object is
+ drawn on its own. Objects here are kept in structure-of-arrays form sorted by (pipeline, mesh),
+ each frame writes one 48 byte InstanceData record per object and every run of objects sharing a
+ pipeline and a mesh becomes one instanced draw.
+ */
+
+#ifndef _OBJECTS_INSTANCE_BATCHER_H_
+#define _OBJECTS_INSTANCE_BATCHER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Objects
+{
+    // Layout of InstanceData in SharedObjectsBridge.h
+    struct Instance
+    {
+        float    rotation[4];      // Unit quaternion (x, y, z, w)
+        float    translation[4];   // w is 1
+        float    scale[3];
+        uint32_t color;            // RGBA8 unorm, red in the low byte
+    };
+
+    struct Float3
+    {
+        float x;
+        float y;
+        float z;
+    };
+
+    // Objects sharing a pipeline and a mesh, drawn with one instanced call
+    struct DrawBatch
+    {
+        uint32_t pipeline;
+        uint32_t mesh;
+        uint32_t firstInstance;    // baseInstance of the draw, instance_id in the shader starts here
+        uint32_t instanceCount;
+    };
+
+    // Colour components in [0, 1] packed as by pack_float_to_unorm4x8
+    uint32_t packColor(const float& r, const float& g, const float& b, const float& a);
+
+    // Quaternion of Rz * Ry * Rx, the rotation RenderableObject.UpdateData builds from Euler angles
+    void quaternion(const Float3& angles, float* pQuaternion);
+
+    // Column major LocalToWorld of a record, as ObjectData stores it
+    void localToWorld(const Instance& rInstance, float* pMatrix);
+
+    class InstanceBatcher
+    {
+    public:
+        // Stable identifier of an object; its position in the instance buffer changes when re-batching
+        typedef uint32_t Handle;
+
+        InstanceBatcher();
+
+        void reserve(const size_t& count);
+
+        void clear();
+
+        Handle add(const uint32_t& pipeline,
+                   const uint32_t& mesh,
+                   const Float3& position,
+                   const Float3& scale,
+                   const Float3& rotationRate,
+                   const uint32_t& color);
+
+        // Moving an object to another pipeline or mesh re-batches on the next update
+        void setMaterial(const Handle& handle, const uint32_t& pipeline, const uint32_t& mesh);
+
+        void setRotation(const Handle& handle, const Float3& rotation);
+
+        size_t count() const;
+
+        // Index of the object's record in the instance buffer
+        uint32_t instanceIndex(const Handle& handle);
+
+        // Instanced draws covering all objects, in instance buffer order
+        const std::vector<DrawBatch>& batches();
+
+        // Advance all rotations by deltaTime and write count() records
+        void update(const float& deltaTime, Instance* pInstances);
+
+        // Same for the records [first, last), so disjoint ranges may be updated on different threads
+        // once batches() has been called
+        void update(const float& deltaTime, Instance* pInstances, const size_t& first, const size_t& last);
+
+    private:
+        void rebatch();
+
+        bool                   mbDirty;
+        std::vector<DrawBatch> m_Batches;
+
+        // Per object, in instance buffer order
+        std::vector<uint32_t>  m_Pipeline;
+        std::vector<uint32_t>  m_Mesh;
+        std::vector<Handle>    m_Handle;
+        std::vector<float>     m_Position[3];
+        std::vector<float>     m_Scale[3];
+        std::vector<float>     m_Rotation[3];
+        std::vector<float>     m_RotationRate[3];
+        std::vector<uint32_t>  m_Color;
+
+        // Per handle
+        std::vector<uint32_t>  m_Index;
+    }; // InstanceBatcher
+} // Objects
+
+#endif
+
+#endif
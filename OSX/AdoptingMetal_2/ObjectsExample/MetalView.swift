@@ -37,6 +37,18 @@ let SHADOWED_DIRECTIONAL_LIGHT_UP = float3(0.0, 0.0, 1.0)
 let SHADOWED_DIRECTIONAL_LIGHT_POSITION = float3(0.0, 225.0, 0.0)
 
 let CONSTANT_BUFFER_SIZE : Int = OBJECT_COUNT * MemoryLayout<ObjectData>.size + SHADOW_PASS_COUNT * MemoryLayout<ShadowPass>.size + MAIN_PASS_COUNT * MemoryLayout<MainPass>.size
+let INSTANCE_BUFFER_SIZE : Int = OBJECT_COUNT * MemoryLayout<InstanceData>.stride
+
+// Instanced draws batch the cubes by pipeline and mesh
+// All cubes use the cube pipeline selected by the lighting and shadow toggles, and the cube mesh
+let CUBE_PIPELINE : UInt32 = 0
+let CUBE_MESH : UInt32 = 0
+
+// Occlusion culling of the instanced draws: the depth buffer the occluders are rasterised into and
+// the most cubes rasterised for the main pass, next to the ground plane
+let CULL_WIDTH : UInt32 = 320
+let CULL_HEIGHT : UInt32 = 192
+let CULL_OCCLUDERS : Int = 512
 
 class MetalView : MTKView
 {
@@ -66,12 +78,31 @@ class MetalView : MTKView
 	var dispatchQueue : DispatchQueue
 	
 	// Contains all our objects and metadata about them
-	// We aren't doing any culling so that means we'll be drawing everything every frame
+	// Only the instanced draws are culled, the per-object draws draw everything every frame
 	var renderables : ContiguousArray<RenderableObject> = ContiguousArray<RenderableObject>()
 	var groundPlane : StaticRenderableObject?
 	
 	// Constant buffer ring
 	var constantBuffers : Array<MTLBuffer> = [MTLBuffer] ()
+	
+	// Instanced draws: one 48 byte InstanceData record per object instead of a 256 byte ObjectData
+	// and one draw per run of objects sharing a pipeline and a mesh
+	var instanceBatcher = ObjectsInstanceBatcher(capacity: OBJECT_COUNT)
+	var instanceBuffers : Array<MTLBuffer> = [MTLBuffer] ()
+	var instancedMeshes : Array<RenderableObject> = [RenderableObject]()
+	
+	// Occlusion culling: each pass copies the records it can see into a buffer of its own and draws
+	// only those. From the light cubes are hidden by many small cubes together, which the culler's
+	// whole pixel occluders miss, so the shadow pass only drops what lies outside its frustum.
+	var cullObjects = true
+	var mainCuller = ObjectsOcclusionCuller(width: CULL_WIDTH, height: CULL_HEIGHT, maxOccluders: UInt(CULL_OCCLUDERS))
+	var shadowCuller = ObjectsOcclusionCuller(width: CULL_WIDTH, height: CULL_HEIGHT, maxOccluders: 0)
+	var mainVisibleBuffers : Array<MTLBuffer> = [MTLBuffer] ()
+	var shadowVisibleBuffers : Array<MTLBuffer> = [MTLBuffer] ()
+	var visibleObjects = 0
+	
+	// Per-object draws: the ObjectData records are written four objects at a time
+	var objectUpdater = ObjectsObjectUpdater(capacity: OBJECT_COUNT)
 	var constantBufferSlot : Int = 0
 	var frameCounter : UInt = 1
 	
@@ -97,6 +128,7 @@ class MetalView : MTKView
 	var multithreadedUpdate = false
 	var multithreadedRender = false
 	var objectsToRender = 10000
+	var instancedDraws = true
 	
 	// Render modes
 	var depthTest = true
@@ -119,6 +151,12 @@ class MetalView : MTKView
 	var planeRenderPipeline: MTLRenderPipelineState?
 	var zpassPipeline: MTLRenderPipelineState?
 	
+	var instancedUnshadedPipeline: MTLRenderPipelineState?
+	var instancedUnshadedShadowedPipeline: MTLRenderPipelineState?
+	var instancedLitPipeline: MTLRenderPipelineState?
+	var instancedLitShadowedPipeline: MTLRenderPipelineState?
+	var instancedZpassPipeline: MTLRenderPipelineState?
+	
 	var quadVisPipeline: MTLRenderPipelineState?
 	var depthVisPipeline: MTLRenderPipelineState?
 	var texQuadVisPipeline: MTLRenderPipelineState?
@@ -237,6 +275,37 @@ class MetalView : MTKView
 			fatalError("Could not create lighting shaders, failing. \(error)")
 		}
 		
+		do {
+			// Instanced variants, reading InstanceData through instance_id
+			let pipeDesc = MTLRenderPipelineDescriptor()
+			pipeDesc.vertexFunction = lib.makeFunction(name: "instanced_vertex_main")
+			pipeDesc.fragmentFunction = lib.makeFunction(name: "instanced_unshaded_fragment")
+			pipeDesc.colorAttachments[0].pixelFormat = .bgra8Unorm
+			pipeDesc.depthAttachmentPixelFormat = .depth32Float
+			
+			try instancedUnshadedPipeline = device!.makeRenderPipelineState(descriptor: pipeDesc)
+			
+			pipeDesc.fragmentFunction = lib.makeFunction(name: "instanced_unshaded_shadowed_fragment")
+			try instancedUnshadedShadowedPipeline = device!.makeRenderPipelineState(descriptor: pipeDesc)
+			
+			pipeDesc.vertexFunction = lib.makeFunction(name: "instanced_lit_vertex")
+			pipeDesc.fragmentFunction = lib.makeFunction(name: "instanced_lit_fragment")
+			try instancedLitPipeline = device!.makeRenderPipelineState(descriptor: pipeDesc)
+			
+			pipeDesc.fragmentFunction = lib.makeFunction(name: "instanced_lit_shadowed_fragment")
+			try instancedLitShadowedPipeline = device!.makeRenderPipelineState(descriptor: pipeDesc)
+			
+			pipeDesc.vertexFunction = lib.makeFunction(name: "instanced_zpass_vertex_main")
+			pipeDesc.fragmentFunction = lib.makeFunction(name: "zpass_fragment")
+			pipeDesc.colorAttachments[0].pixelFormat = .invalid
+			pipeDesc.colorAttachments[0].writeMask = MTLColorWriteMask()
+			
+			try instancedZpassPipeline = device!.makeRenderPipelineState(descriptor: pipeDesc)
+		}
+		catch {
+			fatalError("Could not create instanced shaders, failing. \(error)")
+		}
+		
 		do {
 			// Visualization shaders
 			let vertexFunction = lib.makeFunction(name: "quad_vertex_main")
@@ -266,7 +335,7 @@ class MetalView : MTKView
 	override func awakeFromNib() {
         super.awakeFromNib()
         
-		drawCountField?.stringValue = "\(objectsToRender) draws"
+		updateDrawCountField()
 		if multithreadedUpdate {
 			multithreadUpdateLabel?.stringValue = "Multithreaded Update"
 		}
@@ -306,6 +375,12 @@ class MetalView : MTKView
 		for _ in 1...MAX_FRAMES_IN_FLIGHT {
 			let buf : MTLBuffer = device!.makeBuffer(length: CONSTANT_BUFFER_SIZE, options: MTLResourceOptions.storageModeManaged)
 			constantBuffers.append(buf)
+			
+			let instances : MTLBuffer = device!.makeBuffer(length: INSTANCE_BUFFER_SIZE, options: MTLResourceOptions.storageModeManaged)
+			instanceBuffers.append(instances)
+			
+			mainVisibleBuffers.append(device!.makeBuffer(length: INSTANCE_BUFFER_SIZE, options: MTLResourceOptions.storageModeManaged))
+			shadowVisibleBuffers.append(device!.makeBuffer(length: INSTANCE_BUFFER_SIZE, options: MTLResourceOptions.storageModeManaged))
 		}
 		
 		// MARK: Shadow Texture Creation
@@ -382,6 +457,10 @@ class MetalView : MTKView
 		do {
 			let (geo, index, indexCount, vertCount) = createCube(device!)
 			
+			let cubeMesh = RenderableObject(m: geo, idx: index, count: indexCount, tex: nil)
+			cubeMesh.count = vertCount
+			instancedMeshes.append(cubeMesh)
+			
 			for _ in 0..<OBJECT_COUNT {
 				//NOTE returns a value within -value to value
 				let p = Float(getRandomValue(500.0))
@@ -406,6 +485,19 @@ class MetalView : MTKView
 												 Float(drand48()),
 												 Float(drand48()), 1.0)
 				renderables.append(cube)
+				
+				objectUpdater.addObject(withPosition: float3(p, p1, p2),
+				                        scale: cube.scale,
+				                        rotationRate: cube.rotationRate,
+				                        color: cube.objectData.color)
+				
+				// The same object for instanced draws
+				instanceBatcher.addObject(withPipeline: CUBE_PIPELINE,
+				                          mesh: CUBE_MESH,
+				                          position: float3(p, p1, p2),
+				                          scale: cube.scale,
+				                          rotationRate: cube.rotationRate,
+				                          color: cube.objectData.color)
 			}
 		}
 		
@@ -417,6 +509,13 @@ class MetalView : MTKView
 			                               GROUND_POSITION.z,1.0)
 			groundPlane!.objectData.color = GROUND_COLOR
 			groundPlane!.objectData.LocalToWorld.columns.3 = groundPlane!.position
+			
+			// The plane's 2001 by 2001 quad as a flat cube record, occluding what lies below it
+			let ground = InstanceData(rotation: float4(0.0, 0.0, 0.0, 1.0),
+			                          translation: groundPlane!.position,
+			                          scale: (2001.0, 0.0, 2001.0),
+			                          color: 0)
+			mainCuller.addStaticOccluder(ground)
 		}
 		
 		// Main pass projection matrix
@@ -424,14 +523,58 @@ class MetalView : MTKView
 		mainPassProjection = getPerpectiveProjectionMatrix(Float(60.0*DEG2RAD), aspectRatio: Float(self.frame.width) / Float(self.frame.height), zFar: 2000.0, zNear: 1.0)
 	}
 	
+	// Encodes the instanced draws of the records the culler left visible, or of the first
+	// objectsToRender records without one
+	// The records, the pipeline and the pass constants must be bound already
+	func encodeInstancedDraws(_ enc: MTLRenderCommandEncoder, culler: ObjectsOcclusionCuller?) {
+		if let culler = culler {
+			for index in 0..<culler.batchCount {
+				let batch = culler.batch(at: index)
+				
+				let mesh = instancedMeshes[Int(batch.mesh)]
+				enc.setVertexBuffer(mesh.mesh, offset: 0, at: 0)
+				mesh.DrawInstanced(enc, instanceCount: Int(batch.instanceCount), baseInstance: Int(batch.firstInstance))
+			}
+			return
+		}
+		
+		for index in 0..<instanceBatcher.batchCount {
+			let batch = instanceBatcher.batch(at: index)
+			
+			let first = Int(batch.firstInstance)
+			let count = min(Int(batch.instanceCount), objectsToRender - first)
+			
+			if count <= 0 {
+				break
+			}
+			
+			let mesh = instancedMeshes[Int(batch.mesh)]
+			enc.setVertexBuffer(mesh.mesh, offset: 0, at: 0)
+			mesh.DrawInstanced(enc, instanceCount: count, baseInstance: first)
+		}
+	}
+	
 	// Encodes a single shadow pass
-	func encodeShadowPass(_ commandBuffer: MTLCommandBuffer, rp: MTLRenderPassDescriptor, constantBuffer: MTLBuffer, passDataOffset: Int, objectDataOffset: Int) {
+	func encodeShadowPass(_ commandBuffer: MTLCommandBuffer, rp: MTLRenderPassDescriptor, constantBuffer: MTLBuffer, instanceBuffer: MTLBuffer, culler: ObjectsOcclusionCuller?, passDataOffset: Int, objectDataOffset: Int) {
 		let enc = commandBuffer.makeRenderCommandEncoder(descriptor: rp)
 		enc.setDepthStencilState(depthTestLess)
 		
 		//We're only going to draw back faces into the shadowmap
 		enc.setCullMode(MTLCullMode.front)
 		
+		if instancedDraws {
+			enc.setVertexBuffer(instanceBuffer, offset: 0, at: 1)
+			enc.setVertexBuffer(constantBuffer, offset: passDataOffset, at: 2)
+			enc.setRenderPipelineState(instancedZpassPipeline!)
+			
+			encodeInstancedDraws(enc, culler: culler)
+			
+			enc.endEncoding()
+			
+			commandBuffer.commit()
+			return
+		}
+		
 		// setVertexOffset will allow faster updates, but we must bind the Constant buffer once
 		enc.setVertexBuffer(constantBuffer, offset: 0, at: 1)
 		// Bind the ShadowPass data once for all objects to see
@@ -457,7 +600,31 @@ class MetalView : MTKView
 	// Committing our command buffer
 	// We'll also add a completion handler to signal the semaphore
 	
-	func encodeMainPass(_ enc: MTLRenderCommandEncoder, constantBuffer: MTLBuffer, passDataOffset: Int, objectDataOffset: Int) {
+	// Instanced counterpart of the object loop in encodeMainPass
+	func encodeInstancedMainPass(_ enc: MTLRenderCommandEncoder, instanceBuffer: MTLBuffer, culler: ObjectsOcclusionCuller?) {
+		enc.setVertexBuffer(instanceBuffer, offset: 0, at: 1)
+		
+		if drawShadowsOnCubes {
+			if drawLighting {
+				enc.setRenderPipelineState(instancedLitShadowedPipeline!)
+			}
+			else {
+				enc.setRenderPipelineState(instancedUnshadedShadowedPipeline!)
+			}
+		}
+		else {
+			if drawLighting {
+				enc.setRenderPipelineState(instancedLitPipeline!)
+			}
+			else {
+				enc.setRenderPipelineState(instancedUnshadedPipeline!)
+			}
+		}
+		
+		encodeInstancedDraws(enc, culler: culler)
+	}
+	
+	func encodeMainPass(_ enc: MTLRenderCommandEncoder, constantBuffer: MTLBuffer, instanceBuffer: MTLBuffer, culler: ObjectsOcclusionCuller?, passDataOffset: Int, objectDataOffset: Int) {
 		// Similar to the shadow passes, we must bind the constant buffer once before we call setVertexBytes
 		enc.setVertexBuffer(constantBuffer, offset: 0, at: 1)
 		enc.setFragmentBuffer(constantBuffer, offset: 0, at: 1)
@@ -468,6 +635,15 @@ class MetalView : MTKView
 		
 		enc.setFragmentTexture(shadowMap, at: 0)
 		
+		if instancedDraws {
+			encodeInstancedMainPass(enc, instanceBuffer: instanceBuffer, culler: culler)
+			
+			// The ground plane binds its own ObjectData
+			enc.setRenderPipelineState(planeRenderPipeline!)
+			groundPlane!.Draw(enc, offset: 0)
+			return
+		}
+		
 		var offset = objectDataOffset
 		if drawShadowsOnCubes {
 			if drawLighting {
@@ -497,7 +673,7 @@ class MetalView : MTKView
 		groundPlane!.Draw(enc, offset: offset)
 	}
 	
-	func drawMainPass(_ mainCommandBuffer: MTLCommandBuffer, constantBuffer: MTLBuffer, mainPassOffset: Int, objectDataOffset: Int) {
+	func drawMainPass(_ mainCommandBuffer: MTLCommandBuffer, constantBuffer: MTLBuffer, instanceBuffer: MTLBuffer, culler: ObjectsOcclusionCuller?, mainPassOffset: Int, objectDataOffset: Int) {
 		let currentFrame = frameCounter
 		
 		if showDepthAndShadow {
@@ -514,7 +690,7 @@ class MetalView : MTKView
 			enc.setDepthStencilState(depthTestLess)
 		}
 		
-		encodeMainPass(enc, constantBuffer: constantBuffer, passDataOffset : mainPassOffset, objectDataOffset: objectDataOffset)
+		encodeMainPass(enc, constantBuffer: constantBuffer, instanceBuffer: instanceBuffer, culler: culler, passDataOffset : mainPassOffset, objectDataOffset: objectDataOffset)
 		
 		enc.endEncoding()
 		
@@ -645,6 +821,14 @@ class MetalView : MTKView
 		
         // Select which constant buffer to use
         let constantBufferForFrame = constantBuffers[currentConstantBuffer]
+        let instanceBufferForFrame = instanceBuffers[currentConstantBuffer]
+        
+        // Each pass reads the records it can see from its own buffer when culling
+        let culling = instancedDraws && cullObjects
+        var shadowInstanceBuffer = instanceBufferForFrame
+        var mainInstanceBuffer = instanceBufferForFrame
+        var shadowCullerForFrame : ObjectsOcclusionCuller? = nil
+        var mainCullerForFrame : ObjectsOcclusionCuller? = nil
         
         // Calculate the offsets into the constant buffer for the shadow pass data, main pass data, and object data
         let shadowOffset = 0
@@ -657,29 +841,53 @@ class MetalView : MTKView
         // Write the main pass data into the constants buffer
         constantBufferForFrame.contents().storeBytes(of: mainPassFrameData, toByteOffset: mainPassOffset, as: MainPass.self)
         
-        // Create a mutable pointer to the beginning of the object data so we can step through it and set the data of each object individually
-        var ptr = constantBufferForFrame.contents().advanced(by: objectDataOffset).bindMemory(to: ObjectData.self, capacity: objectsToRender)
-        
-        // Update position of all the objects
-        if multithreadedUpdate {
-            DispatchQueue.concurrentPerform(iterations: objectsToRender) { i in
-                let thisPtr = ptr.advanced(by: i)
-                _ = self.renderables[i].UpdateData(thisPtr, deltaTime: 1.0/60.0)
+        if instancedDraws {
+            // Write the instance records, the batches are up to date afterwards
+            let instances = instanceBufferForFrame.contents().bindMemory(to: InstanceData.self, capacity: objectsToRender)
+            
+            instanceBatcher.update(withDeltaTime: 1.0/60.0, instances: instances, count: objectsToRender, concurrently: multithreadedUpdate)
+            
+            instanceBufferForFrame.didModifyRange(NSMakeRange(0, MemoryLayout<InstanceData>.stride*objectsToRender))
+            constantBufferForFrame.didModifyRange(NSMakeRange(0, objectDataOffset))
+            
+            if culling {
+                shadowInstanceBuffer = shadowVisibleBuffers[currentConstantBuffer]
+                mainInstanceBuffer = mainVisibleBuffers[currentConstantBuffer]
+                shadowCullerForFrame = shadowCuller
+                mainCullerForFrame = mainCuller
+                
+                let shadowVisible = shadowInstanceBuffer.contents().bindMemory(to: InstanceData.self, capacity: objectsToRender)
+                let mainVisible = mainInstanceBuffer.contents().bindMemory(to: InstanceData.self, capacity: objectsToRender)
+                
+                let shadowStats = shadowCuller.cullInstances(instances, count: objectsToRender, batcher: instanceBatcher, viewProjection: shadowPassData[0].ViewProjection, visibleInstances: shadowVisible, concurrently: multithreadedUpdate)
+                let mainStats = mainCuller.cullInstances(instances, count: objectsToRender, batcher: instanceBatcher, viewProjection: mainPassFrameData.ViewProjection, visibleInstances: mainVisible, concurrently: multithreadedUpdate)
+                
+                if shadowStats.visible > 0 {
+                    shadowInstanceBuffer.didModifyRange(NSMakeRange(0, MemoryLayout<InstanceData>.stride*Int(shadowStats.visible)))
+                }
+                if mainStats.visible > 0 {
+                    mainInstanceBuffer.didModifyRange(NSMakeRange(0, MemoryLayout<InstanceData>.stride*Int(mainStats.visible)))
+                }
+                
+                visibleObjects = Int(mainStats.visible)
             }
         }
         else {
-            for index in 0..<objectsToRender {
-                ptr = renderables[index].UpdateData(ptr, deltaTime: 1.0/60.0)
-            }
+            // Create a mutable pointer to the beginning of the object data
+            var ptr = constantBufferForFrame.contents().advanced(by: objectDataOffset).bindMemory(to: ObjectData.self, capacity: objectsToRender + 1)
+            
+            // Update position of all the objects
+            // The updater writes four objects at a time, in chunks of whole cache lines on a thread pool when multithreaded
+            objectUpdater.update(withDeltaTime: 1.0/60.0, objectData: ptr, count: objectsToRender, concurrently: multithreadedUpdate)
+            
+            // Advance the object data pointer so we can write the data for the ground plane object
+            ptr = ptr.advanced(by: objectsToRender)
+            
+            _ = groundPlane!.UpdateData(ptr, deltaTime: 1.0/60.0)
+            
+            // Mark constant buffer as modified (objectsToRender+1 because of the ground plane)
+            constantBufferForFrame.didModifyRange(NSMakeRange(0, mainPassOffset+(MemoryLayout<ObjectData>.stride*(objectsToRender+1))))
         }
-        
-        // Advance the object data pointer once more so we can write the data for the ground plane object
-        ptr = ptr.advanced(by: objectsToRender)
-        
-        _ = groundPlane!.UpdateData(ptr, deltaTime: 1.0/60.0)
-        
-        // Mark constant buffer as modified (objectsToRender+1 because of the ground plane)
-        constantBufferForFrame.didModifyRange(NSMakeRange(0, mainPassOffset+(MemoryLayout<ObjectData>.stride*(objectsToRender+1))))
 		
 		// Create command buffers for the entire scene rendering
 		let shadowCommandBuffer : MTLCommandBuffer = metalQueue!.makeCommandBufferWithUnretainedReferences()
@@ -699,24 +907,24 @@ class MetalView : MTKView
 		if multithreadedRender {
 			dispatchGroup.enter()
 			dispatchQueue.async {
-				self.encodeShadowPass(shadowCommandBuffer, rp: self.shadowRPs[0], constantBuffer: constantBufferForFrame, passDataOffset: shadowOffset, objectDataOffset: objectDataOffset)
+				self.encodeShadowPass(shadowCommandBuffer, rp: self.shadowRPs[0], constantBuffer: constantBufferForFrame, instanceBuffer: shadowInstanceBuffer, culler: shadowCullerForFrame, passDataOffset: shadowOffset, objectDataOffset: objectDataOffset)
 				dispatchGroup.leave()
 			}
 		}
 		else {
-			encodeShadowPass(shadowCommandBuffer, rp: self.shadowRPs[0], constantBuffer: constantBufferForFrame, passDataOffset: shadowOffset, objectDataOffset: objectDataOffset)
+			encodeShadowPass(shadowCommandBuffer, rp: self.shadowRPs[0], constantBuffer: constantBufferForFrame, instanceBuffer: shadowInstanceBuffer, culler: shadowCullerForFrame, passDataOffset: shadowOffset, objectDataOffset: objectDataOffset)
 		}
 		
 		//MARK: Dispatch Main Render Pass
 		if multithreadedRender {
 			dispatchGroup.enter()
 			dispatchQueue.async {
-				self.drawMainPass(mainCommandBuffer, constantBuffer: constantBufferForFrame, mainPassOffset: mainPassOffset, objectDataOffset: objectDataOffset)
+				self.drawMainPass(mainCommandBuffer, constantBuffer: constantBufferForFrame, instanceBuffer: mainInstanceBuffer, culler: mainCullerForFrame, mainPassOffset: mainPassOffset, objectDataOffset: objectDataOffset)
 				dispatchGroup.leave()
 			}
 		}
 		else {
-			drawMainPass(mainCommandBuffer, constantBuffer: constantBufferForFrame, mainPassOffset: mainPassOffset, objectDataOffset: objectDataOffset)
+			drawMainPass(mainCommandBuffer, constantBuffer: constantBufferForFrame, instanceBuffer: mainInstanceBuffer, culler: mainCullerForFrame, mainPassOffset: mainPassOffset, objectDataOffset: objectDataOffset)
 		}
 
 		if multithreadedRender {
@@ -739,6 +947,7 @@ class MetalView : MTKView
 		
 		if frameCounter % 60 == 0 {
 			frameEncodingTimeField?.stringValue = String.localizedStringWithFormat("%.3f ms", mseconds)
+			updateDrawCountField()
 		}
 		
 		// Increment our constant buffer counter
@@ -747,6 +956,18 @@ class MetalView : MTKView
 		frameCounter = frameCounter+1
 	}
 	
+	func updateDrawCountField() {
+		if instancedDraws && cullObjects {
+			drawCountField?.stringValue = "\(visibleObjects) of \(objectsToRender) instances"
+		}
+		else if instancedDraws {
+			drawCountField?.stringValue = "\(objectsToRender) instances"
+		}
+		else {
+			drawCountField?.stringValue = "\(objectsToRender) draws"
+		}
+	}
+	
 	func resetCamera() {
 		camera.position = START_POSITION
 		cameraAngles = float2(0.0, 0.0)
@@ -803,11 +1024,19 @@ class MetalView : MTKView
             
             case kVK_ANSI_7:
                 objectsToRender = max(objectsToRender/2, 10)
-                drawCountField?.stringValue = "\(objectsToRender) draws"
+                updateDrawCountField()
             
             case kVK_ANSI_8:
                 objectsToRender = min(objectsToRender*2,OBJECT_COUNT)
-                drawCountField?.stringValue = "\(objectsToRender) draws"
+                updateDrawCountField()
+            
+            case kVK_ANSI_0:
+                instancedDraws = !instancedDraws
+                updateDrawCountField()
+            
+            case kVK_ANSI_1:
+                cullObjects = !cullObjects
+                updateDrawCountField()
             
             case kVK_ANSI_9:
                 showDepthAndShadow = !showDepthAndShadow
@@ -0,0 +1,609 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Chunked update of the per-object constants. The multithreaded path of MetalView dispatches one
+ closure per object, and every closure multiplies four matrices and writes a whole 256 byte
+ ObjectData. Here the rotation state lives in cache line aligned arrays (one per component), and
+ objects are updated four at a time: SIMD sincos, a closed form Rz * Ry * Rx, then the matrix and
+ colour lines of each ObjectData are streamed with non-temporal stores. Work is handed out in
+ chunks of whole cache lines, so no two threads ever write the same line.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#include "ObjectUpdate.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace Objects
+{
+    // Four objects per register
+    struct float4
+    {
+#if defined(__SSE2__)
+        __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        float32x4_t v;
+#else
+        float v[4];
+#endif
+    };
+
+    struct int4
+    {
+#if defined(__SSE2__)
+        __m128i v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        int32x4_t v;
+#else
+        int32_t v[4];
+#endif
+    };
+
+#if defined(__SSE2__)
+    static inline float4 load(const float* p)                        { return {_mm_load_ps(p)}; }
+    static inline void   store(float* p, const float4& a)            { _mm_storeu_ps(p, a.v); }
+    static inline void   stream(float* p, const float4& a)           { _mm_stream_ps(p, a.v); }
+    static inline void   fence()                                     { _mm_sfence(); }
+    static inline float4 splat(const float& s)                       { return {_mm_set1_ps(s)}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+    static inline float4 operator-(const float4& a, const float4& b) { return {_mm_sub_ps(a.v, b.v)}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+    static inline int4   round(const float4& a)                      { return {_mm_cvtps_epi32(a.v)}; }
+    static inline float4 convert(const int4& a)                      { return {_mm_cvtepi32_ps(a.v)}; }
+    static inline int4   bits(const int4& a, const int32_t& mask)    { return {_mm_and_si128(a.v, _mm_set1_epi32(mask))}; }
+    static inline int4   increment(const int4& a)                    { return {_mm_add_epi32(a.v, _mm_set1_epi32(1))}; }
+    static inline int4   signBit(const int4& a)                      { return {_mm_slli_epi32(a.v, 30)}; }   // Bit 1 to bit 31
+    static inline float4 flipSign(const float4& a, const int4& sign) { return {_mm_xor_ps(a.v, _mm_castsi128_ps(sign.v))}; }
+
+    // Lanes with a nonzero mask take a
+    static inline float4 select(const int4& mask, const float4& a, const float4& b)
+    {
+        const __m128 m = _mm_castsi128_ps(_mm_cmpeq_epi32(mask.v, _mm_setzero_si128()));
+
+        return {_mm_or_ps(_mm_and_ps(m, b.v), _mm_andnot_ps(m, a.v))};
+    }
+
+    static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+    {
+        _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    static inline float4 load(const float* p)                        { return {vld1q_f32(p)}; }
+    static inline void   store(float* p, const float4& a)            { vst1q_f32(p, a.v); }
+    static inline void   stream(float* p, const float4& a)           { vst1q_f32(p, a.v); }
+    static inline void   fence()                                     { }
+    static inline float4 splat(const float& s)                       { return {vdupq_n_f32(s)}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+    static inline float4 operator-(const float4& a, const float4& b) { return {vsubq_f32(a.v, b.v)}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+    static inline float4 convert(const int4& a)                      { return {vcvtq_f32_s32(a.v)}; }
+    static inline int4   bits(const int4& a, const int32_t& mask)    { return {vandq_s32(a.v, vdupq_n_s32(mask))}; }
+    static inline int4   increment(const int4& a)                    { return {vaddq_s32(a.v, vdupq_n_s32(1))}; }
+    static inline int4   signBit(const int4& a)                      { return {vshlq_n_s32(a.v, 30)}; }
+    static inline float4 flipSign(const float4& a, const int4& sign) { return {vreinterpretq_f32_s32(veorq_s32(vreinterpretq_s32_f32(a.v), sign.v))}; }
+
+    // Nearest integer, halves away from zero
+    static inline int4 round(const float4& a)
+    {
+        const uint32x4_t negative = vcltq_f32(a.v, vdupq_n_f32(0.0f));
+
+        return {vcvtq_s32_f32(vaddq_f32(a.v, vbslq_f32(negative, vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f))))};
+    }
+
+    static inline float4 select(const int4& mask, const float4& a, const float4& b)
+    {
+        return {vbslq_f32(vtstq_s32(mask.v, mask.v), a.v, b.v)};
+    }
+
+    static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+    {
+        const float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+        const float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+
+        a.v = vcombine_f32(vget_low_f32(ab.val[0]),  vget_low_f32(cd.val[0]));
+        b.v = vcombine_f32(vget_low_f32(ab.val[1]),  vget_low_f32(cd.val[1]));
+        c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+        d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+    }
+#else
+    static inline float4 load(const float* p)             { return {{p[0], p[1], p[2], p[3]}}; }
+    static inline void   store(float* p, const float4& a) { std::memcpy(p, a.v, sizeof(a.v)); }
+    static inline void   stream(float* p, const float4& a) { std::memcpy(p, a.v, sizeof(a.v)); }
+    static inline void   fence()                          { }
+    static inline float4 splat(const float& s)            { return {{s, s, s, s}}; }
+
+    static inline float4 operator+(const float4& a, const float4& b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    static inline float4 operator-(const float4& a, const float4& b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+
+    static inline int4 round(const float4& a)
+    {
+        return {{int32_t(std::lround(a.v[0])), int32_t(std::lround(a.v[1])), int32_t(std::lround(a.v[2])), int32_t(std::lround(a.v[3]))}};
+    }
+
+    static inline float4 convert(const int4& a)                   { return {{float(a.v[0]), float(a.v[1]), float(a.v[2]), float(a.v[3])}}; }
+    static inline int4   bits(const int4& a, const int32_t& mask) { return {{a.v[0] & mask, a.v[1] & mask, a.v[2] & mask, a.v[3] & mask}}; }
+    static inline int4   increment(const int4& a)                 { return {{a.v[0] + 1, a.v[1] + 1, a.v[2] + 1, a.v[3] + 1}}; }
+
+    static inline int4 signBit(const int4& a)
+    {
+        return {{int32_t(uint32_t(a.v[0]) << 30), int32_t(uint32_t(a.v[1]) << 30), int32_t(uint32_t(a.v[2]) << 30), int32_t(uint32_t(a.v[3]) << 30)}};
+    }
+
+    static inline float4 flipSign(const float4& a, const int4& sign)
+    {
+        float4 result;
+
+        for(size_t i = 0; i < 4; ++i)
+        {
+            uint32_t value;
+
+            std::memcpy(&value, &a.v[i], sizeof(value));
+
+            value ^= uint32_t(sign.v[i]);
+
+            std::memcpy(&result.v[i], &value, sizeof(value));
+        }
+
+        return result;
+    }
+
+    static inline float4 select(const int4& mask, const float4& a, const float4& b)
+    {
+        return {{mask.v[0] ? a.v[0] : b.v[0], mask.v[1] ? a.v[1] : b.v[1], mask.v[2] ? a.v[2] : b.v[2], mask.v[3] ? a.v[3] : b.v[3]}};
+    }
+
+    static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+    {
+        for(size_t i = 0; i < 4; ++i)
+        {
+            for(size_t j = i + 1; j < 4; ++j)
+            {
+                float4* rows[4] = {&a, &b, &c, &d};
+
+                std::swap(rows[i]->v[j], rows[j]->v[i]);
+            }
+        }
+    }
+#endif
+
+    static const float kPi    = 3.14159265358979f;
+    static const float kTwoPi = 6.28318530717959f;
+
+    // Angle in [-pi, pi]
+    static inline float4 wrap(const float4& angle)
+    {
+        return angle - splat(kTwoPi) * convert(round(angle * splat(1.0f / kTwoPi)));
+    }
+
+    // Sine and cosine of |x| <= pi (Cephes style): reduction by quadrants of pi/2 in
+    // three parts, minimax polynomials on [-pi/4, pi/4]
+    static inline void sincos(const float4& x, float4& rSin, float4& rCos)
+    {
+        const int4   quadrant = round(x * splat(2.0f / kPi));
+        const float4 j        = convert(quadrant);
+
+        const float4 y  = ((x - j * splat(1.5703125f)) - j * splat(4.837512969970703125e-4f)) - j * splat(7.54978995489188216e-8f);
+        const float4 y2 = y * y;
+
+        const float4 s = y + y * y2 * (splat(-1.6666654611e-1f) + y2 * (splat(8.3321608736e-3f) + y2 * splat(-1.9515295891e-4f)));
+        const float4 c = splat(1.0f) - splat(0.5f) * y2
+                       + y2 * y2 * (splat(4.166664568298827e-2f) + y2 * (splat(-1.388731625493765e-3f) + y2 * splat(2.443315711809948e-5f)));
+
+        const int4 odd = bits(quadrant, 1);
+
+        rSin = flipSign(select(odd, c, s), signBit(bits(quadrant, 2)));
+        rCos = flipSign(select(odd, s, c), signBit(bits(increment(quadrant), 2)));
+    }
+
+    static inline float wrap(const float& angle)
+    {
+        return angle - kTwoPi * std::round(angle * (1.0f / kTwoPi));
+    }
+
+    // Column major 4x4 product a * b
+    static void multiply(const float* pA, const float* pB, float* pResult)
+    {
+        for(size_t c = 0; c < 4; ++c)
+        {
+            for(size_t r = 0; r < 4; ++r)
+            {
+                pResult[4 * c + r] = pA[r] * pB[4 * c] + pA[4 + r] * pB[4 * c + 1] + pA[8 + r] * pB[4 * c + 2] + pA[12 + r] * pB[4 * c + 3];
+            }
+        }
+    }
+
+    static void identity(float* pMatrix)
+    {
+        for(size_t i = 0; i < 16; ++i)
+        {
+            pMatrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        }
+    }
+} // Objects
+
+#pragma mark -
+#pragma mark Public - Aligned array
+
+Objects::AlignedArray::AlignedArray()
+: mnSize(0)
+{
+}
+
+void Objects::AlignedArray::resize(const size_t& count)
+{
+    // 16 spare floats leave room to move the start onto a 64 byte boundary
+    std::vector<float> storage(count + 16, 0.0f);
+
+    const size_t offset = (64 - (reinterpret_cast<uintptr_t>(storage.data()) & 63)) / sizeof(float) % 16;
+
+    if(mnSize > 0)
+    {
+        std::memcpy(storage.data() + offset, data(), std::min(mnSize, count) * sizeof(float));
+    }
+
+    m_Storage.swap(storage);
+
+    mnSize = count;
+}
+
+void Objects::AlignedArray::clear()
+{
+    std::vector<float>().swap(m_Storage);
+
+    mnSize = 0;
+}
+
+size_t Objects::AlignedArray::size() const
+{
+    return mnSize;
+}
+
+float* Objects::AlignedArray::data()
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(m_Storage.data());
+
+    return m_Storage.data() + (64 - (address & 63)) / sizeof(float) % 16;
+}
+
+const float* Objects::AlignedArray::data() const
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(m_Storage.data());
+
+    return m_Storage.data() + (64 - (address & 63)) / sizeof(float) % 16;
+}
+
+#pragma mark -
+#pragma mark Public - Updater
+
+const size_t Objects::ObjectUpdater::kDefaultChunk;
+
+Objects::ObjectUpdater::ObjectUpdater()
+: mnCount(0)
+{
+}
+
+void Objects::ObjectUpdater::reserve(const size_t& count)
+{
+    // Whole cache lines, so four-wide loads past the last object stay inside the arrays
+    const size_t capacity = (std::max(count, mnCount) + 15) & ~size_t(15);
+
+    if(capacity <= m_Rotation[0].size())
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        m_Position[i].resize(capacity);
+        m_Scale[i].resize(capacity);
+        m_Rotation[i].resize(capacity);
+        m_RotationRate[i].resize(capacity);
+    }
+
+    m_Color.resize(4 * capacity);
+}
+
+void Objects::ObjectUpdater::clear()
+{
+    mnCount = 0;
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        m_Position[i].clear();
+        m_Scale[i].clear();
+        m_Rotation[i].clear();
+        m_RotationRate[i].clear();
+    }
+
+    m_Color.clear();
+}
+
+size_t Objects::ObjectUpdater::add(const Float3& position,
+                                   const Float3& scale,
+                                   const Float3& rotationRate,
+                                   const float* pColor)
+{
+    if(mnCount == m_Rotation[0].size())
+    {
+        reserve(std::max<size_t>(64, 2 * mnCount));
+    }
+
+    const size_t index = mnCount++;
+
+    m_Position[0][index] = position.x;
+    m_Position[1][index] = position.y;
+    m_Position[2][index] = position.z;
+
+    m_Scale[0][index] = scale.x;
+    m_Scale[1][index] = scale.y;
+    m_Scale[2][index] = scale.z;
+
+    m_RotationRate[0][index] = rotationRate.x;
+    m_RotationRate[1][index] = rotationRate.y;
+    m_RotationRate[2][index] = rotationRate.z;
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        m_Rotation[i][index] = 0.0f;
+    }
+
+    std::memcpy(&m_Color[4 * index], pColor, 4 * sizeof(float));
+
+    return index;
+}
+
+void Objects::ObjectUpdater::setRotation(const size_t& index, const Float3& rotation)
+{
+    m_Rotation[0][index] = wrap(rotation.x);
+    m_Rotation[1][index] = wrap(rotation.y);
+    m_Rotation[2][index] = wrap(rotation.z);
+}
+
+size_t Objects::ObjectUpdater::count() const
+{
+    return mnCount;
+}
+
+void Objects::ObjectUpdater::update(const float& deltaTime,
+                                    void* pObjectData,
+                                    const size_t& count,
+                                    Threads::WorkStealingPool* pPool,
+                                    const size_t& stride,
+                                    const size_t& chunk)
+{
+    const size_t objects = std::min(count, mnCount);
+    const size_t grain   = std::max<size_t>(16, (chunk + 15) & ~size_t(15));
+    const size_t chunks  = (objects + grain - 1) / grain;
+
+    uint8_t* pBytes = static_cast<uint8_t*>(pObjectData);
+
+    if((pPool == nullptr) || (chunks < 2))
+    {
+        updateRange(deltaTime, pBytes, stride, 0, objects);
+
+        return;
+    }
+
+    pPool->parallelFor(chunks, [&](size_t c) {
+        updateRange(deltaTime, pBytes, stride, c * grain, std::min(objects, (c + 1) * grain));
+    }, 1);
+}
+
+void Objects::ObjectUpdater::updatePerObject(const float& deltaTime,
+                                             void* pObjectData,
+                                             const size_t& count,
+                                             Threads::WorkStealingPool* pPool,
+                                             const size_t& stride)
+{
+    const size_t objects = std::min(count, mnCount);
+
+    uint8_t* pBytes = static_cast<uint8_t*>(pObjectData);
+
+    if(pPool == nullptr)
+    {
+        for(size_t i = 0; i < objects; ++i)
+        {
+            updateObject(deltaTime, pBytes + i * stride, stride, i);
+        }
+
+        return;
+    }
+
+    // Like concurrentPerform: every thread claims one iteration at a time from a shared counter
+    std::atomic<size_t> next(0);
+
+    pPool->parallelFor(pPool->concurrency(), [&](size_t) {
+        for(size_t i = next.fetch_add(1); i < objects; i = next.fetch_add(1))
+        {
+            updateObject(deltaTime, pBytes + i * stride, stride, i);
+        }
+    }, 1);
+}
+
+#pragma mark -
+#pragma mark Private - Updater
+
+void Objects::ObjectUpdater::updateRange(const float& deltaTime,
+                                         uint8_t* pObjectData,
+                                         const size_t& stride,
+                                         const size_t& first,
+                                         const size_t& last)
+{
+    // Full lines can be streamed; anything else goes through the cache
+    const bool isStreamed = ((stride % 64) == 0) && ((reinterpret_cast<uintptr_t>(pObjectData) & 15) == 0);
+
+    const float4 dt   = splat(deltaTime);
+    const float4 zero = splat(0.0f);
+    const float4 one  = splat(1.0f);
+
+    for(size_t i = first; i < last; i += 4)
+    {
+        float4 angles[3];
+        float4 sines[3];
+        float4 cosines[3];
+
+        for(size_t a = 0; a < 3; ++a)
+        {
+            angles[a] = wrap(load(&m_Rotation[a][i]) + load(&m_RotationRate[a][i]) * dt);
+
+            sincos(angles[a], sines[a], cosines[a]);
+        }
+
+        const float4& sx = sines[0];
+        const float4& cx = cosines[0];
+        const float4& sy = sines[1];
+        const float4& cy = cosines[1];
+        const float4& sz = sines[2];
+        const float4& cz = cosines[2];
+
+        const float4 scaleX = load(&m_Scale[0][i]);
+        const float4 scaleY = load(&m_Scale[1][i]);
+        const float4 scaleZ = load(&m_Scale[2][i]);
+
+        // Columns of T * Rz * Ry * Rx * S, one component per register
+        const float4 sysx = sy * sx;
+        const float4 sycx = sy * cx;
+
+        float4 columns[4][4] =
+        {
+            {cz * cy * scaleX, sz * cy * scaleX, (zero - sy) * scaleX, zero},
+            {(cz * sysx - sz * cx) * scaleY, (sz * sysx + cz * cx) * scaleY, cy * sx * scaleY, zero},
+            {(cz * sycx + sz * sx) * scaleZ, (sz * sycx - cz * sx) * scaleZ, cy * cx * scaleZ, zero},
+            {load(&m_Position[0][i]), load(&m_Position[1][i]), load(&m_Position[2][i]), one}
+        };
+
+        // Lanes past the last object hold zeros and are never stored
+        const size_t lanes = std::min<size_t>(4, last - i);
+
+        for(size_t a = 0; a < 3; ++a)
+        {
+            float rotations[4];
+
+            store(rotations, angles[a]);
+
+            std::memcpy(&m_Rotation[a][i], rotations, lanes * sizeof(float));
+        }
+
+        for(size_t c = 0; c < 4; ++c)
+        {
+            transpose(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+        }
+
+        for(size_t lane = 0; lane < lanes; ++lane)
+        {
+            float* pRecord = reinterpret_cast<float*>(pObjectData + (i + lane) * stride);
+
+            const float4 color = load(&m_Color[4 * (i + lane)]);
+
+            if(isStreamed)
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    stream(pRecord + 4 * c, columns[c][lane]);
+                }
+
+                // Colour and pad0 to pad02 fill the second line
+                stream(pRecord + 16, color);
+                stream(pRecord + 20, zero);
+                stream(pRecord + 24, zero);
+                stream(pRecord + 28, zero);
+            }
+            else
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    store(pRecord + 4 * c, columns[c][lane]);
+                }
+
+                store(pRecord + 16, color);
+                store(pRecord + 20, zero);
+                store(pRecord + 24, zero);
+                store(pRecord + 28, zero);
+            }
+        }
+    }
+
+    // Streamed lines must be visible before the command buffer is committed
+    fence();
+}
+
+void Objects::ObjectUpdater::updateObject(const float& deltaTime,
+                                          uint8_t* pObjectData,
+                                          const size_t& stride,
+                                          const size_t& index)
+{
+    float angles[3];
+
+    for(size_t a = 0; a < 3; ++a)
+    {
+        angles[a] = wrap(m_Rotation[a][index] + m_RotationRate[a][index] * deltaTime);
+
+        m_Rotation[a][index] = angles[a];
+    }
+
+    float scale[16];
+    float rotationX[16];
+    float rotationY[16];
+    float rotationZ[16];
+    float translation[16];
+
+    identity(scale);
+    identity(rotationX);
+    identity(rotationY);
+    identity(rotationZ);
+    identity(translation);
+
+    scale[0]  = m_Scale[0][index];
+    scale[5]  = m_Scale[1][index];
+    scale[10] = m_Scale[2][index];
+
+    rotationX[5]  =  std::cos(angles[0]);
+    rotationX[6]  =  std::sin(angles[0]);
+    rotationX[9]  = -std::sin(angles[0]);
+    rotationX[10] =  std::cos(angles[0]);
+
+    rotationY[0]  =  std::cos(angles[1]);
+    rotationY[2]  = -std::sin(angles[1]);
+    rotationY[8]  =  std::sin(angles[1]);
+    rotationY[10] =  std::cos(angles[1]);
+
+    rotationZ[0] =  std::cos(angles[2]);
+    rotationZ[1] =  std::sin(angles[2]);
+    rotationZ[4] = -std::sin(angles[2]);
+    rotationZ[5] =  std::cos(angles[2]);
+
+    translation[12] = m_Position[0][index];
+    translation[13] = m_Position[1][index];
+    translation[14] = m_Position[2][index];
+
+    // ObjectData with pad1 and pad2 set to identity, as RenderableObject initialises them
+    float record[kObjectDataStride / sizeof(float)] = {};
+    float temporary[16];
+
+    multiply(rotationX, scale, record);
+    multiply(rotationY, record, temporary);
+    multiply(rotationZ, temporary, record);
+    multiply(translation, record, temporary);
+
+    std::memcpy(record, temporary, sizeof(temporary));
+    std::memcpy(record + 16, &m_Color[4 * index], 4 * sizeof(float));
+
+    identity(record + 32);
+    identity(record + 48);
+
+    std::memcpy(pObjectData, record, std::min(sizeof(record), stride));
+}
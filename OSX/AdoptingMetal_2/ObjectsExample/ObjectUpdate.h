@@ -0,0 +1,129 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Chunked update of the per-object constants. The multithreaded path of MetalView dispatches one
+ closure per object, and every closure multiplies four matrices and writes a whole 256 byte
+ ObjectData. Here the rotation state lives in cache line aligned arrays (one per component), and
+ objects are updated four at a time: SIMD sincos, a closed form Rz * Ry * Rx, then the matrix and
+ colour lines of each ObjectData are streamed with non-temporal stores. Work is handed out in
+ chunks of whole cache lines, so no two threads ever write the same line.
+ */
+
+#ifndef _OBJECTS_OBJECT_UPDATE_H_
+#define _OBJECTS_OBJECT_UPDATE_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "InstanceBatcher.h"
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace Objects
+{
+    // Size of ObjectData in SharedObjectsBridge.h
+    static const size_t kObjectDataStride = 256;
+
+    // Float array whose first element starts a cache line
+    class AlignedArray
+    {
+    public:
+        AlignedArray();
+
+        // data() finds the aligned element in m_Storage again on every call, so a copied vector
+        // whose buffer sits at a different offset would shift the elements
+        AlignedArray(const AlignedArray& rArray) = delete;
+
+        AlignedArray& operator=(const AlignedArray& rArray) = delete;
+
+        // Keeps the first min(size(), count) values
+        void resize(const size_t& count);
+
+        // Releases the storage
+        void clear();
+
+        size_t size() const;
+
+        float*       data();
+        const float* data() const;
+
+        float&       operator[](const size_t& index)       { return data()[index]; }
+        const float& operator[](const size_t& index) const { return data()[index]; }
+
+    private:
+        std::vector<float> m_Storage;
+        size_t             mnSize;
+    }; // AlignedArray
+
+    class ObjectUpdater
+    {
+    public:
+        // Objects per chunk handed to a thread, a multiple of 16 so SoA reads start cache lines
+        static const size_t kDefaultChunk = 512;
+
+        ObjectUpdater();
+
+        void reserve(const size_t& count);
+
+        void clear();
+
+        // Returns the index of the object's ObjectData
+        size_t add(const Float3& position,
+                   const Float3& scale,
+                   const Float3& rotationRate,
+                   const float* pColor);
+
+        void setRotation(const size_t& index, const Float3& rotation);
+
+        size_t count() const;
+
+        // Advance the first count objects by deltaTime and write their LocalToWorld and colour
+        // into ObjectData records stride bytes apart. Only the matrix and colour cache lines are
+        // written (pad0 to pad02 are zeroed, pad1 and pad2 are left alone). Chunks run on pPool
+        // when given, otherwise on the calling thread.
+        void update(const float& deltaTime,
+                    void* pObjectData,
+                    const size_t& count,
+                    Threads::WorkStealingPool* pPool = nullptr,
+                    const size_t& stride = kObjectDataStride,
+                    const size_t& chunk = kDefaultChunk);
+
+        // What RenderableObject.UpdateData does, dispatched one object per task: scale, three
+        // rotations and a translation multiplied as 4x4 matrices, the whole record written
+        void updatePerObject(const float& deltaTime,
+                             void* pObjectData,
+                             const size_t& count,
+                             Threads::WorkStealingPool* pPool = nullptr,
+                             const size_t& stride = kObjectDataStride);
+
+    private:
+        void updateRange(const float& deltaTime,
+                         uint8_t* pObjectData,
+                         const size_t& stride,
+                         const size_t& first,
+                         const size_t& last);
+
+        void updateObject(const float& deltaTime,
+                          uint8_t* pObjectData,
+                          const size_t& stride,
+                          const size_t& index);
+
+        size_t       mnCount;
+        AlignedArray m_Position[3];
+        AlignedArray m_Scale[3];
+        AlignedArray m_Rotation[3];      // Kept within [-pi, pi]
+        AlignedArray m_RotationRate[3];
+        AlignedArray m_Color;            // RGBA per object
+    }; // ObjectUpdater
+} // Objects
+
+#endif
+
+#endif
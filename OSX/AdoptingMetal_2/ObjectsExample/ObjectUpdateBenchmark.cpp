@@ -0,0 +1,179 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the chunked object update, a standalone program that is not part of the app target.
+ It checks that the chunked update writes the LocalToWorld and colour of the per-object update over
+ thousands of frames, zeroes pad0 to pad02 and leaves pad1 and pad2 alone, with streamed and with
+ cached stores. It then times both updates of 200k and 2M objects on the calling thread and on a
+ thread pool.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads ObjectUpdate.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp ObjectUpdateBenchmark.cpp -o benchmark
+     ./benchmark [threads]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+#include "ObjectUpdate.h"
+#include "WorkStealingPool.h"
+
+using namespace Objects;
+
+namespace
+{
+    const size_t kFloatsPerRecord = kObjectDataStride / sizeof(float);
+
+    // Canary for the floats the update must not write
+    const float kUntouched = -7.0f;
+
+    void populate(ObjectUpdater& rUpdater, const size_t& count, std::mt19937& rRandom)
+    {
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+        rUpdater.reserve(count);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            const Float3 position     = {500.0f * uniform(rRandom), 100.0f * uniform(rRandom), 500.0f * uniform(rRandom)};
+            const float  size         = 2.5f + 2.5f * uniform(rRandom);
+            const Float3 scale        = {size, size, size};
+            const Float3 rotationRate = {1.0f + uniform(rRandom), 1.0f + uniform(rRandom), 1.0f + uniform(rRandom)};
+            const float  color[4]     = {0.5f + 0.5f * uniform(rRandom), 0.5f, 0.25f, 1.0f};
+
+            rUpdater.add(position, scale, rotationRate, color);
+        }
+    }
+
+    // Records start offset floats into each buffer, so offset 1 forces the cached stores
+    bool checkUpdate(Threads::WorkStealingPool& rPool, const size_t& offset)
+    {
+        const size_t count = 10001;
+
+        std::mt19937 random(1);
+        std::mt19937 same(1);
+
+        ObjectUpdater chunked;
+        ObjectUpdater perObject;
+
+        populate(chunked, count, random);
+        populate(perObject, count, same);
+
+        std::vector<float> chunkedRecords(count * kFloatsPerRecord + offset, kUntouched);
+        std::vector<float> perObjectRecords(count * kFloatsPerRecord, kUntouched);
+
+        float* pChunked = chunkedRecords.data() + offset;
+
+        float worstMatrix = 0.0f;
+        float worstColor  = 0.0f;
+        bool  padsZero    = true;
+        bool  padsKept    = true;
+
+        for(size_t frame = 0; frame < 3000; ++frame)
+        {
+            chunked.update(1.0f / 60.0f, pChunked, count, &rPool, kObjectDataStride, 64);
+            perObject.updatePerObject(1.0f / 60.0f, perObjectRecords.data(), count);
+
+            if((frame % 500 != 0) && (frame != 2999))
+            {
+                continue;
+            }
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const float* pA = pChunked + i * kFloatsPerRecord;
+                const float* pB = perObjectRecords.data() + i * kFloatsPerRecord;
+
+                for(size_t k = 0; k < 16; ++k)
+                {
+                    worstMatrix = std::max(worstMatrix, std::fabs(pA[k] - pB[k]) / (1.0f + std::fabs(pB[k])));
+                }
+
+                for(size_t k = 16; k < 20; ++k)
+                {
+                    worstColor = std::max(worstColor, std::fabs(pA[k] - pB[k]));
+                }
+
+                for(size_t k = 20; k < 32; ++k)
+                {
+                    padsZero = padsZero && (pA[k] == 0.0f);
+                }
+
+                for(size_t k = 32; k < kFloatsPerRecord; ++k)
+                {
+                    padsKept = padsKept && (pA[k] == kUntouched);
+                }
+            }
+        }
+
+        const bool passed = (worstMatrix < 1.0e-4f) && (worstColor == 0.0f) && padsZero && padsKept;
+
+        std::printf("%s stores: largest relative difference %g, colour %g, pad0 to pad02 %s, pad1 and pad2 %s\n",
+                    (offset == 0) ? "streamed" : "cached", worstMatrix, worstColor,
+                    padsZero ? "zero" : "NOT ZERO", padsKept ? "untouched" : "WRITTEN");
+
+        return passed;
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 7; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t threads = (argc >= 2) ? size_t(std::atoi(argv[1])) : 0;
+
+    Threads::WorkStealingPool pool(threads);
+
+    if(!checkUpdate(pool, 0) || !checkUpdate(pool, 1))
+    {
+        return 1;
+    }
+
+    const size_t counts[] = {200000, 2000000};
+
+    std::mt19937 random(3);
+
+    for(const size_t& count : counts)
+    {
+        ObjectUpdater updater;
+
+        populate(updater, count, random);
+
+        // Records 64 byte aligned, as in the constant buffers
+        std::vector<float> storage(count * kFloatsPerRecord + 16, 0.0f);
+
+        float* pRecords = storage.data() + (64 - (reinterpret_cast<uintptr_t>(storage.data()) & 63)) / sizeof(float) % 16;
+
+        const double perObject     = milliseconds([&] { updater.updatePerObject(1.0f / 60.0f, pRecords, count); });
+        const double perObjectPool = milliseconds([&] { updater.updatePerObject(1.0f / 60.0f, pRecords, count, &pool); });
+        const double chunked       = milliseconds([&] { updater.update(1.0f / 60.0f, pRecords, count); });
+        const double chunkedPool   = milliseconds([&] { updater.update(1.0f / 60.0f, pRecords, count, &pool); });
+
+        std::printf("%8zu objects, %zu threads: per object %7.2f ms, per object on the pool %7.2f ms, "
+                    "chunked %7.2f ms (%.1fx), chunked on the pool %7.2f ms (%.1fx)\n",
+                    count, pool.concurrency(), perObject, perObjectPool, chunked, perObject / chunked,
+                    chunkedPool, perObjectPool / chunkedPool);
+    }
+
+    return 0;
+}
@@ -0,0 +1,17 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+ 
+ Abstract:
+ A bridging header so our swift code can see the shared structures and the C++ helpers through
+ their objC faces
+ */
+
+#ifndef ObjectsExample_Bridging_Header_h
+#define ObjectsExample_Bridging_Header_h
+
+#import "SharedObjectsBridge.h"
+#import "ObjectsInstanceBatcher.h"
+#import "ObjectsObjectUpdater.h"
+#import "ObjectsOcclusionCuller.h"
+
+#endif /* ObjectsExample_Bridging_Header_h */
@@ -0,0 +1,54 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the instance batcher in InstanceBatcher.h, so MetalView can write one
+ InstanceData record per object and draw every run of objects sharing a pipeline and a mesh with
+ one instanced call.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "SharedObjectsBridge.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Objects sharing a pipeline and a mesh, drawn with one instanced call
+typedef struct
+{
+    uint32_t pipeline;
+    uint32_t mesh;
+    uint32_t firstInstance;    // baseInstance of the draw, instance_id in the shader starts here
+    uint32_t instanceCount;
+} ObjectsDrawBatch;
+
+@interface ObjectsInstanceBatcher : NSObject
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+// Returns the object's handle; its record moves when objects change batches
+- (NSUInteger)addObjectWithPipeline:(uint32_t)pipeline
+                               mesh:(uint32_t)mesh
+                           position:(vector_float3)position
+                              scale:(vector_float3)scale
+                       rotationRate:(vector_float3)rotationRate
+                              color:(vector_float4)color;
+
+@property (nonatomic, readonly) NSUInteger count;
+
+// Instanced draws covering all objects, in instance buffer order. Safe to read from several
+// threads once the records of a frame are written.
+@property (nonatomic, readonly) NSUInteger batchCount;
+
+- (ObjectsDrawBatch)batchAtIndex:(NSUInteger)index;
+
+// Advance the rotations of the first count records by deltaTime and write them, in chunks on the
+// global queue when concurrently is set
+- (void)updateWithDeltaTime:(float)deltaTime
+                  instances:(InstanceData *)instances
+                      count:(NSUInteger)count
+               concurrently:(BOOL)concurrently;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,94 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the instance batcher in InstanceBatcher.h.
+ */
+
+#import "ObjectsInstanceBatcher.h"
+
+#import <algorithm>
+
+#import "InstanceBatcher.h"
+
+// Records per block on the global queue, a few hundred microseconds of work
+static const size_t kUpdateChunk = 8192;
+
+static Objects::Float3 toFloat3(const vector_float3& value)
+{
+    return { value.x, value.y, value.z };
+}
+
+@implementation ObjectsInstanceBatcher
+{
+    Objects::InstanceBatcher _batcher;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+
+    if(self)
+    {
+        _batcher.reserve(capacity);
+    }
+
+    return self;
+}
+
+- (NSUInteger)addObjectWithPipeline:(uint32_t)pipeline
+                               mesh:(uint32_t)mesh
+                           position:(vector_float3)position
+                              scale:(vector_float3)scale
+                       rotationRate:(vector_float3)rotationRate
+                              color:(vector_float4)color
+{
+    return _batcher.add(pipeline, mesh, toFloat3(position), toFloat3(scale), toFloat3(rotationRate),
+                        Objects::packColor(color.x, color.y, color.z, color.w));
+}
+
+- (NSUInteger)count
+{
+    return _batcher.count();
+}
+
+- (NSUInteger)batchCount
+{
+    return _batcher.batches().size();
+}
+
+- (ObjectsDrawBatch)batchAtIndex:(NSUInteger)index
+{
+    const Objects::DrawBatch& rBatch = _batcher.batches()[index];
+
+    return (ObjectsDrawBatch){ rBatch.pipeline, rBatch.mesh, rBatch.firstInstance, rBatch.instanceCount };
+}
+
+- (void)updateWithDeltaTime:(float)deltaTime
+                  instances:(InstanceData *)instances
+                      count:(NSUInteger)count
+               concurrently:(BOOL)concurrently
+{
+    Objects::InstanceBatcher* pBatcher   = &_batcher;
+    Objects::Instance*        pInstances = reinterpret_cast<Objects::Instance *>(instances);
+
+    const size_t last = std::min(size_t(count), _batcher.count());
+
+    // Re-batch before the records are written, the ranges below index the sorted objects
+    _batcher.batches();
+
+    if(!concurrently)
+    {
+        _batcher.update(deltaTime, pInstances, 0, last);
+
+        return;
+    }
+
+    const size_t chunks = (last + kUpdateChunk - 1) / kUpdateChunk;
+
+    dispatch_apply(chunks, dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0), ^(size_t chunk) {
+        pBatcher->update(deltaTime, pInstances, chunk * kUpdateChunk, std::min(last, (chunk + 1) * kUpdateChunk));
+    });
+}
+
+@end
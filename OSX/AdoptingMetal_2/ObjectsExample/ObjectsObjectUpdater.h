@@ -0,0 +1,37 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the chunked object update in ObjectUpdate.h, so MetalView can write the
+ ObjectData records of its per-object draws four objects at a time, in chunks on a thread pool.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "SharedObjectsBridge.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ObjectsObjectUpdater : NSObject
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+// Returns the index of the object's ObjectData
+- (NSUInteger)addObjectWithPosition:(vector_float3)position
+                              scale:(vector_float3)scale
+                       rotationRate:(vector_float3)rotationRate
+                              color:(vector_float4)color;
+
+@property (nonatomic, readonly) NSUInteger count;
+
+// Advance the first count objects by deltaTime and write their LocalToWorld, colour and pad0 to
+// pad02 into consecutive ObjectData records; pad1 and pad2 are left alone. Chunks run on a thread
+// pool when concurrently is set.
+- (void)updateWithDeltaTime:(float)deltaTime
+                 objectData:(ObjectData *)objectData
+                      count:(NSUInteger)count
+               concurrently:(BOOL)concurrently;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,67 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the chunked object update in ObjectUpdate.h.
+ */
+
+#import "ObjectsObjectUpdater.h"
+
+#import "ObjectUpdate.h"
+#import "WorkStealingPool.h"
+
+static_assert(sizeof(ObjectData) == Objects::kObjectDataStride, "ObjectData layout mismatch");
+
+static Threads::WorkStealingPool & updatePool()
+{
+    static Threads::WorkStealingPool pool;
+
+    return pool;
+}
+
+static Objects::Float3 toFloat3(const vector_float3& value)
+{
+    return { value.x, value.y, value.z };
+}
+
+@implementation ObjectsObjectUpdater
+{
+    Objects::ObjectUpdater _updater;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+
+    if(self)
+    {
+        _updater.reserve(capacity);
+    }
+
+    return self;
+}
+
+- (NSUInteger)addObjectWithPosition:(vector_float3)position
+                              scale:(vector_float3)scale
+                       rotationRate:(vector_float3)rotationRate
+                              color:(vector_float4)color
+{
+    const float rgba[4] = { color.x, color.y, color.z, color.w };
+
+    return _updater.add(toFloat3(position), toFloat3(scale), toFloat3(rotationRate), rgba);
+}
+
+- (NSUInteger)count
+{
+    return _updater.count();
+}
+
+- (void)updateWithDeltaTime:(float)deltaTime
+                 objectData:(ObjectData *)objectData
+                      count:(NSUInteger)count
+               concurrently:(BOOL)concurrently
+{
+    _updater.update(deltaTime, objectData, count, concurrently ? &updatePool() : nullptr);
+}
+
+@end
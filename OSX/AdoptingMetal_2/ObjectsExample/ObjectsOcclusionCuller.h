@@ -0,0 +1,55 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the occlusion culler in OcclusionCuller.h, so MetalView can copy the records
+ a pass can see into a buffer of their own and encode only the instanced draws of those.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "SharedObjectsBridge.h"
+#import "ObjectsInstanceBatcher.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef struct
+{
+    NSUInteger tested;
+    NSUInteger outside;     // Outside the view frustum
+    NSUInteger occluded;    // Inside the frustum, behind the occluders
+    NSUInteger visible;
+    NSUInteger occluders;   // Rasterised for the view
+} ObjectsCullStats;
+
+@interface ObjectsOcclusionCuller : NSObject
+
+// A width by height depth buffer, into which every view rasterises the static occluders and then
+// up to maxOccluders of the records, the largest ones on screen first. Without occluders only the
+// records outside the view frustum are culled.
+- (instancetype)initWithWidth:(uint32_t)width
+                       height:(uint32_t)height
+                 maxOccluders:(NSUInteger)maxOccluders;
+
+// Rasterised in every view, such as the ground plane as a record with a zero y scale
+- (void)addStaticOccluder:(InstanceData)occluder;
+
+// Cull the first count records, as the batcher batches them, from viewProjection (column major,
+// depth in [0, 1]). The visible ones are copied to visibleInstances in instance buffer order and
+// the batches rebuilt to draw them. Chunks run on a thread pool when concurrently is set.
+- (ObjectsCullStats)cullInstances:(const InstanceData *)instances
+                            count:(NSUInteger)count
+                          batcher:(ObjectsInstanceBatcher *)batcher
+                   viewProjection:(matrix_float4x4)viewProjection
+                 visibleInstances:(InstanceData *)visibleInstances
+                     concurrently:(BOOL)concurrently;
+
+// Instanced draws of the visible records of the last cull, whose firstInstance indexes
+// visibleInstances. Safe to read from several threads until the next cull.
+@property (nonatomic, readonly) NSUInteger batchCount;
+
+- (ObjectsDrawBatch)batchAtIndex:(NSUInteger)index;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,122 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the occlusion culler in OcclusionCuller.h.
+ */
+
+#import "ObjectsOcclusionCuller.h"
+
+#import <memory>
+#import <numeric>
+#import <vector>
+
+#import "OcclusionCuller.h"
+#import "WorkStealingPool.h"
+
+static_assert(sizeof(InstanceData) == sizeof(Objects::Instance), "InstanceData layout mismatch");
+
+static Threads::WorkStealingPool & cullingPool()
+{
+    static Threads::WorkStealingPool pool;
+
+    return pool;
+}
+
+@implementation ObjectsOcclusionCuller
+{
+    std::unique_ptr<Objects::OcclusionCuller> _culler;
+    NSUInteger                                _maxOccluders;
+    std::vector<Objects::Instance>            _staticOccluders;
+    std::vector<Objects::DrawBatch>           _batches;
+    std::vector<Objects::DrawBatch>           _visibleBatches;
+    std::vector<uint32_t>                     _visible;
+}
+
+- (instancetype)initWithWidth:(uint32_t)width
+                       height:(uint32_t)height
+                 maxOccluders:(NSUInteger)maxOccluders
+{
+    self = [super init];
+
+    if(self)
+    {
+        _culler.reset(new Objects::OcclusionCuller(width, height));
+        _maxOccluders = maxOccluders;
+    }
+
+    return self;
+}
+
+- (void)addStaticOccluder:(InstanceData)occluder
+{
+    _staticOccluders.push_back(*reinterpret_cast<const Objects::Instance *>(&occluder));
+}
+
+- (ObjectsCullStats)cullInstances:(const InstanceData *)instances
+                            count:(NSUInteger)count
+                          batcher:(ObjectsInstanceBatcher *)batcher
+                   viewProjection:(matrix_float4x4)viewProjection
+                 visibleInstances:(InstanceData *)visibleInstances
+                     concurrently:(BOOL)concurrently
+{
+    const Objects::Instance *pInstances = reinterpret_cast<const Objects::Instance *>(instances);
+
+    Threads::WorkStealingPool *pPool = concurrently ? &cullingPool() : nullptr;
+
+    Objects::CullStats stats = {};
+
+    if(_culler->begin(reinterpret_cast<const float *>(&viewProjection)))
+    {
+        for(const Objects::Instance& rOccluder : _staticOccluders)
+        {
+            _culler->addOccluder(rOccluder);
+        }
+
+        if(_maxOccluders > 0)
+        {
+            _culler->addOccluders(pInstances, count, _maxOccluders, 0.5f, pPool);
+        }
+
+        _culler->end();
+
+        stats = _culler->cull(pInstances, count, _visible, 0.5f, pPool);
+    }
+    else
+    {
+        // A singular view culls nothing
+        _visible.resize(count);
+
+        std::iota(_visible.begin(), _visible.end(), 0);
+
+        stats.tested  = count;
+        stats.visible = count;
+    }
+
+    _batches.clear();
+
+    for(NSUInteger index = 0; index < batcher.batchCount; ++index)
+    {
+        const ObjectsDrawBatch batch = [batcher batchAtIndex:index];
+
+        _batches.push_back({ batch.pipeline, batch.mesh, batch.firstInstance, batch.instanceCount });
+    }
+
+    Objects::compact(pInstances, _batches, _visible, reinterpret_cast<Objects::Instance *>(visibleInstances), _visibleBatches);
+
+    return (ObjectsCullStats){ stats.tested, stats.outside, stats.occluded, stats.visible, stats.occluders };
+}
+
+- (NSUInteger)batchCount
+{
+    return _visibleBatches.size();
+}
+
+- (ObjectsDrawBatch)batchAtIndex:(NSUInteger)index
+{
+    const Objects::DrawBatch& rBatch = _visibleBatches[index];
+
+    return (ObjectsDrawBatch){ rBatch.pipeline, rBatch.mesh, rBatch.firstInstance, rBatch.instanceCount };
+}
+
+@end
@@ -0,0 +1,1179 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Software occlusion culling. Occluders are rasterised as the convex silhouette of their box clipped
+ to the near plane; the depth of a pixel is the farthest of the box's front face planes at the
+ pixel's farthest corner, which for a convex body is where every ray through the pixel enters it.
+ Objects are culled when the depth pyramid holds nearer occluders under all of their bounds.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "OcclusionCuller.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace Objects
+{
+    // Local to this file, ObjectUpdate.cpp has a float4 of its own
+    namespace
+    {
+        // Four pixels, or one component of four records or of four points in clip space
+        struct float4
+        {
+#if defined(__SSE2__)
+            __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            float32x4_t v;
+#else
+            float v[4];
+#endif
+        };
+
+#if defined(__SSE2__)
+        static inline float4 load(const float* p)                        { return {_mm_loadu_ps(p)}; }
+        static inline void   store(float* p, const float4& a)            { _mm_storeu_ps(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {_mm_set1_ps(s)}; }
+        static inline float4 set(float a, float b, float c, float d)     { return {_mm_setr_ps(a, b, c, d)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {_mm_sub_ps(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+        static inline float4 operator/(const float4& a, const float4& b) { return {_mm_div_ps(a.v, b.v)}; }
+        static inline float4 min(const float4& a, const float4& b)       { return {_mm_min_ps(a.v, b.v)}; }
+        static inline float4 max(const float4& a, const float4& b)       { return {_mm_max_ps(a.v, b.v)}; }
+
+        // Bit i set where lane i of a is less than lane i of b
+        static inline int less(const float4& a, const float4& b)         { return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)); }
+
+        // Maxima of the pairs of lanes of a, then of b
+        static inline float4 pairs(const float4& a, const float4& b)
+        {
+            return {_mm_max_ps(_mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(3, 1, 3, 1)))};
+        }
+
+        static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+        {
+            _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+        }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        static inline float4 load(const float* p)                        { return {vld1q_f32(p)}; }
+        static inline void   store(float* p, const float4& a)            { vst1q_f32(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {vdupq_n_f32(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {vsubq_f32(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+        static inline float4 min(const float4& a, const float4& b)       { return {vminq_f32(a.v, b.v)}; }
+        static inline float4 max(const float4& a, const float4& b)       { return {vmaxq_f32(a.v, b.v)}; }
+
+        static inline float4 set(float a, float b, float c, float d)
+        {
+            const float values[4] = {a, b, c, d};
+
+            return {vld1q_f32(values)};
+        }
+
+        static inline float4 operator/(const float4& a, const float4& b)
+        {
+#if defined(__aarch64__)
+            return {vdivq_f32(a.v, b.v)};
+#else
+            // Reciprocal estimate and two Newton-Raphson steps
+            float32x4_t r = vrecpeq_f32(b.v);
+
+            r = vmulq_f32(r, vrecpsq_f32(b.v, r));
+            r = vmulq_f32(r, vrecpsq_f32(b.v, r));
+
+            return {vmulq_f32(a.v, r)};
+#endif
+        }
+
+        static inline int less(const float4& a, const float4& b)
+        {
+            const uint32x4_t mask = vcltq_f32(a.v, b.v);
+
+            return int((vgetq_lane_u32(mask, 0) & 1) | (vgetq_lane_u32(mask, 1) & 2) | (vgetq_lane_u32(mask, 2) & 4) | (vgetq_lane_u32(mask, 3) & 8));
+        }
+
+        static inline float4 pairs(const float4& a, const float4& b)
+        {
+            const float32x4x2_t split = vuzpq_f32(a.v, b.v);
+
+            return {vmaxq_f32(split.val[0], split.val[1])};
+        }
+
+        static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+        {
+            const float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+            const float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+
+            a.v = vcombine_f32(vget_low_f32(ab.val[0]),  vget_low_f32(cd.val[0]));
+            b.v = vcombine_f32(vget_low_f32(ab.val[1]),  vget_low_f32(cd.val[1]));
+            c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+            d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+        }
+#else
+        static inline float4 load(const float* p)             { return {{p[0], p[1], p[2], p[3]}}; }
+        static inline void   store(float* p, const float4& a) { std::memcpy(p, a.v, sizeof(a.v)); }
+        static inline float4 splat(const float& s)            { return {{s, s, s, s}}; }
+
+        static inline float4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+
+        static inline float4 operator+(const float4& a, const float4& b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+        static inline float4 operator/(const float4& a, const float4& b) { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+
+        static inline float4 min(const float4& a, const float4& b)
+        {
+            return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}};
+        }
+
+        static inline float4 max(const float4& a, const float4& b)
+        {
+            return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+        }
+
+        static inline int less(const float4& a, const float4& b)
+        {
+            return (a.v[0] < b.v[0] ? 1 : 0) | (a.v[1] < b.v[1] ? 2 : 0) | (a.v[2] < b.v[2] ? 4 : 0) | (a.v[3] < b.v[3] ? 8 : 0);
+        }
+
+        static inline float4 pairs(const float4& a, const float4& b)
+        {
+            return {{std::max(a.v[0], a.v[1]), std::max(a.v[2], a.v[3]), std::max(b.v[0], b.v[1]), std::max(b.v[2], b.v[3])}};
+        }
+
+        static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+        {
+            float4* rows[4] = {&a, &b, &c, &d};
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                for(size_t j = i + 1; j < 4; ++j)
+                {
+                    std::swap(rows[i]->v[j], rows[j]->v[i]);
+                }
+            }
+        }
+#endif
+
+        // Clip space w below which a point counts as at the eye
+        static const float  kMinW = 1.0e-5f;
+
+        // Added to rasterised depths so that rounding never puts an occluder in front of itself
+        static const double kDepthBias = 1.0e-6;
+
+        // Faces closer to edge on than this (distance from the eye to the face's plane in world
+        // units, or the cosine between its normal and a parallel projection's direction) skip
+        // the occluder
+        static const double kEdgeOn = 1.0e-3;
+
+        struct Point
+        {
+            double x;
+            double y;
+        };
+
+        struct Candidate
+        {
+            float    score;
+            uint32_t index;
+        };
+
+        static double cross(const Point& o, const Point& a, const Point& b)
+        {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+        }
+
+        // Convex hull (Andrew's monotone chain), counterclockwise without collinear points
+        static size_t hull(Point* pPoints, const size_t& count, Point* pHull)
+        {
+            std::sort(pPoints, pPoints + count, [](const Point& a, const Point& b) {
+                return (a.x < b.x) || ((a.x == b.x) && (a.y < b.y));
+            });
+
+            size_t size = 0;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                while((size >= 2) && (cross(pHull[size - 2], pHull[size - 1], pPoints[i]) <= 0.0))
+                {
+                    --size;
+                }
+
+                pHull[size++] = pPoints[i];
+            }
+
+            const size_t lower = size + 1;
+
+            for(size_t i = count - 1; i-- > 0;)
+            {
+                while((size >= lower) && (cross(pHull[size - 2], pHull[size - 1], pPoints[i]) <= 0.0))
+                {
+                    --size;
+                }
+
+                pHull[size++] = pPoints[i];
+            }
+
+            // The last point repeats the first
+            return (size > 1) ? (size - 1) : size;
+        }
+
+        // Gauss-Jordan with partial pivoting
+        static bool invert(const double (*pMatrix)[4], double (*pInverse)[4])
+        {
+            double a[4][8];
+
+            for(size_t r = 0; r < 4; ++r)
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    a[r][c]     = pMatrix[r][c];
+                    a[r][c + 4] = (r == c) ? 1.0 : 0.0;
+                }
+            }
+
+            for(size_t c = 0; c < 4; ++c)
+            {
+                size_t pivot = c;
+
+                for(size_t r = c + 1; r < 4; ++r)
+                {
+                    if(std::fabs(a[r][c]) > std::fabs(a[pivot][c]))
+                    {
+                        pivot = r;
+                    }
+                }
+
+                if(std::fabs(a[pivot][c]) < 1.0e-12)
+                {
+                    return false;
+                }
+
+                std::swap(a[c], a[pivot]);
+
+                const double scale = 1.0 / a[c][c];
+
+                for(size_t k = 0; k < 8; ++k)
+                {
+                    a[c][k] *= scale;
+                }
+
+                for(size_t r = 0; r < 4; ++r)
+                {
+                    if(r != c)
+                    {
+                        const double factor = a[r][c];
+
+                        for(size_t k = 0; k < 8; ++k)
+                        {
+                            a[r][k] -= factor * a[c][k];
+                        }
+                    }
+                }
+            }
+
+            for(size_t r = 0; r < 4; ++r)
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    pInverse[r][c] = a[r][c + 4];
+                }
+            }
+
+            return true;
+        }
+    } // namespace
+} // Objects
+
+#pragma mark -
+#pragma mark Public - Culler
+
+const uint32_t Objects::OcclusionCuller::kDefaultWidth;
+const uint32_t Objects::OcclusionCuller::kDefaultHeight;
+const size_t   Objects::OcclusionCuller::kDefaultChunk;
+
+Objects::OcclusionCuller::OcclusionCuller(const uint32_t& width, const uint32_t& height)
+: mnWidth(std::max<uint32_t>(width, 1)), mnHeight(std::max<uint32_t>(height, 1)), mnOccluders(0)
+{
+    std::memset(m_ViewProjection, 0, sizeof(m_ViewProjection));
+    std::memset(m_Inverse, 0, sizeof(m_Inverse));
+    std::memset(m_Eye, 0, sizeof(m_Eye));
+
+    uint32_t levelWidth  = mnWidth;
+    uint32_t levelHeight = mnHeight;
+
+    for(;;)
+    {
+        Level level;
+
+        // Pyramid rows read up to seven floats past the last texel of the level below
+        level.width  = levelWidth;
+        level.height = levelHeight;
+        level.pitch  = ((levelWidth + 3) & ~uint32_t(3)) + 8;
+
+        level.depth.assign(size_t(level.pitch) * levelHeight, 1.0f);
+
+        m_Levels.push_back(level);
+
+        if((levelWidth == 1) && (levelHeight == 1))
+        {
+            break;
+        }
+
+        levelWidth  = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+uint32_t Objects::OcclusionCuller::width() const
+{
+    return mnWidth;
+}
+
+uint32_t Objects::OcclusionCuller::height() const
+{
+    return mnHeight;
+}
+
+bool Objects::OcclusionCuller::begin(const float* pViewProjection)
+{
+    std::memcpy(m_ViewProjection, pViewProjection, sizeof(m_ViewProjection));
+
+    // Levels above 0 are cleared too, so culling before end() finds nothing occluded
+    for(Level& rLevel : m_Levels)
+    {
+        std::fill(rLevel.depth.begin(), rLevel.depth.end(), 1.0f);
+    }
+
+    mnOccluders = 0;
+
+    double matrix[4][4];
+
+    for(size_t r = 0; r < 4; ++r)
+    {
+        for(size_t c = 0; c < 4; ++c)
+        {
+            matrix[r][c] = pViewProjection[4 * c + r];
+        }
+    }
+
+    if(!invert(matrix, m_Inverse))
+    {
+        return false;
+    }
+
+    // The eye maps to x = y = w = 0, a multiple of the inverse's third column. A parallel
+    // projection has it at infinity, in the direction that lowers the depth.
+    for(size_t r = 0; r < 4; ++r)
+    {
+        m_Eye[r] = m_Inverse[r][2];
+    }
+
+    const double length = std::sqrt(m_Eye[0] * m_Eye[0] + m_Eye[1] * m_Eye[1] + m_Eye[2] * m_Eye[2]);
+
+    if(std::fabs(m_Eye[3]) > 1.0e-9 * length)
+    {
+        for(size_t r = 0; r < 4; ++r)
+        {
+            m_Eye[r] /= m_Eye[3];
+        }
+
+        m_Eye[3] = 1.0;
+    }
+    else
+    {
+        for(size_t r = 0; r < 3; ++r)
+        {
+            m_Eye[r] = -m_Eye[r] / length;
+        }
+
+        m_Eye[3] = 0.0;
+    }
+
+    return true;
+}
+
+bool Objects::OcclusionCuller::addOccluder(const Instance& rInstance, const float& extent)
+{
+    float matrix[16];
+
+    localToWorld(rInstance, matrix);
+
+    double center[3];
+    double axes[3][3];
+
+    for(size_t i = 0; i < 3; ++i)
+    {
+        center[i] = matrix[12 + i];
+
+        for(size_t k = 0; k < 3; ++k)
+        {
+            axes[k][i] = double(extent) * matrix[4 * k + i];
+        }
+    }
+
+    // Screen space planes of the faces towards the eye, depth = a * x + b * y + c in pixels
+    double faces[3][3];
+    size_t count = 0;
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+        const double* u = axes[(k + 1) % 3];
+        const double* v = axes[(k + 2) % 3];
+
+        double normal[3] =
+        {
+            u[1] * v[2] - u[2] * v[1],
+            u[2] * v[0] - u[0] * v[2],
+            u[0] * v[1] - u[1] * v[0]
+        };
+
+        const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+        // Faces of zero area, such as the sides of the ground plane
+        if(length <= 1.0e-12)
+        {
+            continue;
+        }
+
+        // Distance from the center to the faces, which coincide when the box is flat
+        double offset = (normal[0] * axes[k][0] + normal[1] * axes[k][1] + normal[2] * axes[k][2]) / length;
+
+        for(size_t i = 0; i < 3; ++i)
+        {
+            normal[i] *= ((offset < 0.0) ? -1.0 : 1.0) / length;
+        }
+
+        offset = std::fabs(offset);
+
+        for(double side = 1.0; side >= -1.0; side -= 2.0)
+        {
+            // Positive outside the box
+            const double plane[4] =
+            {
+                side * normal[0],
+                side * normal[1],
+                side * normal[2],
+                -side * (normal[0] * center[0] + normal[1] * center[1] + normal[2] * center[2]) - offset
+            };
+
+            const double facing = plane[0] * m_Eye[0] + plane[1] * m_Eye[1] + plane[2] * m_Eye[2] + plane[3] * m_Eye[3];
+
+            if(std::fabs(facing) <= kEdgeOn)
+            {
+                return false;
+            }
+
+            if(facing < 0.0)
+            {
+                continue;
+            }
+
+            // The plane in clip space, through the inverse transpose
+            double q[4];
+
+            for(size_t c = 0; c < 4; ++c)
+            {
+                q[c] = plane[0] * m_Inverse[0][c] + plane[1] * m_Inverse[1][c] + plane[2] * m_Inverse[2][c] + plane[3] * m_Inverse[3][c];
+            }
+
+            if(std::fabs(q[2]) < 1.0e-12)
+            {
+                return false;
+            }
+
+            // z = -(q0 * x + q1 * y + q3) / q2 with x = 2 * px / width - 1 and y = 1 - 2 * py / height
+            faces[count][0] = -2.0 * q[0] / (q[2] * mnWidth);
+            faces[count][1] =  2.0 * q[1] / (q[2] * mnHeight);
+            faces[count][2] = (q[0] - q[1] - q[3]) / q[2];
+
+            ++count;
+        }
+    }
+
+    // The eye is inside the box
+    if(count == 0)
+    {
+        return false;
+    }
+
+    // Corners, bit k choosing the sign of axis k
+    double corners[8][4];
+
+    for(size_t i = 0; i < 8; ++i)
+    {
+        double point[3];
+
+        for(size_t j = 0; j < 3; ++j)
+        {
+            point[j] = center[j];
+
+            for(size_t k = 0; k < 3; ++k)
+            {
+                point[j] += ((i >> k) & 1) ? axes[k][j] : -axes[k][j];
+            }
+        }
+
+        for(size_t r = 0; r < 4; ++r)
+        {
+            corners[i][r] = m_ViewProjection[r] * point[0] + m_ViewProjection[4 + r] * point[1] + m_ViewProjection[8 + r] * point[2] + m_ViewProjection[12 + r];
+        }
+    }
+
+    // The silhouette of the box clipped to the near plane is the hull of the corners in front of
+    // it and of the points where the edges cross it
+    Point  points[20];
+    size_t pointCount = 0;
+
+    const double halfWidth  = 0.5 * mnWidth;
+    const double halfHeight = 0.5 * mnHeight;
+
+    auto project = [&](const double* pClip) -> bool {
+        if(pClip[3] <= kMinW)
+        {
+            return false;
+        }
+
+        points[pointCount].x = (pClip[0] / pClip[3] + 1.0) * halfWidth;
+        points[pointCount].y = (1.0 - pClip[1] / pClip[3]) * halfHeight;
+
+        ++pointCount;
+
+        return true;
+    };
+
+    for(size_t i = 0; i < 8; ++i)
+    {
+        if((corners[i][2] >= 0.0) && !project(corners[i]))
+        {
+            return false;
+        }
+
+        for(size_t k = 0; k < 3; ++k)
+        {
+            const size_t j = i | (size_t(1) << k);
+
+            if((j == i) || ((corners[i][2] < 0.0) == (corners[j][2] < 0.0)))
+            {
+                continue;
+            }
+
+            const double t = corners[i][2] / (corners[i][2] - corners[j][2]);
+
+            double crossing[4];
+
+            for(size_t r = 0; r < 4; ++r)
+            {
+                crossing[r] = corners[i][r] + t * (corners[j][r] - corners[i][r]);
+            }
+
+            if(!project(crossing))
+            {
+                return false;
+            }
+        }
+    }
+
+    Point  polygon[21];
+    size_t edges = (pointCount >= 3) ? hull(points, pointCount, polygon) : 0;
+
+    if(edges < 3)
+    {
+        return false;
+    }
+
+    // Inward edge functions a * x + b * y + c, shifted by half a pixel so that only pixels
+    // entirely inside pass
+    double lines[20][3];
+    double top    = polygon[0].y;
+    double bottom = polygon[0].y;
+
+    for(size_t e = 0; e < edges; ++e)
+    {
+        const Point& p = polygon[e];
+        const Point& q = polygon[(e + 1) % edges];
+
+        lines[e][0] = p.y - q.y;
+        lines[e][1] = q.x - p.x;
+        lines[e][2] = -(lines[e][0] * p.x + lines[e][1] * p.y) - 0.5 * (std::fabs(lines[e][0]) + std::fabs(lines[e][1]));
+
+        top    = std::min(top, p.y);
+        bottom = std::max(bottom, p.y);
+    }
+
+    const int32_t firstRow = int32_t(std::max(std::floor(top), 0.0));
+    const int32_t lastRow  = int32_t(std::min(std::floor(bottom), double(mnHeight) - 1.0));
+
+    bool isCovering = false;
+
+    for(int32_t row = firstRow; row <= lastRow; ++row)
+    {
+        const double y = row + 0.5;
+
+        // Pixel centers
+        double left  = 0.5;
+        double right = mnWidth - 0.5;
+
+        for(size_t e = 0; (e < edges) && (left <= right); ++e)
+        {
+            const double a = lines[e][0];
+            const double r = -(lines[e][1] * y + lines[e][2]);
+
+            if(a > 0.0)
+            {
+                left = std::max(left, r / a);
+            }
+            else if(a < 0.0)
+            {
+                right = std::min(right, r / a);
+            }
+            else if(r > 0.0)
+            {
+                right = -1.0;
+            }
+        }
+
+        if(left > right)
+        {
+            continue;
+        }
+
+        const uint32_t first = uint32_t(std::ceil(left - 0.5));
+        const uint32_t last  = uint32_t(std::floor(right - 0.5));
+
+        if(first > last)
+        {
+            continue;
+        }
+
+        // Depth of each plane at the farthest corner of the pixels in column 0 of the row
+        float bases[3];
+        float slopes[3];
+
+        for(size_t f = 0; f < count; ++f)
+        {
+            const double a = faces[f][0];
+            const double b = faces[f][1];
+
+            bases[f]  = float(0.5 * a + b * y + faces[f][2] + 0.5 * (std::fabs(a) + std::fabs(b)) + kDepthBias);
+            slopes[f] = float(a);
+        }
+
+        fill(uint32_t(row), first, last, bases, slopes, count);
+
+        isCovering = true;
+    }
+
+    mnOccluders += isCovering ? 1 : 0;
+
+    return isCovering;
+}
+
+size_t Objects::OcclusionCuller::addOccluders(const Instance* pInstances,
+                                              const size_t& count,
+                                              const size_t& maxOccluders,
+                                              const float& extent,
+                                              Threads::WorkStealingPool* pPool)
+{
+    const float* m = m_ViewProjection;
+
+    // Clip space x and y per world unit at most
+    const float scaleX = std::sqrt(m[0] * m[0] + m[4] * m[4] + m[8] * m[8]);
+    const float scaleY = std::sqrt(m[1] * m[1] + m[5] * m[5] + m[9] * m[9]);
+
+    const bool isPerspective = (m_Eye[3] != 0.0);
+
+    const size_t grain  = kDefaultChunk;
+    const size_t chunks = (count + grain - 1) / grain;
+
+    std::vector<std::vector<Candidate>> candidates(chunks);
+
+    // Score records by the radius in pixels of the sphere inside them
+    auto score = [&](size_t c) {
+        std::vector<Candidate>& rCandidates = candidates[c];
+
+        for(size_t i = c * grain; i < std::min(count, (c + 1) * grain); ++i)
+        {
+            const Instance& rInstance = pInstances[i];
+
+            const float* t = rInstance.translation;
+            const float* s = rInstance.scale;
+
+            const float w = m[3] * t[0] + m[7] * t[1] + m[11] * t[2] + m[15];
+            const float x = m[0] * t[0] + m[4] * t[1] + m[8]  * t[2] + m[12];
+            const float y = m[1] * t[0] + m[5] * t[1] + m[9]  * t[2] + m[13];
+
+            const float outer = extent * std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+            const float inner = extent * std::min(std::fabs(s[0]), std::min(std::fabs(s[1]), std::fabs(s[2])));
+
+            if((w <= kMinW) || (isPerspective && (w <= outer)))
+            {
+                continue;
+            }
+
+            if((std::fabs(x) > w + outer * scaleX) || (std::fabs(y) > w + outer * scaleY))
+            {
+                continue;
+            }
+
+            const float pixels = inner * scaleY * 0.5f * mnHeight / w;
+
+            if(pixels >= 1.0f)
+            {
+                rCandidates.push_back({pixels, uint32_t(i)});
+            }
+        }
+    };
+
+    if((pPool == nullptr) || (chunks < 2))
+    {
+        for(size_t c = 0; c < chunks; ++c)
+        {
+            score(c);
+        }
+    }
+    else
+    {
+        pPool->parallelFor(chunks, score, 1);
+    }
+
+    std::vector<Candidate> best;
+
+    for(const std::vector<Candidate>& rCandidates : candidates)
+    {
+        best.insert(best.end(), rCandidates.begin(), rCandidates.end());
+    }
+
+    auto isLarger = [](const Candidate& a, const Candidate& b) { return a.score > b.score; };
+
+    if(best.size() > maxOccluders)
+    {
+        std::nth_element(best.begin(), best.begin() + maxOccluders, best.end(), isLarger);
+
+        best.resize(maxOccluders);
+    }
+
+    size_t added = 0;
+
+    for(const Candidate& rCandidate : best)
+    {
+        added += addOccluder(pInstances[rCandidate.index], extent) ? 1 : 0;
+    }
+
+    return added;
+}
+
+void Objects::OcclusionCuller::end()
+{
+    for(size_t l = 0; l < m_Levels.size(); ++l)
+    {
+        Level& rLevel = m_Levels[l];
+
+        if(l > 0)
+        {
+            const Level& rBelow = m_Levels[l - 1];
+
+            for(uint32_t y = 0; y < rLevel.height; ++y)
+            {
+                const float* pRow0 = &rBelow.depth[size_t(rBelow.pitch) * std::min(2 * y, rBelow.height - 1)];
+                const float* pRow1 = &rBelow.depth[size_t(rBelow.pitch) * std::min(2 * y + 1, rBelow.height - 1)];
+
+                float* pDepth = &rLevel.depth[size_t(rLevel.pitch) * y];
+
+                for(uint32_t x = 0; x < rLevel.width; x += 4)
+                {
+                    const float4 a = max(load(pRow0 + 2 * x),     load(pRow1 + 2 * x));
+                    const float4 b = max(load(pRow0 + 2 * x + 4), load(pRow1 + 2 * x + 4));
+
+                    store(pDepth + x, pairs(a, b));
+                }
+            }
+        }
+
+        // The padding repeats the last texel of each row, which an odd width pairs up with
+        for(uint32_t y = 0; y < rLevel.height; ++y)
+        {
+            float* pRow = &rLevel.depth[size_t(rLevel.pitch) * y];
+
+            std::fill(pRow + rLevel.width, pRow + rLevel.pitch, pRow[rLevel.width - 1]);
+        }
+    }
+}
+
+bool Objects::OcclusionCuller::isVisible(const Instance& rInstance, const float& extent) const
+{
+    uint8_t result = eResultVisible;
+
+    classify(&rInstance, 1, extent, &result);
+
+    return result == eResultVisible;
+}
+
+Objects::CullStats Objects::OcclusionCuller::cull(const Instance* pInstances,
+                                                  const size_t& count,
+                                                  std::vector<uint32_t>& rVisible,
+                                                  const float& extent,
+                                                  Threads::WorkStealingPool* pPool,
+                                                  const size_t& chunk)
+{
+    const size_t grain  = std::max<size_t>(chunk, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+
+    m_Results.resize(count);
+
+    auto test = [&](size_t c) {
+        const size_t last = std::min(count, (c + 1) * grain);
+
+        for(size_t i = c * grain; i < last; i += 4)
+        {
+            classify(pInstances + i, std::min<size_t>(last - i, 4), extent, &m_Results[i]);
+        }
+    };
+
+    if((pPool == nullptr) || (chunks < 2))
+    {
+        for(size_t c = 0; c < chunks; ++c)
+        {
+            test(c);
+        }
+    }
+    else
+    {
+        pPool->parallelFor(chunks, test, 1);
+    }
+
+    CullStats stats = {};
+
+    stats.tested    = count;
+    stats.occluders = mnOccluders;
+
+    rVisible.clear();
+    rVisible.reserve(count);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        switch(m_Results[i])
+        {
+            case eResultOutside:
+                ++stats.outside;
+                break;
+
+            case eResultOccluded:
+                ++stats.occluded;
+                break;
+
+            default:
+                rVisible.push_back(uint32_t(i));
+                break;
+        }
+    }
+
+    stats.visible = rVisible.size();
+
+    return stats;
+}
+
+size_t Objects::OcclusionCuller::levels() const
+{
+    return m_Levels.size();
+}
+
+const float* Objects::OcclusionCuller::depth(const size_t& level) const
+{
+    return m_Levels[level].depth.data();
+}
+
+uint32_t Objects::OcclusionCuller::pitch(const size_t& level) const
+{
+    return m_Levels[level].pitch;
+}
+
+#pragma mark -
+#pragma mark Private - Culler
+
+void Objects::OcclusionCuller::classify(const Instance* pInstances,
+                                        const size_t& count,
+                                        const float& extent,
+                                        uint8_t* pResults) const
+{
+    // One record per lane; a short group repeats its last record. The scale is loaded together
+    // with the colour, whose lane is dropped.
+    float4 rotation[4];
+    float4 translation[4];
+    float4 scale[4];
+
+    for(size_t i = 0; i < 4; ++i)
+    {
+        const Instance& rInstance = pInstances[std::min(i, count - 1)];
+
+        rotation[i]    = load(rInstance.rotation);
+        translation[i] = load(rInstance.translation);
+        scale[i]       = load(rInstance.scale);
+    }
+
+    transpose(rotation[0], rotation[1], rotation[2], rotation[3]);
+    transpose(translation[0], translation[1], translation[2], translation[3]);
+    transpose(scale[0], scale[1], scale[2], scale[3]);
+
+    const float4 zero = splat(0.0f);
+    const float4 one  = splat(1.0f);
+    const float4 two  = splat(2.0f);
+
+    const float4& x = rotation[0];
+    const float4& y = rotation[1];
+    const float4& z = rotation[2];
+    const float4& w = rotation[3];
+
+    // The half axes of the boxes, the columns of localToWorld scaled by the extent
+    const float4 scale0 = scale[0] * splat(extent);
+    const float4 scale1 = scale[1] * splat(extent);
+    const float4 scale2 = scale[2] * splat(extent);
+
+    const float4 columns[3][3] =
+    {
+        {(one - two * (y * y + z * z)) * scale0, two * (x * y + w * z) * scale0,         two * (x * z - w * y) * scale0},
+        {two * (x * y - w * z) * scale1,         (one - two * (x * x + z * z)) * scale1, two * (y * z + w * x) * scale1},
+        {two * (x * z + w * y) * scale2,         two * (y * z - w * x) * scale2,         (one - two * (x * x + y * y)) * scale2}
+    };
+
+    const float* m = m_ViewProjection;
+
+    // The corners in clip space; bits 0, 1 and 2 of a corner's index choose the signs of the axes
+    float4 corners[8][4];
+
+    for(size_t r = 0; r < 4; ++r)
+    {
+        const float4 m0 = splat(m[r]);
+        const float4 m1 = splat(m[4 + r]);
+        const float4 m2 = splat(m[8 + r]);
+
+        const float4 center = m0 * translation[0] + m1 * translation[1] + m2 * translation[2] + splat(m[12 + r]);
+
+        float4 axes[3];
+
+        for(size_t k = 0; k < 3; ++k)
+        {
+            axes[k] = m0 * columns[k][0] + m1 * columns[k][1] + m2 * columns[k][2];
+        }
+
+        const float4 faces[2] = {center - axes[2], center + axes[2]};
+
+        for(size_t e = 0; e < 4; ++e)
+        {
+            const float4 edge = (e & 1) ? (faces[e >> 1] + axes[1]) : (faces[e >> 1] - axes[1]);
+
+            corners[2 * e][r]     = edge - axes[0];
+            corners[2 * e + 1][r] = edge + axes[0];
+        }
+    }
+
+    const float4 minW = splat(kMinW);
+
+    // Lanes whose corners are all beyond x = w, x = -w, y = w, y = -w, z = w and z = 0
+    int beyond[6] = {0xf, 0xf, 0xf, 0xf, 0xf, 0xf};
+    int atTheEye  = 0;
+
+    for(size_t c = 0; c < 8; ++c)
+    {
+        const float4* pCorner  = corners[c];
+        const float4  negative = zero - pCorner[3];
+
+        beyond[0] &= less(pCorner[3], pCorner[0]);
+        beyond[1] &= less(pCorner[0], negative);
+        beyond[2] &= less(pCorner[3], pCorner[1]);
+        beyond[3] &= less(pCorner[1], negative);
+        beyond[4] &= less(pCorner[3], pCorner[2]);
+        beyond[5] &= less(pCorner[2], zero);
+
+        atTheEye |= less(pCorner[3], minW);
+    }
+
+    const int outside = beyond[0] | beyond[1] | beyond[2] | beyond[3] | beyond[4] | beyond[5];
+
+    // Bounds in normalized device coordinates, meaningless for the lanes outside or at the eye
+    float low[3][4];
+    float high[2][4];
+
+    if((outside | atTheEye) != 0xf)
+    {
+        const float4 reciprocal = one / corners[0][3];
+
+        float4 lowX  = corners[0][0] * reciprocal;
+        float4 lowY  = corners[0][1] * reciprocal;
+        float4 lowZ  = corners[0][2] * reciprocal;
+        float4 highX = lowX;
+        float4 highY = lowY;
+
+        for(size_t c = 1; c < 8; ++c)
+        {
+            const float4 r = one / corners[c][3];
+
+            const float4 ndcX = corners[c][0] * r;
+            const float4 ndcY = corners[c][1] * r;
+
+            lowX  = min(lowX, ndcX);
+            highX = max(highX, ndcX);
+            lowY  = min(lowY, ndcY);
+            highY = max(highY, ndcY);
+            lowZ  = min(lowZ, corners[c][2] * r);
+        }
+
+        store(low[0],  lowX);
+        store(low[1],  lowY);
+        store(low[2],  lowZ);
+        store(high[0], highX);
+        store(high[1], highY);
+    }
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const int lane = 1 << i;
+
+        if(outside & lane)
+        {
+            pResults[i] = eResultOutside;
+        }
+        else if((atTheEye & lane) || (low[2][i] <= 0.0f))
+        {
+            // At the eye or crossing the near plane
+            pResults[i] = eResultVisible;
+        }
+        else
+        {
+            pResults[i] = isOccluded(low[0][i], high[0][i], low[1][i], high[1][i], low[2][i]) ? eResultOccluded : eResultVisible;
+        }
+    }
+}
+
+bool Objects::OcclusionCuller::isOccluded(const float& left,
+                                          const float& right,
+                                          const float& bottom,
+                                          const float& top,
+                                          const float& depth) const
+{
+    // Every pixel the bounds touch; truncation rounds down once clamped to be positive
+    const float lastX = float(mnWidth - 1);
+    const float lastY = float(mnHeight - 1);
+
+    const int32_t x0 = int32_t(std::min(std::max((left  + 1.0f) * 0.5f * mnWidth,  0.0f), lastX));
+    const int32_t x1 = int32_t(std::min(std::max((right + 1.0f) * 0.5f * mnWidth,  0.0f), lastX));
+    const int32_t y0 = int32_t(std::min(std::max((1.0f - top)    * 0.5f * mnHeight, 0.0f), lastY));
+    const int32_t y1 = int32_t(std::min(std::max((1.0f - bottom) * 0.5f * mnHeight, 0.0f), lastY));
+
+    // The finest level where they span at most 4x4 texels
+    size_t level = 0;
+
+    while((((x1 >> level) - (x0 >> level)) > 3) || (((y1 >> level) - (y0 >> level)) > 3))
+    {
+        ++level;
+    }
+
+    const Level& rLevel = m_Levels[level];
+
+    const int32_t first = x0 >> level;
+    const int32_t mask  = (1 << ((x1 >> level) - first + 1)) - 1;
+    const float4  limit = splat(depth);
+
+    for(int32_t y = y0 >> level; y <= (y1 >> level); ++y)
+    {
+        if((less(load(&rLevel.depth[size_t(rLevel.pitch) * y + first]), limit) & mask) != mask)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Objects::OcclusionCuller::fill(const uint32_t& row,
+                                    const uint32_t& first,
+                                    const uint32_t& last,
+                                    const float* pBases,
+                                    const float* pSlopes,
+                                    const size_t& planes)
+{
+    float* pDepth = &m_Levels[0].depth[size_t(m_Levels[0].pitch) * row];
+
+    uint32_t x = first;
+
+    for(; x + 3 <= last; x += 4)
+    {
+        const float4 column = splat(float(x)) + set(0.0f, 1.0f, 2.0f, 3.0f);
+
+        float4 depth = splat(pBases[0]) + splat(pSlopes[0]) * column;
+
+        for(size_t p = 1; p < planes; ++p)
+        {
+            depth = max(depth, splat(pBases[p]) + splat(pSlopes[p]) * column);
+        }
+
+        store(pDepth + x, min(load(pDepth + x), depth));
+    }
+
+    for(; x <= last; ++x)
+    {
+        float depth = pBases[0] + pSlopes[0] * float(x);
+
+        for(size_t p = 1; p < planes; ++p)
+        {
+            depth = std::max(depth, pBases[p] + pSlopes[p] * float(x));
+        }
+
+        pDepth[x] = std::min(pDepth[x], depth);
+    }
+}
+
+#pragma mark -
+#pragma mark Public - Batches
+
+void Objects::compact(const Instance* pInstances,
+                      const std::vector<DrawBatch>& batches,
+                      const std::vector<uint32_t>& visible,
+                      Instance* pVisible,
+                      std::vector<DrawBatch>& rBatches)
+{
+    rBatches.clear();
+
+    size_t next  = 0;
+    size_t count = 0;
+
+    for(const DrawBatch& rBatch : batches)
+    {
+        const uint32_t end = rBatch.firstInstance + rBatch.instanceCount;
+
+        // Visible records before the batch belong to no batch
+        while((next < visible.size()) && (visible[next] < rBatch.firstInstance))
+        {
+            ++next;
+        }
+
+        DrawBatch batch = rBatch;
+
+        batch.firstInstance = uint32_t(count);
+
+        for(; (next < visible.size()) && (visible[next] < end); ++next)
+        {
+            pVisible[count++] = pInstances[visible[next]];
+        }
+
+        batch.instanceCount = uint32_t(count) - batch.firstInstance;
+
+        if(batch.instanceCount > 0)
+        {
+            rBatches.push_back(batch);
+        }
+    }
+}
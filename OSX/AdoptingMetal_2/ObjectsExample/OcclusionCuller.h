@@ -0,0 +1,158 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Software occlusion culling, so MetalView encodes only the objects a pass can see rather than
+ every object in the shadow pass and in the main pass. A few large occluders, the ground plane and
+ the cubes nearest to the eye relative to their size, are rasterised into a low resolution depth
+ buffer, four pixels at a time. A pixel only takes an occluder's depth when the occluder covers all
+ of it, and then the depth of its farthest corner, so the buffer never claims more than the
+ occluders hide. A max depth pyramid over the buffer lets every object's bounds be tested against
+ at most 4x4 texels; objects are tested four at a time in chunks on a thread pool and only the
+ visible ones are left to encode.
+ From the light most cubes are hidden by several small cubes together rather than by one large one,
+ which whole pixel coverage doesn't see, so the shadow pass culls against the light's frustum only.
+ */
+
+#ifndef _OBJECTS_OCCLUSION_CULLER_H_
+#define _OBJECTS_OCCLUSION_CULLER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "InstanceBatcher.h"
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace Objects
+{
+    struct CullStats
+    {
+        size_t tested;
+        size_t outside;     // Outside the view frustum
+        size_t occluded;    // Inside the frustum, behind the occluders
+        size_t visible;
+        size_t occluders;   // Rasterised since begin()
+    };
+
+    class OcclusionCuller
+    {
+    public:
+        static const uint32_t kDefaultWidth  = 320;
+        static const uint32_t kDefaultHeight = 192;
+
+        // Objects per chunk handed to a thread, a multiple of four
+        static const size_t kDefaultChunk = 2048;
+
+        OcclusionCuller(const uint32_t& width = kDefaultWidth, const uint32_t& height = kDefaultHeight);
+
+        uint32_t width() const;
+        uint32_t height() const;
+
+        // Start a view and clear the depth buffer. pViewProjection is column major and maps depth to
+        // [0, 1], as MainPass.ViewProjection and ShadowPass.ViewProjection do; false if it is singular.
+        bool begin(const float* pViewProjection);
+
+        // Rasterise the box [-extent, extent]^3 in the record's local space (0.5 for the cube mesh).
+        // The ground plane is a record with a zero y scale. False when the box covers no whole pixel,
+        // contains the eye or is seen edge on.
+        bool addOccluder(const Instance& rInstance, const float& extent = 0.5f);
+
+        // Rasterise up to maxOccluders records, the largest ones on screen first; returns how many
+        // covered a pixel
+        size_t addOccluders(const Instance* pInstances,
+                            const size_t& count,
+                            const size_t& maxOccluders,
+                            const float& extent = 0.5f,
+                            Threads::WorkStealingPool* pPool = nullptr);
+
+        // Build the depth pyramid, once all occluders are in
+        void end();
+
+        bool isVisible(const Instance& rInstance, const float& extent = 0.5f) const;
+
+        // Indices of the visible records in ascending order. Chunks run on pPool when given,
+        // otherwise on the calling thread.
+        CullStats cull(const Instance* pInstances,
+                       const size_t& count,
+                       std::vector<uint32_t>& rVisible,
+                       const float& extent = 0.5f,
+                       Threads::WorkStealingPool* pPool = nullptr,
+                       const size_t& chunk = kDefaultChunk);
+
+        size_t levels() const;
+
+        // Rows of a pyramid level, pitch() floats apart; 1 where no occluder covers a whole pixel
+        const float* depth(const size_t& level = 0) const;
+
+        uint32_t pitch(const size_t& level = 0) const;
+
+    private:
+        enum Result
+        {
+            eResultVisible = 0,
+            eResultOutside,
+            eResultOccluded
+        };
+
+        struct Level
+        {
+            uint32_t           width;
+            uint32_t           height;
+            uint32_t           pitch;    // Room for four-wide loads past the last texel of a row
+            std::vector<float> depth;
+        };
+
+        // Results of up to four records, tested one per lane
+        void classify(const Instance* pInstances,
+                      const size_t& count,
+                      const float& extent,
+                      uint8_t* pResults) const;
+
+        // Whether the pyramid is nearer than depth everywhere under bounds in normalized device
+        // coordinates
+        bool isOccluded(const float& left,
+                        const float& right,
+                        const float& bottom,
+                        const float& top,
+                        const float& depth) const;
+
+        // Lower the pixels [first, last] of a level 0 row to the farthest of the planes, each a
+        // depth at column 0 of the row and a slope per column
+        void fill(const uint32_t& row,
+                  const uint32_t& first,
+                  const uint32_t& last,
+                  const float* pBases,
+                  const float* pSlopes,
+                  const size_t& planes);
+
+        uint32_t             mnWidth;
+        uint32_t             mnHeight;
+        size_t               mnOccluders;
+
+        float                m_ViewProjection[16];    // Column major
+        double               m_Inverse[4][4];         // Row, column
+        double               m_Eye[4];                // w is 1, or 0 for a parallel projection
+
+        std::vector<Level>   m_Levels;
+        std::vector<uint8_t> m_Results;               // Result per record, written by the chunks
+    }; // OcclusionCuller
+
+    // Copy the visible records of the batches into pVisible and build the batches drawing them;
+    // visible holds indices in instance buffer order, ascending
+    void compact(const Instance* pInstances,
+                 const std::vector<DrawBatch>& batches,
+                 const std::vector<uint32_t>& visible,
+                 Instance* pVisible,
+                 std::vector<DrawBatch>& rBatches);
+} // Objects
+
+#endif
+
+#endif
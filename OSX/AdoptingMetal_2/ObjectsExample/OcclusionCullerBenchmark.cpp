@@ -0,0 +1,500 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the occlusion culler, a standalone program that is not part of the app target. It
+ builds MetalView's scene, cubes scattered over 1000 x 200 x 1000 units above the ground plane, and
+ culls it as MetalView does: the main view against the ground and the largest cubes, the light's
+ view against its frustum only. It times rasterising the occluders and testing the records on the
+ calling thread and on a thread pool, and checks compact() against the visible indices. Unless
+ check is 0 it then draws every cube into an exact z-buffer at the view's full resolution and fails
+ when a cube with a visible pixel was culled.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads InstanceBatcher.cpp OcclusionCuller.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp OcclusionCullerBenchmark.cpp -o benchmark
+     ./benchmark [objects] [check] [occluders] [width] [height]
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+
+#include "OcclusionCuller.h"
+#include "WorkStealingPool.h"
+
+using namespace Objects;
+
+namespace
+{
+    // Column major, as simd's matrix_float4x4
+    typedef std::array<float, 16> Matrix;
+
+    struct View
+    {
+        const char* pName;
+        Matrix      viewProjection;
+        int         width;          // Of the reference z-buffer, the pass's render target
+        int         height;
+        size_t      occluders;      // Largest cubes rasterised; the ground plane with any
+    };
+
+    Matrix multiply(const Matrix& a, const Matrix& b)
+    {
+        Matrix result = {};
+
+        for(size_t c = 0; c < 4; ++c)
+        {
+            for(size_t r = 0; r < 4; ++r)
+            {
+                for(size_t k = 0; k < 4; ++k)
+                {
+                    result[4 * c + r] += a[4 * k + r] * b[4 * c + k];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Camera.GetViewMatrix: the inverse of the camera's basis and position, the basis orthonormal
+    Matrix lookAlong(const float* position, const float* direction, const float* up)
+    {
+        const float right[3] =
+        {
+            up[1] * direction[2] - up[2] * direction[1],
+            up[2] * direction[0] - up[0] * direction[2],
+            up[0] * direction[1] - up[1] * direction[0]
+        };
+
+        const float* axes[3] = {right, up, direction};
+
+        Matrix view = {};
+
+        for(size_t r = 0; r < 3; ++r)
+        {
+            for(size_t c = 0; c < 3; ++c)
+            {
+                view[4 * c + r] = axes[r][c];
+            }
+
+            view[12 + r] = -(axes[r][0] * position[0] + axes[r][1] * position[1] + axes[r][2] * position[2]);
+        }
+
+        view[15] = 1.0f;
+
+        return view;
+    }
+
+    // getPerpectiveProjectionMatrix in Utils.swift
+    Matrix perspective(const float& fovY, const float& aspect, const float& zFar, const float& zNear)
+    {
+        const float f = 1.0f / std::tan(0.5f * fovY);
+
+        Matrix m = {};
+
+        m[0]  = f / aspect;
+        m[5]  = f;
+        m[10] = zFar / (zFar - zNear);
+        m[11] = 1.0f;
+        m[14] = -zNear * zFar / (zFar - zNear);
+
+        return m;
+    }
+
+    // getLHOrthoMatrix in Utils.swift
+    Matrix orthographic(const float& width, const float& height, const float& zFar, const float& zNear)
+    {
+        Matrix m = {};
+
+        m[0]  = 2.0f / width;
+        m[5]  = 2.0f / height;
+        m[10] = 1.0f / (zFar - zNear);
+        m[14] = -zNear / (zFar - zNear);
+        m[15] = 1.0f;
+
+        return m;
+    }
+
+    // As MetalView creates its cubes, with random orientations in place of the rotations
+    std::vector<Instance> scene(const size_t& count)
+    {
+        std::mt19937 random(7);
+
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<Instance> instances(count);
+
+        for(Instance& rInstance : instances)
+        {
+            const Float3 angles = {3.14159f * uniform(random), 3.14159f * uniform(random), 3.14159f * uniform(random)};
+
+            quaternion(angles, rInstance.rotation);
+
+            rInstance.translation[0] = 500.0f * uniform(random);
+            rInstance.translation[1] = 100.0f * uniform(random);
+            rInstance.translation[2] = 500.0f * uniform(random);
+            rInstance.translation[3] = 1.0f;
+
+            const float size = 5.0f * unit(random);
+
+            rInstance.scale[0] = size;
+            rInstance.scale[1] = size;
+            rInstance.scale[2] = size;
+            rInstance.color    = 0;
+        }
+
+        return instances;
+    }
+
+    #pragma mark -
+    #pragma mark Reference z-buffer
+
+    // Nearest cube per pixel centre
+    class Reference
+    {
+    public:
+        Reference(const int& width, const int& height)
+        : mnWidth(width),
+          mnHeight(height),
+          m_Depth(size_t(width) * height, 1.0f),
+          m_Object(size_t(width) * height, -1)
+        {
+        }
+
+        // The box [-0.5, 0.5]^3 of the record, clipped to the near plane
+        void draw(const Matrix& viewProjection, const Instance& rInstance, const int& object)
+        {
+            float toWorld[16];
+
+            localToWorld(rInstance, toWorld);
+
+            std::array<double, 4> corners[8];
+
+            for(size_t i = 0; i < 8; ++i)
+            {
+                double world[3];
+
+                for(size_t j = 0; j < 3; ++j)
+                {
+                    world[j] = toWorld[12 + j];
+
+                    for(size_t k = 0; k < 3; ++k)
+                    {
+                        world[j] += (((i >> k) & 1) ? 0.5 : -0.5) * toWorld[4 * k + j];
+                    }
+                }
+
+                for(size_t r = 0; r < 4; ++r)
+                {
+                    corners[i][r] = viewProjection[r] * world[0] + viewProjection[4 + r] * world[1] +
+                                    viewProjection[8 + r] * world[2] + viewProjection[12 + r];
+                }
+            }
+
+            static const int faces[6][4] =
+            {
+                {0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}
+            };
+
+            for(const auto& face : faces)
+            {
+                for(int t = 0; t < 2; ++t)
+                {
+                    const int triangle[3] = {face[0], face[1 + t], face[2 + t]};
+
+                    std::vector<std::array<double, 4>> clipped;
+
+                    for(int k = 0; k < 3; ++k)
+                    {
+                        const std::array<double, 4>& a = corners[triangle[k]];
+                        const std::array<double, 4>& b = corners[triangle[(k + 1) % 3]];
+
+                        if(a[2] >= 0.0)
+                        {
+                            clipped.push_back(a);
+                        }
+
+                        if((a[2] >= 0.0) != (b[2] >= 0.0))
+                        {
+                            const double s = a[2] / (a[2] - b[2]);
+
+                            std::array<double, 4> c;
+
+                            for(size_t r = 0; r < 4; ++r)
+                            {
+                                c[r] = a[r] + s * (b[r] - a[r]);
+                            }
+
+                            clipped.push_back(c);
+                        }
+                    }
+
+                    for(size_t k = 1; k + 1 < clipped.size(); ++k)
+                    {
+                        fill(clipped[0], clipped[k], clipped[k + 1], object);
+                    }
+                }
+            }
+        }
+
+        // Records with a pixel of their own
+        std::vector<bool> seen(const size_t& count) const
+        {
+            std::vector<bool> result(count, false);
+
+            for(const int& object : m_Object)
+            {
+                if(object >= 0)
+                {
+                    result[object] = true;
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        void fill(const std::array<double, 4>& a, const std::array<double, 4>& b, const std::array<double, 4>& c, const int& object)
+        {
+            const std::array<double, 4>* vertices[3] = {&a, &b, &c};
+
+            double p[3][3];
+
+            for(size_t i = 0; i < 3; ++i)
+            {
+                const std::array<double, 4>& v = *vertices[i];
+
+                p[i][0] = (v[0] / v[3] + 1.0) * 0.5 * mnWidth;
+                p[i][1] = (1.0 - v[1] / v[3]) * 0.5 * mnHeight;
+                p[i][2] = v[2] / v[3];
+            }
+
+            const double area = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]);
+
+            if(area == 0.0)
+            {
+                return;
+            }
+
+            const int left   = std::max(0, int(std::floor(std::min({p[0][0], p[1][0], p[2][0]}))));
+            const int right  = std::min(mnWidth - 1, int(std::ceil(std::max({p[0][0], p[1][0], p[2][0]}))));
+            const int top    = std::max(0, int(std::floor(std::min({p[0][1], p[1][1], p[2][1]}))));
+            const int bottom = std::min(mnHeight - 1, int(std::ceil(std::max({p[0][1], p[1][1], p[2][1]}))));
+
+            for(int y = top; y <= bottom; ++y)
+            {
+                for(int x = left; x <= right; ++x)
+                {
+                    const double px = x + 0.5;
+                    const double py = y + 0.5;
+
+                    const double w0 = ((p[1][0] - px) * (p[2][1] - py) - (p[1][1] - py) * (p[2][0] - px)) / area;
+                    const double w1 = ((p[2][0] - px) * (p[0][1] - py) - (p[2][1] - py) * (p[0][0] - px)) / area;
+                    const double w2 = 1.0 - w0 - w1;
+
+                    if((w0 < 0.0) || (w1 < 0.0) || (w2 < 0.0))
+                    {
+                        continue;
+                    }
+
+                    const double z = w0 * p[0][2] + w1 * p[1][2] + w2 * p[2][2];
+
+                    const size_t pixel = size_t(y) * mnWidth + x;
+
+                    if((z >= 0.0) && (z <= 1.0) && (z < m_Depth[pixel]))
+                    {
+                        m_Depth[pixel]  = float(z);
+                        m_Object[pixel] = object;
+                    }
+                }
+            }
+        }
+
+        int                mnWidth;
+        int                mnHeight;
+        std::vector<float> m_Depth;
+        std::vector<int>   m_Object;
+    }; // Reference
+
+    #pragma mark -
+    #pragma mark Checks
+
+    // The compacted records are the visible ones, in order, and the batches cover exactly them
+    bool checkCompact(const std::vector<Instance>& instances, const std::vector<uint32_t>& visible)
+    {
+        // Two pipelines, so a batch boundary falls inside the records
+        const uint32_t half = uint32_t(instances.size() / 2);
+
+        const std::vector<DrawBatch> batches =
+        {
+            {0, 0, 0, half},
+            {1, 0, half, uint32_t(instances.size()) - half}
+        };
+
+        std::vector<Instance>  compacted(visible.size());
+        std::vector<DrawBatch> compactedBatches;
+
+        compact(instances.data(), batches, visible, compacted.data(), compactedBatches);
+
+        size_t covered = 0;
+        bool   passed  = true;
+
+        for(const DrawBatch& rBatch : compactedBatches)
+        {
+            passed = passed && (rBatch.firstInstance == covered) && (rBatch.instanceCount > 0);
+
+            for(uint32_t i = rBatch.firstInstance; i < rBatch.firstInstance + rBatch.instanceCount; ++i)
+            {
+                const uint32_t source = visible[i];
+
+                passed = passed && (rBatch.pipeline == ((source < half) ? 0u : 1u)) &&
+                         (std::memcmp(&compacted[i], &instances[source], sizeof(Instance)) == 0);
+            }
+
+            covered += rBatch.instanceCount;
+        }
+
+        return passed && (covered == visible.size());
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 5; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t   count     = (argc >= 2) ? size_t(std::atol(argv[1])) : 200000;
+    const bool     check     = (argc >= 3) ? (std::atoi(argv[2]) != 0) : true;
+    const size_t   occluders = (argc >= 4) ? size_t(std::atol(argv[3])) : 512;
+    const uint32_t width     = (argc >= 5) ? uint32_t(std::atoi(argv[4])) : OcclusionCuller::kDefaultWidth;
+    const uint32_t height    = (argc >= 6) ? uint32_t(std::atoi(argv[5])) : OcclusionCuller::kDefaultHeight;
+
+    const std::vector<Instance> instances = scene(count);
+
+    // MetalView's ground plane as a flat cube record
+    Instance ground = {};
+
+    ground.rotation[3]    = 1.0f;
+    ground.translation[1] = -250.0f;
+    ground.translation[3] = 1.0f;
+    ground.scale[0]       = 2001.0f;
+    ground.scale[2]       = 2001.0f;
+
+    // MetalView's camera at its start position and its light
+    const float eye[3]          = {0.0f, 0.0f, -325.0f};
+    const float forward[3]      = {0.0f, 0.0f, 1.0f};
+    const float up[3]           = {0.0f, 1.0f, 0.0f};
+    const float light[3]        = {0.0f, 225.0f, 0.0f};
+    const float lightForward[3] = {0.0f, -1.0f, 0.0f};
+    const float lightUp[3]      = {0.0f, 0.0f, 1.0f};
+
+    const View views[] =
+    {
+        {"main", multiply(perspective(60.0f * 3.14159265f / 180.0f, 1280.0f / 800.0f, 2000.0f, 1.0f), lookAlong(eye, forward, up)), 1280, 800, occluders},
+        {"shadow", multiply(orthographic(1100.0f, 1100.0f, 475.0f, 25.0f), lookAlong(light, lightForward, lightUp)), 2048, 2048, 0}
+    };
+
+    Threads::WorkStealingPool pool;
+
+    for(const View& rView : views)
+    {
+        OcclusionCuller culler(width, height);
+
+        std::vector<uint32_t> visible;
+
+        const auto rasterise = [&] {
+            culler.begin(rView.viewProjection.data());
+
+            if(rView.occluders > 0)
+            {
+                culler.addOccluder(ground);
+                culler.addOccluders(instances.data(), count, rView.occluders, 0.5f, &pool);
+            }
+
+            culler.end();
+        };
+
+        const double raster     = milliseconds(rasterise);
+        const double serial     = milliseconds([&] { culler.cull(instances.data(), count, visible); });
+        const double concurrent = milliseconds([&] { culler.cull(instances.data(), count, visible, 0.5f, &pool); });
+
+        const CullStats stats = culler.cull(instances.data(), count, visible, 0.5f, &pool);
+
+        std::printf("%s view, %zu objects, %zu occluders in %ux%u: raster %.2f ms, test %.2f ms, on %zu threads %.2f ms\n"
+                    "    %.1f%% outside, %.1f%% occluded (%.1f%% of those inside), %.1f%% visible\n",
+                    rView.pName, count, stats.occluders, width, height, raster, serial, pool.concurrency(), concurrent,
+                    100.0 * stats.outside / count, 100.0 * stats.occluded / count,
+                    100.0 * stats.occluded / std::max<size_t>(count - stats.outside, 1), 100.0 * stats.visible / count);
+
+        if(!checkCompact(instances, visible))
+        {
+            std::printf("    compact: records or batches do not match the visible indices\n");
+
+            return 1;
+        }
+
+        if(!check)
+        {
+            continue;
+        }
+
+        Reference reference(rView.width, rView.height);
+
+        reference.draw(rView.viewProjection, ground, -2);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            reference.draw(rView.viewProjection, instances[i], int(i));
+        }
+
+        const std::vector<bool> seen = reference.seen(count);
+
+        std::vector<bool> kept(count, false);
+
+        for(const uint32_t& index : visible)
+        {
+            kept[index] = true;
+        }
+
+        size_t onScreen = 0;
+        size_t wrong    = 0;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            onScreen += seen[i];
+            wrong    += seen[i] && !kept[i];
+        }
+
+        const size_t inside = count - stats.outside;
+
+        std::printf("    reference %dx%d: %zu objects with a visible pixel, at best %.1f%% of those inside culled; %zu culled but visible\n",
+                    rView.width, rView.height, onScreen, 100.0 * (inside - std::min(onScreen, inside)) / std::max<size_t>(inside, 1), wrong);
+
+        if(wrong != 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -103,6 +103,20 @@ class RenderableObject
 		}
 		
 	}
+	
+	// Draws instanceCount copies of the mesh, reading InstanceData records from baseInstance on
+	// The records are bound once per pass, so there is no per-object offset to set
+	func DrawInstanced(_ enc : MTLRenderCommandEncoder, instanceCount : Int, baseInstance : Int)
+	{
+		if(indexBuffer != nil)
+		{
+			enc.drawIndexedPrimitives(type: MTLPrimitiveType.triangle, indexCount: count, indexType: MTLIndexType.uint16, indexBuffer: indexBuffer!, indexBufferOffset: 0, instanceCount: instanceCount, baseVertex: 0, baseInstance: baseInstance)
+		}
+		else
+		{
+			enc.drawPrimitives(type: MTLPrimitiveType.triangle, vertexStart: 0, vertexCount: count, instanceCount: instanceCount, baseInstance: baseInstance)
+		}
+	}
 }
 
 class StaticRenderableObject : RenderableObject
@@ -223,3 +223,154 @@ fragment float4 zpass_fragment()
 {
 	return float4(1.0);
 }
+
+/*
+	Instanced variants. Every object of a batch reads its InstanceData record through
+	instance_id, which includes the base instance of the draw, and the colour travels
+	to the fragment stage as a flat varying instead of a per-object buffer offset.
+ */
+
+struct InstancedVaryings
+{
+	float4 position [[position]];
+	float4 shadow0Position;
+	float4 color [[flat]];
+};
+
+struct InstancedLitVaryings
+{
+	float4 position [[position]];
+	float4 shadow0Position;
+	float3 worldSpacePosition;
+	float3 worldSpaceNormal;
+	float4 color [[flat]];
+};
+
+static float3 quaternion_rotate(float4 q, float3 v)
+{
+	float3 t = 2.0 * cross(q.xyz, v);
+	return v + q.w * t + cross(q.xyz, t);
+}
+
+static float4 instance_position(constant InstanceData& instance, float3 position)
+{
+	float3 scale = float3(instance.scale[0], instance.scale[1], instance.scale[2]);
+	return float4(quaternion_rotate(instance.rotation, position * scale) + instance.translation.xyz, 1.0);
+}
+
+//Normals take the inverse scale, so non-uniform scales stay correct
+static float3 instance_normal(constant InstanceData& instance, float3 normal)
+{
+	float3 scale = float3(instance.scale[0], instance.scale[1], instance.scale[2]);
+	return normalize(quaternion_rotate(instance.rotation, normal / scale));
+}
+
+vertex InstancedVaryings instanced_vertex_main(device Vertex* verts [[buffer(0)]],
+											 constant InstanceData* instances [[buffer(1)]],
+											 constant MainPass&  frame_constants [[buffer(2)]],
+											 uint vid [[vertex_id]],
+											 uint iid [[instance_id]])
+{
+	InstancedVaryings out;
+	
+	float4 worldPosition = instance_position(instances[iid], verts[vid].position);
+	out.position = frame_constants.ViewProjection * worldPosition;
+	out.shadow0Position = frame_constants.ViewShadow0Projection * worldPosition;
+	out.color = unpack_unorm4x8_to_float(instances[iid].color);
+	
+	return out;
+}
+
+vertex InstancedLitVaryings instanced_lit_vertex(device Vertex* verts [[buffer(0)]],
+											   constant InstanceData* instances [[buffer(1)]],
+											   constant MainPass&  frame_constants [[buffer(2)]],
+											   uint vid [[vertex_id]],
+											   uint iid [[instance_id]])
+{
+	InstancedLitVaryings out;
+	
+	float4 worldPosition = instance_position(instances[iid], verts[vid].position);
+	
+	out.worldSpacePosition = worldPosition.xyz;
+	out.position = frame_constants.ViewProjection * worldPosition;
+	out.shadow0Position = frame_constants.ViewShadow0Projection * worldPosition;
+	out.worldSpaceNormal = instance_normal(instances[iid], verts[vid].normal);
+	out.color = unpack_unorm4x8_to_float(instances[iid].color);
+	
+	return out;
+}
+
+fragment float4 instanced_unshaded_fragment(InstancedVaryings input [[stage_in]])
+{
+	return input.color;
+}
+
+fragment float4 instanced_lit_fragment(InstancedLitVaryings input [[stage_in]],
+									   constant MainPass& frame_constants [[buffer(2)]])
+{
+	float3 L = normalize(frame_constants.LightPosition.xyz);
+	float attenuation = clamp(dot(normalize(input.worldSpaceNormal), L), 0.3, 1.0);
+	float3 color = input.color.xyz*attenuation;
+	return float4(color, 1.0);
+}
+
+fragment float4 instanced_lit_shadowed_fragment(InstancedLitVaryings input [[stage_in]],
+												constant MainPass& frame_constants [[buffer(2)]],
+												depth2d<float> shadow [[texture(0)]])
+{
+	constexpr sampler s(coord::normalized, address::clamp_to_edge, filter::linear);
+	
+	float4 shadowSpacePosition = input.shadow0Position;
+	
+	shadowSpacePosition.xy = shadowSpacePosition.xy * 0.5 + 0.5;
+	shadowSpacePosition.y = 1.0 - shadowSpacePosition.y;
+	
+	float4 shadow_depth = shadow.sample(s, shadowSpacePosition.xy);
+	
+	float3 L = normalize(frame_constants.LightPosition.xyz);
+	float attenuation = clamp(dot(normalize(input.worldSpaceNormal), L), 0.3, 1.0);
+	float3 c = input.color.xyz*attenuation;
+	
+	if(shadow_depth.x <= shadowSpacePosition.z - 0.001)
+	{
+		c.xyz *= 0.5;
+	}
+	
+	return float4(c, 1.0);
+}
+
+fragment float4 instanced_unshaded_shadowed_fragment(InstancedVaryings input [[stage_in]],
+													 depth2d<float> shadow [[texture(0)]])
+{
+	constexpr sampler s(coord::normalized, address::clamp_to_edge, filter::linear);
+	
+	float4 shadowSpacePosition = input.shadow0Position;
+	
+	shadowSpacePosition.xy = shadowSpacePosition.xy * 0.5 + 0.5;
+	shadowSpacePosition.y = 1.0 - shadowSpacePosition.y;
+	
+	float4 shadow_depth = shadow.sample(s, shadowSpacePosition.xy);
+	
+	float4 c = input.color;
+	
+	if(shadow_depth.x <= shadowSpacePosition.z - 0.001)
+	{
+		c.xyz *= 0.5;
+	}
+
+	return c;
+}
+
+vertex ZPassVaryings instanced_zpass_vertex_main(device Vertex* verts [[buffer(0)]],
+												 constant InstanceData* instances [[buffer(1)]],
+												 constant ShadowPass&  frame_constants [[buffer(2)]],
+												 uint vid [[vertex_id]],
+												 uint iid [[instance_id]])
+{
+	ZPassVaryings out;
+	
+	float4 worldPosition = instance_position(instances[iid], verts[vid].position);
+	out.position = frame_constants.ViewProjection * worldPosition;
+	
+	return out;
+}
@@ -12,6 +12,15 @@ struct ObjectData
 	
 };
 
+// Compact per-object record for instanced draws, indexed by instance_id
+struct InstanceData
+{
+	vector_float4 rotation;		// Unit quaternion (x, y, z, w)
+	vector_float4 translation;	// w is 1
+	float scale[3];
+	unsigned int color;			// RGBA8 unorm, red in the low byte
+};
+
 struct ShadowPass
 {
 	matrix_float4x4 ViewProjection;
@@ -0,0 +1,891 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Image based lighting baker for cube maps. A source cube map is projected onto order 2 (nine
+coefficient) spherical harmonics for diffuse irradiance, prefiltered into a mip chain for GGX
+specular with importance sampling, one roughness per level, and the split-sum environment BRDF is
+integrated into a lookup table. Faces and rows are spread over a thread pool, and results are cached
+on disk under a hash of the source texels and the settings.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+#include "AAPLEnvironmentBaker.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace AAPL
+{
+    namespace Environment
+    {
+        static const float kPi = 3.14159265358979f;
+
+        // Bumped whenever the baked data would change for the same source and settings
+        static const uint32_t kCacheVersion = 1;
+
+        // Major axis, then the directions of u and v across each face
+        static const float kFaceFrames[kFaceCount][3][3] =
+        {
+            {{ 1.0f,  0.0f,  0.0f}, { 0.0f,  0.0f, -1.0f}, { 0.0f, -1.0f,  0.0f}},
+            {{-1.0f,  0.0f,  0.0f}, { 0.0f,  0.0f,  1.0f}, { 0.0f, -1.0f,  0.0f}},
+            {{ 0.0f,  1.0f,  0.0f}, { 1.0f,  0.0f,  0.0f}, { 0.0f,  0.0f,  1.0f}},
+            {{ 0.0f, -1.0f,  0.0f}, { 1.0f,  0.0f,  0.0f}, { 0.0f,  0.0f, -1.0f}},
+            {{ 0.0f,  0.0f,  1.0f}, { 1.0f,  0.0f,  0.0f}, { 0.0f, -1.0f,  0.0f}},
+            {{ 0.0f,  0.0f, -1.0f}, {-1.0f,  0.0f,  0.0f}, { 0.0f, -1.0f,  0.0f}}
+        };
+
+        // Four lanes per register
+        struct float4
+        {
+#if defined(__SSE2__)
+            __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            float32x4_t v;
+#else
+            float v[4];
+#endif
+        };
+
+#if defined(__SSE2__)
+        static inline float4 load(const float* p)                        { return {_mm_loadu_ps(p)}; }
+        static inline void   store(float* p, const float4& a)            { _mm_storeu_ps(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {_mm_set1_ps(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+        static inline float4 operator/(const float4& a, const float4& b) { return {_mm_div_ps(a.v, b.v)}; }
+        static inline float4 sqrt(const float4& a)                       { return {_mm_sqrt_ps(a.v)}; }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        static inline float4 load(const float* p)                        { return {vld1q_f32(p)}; }
+        static inline void   store(float* p, const float4& a)            { vst1q_f32(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {vdupq_n_f32(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+        static inline float4 operator/(const float4& a, const float4& b) { return {vdivq_f32(a.v, b.v)}; }
+        static inline float4 sqrt(const float4& a)                       { return {vsqrtq_f32(a.v)}; }
+#else
+        static inline float4 load(const float* p)             { return {{p[0], p[1], p[2], p[3]}}; }
+        static inline void   store(float* p, const float4& a) { std::copy(a.v, a.v + 4, p); }
+        static inline float4 splat(const float& s)            { return {{s, s, s, s}}; }
+
+        static inline float4 operator+(const float4& a, const float4& b)
+        {
+            return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+        }
+
+        static inline float4 operator*(const float4& a, const float4& b)
+        {
+            return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+        }
+
+        static inline float4 operator/(const float4& a, const float4& b)
+        {
+            return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}};
+        }
+
+        static inline float4 sqrt(const float4& a)
+        {
+            return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}};
+        }
+#endif
+
+        static inline void parallelFor(Threads::WorkStealingPool* pPool,
+                                       const size_t& count,
+                                       const std::function<void(size_t)>& rBody)
+        {
+            if(pPool)
+            {
+                pPool->parallelFor(count, rBody, 1);
+            }
+            else
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    rBody(i);
+                }
+            }
+        }
+
+        static inline uint32_t levelSize(const uint32_t& size, const uint32_t& level)
+        {
+            return std::max(size >> level, 1u);
+        }
+
+        static inline size_t faceLength(const uint32_t& size)
+        {
+            return size_t(size) * size * 4;
+        }
+
+        static CubeMap allocate(const uint32_t& size)
+        {
+            CubeMap cubeMap;
+
+            cubeMap.size = size;
+
+            for(uint32_t face = 0; face < kFaceCount; ++face)
+            {
+                cubeMap.faces[face].assign(faceLength(size), 0.0f);
+            }
+
+            return cubeMap;
+        }
+
+        // The nine real basis functions at a unit direction
+        static inline void basis(const float& x, const float& y, const float& z, float* pBasis)
+        {
+            pBasis[0] = 0.282095f;
+            pBasis[1] = 0.488603f * y;
+            pBasis[2] = 0.488603f * z;
+            pBasis[3] = 0.488603f * x;
+            pBasis[4] = 1.092548f * x * y;
+            pBasis[5] = 1.092548f * y * z;
+            pBasis[6] = 0.315392f * (3.0f * z * z - 1.0f);
+            pBasis[7] = 1.092548f * x * z;
+            pBasis[8] = 0.546274f * (x * x - y * y);
+        }
+
+        // Bit reversed low discrepancy sequence in [0, 1)
+        static inline float radicalInverse(uint32_t bits)
+        {
+            bits = (bits << 16) | (bits >> 16);
+            bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+            bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+            bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+            bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+
+            return float(bits) * 2.3283064365386963e-10f;
+        }
+
+        // Half vector around +Z distributed by D(h) (h.z)
+        static inline void sampleGGX(const uint32_t& i,
+                                     const uint32_t& count,
+                                     const float& alpha,
+                                     float* pHalf)
+        {
+            const float phi = 2.0f * kPi * (float(i) + 0.5f) / float(count);
+            const float e   = radicalInverse(i);
+
+            const float cosTheta = std::sqrt((1.0f - e) / (1.0f + (alpha * alpha - 1.0f) * e));
+            const float sinTheta = std::sqrt(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+
+            pHalf[0] = sinTheta * std::cos(phi);
+            pHalf[1] = sinTheta * std::sin(phi);
+            pHalf[2] = cosTheta;
+        }
+
+        static inline float distributionGGX(const float& nDotH, const float& alpha)
+        {
+            const float a2 = alpha * alpha;
+            const float d  = nDotH * nDotH * (a2 - 1.0f) + 1.0f;
+
+            return a2 / (kPi * d * d);
+        }
+
+        // Smith visibility with the k = alpha / 2 remapping for image based lighting
+        static inline float geometrySmith(const float& nDotV, const float& nDotL, const float& alpha)
+        {
+            const float k = 0.5f * alpha;
+
+            return (nDotV / (nDotV * (1.0f - k) + k)) * (nDotL / (nDotL * (1.0f - k) + k));
+        }
+
+        // Trilinear sample between the levels of a chain
+        static inline void sampleLevel(const std::vector<CubeMap>& rChain,
+                                       const float* pDirection,
+                                       const float& lod,
+                                       float* pColor)
+        {
+            const float clamped = std::min(std::max(lod, 0.0f), float(rChain.size() - 1));
+
+            const uint32_t fine   = uint32_t(clamped);
+            const uint32_t coarse = std::min(fine + 1, uint32_t(rChain.size() - 1));
+            const float    t      = clamped - float(fine);
+
+            sample(rChain[fine], pDirection, pColor);
+
+            if(t > 0.0f && coarse != fine)
+            {
+                float color[4];
+
+                sample(rChain[coarse], pDirection, color);
+
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    pColor[c] += (color[c] - pColor[c]) * t;
+                }
+            }
+        }
+
+        static uint64_t fnv1a(const void* pData, const size_t& length, uint64_t hash)
+        {
+            const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+
+            for(size_t i = 0; i < length; ++i)
+            {
+                hash ^= pBytes[i];
+                hash *= 0x100000001b3ull;
+            }
+
+            return hash;
+        }
+
+        // Leads a cache file
+        struct Header
+        {
+            char     magic[4];
+            uint32_t version;
+            uint32_t size;
+            Settings settings;
+        };
+    } // Environment
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Sampling
+
+void AAPL::Environment::direction(const uint32_t& face, const float& u, const float& v, float* pDirection)
+{
+    const float (&frame)[3][3] = kFaceFrames[face];
+
+    float length = 0.0f;
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+        pDirection[k] = frame[0][k] + frame[1][k] * u + frame[2][k] * v;
+
+        length += pDirection[k] * pDirection[k];
+    }
+
+    length = 1.0f / std::sqrt(length);
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+        pDirection[k] *= length;
+    }
+}
+
+void AAPL::Environment::sample(const CubeMap& rCubeMap, const float* pDirection, float* pColor)
+{
+    const float ax = std::fabs(pDirection[0]);
+    const float ay = std::fabs(pDirection[1]);
+    const float az = std::fabs(pDirection[2]);
+
+    uint32_t face  = 0;
+    float    major = 0.0f;
+
+    if(ax >= ay && ax >= az)
+    {
+        face  = (pDirection[0] >= 0.0f) ? 0 : 1;
+        major = ax;
+    }
+    else if(ay >= az)
+    {
+        face  = (pDirection[1] >= 0.0f) ? 2 : 3;
+        major = ay;
+    }
+    else
+    {
+        face  = (pDirection[2] >= 0.0f) ? 4 : 5;
+        major = az;
+    }
+
+    const float (&frame)[3][3] = kFaceFrames[face];
+
+    const float u = (pDirection[0] * frame[1][0] + pDirection[1] * frame[1][1] + pDirection[2] * frame[1][2]) / major;
+    const float v = (pDirection[0] * frame[2][0] + pDirection[1] * frame[2][1] + pDirection[2] * frame[2][2]) / major;
+
+    const float size = float(rCubeMap.size);
+    const float x    = std::min(std::max((u + 1.0f) * 0.5f * size - 0.5f, 0.0f), size - 1.0f);
+    const float y    = std::min(std::max((v + 1.0f) * 0.5f * size - 0.5f, 0.0f), size - 1.0f);
+
+    const uint32_t x0 = uint32_t(x);
+    const uint32_t y0 = uint32_t(y);
+    const uint32_t x1 = std::min(x0 + 1, rCubeMap.size - 1);
+    const uint32_t y1 = std::min(y0 + 1, rCubeMap.size - 1);
+    const float    tx = x - float(x0);
+    const float    ty = y - float(y0);
+
+    const float* pTexels = rCubeMap.faces[face].data();
+
+    const float* p00 = pTexels + (size_t(y0) * rCubeMap.size + x0) * 4;
+    const float* p01 = pTexels + (size_t(y0) * rCubeMap.size + x1) * 4;
+    const float* p10 = pTexels + (size_t(y1) * rCubeMap.size + x0) * 4;
+    const float* p11 = pTexels + (size_t(y1) * rCubeMap.size + x1) * 4;
+
+    for(size_t c = 0; c < 4; ++c)
+    {
+        const float top    = p00[c] + (p01[c] - p00[c]) * tx;
+        const float bottom = p10[c] + (p11[c] - p10[c]) * tx;
+
+        pColor[c] = top + (bottom - top) * ty;
+    }
+}
+
+std::vector<AAPL::Environment::CubeMap> AAPL::Environment::downsample(const CubeMap& rSource)
+{
+    std::vector<CubeMap> chain(1, rSource);
+
+    while(chain.back().size > 1)
+    {
+        const CubeMap& rFine = chain.back();
+
+        CubeMap coarse = allocate(rFine.size / 2);
+
+        for(uint32_t face = 0; face < kFaceCount; ++face)
+        {
+            const float* pFine   = rFine.faces[face].data();
+            float*       pCoarse = coarse.faces[face].data();
+
+            for(uint32_t y = 0; y < coarse.size; ++y)
+            {
+                for(uint32_t x = 0; x < coarse.size; ++x)
+                {
+                    const float* p0 = pFine + (size_t(2 * y) * rFine.size + 2 * x) * 4;
+                    const float* p1 = p0 + size_t(rFine.size) * 4;
+
+                    for(size_t c = 0; c < 4; ++c)
+                    {
+                        pCoarse[(size_t(y) * coarse.size + x) * 4 + c] = 0.25f * (p0[c] + p0[c + 4] + p1[c] + p1[c + 4]);
+                    }
+                }
+            }
+        }
+
+        chain.push_back(std::move(coarse));
+    }
+
+    return chain;
+}
+
+#pragma mark -
+#pragma mark Public - Diffuse
+
+AAPL::Environment::SphericalHarmonics AAPL::Environment::project(const CubeMap& rSource, Threads::WorkStealingPool* pPool)
+{
+    // Per face, RGBA sums for each coefficient and the total solid angle
+    struct Partial
+    {
+        float  sums[kCoefficientCount][4];
+        double weight;
+    };
+
+    Partial partials[kFaceCount];
+
+    const uint32_t size  = rSource.size;
+    const float    texel = 2.0f / float(size);
+
+    parallelFor(pPool, kFaceCount, [&](size_t face)
+    {
+        const float (&frame)[3][3] = kFaceFrames[face];
+
+        float4 sums[kCoefficientCount];
+
+        for(uint32_t k = 0; k < kCoefficientCount; ++k)
+        {
+            sums[k] = splat(0.0f);
+        }
+
+        double weight = 0.0;
+
+        const float* pTexels = rSource.faces[face].data();
+
+        for(uint32_t y = 0; y < size; ++y)
+        {
+            const float4 v = splat((float(y) + 0.5f) * texel - 1.0f);
+
+            for(uint32_t x = 0; x < size; x += 4)
+            {
+                // Four texels across the row at once; lanes past the edge get no weight
+                float lanes[4];
+
+                for(uint32_t l = 0; l < 4; ++l)
+                {
+                    lanes[l] = (float(x + l) + 0.5f) * texel - 1.0f;
+                }
+
+                const float4 u = load(lanes);
+
+                // |axis + u U + v V|^2 = 1 + u^2 + v^2 for an orthonormal frame; the solid angle
+                // of a texel is its area over the cube of the distance
+                const float4 distance2 = splat(1.0f) + u * u + v * v;
+                const float4 inverse   = splat(1.0f) / sqrt(distance2);
+
+                const float4 dx = (splat(frame[0][0]) + splat(frame[1][0]) * u + splat(frame[2][0]) * v) * inverse;
+                const float4 dy = (splat(frame[0][1]) + splat(frame[1][1]) * u + splat(frame[2][1]) * v) * inverse;
+                const float4 dz = (splat(frame[0][2]) + splat(frame[1][2]) * u + splat(frame[2][2]) * v) * inverse;
+
+                const float4 solidAngle = splat(texel * texel) * inverse * inverse * inverse;
+
+                float b[kCoefficientCount][4];
+
+                store(b[0], solidAngle * splat(0.282095f));
+                store(b[1], solidAngle * splat(0.488603f) * dy);
+                store(b[2], solidAngle * splat(0.488603f) * dz);
+                store(b[3], solidAngle * splat(0.488603f) * dx);
+                store(b[4], solidAngle * splat(1.092548f) * dx * dy);
+                store(b[5], solidAngle * splat(1.092548f) * dy * dz);
+                store(b[6], solidAngle * splat(0.315392f) * (splat(3.0f) * dz * dz + splat(-1.0f)));
+                store(b[7], solidAngle * splat(1.092548f) * dx * dz);
+                store(b[8], solidAngle * splat(0.546274f) * (dx * dx + splat(-1.0f) * dy * dy));
+
+                float angles[4];
+
+                store(angles, solidAngle);
+
+                const uint32_t count = std::min(4u, size - x);
+
+                // RGBA of each texel against its weighted basis
+                for(uint32_t l = 0; l < count; ++l)
+                {
+                    const float4 color = load(pTexels + (size_t(y) * size + x + l) * 4);
+
+                    for(uint32_t k = 0; k < kCoefficientCount; ++k)
+                    {
+                        sums[k] = sums[k] + color * splat(b[k][l]);
+                    }
+
+                    weight += angles[l];
+                }
+            }
+        }
+
+        for(uint32_t k = 0; k < kCoefficientCount; ++k)
+        {
+            store(partials[face].sums[k], sums[k]);
+        }
+
+        partials[face].weight = weight;
+    });
+
+    SphericalHarmonics harmonics;
+
+    double weight = 0.0;
+
+    for(uint32_t face = 0; face < kFaceCount; ++face)
+    {
+        weight += partials[face].weight;
+    }
+
+    // The texels' solid angles sum to slightly off 4 pi
+    const float scale = float(4.0 * double(kPi) / weight);
+
+    for(uint32_t k = 0; k < kCoefficientCount; ++k)
+    {
+        for(uint32_t c = 0; c < 3; ++c)
+        {
+            float sum = 0.0f;
+
+            for(uint32_t face = 0; face < kFaceCount; ++face)
+            {
+                sum += partials[face].sums[k][c];
+            }
+
+            harmonics.coefficients[k][c] = sum * scale;
+        }
+    }
+
+    return harmonics;
+}
+
+void AAPL::Environment::irradiance(const SphericalHarmonics& rHarmonics, const float* pDirection, float* pColor)
+{
+    // Cosine lobe convolution per band, pi, 2 pi / 3 and pi / 4, over pi
+    static const float bands[kCoefficientCount] =
+    {
+        1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f
+    };
+
+    float b[kCoefficientCount];
+
+    basis(pDirection[0], pDirection[1], pDirection[2], b);
+
+    for(uint32_t c = 0; c < 3; ++c)
+    {
+        float sum = 0.0f;
+
+        for(uint32_t k = 0; k < kCoefficientCount; ++k)
+        {
+            sum += bands[k] * b[k] * rHarmonics.coefficients[k][c];
+        }
+
+        pColor[c] = std::max(sum, 0.0f);
+    }
+}
+
+#pragma mark -
+#pragma mark Public - Specular
+
+std::vector<AAPL::Environment::CubeMap> AAPL::Environment::prefilter(const CubeMap& rSource,
+                                                                     const uint32_t& levels,
+                                                                     const uint32_t& samples,
+                                                                     Threads::WorkStealingPool* pPool)
+{
+    const std::vector<CubeMap> chain = downsample(rSource);
+
+    std::vector<CubeMap> result(1, rSource);
+
+    // Solid angle of a texel of the source
+    const float texelAngle = 4.0f * kPi / (6.0f * float(rSource.size) * float(rSource.size));
+
+    for(uint32_t level = 1; level < levels; ++level)
+    {
+        const float roughness = float(level) / float(levels - 1);
+        const float alpha     = roughness * roughness;
+
+        // With the normal, view and reflection directions equal, the samples are the same around
+        // every texel: light directions around +Z, weighted by N.L, with the mip whose texels
+        // cover the solid angle each sample stands for
+        struct Sample
+        {
+            float direction[3];
+            float weight;
+            float lod;
+        };
+
+        std::vector<Sample> lobe;
+
+        lobe.reserve(samples);
+
+        for(uint32_t i = 0; i < samples; ++i)
+        {
+            float h[3];
+
+            sampleGGX(i, samples, alpha, h);
+
+            // Reflect V = +Z about the half vector
+            const float l[3] = {2.0f * h[2] * h[0], 2.0f * h[2] * h[1], 2.0f * h[2] * h[2] - 1.0f};
+
+            if(l[2] <= 0.0f)
+            {
+                continue;
+            }
+
+            // pdf of L is D (N.H) / (4 V.H), and V.H = N.H here
+            const float pdf   = distributionGGX(h[2], alpha) * 0.25f;
+            const float angle = 1.0f / (float(samples) * pdf + 1e-6f);
+            const float lod   = std::max(0.5f * std::log2(angle / texelAngle) + 1.0f, 0.0f);
+
+            lobe.push_back({{l[0], l[1], l[2]}, l[2], lod});
+        }
+
+        const uint32_t size = levelSize(rSource.size, level);
+
+        CubeMap output = allocate(size);
+
+        parallelFor(pPool, size_t(kFaceCount) * size, [&](size_t task)
+        {
+            const uint32_t face = uint32_t(task / size);
+            const uint32_t y    = uint32_t(task % size);
+
+            float* pRow = output.faces[face].data() + size_t(y) * size * 4;
+
+            for(uint32_t x = 0; x < size; ++x)
+            {
+                float n[3];
+
+                direction(face, (float(x) + 0.5f) * 2.0f / float(size) - 1.0f, (float(y) + 0.5f) * 2.0f / float(size) - 1.0f, n);
+
+                // Tangent frame around the normal
+                const float up[3] = {std::fabs(n[2]) < 0.999f ? 0.0f : 1.0f, 0.0f, std::fabs(n[2]) < 0.999f ? 1.0f : 0.0f};
+
+                float t[3] = {up[1] * n[2] - up[2] * n[1], up[2] * n[0] - up[0] * n[2], up[0] * n[1] - up[1] * n[0]};
+
+                const float length = 1.0f / std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+
+                t[0] *= length;
+                t[1] *= length;
+                t[2] *= length;
+
+                const float b[3] = {n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2], n[0] * t[1] - n[1] * t[0]};
+
+                float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                float weight = 0.0f;
+
+                for(const Sample& rSample : lobe)
+                {
+                    const float* l = rSample.direction;
+
+                    const float world[3] =
+                    {
+                        t[0] * l[0] + b[0] * l[1] + n[0] * l[2],
+                        t[1] * l[0] + b[1] * l[1] + n[1] * l[2],
+                        t[2] * l[0] + b[2] * l[1] + n[2] * l[2]
+                    };
+
+                    float color[4];
+
+                    sampleLevel(chain, world, rSample.lod, color);
+
+                    for(size_t c = 0; c < 4; ++c)
+                    {
+                        sum[c] += color[c] * rSample.weight;
+                    }
+
+                    weight += rSample.weight;
+                }
+
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    pRow[x * 4 + c] = (weight > 0.0f) ? sum[c] / weight : 0.0f;
+                }
+            }
+        });
+
+        result.push_back(std::move(output));
+    }
+
+    return result;
+}
+
+std::vector<float> AAPL::Environment::integrateBRDF(const uint32_t& size,
+                                                    const uint32_t& samples,
+                                                    Threads::WorkStealingPool* pPool)
+{
+    std::vector<float> table(size_t(size) * size * 2, 0.0f);
+
+    parallelFor(pPool, size, [&](size_t y)
+    {
+        const float roughness = (float(y) + 0.5f) / float(size);
+        const float alpha     = roughness * roughness;
+
+        for(uint32_t x = 0; x < size; ++x)
+        {
+            const float nDotV = (float(x) + 0.5f) / float(size);
+            const float v[3]  = {std::sqrt(1.0f - nDotV * nDotV), 0.0f, nDotV};
+
+            float scale = 0.0f;
+            float bias  = 0.0f;
+
+            for(uint32_t i = 0; i < samples; ++i)
+            {
+                float h[3];
+
+                sampleGGX(i, samples, alpha, h);
+
+                const float vDotH = v[0] * h[0] + v[2] * h[2];
+                const float nDotL = 2.0f * vDotH * h[2] - v[2];
+
+                if(nDotL <= 0.0f)
+                {
+                    continue;
+                }
+
+                const float nDotH = h[2];
+
+                // G (V.H) / (N.H N.V) is the BRDF times N.L over the pdf
+                const float visibility = geometrySmith(nDotV, nDotL, alpha) * vDotH / (nDotH * nDotV);
+                const float fresnel    = std::pow(1.0f - std::max(vDotH, 0.0f), 5.0f);
+
+                scale += (1.0f - fresnel) * visibility;
+                bias  += fresnel * visibility;
+            }
+
+            table[(size_t(y) * size + x) * 2]     = scale / float(samples);
+            table[(size_t(y) * size + x) * 2 + 1] = bias / float(samples);
+        }
+    });
+
+    return table;
+}
+
+#pragma mark -
+#pragma mark Public - Cache
+
+uint64_t AAPL::Environment::hash(const CubeMap& rSource, const Settings& rSettings)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    hash = fnv1a(&kCacheVersion, sizeof(kCacheVersion), hash);
+    hash = fnv1a(&rSource.size, sizeof(rSource.size), hash);
+    hash = fnv1a(&rSettings, sizeof(rSettings), hash);
+
+    for(uint32_t face = 0; face < kFaceCount; ++face)
+    {
+        hash = fnv1a(rSource.faces[face].data(), rSource.faces[face].size() * sizeof(float), hash);
+    }
+
+    return hash;
+}
+
+#pragma mark -
+#pragma mark Private - Baker
+
+bool AAPL::Environment::Baker::load(const std::string& path,
+                                    const Settings& rSettings,
+                                    const uint32_t& size,
+                                    Result& rResult) const
+{
+    FILE* pFile = std::fopen(path.c_str(), "rb");
+
+    if(!pFile)
+    {
+        return false;
+    }
+
+    Header header;
+
+    bool valid = (std::fread(&header, sizeof(header), 1, pFile) == 1) &&
+                 (std::memcmp(header.magic, "AENV", 4) == 0) &&
+                 (header.version == kCacheVersion) &&
+                 (header.size == size) &&
+                 (std::memcmp(&header.settings, &rSettings, sizeof(Settings)) == 0);
+
+    valid = valid && (std::fread(&rResult.irradiance, sizeof(SphericalHarmonics), 1, pFile) == 1);
+
+    rResult.specular.clear();
+
+    for(uint32_t level = 0; valid && level < rSettings.specularLevels; ++level)
+    {
+        CubeMap cubeMap = allocate(levelSize(size, level));
+
+        for(uint32_t face = 0; valid && face < kFaceCount; ++face)
+        {
+            const size_t count = cubeMap.faces[face].size();
+
+            valid = (std::fread(cubeMap.faces[face].data(), sizeof(float), count, pFile) == count);
+        }
+
+        rResult.specular.push_back(std::move(cubeMap));
+    }
+
+    if(valid)
+    {
+        const size_t count = size_t(rSettings.lutSize) * rSettings.lutSize * 2;
+
+        rResult.brdf.resize(count);
+        rResult.lutSize = rSettings.lutSize;
+
+        valid = (std::fread(rResult.brdf.data(), sizeof(float), count, pFile) == count);
+    }
+
+    std::fclose(pFile);
+
+    return valid;
+}
+
+bool AAPL::Environment::Baker::store(const std::string& path, const Settings& rSettings, const Result& rResult) const
+{
+    // Written aside and renamed, so a reader never sees half a file
+    const std::string temporary = path + ".tmp";
+
+    FILE* pFile = std::fopen(temporary.c_str(), "wb");
+
+    if(!pFile)
+    {
+        return false;
+    }
+
+    Header header;
+
+    std::memcpy(header.magic, "AENV", 4);
+
+    header.version  = kCacheVersion;
+    header.size     = rResult.specular.front().size;
+    header.settings = rSettings;
+
+    bool valid = (std::fwrite(&header, sizeof(header), 1, pFile) == 1) &&
+                 (std::fwrite(&rResult.irradiance, sizeof(SphericalHarmonics), 1, pFile) == 1);
+
+    for(const CubeMap& rCubeMap : rResult.specular)
+    {
+        for(uint32_t face = 0; valid && face < kFaceCount; ++face)
+        {
+            const size_t count = rCubeMap.faces[face].size();
+
+            valid = (std::fwrite(rCubeMap.faces[face].data(), sizeof(float), count, pFile) == count);
+        }
+    }
+
+    valid = valid && (std::fwrite(rResult.brdf.data(), sizeof(float), rResult.brdf.size(), pFile) == rResult.brdf.size());
+    valid = (std::fclose(pFile) == 0) && valid;
+
+    if(valid)
+    {
+        valid = (std::rename(temporary.c_str(), path.c_str()) == 0);
+    }
+
+    if(!valid)
+    {
+        std::remove(temporary.c_str());
+    }
+
+    return valid;
+}
+
+#pragma mark -
+#pragma mark Public - Baker
+
+AAPL::Environment::Baker::Baker(const std::string& directory, Threads::WorkStealingPool* pPool)
+: m_Directory(directory),
+  mpPool(pPool)
+{
+} // Constructor
+
+AAPL::Environment::Baker::~Baker()
+{
+} // Destructor
+
+std::string AAPL::Environment::Baker::path(const uint64_t& key) const
+{
+    char name[32];
+
+    std::snprintf(name, sizeof(name), "%016llx.environment", static_cast<unsigned long long>(key));
+
+    return m_Directory + "/" + name;
+}
+
+bool AAPL::Environment::Baker::bake(const CubeMap& rSource, const Settings& rSettings, Result& rResult)
+{
+    if(rSource.size == 0 || rSettings.specularLevels == 0 || rSettings.specularSamples == 0 ||
+       rSettings.lutSize == 0 || rSettings.lutSamples == 0)
+    {
+        return false;
+    }
+
+    for(uint32_t face = 0; face < kFaceCount; ++face)
+    {
+        if(rSource.faces[face].size() != faceLength(rSource.size))
+        {
+            return false;
+        }
+    }
+
+    std::string file;
+
+    if(!m_Directory.empty())
+    {
+        file = path(hash(rSource, rSettings));
+
+        if(load(file, rSettings, rSource.size, rResult))
+        {
+            rResult.cached = true;
+
+            return true;
+        }
+    }
+
+    rResult.irradiance = project(rSource, mpPool);
+    rResult.specular   = prefilter(rSource, rSettings.specularLevels, rSettings.specularSamples, mpPool);
+    rResult.brdf       = integrateBRDF(rSettings.lutSize, rSettings.lutSamples, mpPool);
+    rResult.lutSize    = rSettings.lutSize;
+    rResult.cached     = false;
+
+    if(!file.empty())
+    {
+        store(file, rSettings, rResult);
+    }
+
+    return true;
+}
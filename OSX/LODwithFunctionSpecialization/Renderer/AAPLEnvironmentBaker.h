@@ -0,0 +1,126 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Image based lighting baker for cube maps. A source cube map is projected onto order 2 (nine
+coefficient) spherical harmonics for diffuse irradiance, prefiltered into a mip chain for GGX
+specular with importance sampling, one roughness per level, and the split-sum environment BRDF is
+integrated into a lookup table. Faces and rows are spread over a thread pool, and results are cached
+on disk under a hash of the source texels and the settings.
+*/
+
+#ifndef _AAPL_ENVIRONMENT_BAKER_H_
+#define _AAPL_ENVIRONMENT_BAKER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace Environment
+    {
+        // Faces in Metal's order: +X, -X, +Y, -Y, +Z, -Z
+        static const uint32_t kFaceCount = 6;
+
+        // Spherical harmonics coefficients up to order 2
+        static const uint32_t kCoefficientCount = 9;
+
+        // Linear RGBA texels, rows top to bottom
+        struct CubeMap
+        {
+            uint32_t           size;                // Texels per side of a face
+            std::vector<float> faces[kFaceCount];   // size * size * 4 floats each
+        };
+
+        struct SphericalHarmonics
+        {
+            float coefficients[kCoefficientCount][3];
+        };
+
+        struct Settings
+        {
+            uint32_t specularLevels;    // Mips of the specular chain, roughness 0 to 1
+            uint32_t specularSamples;   // GGX samples per texel
+            uint32_t lutSize;           // Texels per side of the BRDF table
+            uint32_t lutSamples;
+        };
+
+        struct Result
+        {
+            SphericalHarmonics   irradiance;    // Radiance, convolve before evaluating
+            std::vector<CubeMap> specular;      // Level i prefiltered for roughness i / (levels - 1)
+            std::vector<float>   brdf;          // lutSize^2 (scale, bias) pairs, x is N.V, y roughness
+            uint32_t             lutSize;
+            bool                 cached;        // Loaded rather than baked
+        };
+
+        // Unit direction through a point of a face, u and v in [-1, 1] across and down
+        void direction(const uint32_t& face, const float& u, const float& v, float* pDirection);
+
+        // Bilinear sample, clamped to the edges of the face the direction falls on
+        void sample(const CubeMap& rCubeMap, const float* pDirection, float* pColor);
+
+        // Box filtered chain down to one texel per face; level 0 is a copy of rSource
+        std::vector<CubeMap> downsample(const CubeMap& rSource);
+
+        // Each face weighted by the texels' solid angles, faces in parallel
+        SphericalHarmonics project(const CubeMap& rSource, Threads::WorkStealingPool* pPool = nullptr);
+
+        // Cosine convolved irradiance over pi, i.e. the diffuse radiance of a white Lambertian
+        // surface facing the direction
+        void irradiance(const SphericalHarmonics& rHarmonics, const float* pDirection, float* pColor);
+
+        // Levels of the GGX prefiltered chain, sizes halving from the source's. Samples read the
+        // source chain at the mip that matches their solid angle, which keeps the samples needed
+        // for a noise free result low.
+        std::vector<CubeMap> prefilter(const CubeMap& rSource,
+                                       const uint32_t& levels,
+                                       const uint32_t& samples,
+                                       Threads::WorkStealingPool* pPool = nullptr);
+
+        // Split-sum scale and bias to F0 of the GGX BRDF with Smith visibility
+        std::vector<float> integrateBRDF(const uint32_t& size,
+                                         const uint32_t& samples,
+                                         Threads::WorkStealingPool* pPool = nullptr);
+
+        // 64 bit FNV-1a of the source texels and the settings
+        uint64_t hash(const CubeMap& rSource, const Settings& rSettings);
+
+        class Baker
+        {
+        public:
+            // An empty directory disables the cache
+            explicit Baker(const std::string& directory, Threads::WorkStealingPool* pPool = nullptr);
+
+            virtual ~Baker();
+
+            // Cached file for a key
+            std::string path(const uint64_t& key) const;
+
+            // False for a source whose faces don't hold size^2 texels or settings without levels or
+            // samples. Failing to read or write the cache only costs a bake.
+            bool bake(const CubeMap& rSource, const Settings& rSettings, Result& rResult);
+
+        private:
+            bool load(const std::string& path, const Settings& rSettings, const uint32_t& size, Result& rResult) const;
+            bool store(const std::string& path, const Settings& rSettings, const Result& rResult) const;
+
+        private:
+            std::string                 m_Directory;
+            Threads::WorkStealingPool*  mpPool;
+        }; // Class Baker
+    } // Environment
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,497 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Benchmark for the environment baker, a standalone program that is not part of the app target. It
+checks the baked results against references computed independently of the baker: irradiance from
+the harmonics against the cosine convolution summed over every texel, on a sky smooth enough for
+order 2 to hold exactly; each prefiltered level against a Monte Carlo GGX convolution of the source
+with uniformly distributed directions; and the BRDF table against a quadrature of the split-sum
+integrals over the hemisphere. A constant environment must come through every stage unchanged. It
+then times the harmonics, the prefiltered chain, the table and a whole bake at several face
+resolutions, and checks that loading the bake back from the cache reproduces it.
+
+    c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLEnvironmentBaker.cpp \
+        ../../../Shared/Threads/WorkStealingPool.cpp AAPLEnvironmentBakerBenchmark.cpp -o benchmark
+    ./benchmark [cache directory]
+
+The cache directory defaults to the current one; the files the benchmark bakes are removed again.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AAPLEnvironmentBaker.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::Environment;
+
+namespace
+{
+    const double kPi = 3.14159265358979323846;
+
+    typedef std::function<void(const float* pDirection, float* pColor)> Environment;
+
+    // Sky brightening towards +Y with a bluish band about Z, quadratic in the direction so that
+    // order 2 harmonics represent its irradiance exactly
+    void sky(const float* d, float* pColor)
+    {
+        pColor[0] = 0.2f + 0.3f * d[1];
+        pColor[1] = 0.3f + 0.2f * d[1] + 0.1f * d[0] * d[1];
+        pColor[2] = 0.5f + 0.4f * d[2] * d[2];
+        pColor[3] = 1.0f;
+    }
+
+    // The sky with a small bright sun, which the harmonics can only approximate
+    void sunlit(const float* d, float* pColor)
+    {
+        const float sun = 20.0f * std::pow(std::max(0.0f, 0.6f * d[0] + 0.8f * d[1]), 64.0f);
+
+        sky(d, pColor);
+
+        pColor[0] += sun;
+        pColor[1] += sun;
+        pColor[2] += 0.5f * sun;
+    }
+
+    CubeMap cubeMap(const uint32_t& size, const Environment& rEnvironment)
+    {
+        CubeMap result;
+
+        result.size = size;
+
+        for(uint32_t face = 0; face < kFaceCount; ++face)
+        {
+            result.faces[face].resize(size_t(size) * size * 4);
+
+            for(uint32_t y = 0; y < size; ++y)
+            {
+                for(uint32_t x = 0; x < size; ++x)
+                {
+                    float d[3];
+
+                    direction(face, (float(x) + 0.5f) * 2.0f / float(size) - 1.0f, (float(y) + 0.5f) * 2.0f / float(size) - 1.0f, d);
+
+                    rEnvironment(d, &result.faces[face][(size_t(y) * size + x) * 4]);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    float dot(const float* a, const float* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    void randomDirection(std::mt19937& rGenerator, float* pDirection)
+    {
+        std::normal_distribution<float> normal;
+
+        float length = 0.0f;
+
+        do
+        {
+            pDirection[0] = normal(rGenerator);
+            pDirection[1] = normal(rGenerator);
+            pDirection[2] = normal(rGenerator);
+
+            length = std::sqrt(dot(pDirection, pDirection));
+        }
+        while(length < 1.0e-3f);
+
+        for(int k = 0; k < 3; ++k)
+        {
+            pDirection[k] /= length;
+        }
+    }
+
+    // Cosine weighted sum over every texel over pi, each texel weighted by its solid angle
+    void referenceIrradiance(const CubeMap& rSource, const float* pNormal, double* pColor)
+    {
+        const uint32_t n = rSource.size;
+
+        pColor[0] = pColor[1] = pColor[2] = 0.0;
+
+        for(uint32_t face = 0; face < kFaceCount; ++face)
+        {
+            for(uint32_t y = 0; y < n; ++y)
+            {
+                for(uint32_t x = 0; x < n; ++x)
+                {
+                    const float u = (float(x) + 0.5f) * 2.0f / float(n) - 1.0f;
+                    const float v = (float(y) + 0.5f) * 2.0f / float(n) - 1.0f;
+
+                    float d[3];
+
+                    direction(face, u, v, d);
+
+                    const double solidAngle = (4.0 / (double(n) * n)) / std::pow(1.0 + u * u + v * v, 1.5);
+                    const double cosine     = std::max(0.0f, dot(d, pNormal));
+
+                    const float* pTexel = &rSource.faces[face][(size_t(y) * n + x) * 4];
+
+                    for(int k = 0; k < 3; ++k)
+                    {
+                        pColor[k] += pTexel[k] * cosine * solidAngle / kPi;
+                    }
+                }
+            }
+        }
+    }
+
+    // GGX weighted average of the source about the normal, taken with N = V = R as the
+    // prefilter assumes, over uniformly distributed directions
+    double referencePrefiltered(const CubeMap& rSource, const float* pNormal, const float& alpha, std::mt19937& rGenerator)
+    {
+        const double a2 = double(alpha) * alpha;
+
+        double sum    = 0.0;
+        double weight = 0.0;
+
+        for(int s = 0; s < 20000; ++s)
+        {
+            float l[3];
+
+            randomDirection(rGenerator, l);
+
+            const float nDotL = dot(l, pNormal);
+
+            if(nDotL <= 0.0f)
+            {
+                continue;
+            }
+
+            const float  h[3]   = {l[0] + pNormal[0], l[1] + pNormal[1], l[2] + pNormal[2]};
+            const double nDotH  = dot(h, pNormal) / std::sqrt(dot(h, h));
+            const double d      = nDotH * nDotH * (a2 - 1.0) + 1.0;
+            const double w      = a2 / (kPi * d * d) * nDotL;
+
+            float color[4];
+
+            sample(rSource, l, color);
+
+            sum    += color[0] * w;
+            weight += w;
+        }
+
+        return sum / weight;
+    }
+
+    // Split-sum scale and bias by the midpoint rule over the cosine and azimuth of L
+    void referenceBRDF(const double& nDotV, const double& roughness, double& rScale, double& rBias)
+    {
+        const int    kSteps = 1024;
+        const double alpha  = roughness * roughness;
+        const double a2     = alpha * alpha;
+        const double k      = 0.5 * alpha;
+        const double v[3]   = {std::sqrt(1.0 - nDotV * nDotV), 0.0, nDotV};
+
+        rScale = 0.0;
+        rBias  = 0.0;
+
+        for(int i = 0; i < kSteps; ++i)
+        {
+            const double nDotL = (i + 0.5) / kSteps;
+            const double sine  = std::sqrt(1.0 - nDotL * nDotL);
+
+            for(int j = 0; j < 2 * kSteps; ++j)
+            {
+                const double phi  = (j + 0.5) * kPi / kSteps;
+                const double l[3] = {sine * std::cos(phi), sine * std::sin(phi), nDotL};
+
+                double h[3]   = {l[0] + v[0], l[1] + v[1], l[2] + v[2]};
+                double length = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+
+                const double nDotH = h[2] / length;
+                const double vDotH = (h[0] * v[0] + h[2] * v[2]) / length;
+
+                const double d        = nDotH * nDotH * (a2 - 1.0) + 1.0;
+                const double D        = a2 / (kPi * d * d);
+                const double G        = (nDotV / (nDotV * (1.0 - k) + k)) * (nDotL / (nDotL * (1.0 - k) + k));
+                const double fresnel  = std::pow(1.0 - vDotH, 5.0);
+
+                // BRDF without Fresnel times N.L, times the area of a cell
+                const double f = D * G / (4.0 * nDotV) * (1.0 / kSteps) * (kPi / kSteps);
+
+                rScale += (1.0 - fresnel) * f;
+                rBias  += fresnel * f;
+            }
+        }
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 3; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+
+    bool checkIrradiance(Threads::WorkStealingPool& rPool)
+    {
+        std::mt19937 generator(3);
+
+        const CubeMap smooth = cubeMap(64, sky);
+        const CubeMap sun    = cubeMap(64, sunlit);
+
+        const SphericalHarmonics smoothHarmonics = project(smooth, &rPool);
+        const SphericalHarmonics sunHarmonics    = project(sun, &rPool);
+
+        double smoothError = 0.0;
+        double sunError    = 0.0;
+
+        for(int t = 0; t < 20; ++t)
+        {
+            float normal[3];
+
+            randomDirection(generator, normal);
+
+            double reference[3];
+            float  color[3];
+
+            referenceIrradiance(smooth, normal, reference);
+            irradiance(smoothHarmonics, normal, color);
+
+            for(int k = 0; k < 3; ++k)
+            {
+                smoothError = std::max(smoothError, std::abs(color[k] - reference[k]) / reference[k]);
+            }
+
+            referenceIrradiance(sun, normal, reference);
+            irradiance(sunHarmonics, normal, color);
+
+            for(int k = 0; k < 3; ++k)
+            {
+                sunError = std::max(sunError, std::abs(color[k] - reference[k]) / reference[k]);
+            }
+        }
+
+        std::printf("Irradiance: largest relative error %.4f on the smooth sky, %.3f with the sun\n", smoothError, sunError);
+
+        return smoothError < 0.01;
+    }
+
+    bool checkPrefilter(Threads::WorkStealingPool& rPool)
+    {
+        std::mt19937 generator(5);
+
+        const uint32_t kLevels = 6;
+
+        const CubeMap              source   = cubeMap(64, sunlit);
+        const std::vector<CubeMap> filtered = prefilter(source, kLevels, 256, &rPool);
+
+        bool passed = (filtered.size() == kLevels);
+
+        for(uint32_t level = 1; passed && (level < kLevels); ++level)
+        {
+            const float roughness = float(level) / float(kLevels - 1);
+
+            double error     = 0.0;
+            double magnitude = 0.0;
+
+            for(int t = 0; t < 40; ++t)
+            {
+                float normal[3];
+                float color[4];
+
+                randomDirection(generator, normal);
+                sample(filtered[level], normal, color);
+
+                const double reference = referencePrefiltered(source, normal, roughness * roughness, generator);
+
+                error     += (color[0] - reference) * (color[0] - reference);
+                magnitude += reference * reference;
+            }
+
+            const double relative = std::sqrt(error / magnitude);
+
+            std::printf("Prefiltered level %u, roughness %.1f: relative RMS error %.3f\n", level, roughness, relative);
+
+            passed = (relative < 0.15);
+        }
+
+        return passed;
+    }
+
+    bool checkBRDF(Threads::WorkStealingPool& rPool)
+    {
+        const uint32_t kSize = 32;
+
+        const std::vector<float> table = integrateBRDF(kSize, 1024, &rPool);
+
+        // Texels as (N.V, roughness); the lowest rows are too sharp for the quadrature
+        const uint32_t points[][2] = {{31, 6}, {16, 16}, {4, 28}, {28, 8}, {8, 12}, {31, 31}};
+
+        double worst = 0.0;
+
+        for(const auto& rPoint : points)
+        {
+            double scale = 0.0;
+            double bias  = 0.0;
+
+            referenceBRDF((rPoint[0] + 0.5) / kSize, (rPoint[1] + 0.5) / kSize, scale, bias);
+
+            const float* pEntry = &table[(size_t(rPoint[1]) * kSize + rPoint[0]) * 2];
+
+            worst = std::max(worst, std::max(std::abs(pEntry[0] - scale), std::abs(pEntry[1] - bias)));
+        }
+
+        std::printf("BRDF table: largest error %.4f against the quadrature\n", worst);
+
+        return worst < 0.01;
+    }
+
+    bool checkConstant(Threads::WorkStealingPool& rPool)
+    {
+        const CubeMap constant = cubeMap(8, [](const float*, float* pColor) { pColor[0] = 1.0f; pColor[1] = 0.5f; pColor[2] = 0.25f; pColor[3] = 1.0f; });
+
+        const float normal[3] = {0.36f, 0.48f, -0.8f};
+
+        float color[3];
+
+        irradiance(project(constant, &rPool), normal, color);
+
+        double error = std::max(std::abs(color[0] - 1.0f), std::max(std::abs(color[1] - 0.5f), std::abs(color[2] - 0.25f)));
+
+        for(const CubeMap& rLevel : prefilter(constant, 4, 64, &rPool))
+        {
+            for(const std::vector<float>& rFace : rLevel.faces)
+            {
+                for(size_t i = 0; i < rFace.size(); ++i)
+                {
+                    error = std::max(error, double(std::abs(rFace[i] - constant.faces[0][i % 4])));
+                }
+            }
+        }
+
+        std::printf("Constant environment: largest error %.2g\n", error);
+
+        return error < 1.0e-4;
+    }
+
+    bool timeBakes(const std::string& directory, Threads::WorkStealingPool& rPool)
+    {
+        Baker baker(directory, &rPool);
+
+        bool passed = true;
+
+        for(const uint32_t& size : {32u, 64u, 128u, 256u})
+        {
+            const CubeMap source = cubeMap(size, sunlit);
+
+            uint32_t levels = 1;
+
+            while((size >> (levels - 1)) > 1)
+            {
+                ++levels;
+            }
+
+            const Settings settings = {levels, 128, 64, 256};
+
+            const std::string file = baker.path(hash(source, settings));
+
+            std::remove(file.c_str());
+
+            const double harmonicsTime = milliseconds([&] { project(source, &rPool); });
+            const double prefilterTime = milliseconds([&] { prefilter(source, levels, settings.specularSamples, &rPool); });
+            const double tableTime     = milliseconds([&] { integrateBRDF(settings.lutSize, settings.lutSamples, &rPool); });
+
+            Result baked;
+            Result loaded;
+
+            auto start = std::chrono::steady_clock::now();
+
+            const bool bakedOK = baker.bake(source, settings, baked);
+
+            const double bakeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+
+            const bool loadedOK = baker.bake(source, settings, loaded);
+
+            const double loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            bool same = bakedOK && loadedOK && !baked.cached && loaded.cached &&
+                        (std::memcmp(&baked.irradiance, &loaded.irradiance, sizeof(SphericalHarmonics)) == 0) &&
+                        (baked.brdf == loaded.brdf) && (baked.specular.size() == loaded.specular.size());
+
+            for(size_t level = 0; same && (level < baked.specular.size()); ++level)
+            {
+                for(uint32_t face = 0; face < kFaceCount; ++face)
+                {
+                    same = same && (baked.specular[level].faces[face] == loaded.specular[level].faces[face]);
+                }
+            }
+
+            std::remove(file.c_str());
+
+            std::printf("%3u texel faces: harmonics %6.2f ms, %u prefiltered levels %7.1f ms, 64x64 table %5.1f ms, bake %7.1f ms, cached load %5.2f ms, %s\n",
+                        size, harmonicsTime, levels, prefilterTime, tableTime, bakeTime, loadTime,
+                        same ? "identical" : "DIFFERENT");
+
+            passed = passed && same;
+        }
+
+        return passed;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const std::string directory = (argc >= 2) ? argv[1] : ".";
+
+    Threads::WorkStealingPool pool;
+
+    std::printf("%zu threads\n", pool.concurrency());
+
+    // Every face direction must sample back to its own texel
+    const CubeMap ramp = cubeMap(16, [](const float* d, float* pColor) { pColor[0] = d[0] + 2.0f * d[1] + 3.0f * d[2]; pColor[1] = pColor[2] = pColor[3] = 0.0f; });
+
+    double roundTrip = 0.0;
+
+    for(uint32_t face = 0; face < kFaceCount; ++face)
+    {
+        for(uint32_t y = 0; y < 16; ++y)
+        {
+            for(uint32_t x = 0; x < 16; ++x)
+            {
+                float d[3];
+                float color[4];
+
+                direction(face, (float(x) + 0.5f) / 8.0f - 1.0f, (float(y) + 0.5f) / 8.0f - 1.0f, d);
+                sample(ramp, d, color);
+
+                roundTrip = std::max(roundTrip, double(std::abs(color[0] - ramp.faces[face][(y * 16 + x) * 4])));
+            }
+        }
+    }
+
+    std::printf("Texel directions: largest sampling error %.2g\n", roundTrip);
+
+    bool passed = (roundTrip < 1.0e-5);
+
+    passed = checkIrradiance(pool) && passed;
+    passed = checkPrefilter(pool) && passed;
+    passed = checkBRDF(pool) && passed;
+    passed = checkConstant(pool) && passed;
+    passed = timeBakes(directory, pool) && passed;
+
+    return passed ? 0 : 1;
+}
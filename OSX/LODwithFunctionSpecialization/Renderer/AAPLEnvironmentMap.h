@@ -0,0 +1,35 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Header for the environment map object, which bakes image based lighting data from a cube texture
+*/
+
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+
+// Lighting data baked on the CPU from the top level of a cube texture.  Bakes are cached on disk,
+//   so only the first launch with a given source pays for them
+@interface AAPLEnvironmentMap : NSObject
+
+// Bakes from an 8-bit RGBA or BGRA cube texture (sRGB or not) whose contents the CPU can read.
+//   specularLevels mips of roughness 0 to 1 are prefiltered, each with specularSamples GGX samples
+//   per texel.  Returns nil for other textures
+- (nullable instancetype)initWithTexture:(nonnull id <MTLTexture>)texture
+                          specularLevels:(NSUInteger)specularLevels
+                         specularSamples:(NSUInteger)specularSamples
+                             metalDevice:(nonnull id <MTLDevice>)device;
+
+// RGBA16Float cube whose mips are prefiltered for GGX specular, roughness level / (levels - 1)
+@property (nonatomic, readonly, nonnull) id <MTLTexture> specularMap;
+
+// RG16Float split-sum scale and bias to F0, N.V across and roughness down
+@property (nonatomic, readonly, nonnull) id <MTLTexture> brdfLookupTable;
+
+// Nine RGB order 2 spherical harmonics coefficients of the environment's radiance
+@property (nonatomic, readonly, nonnull) NSData *irradianceCoefficients;
+
+// YES when the bake was loaded from the cache
+@property (nonatomic, readonly) BOOL cached;
+
+@end
@@ -0,0 +1,225 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Implementation of the environment map object, which bakes image based lighting data from a cube texture
+*/
+#import <QuartzCore/QuartzCore.h>
+
+#import <cmath>
+#import <vector>
+
+#import "AAPLEnvironmentMap.h"
+#import "AAPLEnvironmentBaker.h"
+#import "HalfConversion.h"
+#import "WorkStealingPool.h"
+
+// Texels per side of the BRDF lookup table and the samples integrated for each
+static const uint32_t kBRDFLookupTableSize = 64;
+static const uint32_t kBRDFLookupTableSamples = 512;
+
+static Threads::WorkStealingPool & bakingPool()
+{
+    static Threads::WorkStealingPool pool;
+
+    return pool;
+}
+
+/// Directory the baker caches its results in, created on first use.  Empty if it can't be created
+static std::string cacheDirectory()
+{
+    NSURL *caches = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory
+                                                           inDomains:NSUserDomainMask].firstObject;
+
+    NSString *bundleIdentifier = [NSBundle mainBundle].bundleIdentifier ?: @"LODwithFunctionSpecialization";
+
+    NSURL *directory = [[caches URLByAppendingPathComponent:bundleIdentifier]
+                        URLByAppendingPathComponent:@"Environment"];
+
+    if(!directory ||
+       ![[NSFileManager defaultManager] createDirectoryAtURL:directory
+                                 withIntermediateDirectories:YES
+                                                  attributes:nil
+                                                       error:nil])
+    {
+        return std::string();
+    }
+
+    return std::string(directory.fileSystemRepresentation);
+}
+
+/// Half precision copy of a float array
+static std::vector<uint16_t> halvesFromFloats(const std::vector<float> &values)
+{
+    std::vector<uint16_t> halves(values.size());
+
+    Half::fromFloat(values.data(), halves.data(), values.size());
+
+    return halves;
+}
+
+/// Copy the top level of an 8-bit cube texture to linear float RGBA.  Returns false for other
+///   pixel formats
+static bool readCubeMap(id<MTLTexture> texture, AAPL::Environment::CubeMap &cubeMap)
+{
+    bool bgra = false;
+    bool srgb = false;
+
+    switch(texture.pixelFormat)
+    {
+        case MTLPixelFormatRGBA8Unorm:      break;
+        case MTLPixelFormatRGBA8Unorm_sRGB: srgb = true; break;
+        case MTLPixelFormatBGRA8Unorm:      bgra = true; break;
+        case MTLPixelFormatBGRA8Unorm_sRGB: bgra = true; srgb = true; break;
+        default:                            return false;
+    }
+
+    if(texture.textureType != MTLTextureTypeCube || texture.width != texture.height)
+    {
+        return false;
+    }
+
+    // The shader samples linear values from sRGB textures, so the bake works on those
+    float decode[256];
+
+    for(uint32_t i = 0; i < 256; i++)
+    {
+        const float c = i / 255.0f;
+
+        decode[i] = !srgb ? c : (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    const uint32_t size = (uint32_t)texture.width;
+
+    std::vector<uint8_t> bytes(size_t(size) * size * 4);
+
+    cubeMap.size = size;
+
+    for(uint32_t face = 0; face < AAPL::Environment::kFaceCount; face++)
+    {
+        [texture getBytes:bytes.data()
+              bytesPerRow:size * 4
+            bytesPerImage:bytes.size()
+               fromRegion:MTLRegionMake2D(0, 0, size, size)
+              mipmapLevel:0
+                    slice:face];
+
+        std::vector<float> &texels = cubeMap.faces[face];
+
+        texels.resize(bytes.size());
+
+        for(size_t i = 0; i < bytes.size(); i += 4)
+        {
+            texels[i + 0] = decode[bytes[i + (bgra ? 2 : 0)]];
+            texels[i + 1] = decode[bytes[i + 1]];
+            texels[i + 2] = decode[bytes[i + (bgra ? 0 : 2)]];
+            texels[i + 3] = bytes[i + 3] / 255.0f;
+        }
+    }
+
+    return true;
+}
+
+@implementation AAPLEnvironmentMap
+
+- (nullable instancetype)initWithTexture:(nonnull id <MTLTexture>)texture
+                          specularLevels:(NSUInteger)specularLevels
+                         specularSamples:(NSUInteger)specularSamples
+                             metalDevice:(nonnull id <MTLDevice>)device
+{
+    self = [super init];
+
+    if(!self)
+    {
+        return nil;
+    }
+
+    AAPL::Environment::CubeMap source;
+
+    if(!readCubeMap(texture, source))
+    {
+        NSLog(@"Environment maps can only be baked from 8-bit RGBA cube textures");
+        return nil;
+    }
+
+    // No more levels than halvings of the source
+    NSUInteger levels = 1;
+
+    while(levels < specularLevels && (source.size >> levels) > 0)
+    {
+        levels++;
+    }
+
+    AAPL::Environment::Settings settings;
+
+    settings.specularLevels  = (uint32_t)levels;
+    settings.specularSamples = (uint32_t)specularSamples;
+    settings.lutSize         = kBRDFLookupTableSize;
+    settings.lutSamples      = kBRDFLookupTableSamples;
+
+    AAPL::Environment::Baker baker(cacheDirectory(), &bakingPool());
+    AAPL::Environment::Result result;
+
+    const CFTimeInterval start = CACurrentMediaTime();
+
+    if(!baker.bake(source, settings, result))
+    {
+        return nil;
+    }
+
+    _cached = result.cached;
+
+    NSLog(@"%@ environment map of %u texel faces in %.1f ms",
+          _cached ? @"Loaded" : @"Baked", source.size, (CACurrentMediaTime() - start) * 1000.0);
+
+    // Half floats filter on every GPU family, unlike 32-bit floats
+    MTLTextureDescriptor *specularDescriptor =
+        [MTLTextureDescriptor textureCubeDescriptorWithPixelFormat:MTLPixelFormatRGBA16Float
+                                                              size:source.size
+                                                         mipmapped:YES];
+
+    specularDescriptor.mipmapLevelCount = levels;
+
+    _specularMap = [device newTextureWithDescriptor:specularDescriptor];
+    _specularMap.label = @"Prefiltered Specular";
+
+    for(NSUInteger level = 0; level < levels; level++)
+    {
+        const AAPL::Environment::CubeMap &cubeMap = result.specular[level];
+
+        for(NSUInteger face = 0; face < AAPL::Environment::kFaceCount; face++)
+        {
+            const std::vector<uint16_t> halves = halvesFromFloats(cubeMap.faces[face]);
+
+            [_specularMap replaceRegion:MTLRegionMake2D(0, 0, cubeMap.size, cubeMap.size)
+                            mipmapLevel:level
+                                  slice:face
+                              withBytes:halves.data()
+                            bytesPerRow:cubeMap.size * 4 * sizeof(uint16_t)
+                          bytesPerImage:halves.size() * sizeof(uint16_t)];
+        }
+    }
+
+    MTLTextureDescriptor *lookupDescriptor =
+        [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRG16Float
+                                                           width:result.lutSize
+                                                          height:result.lutSize
+                                                       mipmapped:NO];
+
+    _brdfLookupTable = [device newTextureWithDescriptor:lookupDescriptor];
+    _brdfLookupTable.label = @"BRDF Lookup Table";
+
+    const std::vector<uint16_t> lookupTable = halvesFromFloats(result.brdf);
+
+    [_brdfLookupTable replaceRegion:MTLRegionMake2D(0, 0, result.lutSize, result.lutSize)
+                        mipmapLevel:0
+                          withBytes:lookupTable.data()
+                        bytesPerRow:result.lutSize * 2 * sizeof(uint16_t)];
+
+    _irradianceCoefficients = [NSData dataWithBytes:result.irradiance.coefficients
+                                             length:sizeof(result.irradiance.coefficients)];
+
+    return self;
+}
+
+@end
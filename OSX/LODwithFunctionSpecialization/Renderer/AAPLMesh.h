@@ -5,9 +5,9 @@ Abstract:
 Header for mesh and submesh objects used for managing models
 */
 
-@import Foundation;
-@import MetalKit;
-@import simd;
+#import <Foundation/Foundation.h>
+#import <MetalKit/MetalKit.h>
+#import <simd/simd.h>
 
 #include "AAPLShaderTypes.h"
 
@@ -30,6 +30,26 @@ Header for mesh and submesh objects used for managing models
 // Material uniforms used instead of texture when rendering with lower LODs
 @property (nonatomic, readonly, nonnull) id <MTLBuffer> materialUniforms;
 
+// 32-bit indices of every geometric level of the submesh, drawn with the mesh's vertex buffers.
+//   Nil when the submesh could not be simplified, in which case only metalKitSubmmesh is drawn
+@property (nonatomic, readonly, nullable) id <MTLBuffer> levelIndexBuffer;
+
+// Number of geometric levels, level 0 being the full resolution submesh
+@property (nonatomic, readonly) NSUInteger levelCount;
+
+// Coarsest geometric level whose simplification error, seen at the given distance through a
+//   perspective projection with a vertical field of view of fovY radians, covers at most
+//   maxPixels of a viewport viewportHeight pixels high
+- (NSUInteger)levelAtDistance:(float)distance
+                  fieldOfView:(float)fovY
+               viewportHeight:(float)viewportHeight
+                maxPixelError:(float)maxPixels;
+
+- (NSUInteger)indexCountForLevel:(NSUInteger)level;
+
+// Byte offset of the level's first index in levelIndexBuffer
+- (NSUInteger)indexBufferOffsetForLevel:(NSUInteger)level;
+
 @end
 
 // App specific mesh class containing vertex data describing the mesh and submesh object describing
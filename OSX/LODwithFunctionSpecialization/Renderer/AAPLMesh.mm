@@ -4,17 +4,33 @@ See LICENSE folder for this sample’s licensing information.
 Abstract:
 Implementation for Mesh and Submesh objects
 */
-@import MetalKit;
-@import ModelIO;
+#import <MetalKit/MetalKit.h>
+#import <ModelIO/ModelIO.h>
+
+#import <algorithm>
+#import <vector>
 
 #import "AAPLMesh.h"
 #import "AAPLMathUtilities.h"
+#import "AAPLMeshSimplifier.h"
+#import "WorkStealingPool.h"
+
+@interface AAPLSubmesh ()
+
+// Upload the levels' indices and keep their offsets, counts and errors
+- (void)setLevels:(AAPL::MeshSimplifier::Chain &)chain
+      metalDevice:(nonnull id<MTLDevice>)device;
+
+@end
 
 @implementation AAPLSubmesh
 {
     NSMutableArray<id<MTLTexture>> *_textures;
     AAPLMaterialUniforms *_uniforms;
     id<MTLBuffer> _materialUniforms;
+
+    // Geometric levels; the chain's indices live in _levelIndexBuffer
+    AAPL::MeshSimplifier::Chain _levels;
 }
 
 @synthesize textures = _textures;
@@ -196,6 +212,55 @@ Implementation for Mesh and Submesh objects
     return self;
 }
 
+- (void)setLevels:(AAPL::MeshSimplifier::Chain &)chain
+      metalDevice:(nonnull id<MTLDevice>)device
+{
+    if(chain.levels.empty())
+    {
+        return;
+    }
+
+    _levelIndexBuffer = [device newBufferWithBytes:chain.indices.data()
+                                            length:chain.indices.size() * sizeof(uint32_t)
+                                           options:0];
+
+    if(!_levelIndexBuffer)
+    {
+        return;
+    }
+
+    _levelIndexBuffer.label = @"LevelIndices";
+
+    _levels.levels.swap(chain.levels);
+}
+
+- (NSUInteger)levelCount
+{
+    return _levels.levels.size();
+}
+
+- (NSUInteger)levelAtDistance:(float)distance
+                  fieldOfView:(float)fovY
+               viewportHeight:(float)viewportHeight
+                maxPixelError:(float)maxPixels
+{
+    return AAPL::MeshSimplifier::selectLevel(_levels, distance, fovY, viewportHeight, maxPixels);
+}
+
+- (NSUInteger)indexCountForLevel:(NSUInteger)level
+{
+    assert(level < _levels.levels.size());
+
+    return _levels.levels[level].indexCount;
+}
+
+- (NSUInteger)indexBufferOffsetForLevel:(NSUInteger)level
+{
+    assert(level < _levels.levels.size());
+
+    return _levels.levels[level].indexOffset * sizeof(uint32_t);
+}
+
 - (AAPLFunctionConstantIndices)mapTextureBindPointToFunctionConstantIndex:(AAPLTextureIndices)textureIndex
 {
     switch (textureIndex)
@@ -244,6 +309,126 @@ Implementation for Mesh and Submesh objects
 
 @synthesize submeshes = _submeshes;
 
+/// Threads shared by every mesh to simplify submeshes in parallel
+static Threads::WorkStealingPool & simplificationPool()
+{
+    static Threads::WorkStealingPool pool;
+
+    return pool;
+}
+
+/// Copy a Model I/O submesh's indices to 32-bit indices.  Returns false for primitives other than
+///   triangles
+static bool copyTriangleIndices(MDLSubmesh *modelIOSubmesh, std::vector<uint32_t> &indices)
+{
+    if(modelIOSubmesh.geometryType != MDLGeometryTypeTriangles)
+    {
+        return false;
+    }
+
+    const NSUInteger indexCount = modelIOSubmesh.indexCount;
+
+    MDLMeshBufferMap *indexMap = [modelIOSubmesh.indexBuffer map];
+
+    indices.resize(indexCount);
+
+    switch(modelIOSubmesh.indexType)
+    {
+        case MDLIndexBitDepthUInt8:
+            std::copy((const uint8_t*)indexMap.bytes, (const uint8_t*)indexMap.bytes + indexCount, indices.begin());
+            return true;
+        case MDLIndexBitDepthUInt16:
+            std::copy((const uint16_t*)indexMap.bytes, (const uint16_t*)indexMap.bytes + indexCount, indices.begin());
+            return true;
+        case MDLIndexBitDepthUInt32:
+            std::copy((const uint32_t*)indexMap.bytes, (const uint32_t*)indexMap.bytes + indexCount, indices.begin());
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Simplify every submesh into a chain of geometric levels sharing the mesh's vertex buffers.
+///   Attributes are read back from Model I/O as 32-bit floats, whatever the layout the vertex
+///   descriptor gave them, so that the simplifier keeps UV, normal and tangent seams
+- (void)buildLevelsWithModelIOMesh:(nonnull MDLMesh *)modelIOMesh
+                       metalDevice:(nonnull id<MTLDevice>)device
+{
+    // Weights of the attributes against the geometric error, measured with the mesh scaled to
+    //   a unit box
+    static const float TextureCoordinateWeight = 1.0f;
+    static const float NormalWeight            = 0.5f;
+    static const float TangentWeight           = 0.25f;
+
+    MDLVertexAttributeData *positions =
+        [modelIOMesh vertexAttributeDataForAttributeNamed:MDLVertexAttributePosition
+                                                 asFormat:MDLVertexFormatFloat3];
+
+    if(!positions)
+    {
+        return;
+    }
+
+    MDLVertexAttributeData *textureCoordinates =
+        [modelIOMesh vertexAttributeDataForAttributeNamed:MDLVertexAttributeTextureCoordinate
+                                                 asFormat:MDLVertexFormatFloat2];
+    MDLVertexAttributeData *normals =
+        [modelIOMesh vertexAttributeDataForAttributeNamed:MDLVertexAttributeNormal
+                                                 asFormat:MDLVertexFormatFloat3];
+    MDLVertexAttributeData *tangents =
+        [modelIOMesh vertexAttributeDataForAttributeNamed:MDLVertexAttributeTangent
+                                                 asFormat:MDLVertexFormatFloat3];
+
+    AAPL::MeshSimplifier::Source source = {};
+
+    source.pPositions     = (const float *)positions.dataStart;
+    source.positionStride = positions.stride;
+    source.vertexCount    = modelIOMesh.vertexCount;
+
+    if(textureCoordinates)
+    {
+        source.attributes.push_back({(const float *)textureCoordinates.dataStart, textureCoordinates.stride, 2, TextureCoordinateWeight});
+    }
+
+    if(normals)
+    {
+        source.attributes.push_back({(const float *)normals.dataStart, normals.stride, 3, NormalWeight});
+    }
+
+    if(tangents)
+    {
+        source.attributes.push_back({(const float *)tangents.dataStart, tangents.stride, 3, TangentWeight});
+    }
+
+    const NSUInteger submeshCount = modelIOMesh.submeshes.count;
+
+    std::vector<std::vector<uint32_t>>         indices(submeshCount);
+    std::vector<AAPL::MeshSimplifier::Source>  sources;
+    std::vector<NSUInteger>                    submeshIndices;
+
+    for(NSUInteger index = 0; index < submeshCount; index++)
+    {
+        // Submeshes that aren't triangle lists are drawn from their MetalKit submesh only
+        if(copyTriangleIndices(modelIOMesh.submeshes[index], indices[index]))
+        {
+            source.pIndices   = indices[index].data();
+            source.indexCount = indices[index].size();
+
+            sources.push_back(source);
+            submeshIndices.push_back(index);
+        }
+    }
+
+    std::vector<AAPL::MeshSimplifier::Chain> chains =
+        AAPL::MeshSimplifier::buildChains(sources, simplificationPool());
+
+    for(size_t chain = 0; chain < chains.size(); chain++)
+    {
+        [_submeshes[submeshIndices[chain]] setLevels:chains[chain]
+                                         metalDevice:device];
+    }
+}
+
 /// Load the Model I/O mesh, including vertex data and submesh data which have index buffers and
 ///   textures.  Also generate tangent and bitangent vertex attributes
 - (nonnull instancetype) initWithModelIOMesh:(nonnull MDLMesh *)modelIOMesh
@@ -309,6 +494,10 @@ Implementation for Mesh and Submesh objects
         [_submeshes addObject:submesh];
     }
 
+    // Build geometric levels of detail for the renderer to select from by screen space error
+    [self buildLevelsWithModelIOMesh:modelIOMesh
+                         metalDevice:device];
+
     return self;
 }
 
@@ -0,0 +1,1099 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Quadric error mesh simplification. Edges of an indexed triangle list are collapsed in passes: the
+cost of every candidate collapse is evaluated in parallel, then the cheapest independent collapses
+are applied. Vertices that share a position but not their attributes (UV, normal or tangent seams)
+are collapsed together along the seam, so seams and open borders keep their shape. A chain of
+levels shares the source vertex buffer; each level reports its geometric error so a renderer can
+pick the coarsest level whose error stays under a pixel budget on screen.
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "WorkStealingPool.h"
+
+#include "AAPLMeshSimplifier.h"
+
+#pragma mark -
+#pragma mark Private - Geometry
+
+namespace AAPL
+{
+    namespace MeshSimplifier
+    {
+        static const uint32_t kNone = 0xffffffff;
+
+        // Open edges weigh this much more than the triangles around them
+        static const float kBorderWeight = 10.0f;
+
+        // Candidates evaluated per task
+        static const size_t kCostGrain = 4096;
+
+        struct float3
+        {
+            float x, y, z;
+        };
+
+        static inline float3 operator-(const float3& a, const float3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+        static inline float3 operator+(const float3& a, const float3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+        static inline float3 operator*(const float3& a, const float& s)  { return {a.x * s, a.y * s, a.z * s}; }
+
+        static inline float dot(const float3& a, const float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+        static inline float3 cross(const float3& a, const float3& b)
+        {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        // Squared distance from p to the closest point of triangle abc, by the Voronoi region of
+        // the triangle that p falls into
+        static float distanceSquared(const float3& p, const float3& a, const float3& b, const float3& c)
+        {
+            const float3 ab = b - a;
+            const float3 ac = c - a;
+            const float3 ap = p - a;
+
+            const float d1 = dot(ab, ap);
+            const float d2 = dot(ac, ap);
+
+            float3 closest = a;
+
+            const float3 bp = p - b;
+            const float3 cp = p - c;
+
+            const float d3 = dot(ab, bp);
+            const float d4 = dot(ac, bp);
+            const float d5 = dot(ab, cp);
+            const float d6 = dot(ac, cp);
+
+            const float vc = d1 * d4 - d3 * d2;
+            const float vb = d5 * d2 - d1 * d6;
+            const float va = d3 * d6 - d5 * d4;
+
+            if((d1 <= 0.0f) && (d2 <= 0.0f))
+            {
+                closest = a;
+            }
+            else if((d3 >= 0.0f) && (d4 <= d3))
+            {
+                closest = b;
+            }
+            else if((vc <= 0.0f) && (d1 >= 0.0f) && (d3 <= 0.0f))
+            {
+                closest = a + ab * (d1 / (d1 - d3));
+            }
+            else if((d6 >= 0.0f) && (d5 <= d6))
+            {
+                closest = c;
+            }
+            else if((vb <= 0.0f) && (d2 >= 0.0f) && (d6 <= 0.0f))
+            {
+                closest = a + ac * (d2 / (d2 - d6));
+            }
+            else if((va <= 0.0f) && (d4 >= d3) && (d5 >= d6))
+            {
+                closest = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+            }
+            else
+            {
+                const float denominator = 1.0f / (va + vb + vc);
+
+                closest = a + ab * (vb * denominator) + ac * (vc * denominator);
+            }
+
+            const float3 d = p - closest;
+
+            return dot(d, d);
+        }
+
+        // Sum of squared distances to weighted planes: p'Ap + 2b'p + c, over a total weight w
+        struct Quadric
+        {
+            double a00, a11, a22, a01, a02, a12;
+            double b0, b1, b2;
+            double c;
+            double w;
+        };
+
+        static void add(Quadric& rQ, const Quadric& rOther)
+        {
+            rQ.a00 += rOther.a00; rQ.a11 += rOther.a11; rQ.a22 += rOther.a22;
+            rQ.a01 += rOther.a01; rQ.a02 += rOther.a02; rQ.a12 += rOther.a12;
+            rQ.b0  += rOther.b0;  rQ.b1  += rOther.b1;  rQ.b2  += rOther.b2;
+            rQ.c   += rOther.c;
+            rQ.w   += rOther.w;
+        }
+
+        static Quadric plane(const float3& n, const float& d, const float& weight)
+        {
+            const double w = weight;
+
+            return {w * n.x * n.x, w * n.y * n.y, w * n.z * n.z,
+                    w * n.x * n.y, w * n.x * n.z, w * n.y * n.z,
+                    w * n.x * d,   w * n.y * d,   w * n.z * d,
+                    w * d * d,
+                    w};
+        }
+
+        // Mean squared distance of the planes to p
+        static float quadricError(const Quadric& rQ, const float3& p)
+        {
+            const double x = p.x;
+            const double y = p.y;
+            const double z = p.z;
+
+            const double e = rQ.a00 * x * x + rQ.a11 * y * y + rQ.a22 * z * z
+                           + 2.0 * (rQ.a01 * x * y + rQ.a02 * x * z + rQ.a12 * y * z)
+                           + 2.0 * (rQ.b0 * x + rQ.b1 * y + rQ.b2 * z)
+                           + rQ.c;
+
+            return (rQ.w > 0.0) ? float(std::fabs(e) / rQ.w) : 0.0f;
+        }
+
+        // Squared difference between an attribute component a kept by a vertex and the linear
+        // interpolation g.p + d of that component across each triangle around the vertex, summed
+        // with weights w; a collapse along which the attribute varies linearly costs nothing
+        struct AttributeQuadric
+        {
+            double g00, g11, g22, g01, g02, g12;    // Sum of w g g'
+            double gd0, gd1, gd2;                   // Sum of w g d
+            double g0, g1, g2;                      // Sum of w g
+            double dd, d;                           // Sums of w d d and w d
+            double w;
+        };
+
+        static void add(AttributeQuadric& rQ, const AttributeQuadric& rOther)
+        {
+            rQ.g00 += rOther.g00; rQ.g11 += rOther.g11; rQ.g22 += rOther.g22;
+            rQ.g01 += rOther.g01; rQ.g02 += rOther.g02; rQ.g12 += rOther.g12;
+            rQ.gd0 += rOther.gd0; rQ.gd1 += rOther.gd1; rQ.gd2 += rOther.gd2;
+            rQ.g0  += rOther.g0;  rQ.g1  += rOther.g1;  rQ.g2  += rOther.g2;
+            rQ.dd  += rOther.dd;  rQ.d   += rOther.d;
+            rQ.w   += rOther.w;
+        }
+
+        static AttributeQuadric gradient(const float3& g, const float& d, const float& weight)
+        {
+            const double w = weight;
+
+            return {w * g.x * g.x, w * g.y * g.y, w * g.z * g.z,
+                    w * g.x * g.y, w * g.x * g.z, w * g.y * g.z,
+                    w * g.x * d,   w * g.y * d,   w * g.z * d,
+                    w * g.x,       w * g.y,       w * g.z,
+                    w * d * d,     w * d,
+                    w};
+        }
+
+        static double quadricError(const AttributeQuadric& rQ, const float3& p, const float& a)
+        {
+            const double x = p.x;
+            const double y = p.y;
+            const double z = p.z;
+
+            return rQ.g00 * x * x + rQ.g11 * y * y + rQ.g22 * z * z
+                 + 2.0 * (rQ.g01 * x * y + rQ.g02 * x * z + rQ.g12 * y * z)
+                 + 2.0 * (x * (rQ.gd0 - a * rQ.g0) + y * (rQ.gd1 - a * rQ.g1) + z * (rQ.gd2 - a * rQ.g2))
+                 + rQ.dd - 2.0 * a * rQ.d + double(a) * a * rQ.w;
+        }
+
+#pragma mark -
+#pragma mark Private - Topology
+
+        // Half edges leaving every vertex
+        struct Adjacency
+        {
+            struct Edge
+            {
+                uint32_t next;
+                uint32_t prev;
+            };
+
+            std::vector<uint32_t> offsets;
+            std::vector<Edge>     edges;
+
+            void build(const uint32_t* pIndices, const size_t& indexCount, const size_t& vertexCount)
+            {
+                offsets.assign(vertexCount + 1, 0);
+                edges.resize(indexCount);
+
+                for(size_t i = 0; i < indexCount; ++i)
+                {
+                    offsets[pIndices[i] + 1]++;
+                }
+
+                for(size_t v = 0; v < vertexCount; ++v)
+                {
+                    offsets[v + 1] += offsets[v];
+                }
+
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+
+                for(size_t i = 0; i < indexCount; i += 3)
+                {
+                    const uint32_t a = pIndices[i];
+                    const uint32_t b = pIndices[i + 1];
+                    const uint32_t c = pIndices[i + 2];
+
+                    edges[cursor[a]++] = {b, c};
+                    edges[cursor[b]++] = {c, a};
+                    edges[cursor[c]++] = {a, b};
+                }
+            }
+
+            bool hasEdge(const uint32_t& a, const uint32_t& b) const
+            {
+                for(uint32_t e = offsets[a]; e < offsets[a + 1]; ++e)
+                {
+                    if(edges[e].next == b)
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+        };
+
+        // A border vertex slides along its open edge, a seam vertex along its seam (with the vertex
+        // on the other side of the seam), anything else that is not manifold stays put
+        enum Kind : uint8_t
+        {
+            eKindManifold = 0,
+            eKindBorder,
+            eKindSeam,
+            eKindLocked
+        };
+
+        struct Collapse
+        {
+            uint32_t v;         // Removed vertex
+            uint32_t t;         // Vertex it merges into
+            float    cost;
+        };
+
+        class Simplifier
+        {
+        public:
+            Simplifier(const Source& rSource, Threads::WorkStealingPool* pPool);
+
+            // Simplify further; a second run continues where the first stopped. rError is the
+            // deviation of the source vertices from the result (see deviation()).
+            size_t run(uint32_t* pDestination, const size_t& targetIndexCount, const float& targetError, float& rError);
+
+        private:
+            void weld();
+            void classify();
+            void computeQuadrics();
+
+            bool canCollapse(const uint32_t& v, const uint32_t& t) const;
+            uint32_t twin(const uint32_t& v, const uint32_t& t) const;
+
+            float attribute(const uint32_t& v, const size_t& component) const;
+            float attributeError(const uint32_t& v, const uint32_t& t) const;
+            void  mergeAttributes(const uint32_t& v, const uint32_t& t);
+            void  evaluate(Collapse& rCollapse) const;
+
+            bool flips(const uint32_t& v, const uint32_t& t) const;
+
+            void gatherCandidates();
+            size_t applyCollapses(const size_t& goal, const float& limit);
+            void filterTriangles();
+
+            // Largest distance from a source vertex to the triangles around the vertex it merged
+            // into, in scaled units; a bound of its distance to the simplified surface
+            float deviation();
+
+            const Source&              mrSource;
+            Threads::WorkStealingPool* mpPool;
+
+            std::vector<uint32_t> m_Indices;
+            std::vector<float3>   m_Positions;          // Scaled into a unit box
+            float                 mnScale;
+
+            std::vector<uint32_t> m_Remap;              // First vertex with the same position
+            std::vector<uint32_t> m_Wedge;              // Next vertex with the same position, circular
+            std::vector<uint32_t> m_OpenOut;            // Open edge leaving the vertex, itself if several
+            std::vector<uint32_t> m_OpenIn;             // Open edge entering the vertex, itself if several
+            std::vector<Kind>     m_Kinds;
+            std::vector<Quadric>  m_Quadrics;           // Per position
+
+            size_t                        mnComponents;         // Attribute components per vertex
+            std::vector<AttributeQuadric> m_AttributeQuadrics;  // Per vertex and component
+            std::vector<float>            m_Areas;              // Per vertex, of the triangles around it
+
+            Adjacency             m_Adjacency;
+            bool                  mbAdjacencyCurrent;   // Built from m_Indices as they are
+            std::vector<Collapse> m_Candidates;
+            std::vector<uint32_t> m_CollapseRemap;
+            std::vector<uint8_t>  m_Locked;             // Per position, for the current pass
+
+            std::vector<uint32_t> m_SourceVertices;     // Vertices the source indices reference
+            std::vector<uint32_t> m_Representatives;    // Vertex every vertex merged into, over all runs
+        }; // Simplifier
+    } // MeshSimplifier
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Simplifier
+
+AAPL::MeshSimplifier::Simplifier::Simplifier(const Source& rSource, Threads::WorkStealingPool* pPool)
+: mrSource(rSource),
+  mpPool(pPool),
+  m_Indices(rSource.pIndices, rSource.pIndices + rSource.indexCount - rSource.indexCount % 3),
+  mnScale(1.0f),
+  mnComponents(0),
+  mbAdjacencyCurrent(false)
+{
+    const size_t   vertexCount = rSource.vertexCount;
+    const uint8_t* pBase       = reinterpret_cast<const uint8_t*>(rSource.pPositions);
+
+    float3 minimum = { FLT_MAX,  FLT_MAX,  FLT_MAX};
+    float3 maximum = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    m_Positions.resize(vertexCount);
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        std::memcpy(&m_Positions[v], pBase + v * rSource.positionStride, sizeof(float3));
+
+        minimum = {std::min(minimum.x, m_Positions[v].x), std::min(minimum.y, m_Positions[v].y), std::min(minimum.z, m_Positions[v].z)};
+        maximum = {std::max(maximum.x, m_Positions[v].x), std::max(maximum.y, m_Positions[v].y), std::max(maximum.z, m_Positions[v].z)};
+    }
+
+    const float extent = std::max(maximum.x - minimum.x, std::max(maximum.y - minimum.y, maximum.z - minimum.z));
+
+    mnScale = (extent > 0.0f) ? 1.0f / extent : 1.0f;
+
+    weld();
+
+    for(float3& rPosition : m_Positions)
+    {
+        rPosition = {(rPosition.x - minimum.x) * mnScale, (rPosition.y - minimum.y) * mnScale, (rPosition.z - minimum.z) * mnScale};
+    }
+
+    m_Adjacency.build(m_Indices.data(), m_Indices.size(), vertexCount);
+
+    mbAdjacencyCurrent = true;
+
+    m_Representatives.resize(vertexCount);
+
+    for(uint32_t v = 0; v < vertexCount; ++v)
+    {
+        m_Representatives[v] = v;
+
+        if(m_Adjacency.offsets[v + 1] > m_Adjacency.offsets[v])
+        {
+            m_SourceVertices.push_back(v);
+        }
+    }
+
+    classify();
+    computeQuadrics();
+}
+
+// Vertices are welded on their exact position, before scaling can merge near neighbours
+void AAPL::MeshSimplifier::Simplifier::weld()
+{
+    struct Key
+    {
+        uint32_t x, y, z;
+
+        bool operator==(const Key& rOther) const { return (x == rOther.x) && (y == rOther.y) && (z == rOther.z); }
+    };
+
+    struct Hash
+    {
+        size_t operator()(const Key& rKey) const
+        {
+            return (rKey.x * 73856093u) ^ (rKey.y * 19349663u) ^ (rKey.z * 83492791u);
+        }
+    };
+
+    const size_t vertexCount = m_Positions.size();
+
+    std::unordered_map<Key, uint32_t, Hash> positions(vertexCount);
+
+    m_Remap.resize(vertexCount);
+    m_Wedge.resize(vertexCount);
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        Key key;
+
+        std::memcpy(&key, &m_Positions[v], sizeof(key));
+
+        // -0 and 0 are the same position
+        key.x = (key.x == 0x80000000u) ? 0 : key.x;
+        key.y = (key.y == 0x80000000u) ? 0 : key.y;
+        key.z = (key.z == 0x80000000u) ? 0 : key.z;
+
+        const uint32_t first = positions.insert(std::make_pair(key, uint32_t(v))).first->second;
+
+        m_Remap[v] = first;
+        m_Wedge[v] = uint32_t(v);
+
+        if(first != v)
+        {
+            m_Wedge[v]     = m_Wedge[first];
+            m_Wedge[first] = uint32_t(v);
+        }
+    }
+}
+
+void AAPL::MeshSimplifier::Simplifier::classify()
+{
+    const size_t vertexCount = m_Positions.size();
+
+    m_OpenOut.assign(vertexCount, kNone);
+    m_OpenIn.assign(vertexCount, kNone);
+    m_Kinds.assign(vertexCount, eKindLocked);
+
+    for(uint32_t v = 0; v < vertexCount; ++v)
+    {
+        for(uint32_t e = m_Adjacency.offsets[v]; e < m_Adjacency.offsets[v + 1]; ++e)
+        {
+            const uint32_t t = m_Adjacency.edges[e].next;
+
+            if(!m_Adjacency.hasEdge(t, v))
+            {
+                m_OpenIn[t]  = (m_OpenIn[t] == kNone) ? v : t;
+                m_OpenOut[v] = (m_OpenOut[v] == kNone) ? t : v;
+            }
+        }
+    }
+
+    for(uint32_t v = 0; v < vertexCount; ++v)
+    {
+        const uint32_t w = m_Wedge[v];
+
+        if(w == v)
+        {
+            if((m_OpenIn[v] == kNone) && (m_OpenOut[v] == kNone))
+            {
+                m_Kinds[v] = eKindManifold;
+            }
+            else if((m_OpenIn[v] != kNone) && (m_OpenOut[v] != kNone) && (m_OpenIn[v] != v) && (m_OpenOut[v] != v))
+            {
+                m_Kinds[v] = eKindBorder;
+            }
+        }
+        else if(m_Wedge[w] == v)
+        {
+            // Two wedges whose open edges run along the same positions in opposite directions
+            const uint32_t inV  = m_OpenIn[v];
+            const uint32_t outV = m_OpenOut[v];
+            const uint32_t inW  = m_OpenIn[w];
+            const uint32_t outW = m_OpenOut[w];
+
+            if((inV != kNone) && (outV != kNone) && (inW != kNone) && (outW != kNone) &&
+               (inV != v) && (outV != v) && (inW != w) && (outW != w) &&
+               (m_Remap[inV] == m_Remap[outW]) && (m_Remap[outV] == m_Remap[inW]) &&
+               (m_Remap[inV] != m_Remap[outV]))
+            {
+                m_Kinds[v] = eKindSeam;
+            }
+        }
+    }
+}
+
+void AAPL::MeshSimplifier::Simplifier::computeQuadrics()
+{
+    m_Quadrics.assign(m_Positions.size(), Quadric());
+
+    for(const Attribute& rAttribute : mrSource.attributes)
+    {
+        mnComponents += rAttribute.components;
+    }
+
+    m_AttributeQuadrics.assign(m_Positions.size() * mnComponents, AttributeQuadric());
+    m_Areas.assign(m_Positions.size(), 0.0f);
+
+    for(size_t i = 0; i < m_Indices.size(); i += 3)
+    {
+        const uint32_t corners[3] = {m_Indices[i], m_Indices[i + 1], m_Indices[i + 2]};
+
+        const float3 p0 = m_Positions[corners[0]];
+        const float3 e1 = m_Positions[corners[1]] - p0;
+        const float3 e2 = m_Positions[corners[2]] - p0;
+        const float3 n  = cross(e1, e2);
+        const float  nn = dot(n, n);
+        const float  l  = std::sqrt(nn);
+
+        if(l <= 0.0f)
+        {
+            continue;
+        }
+
+        const float3  unit = {n.x / l, n.y / l, n.z / l};
+        const Quadric q    = plane(unit, -dot(unit, p0), 0.5f * l);
+
+        for(size_t k = 0; k < 3; ++k)
+        {
+            add(m_Quadrics[m_Remap[corners[k]]], q);
+
+            m_Areas[corners[k]] += 0.5f * l;
+        }
+
+        // The gradient g of every attribute component x across the triangle solves g.e1 = x1 - x0,
+        // g.e2 = x2 - x0 and g.n = 0
+        const float3 g1 = cross(e2, n);
+        const float3 g2 = cross(n, e1);
+
+        size_t component = 0;
+
+        for(const Attribute& rAttribute : mrSource.attributes)
+        {
+            for(size_t c = 0; c < rAttribute.components; ++c, ++component)
+            {
+                const float x0 = attribute(corners[0], component);
+                const float d1 = (attribute(corners[1], component) - x0) / nn;
+                const float d2 = (attribute(corners[2], component) - x0) / nn;
+
+                const float3           g  = {d1 * g1.x + d2 * g2.x, d1 * g1.y + d2 * g2.y, d1 * g1.z + d2 * g2.z};
+                const AttributeQuadric aq = gradient(g, x0 - dot(g, p0), rAttribute.weight * 0.5f * l);
+
+                for(size_t k = 0; k < 3; ++k)
+                {
+                    add(m_AttributeQuadrics[corners[k] * mnComponents + component], aq);
+                }
+            }
+        }
+
+        // Open edges hold a plane through them, perpendicular to the triangle
+        for(size_t k = 0; k < 3; ++k)
+        {
+            const uint32_t a = corners[k];
+            const uint32_t b = corners[(k + 1) % 3];
+
+            if(m_OpenOut[a] == kNone || m_Adjacency.hasEdge(b, a))
+            {
+                continue;
+            }
+
+            const float3 edge   = m_Positions[b] - m_Positions[a];
+            const float  length = dot(edge, edge);
+            const float3 normal = cross(edge, unit);
+            const float  nl     = std::sqrt(dot(normal, normal));
+
+            if(nl <= 0.0f)
+            {
+                continue;
+            }
+
+            const float3  side = {normal.x / nl, normal.y / nl, normal.z / nl};
+            const Quadric e    = plane(side, -dot(side, m_Positions[a]), kBorderWeight * length);
+
+            add(m_Quadrics[m_Remap[a]], e);
+            add(m_Quadrics[m_Remap[b]], e);
+        }
+    }
+}
+
+bool AAPL::MeshSimplifier::Simplifier::canCollapse(const uint32_t& v, const uint32_t& t) const
+{
+    if(m_Remap[v] == m_Remap[t])
+    {
+        return false;
+    }
+
+    switch(m_Kinds[v])
+    {
+        case eKindManifold:
+            return true;
+
+        case eKindBorder:
+            return (m_Kinds[t] == eKindBorder) && ((m_OpenOut[v] == t) || (m_OpenIn[v] == t));
+
+        case eKindSeam:
+            return (m_Kinds[t] == eKindSeam) && ((m_OpenOut[v] == t) || (m_OpenIn[v] == t)) && (twin(v, t) != kNone);
+
+        default:
+            return false;
+    }
+}
+
+// Where the other wedge of seam vertex v goes when v collapses into t
+uint32_t AAPL::MeshSimplifier::Simplifier::twin(const uint32_t& v, const uint32_t& t) const
+{
+    const uint32_t w = m_Wedge[v];
+    const uint32_t s = (m_OpenOut[v] == t) ? m_OpenIn[w] : m_OpenOut[w];
+
+    if((s == kNone) || (s == w) || (m_Remap[s] != m_Remap[t]) || (m_Kinds[s] != eKindSeam))
+    {
+        return kNone;
+    }
+
+    return s;
+}
+
+float AAPL::MeshSimplifier::Simplifier::attribute(const uint32_t& v, const size_t& component) const
+{
+    size_t first = 0;
+
+    for(const Attribute& rAttribute : mrSource.attributes)
+    {
+        if(component < first + rAttribute.components)
+        {
+            const uint8_t* pBase = reinterpret_cast<const uint8_t*>(rAttribute.pData);
+
+            return reinterpret_cast<const float*>(pBase + v * rAttribute.stride)[component - first];
+        }
+
+        first += rAttribute.components;
+    }
+
+    return 0.0f;
+}
+
+// Weighted mean squared attribute error over the triangles around v when v takes t's place
+float AAPL::MeshSimplifier::Simplifier::attributeError(const uint32_t& v, const uint32_t& t) const
+{
+    if((mnComponents == 0) || (m_Areas[v] <= 0.0f))
+    {
+        return 0.0f;
+    }
+
+    const AttributeQuadric* pQuadrics = &m_AttributeQuadrics[v * mnComponents];
+
+    double error = 0.0;
+
+    for(size_t c = 0; c < mnComponents; ++c)
+    {
+        error += quadricError(pQuadrics[c], m_Positions[t], attribute(t, c));
+    }
+
+    return float(std::fabs(error) / m_Areas[v]);
+}
+
+void AAPL::MeshSimplifier::Simplifier::evaluate(Collapse& rCollapse) const
+{
+    const uint32_t v = rCollapse.v;
+    const uint32_t t = rCollapse.t;
+
+    rCollapse.cost = quadricError(m_Quadrics[m_Remap[v]], m_Positions[t]) + attributeError(v, t);
+
+    if(m_Kinds[v] == eKindSeam)
+    {
+        rCollapse.cost += attributeError(m_Wedge[v], twin(v, t));
+    }
+}
+
+void AAPL::MeshSimplifier::Simplifier::mergeAttributes(const uint32_t& v, const uint32_t& t)
+{
+    for(size_t c = 0; c < mnComponents; ++c)
+    {
+        add(m_AttributeQuadrics[t * mnComponents + c], m_AttributeQuadrics[v * mnComponents + c]);
+    }
+
+    m_Areas[t] += m_Areas[v];
+}
+
+// Whether moving v onto t turns a triangle around v over
+bool AAPL::MeshSimplifier::Simplifier::flips(const uint32_t& v, const uint32_t& t) const
+{
+    uint32_t wedge = v;
+
+    do
+    {
+        for(uint32_t e = m_Adjacency.offsets[wedge]; e < m_Adjacency.offsets[wedge + 1]; ++e)
+        {
+            // Neighbours may have moved earlier in this pass
+            const uint32_t b = m_CollapseRemap[m_Adjacency.edges[e].next];
+            const uint32_t c = m_CollapseRemap[m_Adjacency.edges[e].prev];
+
+            if((m_Remap[b] == m_Remap[t]) || (m_Remap[c] == m_Remap[t]))
+            {
+                continue;
+            }
+
+            const float3 before = cross(m_Positions[b] - m_Positions[v], m_Positions[c] - m_Positions[v]);
+            const float3 after  = cross(m_Positions[b] - m_Positions[t], m_Positions[c] - m_Positions[t]);
+
+            if(dot(before, after) <= 0.0f)
+            {
+                return true;
+            }
+        }
+
+        wedge = m_Wedge[wedge];
+    }
+    while(wedge != v);
+
+    return false;
+}
+
+void AAPL::MeshSimplifier::Simplifier::gatherCandidates()
+{
+    m_Candidates.clear();
+
+    for(size_t i = 0; i < m_Indices.size(); i += 3)
+    {
+        for(size_t k = 0; k < 3; ++k)
+        {
+            const uint32_t a = m_Indices[i + k];
+            const uint32_t b = m_Indices[i + (k + 1) % 3];
+
+            // Edges with a twin are visited once
+            if((a > b) && m_Adjacency.hasEdge(b, a))
+            {
+                continue;
+            }
+
+            if(canCollapse(a, b))
+            {
+                m_Candidates.push_back({a, b, 0.0f});
+            }
+
+            if(canCollapse(b, a))
+            {
+                m_Candidates.push_back({b, a, 0.0f});
+            }
+        }
+    }
+
+    const size_t count  = m_Candidates.size();
+    const size_t chunks = (count + kCostGrain - 1) / kCostGrain;
+
+    const auto evaluateChunk = [this, count](size_t chunk)
+    {
+        const size_t last = std::min(count, (chunk + 1) * kCostGrain);
+
+        for(size_t c = chunk * kCostGrain; c < last; ++c)
+        {
+            evaluate(m_Candidates[c]);
+        }
+    };
+
+    if(mpPool && (chunks > 1))
+    {
+        mpPool->parallelFor(chunks, evaluateChunk, 1);
+    }
+    else
+    {
+        for(size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            evaluateChunk(chunk);
+        }
+    }
+
+    std::sort(m_Candidates.begin(), m_Candidates.end(), [](const Collapse& a, const Collapse& b)
+    {
+        return (a.cost < b.cost) || ((a.cost == b.cost) && (a.v < b.v));
+    });
+}
+
+size_t AAPL::MeshSimplifier::Simplifier::applyCollapses(const size_t& goal, const float& limit)
+{
+    const size_t vertexCount = m_Positions.size();
+
+    m_CollapseRemap.resize(vertexCount);
+    m_Locked.assign(vertexCount, 0);
+
+    for(uint32_t v = 0; v < vertexCount; ++v)
+    {
+        m_CollapseRemap[v] = v;
+    }
+
+    size_t applied = 0;
+
+    for(const Collapse& rCollapse : m_Candidates)
+    {
+        if((applied >= goal) || (rCollapse.cost > limit))
+        {
+            break;
+        }
+
+        const uint32_t v = rCollapse.v;
+        const uint32_t t = rCollapse.t;
+
+        if(m_Locked[m_Remap[v]] || m_Locked[m_Remap[t]] || flips(v, t))
+        {
+            continue;
+        }
+
+        m_CollapseRemap[v] = t;
+        mergeAttributes(v, t);
+
+        if(m_Kinds[v] == eKindSeam)
+        {
+            const uint32_t w = m_Wedge[v];
+            const uint32_t s = twin(v, t);
+
+            m_CollapseRemap[w] = s;
+            mergeAttributes(w, s);
+        }
+
+        add(m_Quadrics[m_Remap[t]], m_Quadrics[m_Remap[v]]);
+
+        m_Locked[m_Remap[v]] = 1;
+        m_Locked[m_Remap[t]] = 1;
+
+        applied++;
+    }
+
+    return applied;
+}
+
+void AAPL::MeshSimplifier::Simplifier::filterTriangles()
+{
+    size_t kept = 0;
+
+    for(size_t i = 0; i < m_Indices.size(); i += 3)
+    {
+        const uint32_t a = m_CollapseRemap[m_Indices[i]];
+        const uint32_t b = m_CollapseRemap[m_Indices[i + 1]];
+        const uint32_t c = m_CollapseRemap[m_Indices[i + 2]];
+
+        if((m_Remap[a] != m_Remap[b]) && (m_Remap[b] != m_Remap[c]) && (m_Remap[c] != m_Remap[a]))
+        {
+            m_Indices[kept++] = a;
+            m_Indices[kept++] = b;
+            m_Indices[kept++] = c;
+        }
+    }
+
+    m_Indices.resize(kept);
+
+    mbAdjacencyCurrent = false;
+
+    for(uint32_t& rRepresentative : m_Representatives)
+    {
+        rRepresentative = m_CollapseRemap[rRepresentative];
+    }
+
+    // Open edges now end at the vertices their ends collapsed into. When a seam collapses against
+    // the direction of an open edge, the edge continues from where the removed vertex's edge went.
+    for(std::vector<uint32_t>* pLoop : {&m_OpenOut, &m_OpenIn})
+    {
+        std::vector<uint32_t>& rLoop = *pLoop;
+
+        for(size_t v = 0; v < rLoop.size(); ++v)
+        {
+            if(rLoop[v] != kNone)
+            {
+                const uint32_t l = rLoop[v];
+                const uint32_t r = m_CollapseRemap[l];
+
+                rLoop[v] = (r == v) ? rLoop[l] : r;
+            }
+        }
+    }
+}
+
+float AAPL::MeshSimplifier::Simplifier::deviation()
+{
+    if(!mbAdjacencyCurrent)
+    {
+        m_Adjacency.build(m_Indices.data(), m_Indices.size(), m_Positions.size());
+
+        mbAdjacencyCurrent = true;
+    }
+
+    float worst = 0.0f;
+
+    for(const uint32_t& v : m_SourceVertices)
+    {
+        const uint32_t r = m_Representatives[v];
+
+        if(r == v)
+        {
+            continue;
+        }
+
+        // Any triangle at the representative's position bounds the distance to the nearest one
+        const float3& rPoint = m_Positions[v];
+
+        float  nearest = FLT_MAX;
+        uint32_t wedge = r;
+
+        do
+        {
+            for(uint32_t e = m_Adjacency.offsets[wedge]; e < m_Adjacency.offsets[wedge + 1]; ++e)
+            {
+                const Adjacency::Edge& rEdge = m_Adjacency.edges[e];
+
+                nearest = std::min(nearest, distanceSquared(rPoint, m_Positions[wedge], m_Positions[rEdge.next], m_Positions[rEdge.prev]));
+            }
+
+            wedge = m_Wedge[wedge];
+        }
+        while(wedge != r);
+
+        if(nearest == FLT_MAX)
+        {
+            const float3 d = rPoint - m_Positions[r];
+
+            nearest = dot(d, d);
+        }
+
+        worst = std::max(worst, nearest);
+    }
+
+    return std::sqrt(worst);
+}
+
+size_t AAPL::MeshSimplifier::Simplifier::run(uint32_t* pDestination,
+                                             const size_t& targetIndexCount,
+                                             const float& targetError,
+                                             float& rError)
+{
+    const float limit = (targetError < FLT_MAX) ? (targetError * mnScale) * (targetError * mnScale) : FLT_MAX;
+
+    while(m_Indices.size() > targetIndexCount)
+    {
+        if(!mbAdjacencyCurrent)
+        {
+            m_Adjacency.build(m_Indices.data(), m_Indices.size(), m_Positions.size());
+
+            mbAdjacencyCurrent = true;
+        }
+
+        gatherCandidates();
+
+        // A manifold collapse removes two triangles; leave room for the goal to be missed
+        const size_t goal = std::max<size_t>(1, (m_Indices.size() - targetIndexCount) / 6);
+
+        if(applyCollapses(goal, limit) == 0)
+        {
+            break;
+        }
+
+        filterTriangles();
+    }
+
+    std::copy(m_Indices.begin(), m_Indices.end(), pDestination);
+
+    rError = deviation() / mnScale;
+
+    return m_Indices.size();
+}
+
+#pragma mark -
+#pragma mark Public - Simplification
+
+size_t AAPL::MeshSimplifier::simplify(uint32_t* pDestination,
+                                      const Source& rSource,
+                                      const size_t& targetIndexCount,
+                                      const float& targetError,
+                                      float& rError,
+                                      Threads::WorkStealingPool* pPool)
+{
+    rError = 0.0f;
+
+    if((rSource.indexCount < 3) || (rSource.vertexCount == 0))
+    {
+        std::copy(rSource.pIndices, rSource.pIndices + rSource.indexCount, pDestination);
+
+        return rSource.indexCount;
+    }
+
+    Simplifier simplifier(rSource, pPool);
+
+    return simplifier.run(pDestination, targetIndexCount, targetError, rError);
+}
+
+AAPL::MeshSimplifier::Chain AAPL::MeshSimplifier::buildChain(const Source& rSource,
+                                                             Threads::WorkStealingPool* pPool,
+                                                             const float& ratio,
+                                                             const size_t& maxLevels,
+                                                             const size_t& minTriangles)
+{
+    Chain chain;
+
+    chain.indices.assign(rSource.pIndices, rSource.pIndices + rSource.indexCount);
+    chain.levels.push_back({0, rSource.indexCount, 0.0f});
+
+    if((rSource.indexCount < 3) || (rSource.vertexCount == 0))
+    {
+        return chain;
+    }
+
+    // Every level continues simplifying the one before it, so the quadrics keep every source
+    // plane and the errors are measured against level 0
+    Simplifier simplifier(rSource, pPool);
+
+    std::vector<uint32_t> level(rSource.indexCount);
+
+    while(chain.levels.size() < maxLevels)
+    {
+        const Level previous = chain.levels.back();
+        const size_t target  = 3 * size_t(float(previous.indexCount / 3) * ratio);
+
+        if(target / 3 < minTriangles)
+        {
+            break;
+        }
+
+        float        error = 0.0f;
+        const size_t count = simplifier.run(level.data(), target, FLT_MAX, error);
+
+        if(10 * count > 9 * previous.indexCount)
+        {
+            break;
+        }
+
+        chain.levels.push_back({chain.indices.size(), count, error});
+        chain.indices.insert(chain.indices.end(), level.begin(), level.begin() + count);
+    }
+
+    return chain;
+}
+
+std::vector<AAPL::MeshSimplifier::Chain> AAPL::MeshSimplifier::buildChains(const std::vector<Source>& rSources,
+                                                                           Threads::WorkStealingPool& rPool,
+                                                                           const float& ratio,
+                                                                           const size_t& maxLevels,
+                                                                           const size_t& minTriangles)
+{
+    std::vector<Chain> chains(rSources.size());
+
+    rPool.parallelFor(rSources.size(), [&](size_t i)
+    {
+        chains[i] = buildChain(rSources[i], &rPool, ratio, maxLevels, minTriangles);
+    }, 1);
+
+    return chains;
+}
+
+#pragma mark -
+#pragma mark Public - Level selection
+
+float AAPL::MeshSimplifier::screenSpaceError(const float& error,
+                                             const float& distance,
+                                             const float& fovY,
+                                             const float& viewportHeight)
+{
+    if(distance <= 0.0f)
+    {
+        return FLT_MAX;
+    }
+
+    return error * viewportHeight / (2.0f * distance * std::tan(0.5f * fovY));
+}
+
+size_t AAPL::MeshSimplifier::selectLevel(const Chain& rChain,
+                                         const float& distance,
+                                         const float& fovY,
+                                         const float& viewportHeight,
+                                         const float& maxPixels)
+{
+    size_t level = 0;
+
+    for(size_t i = 1; i < rChain.levels.size(); ++i)
+    {
+        if(screenSpaceError(rChain.levels[i].error, distance, fovY, viewportHeight) > maxPixels)
+        {
+            break;
+        }
+
+        level = i;
+    }
+
+    return level;
+}
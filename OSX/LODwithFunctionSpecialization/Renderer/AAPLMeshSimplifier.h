@@ -0,0 +1,121 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Quadric error mesh simplification. Edges of an indexed triangle list are collapsed in passes: the
+cost of every candidate collapse is evaluated in parallel, then the cheapest independent collapses
+are applied. Vertices that share a position but not their attributes (UV, normal or tangent seams)
+are collapsed together along the seam, so seams and open borders keep their shape. A chain of
+levels shares the source vertex buffer; each level reports its geometric error so a renderer can
+pick the coarsest level whose error stays under a pixel budget on screen.
+*/
+
+#ifndef _AAPL_MESH_SIMPLIFIER_H_
+#define _AAPL_MESH_SIMPLIFIER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace MeshSimplifier
+    {
+        // Each level keeps about this fraction of the previous level's triangles
+        static const float kDefaultLevelRatio = 0.5f;
+
+        // Levels in a chain, including the full resolution level 0
+        static const size_t kDefaultMaxLevels = 5;
+
+        // A chain stops before a level with fewer triangles
+        static const size_t kDefaultMinTriangles = 64;
+
+        // A per-vertex float attribute, stride bytes apart. The weight scales the squared
+        // difference of the attribute against the squared geometric error, measured with the
+        // mesh scaled to a unit box, e.g. 1 for UVs and 0.5 for unit normals.
+        struct Attribute
+        {
+            const float* pData;
+            size_t       stride;
+            size_t       components;
+            float        weight;
+        };
+
+        // Indices [indexOffset, indexOffset + indexCount) of Chain::indices
+        struct Level
+        {
+            size_t indexOffset;
+            size_t indexCount;
+            float  error;           // Bound of the distance from a level 0 vertex to the level, in mesh units
+        };
+
+        struct Chain
+        {
+            std::vector<uint32_t> indices;
+            std::vector<Level>    levels;
+        };
+
+        struct Source
+        {
+            const uint32_t*        pIndices;
+            size_t                 indexCount;
+            const float*           pPositions;
+            size_t                 positionStride;     // Bytes
+            size_t                 vertexCount;
+            std::vector<Attribute> attributes;
+        };
+
+        // Simplify a triangle list until it has at most targetIndexCount indices or the next
+        // collapse would move the surface by more than targetError (mesh units). Writes the
+        // indices to pDestination, which may alias pIndices and must hold indexCount indices.
+        // Returns the new index count; rError bounds the distance from a source vertex to the
+        // result. The pool, when given, evaluates collapse costs in parallel.
+        size_t simplify(uint32_t* pDestination,
+                        const Source& rSource,
+                        const size_t& targetIndexCount,
+                        const float& targetError,
+                        float& rError,
+                        Threads::WorkStealingPool* pPool = nullptr);
+
+        // Level 0 is the source; every next level continues simplifying the previous one to ratio
+        // of its triangles. The chain ends at maxLevels, below minTriangles, or when a level could not
+        // drop at least a tenth of its triangles.
+        Chain buildChain(const Source& rSource,
+                         Threads::WorkStealingPool* pPool = nullptr,
+                         const float& ratio = kDefaultLevelRatio,
+                         const size_t& maxLevels = kDefaultMaxLevels,
+                         const size_t& minTriangles = kDefaultMinTriangles);
+
+        // Chains of several index lists, e.g. the submeshes of one vertex buffer, built in parallel
+        std::vector<Chain> buildChains(const std::vector<Source>& rSources,
+                                       Threads::WorkStealingPool& rPool,
+                                       const float& ratio = kDefaultLevelRatio,
+                                       const size_t& maxLevels = kDefaultMaxLevels,
+                                       const size_t& minTriangles = kDefaultMinTriangles);
+
+        // Height in pixels of an error seen at distance through a perspective projection with a
+        // vertical field of view of fovY radians onto a viewport viewportHeight pixels high
+        float screenSpaceError(const float& error,
+                               const float& distance,
+                               const float& fovY,
+                               const float& viewportHeight);
+
+        // Coarsest level whose error stays within maxPixels on screen
+        size_t selectLevel(const Chain& rChain,
+                           const float& distance,
+                           const float& fovY,
+                           const float& viewportHeight,
+                           const float& maxPixels);
+    } // MeshSimplifier
+} // AAPL
+
+#endif
+
+#endif
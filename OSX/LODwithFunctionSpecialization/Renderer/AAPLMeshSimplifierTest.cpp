@@ -0,0 +1,618 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Test for the mesh simplifier, a standalone program that is not part of the app target. It builds
+level chains for generated meshes and for Temple.obj: a UV sphere and a torus, closed and with UV
+seams split into separate vertices, and a terrain grid with an open border. Every level must keep
+the closed meshes closed and open no edge by position that wasn't open in level 0, so seams don't
+crack; no triangle may bridge a UV seam; and the error a level reports must bound the deviation
+measured from every level 0 vertex to the level's triangles. Chains built on the pool must equal
+the serial ones, and both are timed.
+
+    c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLMeshSimplifier.cpp \
+        ../../../Shared/Threads/WorkStealingPool.cpp AAPLMeshSimplifierTest.cpp -o test
+    ./test [Temple.obj]
+
+The OBJ defaults to the copy in MetalDeferredLighting.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "WorkStealingPool.h"
+
+#include "AAPLMeshSimplifier.h"
+
+using namespace AAPL::MeshSimplifier;
+
+namespace
+{
+    const float kPi = 3.14159265f;
+
+    struct Vertex
+    {
+        float position[3];
+        float normal[3];
+        float uv[2];
+    };
+
+    struct Mesh
+    {
+        std::string           name;
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        bool                  isClosed;
+        bool                  hasWrappedUVs;   // UVs run from 0 to 1 around the seams
+    };
+
+    // Unit sphere; the seam column and the poles repeat positions with other UVs
+    Mesh sphere(const uint32_t& segments, const uint32_t& rings)
+    {
+        Mesh mesh = {"uv sphere", {}, {}, true, true};
+
+        for(uint32_t r = 0; r <= rings; ++r)
+        {
+            for(uint32_t s = 0; s <= segments; ++s)
+            {
+                const float theta = kPi * r / rings;
+                const float phi   = 2.0f * kPi * (s % segments) / segments;
+
+                // Exact zeros at the poles, so all pole vertices share one position
+                const float radius = ((r == 0) || (r == rings)) ? 0.0f : std::sin(theta);
+
+                Vertex vertex = {{radius * std::cos(phi), std::cos(theta), radius * std::sin(phi)},
+                                 {radius * std::cos(phi), std::cos(theta), radius * std::sin(phi)},
+                                 {float(s) / segments, float(r) / rings}};
+
+                mesh.vertices.push_back(vertex);
+            }
+        }
+
+        for(uint32_t r = 0; r < rings; ++r)
+        {
+            for(uint32_t s = 0; s < segments; ++s)
+            {
+                const uint32_t a = r * (segments + 1) + s;
+                const uint32_t c = a + segments + 1;
+
+                if(r > 0)
+                {
+                    mesh.indices.insert(mesh.indices.end(), {a, a + 1, c});
+                }
+
+                if(r + 1 < rings)
+                {
+                    mesh.indices.insert(mesh.indices.end(), {a + 1, c + 1, c});
+                }
+            }
+        }
+
+        return mesh;
+    }
+
+    // Ring of radius 1 and tube of 0.3, seams around both
+    Mesh torus(const uint32_t& segments, const uint32_t& sides)
+    {
+        Mesh mesh = {"torus", {}, {}, true, true};
+
+        for(uint32_t i = 0; i <= segments; ++i)
+        {
+            for(uint32_t j = 0; j <= sides; ++j)
+            {
+                const float u = 2.0f * kPi * (i % segments) / segments;
+                const float w = 2.0f * kPi * (j % sides) / sides;
+
+                Vertex vertex = {{(1.0f + 0.3f * std::cos(w)) * std::cos(u), 0.3f * std::sin(w), (1.0f + 0.3f * std::cos(w)) * std::sin(u)},
+                                 {std::cos(w) * std::cos(u), std::sin(w), std::cos(w) * std::sin(u)},
+                                 {float(i) / segments, float(j) / sides}};
+
+                mesh.vertices.push_back(vertex);
+            }
+        }
+
+        for(uint32_t i = 0; i < segments; ++i)
+        {
+            for(uint32_t j = 0; j < sides; ++j)
+            {
+                const uint32_t p = i * (sides + 1) + j;
+                const uint32_t s = p + sides + 1;
+
+                mesh.indices.insert(mesh.indices.end(), {p, p + 1, s, p + 1, s + 1, s});
+            }
+        }
+
+        return mesh;
+    }
+
+    // Unit square of rolling hills with an open border
+    Mesh terrain(const uint32_t& cells)
+    {
+        Mesh mesh = {"terrain", {}, {}, false, false};
+
+        for(uint32_t y = 0; y <= cells; ++y)
+        {
+            for(uint32_t x = 0; x <= cells; ++x)
+            {
+                const float u = float(x) / cells;
+                const float v = float(y) / cells;
+
+                Vertex vertex = {{u, 0.05f * std::sin(9.0f * u) * std::cos(7.0f * v), v}, {0.0f, 1.0f, 0.0f}, {u, v}};
+
+                mesh.vertices.push_back(vertex);
+            }
+        }
+
+        for(uint32_t y = 0; y < cells; ++y)
+        {
+            for(uint32_t x = 0; x < cells; ++x)
+            {
+                const uint32_t a = y * (cells + 1) + x;
+                const uint32_t c = a + cells + 1;
+
+                mesh.indices.insert(mesh.indices.end(), {a, c, a + 1, a + 1, c, c + 1});
+            }
+        }
+
+        return mesh;
+    }
+
+    // Positions, UVs and normals of an OBJ; every distinct v/vt/vn triple is a vertex and
+    // polygons are fanned into triangles
+    bool loadOBJ(const char* pPath, Mesh& rMesh)
+    {
+        std::ifstream file(pPath);
+
+        if(!file)
+        {
+            return false;
+        }
+
+        rMesh = {pPath, {}, {}, false, false};
+
+        std::vector<float> positions;
+        std::vector<float> uvs;
+        std::vector<float> normals;
+
+        std::map<std::tuple<int, int, int>, uint32_t> vertices;
+
+        std::string line;
+
+        while(std::getline(file, line))
+        {
+            std::istringstream stream(line);
+            std::string        tag;
+
+            stream >> tag;
+
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+
+            if(tag == "v")
+            {
+                stream >> x >> y >> z;
+                positions.insert(positions.end(), {x, y, z});
+            }
+            else if(tag == "vt")
+            {
+                stream >> x >> y;
+                uvs.insert(uvs.end(), {x, y});
+            }
+            else if(tag == "vn")
+            {
+                stream >> x >> y >> z;
+                normals.insert(normals.end(), {x, y, z});
+            }
+            else if(tag == "f")
+            {
+                std::vector<uint32_t> polygon;
+                std::string           corner;
+
+                while(stream >> corner)
+                {
+                    int p = 0;
+                    int t = 0;
+                    int n = 0;
+
+                    if(std::sscanf(corner.c_str(), "%d/%d/%d", &p, &t, &n) < 3)
+                    {
+                        t = 0;
+                        std::sscanf(corner.c_str(), "%d//%d", &p, &n);
+                    }
+
+                    if((p <= 0) || (size_t(3 * p) > positions.size()) || (size_t(2 * t) > uvs.size()) || (size_t(3 * n) > normals.size()))
+                    {
+                        return false;
+                    }
+
+                    const auto key   = std::make_tuple(p, t, n);
+                    auto       found = vertices.find(key);
+
+                    if(found == vertices.end())
+                    {
+                        Vertex vertex = {};
+
+                        for(int k = 0; k < 3; ++k)
+                        {
+                            vertex.position[k] = positions[size_t(3 * (p - 1) + k)];
+                            vertex.normal[k]   = (n > 0) ? normals[size_t(3 * (n - 1) + k)] : 0.0f;
+                        }
+
+                        vertex.uv[0] = (t > 0) ? uvs[size_t(2 * (t - 1))] : 0.0f;
+                        vertex.uv[1] = (t > 0) ? uvs[size_t(2 * (t - 1) + 1)] : 0.0f;
+
+                        found = vertices.insert(std::make_pair(key, uint32_t(rMesh.vertices.size()))).first;
+
+                        rMesh.vertices.push_back(vertex);
+                    }
+
+                    polygon.push_back(found->second);
+                }
+
+                for(size_t k = 1; k + 1 < polygon.size(); ++k)
+                {
+                    rMesh.indices.insert(rMesh.indices.end(), {polygon[0], polygon[k], polygon[k + 1]});
+                }
+            }
+        }
+
+        return !rMesh.indices.empty();
+    }
+
+    Source source(const Mesh& rMesh)
+    {
+        Source result;
+
+        result.pIndices       = rMesh.indices.data();
+        result.indexCount     = rMesh.indices.size();
+        result.pPositions     = rMesh.vertices[0].position;
+        result.positionStride = sizeof(Vertex);
+        result.vertexCount    = rMesh.vertices.size();
+        result.attributes     = {{rMesh.vertices[0].uv, sizeof(Vertex), 2, 1.0f},
+                                 {rMesh.vertices[0].normal, sizeof(Vertex), 3, 0.5f}};
+
+        return result;
+    }
+
+    float extent(const Mesh& rMesh)
+    {
+        float lo[3] = { 1.0e30f,  1.0e30f,  1.0e30f};
+        float hi[3] = {-1.0e30f, -1.0e30f, -1.0e30f};
+
+        for(const Vertex& rVertex : rMesh.vertices)
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                lo[k] = std::min(lo[k], rVertex.position[k]);
+                hi[k] = std::max(hi[k], rVertex.position[k]);
+            }
+        }
+
+        return std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+    }
+
+    // Edges by position without a twin in the opposite direction; a crack along a seam shows up
+    // here even though the seam's vertices are separate
+    size_t openEdges(const Mesh& rMesh, const uint32_t* pIndices, const size_t& count)
+    {
+        std::map<std::tuple<float, float, float>, uint32_t> ids;
+        std::vector<uint32_t>                               position(rMesh.vertices.size());
+
+        for(size_t v = 0; v < rMesh.vertices.size(); ++v)
+        {
+            const float* p = rMesh.vertices[v].position;
+
+            position[v] = ids.insert(std::make_pair(std::make_tuple(p[0] + 0.0f, p[1] + 0.0f, p[2] + 0.0f), uint32_t(ids.size()))).first->second;
+        }
+
+        std::map<std::pair<uint32_t, uint32_t>, int> edges;
+
+        for(size_t i = 0; i + 2 < count; i += 3)
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                edges[std::make_pair(position[pIndices[i + k]], position[pIndices[i + (k + 1) % 3]])]++;
+            }
+        }
+
+        size_t open = 0;
+
+        for(const auto& rEdge : edges)
+        {
+            open += edges.count(std::make_pair(rEdge.first.second, rEdge.first.first)) ? 0 : 1;
+        }
+
+        return open;
+    }
+
+    // Triangles whose UVs span more than half the texture, i.e. that wrap across a seam
+    size_t bridgingTriangles(const Mesh& rMesh, const uint32_t* pIndices, const size_t& count)
+    {
+        size_t bridging = 0;
+
+        for(size_t i = 0; i + 2 < count; i += 3)
+        {
+            for(int k = 0; k < 2; ++k)
+            {
+                const float a = rMesh.vertices[pIndices[i]].uv[k];
+                const float b = rMesh.vertices[pIndices[i + 1]].uv[k];
+                const float c = rMesh.vertices[pIndices[i + 2]].uv[k];
+
+                if(std::max(a, std::max(b, c)) - std::min(a, std::min(b, c)) > 0.5f)
+                {
+                    bridging++;
+                    break;
+                }
+            }
+        }
+
+        return bridging;
+    }
+
+    double distanceSquared(const float* p, const float* a, const float* b, const float* c)
+    {
+        double ab[3], ac[3], ap[3], bp[3], cp[3];
+
+        for(int k = 0; k < 3; ++k)
+        {
+            ab[k] = double(b[k]) - a[k];
+            ac[k] = double(c[k]) - a[k];
+            ap[k] = double(p[k]) - a[k];
+            bp[k] = double(p[k]) - b[k];
+            cp[k] = double(p[k]) - c[k];
+        }
+
+        auto dot = [](const double* x, const double* y) { return x[0] * y[0] + x[1] * y[1] + x[2] * y[2]; };
+
+        const double d1 = dot(ab, ap), d2 = dot(ac, ap);
+        const double d3 = dot(ab, bp), d4 = dot(ac, bp);
+        const double d5 = dot(ab, cp), d6 = dot(ac, cp);
+
+        const double vc = d1 * d4 - d3 * d2;
+        const double vb = d5 * d2 - d1 * d6;
+        const double va = d3 * d6 - d5 * d4;
+
+        // Barycentric weights of b and c of the closest point
+        double s = 0.0;
+        double t = 0.0;
+
+        if((d1 <= 0.0) && (d2 <= 0.0))                          { s = 0.0; t = 0.0; }
+        else if((d3 >= 0.0) && (d4 <= d3))                      { s = 1.0; t = 0.0; }
+        else if((vc <= 0.0) && (d1 >= 0.0) && (d3 <= 0.0))      { s = d1 / (d1 - d3); t = 0.0; }
+        else if((d6 >= 0.0) && (d5 <= d6))                      { s = 0.0; t = 1.0; }
+        else if((vb <= 0.0) && (d2 >= 0.0) && (d6 <= 0.0))      { s = 0.0; t = d2 / (d2 - d6); }
+        else if((va <= 0.0) && (d4 >= d3) && (d5 >= d6))        { t = (d4 - d3) / ((d4 - d3) + (d5 - d6)); s = 1.0 - t; }
+        else                                                    { s = vb / (va + vb + vc); t = vc / (va + vb + vc); }
+
+        double result = 0.0;
+
+        for(int k = 0; k < 3; ++k)
+        {
+            const double d = ap[k] - s * ab[k] - t * ac[k];
+
+            result += d * d;
+        }
+
+        return result;
+    }
+
+    // Largest distance from a vertex of the source triangles to the nearest triangle of the
+    // level, searched in growing shells of a uniform grid
+    float deviation(const Mesh& rMesh, const uint32_t* pIndices, const size_t& count)
+    {
+        const int   kCells = 32;
+        const float size   = extent(rMesh) * 1.0001f + 1.0e-6f;
+
+        float lo[3] = {1.0e30f, 1.0e30f, 1.0e30f};
+
+        for(const Vertex& rVertex : rMesh.vertices)
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                lo[k] = std::min(lo[k], rVertex.position[k]);
+            }
+        }
+
+        auto cell = [&](const float& x, const int& k) {
+            return std::min(kCells - 1, std::max(0, int((x - lo[k]) / size * kCells)));
+        };
+
+        std::vector<std::vector<uint32_t>> cells(kCells * kCells * kCells);
+
+        for(uint32_t t = 0; 3 * t < count; ++t)
+        {
+            int first[3];
+            int last[3];
+
+            for(int k = 0; k < 3; ++k)
+            {
+                const float a = rMesh.vertices[pIndices[3 * t]].position[k];
+                const float b = rMesh.vertices[pIndices[3 * t + 1]].position[k];
+                const float c = rMesh.vertices[pIndices[3 * t + 2]].position[k];
+
+                first[k] = cell(std::min(a, std::min(b, c)), k);
+                last[k]  = cell(std::max(a, std::max(b, c)), k);
+            }
+
+            for(int x = first[0]; x <= last[0]; ++x)
+                for(int y = first[1]; y <= last[1]; ++y)
+                    for(int z = first[2]; z <= last[2]; ++z)
+                        cells[size_t((x * kCells + y) * kCells + z)].push_back(t);
+        }
+
+        std::vector<bool> used(rMesh.vertices.size(), false);
+
+        for(const uint32_t& index : rMesh.indices)
+        {
+            used[index] = true;
+        }
+
+        std::vector<size_t> visited(count / 3, 0);
+        size_t              stamp = 0;
+        double              worst = 0.0;
+
+        for(size_t v = 0; v < rMesh.vertices.size(); ++v)
+        {
+            if(!used[v])
+            {
+                continue;
+            }
+
+            const float* p = rMesh.vertices[v].position;
+            const int    c[3] = {cell(p[0], 0), cell(p[1], 1), cell(p[2], 2)};
+
+            double nearest = 1.0e300;
+
+            stamp++;
+
+            // Shell r only holds triangles at least (r - 1) cells away
+            for(int r = 0; r < kCells; ++r)
+            {
+                const double reach = double(r - 1) * size / kCells;
+
+                if((r > 1) && (reach * reach > nearest))
+                {
+                    break;
+                }
+
+                for(int x = c[0] - r; x <= c[0] + r; ++x)
+                    for(int y = c[1] - r; y <= c[1] + r; ++y)
+                        for(int z = c[2] - r; z <= c[2] + r; ++z)
+                        {
+                            const bool inside = (x >= 0) && (y >= 0) && (z >= 0) && (x < kCells) && (y < kCells) && (z < kCells);
+                            const int  shell  = std::max(std::abs(x - c[0]), std::max(std::abs(y - c[1]), std::abs(z - c[2])));
+
+                            if(!inside || (shell != r))
+                            {
+                                continue;
+                            }
+
+                            for(const uint32_t& t : cells[size_t((x * kCells + y) * kCells + z)])
+                            {
+                                if(visited[t] != stamp)
+                                {
+                                    visited[t] = stamp;
+
+                                    nearest = std::min(nearest, distanceSquared(p, rMesh.vertices[pIndices[3 * t]].position,
+                                                                                   rMesh.vertices[pIndices[3 * t + 1]].position,
+                                                                                   rMesh.vertices[pIndices[3 * t + 2]].position));
+                                }
+                            }
+                        }
+            }
+
+            worst = std::max(worst, nearest);
+        }
+
+        return float(std::sqrt(worst));
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 3; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+
+    bool check(const Mesh& rMesh, Threads::WorkStealingPool& rPool)
+    {
+        const Source input = source(rMesh);
+
+        Chain pooled;
+        Chain serial;
+
+        const double pooledTime = milliseconds([&] { pooled = buildChain(input, &rPool); });
+        const double serialTime = milliseconds([&] { serial = buildChain(input); });
+
+        bool identical = (pooled.indices == serial.indices) && (pooled.levels.size() == serial.levels.size());
+
+        for(size_t l = 0; identical && (l < pooled.levels.size()); ++l)
+        {
+            identical = (pooled.levels[l].indexCount == serial.levels[l].indexCount) && (pooled.levels[l].error == serial.levels[l].error);
+        }
+
+        const float  size     = extent(rMesh);
+        const size_t openBase = openEdges(rMesh, rMesh.indices.data(), rMesh.indices.size());
+
+        std::printf("%s: %zu vertices, %zu triangles, %zu open edges; chain %.1f ms on the pool, %.1f ms serial, %s\n",
+                    rMesh.name.c_str(), rMesh.vertices.size(), rMesh.indices.size() / 3, openBase,
+                    pooledTime, serialTime, identical ? "identical" : "DIFFERENT");
+
+        bool passed = identical && (pooled.levels.size() > 2) && (!rMesh.isClosed || (openBase == 0));
+
+        for(size_t l = 1; l < pooled.levels.size(); ++l)
+        {
+            const Level&    rLevel   = pooled.levels[l];
+            const uint32_t* pIndices = pooled.indices.data() + rLevel.indexOffset;
+
+            const size_t open     = openEdges(rMesh, pIndices, rLevel.indexCount);
+            const size_t bridging = rMesh.hasWrappedUVs ? bridgingTriangles(rMesh, pIndices, rLevel.indexCount) : 0;
+            const float  measured = deviation(rMesh, pIndices, rLevel.indexCount);
+
+            // Rounding of the scaled positions the simplifier works in
+            const bool bounded = (measured <= rLevel.error + 1.0e-5f * size);
+
+            std::printf("  level %zu: %6zu triangles, error %.4g (%.2f%% of the extent), measured %.4g, %zu open edges, %zu across a UV seam\n",
+                        l, rLevel.indexCount / 3, rLevel.error, 100.0f * rLevel.error / size, measured, open, bridging);
+
+            if(!bounded || (open > openBase) || (bridging != 0))
+            {
+                std::printf("  level %zu %s\n", l, !bounded ? "deviates further than its error" : (open > openBase) ? "opened edges" : "bridges a UV seam");
+
+                passed = false;
+            }
+        }
+
+        return passed;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const char* pTemple = (argc >= 2) ? argv[1] : "../../MetalDeferredLighting/MetalDeferredLighting/Temple.obj";
+
+    std::vector<Mesh> meshes = {sphere(96, 48), torus(160, 48), terrain(120)};
+
+    Mesh temple;
+
+    if(!loadOBJ(pTemple, temple))
+    {
+        std::printf("Couldn't read %s\n", pTemple);
+
+        return 1;
+    }
+
+    meshes.push_back(temple);
+
+    Threads::WorkStealingPool pool;
+
+    std::printf("%zu threads\n", pool.concurrency());
+
+    bool passed = true;
+
+    for(const Mesh& rMesh : meshes)
+    {
+        passed = check(rMesh, pool) && passed;
+    }
+
+    return passed ? 0 : 1;
+}
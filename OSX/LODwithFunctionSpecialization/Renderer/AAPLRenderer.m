@@ -10,6 +10,7 @@ Implementation of renderer class which performs Metal setup and per frame render
 
 #import "AAPLRenderer.h"
 #import "AAPLMesh.h"
+#import "AAPLEnvironmentMap.h"
 #import "AAPLMathUtilities.h"
 
 // Include header shared between C code here, which executes Metal API commands, and .metal files
@@ -23,6 +24,16 @@ static const size_t kAlignedPerViewportUniformsSize = ((sizeof(AAPLUniforms) & ~
 // The 256 byte aligned size of our uniform structure
 static const size_t kAlignedUniformsSize = kAlignedPerViewportUniformsSize * kViewportNumViewports;
 
+// GGX samples per texel when prefiltering the environment map
+static const NSUInteger kSpecularSamples = 128;
+
+// Vertical field of view of the projection, in radians
+static const float kFieldOfView = 65.0f * (M_PI / 180.0f);
+
+// Pixels of simplification error allowed on screen at each quality level when selecting a
+//   geometric level of detail.  Lower quality levels accept coarser geometry
+static const float kMaxPixelError[kQualityNumLevels] = { 0.5f, 1.0f, 2.0f };
+
 // Main class performing the rendering
 @implementation AAPLRenderer
 {
@@ -53,6 +64,12 @@ static const size_t kAlignedUniformsSize = kAlignedPerViewportUniformsSize * kVi
     // Projection matrix calculated as a function of view size
     matrix_float4x4 _projectionMatrix;
 
+    // Height of each viewport in pixels
+    float _viewportHeight;
+
+    // Distance from the camera to the model drawn in each viewport
+    float _viewportDistances[kViewportNumViewports];
+
     // Current rotation of our object in radians
     float _rotation;
 
@@ -299,20 +316,30 @@ static const size_t kAlignedUniformsSize = kAlignedPerViewportUniformsSize * kVi
         NSLog(@"Could not create meshes from model file %@", modelFileURL.absoluteString);
     }
 
+    // The environment is loaded where the CPU can read it, rather than in private storage, then
+    //   prefiltered for GGX specular with a level per roughness the shader picks from
     NSDictionary *textureLoaderOptions =
     @{
-      MTKTextureLoaderOptionTextureUsage       : @(MTLTextureUsageShaderRead),
-      MTKTextureLoaderOptionTextureStorageMode : @(MTLStorageModePrivate)
+      MTKTextureLoaderOptionTextureUsage       : @(MTLTextureUsageShaderRead)
       };
 
     MTKTextureLoader* textureLoader = [[MTKTextureLoader alloc] initWithDevice:_device];
 
-    _irradianceMap = [textureLoader newTextureWithName:@"IrradianceMap" scaleFactor:1.0 bundle:nil options:textureLoaderOptions error:&error];
+    id<MTLTexture> environment = [textureLoader newTextureWithName:@"IrradianceMap" scaleFactor:1.0 bundle:nil options:textureLoaderOptions error:&error];
 
-    if (!_irradianceMap)
+    if (!environment)
     {
         NSLog(@"Could not load IrradianceMap %@", error);
+        return;
     }
+
+    AAPLEnvironmentMap *environmentMap = [[AAPLEnvironmentMap alloc] initWithTexture:environment
+                                                                      specularLevels:environment.mipmapLevelCount
+                                                                     specularSamples:kSpecularSamples
+                                                                         metalDevice:_device];
+
+    // Fall back to the hand filtered mips of the asset
+    _irradianceMap = environmentMap ? environmentMap.specularMap : environment;
 }
 
 - (void)updateDynamicBufferState
@@ -411,6 +438,10 @@ static const size_t kAlignedUniformsSize = kAlignedPerViewportUniformsSize * kVi
     uniformsLeft->modelMatrix = modelMatrixLeft;
     uniformsRight->modelMatrix = modelMatrixRight;
 
+    // Select geometric levels of detail in each viewport from the distance to its model
+    _viewportDistances[kViewportLeft] = vector_distance(cameraTranslation, modelMatrixLeft.columns[3].xyz);
+    _viewportDistances[kViewportRight] = vector_distance(cameraTranslation, modelMatrixRight.columns[3].xyz);
+
     //   The normal matrix is typically the inverse transpose of a 3x3 matrix created from the
     //   upper-left elements in the 4x4 model matrix.  In this case, we don't need to perform the
     //   expensive inverse and transpose operations since this is only required when scaling is
@@ -452,7 +483,9 @@ static const size_t kAlignedUniformsSize = kAlignedPerViewportUniformsSize * kVi
     // When reshape is called, update the aspect ratio and projection matrix since the view
     //   orientation or size has changed
     float aspect = (size.width / kViewportNumViewports) / (float)size.height;
-    _projectionMatrix = matrix_perspective_right_hand(65.0f * (M_PI / 180.0f), aspect, 1.0f, 5000.0);
+    _projectionMatrix = matrix_perspective_right_hand(kFieldOfView, aspect, 1.0f, 5000.0);
+
+    _viewportHeight = size.height;
 
 }
 
@@ -570,11 +603,29 @@ static const size_t kAlignedUniformsSize = kAlignedPerViewportUniformsSize * kVi
                                               offset:_uniformBufferOffset + viewPort * kAlignedPerViewportUniformsSize
                                              atIndex:kBufferIndexUniforms];
 
-                    [renderEncoder drawIndexedPrimitives:metalKitSubmesh.primitiveType
-                                              indexCount:metalKitSubmesh.indexCount
-                                               indexType:metalKitSubmesh.indexType
-                                             indexBuffer:metalKitSubmesh.indexBuffer.buffer
-                                       indexBufferOffset:metalKitSubmesh.indexBuffer.offset];
+                    // Draw the coarsest geometric level whose error stays within the current
+                    //   quality level's pixel budget, or the full submesh if it has no levels
+                    if(submesh.levelIndexBuffer)
+                    {
+                        NSUInteger level = [submesh levelAtDistance:_viewportDistances[viewPort]
+                                                        fieldOfView:kFieldOfView
+                                                     viewportHeight:_viewportHeight
+                                                      maxPixelError:kMaxPixelError[_currentQualityLevel]];
+
+                        [renderEncoder drawIndexedPrimitives:metalKitSubmesh.primitiveType
+                                                  indexCount:[submesh indexCountForLevel:level]
+                                                   indexType:MTLIndexTypeUInt32
+                                                 indexBuffer:submesh.levelIndexBuffer
+                                           indexBufferOffset:[submesh indexBufferOffsetForLevel:level]];
+                    }
+                    else
+                    {
+                        [renderEncoder drawIndexedPrimitives:metalKitSubmesh.primitiveType
+                                                  indexCount:metalKitSubmesh.indexCount
+                                                   indexType:metalKitSubmesh.indexType
+                                                 indexBuffer:metalKitSubmesh.indexBuffer.buffer
+                                           indexBufferOffset:metalKitSubmesh.indexBuffer.offset];
+                    }
                 }
 
             }
@@ -0,0 +1,440 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Batched, pipelined inference scheduler. Requests are coalesced into batches bounded by size and
+ by a deadline, a fixed number of batches is kept in flight on a pluggable backend and per-request
+ latency percentiles are collected. The test set runs through it (MNISTInferenceScheduler.mm),
+ a batch of images sharing a command buffer; LinearClassifier runs the single layer network on the
+ CPU for InferenceSchedulerLoadTest.cpp.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+#include "InferenceScheduler.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace MNIST
+{
+    namespace Inference
+    {
+        // Nearest-rank percentile over an already sorted array
+        static double percentile(const std::vector<float>& rSorted, const double& p)
+        {
+            if(rSorted.empty())
+            {
+                return 0.0;
+            }
+
+            const size_t rank = size_t(std::ceil(p * double(rSorted.size())));
+
+            return rSorted[std::min(rSorted.size(), std::max<size_t>(rank, 1)) - 1];
+        }
+    } // Inference
+} // MNIST
+
+#pragma mark -
+#pragma mark Public - Backends
+
+MNIST::Inference::FunctionBackend::FunctionBackend(const Classifier& classifier, const size_t& workers)
+: m_Classifier(classifier), mbStop(false)
+{
+    const size_t count = std::max<size_t>(workers, 1);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        m_Workers.emplace_back(&FunctionBackend::worker, this);
+    }
+}
+
+MNIST::Inference::FunctionBackend::~FunctionBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        mbStop = true;
+    }
+
+    m_Condition.notify_all();
+
+    for(std::thread& rWorker : m_Workers)
+    {
+        rWorker.join();
+    }
+}
+
+void MNIST::Inference::FunctionBackend::encode(Batch& rBatch, std::function<void()> completion)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Jobs.push_back({&rBatch, std::move(completion)});
+    }
+
+    m_Condition.notify_one();
+}
+
+void MNIST::Inference::FunctionBackend::worker()
+{
+    for(;;)
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            m_Condition.wait(lock, [this] { return mbStop || !m_Jobs.empty(); });
+
+            // Jobs still queued on shutdown are executed so every completion fires
+            if(m_Jobs.empty())
+            {
+                return;
+            }
+
+            job = std::move(m_Jobs.front());
+
+            m_Jobs.pop_front();
+        }
+
+        Batch& rBatch = *job.pBatch;
+
+        for(size_t i = 0; i < rBatch.requests.size(); ++i)
+        {
+            rBatch.labels[i] = m_Classifier(rBatch.requests[i].pixels);
+        }
+
+        job.completion();
+    }
+}
+
+bool MNIST::Inference::LinearClassifier::load(const char* pWeightsPath, const char* pBiasPath)
+{
+    std::vector<float> weights(kPixels * kLabels);
+    std::vector<float> bias(kLabels);
+
+    const std::pair<const char*, std::vector<float>*> files[2] = {{pWeightsPath, &weights}, {pBiasPath, &bias}};
+
+    for(const auto& rFile : files)
+    {
+        std::FILE* pFile = std::fopen(rFile.first, "rb");
+
+        if(pFile == nullptr)
+        {
+            return false;
+        }
+
+        const size_t count = std::fread(rFile.second->data(), sizeof(float), rFile.second->size(), pFile);
+
+        std::fclose(pFile);
+
+        if(count != rFile.second->size())
+        {
+            return false;
+        }
+    }
+
+    m_Weights.swap(weights);
+    m_Bias.swap(bias);
+
+    return true;
+}
+
+bool MNIST::Inference::LinearClassifier::isLoaded() const
+{
+    return !m_Weights.empty();
+}
+
+uint32_t MNIST::Inference::LinearClassifier::operator()(const uint8_t* pPixels) const
+{
+    if(!isLoaded())
+    {
+        return kInvalidLabel;
+    }
+
+    float input[kPixels];
+
+    for(size_t i = 0; i < kPixels; ++i)
+    {
+        input[i] = float(pPixels[i]) * (1.0f / 255.0f);
+    }
+
+    uint32_t label = kInvalidLabel;
+    float    best  = -FLT_MAX;
+
+    for(size_t l = 0; l < kLabels; ++l)
+    {
+        const float* pWeights = &m_Weights[l * kPixels];
+
+        float output = m_Bias[l];
+
+        for(size_t i = 0; i < kPixels; ++i)
+        {
+            output += pWeights[i] * input[i];
+        }
+
+        if(output > best)
+        {
+            best  = output;
+            label = uint32_t(l);
+        }
+    }
+
+    return label;
+}
+
+#pragma mark -
+#pragma mark Public - Scheduler
+
+MNIST::Inference::Config MNIST::Inference::defaults()
+{
+    Config config;
+
+    config.maxBatchSize  = 32;
+    config.maxBatchDelay = std::chrono::microseconds(2000);
+    config.maxInFlight   = 3;
+    config.queueCapacity = 1024;
+
+    return config;
+}
+
+MNIST::Inference::Scheduler::Scheduler(Backend& rBackend,
+                                       const Config& config,
+                                       const Completion& completion)
+: m_Backend(rBackend),
+  m_Config(config),
+  m_Completion(completion),
+  mnInFlight(0),
+  mnSequence(0),
+  mbFlush(false),
+  mbStop(false),
+  mnSubmitted(0),
+  mnCompleted(0),
+  mnBatches(0),
+  m_Correct(0)
+{
+    m_Config.maxBatchSize  = std::max<size_t>(m_Config.maxBatchSize, 1);
+    m_Config.maxInFlight   = std::max<size_t>(m_Config.maxInFlight, 1);
+    m_Config.queueCapacity = std::max(m_Config.queueCapacity, m_Config.maxBatchSize);
+
+    m_Dispatcher = std::thread(&Scheduler::dispatch, this);
+}
+
+MNIST::Inference::Scheduler::~Scheduler()
+{
+    drain();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        mbStop = true;
+    }
+
+    m_Pending.notify_all();
+    m_Dispatcher.join();
+}
+
+void MNIST::Inference::Scheduler::enqueue(const uint64_t& id, const uint8_t* pPixels, const uint32_t& correctLabel)
+{
+    const clock::time_point now = clock::now();
+
+    if(mnSubmitted == 0)
+    {
+        m_Start = now;
+    }
+
+    m_Queue.push_back({id, pPixels, correctLabel, now});
+
+    mnSubmitted++;
+
+    // Only wake the dispatcher when it has something new to decide on
+    if((m_Queue.size() == 1) || (m_Queue.size() >= m_Config.maxBatchSize))
+    {
+        m_Pending.notify_one();
+    }
+}
+
+void MNIST::Inference::Scheduler::submit(const uint64_t& id, const uint8_t* pPixels, const uint32_t& correctLabel)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    m_Space.wait(lock, [this] { return m_Queue.size() < m_Config.queueCapacity; });
+
+    enqueue(id, pPixels, correctLabel);
+}
+
+bool MNIST::Inference::Scheduler::trySubmit(const uint64_t& id, const uint8_t* pPixels, const uint32_t& correctLabel)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if(m_Queue.size() >= m_Config.queueCapacity)
+    {
+        return false;
+    }
+
+    enqueue(id, pPixels, correctLabel);
+
+    return true;
+}
+
+void MNIST::Inference::Scheduler::dispatch()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    for(;;)
+    {
+        m_Pending.wait(lock, [this] { return mbStop || !m_Queue.empty(); });
+
+        if(m_Queue.empty())
+        {
+            return;
+        }
+
+        // Let the batch fill up until the oldest request reaches its deadline
+        const clock::time_point deadline = m_Queue.front().submitted + m_Config.maxBatchDelay;
+
+        m_Pending.wait_until(lock, deadline, [this] {
+            return mbStop || mbFlush || (m_Queue.size() >= m_Config.maxBatchSize);
+        });
+
+        // Back-pressure: never more than maxInFlight batches on the backend
+        m_Slots.wait(lock, [this] { return mnInFlight < m_Config.maxInFlight; });
+
+        const size_t count = std::min(m_Queue.size(), m_Config.maxBatchSize);
+
+        Batch* pBatch = new Batch;
+
+        pBatch->sequence = mnSequence++;
+        pBatch->requests.assign(m_Queue.begin(), m_Queue.begin() + count);
+        pBatch->labels.assign(count, kInvalidLabel);
+
+        m_Queue.erase(m_Queue.begin(), m_Queue.begin() + count);
+
+        mnInFlight++;
+        mnBatches++;
+
+        lock.unlock();
+
+        m_Space.notify_all();
+
+        m_Backend.encode(*pBatch, [this, pBatch] { complete(pBatch); });
+
+        lock.lock();
+    }
+}
+
+void MNIST::Inference::Scheduler::complete(Batch* pBatch)
+{
+    const clock::time_point now = clock::now();
+
+    std::vector<float> latencies(pBatch->requests.size());
+
+    uint64_t correct = 0;
+
+    for(size_t i = 0; i < pBatch->requests.size(); ++i)
+    {
+        const Request& rRequest = pBatch->requests[i];
+
+        const std::chrono::duration<float, std::milli> latency = now - rRequest.submitted;
+
+        latencies[i] = latency.count();
+
+        if((rRequest.correctLabel != kUnknownLabel) && (rRequest.correctLabel == pBatch->labels[i]))
+        {
+            correct++;
+        }
+
+        if(m_Completion)
+        {
+            m_Completion(rRequest, pBatch->labels[i]);
+        }
+    }
+
+    const size_t count = pBatch->requests.size();
+
+    delete pBatch;
+
+    m_Correct.fetch_add(correct, std::memory_order_relaxed);
+
+    // Notified under the lock: once mnInFlight drops to zero drain() may return and the
+    // scheduler be destroyed, so nothing of it may be touched after the lock is released
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Latencies.insert(m_Latencies.end(), latencies.begin(), latencies.end());
+
+    mnCompleted += count;
+    mnInFlight--;
+
+    m_Last = now;
+
+    m_Slots.notify_all();
+}
+
+void MNIST::Inference::Scheduler::drain()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    mbFlush = true;
+
+    m_Pending.notify_all();
+
+    m_Slots.wait(lock, [this] { return m_Queue.empty() && (mnInFlight == 0); });
+
+    mbFlush = false;
+}
+
+void MNIST::Inference::Scheduler::reset()
+{
+    drain();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    mnSubmitted = 0;
+    mnCompleted = 0;
+    mnBatches   = 0;
+
+    m_Correct.store(0);
+    m_Latencies.clear();
+}
+
+uint64_t MNIST::Inference::Scheduler::correct() const
+{
+    return m_Correct.load();
+}
+
+MNIST::Inference::Stats MNIST::Inference::Scheduler::stats() const
+{
+    std::vector<float> sorted;
+
+    Stats stats;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        sorted = m_Latencies;
+
+        stats.submitted = mnSubmitted;
+        stats.completed = mnCompleted;
+        stats.batches   = mnBatches;
+
+        const std::chrono::duration<double> elapsed = m_Last - m_Start;
+
+        stats.throughput = ((mnCompleted > 0) && (elapsed.count() > 0.0)) ? double(mnCompleted) / elapsed.count() : 0.0;
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+
+    stats.correct       = m_Correct.load();
+    stats.meanBatchSize = (stats.batches > 0) ? double(stats.completed) / double(stats.batches) : 0.0;
+    stats.p50           = percentile(sorted, 0.50);
+    stats.p90           = percentile(sorted, 0.90);
+    stats.p99           = percentile(sorted, 0.99);
+    stats.max           = sorted.empty() ? 0.0 : sorted.back();
+
+    return stats;
+}
@@ -0,0 +1,214 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Batched, pipelined inference scheduler. Requests are coalesced into batches bounded by size and
+ by a deadline, a fixed number of batches is kept in flight on a pluggable backend and per-request
+ latency percentiles are collected. The test set runs through it (MNISTInferenceScheduler.mm),
+ a batch of images sharing a command buffer; LinearClassifier runs the single layer network on the
+ CPU for InferenceSchedulerLoadTest.cpp.
+ */
+
+#ifndef _MNIST_INFERENCE_SCHEDULER_H_
+#define _MNIST_INFERENCE_SCHEDULER_H_
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MNIST
+{
+    namespace Inference
+    {
+        typedef std::chrono::steady_clock clock;
+
+        // Label used for requests the backend did not classify
+        static const uint32_t kInvalidLabel = 99;
+
+        // Label used for requests without a known correct answer
+        static const uint32_t kUnknownLabel = 10;
+
+        // Single image to classify
+        struct Request
+        {
+            uint64_t          id;             // Caller defined identifier, e.g. index in the test set
+            const uint8_t*    pixels;         // Input image, must stay alive until completion
+            uint32_t          correctLabel;   // Expected label or kUnknownLabel
+            clock::time_point submitted;      // Filled in by the scheduler
+        };
+
+        // Batch handed to the backend. The backend writes one label per request.
+        struct Batch
+        {
+            uint64_t              sequence;
+            std::vector<Request>  requests;
+            std::vector<uint32_t> labels;
+        };
+
+        // Execution backend. encode() may complete synchronously or later on any thread
+        // (e.g. from a command buffer completion handler), but must call completion exactly once.
+        class Backend
+        {
+        public:
+            virtual ~Backend() {}
+
+            virtual void encode(Batch& rBatch, std::function<void()> completion) = 0;
+        };
+
+        // Backend that runs a classifier function on its own worker threads. Used for
+        // the CPU inference path and for load testing the scheduler without a GPU
+        // (InferenceSchedulerLoadTest.cpp).
+        class FunctionBackend : public Backend
+        {
+        public:
+            typedef std::function<uint32_t(const uint8_t* pixels)> Classifier;
+
+            FunctionBackend(const Classifier& classifier, const size_t& workers = 1);
+
+            virtual ~FunctionBackend();
+
+            virtual void encode(Batch& rBatch, std::function<void()> completion);
+
+        private:
+            struct Job
+            {
+                Batch*                pBatch;
+                std::function<void()> completion;
+            };
+
+            void worker();
+
+            Classifier               m_Classifier;
+            std::mutex               m_Mutex;
+            std::condition_variable  m_Condition;
+            std::deque<Job>          m_Jobs;
+            std::vector<std::thread> m_Workers;
+            bool                     mbStop;
+        }; // FunctionBackend
+
+        // CPU inference for the single layer network of MNISTSingleLayer.swift: the fully connected
+        // layer over the 28x28 unorm8 image, then the largest output, as softmax keeps the order.
+        // Usable as a FunctionBackend classifier.
+        class LinearClassifier
+        {
+        public:
+            static const size_t kPixels = 28 * 28;
+            static const size_t kLabels = 10;
+
+            // weights_NN.dat and bias_NN.dat, the floats SlimMPSCNNFullyConnected maps: the weights
+            // label by label in rows of pixels, then one bias per label
+            bool load(const char* pWeightsPath, const char* pBiasPath);
+
+            bool isLoaded() const;
+
+            uint32_t operator()(const uint8_t* pPixels) const;
+
+        private:
+            std::vector<float> m_Weights;
+            std::vector<float> m_Bias;
+        }; // LinearClassifier
+
+        struct Config
+        {
+            size_t                    maxBatchSize;   // Requests coalesced into one batch at most
+            std::chrono::microseconds maxBatchDelay;  // Oldest request never waits longer than this for a batch to fill
+            size_t                    maxInFlight;    // Batches encoded on the backend at the same time
+            size_t                    queueCapacity;  // Pending requests before submit() blocks
+        };
+
+        // Default configuration: batches of 32, 2 ms deadline, triple buffering
+        Config defaults();
+
+        // Snapshot of scheduler statistics
+        struct Stats
+        {
+            uint64_t submitted;
+            uint64_t completed;
+            uint64_t correct;
+            uint64_t batches;
+            double   meanBatchSize;
+            double   p50;       // Latency percentiles in milliseconds from submit to completion
+            double   p90;
+            double   p99;
+            double   max;
+            double   throughput; // Completed requests per second since the first submit
+        };
+
+        class Scheduler
+        {
+        public:
+            // Called for every request once its label is known, on a backend thread
+            typedef std::function<void(const Request& rRequest, const uint32_t& label)> Completion;
+
+            Scheduler(Backend& rBackend,
+                      const Config& config = defaults(),
+                      const Completion& completion = Completion());
+
+            // Flushes pending work and joins the dispatch thread
+            virtual ~Scheduler();
+
+            Scheduler(const Scheduler&) = delete;
+            Scheduler& operator=(const Scheduler&) = delete;
+
+            // Enqueue a request, blocking while the pending queue is full (back-pressure)
+            void submit(const uint64_t& id, const uint8_t* pPixels, const uint32_t& correctLabel = kUnknownLabel);
+
+            // Enqueue a request, returns false instead of blocking when the queue is full
+            bool trySubmit(const uint64_t& id, const uint8_t* pPixels, const uint32_t& correctLabel = kUnknownLabel);
+
+            // Dispatch partially filled batches immediately and wait until all requests completed
+            void drain();
+
+            // Reset counters and latency samples
+            void reset();
+
+            // Number of correctly classified requests
+            uint64_t correct() const;
+
+            Stats stats() const;
+
+        private:
+            void enqueue(const uint64_t& id, const uint8_t* pPixels, const uint32_t& correctLabel);
+            void dispatch();
+            void complete(Batch* pBatch);
+
+            Backend&                  m_Backend;
+            Config                    m_Config;
+            Completion                m_Completion;
+
+            mutable std::mutex        m_Mutex;
+            std::condition_variable   m_Pending;    // Signalled when requests arrive or a flush is asked
+            std::condition_variable   m_Space;      // Signalled when the pending queue shrinks
+            std::condition_variable   m_Slots;      // Signalled when an in-flight batch completes
+            std::deque<Request>       m_Queue;
+            size_t                    mnInFlight;
+            uint64_t                  mnSequence;
+            bool                      mbFlush;
+            bool                      mbStop;
+
+            uint64_t                  mnSubmitted;
+            uint64_t                  mnCompleted;
+            uint64_t                  mnBatches;
+            std::atomic<uint64_t>     m_Correct;
+            clock::time_point         m_Start;
+            clock::time_point         m_Last;
+            std::vector<float>        m_Latencies;  // Milliseconds, one per completed request
+
+            std::thread               m_Dispatcher;
+        }; // Scheduler
+    } // Inference
+} // MNIST
+
+#endif
+
+#endif
@@ -0,0 +1,323 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Load test for the inference scheduler, a standalone program that is not part of the app target.
+ It checks that every request completes and that schedulers can be destroyed while batches finish
+ on other threads, then measures throughput and latency percentiles over batch sizes and in-flight
+ limits, on the CPU classifier and on a simulated command queue with a fixed cost per command
+ buffer, which is what one command buffer per image paid before.
+
+     c++ -std=c++11 -O2 -pthread InferenceScheduler.cpp InferenceSchedulerLoadTest.cpp -o loadtest
+     ./loadtest single_layer_weights/weights_NN.dat single_layer_weights/bias_NN.dat \
+                [t10k-images-idx3-ubyte.data mnistData/t10k-labels-idx1-ubyte.data]
+
+ Without the weights the CPU runs use a synthetic classifier, without the test set images random ones.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "InferenceScheduler.h"
+
+using namespace MNIST::Inference;
+
+namespace
+{
+    // One command queue: batches run in submission order, each paying a fixed cost plus a cost per image
+    class SimulatedQueue : public Backend
+    {
+    public:
+        SimulatedQueue(const std::chrono::microseconds& perBatch, const std::chrono::microseconds& perImage)
+        : m_PerBatch(perBatch), m_PerImage(perImage), m_Backend([](const uint8_t* pPixels) { return uint32_t(pPixels[0] % 10); }, 1)
+        {
+        }
+
+        virtual void encode(Batch& rBatch, std::function<void()> completion)
+        {
+            const std::chrono::microseconds cost = m_PerBatch + m_PerImage * int64_t(rBatch.requests.size());
+
+            m_Backend.encode(rBatch, [cost, completion] {
+                std::this_thread::sleep_for(cost);
+
+                completion();
+            });
+        }
+
+    private:
+        std::chrono::microseconds m_PerBatch;
+        std::chrono::microseconds m_PerImage;
+        FunctionBackend           m_Backend;
+    }; // SimulatedQueue
+
+    struct TestSet
+    {
+        std::vector<uint8_t> images;
+        std::vector<uint8_t> labels;
+        size_t               count;
+    };
+
+    bool readFile(const char* pPath, const size_t& header, std::vector<uint8_t>& rData)
+    {
+        std::FILE* pFile = std::fopen(pPath, "rb");
+
+        if(pFile == nullptr)
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> data;
+        uint8_t              buffer[65536];
+        size_t               size;
+
+        while((size = std::fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        {
+            data.insert(data.end(), buffer, buffer + size);
+        }
+
+        std::fclose(pFile);
+
+        if(data.size() <= header)
+        {
+            return false;
+        }
+
+        rData.assign(data.begin() + header, data.end());
+
+        return true;
+    }
+
+    TestSet testSet(const char* pImages, const char* pLabels)
+    {
+        TestSet set;
+
+        if(pImages && pLabels && readFile(pImages, 16, set.images) && readFile(pLabels, 8, set.labels))
+        {
+            set.count = std::min(set.images.size() / LinearClassifier::kPixels, set.labels.size());
+
+            return set;
+        }
+
+        // Random images, labels unknown
+        std::mt19937 random(1);
+
+        set.count = 10000;
+        set.images.resize(set.count * LinearClassifier::kPixels);
+        set.labels.assign(set.count, uint8_t(kUnknownLabel));
+
+        for(uint8_t& rPixel : set.images)
+        {
+            rPixel = uint8_t(random() & 0xff);
+        }
+
+        return set;
+    }
+
+    Stats run(Backend& rBackend, const Config& config, const TestSet& set, const size_t& passes)
+    {
+        Scheduler scheduler(rBackend, config);
+
+        for(size_t pass = 0; pass < passes; ++pass)
+        {
+            for(size_t i = 0; i < set.count; ++i)
+            {
+                scheduler.submit(i, &set.images[i * LinearClassifier::kPixels], set.labels[i]);
+            }
+        }
+
+        scheduler.drain();
+
+        return scheduler.stats();
+    }
+
+    void print(const char* pName, const Config& config, const Stats& stats)
+    {
+        std::printf("%-10s batch %3zu in flight %zu: %8.0f images/s, mean batch %6.1f, p50 %7.3f ms, p90 %7.3f ms, p99 %7.3f ms, max %7.3f ms",
+                    pName, config.maxBatchSize, config.maxInFlight, stats.throughput, stats.meanBatchSize,
+                    stats.p50, stats.p90, stats.p99, stats.max);
+
+        if(stats.correct > 0)
+        {
+            std::printf(", accuracy %.2f%%", 100.0 * double(stats.correct) / double(stats.completed));
+        }
+
+        std::printf("\n");
+    }
+
+    // Every request completes once, with the label the backend gave it
+    bool checkCompletion()
+    {
+        const size_t count = 20000;
+
+        std::vector<uint8_t>  pixels(count);
+        std::vector<uint32_t> seen(count, 0);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            pixels[i] = uint8_t(i);
+        }
+
+        FunctionBackend backend([](const uint8_t* pPixels) { return uint32_t(*pPixels % 10); }, 3);
+
+        std::mutex mutex;
+        bool       labelled = true;
+
+        Config config = defaults();
+
+        config.queueCapacity = 64;
+
+        {
+            Scheduler scheduler(backend, config, [&](const Request& rRequest, const uint32_t& label) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                seen[rRequest.id]++;
+                labelled = labelled && (label == *rRequest.pixels % 10);
+            });
+
+            uint64_t expected = 0;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const uint32_t correctLabel = (i % 3 == 0) ? uint32_t(i % 10) : 0;
+
+                expected += (correctLabel == pixels[i] % 10) ? 1 : 0;
+
+                scheduler.submit(i, &pixels[i], correctLabel);
+            }
+
+            scheduler.drain();
+
+            const Stats stats = scheduler.stats();
+
+            if((stats.completed != count) || (stats.correct != expected) || (scheduler.correct() != expected))
+            {
+                std::printf("completion: %llu of %zu completed, %llu correct, %llu expected\n",
+                            (unsigned long long)stats.completed, count, (unsigned long long)stats.correct, (unsigned long long)expected);
+
+                return false;
+            }
+        }
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            if(seen[i] != 1)
+            {
+                std::printf("completion: request %zu completed %u times\n", i, seen[i]);
+
+                return false;
+            }
+        }
+
+        if(!labelled)
+        {
+            std::printf("completion: a request got another request's label\n");
+
+            return false;
+        }
+
+        std::printf("completion: %zu requests completed once each\n", count);
+
+        return true;
+    }
+
+    // Schedulers destroyed right after their last batch completes on a backend thread; run under
+    // ThreadSanitizer or AddressSanitizer to catch a completion touching a destroyed scheduler
+    bool checkDestruction()
+    {
+        const size_t rounds = 2000;
+
+        uint8_t pixel = 0;
+
+        FunctionBackend backend([](const uint8_t*) { return 0u; }, 4);
+
+        Config config = defaults();
+
+        config.maxBatchSize  = 2;
+        config.maxBatchDelay = std::chrono::microseconds(0);
+        config.maxInFlight   = 4;
+
+        for(size_t round = 0; round < rounds; ++round)
+        {
+            Scheduler scheduler(backend, config);
+
+            for(size_t i = 0; i < 1 + (round % 7); ++i)
+            {
+                scheduler.submit(i, &pixel, 0);
+            }
+        }
+
+        std::printf("destruction: %zu schedulers destroyed with batches completing\n", rounds);
+
+        return true;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    if(!checkCompletion() || !checkDestruction())
+    {
+        return 1;
+    }
+
+    LinearClassifier classifier;
+
+    if((argc >= 3) && !classifier.load(argv[1], argv[2]))
+    {
+        std::printf("Couldn't read the weights from %s and %s\n", argv[1], argv[2]);
+
+        return 1;
+    }
+
+    const TestSet set = testSet((argc >= 5) ? argv[3] : nullptr, (argc >= 5) ? argv[4] : nullptr);
+
+    FunctionBackend::Classifier classify = [&classifier](const uint8_t* pPixels) { return classifier(pPixels); };
+
+    if(!classifier.isLoaded())
+    {
+        // Roughly the cost of the linear classifier
+        classify = [](const uint8_t* pPixels) {
+            uint32_t sum = 0;
+
+            for(size_t i = 0; i < LinearClassifier::kPixels * 10; ++i)
+            {
+                sum += pPixels[i % LinearClassifier::kPixels] * uint32_t(i);
+            }
+
+            return sum % 10;
+        };
+    }
+
+    const size_t sizes[]    = {1, 8, 32, 128};
+    const size_t inFlight[] = {1, 3};
+
+    for(const size_t& flight : inFlight)
+    {
+        FunctionBackend backend(classify, flight);
+
+        for(const size_t& size : sizes)
+        {
+            Config config = defaults();
+
+            config.maxBatchSize = size;
+            config.maxInFlight  = flight;
+
+            print("cpu", config, run(backend, config, set, 3));
+        }
+    }
+
+    // 50 us per command buffer and 2 us per image
+    for(const size_t& size : sizes)
+    {
+        SimulatedQueue queue(std::chrono::microseconds(50), std::chrono::microseconds(2));
+
+        Config config = defaults();
+
+        config.maxBatchSize = size;
+
+        print("simulated", config, run(queue, config, set, 1));
+    }
+
+    return 0;
+}
@@ -90,58 +90,23 @@ class MNIST_Deep_ConvNN: MNIST_Full_LayerNN{
 
 
     /**
-        This function encodes all the layers of the network into given commandBuffer, it calls subroutines for each piece of the network
+        This function encodes all the layers of the network for one image into given commandBuffer
      
         - Parameters:
-            - inputImage: Image coming in on which the network will run
-            - imageNum: If the test set is being used we will get a value between 0 and 9999 for which of the 10,000 images is being evaluated
-            - correctLabel: The correct label for the inputImage while testing
+            - commandBuffer: Command buffer the layers are encoded into
+            - sourceImage: Image coming in on which the network will run
+            - destinationImage: Image the probabilities of each digit are written to
      
         - Returns:
-            Guess of the network as to what the digit is as UInt
+            Void
      */
-    override func forward(inputImage: MPSImage? = nil, imageNum: Int = 9999, correctLabel: UInt = 10) -> UInt{
-        var label = UInt(99)
-
-        // to deliver optimal performance we leave some resources used in MPSCNN to be released at next call of autoreleasepool,
-        // so the user can decide the appropriate time to release this
-        autoreleasepool{
-            // Get command buffer to use in MetalPerformanceShaders.
-            let commandBuffer = commandQueue.makeCommandBuffer()
-
-            // output will be stored in this image
-            let finalLayer = MPSImage(device: commandBuffer.device, imageDescriptor: did)
-            
-            // encode layers to metal commandBuffer
-            if inputImage == nil {
-                conv1.encode(commandBuffer: commandBuffer, sourceImage: srcImage, destinationImage: c1Image)
-            }
-            else{
-                conv1.encode(commandBuffer: commandBuffer, sourceImage: inputImage!, destinationImage: c1Image)
-            }
-            
-            pool.encode   (commandBuffer: commandBuffer, sourceImage: c1Image   , destinationImage: p1Image)
-            conv2.encode  (commandBuffer: commandBuffer, sourceImage: p1Image   , destinationImage: c2Image)
-            pool.encode   (commandBuffer: commandBuffer, sourceImage: c2Image   , destinationImage: p2Image)
-            fc1.encode    (commandBuffer: commandBuffer, sourceImage: p2Image   , destinationImage: fc1Image)
-            fc2.encode    (commandBuffer: commandBuffer, sourceImage: fc1Image  , destinationImage: dstImage)
-            softmax.encode(commandBuffer: commandBuffer, sourceImage: dstImage  , destinationImage: finalLayer)
-            
-            // add a completion handler to get the correct label the moment GPU is done and compare it to the correct output or return it
-            commandBuffer.addCompletedHandler { commandBuffer in
-                label = self.getLabel(finalLayer: finalLayer)
-                if(correctLabel == label){
-                    __atomic_increment()
-                }
-            }
-            
-            // commit commandbuffer to run on GPU and wait for completion
-            commandBuffer.commit()
-            if imageNum == 9999 {
-                commandBuffer.waitUntilCompleted()
-            }
-            
-        }
-        return label
+    override func encode(commandBuffer: MTLCommandBuffer, sourceImage: MPSImage, destinationImage: MPSImage) {
+        conv1.encode  (commandBuffer: commandBuffer, sourceImage: sourceImage, destinationImage: c1Image)
+        pool.encode   (commandBuffer: commandBuffer, sourceImage: c1Image    , destinationImage: p1Image)
+        conv2.encode  (commandBuffer: commandBuffer, sourceImage: p1Image    , destinationImage: c2Image)
+        pool.encode   (commandBuffer: commandBuffer, sourceImage: c2Image    , destinationImage: p2Image)
+        fc1.encode    (commandBuffer: commandBuffer, sourceImage: p2Image    , destinationImage: fc1Image)
+        fc2.encode    (commandBuffer: commandBuffer, sourceImage: fc1Image   , destinationImage: dstImage)
+        softmax.encode(commandBuffer: commandBuffer, sourceImage: dstImage   , destinationImage: destinationImage)
     }
 }
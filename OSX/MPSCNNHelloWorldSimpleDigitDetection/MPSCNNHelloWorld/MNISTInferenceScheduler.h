@@ -0,0 +1,57 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the inference scheduler in InferenceScheduler.h, so the Swift networks can
+ run the test set in batches: the scheduler hands batches of images to an encoder block, which
+ encodes them into one command buffer and completes the batch from its completion handler.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Images the scheduler coalesced into one batch
+@interface MNISTInferenceBatch : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;
+
+// 28x28 unorm8 pixels of an image, valid until the batch is completed
+- (const uint8_t *)pixelsAtIndex:(NSUInteger)index;
+
+- (void)setLabel:(NSUInteger)label atIndex:(NSUInteger)index;
+
+// Call once, from any thread, when every label is set
+- (void)complete;
+
+@end
+
+typedef void (^MNISTBatchEncoder)(MNISTInferenceBatch *batch);
+
+@interface MNISTInferenceScheduler : NSObject
+
+// Called on the scheduler's dispatch thread, at most maxInFlight batches outstanding
+- (instancetype)initWithBatchSize:(NSUInteger)batchSize
+                    maxBatchDelay:(NSTimeInterval)maxBatchDelay
+                      maxInFlight:(NSUInteger)maxInFlight
+                          encoder:(MNISTBatchEncoder)encoder;
+
+// Blocks while too many images are pending; pixels must stay valid until the image is classified
+- (void)submitImage:(NSUInteger)imageNum pixels:(const uint8_t *)pixels correctLabel:(NSUInteger)correctLabel;
+
+// Encodes partial batches and waits until every submitted image is classified
+- (void)drain;
+
+// Images classified as their correct label since the scheduler was created
+@property (nonatomic, readonly) NSUInteger correct;
+
+// Milliseconds from submission to completion
+@property (nonatomic, readonly) double latencyP50;
+@property (nonatomic, readonly) double latencyP99;
+
+// Images per second
+@property (nonatomic, readonly) double throughput;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,159 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the inference scheduler in InferenceScheduler.h.
+ */
+
+#import "MNISTInferenceScheduler.h"
+
+#import <memory>
+
+#import "InferenceScheduler.h"
+
+@interface MNISTInferenceBatch ()
+
+- (instancetype)initWithBatch:(MNIST::Inference::Batch *)pBatch completion:(std::function<void()>)completion;
+
+@end
+
+@implementation MNISTInferenceBatch
+{
+    MNIST::Inference::Batch *_pBatch;
+    std::function<void()>    _completion;
+}
+
+- (instancetype)initWithBatch:(MNIST::Inference::Batch *)pBatch completion:(std::function<void()>)completion
+{
+    self = [super init];
+
+    if(self)
+    {
+        _pBatch     = pBatch;
+        _completion = std::move(completion);
+    }
+
+    return self;
+}
+
+- (NSUInteger)count
+{
+    return _pBatch->requests.size();
+}
+
+- (const uint8_t *)pixelsAtIndex:(NSUInteger)index
+{
+    return _pBatch->requests[index].pixels;
+}
+
+- (void)setLabel:(NSUInteger)label atIndex:(NSUInteger)index
+{
+    _pBatch->labels[index] = uint32_t(label);
+}
+
+- (void)complete
+{
+    // The scheduler frees the batch in the completion
+    std::function<void()> completion;
+
+    completion.swap(_completion);
+
+    _pBatch = nullptr;
+
+    if(completion)
+    {
+        completion();
+    }
+}
+
+@end
+
+namespace
+{
+    // Hands every batch to the Swift encoder
+    class BlockBackend : public MNIST::Inference::Backend
+    {
+    public:
+        BlockBackend(MNISTBatchEncoder encoder)
+        : m_Encoder(encoder)
+        {
+        }
+
+        virtual void encode(MNIST::Inference::Batch& rBatch, std::function<void()> completion)
+        {
+            @autoreleasepool
+            {
+                m_Encoder([[MNISTInferenceBatch alloc] initWithBatch:&rBatch completion:std::move(completion)]);
+            }
+        }
+
+    private:
+        MNISTBatchEncoder m_Encoder;
+    }; // BlockBackend
+} // unnamed
+
+@implementation MNISTInferenceScheduler
+{
+    std::unique_ptr<BlockBackend>                m_pBackend;
+    std::unique_ptr<MNIST::Inference::Scheduler> m_pScheduler;
+}
+
+- (instancetype)initWithBatchSize:(NSUInteger)batchSize
+                    maxBatchDelay:(NSTimeInterval)maxBatchDelay
+                      maxInFlight:(NSUInteger)maxInFlight
+                          encoder:(MNISTBatchEncoder)encoder
+{
+    self = [super init];
+
+    if(self)
+    {
+        MNIST::Inference::Config config = MNIST::Inference::defaults();
+
+        config.maxBatchSize  = batchSize;
+        config.maxBatchDelay = std::chrono::microseconds(int64_t(maxBatchDelay * 1.0e6));
+        config.maxInFlight   = maxInFlight;
+
+        m_pBackend.reset(new BlockBackend(encoder));
+        m_pScheduler.reset(new MNIST::Inference::Scheduler(*m_pBackend, config));
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    // The scheduler drains before the backend it encodes on goes away
+    m_pScheduler.reset();
+}
+
+- (void)submitImage:(NSUInteger)imageNum pixels:(const uint8_t *)pixels correctLabel:(NSUInteger)correctLabel
+{
+    m_pScheduler->submit(imageNum, pixels, uint32_t(correctLabel));
+}
+
+- (void)drain
+{
+    m_pScheduler->drain();
+}
+
+- (NSUInteger)correct
+{
+    return NSUInteger(m_pScheduler->correct());
+}
+
+- (double)latencyP50
+{
+    return m_pScheduler->stats().p50;
+}
+
+- (double)latencyP99
+{
+    return m_pScheduler->stats().p99;
+}
+
+- (double)throughput
+{
+    return m_pScheduler->stats().throughput;
+}
+
+@end
@@ -57,17 +57,31 @@ class MNIST_Full_LayerNN{
     }
     
     /**
-        This function encodes all the layers of the network into given commandBuffer, it calls subroutines for each piece of the network
+        This function encodes all the layers of the network for one image into given commandBuffer
+     
+        - Parameters:
+            - commandBuffer: Command buffer the layers are encoded into
+            - sourceImage: Image coming in on which the network will run
+            - destinationImage: Image the probabilities of each digit are written to
+     
+        - Returns:
+            Void
+     */
+    func encode(commandBuffer: MTLCommandBuffer, sourceImage: MPSImage, destinationImage: MPSImage) {
+        layer.encode  (commandBuffer: commandBuffer, sourceImage: sourceImage, destinationImage: dstImage)
+        softmax.encode(commandBuffer: commandBuffer, sourceImage: dstImage   , destinationImage: destinationImage)
+    }
+    
+    /**
+        This function runs the network on srcImage, or on inputImage if one is given, and waits for the GPU
      
         - Parameters:
             - inputImage: Image coming in on which the network will run
-            - imageNum: If the test set is being used we will get a value between 0 and 9999 for which of the 10,000 images is being evaluated
-            - correctLabel: The correct label for the inputImage while testing
      
         - Returns:
             Guess of the network as to what the digit is as UInt
      */
-    func forward(inputImage: MPSImage? = nil, imageNum: Int = 9999, correctLabel: UInt = 10) -> UInt {
+    func forward(inputImage: MPSImage? = nil) -> UInt {
         var label = UInt(99)
 
         // to deliver optimal performance we leave some resources used in MPSCNN to be released at next call of autoreleasepool,
@@ -80,30 +94,59 @@ class MNIST_Full_LayerNN{
             let finalLayer = MPSImage(device: commandBuffer.device, imageDescriptor: did)
             
             // encode layers to metal commandBuffer
-            if inputImage == nil {
-                layer.encode(commandBuffer: commandBuffer, sourceImage: srcImage, destinationImage: dstImage)
-            }
-            else{
-                layer.encode(commandBuffer: commandBuffer, sourceImage: inputImage!, destinationImage: dstImage)
+            encode(commandBuffer: commandBuffer, sourceImage: inputImage ?? srcImage, destinationImage: finalLayer)
+            
+            // commit commandbuffer to run on GPU and wait for completion
+            commandBuffer.commit()
+            commandBuffer.waitUntilCompleted()
+            
+            label = getLabel(finalLayer: finalLayer)
+        }
+        return label
+    }
+    
+    /**
+        This function encodes a batch of test set images handed out by the inference scheduler into one command buffer,
+        sets their labels the moment the GPU is done and completes the batch
+     
+        - Parameters:
+            - batch: Images to classify
+     
+        - Returns:
+            Void
+     */
+    func encode(batch: MNISTInferenceBatch) {
+        autoreleasepool{
+            let commandBuffer = commandQueue.makeCommandBuffer()
+            var finalLayers = [MPSImage]()
+            
+            for i in 0..<batch.count {
+                // put image in source texture (input layer)
+                let inputImage = MPSImage(device: device, imageDescriptor: sid)
+                inputImage.texture.replace(region: MTLRegion(origin: MTLOrigin(x: 0, y: 0, z: 0),
+                                                             size: MTLSize(width: sid.width, height: sid.height, depth: 1)),
+                                           mipmapLevel: 0,
+                                           slice: 0,
+                                           withBytes: batch.pixels(at: i),
+                                           bytesPerRow: sid.width,
+                                           bytesPerImage: 0)
+                
+                // every image of the batch keeps its own output
+                let finalLayer = MPSImage(device: device, imageDescriptor: did)
+                encode(commandBuffer: commandBuffer, sourceImage: inputImage, destinationImage: finalLayer)
+                finalLayers.append(finalLayer)
             }
-            softmax.encode(commandBuffer: commandBuffer, sourceImage: dstImage, destinationImage: finalLayer)
             
-            // add a completion handler to get the correct label the moment GPU is done and compare it to the correct output or return it
+            // read the labels the moment the GPU is done, the scheduler then counts the correct ones
             commandBuffer.addCompletedHandler { commandBuffer in
-                label = self.getLabel(finalLayer: finalLayer)
-                if(correctLabel == label){
-                    __atomic_increment()
+                for (i, finalLayer) in finalLayers.enumerated() {
+                    batch.setLabel(Int(self.getLabel(finalLayer: finalLayer)), at: i)
                 }
-            }
-
-            // commit commandbuffer to run on GPU and wait for completion
-            commandBuffer.commit()
-            if imageNum == 9999 || inputImage == nil {
-                commandBuffer.waitUntilCompleted()
+                batch.complete()
             }
             
+            commandBuffer.commit()
         }
-        return label
     }
     
     /**
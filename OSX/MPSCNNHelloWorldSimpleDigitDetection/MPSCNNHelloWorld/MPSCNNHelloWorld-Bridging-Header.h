@@ -3,12 +3,12 @@
  See LICENSE.txt for this sample’s licensing information
  
  Abstract:
- A bridging header so our swift code can see our atomics in objC
+ A bridging header so our swift code can see the inference scheduler in objC
  */
 
 #ifndef MPSCNNHelloWorld_Bridging_Header_h
 #define MPSCNNHelloWorld_Bridging_Header_h
 
-#import "atomics.h"
+#import "MNISTInferenceScheduler.h"
 
 #endif /* MPSCNNHelloWorld_Bridging_Header_h */
@@ -80,28 +80,35 @@ class ViewController: UIViewController{
     }
 
     @IBAction func tappedTestSet(_ sender: UIButton) {
-        // placeholder to count number of correct detections on the test set
-        var correctDetections = Int32(0)
-        let total = Float(10000)
+        let total = 10000
         accuracyLabel.isHidden = false
-        __atomic_reset()
         
         // validate NeuralNetwork was initialized properly
         assert(runningNet != nil)
+        let network = runningNet!
         
-        for i in 0..<Int(total){
-            inference(imageNum: i, correctLabel: UInt(MNISTdata.labels[i]))
+        // images are coalesced into batches of up to 32 sharing a command buffer, at most three batches on the GPU at once
+        let scheduler = MNISTInferenceScheduler(batchSize: 32, maxBatchDelay: 0.002, maxInFlight: 3) { batch in
+            network.encode(batch: batch)
+        }
+        
+        // the test set images stay mapped as long as MNISTdata lives, past the first 16 bytes of header
+        let images = MNISTdata.hdrW!.assumingMemoryBound(to: UInt8.self) + 16
+        
+        for i in 0..<total{
+            scheduler.submitImage(i, pixels: images + i*mnistInputNumPixels, correctLabel: Int(MNISTdata.labels[i]))
             if i % 100 == 0 {
                 accuracyLabel.text = "\(i/100)% Done"
                 // this command helps update the UI in the loop regularly
                 RunLoop.current.run(mode: RunLoopMode.defaultRunLoopMode, before: Date.distantPast)
             }
         }
-        // display accuracy of the network on the MNIST test set
-        correctDetections = __get_atomic_count()
+        
+        // wait for the last batches and display accuracy of the network on the MNIST test set
+        scheduler.drain()
         
         accuracyLabel.isHidden = false
-        accuracyLabel.text = "Accuracy = \(Float(correctDetections * 100)/total)%"
+        accuracyLabel.text = "Accuracy = \(Float(scheduler.correct * 100)/Float(total))%"
     }
     
     @IBAction func tappedDetectDigit(_ sender: UIButton) {
@@ -126,39 +133,6 @@ class ViewController: UIViewController{
         predictionLabel.text = "\(label)"
         predictionLabel.isHidden = false
     }
-
-    
-    /**
-        This function runs the inference network on the test set
-     
-        - Parameters:
-            - imageNum: If the test set is being used we will get a value between 0 and 9999 for which of the 10,000 images is being evaluated
-            - correctLabel: The correct label for the inputImage while testing
-     
-        - Returns:
-            Void
-     */
-    func inference(imageNum: Int, correctLabel: UInt){
-        // get the correct image pixels from the test set
-        var mnist_input_image = [UInt8]()
-        mnist_input_image += MNISTdata.images[(imageNum*mnistInputNumPixels)..<((imageNum+1)*mnistInputNumPixels)]
-        
-        // create a source image for the network to forward
-        let inputImage = MPSImage(device: device, imageDescriptor: (runningNet?.sid)!)
-        
-        // put image in source texture (input layer)
-        inputImage.texture.replace(region: MTLRegion(origin: MTLOrigin(x: 0, y: 0, z: 0),
-                                             size: MTLSize(width: mnistInputWidth, height: mnistInputHeight, depth: 1)),
-                                             mipmapLevel: 0,
-                                             slice: 0,
-                                             withBytes: mnist_input_image,
-                                             bytesPerRow: mnistInputWidth,
-                                             bytesPerImage: 0)
-        
-        // run the network forward pass
-        _ = runningNet!.forward(inputImage: inputImage, imageNum : imageNum, correctLabel: correctLabel)
-        
-    }
     
 }
 
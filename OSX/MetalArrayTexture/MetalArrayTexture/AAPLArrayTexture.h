@@ -14,7 +14,23 @@
 @property (nonatomic, readonly) uint32_t width;
 @property (nonatomic, readonly) uint32_t height;
 
+// YES while slices from loadSlicesWithContentsOfFiles: are still to be uploaded
+@property (nonatomic, readonly) BOOL loading;
+
 - (instancetype)initWithTextureWidth:(NSUInteger)width textureHeight:(NSUInteger)height arrayLength:(NSUInteger)length device:(id <MTLDevice>)device;
+
+// A mipmapped texture has a full mip chain, which loadSlicesWithContentsOfFiles: fills in
+- (instancetype)initWithTextureWidth:(NSUInteger)width textureHeight:(NSUInteger)height arrayLength:(NSUInteger)length mipmapped:(BOOL)mipmapped device:(id <MTLDevice>)device;
+
+// Decodes and uploads a slice's top level before returning
 - (BOOL)setSlice:(NSUInteger)slice withContentsOfFile:(NSString *)path;
 
+// Starts decoding the files into slices 0 up, along with their mips, on worker threads.  Returns
+// NO if a load is already underway
+- (BOOL)loadSlicesWithContentsOfFiles:(NSArray<NSString *> *)paths;
+
+// Uploads the slices that have finished decoding since the last call and returns how many, so
+// rendering can start before every slice is in.  Call once a frame from the render thread
+- (NSUInteger)uploadCompletedSlices;
+
 @end
@@ -12,28 +12,195 @@
 #import <AppKit/AppKit.h>
 #endif
 
+#import <ImageIO/ImageIO.h>
+
+#import <cstring>
+#import <memory>
+
 #import "AAPLArrayTexture.h"
+#import "AAPLArrayTextureBuilder.h"
+#import "WorkStealingPool.h"
+
+// Slices decoded or waiting for upload at a time
+static const size_t kStagingBuffers = 8;
+
+static Threads::WorkStealingPool & decodingPool()
+{
+    static Threads::WorkStealingPool pool;
+    
+    return pool;
+}
+
+// Take a CGImage's pixels as they are when the builder can convert their layout
+static bool copyImage(CGImageRef pImage, AAPL::ArrayTexture::Image &rImage)
+{
+    if(CGImageGetBitsPerComponent(pImage) != 8 ||
+       CGColorSpaceGetModel(CGImageGetColorSpace(pImage)) != kCGColorSpaceModelRGB)
+    {
+        return false;
+    }
+    
+    const CGImageAlphaInfo alpha     = CGImageGetAlphaInfo(pImage);
+    const CGBitmapInfo     byteOrder = CGImageGetBitmapInfo(pImage) & kCGBitmapByteOrderMask;
+    const bool             little    = (byteOrder == kCGBitmapByteOrder32Little);
+    const bool             big       = (byteOrder == kCGBitmapByteOrderDefault) || (byteOrder == kCGBitmapByteOrder32Big);
+    
+    switch(CGImageGetBitsPerPixel(pImage))
+    {
+        case 32:
+            if(big && alpha == kCGImageAlphaPremultipliedLast)
+            {
+                rImage.format = AAPL::ArrayTexture::eFormatRGBA8;
+            }
+            else if(big && alpha == kCGImageAlphaNoneSkipLast)
+            {
+                rImage.format = AAPL::ArrayTexture::eFormatRGBX8;
+            }
+            else if(little && alpha == kCGImageAlphaPremultipliedFirst)
+            {
+                rImage.format = AAPL::ArrayTexture::eFormatBGRA8;
+            }
+            else if(little && alpha == kCGImageAlphaNoneSkipFirst)
+            {
+                rImage.format = AAPL::ArrayTexture::eFormatBGRX8;
+            }
+            else
+            {
+                return false;
+            }
+            break;
+            
+        case 24:
+            if(byteOrder != kCGBitmapByteOrderDefault || alpha != kCGImageAlphaNone)
+            {
+                return false;
+            }
+            
+            rImage.format = AAPL::ArrayTexture::eFormatRGB8;
+            break;
+            
+        default:
+            return false;
+    }
+    
+    CFDataRef pData = CGDataProviderCopyData(CGImageGetDataProvider(pImage));
+    
+    if(!pData)
+    {
+        return false;
+    }
+    
+    const UInt8 *pBytes = CFDataGetBytePtr(pData);
+    
+    rImage.width       = (uint32_t)CGImageGetWidth(pImage);
+    rImage.height      = (uint32_t)CGImageGetHeight(pImage);
+    rImage.bytesPerRow = CGImageGetBytesPerRow(pImage);
+    
+    rImage.pixels.assign(pBytes, pBytes + CFDataGetLength(pData));
+    
+    CFRelease(pData);
+    
+    return true;
+}
+
+// Anything else is drawn at the slice's size, as setSlice:withContentsOfFile: does
+static bool drawImage(CGImageRef pImage, const uint32_t width, const uint32_t height, AAPL::ArrayTexture::Image &rImage)
+{
+    CGColorSpaceRef pColorSpace = CGColorSpaceCreateDeviceRGB();
+    
+    if(!pColorSpace)
+    {
+        return false;
+    }
+    
+    rImage.width       = width;
+    rImage.height      = height;
+    rImage.bytesPerRow = width * 4;
+    rImage.format      = AAPL::ArrayTexture::eFormatRGBA8;
+    
+    rImage.pixels.assign(rImage.bytesPerRow * height, 0);
+    
+    CGContextRef pContext = CGBitmapContextCreate(rImage.pixels.data(),
+                                                  width,
+                                                  height,
+                                                  8,
+                                                  rImage.bytesPerRow,
+                                                  pColorSpace,
+                                                  CGBitmapInfo(kCGImageAlphaPremultipliedLast));
+    
+    CGColorSpaceRelease(pColorSpace);
+    
+    if(!pContext)
+    {
+        return false;
+    }
+    
+    CGContextDrawImage(pContext, CGRectMake(0.0f, 0.0f, width, height), pImage);
+    
+    CGContextRelease(pContext);
+    
+    return true;
+}
+
+// Runs on the decoding pool's threads; ImageIO and bitmap contexts are safe to use from any thread
+static bool decodeImage(NSString *path, const uint32_t width, const uint32_t height, AAPL::ArrayTexture::Image &rImage)
+{
+    @autoreleasepool
+    {
+        CGImageSourceRef pSource = CGImageSourceCreateWithURL((__bridge CFURLRef)[NSURL fileURLWithPath:path], NULL);
+        
+        if(!pSource)
+        {
+            return false;
+        }
+        
+        CGImageRef pImage = CGImageSourceCreateImageAtIndex(pSource, 0, NULL);
+        
+        CFRelease(pSource);
+        
+        if(!pImage)
+        {
+            return false;
+        }
+        
+        const bool isDecoded = (CGImageGetWidth(pImage) == width && CGImageGetHeight(pImage) == height && copyImage(pImage, rImage))
+                            || drawImage(pImage, width, height, rImage);
+        
+        CGImageRelease(pImage);
+        
+        return isDecoded;
+    }
+}
 
 @implementation AAPLArrayTexture
 {
 @private
     uint32_t         _width;
     uint32_t         _height;
+    
+    // Slices loading in the background
+    std::unique_ptr<AAPL::ArrayTexture::Builder> mpBuilder;
+    NSArray<NSString *>                          *mpPaths;
 }
 
 - (instancetype)initWithTextureWidth:(NSUInteger)width textureHeight:(NSUInteger)height arrayLength:(NSUInteger)length device:(id <MTLDevice>)device
+{
+    return [self initWithTextureWidth:width textureHeight:height arrayLength:length mipmapped:NO device:device];
+}
+
+- (instancetype)initWithTextureWidth:(NSUInteger)width textureHeight:(NSUInteger)height arrayLength:(NSUInteger)length mipmapped:(BOOL)mipmapped device:(id <MTLDevice>)device
 {
     if (self = [super init])
     {
         _width    = (uint32_t)(width);
         _height   = (uint32_t)(height);
         
-        MTLTextureDescriptor *pTexDesc = [MTLTextureDescriptor new];
+        MTLTextureDescriptor *pTexDesc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
+                                                                                            width:_width
+                                                                                           height:_height
+                                                                                        mipmapped:mipmapped];
         
         pTexDesc.textureType = MTLTextureType2DArray;
-        pTexDesc.pixelFormat = MTLPixelFormatRGBA8Unorm;
-        pTexDesc.width = _width;
-        pTexDesc.height = _height;
         pTexDesc.arrayLength = length;
         
         _texture = [device newTextureWithDescriptor:pTexDesc];
@@ -42,6 +209,11 @@
     return self;
 }
 
+- (BOOL)loading
+{
+    return mpBuilder != nullptr;
+}
+
 - (BOOL)setSlice:(NSUInteger)slice withContentsOfFile:(NSString *)path
 {
     
@@ -114,8 +286,89 @@
     return YES;
 }
 
+- (BOOL)loadSlicesWithContentsOfFiles:(NSArray<NSString *> *)paths
+{
+    if(mpBuilder || paths.count > _texture.arrayLength)
+    {
+        return NO;
+    }
+    
+    mpPaths = [paths copy];
+    
+    NSArray<NSString *> *pPaths  = mpPaths;
+    const uint32_t       width   = _width;
+    const uint32_t       height  = _height;
+    
+    // Slices are turned half a turn, the way setSlice:withContentsOfFile: draws them
+    mpBuilder.reset(new AAPL::ArrayTexture::Builder(_width,
+                                                    _height,
+                                                    pPaths.count,
+                                                    (uint32_t)_texture.mipmapLevelCount,
+                                                    true,
+                                                    [pPaths, width, height](const size_t& slice, AAPL::ArrayTexture::Image& rImage)
+                                                    {
+                                                        return decodeImage(pPaths[slice], width, height, rImage);
+                                                    },
+                                                    decodingPool(),
+                                                    kStagingBuffers));
+    
+    mpBuilder->start();
+    
+    return YES;
+}
+
+- (NSUInteger)uploadCompletedSlices
+{
+    if(!mpBuilder)
+    {
+        return 0;
+    }
+    
+    NSUInteger count = 0;
+    
+    AAPL::ArrayTexture::Slice slice;
+    
+    while(mpBuilder->poll(slice))
+    {
+        if(slice.pPixels)
+        {
+            for(uint32_t level = 0; level < mpBuilder->mipLevels(); ++level)
+            {
+                const uint32_t width  = mpBuilder->width(level);
+                const uint32_t height = mpBuilder->height(level);
+                
+                [_texture replaceRegion:MTLRegionMake2D(0, 0, width, height)
+                            mipmapLevel:level
+                                  slice:slice.index
+                              withBytes:slice.pPixels + mpBuilder->offset(level)
+                            bytesPerRow:width * 4
+                          bytesPerImage:width * height * 4];
+            }
+            
+            ++count;
+        }
+        else
+        {
+            NSLog(@">> ERROR: Failed loading array texture slice from %@", mpPaths[slice.index]);
+        }
+        
+        // Frees the staging buffer for the next slice to decode
+        mpBuilder->release(slice);
+    }
+    
+    if(mpBuilder->remaining() == 0)
+    {
+        mpBuilder.reset();
+        mpPaths = nil;
+    }
+    
+    return count;
+}
+
 - (void) dealloc
 {
+    mpBuilder.reset();
+    
     _texture = nil;
 }
 
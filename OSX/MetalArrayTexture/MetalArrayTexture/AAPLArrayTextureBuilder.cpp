@@ -0,0 +1,511 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Builds the slices of a 2D array texture concurrently. Slices are decoded on a thread pool into
+ staging buffers taken from a fixed arena, converted to RGBA8 with SIMD, given a box filtered mip
+ chain, then handed back through a completion queue in whatever order they finish, so that a
+ renderer can upload and draw with the slices it has before every slice is ready. A slice's
+ staging buffer returns to the arena once it has been uploaded, which starts the next decode.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "AAPLArrayTextureBuilder.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSSE3__)
+    #include <tmmintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - Pixels
+
+namespace AAPL
+{
+    namespace ArrayTexture
+    {
+        static inline size_t bytesPerPixel(const Format& format)
+        {
+            return (format == eFormatRGB8) ? 3 : 4;
+        }
+
+        static inline bool swapsRedAndBlue(const Format& format)
+        {
+            return (format == eFormatBGRA8) || (format == eFormatBGRX8);
+        }
+
+        static inline bool isOpaque(const Format& format)
+        {
+            return (format != eFormatRGBA8) && (format != eFormatBGRA8);
+        }
+
+        // One pixel at a time, for the ends of rows
+        static inline void convertPixels(const uint8_t* pSource,
+                                         const Format& format,
+                                         const size_t& first,
+                                         const size_t& last,
+                                         const size_t& count,
+                                         const bool& reverse,
+                                         uint8_t* pDestination)
+        {
+            const size_t stride = bytesPerPixel(format);
+            const bool   swap   = swapsRedAndBlue(format);
+            const bool   opaque = isOpaque(format);
+
+            for(size_t i = first; i < last; ++i)
+            {
+                const uint8_t* p = pSource + i * stride;
+                uint8_t*       q = pDestination + (reverse ? (count - 1 - i) : i) * 4;
+
+                q[0] = swap ? p[2] : p[0];
+                q[1] = p[1];
+                q[2] = swap ? p[0] : p[2];
+                q[3] = opaque ? 255 : p[3];
+            }
+        }
+
+        // Rounded average of up to four RGBA8 pixels
+        static inline void averagePixels(const uint8_t* p00,
+                                         const uint8_t* p01,
+                                         const uint8_t* p10,
+                                         const uint8_t* p11,
+                                         uint8_t* pDestination)
+        {
+            for(size_t c = 0; c < 4; ++c)
+            {
+                pDestination[c] = uint8_t((uint32_t(p00[c]) + p01[c] + p10[c] + p11[c] + 2) >> 2);
+            }
+        }
+    } // ArrayTexture
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Pixels
+
+void AAPL::ArrayTexture::convert(const uint8_t* pSource,
+                                 const Format& format,
+                                 const size_t& count,
+                                 const bool& reverse,
+                                 uint8_t* pDestination)
+{
+    size_t i = 0;
+
+#if defined(__SSSE3__) || defined(__SSE2__)
+    const bool swap   = swapsRedAndBlue(format);
+    const bool opaque = isOpaque(format);
+
+    const __m128i alpha = _mm_set1_epi32(int32_t(0xFF000000u));
+
+    #if defined(__SSSE3__)
+        // One shuffle picks, swaps and reverses four pixels; a -1 index leaves a zero for the alpha
+        // of RGB pixels
+        const size_t stride = bytesPerPixel(format);
+
+        int8_t indices[16];
+
+        for(size_t j = 0; j < 4; ++j)
+        {
+            const size_t pixel = reverse ? (3 - j) : j;
+
+            indices[j * 4 + 0] = int8_t(pixel * stride + (swap ? 2 : 0));
+            indices[j * 4 + 1] = int8_t(pixel * stride + 1);
+            indices[j * 4 + 2] = int8_t(pixel * stride + (swap ? 0 : 2));
+            indices[j * 4 + 3] = (stride == 4) ? int8_t(pixel * stride + 3) : int8_t(-1);
+        }
+
+        const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices));
+
+        // Every load reads 16 bytes, which runs past the last RGB pixel of a block
+        const size_t blocks = (stride == 4) ? (count / 4) : ((count >= 6) ? (count - 6) / 4 + 1 : 0);
+
+        for(size_t b = 0; b < blocks; ++b, i += 4)
+        {
+            __m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i * stride)), shuffle);
+
+            if(opaque)
+            {
+                pixels = _mm_or_si128(pixels, alpha);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + (reverse ? (count - 4 - i) : i) * 4), pixels);
+        }
+    #else
+        // Without byte shuffles, RGB pixels go one at a time
+        if(format != eFormatRGB8)
+        {
+            const __m128i redBlue = _mm_set1_epi32(0x00FF00FF);
+
+            for(; i + 4 <= count; i += 4)
+            {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i * 4));
+
+                if(swap)
+                {
+                    // Red and blue trade places, 16 bits apart in each little endian pixel
+                    const __m128i rb = _mm_and_si128(pixels, redBlue);
+
+                    pixels = _mm_or_si128(_mm_andnot_si128(redBlue, pixels),
+                                          _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+                }
+
+                if(opaque)
+                {
+                    pixels = _mm_or_si128(pixels, alpha);
+                }
+
+                if(reverse)
+                {
+                    pixels = _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3));
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + (reverse ? (count - 4 - i) : i) * 4), pixels);
+            }
+        }
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const bool swap   = swapsRedAndBlue(format);
+    const bool opaque = isOpaque(format);
+
+    // Sixteen pixels deinterleaved into a register per channel
+    for(; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t pixels;
+
+        if(format == eFormatRGB8)
+        {
+            const uint8x16x3_t rgb = vld3q_u8(pSource + i * 3);
+
+            pixels.val[0] = rgb.val[0];
+            pixels.val[1] = rgb.val[1];
+            pixels.val[2] = rgb.val[2];
+            pixels.val[3] = vdupq_n_u8(255);
+        }
+        else
+        {
+            pixels = vld4q_u8(pSource + i * 4);
+
+            if(swap)
+            {
+                std::swap(pixels.val[0], pixels.val[2]);
+            }
+
+            if(opaque)
+            {
+                pixels.val[3] = vdupq_n_u8(255);
+            }
+        }
+
+        if(reverse)
+        {
+            for(size_t c = 0; c < 4; ++c)
+            {
+                const uint8x16_t halves = vrev64q_u8(pixels.val[c]);
+
+                pixels.val[c] = vextq_u8(halves, halves, 8);
+            }
+        }
+
+        vst4q_u8(pDestination + (reverse ? (count - 16 - i) : i) * 4, pixels);
+    }
+#endif
+
+    convertPixels(pSource, format, i, count, count, reverse, pDestination);
+}
+
+void AAPL::ArrayTexture::downsample(const uint8_t* pSource,
+                                    const uint32_t& width,
+                                    const uint32_t& height,
+                                    uint8_t* pDestination)
+{
+    const uint32_t w = std::max(width / 2, 1u);
+    const uint32_t h = std::max(height / 2, 1u);
+
+    for(uint32_t y = 0; y < h; ++y)
+    {
+        const uint8_t* pRow0 = pSource + size_t(std::min(2 * y, height - 1)) * width * 4;
+        const uint8_t* pRow1 = pSource + size_t(std::min(2 * y + 1, height - 1)) * width * 4;
+
+        uint8_t* pOut = pDestination + size_t(y) * w * 4;
+
+        uint32_t x = 0;
+
+        // Whole pairs of source pixels only
+        if((width & 1) == 0)
+        {
+#if defined(__SSE2__)
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(2);
+
+            for(; x + 4 <= w; x += 4)
+            {
+                __m128i sums[2];
+
+                for(size_t k = 0; k < 2; ++k)
+                {
+                    // Two source pixels across two rows per 64 bits, widened to 16 bits a channel
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + (2 * x + 4 * k) * 4));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + (2 * x + 4 * k) * 4));
+
+                    const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                    const __m128i pairs = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+
+                    sums[k] = _mm_srli_epi16(_mm_add_epi16(pairs, round), 2);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + x * 4), _mm_packus_epi16(sums[0], sums[1]));
+            }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            for(; x + 8 <= w; x += 8)
+            {
+                const uint8x16x4_t a = vld4q_u8(pRow0 + 2 * x * 4);
+                const uint8x16x4_t b = vld4q_u8(pRow1 + 2 * x * 4);
+
+                uint8x8x4_t out;
+
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    // Neighbouring pixels summed pairwise, then both rows, rounded down to 8 bits
+                    const uint16x8_t sum = vaddq_u16(vpaddlq_u8(a.val[c]), vpaddlq_u8(b.val[c]));
+
+                    out.val[c] = vrshrn_n_u16(sum, 2);
+                }
+
+                vst4_u8(pOut + x * 4, out);
+            }
+#endif
+        }
+
+        for(; x < w; ++x)
+        {
+            const uint32_t x0 = std::min(2 * x, width - 1);
+            const uint32_t x1 = std::min(2 * x + 1, width - 1);
+
+            averagePixels(pRow0 + x0 * 4, pRow0 + x1 * 4, pRow1 + x0 * 4, pRow1 + x1 * 4, pOut + x * 4);
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Private - Builder
+
+void AAPL::ArrayTexture::Builder::submit(const size_t& slice, std::vector<uint8_t>* pBuffer)
+{
+    // Called with the mutex held
+    ++mnInFlight;
+
+    mrPool.submit([this, slice, pBuffer]()
+    {
+        build(slice, pBuffer);
+    });
+}
+
+void AAPL::ArrayTexture::Builder::build(const size_t& slice, std::vector<uint8_t>* pBuffer)
+{
+    Image image = {0, 0, 0, eFormatRGBA8, std::vector<uint8_t>()};
+
+    bool valid = m_Decoder(slice, image) &&
+                 (image.width == mnWidth) &&
+                 (image.height == mnHeight) &&
+                 (image.bytesPerRow >= mnWidth * bytesPerPixel(image.format)) &&
+                 (image.pixels.size() >= image.bytesPerRow * mnHeight);
+
+    if(valid)
+    {
+        uint8_t* pPixels = pBuffer->data();
+
+        for(uint32_t y = 0; y < mnHeight; ++y)
+        {
+            const uint32_t row = mbRotate ? (mnHeight - 1 - y) : y;
+
+            convert(image.pixels.data() + image.bytesPerRow * y,
+                    image.format,
+                    mnWidth,
+                    mbRotate,
+                    pPixels + size_t(row) * mnWidth * 4);
+        }
+
+        for(uint32_t level = 1; level < mnMipLevels; ++level)
+        {
+            downsample(pPixels + m_Offsets[level - 1], width(level - 1), height(level - 1), pPixels + m_Offsets[level]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Owners[slice] = pBuffer;
+
+    m_Completed.push_back({slice, valid ? pBuffer->data() : nullptr});
+
+    --mnInFlight;
+
+    m_Condition.notify_all();
+}
+
+bool AAPL::ArrayTexture::Builder::take(Slice& rSlice)
+{
+    // Called with the mutex held
+    if(m_Completed.empty())
+    {
+        return false;
+    }
+
+    rSlice = m_Completed.front();
+
+    m_Completed.pop_front();
+
+    ++mnHandedBack;
+
+    return true;
+}
+
+#pragma mark -
+#pragma mark Public - Builder
+
+AAPL::ArrayTexture::Builder::Builder(const uint32_t& width,
+                                     const uint32_t& height,
+                                     const size_t& slices,
+                                     const uint32_t& mipLevels,
+                                     const bool& rotate,
+                                     const Decoder& decoder,
+                                     Threads::WorkStealingPool& rPool,
+                                     const size_t& stagingBuffers)
+: mnWidth(std::max(width, 1u)),
+  mnHeight(std::max(height, 1u)),
+  mnSlices(slices),
+  mnMipLevels(1),
+  mbRotate(rotate),
+  m_Decoder(decoder),
+  mrPool(rPool),
+  mnNext(0),
+  mnInFlight(0),
+  mnHandedBack(0),
+  mbStarted(false)
+{
+    // Levels down to one texel
+    while(mnMipLevels < mipLevels && ((mnWidth >> mnMipLevels) > 0 || (mnHeight >> mnMipLevels) > 0))
+    {
+        ++mnMipLevels;
+    }
+
+    m_Offsets.push_back(0);
+
+    for(uint32_t level = 0; level < mnMipLevels; ++level)
+    {
+        m_Offsets.push_back(m_Offsets.back() + size_t(this->width(level)) * this->height(level) * 4);
+    }
+
+    m_Arena.resize(std::max<size_t>(std::min(stagingBuffers, slices), 1));
+
+    for(std::vector<uint8_t>& rBuffer : m_Arena)
+    {
+        rBuffer.resize(length());
+    }
+
+    m_Owners.resize(slices, nullptr);
+} // Constructor
+
+AAPL::ArrayTexture::Builder::~Builder()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // Nothing more gets started, and the decodes running still use the arena
+    mnNext = mnSlices;
+
+    m_Condition.wait(lock, [this]() { return mnInFlight == 0; });
+} // Destructor
+
+uint32_t AAPL::ArrayTexture::Builder::mipLevels() const
+{
+    return mnMipLevels;
+}
+
+uint32_t AAPL::ArrayTexture::Builder::width(const uint32_t& level) const
+{
+    return std::max(mnWidth >> level, 1u);
+}
+
+uint32_t AAPL::ArrayTexture::Builder::height(const uint32_t& level) const
+{
+    return std::max(mnHeight >> level, 1u);
+}
+
+size_t AAPL::ArrayTexture::Builder::offset(const uint32_t& level) const
+{
+    return m_Offsets[level];
+}
+
+size_t AAPL::ArrayTexture::Builder::length() const
+{
+    return m_Offsets.back();
+}
+
+size_t AAPL::ArrayTexture::Builder::remaining() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return mnSlices - mnHandedBack;
+}
+
+void AAPL::ArrayTexture::Builder::start()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if(mbStarted)
+    {
+        return;
+    }
+
+    mbStarted = true;
+
+    for(std::vector<uint8_t>& rBuffer : m_Arena)
+    {
+        if(mnNext < mnSlices)
+        {
+            submit(mnNext++, &rBuffer);
+        }
+    }
+}
+
+bool AAPL::ArrayTexture::Builder::poll(Slice& rSlice)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return take(rSlice);
+}
+
+bool AAPL::ArrayTexture::Builder::wait(Slice& rSlice)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // With nothing decoding, no slice can finish until a staging buffer is released
+    m_Condition.wait(lock, [this]() { return !m_Completed.empty() || mnInFlight == 0; });
+
+    return take(rSlice);
+}
+
+void AAPL::ArrayTexture::Builder::release(const Slice& rSlice)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<uint8_t>* pBuffer = m_Owners[rSlice.index];
+
+    if(!pBuffer)
+    {
+        return;
+    }
+
+    m_Owners[rSlice.index] = nullptr;
+
+    if(mnNext < mnSlices)
+    {
+        submit(mnNext++, pBuffer);
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Builds the slices of a 2D array texture concurrently. Slices are decoded on a thread pool into
+ staging buffers taken from a fixed arena, converted to RGBA8 with SIMD, given a box filtered mip
+ chain, then handed back through a completion queue in whatever order they finish, so that a
+ renderer can upload and draw with the slices it has before every slice is ready. A slice's
+ staging buffer returns to the arena once it has been uploaded, which starts the next decode.
+ */
+
+#ifndef _AAPL_ARRAY_TEXTURE_BUILDER_H_
+#define _AAPL_ARRAY_TEXTURE_BUILDER_H_
+
+#ifdef __cplusplus
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace ArrayTexture
+    {
+        // Layouts a decoder may hand back, 8 bits per channel. The X layouts' fourth byte is
+        // padding and comes out opaque.
+        enum Format
+        {
+            eFormatRGBA8 = 0,
+            eFormatRGBX8,
+            eFormatBGRA8,
+            eFormatBGRX8,
+            eFormatRGB8
+        };
+
+        // Decoded pixels of a slice, rows top to bottom
+        struct Image
+        {
+            uint32_t             width;
+            uint32_t             height;
+            size_t               bytesPerRow;
+            Format               format;
+            std::vector<uint8_t> pixels;
+        };
+
+        // Decode a slice into rImage; called concurrently for different slices
+        typedef std::function<bool(const size_t& slice, Image& rImage)> Decoder;
+
+        // Convert count pixels of a row to RGBA8, in reverse order when reverse is set
+        void convert(const uint8_t* pSource,
+                     const Format& format,
+                     const size_t& count,
+                     const bool& reverse,
+                     uint8_t* pDestination);
+
+        // 2x2 box filter of an RGBA8 level into the next, edges clamped for odd sizes
+        void downsample(const uint8_t* pSource,
+                        const uint32_t& width,
+                        const uint32_t& height,
+                        uint8_t* pDestination);
+
+        // A finished slice. Pixels hold every level, tightly packed RGBA8 rows, level after level;
+        // null for a slice that failed to decode or didn't match the texture's size.
+        struct Slice
+        {
+            size_t         index;
+            const uint8_t* pPixels;
+        };
+
+        class Builder
+        {
+        public:
+            // Mip levels are clamped to the full chain. Rotated slices are turned half a turn, the
+            // way the sample has always laid them out. At most stagingBuffers slices are decoded or
+            // waiting for upload at a time.
+            Builder(const uint32_t& width,
+                    const uint32_t& height,
+                    const size_t& slices,
+                    const uint32_t& mipLevels,
+                    const bool& rotate,
+                    const Decoder& decoder,
+                    Threads::WorkStealingPool& rPool,
+                    const size_t& stagingBuffers = 4);
+
+            // Waits for the decodes in flight
+            virtual ~Builder();
+
+            Builder(const Builder&) = delete;
+            Builder& operator=(const Builder&) = delete;
+
+            uint32_t mipLevels() const;
+            uint32_t width(const uint32_t& level) const;
+            uint32_t height(const uint32_t& level) const;
+
+            // Byte offset of a level in a slice's pixels
+            size_t offset(const uint32_t& level) const;
+
+            // Bytes of a slice with all its levels
+            size_t length() const;
+
+            // Slices not yet handed back
+            size_t remaining() const;
+
+            // Start decoding
+            void start();
+
+            // A finished slice, if there is one; doesn't block
+            bool poll(Slice& rSlice);
+
+            // Blocks for the next finished slice; false once every slice has been handed back
+            bool wait(Slice& rSlice);
+
+            // Return the slice's staging buffer to the arena once uploaded
+            void release(const Slice& rSlice);
+
+        private:
+            void submit(const size_t& slice, std::vector<uint8_t>* pBuffer);
+            void build(const size_t& slice, std::vector<uint8_t>* pBuffer);
+            bool take(Slice& rSlice);
+
+        private:
+            uint32_t                               mnWidth;
+            uint32_t                               mnHeight;
+            size_t                                 mnSlices;
+            uint32_t                               mnMipLevels;
+            bool                                   mbRotate;
+            Decoder                                m_Decoder;
+            Threads::WorkStealingPool&             mrPool;
+
+            std::vector<size_t>                    m_Offsets;          // Per level, then the length
+
+            std::vector<std::vector<uint8_t>>      m_Arena;
+            std::vector<std::vector<uint8_t>*>     m_Owners;           // Per slice, its staging buffer
+
+            mutable std::mutex                     m_Mutex;
+            std::condition_variable                m_Condition;
+            std::deque<Slice>                      m_Completed;
+            size_t                                 mnNext;             // Next slice to decode
+            size_t                                 mnInFlight;         // Decodes running
+            size_t                                 mnHandedBack;
+            bool                                   mbStarted;
+        }; // Class Builder
+    } // ArrayTexture
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,326 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the array texture builder, a standalone program that is not part of the app target.
+ It checks the SIMD row conversion of every format and the box filter of every small size against
+ scalar references, then builds 256 slices of 512x512 from a synthetic decoder that alternates RGB8
+ and BGRX8 rows and fails one slice and sizes another wrongly. Every slice must be handed back
+ exactly once, the two bad ones without pixels, and every other one must match the reference
+ turned half a turn with its whole mip chain. It reports the time to the first slice and to the
+ last on one worker and on one worker per hardware thread, against decoding, converting and
+ filtering the slices one after another with the scalar references.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLArrayTextureBuilder.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp AAPLArrayTextureBuilderBenchmark.cpp -o benchmark
+     ./benchmark [slices]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "AAPLArrayTextureBuilder.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::ArrayTexture;
+
+namespace
+{
+    const uint32_t kWidth  = 512;
+    const uint32_t kHeight = 512;
+
+    // Slices the decoder fails, or hands back at the wrong size
+    const size_t kFailedSlice    = 37;
+    const size_t kMisfittedSlice = 101;
+
+    void referenceConvert(const uint8_t* pSource, const Format& format, const size_t& count, const bool& reverse, uint8_t* pDestination)
+    {
+        const size_t stride  = (format == eFormatRGB8) ? 3 : 4;
+        const bool   swapped = (format == eFormatBGRA8) || (format == eFormatBGRX8);
+        const bool   opaque  = (format != eFormatRGBA8) && (format != eFormatBGRA8);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            const uint8_t* p = pSource + i * stride;
+            uint8_t*       q = pDestination + (reverse ? count - 1 - i : i) * 4;
+
+            q[0] = swapped ? p[2] : p[0];
+            q[1] = p[1];
+            q[2] = swapped ? p[0] : p[2];
+            q[3] = opaque ? 255 : p[3];
+        }
+    }
+
+    void referenceDownsample(const uint8_t* pSource, const uint32_t& width, const uint32_t& height, uint8_t* pDestination)
+    {
+        const uint32_t w = std::max(width / 2, 1u);
+        const uint32_t h = std::max(height / 2, 1u);
+
+        for(uint32_t y = 0; y < h; ++y)
+        {
+            for(uint32_t x = 0; x < w; ++x)
+            {
+                const uint32_t x0 = std::min(2 * x, width - 1);
+                const uint32_t x1 = std::min(2 * x + 1, width - 1);
+                const uint32_t y0 = std::min(2 * y, height - 1);
+                const uint32_t y1 = std::min(2 * y + 1, height - 1);
+
+                for(uint32_t c = 0; c < 4; ++c)
+                {
+                    const uint32_t sum = pSource[(y0 * width + x0) * 4 + c] + pSource[(y0 * width + x1) * 4 + c] +
+                                         pSource[(y1 * width + x0) * 4 + c] + pSource[(y1 * width + x1) * 4 + c];
+
+                    pDestination[(y * w + x) * 4 + c] = uint8_t((sum + 2) >> 2);
+                }
+            }
+        }
+    }
+
+    // Noise in RGB8 for even slices and BGRX8 for odd ones
+    bool decode(const size_t& slice, Image& rImage)
+    {
+        if(slice == kFailedSlice)
+        {
+            return false;
+        }
+
+        const size_t bytesPerPixel = (slice & 1) ? 4 : 3;
+
+        rImage.width       = (slice == kMisfittedSlice) ? kWidth / 2 : kWidth;
+        rImage.height      = kHeight;
+        rImage.format      = (slice & 1) ? eFormatBGRX8 : eFormatRGB8;
+        rImage.bytesPerRow = rImage.width * bytesPerPixel;
+
+        rImage.pixels.resize(rImage.bytesPerRow * rImage.height);
+
+        uint32_t state = uint32_t(slice * 2654435761u);
+
+        for(uint8_t& rByte : rImage.pixels)
+        {
+            state  = state * 1664525u + 1013904223u;
+            rByte  = uint8_t(state >> 24);
+        }
+
+        return true;
+    }
+
+    // A slice the slow way: decoded, converted half a turn round and filtered level by level
+    void referenceSlice(const size_t& slice, std::vector<uint8_t>& rPixels)
+    {
+        Image image;
+
+        decode(slice, image);
+
+        rPixels.assign(size_t(kWidth) * kHeight * 4 * 2, 0);
+
+        for(uint32_t y = 0; y < kHeight; ++y)
+        {
+            referenceConvert(image.pixels.data() + image.bytesPerRow * y, image.format, kWidth, true, rPixels.data() + size_t(kHeight - 1 - y) * kWidth * 4);
+        }
+
+        size_t   offset = 0;
+        uint32_t width  = kWidth;
+        uint32_t height = kHeight;
+
+        while((width > 1) || (height > 1))
+        {
+            const size_t length = size_t(width) * height * 4;
+
+            referenceDownsample(rPixels.data() + offset, width, height, rPixels.data() + offset + length);
+
+            offset += length;
+            width   = std::max(width / 2, 1u);
+            height  = std::max(height / 2, 1u);
+        }
+
+        rPixels.resize(offset + 4);
+    }
+
+    size_t checkConversions()
+    {
+        std::mt19937 generator(1);
+
+        size_t mismatches = 0;
+
+        for(int format = eFormatRGBA8; format <= eFormatRGB8; ++format)
+        {
+            for(int reverse = 0; reverse < 2; ++reverse)
+            {
+                for(size_t count = 0; count < 70; ++count)
+                {
+                    std::vector<uint8_t> source(count * 4 + 16);
+                    std::vector<uint8_t> result(count * 4);
+                    std::vector<uint8_t> reference(count * 4);
+
+                    for(uint8_t& rByte : source)
+                    {
+                        rByte = uint8_t(generator());
+                    }
+
+                    convert(source.data(), Format(format), count, reverse != 0, result.data());
+                    referenceConvert(source.data(), Format(format), count, reverse != 0, reference.data());
+
+                    mismatches += (result != reference) ? 1 : 0;
+                }
+            }
+        }
+
+        for(uint32_t width = 1; width < 40; ++width)
+        {
+            for(uint32_t height = 1; height < 9; ++height)
+            {
+                std::vector<uint8_t> source(size_t(width) * height * 4);
+                std::vector<uint8_t> result(size_t(std::max(width / 2, 1u)) * std::max(height / 2, 1u) * 4);
+                std::vector<uint8_t> reference(result.size());
+
+                for(uint8_t& rByte : source)
+                {
+                    rByte = uint8_t(generator());
+                }
+
+                downsample(source.data(), width, height, result.data());
+                referenceDownsample(source.data(), width, height, reference.data());
+
+                mismatches += (result != reference) ? 1 : 0;
+            }
+        }
+
+        return mismatches;
+    }
+
+    bool build(const size_t& slices, Threads::WorkStealingPool& rPool)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        double firstTime = 0.0;
+        double totalTime = 0.0;
+
+        std::vector<int>            handedBack(slices, 0);
+        std::vector<const uint8_t*> results(slices, nullptr);
+        std::vector<uint8_t>        copies;
+
+        size_t length = 0;
+
+        {
+            Builder builder(kWidth, kHeight, slices, 16, true, decode, rPool, 8);
+
+            length = builder.length();
+
+            copies.resize(length * slices);
+
+            start = std::chrono::steady_clock::now();
+
+            builder.start();
+
+            Slice slice;
+
+            while(builder.wait(slice))
+            {
+                if(firstTime == 0.0)
+                {
+                    firstTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                }
+
+                // What an upload would copy out before the staging buffer goes back
+                if(slice.pPixels)
+                {
+                    std::memcpy(&copies[slice.index * length], slice.pPixels, length);
+
+                    results[slice.index] = &copies[slice.index * length];
+                }
+
+                handedBack[slice.index]++;
+
+                builder.release(slice);
+            }
+
+            totalTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // The calling thread only waits, so the workers do all the building
+        std::printf("%zu workers: first slice %6.1f ms, all %zu slices %7.1f ms\n", rPool.concurrency() - 1, firstTime, slices, totalTime);
+
+        std::vector<uint8_t> reference;
+
+        for(size_t i = 0; i < slices; ++i)
+        {
+            const bool bad = (i == kFailedSlice) || (i == kMisfittedSlice);
+
+            if(handedBack[i] != 1)
+            {
+                std::printf("Slice %zu was handed back %d times\n", i, handedBack[i]);
+
+                return false;
+            }
+
+            if(bad != (results[i] == nullptr))
+            {
+                std::printf("Slice %zu %s pixels\n", i, bad ? "has" : "lacks");
+
+                return false;
+            }
+
+            if(!bad)
+            {
+                referenceSlice(i, reference);
+
+                if((reference.size() != length) || (std::memcmp(reference.data(), results[i], length) != 0))
+                {
+                    std::printf("Slice %zu differs from the reference\n", i);
+
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t slices = (argc >= 2) ? size_t(std::strtoul(argv[1], nullptr, 10)) : 256;
+
+    if(slices <= kMisfittedSlice)
+    {
+        std::printf("There must be more than %zu slices\n", kMisfittedSlice);
+
+        return 1;
+    }
+
+    const size_t mismatches = checkConversions();
+
+    std::printf("Conversions and filters: %zu mismatches against the references\n", mismatches);
+
+    bool passed = (mismatches == 0);
+
+    // One worker, then one per hardware thread
+    for(const size_t& workers : {size_t(1), size_t(std::max(2u, std::thread::hardware_concurrency()))})
+    {
+        Threads::WorkStealingPool pool(workers);
+
+        passed = build(slices, pool) && passed;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> reference;
+
+    for(size_t i = 0; i < slices; ++i)
+    {
+        if((i != kFailedSlice) && (i != kMisfittedSlice))
+        {
+            referenceSlice(i, reference);
+        }
+    }
+
+    std::printf("Scalar, one slice after another: %7.1f ms\n", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+    return passed ? 0 : 1;
+}
@@ -141,16 +141,20 @@ static const float maxZoomFactor = 2.5;
     
     m_DepthState = [m_Device newDepthStencilStateWithDescriptor:pDepthStateDesc];
    
-    // create our two-dimensional array texture
-    mpInTexture = [[AAPLArrayTexture alloc] initWithTextureWidth:128 textureHeight:128 arrayLength:4 device:m_Device];
+    // create our two-dimensional array texture, whose slices and mips load in the background
+    mpInTexture = [[AAPLArrayTexture alloc] initWithTextureWidth:128 textureHeight:128 arrayLength:4 mipmapped:YES device:m_Device];
     
-    BOOL isAcquired = NO;
-    isAcquired |= [mpInTexture setSlice:0 withContentsOfFile:[[NSBundle mainBundle] pathForResource:@"rock" ofType:@"jpg"]];
-    isAcquired |= [mpInTexture setSlice:1 withContentsOfFile:[[NSBundle mainBundle] pathForResource:@"grass" ofType:@"jpg"]];
-    isAcquired |= [mpInTexture setSlice:2 withContentsOfFile:[[NSBundle mainBundle] pathForResource:@"dirt" ofType:@"jpg"]];
-    isAcquired |= [mpInTexture setSlice:3 withContentsOfFile:[[NSBundle mainBundle] pathForResource:@"snow" ofType:@"jpg"]];
+    NSMutableArray<NSString *> *pSlicePaths = [NSMutableArray new];
     
-    if(!isAcquired) {
+    for (NSString *pName in @[@"rock", @"grass", @"dirt", @"snow"]) {
+        NSString *pPath = [[NSBundle mainBundle] pathForResource:pName ofType:@"jpg"];
+        
+        if(pPath) {
+            [pSlicePaths addObject:pPath];
+        }
+    }
+    
+    if(!pSlicePaths.count || ![mpInTexture loadSlicesWithContentsOfFiles:pSlicePaths]) {
         NSLog(@">> ERROR: Failed creating array texture!");
     }
     
@@ -237,6 +241,11 @@ static const float maxZoomFactor = 2.5;
     
     dispatch_semaphore_wait(m_InflightSemaphore, DISPATCH_TIME_FOREVER);
     
+    // Slices that finished decoding since the last frame
+    if (mpInTexture.loading) {
+        [mpInTexture uploadCompletedSlices];
+    }
+    
     id <MTLCommandBuffer> commandBuffer = [m_CommandQueue commandBuffer];
     
     // create a render command encoder so we can render into something
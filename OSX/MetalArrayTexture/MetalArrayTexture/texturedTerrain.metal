@@ -41,7 +41,7 @@ fragment half4 texturedTerrainFragment(VertexInOut             inFrag    [[ stag
     float2 texCoord = float2(inFrag.m_TexCoord.x , inFrag.m_TexCoord.y);
     float slice = floor(inFrag.m_TexCoord.z);
     
-    constexpr sampler sampler(coord::normalized, address::repeat, filter::linear);
+    constexpr sampler sampler(coord::normalized, address::repeat, filter::linear, mip_filter::linear);
     half4 a = tex2D.sample(sampler, texCoord, slice);
     half4 b = tex2D.sample(sampler, texCoord, slice+1);
     
@@ -0,0 +1,231 @@
+/*
+    Copyright (C) 2016 Apple Inc. All Rights Reserved.
+    See LICENSE.txt for this sample’s licensing information
+
+    Abstract:
+    Screen-space adaptive tessellation factors, the CPU counterpart of the adaptive compute kernels.
+            An edge's factor is its projected length over the pixels a segment aims for, clamped to the pipeline's
+            range. It depends on the edge's two end points alone, so the two patches sharing an edge give it the
+            same factor and the tessellator places the same points on it: no cracks. A patch entirely outside one
+            frustum plane, or back-facing when culling is on, gets zero factors and the tessellator drops it.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "AAPLTessellationFactors.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace AAPL
+{
+    namespace Tessellation
+    {
+        // Clip-space w below which a point is taken to be behind the eye
+        static const float kMinW = 1.0e-5f;
+
+        // MTLWindingClockwise
+        static const unsigned int kClockwise = 0;
+
+        static inline float clamp(const float& value, const float& lower, const float& upper)
+        {
+            return std::min(std::max(value, lower), upper);
+        }
+
+        // Lexicographic order of clip-space points
+        static inline bool precedes(const float4& a, const float4& b)
+        {
+            if(a.x != b.x) return a.x < b.x;
+            if(a.y != b.y) return a.y < b.y;
+            if(a.z != b.z) return a.z < b.z;
+
+            return a.w < b.w;
+        }
+
+        // Twice the signed area of the projected triangle, positive when it winds counterclockwise
+        static inline float area(const float4& a, const float4& b, const float4& c)
+        {
+            const float ax = a.x / a.w;
+            const float ay = a.y / a.w;
+            const float bx = b.x / b.w;
+            const float by = b.y / b.w;
+            const float cx = c.x / c.w;
+            const float cy = c.y / c.w;
+
+            return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+        }
+    } // Tessellation
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Factors
+
+AAPL::Tessellation::float4 AAPL::Tessellation::project(const AAPLTessellationUniforms& uniforms, const float4& p)
+{
+    const float* m = uniforms.modelViewProjection;
+
+    return {m[0] * p.x + m[4] * p.y + m[8]  * p.z + m[12] * p.w,
+            m[1] * p.x + m[5] * p.y + m[9]  * p.z + m[13] * p.w,
+            m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14] * p.w,
+            m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15] * p.w};
+}
+
+float AAPL::Tessellation::edgeFactor(const AAPLTessellationUniforms& uniforms, const float4& p, const float4& q)
+{
+    if(!(p.w > kMinW) || !(q.w > kMinW))
+    {
+        return uniforms.maxFactor;
+    }
+
+    // The two patches on an edge walk it in opposite directions. Measuring from the same end either
+    // way keeps contracted or reordered arithmetic from giving them factors an ulp apart.
+    const bool    swap = precedes(q, p);
+    const float4& a    = swap ? q : p;
+    const float4& b    = swap ? p : q;
+
+    const float sx = 0.5f * uniforms.viewportSize[0];
+    const float sy = 0.5f * uniforms.viewportSize[1];
+
+    const float dx = (a.x / a.w) * sx - (b.x / b.w) * sx;
+    const float dy = (a.y / a.w) * sy - (b.y / b.w) * sy;
+
+    const float pixels = std::sqrt(dx * dx + dy * dy);
+
+    return clamp(pixels / uniforms.pixelsPerSegment, 1.0f, uniforms.maxFactor);
+}
+
+bool AAPL::Tessellation::outside(const float4* pClip, const size_t& count)
+{
+    // Metal's clip volume: -w <= x <= w, -w <= y <= w, 0 <= z <= w
+    bool left   = true;
+    bool right  = true;
+    bool bottom = true;
+    bool top    = true;
+    bool near   = true;
+    bool far    = true;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const float4& p = pClip[i];
+
+        left   = left   && (p.x < -p.w);
+        right  = right  && (p.x >  p.w);
+        bottom = bottom && (p.y < -p.w);
+        top    = top    && (p.y >  p.w);
+        near   = near   && (p.z <  0.0f);
+        far    = far    && (p.z >  p.w);
+    }
+
+    return left || right || bottom || top || near || far;
+}
+
+bool AAPL::Tessellation::backFacing(const AAPLTessellationUniforms& uniforms,
+                                    const float4& a,
+                                    const float4& b,
+                                    const float4& c)
+{
+    // A triangle reaching behind the eye has no winding on screen to judge by
+    if(!(a.w > kMinW) || !(b.w > kMinW) || !(c.w > kMinW))
+    {
+        return false;
+    }
+
+    const float signedArea = area(a, b, c);
+
+    return (uniforms.frontFacingWinding == kClockwise) ? (signedArea > 0.0f) : (signedArea < 0.0f);
+}
+
+bool AAPL::Tessellation::triangleFactors(const AAPLTessellationUniforms& uniforms,
+                                         const float4* pControlPoints,
+                                         TriangleFactors& rFactors)
+{
+    const float4 clip[3] =
+    {
+        project(uniforms, pControlPoints[0]),
+        project(uniforms, pControlPoints[1]),
+        project(uniforms, pControlPoints[2])
+    };
+
+    if(outside(clip, 3) || (uniforms.cullBackFaces && backFacing(uniforms, clip[0], clip[1], clip[2])))
+    {
+        rFactors = {{0.0f, 0.0f, 0.0f}, 0.0f};
+
+        return false;
+    }
+
+    // Edge u == 0 runs between the control points at v == 1 and w == 1, and so on
+    rFactors.edge[0] = edgeFactor(uniforms, clip[1], clip[2]);
+    rFactors.edge[1] = edgeFactor(uniforms, clip[2], clip[0]);
+    rFactors.edge[2] = edgeFactor(uniforms, clip[0], clip[1]);
+
+    // As fine as the finest edge, so the inside never shows coarser than the silhouette
+    rFactors.inside = std::max(std::max(rFactors.edge[0], rFactors.edge[1]), rFactors.edge[2]);
+
+    return true;
+}
+
+bool AAPL::Tessellation::quadFactors(const AAPLTessellationUniforms& uniforms,
+                                     const float4* pControlPoints,
+                                     QuadFactors& rFactors)
+{
+    const float4 clip[4] =
+    {
+        project(uniforms, pControlPoints[0]),
+        project(uniforms, pControlPoints[1]),
+        project(uniforms, pControlPoints[2]),
+        project(uniforms, pControlPoints[3])
+    };
+
+    // A bilinear patch faces away only if both halves of its control cage do
+    const bool culled = outside(clip, 4) ||
+                        (uniforms.cullBackFaces &&
+                         backFacing(uniforms, clip[0], clip[1], clip[2]) &&
+                         backFacing(uniforms, clip[0], clip[2], clip[3]));
+
+    if(culled)
+    {
+        rFactors = {{0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}};
+
+        return false;
+    }
+
+    rFactors.edge[0] = edgeFactor(uniforms, clip[3], clip[0]);
+    rFactors.edge[1] = edgeFactor(uniforms, clip[0], clip[1]);
+    rFactors.edge[2] = edgeFactor(uniforms, clip[1], clip[2]);
+    rFactors.edge[3] = edgeFactor(uniforms, clip[2], clip[3]);
+
+    // Edges v == 0 and v == 1 run along u, the other two along v
+    rFactors.inside[0] = std::max(rFactors.edge[1], rFactors.edge[3]);
+    rFactors.inside[1] = std::max(rFactors.edge[0], rFactors.edge[2]);
+
+    return true;
+}
+
+size_t AAPL::Tessellation::triangleFactors(const AAPLTessellationUniforms& uniforms,
+                                           const float4* pControlPoints,
+                                           TriangleFactors* pFactors)
+{
+    size_t visible = 0;
+
+    for(unsigned int i = 0; i < uniforms.patchCount; ++i)
+    {
+        visible += triangleFactors(uniforms, pControlPoints + 3 * i, pFactors[i]) ? 1 : 0;
+    }
+
+    return visible;
+}
+
+size_t AAPL::Tessellation::quadFactors(const AAPLTessellationUniforms& uniforms,
+                                       const float4* pControlPoints,
+                                       QuadFactors* pFactors)
+{
+    size_t visible = 0;
+
+    for(unsigned int i = 0; i < uniforms.patchCount; ++i)
+    {
+        visible += quadFactors(uniforms, pControlPoints + 4 * i, pFactors[i]) ? 1 : 0;
+    }
+
+    return visible;
+}
@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2016 Apple Inc. All Rights Reserved.
+    See LICENSE.txt for this sample’s licensing information
+
+    Abstract:
+    Screen-space adaptive tessellation factors, the CPU counterpart of the adaptive compute kernels.
+            An edge's factor is its projected length over the pixels a segment aims for, clamped to the pipeline's
+            range. It depends on the edge's two end points alone, so the two patches sharing an edge give it the
+            same factor and the tessellator places the same points on it: no cracks. A patch entirely outside one
+            frustum plane, or back-facing when culling is on, gets zero factors and the tessellator drops it.
+ */
+
+#ifndef _AAPL_TESSELLATION_FACTORS_H_
+#define _AAPL_TESSELLATION_FACTORS_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+
+#include "AAPLTessellationTypes.h"
+
+namespace AAPL
+{
+    namespace Tessellation
+    {
+        struct float4
+        {
+            float x;
+            float y;
+            float z;
+            float w;
+        };
+
+        // MTLTriangleTessellationFactorsHalf's layout in floats: edges u == 0, v == 0, w == 0
+        struct TriangleFactors
+        {
+            float edge[3];
+            float inside;
+        };
+
+        // MTLQuadTessellationFactorsHalf's layout in floats: edges u == 0, v == 0, u == 1, v == 1, then
+        // inside along u and along v
+        struct QuadFactors
+        {
+            float edge[4];
+            float inside[2];
+        };
+
+        // Control points to clip space
+        float4 project(const AAPLTessellationUniforms& uniforms, const float4& position);
+
+        // Factor of the edge between two clip-space points. An edge reaching behind the eye gets the
+        // maximum, having no screen length to measure.
+        float edgeFactor(const AAPLTessellationUniforms& uniforms, const float4& a, const float4& b);
+
+        // All clip-space points outside one frustum plane
+        bool outside(const float4* pClip, const size_t& count);
+
+        // The clip-space triangle winds against the uniforms' front-facing winding on screen
+        bool backFacing(const AAPLTessellationUniforms& uniforms, const float4& a, const float4& b, const float4& c);
+
+        // A linear triangle patch, control points at u == 1, v == 1 and w == 1. False when culled.
+        bool triangleFactors(const AAPLTessellationUniforms& uniforms,
+                             const float4* pControlPoints,
+                             TriangleFactors& rFactors);
+
+        // A bilinear quad patch, control points at (0, 0), (1, 0), (1, 1) and (0, 1). False when culled.
+        bool quadFactors(const AAPLTessellationUniforms& uniforms,
+                         const float4* pControlPoints,
+                         QuadFactors& rFactors);
+
+        // Every patch of a control point array, as the kernels do one per thread. Returns the patches
+        // that weren't culled.
+        size_t triangleFactors(const AAPLTessellationUniforms& uniforms,
+                               const float4* pControlPoints,
+                               TriangleFactors* pFactors);
+
+        size_t quadFactors(const AAPLTessellationUniforms& uniforms,
+                           const float4* pControlPoints,
+                           QuadFactors* pFactors);
+    } // Tessellation
+} // AAPL
+
+#endif
+
+#endif
@@ -8,6 +8,7 @@
             The compute pipelines are built with a compute kernel (one for triangle patches; one for quad patches).
             The render pipelines are built with a post-tessellation vertex function (one for triangle patches; one for quad patches) and a fragment function. The render pipeline descriptor also configures tessellation-specific properties.
             The tessellation factors buffer is dynamically populated by the compute kernel.
+            In adaptive mode the factors follow each edge's projected length instead of the edge and inside factors.
             The control points buffer is populated with static position data.
  */
 
@@ -21,6 +22,10 @@
 @property (readwrite) float edgeFactor;
 @property (readwrite) float insideFactor;
 
+// Экранные факторы: длина ребра на экране / pixelsPerSegment, невидимые патчи отбрасываются
+@property (readwrite) BOOL adaptive;
+@property (readwrite) float pixelsPerSegment;
+
 - (nullable instancetype)initWithMTKView:(nonnull MTKView *)mtkView;
 
 @end
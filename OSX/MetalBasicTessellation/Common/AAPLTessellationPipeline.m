@@ -8,11 +8,13 @@
             The compute pipelines are built with a compute kernel (one for triangle patches; one for quad patches).
             The render pipelines are built with a post-tessellation vertex function (one for triangle patches; one for quad patches) and a fragment function. The render pipeline descriptor also configures tessellation-specific properties.
             The tessellation factors buffer is dynamically populated by the compute kernel.
+            In adaptive mode the factors follow each edge's projected length instead of the edge and inside factors.
             The control points buffer is populated with static position data.
  */
 
 #include <TargetConditionals.h>
 #import "AAPLTessellationPipeline.h"
+#import "AAPLTessellationTypes.h"
 
 @implementation AAPLTessellationPipeline {
     id <MTLDevice> _device;
@@ -21,12 +23,16 @@
     
     id <MTLComputePipelineState> _computePipelineTriangle;
     id <MTLComputePipelineState> _computePipelineQuad;
+    id <MTLComputePipelineState> _computePipelineTriangleAdaptive;
+    id <MTLComputePipelineState> _computePipelineQuadAdaptive;
     id <MTLRenderPipelineState> _renderPipelineTriangle;
     id <MTLRenderPipelineState> _renderPipelineQuad;
     
     id <MTLBuffer> _tessellationFactorsBuffer;
     id <MTLBuffer> _controlPointsBufferTriangle;
     id <MTLBuffer> _controlPointsBufferQuad;
+    
+    AAPLTessellationUniforms _uniforms;
 }
 
 - (nullable instancetype)initWithMTKView:(nonnull MTKView *)view {
@@ -37,6 +43,8 @@
         _patchType = MTLPatchTypeTriangle;
         _edgeFactor = 2.0;
         _insideFactor = 2.0;
+        _adaptive = NO;
+        _pixelsPerSegment = 16.0;
         
         // Настраиваем метал
         if(![self didSetupMetal]) {
@@ -59,6 +67,9 @@
         
         // Настраиваем буфферы
         [self setupBuffers];
+        
+        // Юниформы адаптивных факторов
+        [self setupUniformsWithSize:view.drawableSize];
     }
     return self;
 }
@@ -117,6 +128,23 @@
         return NO;
     }
     
+    // Адаптивные вычислительные пайплайны, по потоку на патч
+    id <MTLFunction> kernelFunctionTriangleAdaptive = [_library newFunctionWithName:@"tessellation_kernel_triangle_adaptive"];
+    _computePipelineTriangleAdaptive = [_device newComputePipelineStateWithFunction:kernelFunctionTriangleAdaptive
+                                                                              error:&computePipelineError];
+    if(!_computePipelineTriangleAdaptive) {
+        NSLog(@"Failed to create compute pipeline (TRIANGLE, ADAPTIVE), error: %@", computePipelineError);
+        return NO;
+    }
+    
+    id <MTLFunction> kernelFunctionQuadAdaptive = [_library newFunctionWithName:@"tessellation_kernel_quad_adaptive"];
+    _computePipelineQuadAdaptive = [_device newComputePipelineStateWithFunction:kernelFunctionQuadAdaptive
+                                                                          error:&computePipelineError];
+    if(!_computePipelineQuadAdaptive) {
+        NSLog(@"Failed to create compute pipeline (QUAD, ADAPTIVE), error: %@", computePipelineError);
+        return NO;
+    }
+    
     return YES;
 }
 
@@ -222,6 +250,28 @@
     // More sophisticated tessellation passes might have additional buffers for per-patch user data
 }
 
+- (void)setupUniformsWithSize:(CGSize)size
+{
+    // Контрольные точки уже в клип-пространстве: единичная матрица
+    for(int i = 0; i < 16; i++) {
+        _uniforms.modelViewProjection[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+    _uniforms.viewportSize[0] = size.width;
+    _uniforms.viewportSize[1] = size.height;
+    
+    // Must match the render pipeline's maxTessellationFactor
+#if TARGET_OS_IOS
+    _uniforms.maxFactor = 16;
+#elif TARGET_OS_OSX
+    _uniforms.maxFactor = 64;
+#endif
+    
+    // Both patches wind clockwise on screen; they are flat, so back faces can be culled from the control points
+    _uniforms.frontFacingWinding = MTLWindingClockwise;
+    _uniforms.cullBackFaces = 1;
+    _uniforms.patchCount = 1;
+}
+
 #pragma mark Compute/Render methods
 
 - (void)computeTessellationFactorsWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer {
@@ -232,23 +282,40 @@
     // Пишем имя для отладочной информации
     [computeCommandEncoder pushDebugGroup:@"Compute Tessellation Factors"];
     
-    // Включаем необходимый вычислительный пайплайн
-    if(self.patchType == MTLPatchTypeTriangle) {
-        [computeCommandEncoder setComputePipelineState:_computePipelineTriangle];
-    } else if(self.patchType == MTLPatchTypeQuad) {
-        [computeCommandEncoder setComputePipelineState:_computePipelineQuad];
+    if(self.adaptive) {
+        // Факторы из длины рёбер на экране, поток на патч
+        id <MTLComputePipelineState> pipeline = (self.patchType == MTLPatchTypeTriangle) ? _computePipelineTriangleAdaptive : _computePipelineQuadAdaptive;
+        id <MTLBuffer> controlPoints = (self.patchType == MTLPatchTypeTriangle) ? _controlPointsBufferTriangle : _controlPointsBufferQuad;
+        [computeCommandEncoder setComputePipelineState:pipeline];
+        
+        _uniforms.pixelsPerSegment = MAX(_pixelsPerSegment, 1.0f);
+        [computeCommandEncoder setBytes:&_uniforms length:sizeof(AAPLTessellationUniforms) atIndex:0];
+        [computeCommandEncoder setBuffer:controlPoints offset:0 atIndex:1];
+        [computeCommandEncoder setBuffer:_tessellationFactorsBuffer offset:0 atIndex:2];
+        
+        // Лишние потоки последней группы выходят по patchCount
+        NSUInteger width = pipeline.threadExecutionWidth;
+        NSUInteger groups = (_uniforms.patchCount + width - 1) / width;
+        [computeCommandEncoder dispatchThreadgroups:MTLSizeMake(groups, 1, 1) threadsPerThreadgroup:MTLSizeMake(width, 1, 1)];
+    } else {
+        // Включаем необходимый вычислительный пайплайн
+        if(self.patchType == MTLPatchTypeTriangle) {
+            [computeCommandEncoder setComputePipelineState:_computePipelineTriangle];
+        } else if(self.patchType == MTLPatchTypeQuad) {
+            [computeCommandEncoder setComputePipelineState:_computePipelineQuad];
+        }
+        
+        // Для вычислительной стадии устанавливаем данные настроек
+        [computeCommandEncoder setBytes:&_edgeFactor length:sizeof(float) atIndex:0];
+        [computeCommandEncoder setBytes:&_insideFactor length:sizeof(float) atIndex:1];
+        
+        // Устанавливаем буффер таccеляции
+        [computeCommandEncoder setBuffer:_tessellationFactorsBuffer offset:0 atIndex:2];
+        
+        // Кидаем задачи в очередь
+        [computeCommandEncoder dispatchThreadgroups:MTLSizeMake(1, 1, 1) threadsPerThreadgroup:MTLSizeMake(1, 1, 1)];
     }
     
-    // Для вычислительной стадии устанавливаем данные настроек
-    [computeCommandEncoder setBytes:&_edgeFactor length:sizeof(float) atIndex:0];
-    [computeCommandEncoder setBytes:&_insideFactor length:sizeof(float) atIndex:1];
-    
-    // Устанавливаем буффер таccеляции
-    [computeCommandEncoder setBuffer:_tessellationFactorsBuffer offset:0 atIndex:2];
-    
-    // Кидаем задачи в очередь
-    [computeCommandEncoder dispatchThreadgroups:MTLSizeMake(1, 1, 1) threadsPerThreadgroup:MTLSizeMake(1, 1, 1)];
-    
     // Заканчиваем энкодинг
     [computeCommandEncoder popDebugGroup];
     [computeCommandEncoder endEncoding];
@@ -301,6 +368,9 @@
 
 // Called whenever view changes orientation or layout is changed
 - (void)mtkView:(nonnull MTKView *)view drawableSizeWillChange:(CGSize)size {
+    // Адаптивные факторы считаются в пикселях
+    _uniforms.viewportSize[0] = size.width;
+    _uniforms.viewportSize[1] = size.height;
 }
 
 // Отрисовка Metal
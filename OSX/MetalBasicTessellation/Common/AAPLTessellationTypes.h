@@ -0,0 +1,25 @@
+/*
+    Copyright (C) 2016 Apple Inc. All Rights Reserved.
+    See LICENSE.txt for this sample’s licensing information
+
+    Abstract:
+    Types shared by the adaptive compute kernels, the tessellation pipeline and the CPU factor module.
+            Only 4-byte scalars, so the layout is the same in the Metal shading language, C and C++.
+ */
+
+#ifndef AAPLTessellationTypes_h
+#define AAPLTessellationTypes_h
+
+// Uniforms of the adaptive compute kernels
+typedef struct
+{
+    float        modelViewProjection[16];   // Column major, as simd's matrix_float4x4; control points to clip space
+    float        viewportSize[2];           // Pixels
+    float        pixelsPerSegment;          // Screen length a tessellated edge segment aims for
+    float        maxFactor;                 // The render pipeline's maxTessellationFactor
+    unsigned int frontFacingWinding;        // MTLWinding of a front-facing patch in normalized device coordinates
+    unsigned int cullBackFaces;             // Zero the factors of back-facing patches too, for flat patches only
+    unsigned int patchCount;
+} AAPLTessellationUniforms;
+
+#endif /* AAPLTessellationTypes_h */
@@ -0,0 +1,815 @@
+/*
+    Copyright (C) 2016 Apple Inc. All Rights Reserved.
+    See LICENSE.txt for this sample’s licensing information
+
+    Abstract:
+    CPU reference tessellator for triangle and quad patches, in every partition mode.
+            Factors are clamped and rounded as the render pipeline does, then laid out the way the fixed-function
+            tessellator lays them out: the outer ring carries each edge's own points, the inner rings the inside
+            factors', placed in 16.16 fixed point with fractional factors splitting their segments symmetrically
+            about each edge's middle. Rings are stitched edge by edge into triangles. The points are the
+            tessellator's; the diagonals of the stitching may differ, the number of triangles doesn't.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "AAPLTessellator.h"
+
+#pragma mark -
+#pragma mark Private - Fixed Point
+
+namespace AAPL
+{
+    namespace Tessellation
+    {
+        // 16.16 fixed point
+        typedef int32_t fixed;
+
+        static const int   kFractionBits = 16;
+        static const fixed kOne          = 1 << kFractionBits;
+        static const fixed kHalf         = kOne >> 1;
+        static const fixed kOneThird     = 0x5555;
+        static const fixed kTwoThirds    = 0xaaaa;
+
+        // Smallest positive fraction; fractional odd keeps the inside above one by it
+        static const float kEpsilon = 1.0f / float(kOne);
+
+        static inline fixed toFixed(const float& value)
+        {
+            return fixed(std::floor(value * float(kOne) + 0.5f));
+        }
+
+        static inline float toFloat(const fixed& value)
+        {
+            return float(value) / float(kOne);
+        }
+
+        static inline fixed floor(const fixed& value)
+        {
+            return value & ~(kOne - 1);
+        }
+
+        static inline fixed ceil(const fixed& value)
+        {
+            return (value + kOne - 1) & ~(kOne - 1);
+        }
+
+        static inline fixed reciprocal(const int& segments)
+        {
+            return (segments > 0) ? fixed(std::floor(double(kOne) / double(segments) + 0.5)) : 0;
+        }
+
+        static inline int removeMSB(const int& value)
+        {
+            if(value <= 0)
+            {
+                return 0;
+            }
+
+            int msb = 1;
+
+            while((msb << 1) <= value)
+            {
+                msb <<= 1;
+            }
+
+            return value & ~msb;
+        }
+
+        // How a factor's points sit on one half of its edge: fractional factors lerp between the points
+        // of the integer factors on either side, the segments that grow splitting off at a point that
+        // depends only on the factor, so both halves mirror each other
+        struct Context
+        {
+            fixed fraction;         // Of the half factor
+            int   halfPoints;       // Points on one half, the middle one excluded
+            int   split;            // Points after it are one further along on the floor factor
+            fixed invFloor;         // 1 / segments of the floor and ceiling factors
+            fixed invCeil;
+        };
+
+        static Context context(const fixed& factor, const bool& odd)
+        {
+            Context ctx;
+
+            fixed half = (factor + 1) / 2;
+
+            // Half of an even factor of one is taken as one, as if it were two
+            if(odd || half == kHalf)
+            {
+                half += kHalf;
+            }
+
+            const fixed halfFloor = floor(half);
+            const fixed halfCeil  = ceil(half);
+
+            ctx.fraction   = half - halfFloor;
+            ctx.halfPoints = halfCeil >> kFractionBits;
+
+            if(halfCeil == halfFloor)
+            {
+                ctx.split = ctx.halfPoints + 1;
+            }
+            else if(odd)
+            {
+                ctx.split = (halfFloor == kOne) ? 0 : (removeMSB((halfFloor >> kFractionBits) - 1) << 1) + 1;
+            }
+            else
+            {
+                ctx.split = (removeMSB(halfFloor >> kFractionBits) << 1) + 1;
+            }
+
+            int floorSegments = (halfFloor * 2) >> kFractionBits;
+            int ceilSegments  = (halfCeil  * 2) >> kFractionBits;
+
+            if(odd)
+            {
+                floorSegments -= 1;
+                ceilSegments  -= 1;
+            }
+
+            ctx.invFloor = reciprocal(floorSegments);
+            ctx.invCeil  = reciprocal(ceilSegments);
+
+            return ctx;
+        }
+
+        // Points along an edge, both ends included
+        static int points(const fixed& factor, const bool& odd)
+        {
+            if(odd)
+            {
+                return (ceil(kHalf + (factor + 1) / 2) * 2) >> kFractionBits;
+            }
+
+            return ((ceil((factor + 1) / 2) * 2) >> kFractionBits) + 1;
+        }
+
+        // Position of a point along its edge, from 0 to 1
+        static fixed place(const Context& ctx, int point, const bool& odd)
+        {
+            bool flip = false;
+
+            if(point >= ctx.halfPoints)
+            {
+                point = (ctx.halfPoints << 1) - point;
+
+                if(odd)
+                {
+                    point -= 1;
+                }
+
+                flip = true;
+            }
+
+            // The middle can't be reached exactly by the products below
+            if(point == ctx.halfPoints)
+            {
+                return kHalf;
+            }
+
+            const int onCeil  = point;
+            const int onFloor = (point > ctx.split) ? (point - 1) : point;
+
+            const int64_t floorLocation = int64_t(onFloor) * ctx.invFloor;
+            const int64_t ceilLocation  = int64_t(onCeil)  * ctx.invCeil;
+
+            const int64_t location = floorLocation * (kOne - ctx.fraction) + ceilLocation * ctx.fraction;
+
+            const fixed result = fixed((location + kHalf) >> kFractionBits);
+
+            return flip ? (kOne - result) : result;
+        }
+    } // Tessellation
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Rings
+
+namespace AAPL
+{
+    namespace Tessellation
+    {
+        // A closed ring of points, stored one edge after another from its first corner
+        struct Ring
+        {
+            uint32_t start;
+            int      segments[4];
+            size_t   edges;
+        };
+
+        static inline uint32_t emit(Domain& rDomain, const fixed& u, const fixed& v)
+        {
+            rDomain.points.push_back({toFloat(u), toFloat(v)});
+
+            return uint32_t(rDomain.points.size() - 1);
+        }
+
+        // An edge's points from corner to corner, the next edge's first point closing it
+        static void edge(const Ring& ring, const size_t& e, std::vector<uint32_t>& rEdge)
+        {
+            uint32_t first = ring.start;
+
+            for(size_t i = 0; i < e; ++i)
+            {
+                first += uint32_t(ring.segments[i]);
+            }
+
+            rEdge.clear();
+
+            for(int i = 0; i < ring.segments[e]; ++i)
+            {
+                rEdge.push_back(first + uint32_t(i));
+            }
+
+            rEdge.push_back((e + 1 < ring.edges) ? (first + uint32_t(ring.segments[e])) : ring.start);
+        }
+
+        static inline void triangle(Domain& rDomain, const uint32_t& a, const uint32_t& b, const uint32_t& c)
+        {
+            rDomain.indices.push_back(a);
+            rDomain.indices.push_back(b);
+            rDomain.indices.push_back(c);
+        }
+
+        // How far along its polyline a point is, from 0 at the first point to 1 at the last
+        static inline float along(const Domain& rDomain, const std::vector<uint32_t>& line, const size_t& i)
+        {
+            const Point& first = rDomain.points[line.front()];
+            const Point& last  = rDomain.points[line.back()];
+            const Point& point = rDomain.points[line[i]];
+
+            const float du = last.u - first.u;
+            const float dv = last.v - first.v;
+
+            return ((point.u - first.u) * du + (point.v - first.v) * dv) / (du * du + dv * dv);
+        }
+
+        // Triangulate the band between an outer and an inner polyline running the same way, advancing
+        // on whichever is behind; every triangle takes one segment of either. Fractional factors bunch
+        // points up around their split points, so behind is by position rather than by count.
+        static void stitch(Domain& rDomain, const std::vector<uint32_t>& outer, const std::vector<uint32_t>& inner)
+        {
+            const size_t m = outer.size() - 1;
+            const size_t k = inner.size() - 1;
+
+            size_t i = 0;
+            size_t j = 0;
+
+            while(i < m || j < k)
+            {
+                if(j == k || (i < m && along(rDomain, outer, i + 1) <= along(rDomain, inner, j + 1)))
+                {
+                    triangle(rDomain, outer[i], outer[i + 1], inner[j]);
+
+                    ++i;
+                }
+                else
+                {
+                    triangle(rDomain, outer[i], inner[j + 1], inner[j]);
+
+                    ++j;
+                }
+            }
+        }
+
+        static void stitch(Domain& rDomain, const Ring& outer, const Ring& inner)
+        {
+            std::vector<uint32_t> a;
+            std::vector<uint32_t> b;
+
+            for(size_t e = 0; e < outer.edges; ++e)
+            {
+                edge(outer, e, a);
+                edge(inner, e, b);
+
+                stitch(rDomain, a, b);
+            }
+        }
+    } // Tessellation
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Factors
+
+struct AAPL::Tessellation::Tessellator::Factors
+{
+    bool    minimum;            // Every factor is one: the patch is a single triangle or quad
+
+    fixed   edge[4];
+    bool    edgeOdd[4];
+    Context edgeContext[4];
+    int     edgePoints[4];
+
+    fixed   inside[2];
+    bool    insideOdd[2];
+    Context insideContext[2];
+    int     insidePoints[2];
+};
+
+bool AAPL::Tessellation::Tessellator::process(const float* pEdges,
+                                              const float* pInside,
+                                              const size_t& edges,
+                                              const size_t& axes,
+                                              Factors& rFactors) const
+{
+    for(size_t e = 0; e < edges; ++e)
+    {
+        // NaN is culled too
+        if(!(pEdges[e] > 0.0f))
+        {
+            return false;
+        }
+    }
+
+    const bool integer = (mnPartition == Partition::eInteger) || (mnPartition == Partition::ePow2);
+    const bool odd     = (mnPartition == Partition::eFractionalOdd);
+
+    // Fractional odd tops out at the odd factor at or below the maximum, fractional even starts at two
+    const float oddMax = (std::fmod(mnMaxFactor, 2.0f) == 0.0f) ? (mnMaxFactor - 1.0f) : mnMaxFactor;
+
+    float lower = (mnPartition == Partition::eFractionalEven) ? 2.0f : 1.0f;
+    float upper = odd ? oddMax : mnMaxFactor;
+
+    auto round = [&](const float& factor)
+    {
+        float result = std::min(upper, std::max(lower, factor));
+
+        if(integer)
+        {
+            result = std::ceil(result);
+        }
+
+        if(mnPartition == Partition::ePow2)
+        {
+            float pow2 = 1.0f;
+
+            while(pow2 < result && pow2 * 2.0f <= upper)
+            {
+                pow2 *= 2.0f;
+            }
+
+            result = pow2;
+        }
+
+        return result;
+    };
+
+    float edge[4];
+    float inside[2];
+
+    bool frame = false;
+
+    for(size_t e = 0; e < edges; ++e)
+    {
+        edge[e] = round(pEdges[e]);
+
+        frame = frame || (edge[e] > 1.0f + 0.5f * kEpsilon);
+    }
+
+    for(size_t a = 0; a < axes; ++a)
+    {
+        frame = frame || (axes > 1 && pInside[a] > 1.0f + 0.5f * kEpsilon);
+    }
+
+    // With any edge above one, an odd inside has to be too, or there is no ring to stitch it to
+    if(odd && frame)
+    {
+        lower = 1.0f + kEpsilon;
+    }
+
+    for(size_t a = 0; a < axes; ++a)
+    {
+        inside[a] = round(pInside[a]);
+    }
+
+    bool ones = integer || odd;
+
+    for(size_t e = 0; e < edges; ++e)
+    {
+        rFactors.edge[e]    = toFixed(edge[e]);
+        rFactors.edgeOdd[e] = integer ? (int(edge[e]) & 1) != 0 : odd;
+
+        ones = ones && (rFactors.edge[e] == kOne);
+    }
+
+    for(size_t a = 0; a < axes; ++a)
+    {
+        rFactors.inside[a]    = toFixed(inside[a]);
+        rFactors.insideOdd[a] = integer ? ((int(inside[a]) & 1) != 0 && inside[a] != 1.0f) : odd;
+
+        ones = ones && (rFactors.inside[a] == kOne);
+    }
+
+    rFactors.minimum = ones;
+
+    for(size_t e = 0; e < edges; ++e)
+    {
+        rFactors.edgeContext[e] = context(rFactors.edge[e], rFactors.edgeOdd[e]);
+        rFactors.edgePoints[e]  = points(rFactors.edge[e], rFactors.edgeOdd[e]);
+    }
+
+    for(size_t a = 0; a < axes; ++a)
+    {
+        rFactors.insideContext[a] = context(rFactors.inside[a], rFactors.insideOdd[a]);
+
+        // An inside of one still leaves a degenerate ring to stitch the edges to
+        rFactors.insidePoints[a] = std::max(rFactors.insideOdd[a] ? 4 : 3,
+                                            points(rFactors.inside[a], rFactors.insideOdd[a]));
+    }
+
+    return true;
+}
+
+#pragma mark -
+#pragma mark Public - Tessellator
+
+AAPL::Tessellation::Tessellator::Tessellator(const uint32_t& partition, const float& maxFactor)
+: mnPartition(partition),
+  mnMaxFactor(maxFactor)
+{
+} // Constructor
+
+AAPL::Tessellation::Tessellator::~Tessellator()
+{
+} // Destructor
+
+void AAPL::Tessellation::Tessellator::setPartition(const uint32_t& partition)
+{
+    mnPartition = partition;
+}
+
+uint32_t AAPL::Tessellation::Tessellator::partition() const
+{
+    return mnPartition;
+}
+
+void AAPL::Tessellation::Tessellator::setMaxFactor(const float& maxFactor)
+{
+    mnMaxFactor = maxFactor;
+}
+
+float AAPL::Tessellation::Tessellator::maxFactor() const
+{
+    return mnMaxFactor;
+}
+
+bool AAPL::Tessellation::Tessellator::triangle(const float* pEdges, const float& inside, Domain& rDomain) const
+{
+    rDomain.points.clear();
+    rDomain.indices.clear();
+
+    Factors factors;
+
+    if(!process(pEdges, &inside, 3, 1, factors))
+    {
+        return false;
+    }
+
+    if(factors.minimum)
+    {
+        emit(rDomain, 0, kOne);
+        emit(rDomain, 0, 0);
+        emit(rDomain, kOne, 0);
+
+        Tessellation::triangle(rDomain, 0, 1, 2);
+
+        return true;
+    }
+
+    // Outer ring, from v == 1 down edge u == 0, along v == 0, back along w == 0
+    Ring outer = {0, {0, 0, 0, 0}, 3};
+
+    for(size_t e = 0; e < 3; ++e)
+    {
+        const int  last = factors.edgePoints[e] - 1;
+        const bool odd  = factors.edgeOdd[e];
+
+        for(int p = 0; p < last; ++p)
+        {
+            const fixed param = place(factors.edgeContext[e], (e & 1) ? p : (last - p), odd);
+
+            if(e == 0)
+            {
+                emit(rDomain, 0, param);
+            }
+            else
+            {
+                emit(rDomain, param, (e == 2) ? (kOne - param) : 0);
+            }
+        }
+
+        outer.segments[e] = last;
+    }
+
+    // Inner rings, each two points in from the one outside it and scaled to the barycentric triangle
+    const Context& ctx   = factors.insideContext[0];
+    const bool     odd   = factors.insideOdd[0];
+    const int      count = factors.insidePoints[0];
+    const int      rings = count >> 1;
+
+    Ring previous = outer;
+
+    for(int r = 1; r < rings; ++r)
+    {
+        const int last = count - 1 - r;
+
+        Ring ring = {uint32_t(rDomain.points.size()), {last - r, last - r, last - r, 0}, 3};
+
+        const fixed perp = fixed((int64_t(place(ctx, r, odd)) * kTwoThirds + kHalf) >> kFractionBits);
+        const fixed half = (perp + 1) / 2;
+
+        for(size_t e = 0; e < 3; ++e)
+        {
+            for(int p = r; p < last; ++p)
+            {
+                const fixed param = place(ctx, (e & 1) ? p : (last - (p - r)), odd);
+
+                if(e == 0)
+                {
+                    emit(rDomain, perp, param - half);
+                }
+                else
+                {
+                    emit(rDomain, param - half, (e == 2) ? (kOne - param - half) : perp);
+                }
+            }
+        }
+
+        stitch(rDomain, previous, ring);
+
+        previous = ring;
+    }
+
+    if(odd)
+    {
+        // The innermost ring is a single triangle
+        const uint32_t first = previous.start;
+
+        Tessellation::triangle(rDomain, first, first + 1, first + 2);
+    }
+    else
+    {
+        const std::vector<uint32_t> center(1, emit(rDomain, kOneThird, kOneThird));
+
+        std::vector<uint32_t> a;
+
+        for(size_t e = 0; e < 3; ++e)
+        {
+            edge(previous, e, a);
+
+            stitch(rDomain, a, center);
+        }
+    }
+
+    return true;
+}
+
+bool AAPL::Tessellation::Tessellator::quad(const float* pEdges, const float* pInside, Domain& rDomain) const
+{
+    rDomain.points.clear();
+    rDomain.indices.clear();
+
+    Factors factors;
+
+    if(!process(pEdges, pInside, 4, 2, factors))
+    {
+        return false;
+    }
+
+    if(factors.minimum)
+    {
+        emit(rDomain, 0, kOne);
+        emit(rDomain, 0, 0);
+        emit(rDomain, kOne, 0);
+        emit(rDomain, kOne, kOne);
+
+        Tessellation::triangle(rDomain, 0, 1, 2);
+        Tessellation::triangle(rDomain, 0, 2, 3);
+
+        return true;
+    }
+
+    // Outer ring, from (0, 1) up edge u == 0, along v == 0, down u == 1 and back along v == 1
+    Ring outer = {0, {0, 0, 0, 0}, 4};
+
+    for(size_t e = 0; e < 4; ++e)
+    {
+        const int  last    = factors.edgePoints[e] - 1;
+        const bool odd     = factors.edgeOdd[e];
+        const bool forward = (e == 1) || (e == 2);
+
+        for(int p = 0; p < last; ++p)
+        {
+            const fixed param = place(factors.edgeContext[e], forward ? p : (last - p), odd);
+
+            if(e & 1)
+            {
+                emit(rDomain, param, (e == 3) ? kOne : 0);
+            }
+            else
+            {
+                emit(rDomain, (e == 2) ? kOne : 0, param);
+            }
+        }
+
+        outer.segments[e] = last;
+    }
+
+    // Inner rings, as many as the axis with fewer points has room for
+    const int count[2] = {factors.insidePoints[0], factors.insidePoints[1]};
+    const int rings    = std::min(count[0], count[1]) >> 1;
+
+    Ring previous = outer;
+
+    for(int r = 1; r < rings; ++r)
+    {
+        const int last[2] = {count[0] - 1 - r, count[1] - 1 - r};
+
+        Ring ring = {uint32_t(rDomain.points.size()), {last[1] - r, last[0] - r, last[1] - r, last[0] - r}, 4};
+
+        for(size_t e = 0; e < 4; ++e)
+        {
+            // The axis the edge sits across, and the one it runs along
+            const size_t across  = e & 1;
+            const size_t along   = (e + 1) & 1;
+            const bool   forward = (e == 1) || (e == 2);
+
+            const fixed perp = place(factors.insideContext[across],
+                                     (e < 2) ? r : last[across],
+                                     factors.insideOdd[across]);
+
+            for(int p = r; p < last[along]; ++p)
+            {
+                const fixed param = place(factors.insideContext[along],
+                                          forward ? p : (last[along] - (p - r)),
+                                          factors.insideOdd[along]);
+
+                if(along)
+                {
+                    emit(rDomain, perp, param);
+                }
+                else
+                {
+                    emit(rDomain, param, perp);
+                }
+            }
+        }
+
+        stitch(rDomain, previous, ring);
+
+        previous = ring;
+    }
+
+    // The axis with fewer points ends either on a row of points through the middle, when it has an
+    // odd count, or on a strip one segment across
+    const size_t narrow = (count[0] > count[1]) ? 1 : 0;
+    const size_t wide   = 1 - narrow;
+
+    std::vector<uint32_t> a;
+    std::vector<uint32_t> b;
+
+    if(!factors.insideOdd[narrow])
+    {
+        std::vector<uint32_t> row;
+
+        const int last = count[wide] - 1 - rings;
+
+        for(int p = rings; p <= last; ++p)
+        {
+            if(narrow)
+            {
+                // A row along u, at v == 1/2
+                row.push_back(emit(rDomain, place(factors.insideContext[0], p, factors.insideOdd[0]), kHalf));
+            }
+            else
+            {
+                // A column along v, at u == 1/2, from v == 1 up
+                row.push_back(emit(rDomain, kHalf, place(factors.insideContext[1], last - (p - rings), factors.insideOdd[1])));
+            }
+        }
+
+        std::vector<uint32_t> reversed(row.rbegin(), row.rend());
+
+        for(size_t e = 0; e < 4; ++e)
+        {
+            edge(previous, e, a);
+
+            if(narrow)
+            {
+                // Edges 1 and 3 run along the row, 0 and 2 end at its two ends
+                if(e == 1)      b = row;
+                else if(e == 3) b = reversed;
+                else            b.assign(1, (e == 0) ? row.front() : row.back());
+            }
+            else
+            {
+                // Edges 0 and 2 run along the column, 1 and 3 end at its two ends
+                if(e == 0)      b = row;
+                else if(e == 2) b = reversed;
+                else            b.assign(1, (e == 1) ? row.back() : row.front());
+            }
+
+            stitch(rDomain, a, b);
+        }
+    }
+    else
+    {
+        // The two long edges of the strip face each other point for point
+        const size_t first = narrow ? 1 : 0;
+
+        edge(previous, first, a);
+        edge(previous, first + 2, b);
+
+        std::reverse(b.begin(), b.end());
+
+        stitch(rDomain, a, b);
+    }
+
+    return true;
+}
+
+size_t AAPL::Tessellation::Tessellator::triangleCount(const float* pEdges, const float& inside) const
+{
+    Factors factors;
+
+    if(!process(pEdges, &inside, 3, 1, factors))
+    {
+        return 0;
+    }
+
+    if(factors.minimum)
+    {
+        return 1;
+    }
+
+    const int count = factors.insidePoints[0];
+    const int rings = count >> 1;
+
+    // Every band triangle takes one segment off its outer or its inner edge
+    size_t triangles = 0;
+    size_t segments  = 0;
+
+    for(size_t e = 0; e < 3; ++e)
+    {
+        segments += size_t(factors.edgePoints[e] - 1);
+    }
+
+    for(int r = 1; r < rings; ++r)
+    {
+        const size_t inner = 3 * size_t(count - 1 - 2 * r);
+
+        triangles += segments + inner;
+        segments   = inner;
+    }
+
+    // The innermost ring closes with one triangle, or fans to the center point
+    return triangles + (factors.insideOdd[0] ? 1 : segments);
+}
+
+size_t AAPL::Tessellation::Tessellator::quadCount(const float* pEdges, const float* pInside) const
+{
+    Factors factors;
+
+    if(!process(pEdges, pInside, 4, 2, factors))
+    {
+        return 0;
+    }
+
+    if(factors.minimum)
+    {
+        return 2;
+    }
+
+    const int count[2] = {factors.insidePoints[0], factors.insidePoints[1]};
+    const int rings    = std::min(count[0], count[1]) >> 1;
+
+    size_t triangles = 0;
+    size_t segments  = 0;
+
+    for(size_t e = 0; e < 4; ++e)
+    {
+        segments += size_t(factors.edgePoints[e] - 1);
+    }
+
+    for(int r = 1; r < rings; ++r)
+    {
+        const size_t inner = 2 * size_t(count[0] - 1 - 2 * r) + 2 * size_t(count[1] - 1 - 2 * r);
+
+        triangles += segments + inner;
+        segments   = inner;
+    }
+
+    const size_t narrow = (count[0] > count[1]) ? 1 : 0;
+    const size_t wide   = 1 - narrow;
+
+    if(!factors.insideOdd[narrow])
+    {
+        // Both sides of the middle row
+        return triangles + segments + 2 * size_t(count[wide] - 1 - 2 * rings);
+    }
+
+    // A strip of one segment across
+    return triangles + 2 * size_t(count[wide] - 1 - 2 * (rings - 1));
+}
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2016 Apple Inc. All Rights Reserved.
+    See LICENSE.txt for this sample’s licensing information
+
+    Abstract:
+    CPU reference tessellator for triangle and quad patches, in every partition mode.
+            Factors are clamped and rounded as the render pipeline does, then laid out the way the fixed-function
+            tessellator lays them out: the outer ring carries each edge's own points, the inner rings the inside
+            factors', placed in 16.16 fixed point with fractional factors splitting their segments symmetrically
+            about each edge's middle. Rings are stitched edge by edge into triangles. The points are the
+            tessellator's; the diagonals of the stitching may differ, the number of triangles doesn't.
+ */
+
+#ifndef _AAPL_TESSELLATOR_H_
+#define _AAPL_TESSELLATOR_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AAPL
+{
+    namespace Tessellation
+    {
+        // MTLTessellationPartitionMode's values
+        namespace Partition
+        {
+            enum : uint32_t
+            {
+                ePow2 = 0,
+                eInteger,
+                eFractionalOdd,
+                eFractionalEven
+            };
+        } // Partition
+
+        // Position in the patch: u and v of a quad, or u and v of a triangle with w = 1 - u - v
+        struct Point
+        {
+            float u;
+            float v;
+        };
+
+        struct Domain
+        {
+            std::vector<Point>    points;
+            std::vector<uint32_t> indices;     // Three per triangle
+        };
+
+        class Tessellator
+        {
+        public:
+            Tessellator(const uint32_t& partition = Partition::eFractionalEven, const float& maxFactor = 64.0f);
+
+            virtual ~Tessellator();
+
+            void setPartition(const uint32_t& partition);
+
+            uint32_t partition() const;
+
+            // The render pipeline's maxTessellationFactor; fractional odd stops at the odd factor below
+            void setMaxFactor(const float& maxFactor);
+
+            float maxFactor() const;
+
+            // Edges u == 0, v == 0 and w == 0. False when the patch is culled, any edge factor being
+            // zero or NaN, and rDomain is left empty.
+            bool triangle(const float* pEdges, const float& inside, Domain& rDomain) const;
+
+            // Edges u == 0, v == 0, u == 1 and v == 1; inside along u, then along v
+            bool quad(const float* pEdges, const float* pInside, Domain& rDomain) const;
+
+            // Triangles the same factors tessellate into, counted without generating them
+            size_t triangleCount(const float* pEdges, const float& inside) const;
+            size_t quadCount(const float* pEdges, const float* pInside) const;
+
+        private:
+            struct Factors;
+
+            // Clamp, round and lay out the factors. False when the patch is culled.
+            bool process(const float* pEdges,
+                         const float* pInside,
+                         const size_t& edges,
+                         const size_t& axes,
+                         Factors& rFactors) const;
+
+        private:
+            uint32_t  mnPartition;
+            float     mnMaxFactor;
+        }; // Class Tessellator
+    } // Tessellation
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,461 @@
+/*
+    Copyright (C) 2016 Apple Inc. All Rights Reserved.
+    See LICENSE.txt for this sample’s licensing information
+
+    Abstract:
+    Test for the CPU tessellator and the adaptive factors, a standalone program that is not part of the app targets.
+            Across a sweep of edge and inside factors in every partition mode, the triangles of a patch must cover its
+            domain exactly once with one winding, every point must lie in the domain, and the count predicted without
+            generating must equal the triangles generated. The points on an edge must depend on that edge's factor
+            alone and read the same walked from either end, so two patches sharing the edge meet without a crack;
+            on a ground grid seen by a camera, the adaptive factors of every shared edge must be identical from both
+            patches. Zero and NaN edge factors must cull the patch. It then times the factors, the counts and the
+            generation for the grid, against a constant factor of 16 on the visible patches.
+
+        c++ -std=c++11 -O2 AAPLTessellator.cpp AAPLTessellationFactors.cpp AAPLTessellatorTest.cpp -o test
+        ./test
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include "AAPLTessellator.h"
+#include "AAPLTessellationFactors.h"
+
+using namespace AAPL::Tessellation;
+
+namespace
+{
+    const char* kPartitionNames[] = {"pow2", "integer", "fractional odd", "fractional even"};
+
+    const uint32_t kPartitionCount = 4;
+
+    // Patches per side of the ground grid
+    const int kGridSize = 128;
+
+    // Twice the signed area of a domain triangle
+    double area(const Domain& rDomain, const size_t& triangle)
+    {
+        const Point& a = rDomain.points[rDomain.indices[3 * triangle]];
+        const Point& b = rDomain.points[rDomain.indices[3 * triangle + 1]];
+        const Point& c = rDomain.points[rDomain.indices[3 * triangle + 2]];
+
+        return double(b.u - a.u) * double(c.v - a.v) - double(b.v - a.v) * double(c.u - a.u);
+    }
+
+    // The triangles tile the domain, a triangle of area 1/2 or the unit square, with one winding
+    bool covers(const Domain& rDomain, const bool& isTriangle)
+    {
+        const double expected = isTriangle ? 0.5 : 1.0;
+
+        for(const Point& rPoint : rDomain.points)
+        {
+            const bool inside = (rPoint.u >= 0.0f) && (rPoint.v >= 0.0f) &&
+                                (isTriangle ? (rPoint.u + rPoint.v <= 1.0f + 1.0e-5f) : ((rPoint.u <= 1.0f) && (rPoint.v <= 1.0f)));
+
+            if(!inside)
+            {
+                return false;
+            }
+        }
+
+        double sum      = 0.0;
+        size_t positive = 0;
+        size_t negative = 0;
+
+        for(size_t t = 0; t < rDomain.indices.size() / 3; ++t)
+        {
+            const double twice = area(rDomain, t);
+
+            positive += (twice > 2.0e-6) ? 1 : 0;
+            negative += (twice < -2.0e-6) ? 1 : 0;
+
+            sum += 0.5 * std::abs(twice);
+        }
+
+        return (std::abs(sum - expected) < 1.0e-4) && ((positive == 0) || (negative == 0));
+    }
+
+    // Positions along the edge u == 0 of a quad
+    std::multiset<float> edgePoints(const Domain& rDomain)
+    {
+        std::multiset<float> result;
+
+        for(const Point& rPoint : rDomain.points)
+        {
+            if(rPoint.u == 0.0f)
+            {
+                result.insert(rPoint.v);
+            }
+        }
+
+        return result;
+    }
+
+    size_t checkDomains()
+    {
+        size_t failures = 0;
+
+        Domain domain;
+
+        for(uint32_t partition = 0; partition < kPartitionCount; ++partition)
+        {
+            const Tessellator tessellator(partition, 64.0f);
+
+            for(float factor = 0.5f; factor <= 66.0f; factor += 0.37f)
+            {
+                // Edges and insides that differ from each other, and then all equal
+                const float edges[2][4]  = {{factor, factor * 0.7f + 1.0f, std::fmod(factor * 3.1f, 64.0f) + 0.1f, 64.0f - factor * 0.5f},
+                                            {factor, factor, factor, factor}};
+                const float insides[2][2] = {{factor * 0.9f, std::fmod(factor * 1.7f, 64.0f) + 0.2f},
+                                             {factor, factor}};
+
+                for(int set = 0; set < 2; ++set)
+                {
+                    const bool triangle = tessellator.triangle(edges[set], insides[set][0], domain);
+
+                    if(!triangle || !covers(domain, true) || (domain.indices.size() / 3 != tessellator.triangleCount(edges[set], insides[set][0])))
+                    {
+                        std::printf("%s triangle, factor %g: %s\n", kPartitionNames[partition], factor,
+                                    !triangle ? "culled" : !covers(domain, true) ? "doesn't cover its domain" : "count differs");
+
+                        failures++;
+                    }
+
+                    const bool quad = tessellator.quad(edges[set], insides[set], domain);
+
+                    if(!quad || !covers(domain, false) || (domain.indices.size() / 3 != tessellator.quadCount(edges[set], insides[set])))
+                    {
+                        std::printf("%s quad, factor %g: %s\n", kPartitionNames[partition], factor,
+                                    !quad ? "culled" : !covers(domain, false) ? "doesn't cover its domain" : "count differs");
+
+                        failures++;
+                    }
+                }
+            }
+        }
+
+        // An integer quad of factor n is n by n cells of two triangles
+        const Tessellator integer(Partition::eInteger, 64.0f);
+
+        for(int n = 1; n <= 64; ++n)
+        {
+            const float edges[4]  = {float(n), float(n), float(n), float(n)};
+            const float inside[2] = {float(n), float(n)};
+
+            if(integer.quadCount(edges, inside) != size_t(2 * n * n))
+            {
+                std::printf("Integer quad of factor %d: %zu triangles\n", n, integer.quadCount(edges, inside));
+
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+
+    size_t checkEdges()
+    {
+        size_t failures = 0;
+
+        Domain domain;
+
+        for(uint32_t partition = 0; partition < kPartitionCount; ++partition)
+        {
+            const Tessellator tessellator(partition, 64.0f);
+
+            for(float factor = 1.0f; factor <= 64.0f; factor += 0.13f)
+            {
+                const float edges[4]  = {factor, 3.0f, 3.0f, 3.0f};
+                const float inside[2] = {3.0f, 3.0f};
+
+                tessellator.quad(edges, inside, domain);
+
+                const std::multiset<float> points = edgePoints(domain);
+
+                // Walked from the other end, as the neighbouring patch walks it
+                std::multiset<float> reversed;
+
+                for(const float& v : points)
+                {
+                    reversed.insert(1.0f - v);
+                }
+
+                // Other factors of the patch must not move the edge's points
+                const float otherEdges[4]  = {factor, 17.5f, 1.0f, 40.2f};
+                const float otherInside[2] = {9.3f, 2.0f};
+
+                tessellator.quad(otherEdges, otherInside, domain);
+
+                if((points != reversed) || (points != edgePoints(domain)))
+                {
+                    std::printf("%s edge of factor %g: %s\n", kPartitionNames[partition], factor,
+                                (points != reversed) ? "not symmetric" : "moves with the other factors");
+
+                    failures++;
+
+                    break;
+                }
+            }
+        }
+
+        return failures;
+    }
+
+    size_t checkCulling()
+    {
+        size_t failures = 0;
+
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+
+        Domain domain;
+
+        for(uint32_t partition = 0; partition < kPartitionCount; ++partition)
+        {
+            const Tessellator tessellator(partition, 64.0f);
+
+            for(int edge = 0; edge < 4; ++edge)
+            {
+                for(const float& culled : {0.0f, nan})
+                {
+                    float edges[4]        = {3.0f, 5.0f, 7.0f, 9.0f};
+                    const float inside[2] = {4.0f, 6.0f};
+
+                    edges[edge] = culled;
+
+                    bool passes = !tessellator.quad(edges, inside, domain) && domain.indices.empty() && (tessellator.quadCount(edges, inside) == 0);
+
+                    if(edge < 3)
+                    {
+                        passes = passes && !tessellator.triangle(edges, inside[0], domain) && domain.indices.empty() &&
+                                 (tessellator.triangleCount(edges, inside[0]) == 0);
+                    }
+
+                    if(!passes)
+                    {
+                        std::printf("%s: edge %d of factor %g doesn't cull the patch\n", kPartitionNames[partition], edge, culled);
+
+                        failures++;
+                    }
+                }
+            }
+        }
+
+        return failures;
+    }
+
+    // Column major a times b
+    void multiply(const float* a, const float* b, float* pResult)
+    {
+        for(int column = 0; column < 4; ++column)
+        {
+            for(int row = 0; row < 4; ++row)
+            {
+                float sum = 0.0f;
+
+                for(int k = 0; k < 4; ++k)
+                {
+                    sum += a[k * 4 + row] * b[column * 4 + k];
+                }
+
+                pResult[column * 4 + row] = sum;
+            }
+        }
+    }
+
+    // A camera 2 units above a ground grid of unit quads, looking down the -z axis and tilted
+    // slightly down, with Metal's clip space depth of [0, 1]
+    AAPLTessellationUniforms groundCamera()
+    {
+        const float fov    = 60.0f * 3.14159265f / 180.0f;
+        const float aspect = 16.0f / 9.0f;
+        const float near   = 0.1f;
+        const float far    = 200.0f;
+        const float ys     = 1.0f / std::tan(fov / 2.0f);
+        const float pitch  = -0.25f;
+
+        const float projection[16]  = {ys / aspect, 0, 0, 0,  0, ys, 0, 0,  0, 0, far / (near - far), -1,  0, 0, near * far / (near - far), 0};
+        const float translation[16] = {1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, -2, 0, 1};
+        const float rotation[16]    = {1, 0, 0, 0,  0, std::cos(pitch), std::sin(pitch), 0,  0, -std::sin(pitch), std::cos(pitch), 0,  0, 0, 0, 1};
+
+        float view[16];
+
+        AAPLTessellationUniforms uniforms;
+
+        multiply(rotation, translation, view);
+        multiply(projection, view, uniforms.modelViewProjection);
+
+        uniforms.viewportSize[0]    = 1920.0f;
+        uniforms.viewportSize[1]    = 1080.0f;
+        uniforms.pixelsPerSegment   = 16.0f;
+        uniforms.maxFactor          = 64.0f;
+        uniforms.frontFacingWinding = 0;
+        uniforms.cullBackFaces      = 1;
+        uniforms.patchCount         = kGridSize * kGridSize;
+
+        return uniforms;
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 5; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+
+    size_t checkGrid()
+    {
+        size_t failures = 0;
+
+        std::vector<float4> controlPoints;
+
+        for(int j = 0; j < kGridSize; ++j)
+        {
+            for(int i = 0; i < kGridSize; ++i)
+            {
+                const float x0 = float(i - kGridSize / 2);
+                const float z0 = float(j - kGridSize / 2);
+
+                controlPoints.push_back({x0,        0.0f, z0,        1.0f});
+                controlPoints.push_back({x0 + 1.0f, 0.0f, z0,        1.0f});
+                controlPoints.push_back({x0 + 1.0f, 0.0f, z0 + 1.0f, 1.0f});
+                controlPoints.push_back({x0,        0.0f, z0 + 1.0f, 1.0f});
+            }
+        }
+
+        const AAPLTessellationUniforms uniforms = groundCamera();
+
+        std::vector<QuadFactors> factors(controlPoints.size() / 4);
+
+        size_t visible = 0;
+
+        const double factorTime = milliseconds([&] { visible = quadFactors(uniforms, controlPoints.data(), factors.data()); });
+
+        // Edge u == 1 of a patch is edge u == 0 of its right neighbour, v == 1 is v == 0 of the one behind
+        size_t shared     = 0;
+        size_t mismatched = 0;
+
+        for(int j = 0; j < kGridSize; ++j)
+        {
+            for(int i = 0; i < kGridSize; ++i)
+            {
+                const QuadFactors& rPatch = factors[size_t(j * kGridSize + i)];
+
+                if(rPatch.edge[0] == 0.0f)
+                {
+                    continue;
+                }
+
+                if((i + 1 < kGridSize) && (factors[size_t(j * kGridSize + i + 1)].edge[0] != 0.0f))
+                {
+                    shared++;
+                    mismatched += (std::memcmp(&rPatch.edge[2], &factors[size_t(j * kGridSize + i + 1)].edge[0], sizeof(float)) != 0) ? 1 : 0;
+                }
+
+                if((j + 1 < kGridSize) && (factors[size_t((j + 1) * kGridSize + i)].edge[0] != 0.0f))
+                {
+                    shared++;
+                    mismatched += (std::memcmp(&rPatch.edge[3], &factors[size_t((j + 1) * kGridSize + i)].edge[1], sizeof(float)) != 0) ? 1 : 0;
+                }
+            }
+        }
+
+        // Seen with the opposite winding in front, the whole grid faces away
+        AAPLTessellationUniforms flipped = uniforms;
+
+        flipped.frontFacingWinding = 1 - uniforms.frontFacingWinding;
+
+        const size_t visibleFlipped = quadFactors(flipped, controlPoints.data(), factors.data());
+
+        quadFactors(uniforms, controlPoints.data(), factors.data());
+
+        std::printf("Grid of %d patches: %zu visible, %zu with the winding flipped; %zu of %zu shared edges with different factors\n",
+                    kGridSize * kGridSize, visible, visibleFlipped, mismatched, shared);
+
+        if((visible == 0) || (visible == factors.size()) || (visibleFlipped != 0) || (shared == 0) || (mismatched != 0))
+        {
+            failures++;
+        }
+
+        std::printf("Factors for the grid: %.3f ms\n", factorTime);
+
+        for(const uint32_t& partition : {uint32_t(Partition::eInteger), uint32_t(Partition::eFractionalEven)})
+        {
+            const Tessellator tessellator(partition, 64.0f);
+
+            size_t counted   = 0;
+            size_t generated = 0;
+
+            Domain domain;
+
+            const double countTime = milliseconds([&]
+            {
+                counted = 0;
+
+                for(const QuadFactors& rPatch : factors)
+                {
+                    counted += tessellator.quadCount(rPatch.edge, rPatch.inside);
+                }
+            });
+
+            const double generateTime = milliseconds([&]
+            {
+                generated = 0;
+
+                for(const QuadFactors& rPatch : factors)
+                {
+                    if(tessellator.quad(rPatch.edge, rPatch.inside, domain))
+                    {
+                        generated += domain.indices.size() / 3;
+                    }
+                }
+            });
+
+            const float  constantEdges[4]  = {16.0f, 16.0f, 16.0f, 16.0f};
+            const float  constantInside[2] = {16.0f, 16.0f};
+            const size_t constant          = visible * tessellator.quadCount(constantEdges, constantInside);
+
+            std::printf("  %-16s %8zu triangles adaptive, %8zu at a constant 16 (%.1fx); counting %.3f ms, generating %.1f ms\n",
+                        kPartitionNames[partition], generated, constant, double(constant) / double(generated), countTime, generateTime);
+
+            if(counted != generated)
+            {
+                std::printf("  %zu triangles counted, %zu generated\n", counted, generated);
+
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+} // unnamed
+
+int main()
+{
+    size_t failures = 0;
+
+    failures += checkDomains();
+    failures += checkEdges();
+    failures += checkCulling();
+    failures += checkGrid();
+
+    std::printf("%zu failures\n", failures);
+
+    return (failures == 0) ? 0 : 1;
+}
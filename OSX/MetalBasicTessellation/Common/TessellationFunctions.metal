@@ -5,6 +5,7 @@
     Abstract:
     Tessellation functions for MetalBasicTessellation.
             The compute kernel populates a per-patch tessellation factors buffer.
+            The adaptive compute kernels derive each patch's factors from its projected edge lengths, and zero them for culled patches.
             The post-tessellation vertex function converts patch coordinates to display coordinates.
             The fragment function outputs a flat color for each vertex position.
  */
@@ -12,6 +13,8 @@
 #include <metal_stdlib>
 using namespace metal;
 
+#include "AAPLTessellationTypes.h"
+
 #pragma mark Structs
 
 // Control Point struct
@@ -62,6 +65,170 @@ kernel void tessellation_kernel_quad(constant float& edge_factor [[ buffer(0) ]]
     factors[pid].insideTessellationFactor[1] = inside_factor;
 }
 
+#pragma mark Adaptive Compute Kernels
+
+// Mirrors AAPLTessellationFactors.cpp operation for operation, so the CPU module predicts what these write
+
+// Clip-space w below which a point is taken to be behind the eye
+constant float kMinW = 1.0e-5;
+
+static float4 project(constant AAPLTessellationUniforms& uniforms, float4 p)
+{
+    constant float* m = uniforms.modelViewProjection;
+    
+    return float4(m[0] * p.x + m[4] * p.y + m[8]  * p.z + m[12] * p.w,
+                  m[1] * p.x + m[5] * p.y + m[9]  * p.z + m[13] * p.w,
+                  m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14] * p.w,
+                  m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15] * p.w);
+}
+
+static bool precedes(float4 a, float4 b)
+{
+    if(a.x != b.x) return a.x < b.x;
+    if(a.y != b.y) return a.y < b.y;
+    if(a.z != b.z) return a.z < b.z;
+    
+    return a.w < b.w;
+}
+
+// Projected length over the pixels a segment aims for. It depends on the edge's end points alone,
+// measured from the same end whichever patch asks, so neighbouring patches agree on it: no cracks.
+static float edge_factor(constant AAPLTessellationUniforms& uniforms, float4 p, float4 q)
+{
+    if(!(p.w > kMinW) || !(q.w > kMinW)) {
+        return uniforms.maxFactor;
+    }
+    
+    const bool swap = precedes(q, p);
+    const float4 a = swap ? q : p;
+    const float4 b = swap ? p : q;
+    
+    const float sx = 0.5 * uniforms.viewportSize[0];
+    const float sy = 0.5 * uniforms.viewportSize[1];
+    
+    const float dx = (a.x / a.w) * sx - (b.x / b.w) * sx;
+    const float dy = (a.y / a.w) * sy - (b.y / b.w) * sy;
+    
+    const float pixels = sqrt(dx * dx + dy * dy);
+    
+    return clamp(pixels / uniforms.pixelsPerSegment, 1.0, uniforms.maxFactor);
+}
+
+// All points outside one plane of Metal's clip volume: -w <= x <= w, -w <= y <= w, 0 <= z <= w
+static bool outside(thread const float4* clip, uint count)
+{
+    bool left = true, right = true, bottom = true, top = true, near = true, far = true;
+    
+    for(uint i = 0; i < count; ++i) {
+        const float4 p = clip[i];
+        left   = left   && (p.x < -p.w);
+        right  = right  && (p.x >  p.w);
+        bottom = bottom && (p.y < -p.w);
+        top    = top    && (p.y >  p.w);
+        near   = near   && (p.z <  0.0);
+        far    = far    && (p.z >  p.w);
+    }
+    
+    return left || right || bottom || top || near || far;
+}
+
+static bool back_facing(constant AAPLTessellationUniforms& uniforms, float4 a, float4 b, float4 c)
+{
+    if(!(a.w > kMinW) || !(b.w > kMinW) || !(c.w > kMinW)) {
+        return false;
+    }
+    
+    const float2 pa = a.xy / a.w;
+    const float2 pb = b.xy / b.w;
+    const float2 pc = c.xy / c.w;
+    
+    // Positive when counterclockwise
+    const float area = (pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x);
+    
+    return (uniforms.frontFacingWinding == 0) ? (area > 0.0) : (area < 0.0);
+}
+
+// Adaptive triangle compute kernel, one thread per patch
+kernel void tessellation_kernel_triangle_adaptive(constant AAPLTessellationUniforms& uniforms [[ buffer(0) ]],
+                                                  const device float4* control_points [[ buffer(1) ]],
+                                                  device MTLTriangleTessellationFactorsHalf* factors [[ buffer(2) ]],
+                                                  uint pid [[ thread_position_in_grid ]])
+{
+    if(pid >= uniforms.patchCount) {
+        return;
+    }
+    
+    const float4 clip[3] = {
+        project(uniforms, control_points[3 * pid + 0]),
+        project(uniforms, control_points[3 * pid + 1]),
+        project(uniforms, control_points[3 * pid + 2])
+    };
+    
+    // A zero edge factor tells the tessellator to drop the patch
+    if(outside(clip, 3) || (uniforms.cullBackFaces && back_facing(uniforms, clip[0], clip[1], clip[2]))) {
+        factors[pid].edgeTessellationFactor[0] = 0.0;
+        factors[pid].edgeTessellationFactor[1] = 0.0;
+        factors[pid].edgeTessellationFactor[2] = 0.0;
+        factors[pid].insideTessellationFactor = 0.0;
+        return;
+    }
+    
+    const float edge0 = edge_factor(uniforms, clip[1], clip[2]);
+    const float edge1 = edge_factor(uniforms, clip[2], clip[0]);
+    const float edge2 = edge_factor(uniforms, clip[0], clip[1]);
+    
+    factors[pid].edgeTessellationFactor[0] = edge0;
+    factors[pid].edgeTessellationFactor[1] = edge1;
+    factors[pid].edgeTessellationFactor[2] = edge2;
+    factors[pid].insideTessellationFactor = max(max(edge0, edge1), edge2);
+}
+
+// Adaptive quad compute kernel, one thread per patch
+kernel void tessellation_kernel_quad_adaptive(constant AAPLTessellationUniforms& uniforms [[ buffer(0) ]],
+                                              const device float4* control_points [[ buffer(1) ]],
+                                              device MTLQuadTessellationFactorsHalf* factors [[ buffer(2) ]],
+                                              uint pid [[ thread_position_in_grid ]])
+{
+    if(pid >= uniforms.patchCount) {
+        return;
+    }
+    
+    const float4 clip[4] = {
+        project(uniforms, control_points[4 * pid + 0]),
+        project(uniforms, control_points[4 * pid + 1]),
+        project(uniforms, control_points[4 * pid + 2]),
+        project(uniforms, control_points[4 * pid + 3])
+    };
+    
+    // A bilinear patch faces away only if both halves of its control cage do
+    const bool culled = outside(clip, 4) ||
+                        (uniforms.cullBackFaces &&
+                         back_facing(uniforms, clip[0], clip[1], clip[2]) &&
+                         back_facing(uniforms, clip[0], clip[2], clip[3]));
+    
+    if(culled) {
+        factors[pid].edgeTessellationFactor[0] = 0.0;
+        factors[pid].edgeTessellationFactor[1] = 0.0;
+        factors[pid].edgeTessellationFactor[2] = 0.0;
+        factors[pid].edgeTessellationFactor[3] = 0.0;
+        factors[pid].insideTessellationFactor[0] = 0.0;
+        factors[pid].insideTessellationFactor[1] = 0.0;
+        return;
+    }
+    
+    const float edge0 = edge_factor(uniforms, clip[3], clip[0]);
+    const float edge1 = edge_factor(uniforms, clip[0], clip[1]);
+    const float edge2 = edge_factor(uniforms, clip[1], clip[2]);
+    const float edge3 = edge_factor(uniforms, clip[2], clip[3]);
+    
+    factors[pid].edgeTessellationFactor[0] = edge0;
+    factors[pid].edgeTessellationFactor[1] = edge1;
+    factors[pid].edgeTessellationFactor[2] = edge2;
+    factors[pid].edgeTessellationFactor[3] = edge3;
+    factors[pid].insideTessellationFactor[0] = max(edge1, edge3);
+    factors[pid].insideTessellationFactor[1] = max(edge0, edge2);
+}
+
 #pragma mark Post-Tessellation Vertex Functions
 
 // Triangle post-tessellation vertex function
@@ -0,0 +1,494 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Frame pacing and stall instrumentation. Scoped timers record begin and end timestamps into a ring
+ owned by the recording thread (single producer, no locks, no allocation); collect() drains every
+ ring into per-category histograms and a trace that exports to the Chrome trace JSON format
+ (chrome://tracing, Perfetto). Predefined categories cover the in-flight semaphore wait, the
+ scene update and command encoding.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+#include "AAPLFrameProfiler.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace AAPL
+{
+    namespace Profile
+    {
+        // Lane of events recorded with recordExternal
+        static const uint32_t kExternalThread = 0;
+
+        static std::atomic<uint64_t> gnProfilers(0);
+
+        static uint64_t clockNanoseconds()
+        {
+            return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static size_t highestBit(const uint64_t& value)
+        {
+            size_t bit = 0;
+
+            while((value >> bit) > 1)
+            {
+                ++bit;
+            }
+
+            return bit;
+        }
+
+        static void writeString(std::ostream& rStream, const std::string& value)
+        {
+            rStream << '"';
+
+            for(const char& c : value)
+            {
+                if((c == '"') || (c == '\\'))
+                {
+                    rStream << '\\' << c;
+                }
+                else if(static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+
+                    rStream << escaped;
+                }
+                else
+                {
+                    rStream << c;
+                }
+            }
+
+            rStream << '"';
+        }
+
+        // Microseconds with nanosecond digits, as the trace format expects
+        static void writeMicroseconds(std::ostream& rStream, const uint64_t& nanoseconds)
+        {
+            char text[32];
+
+            std::snprintf(text, sizeof(text), "%llu.%03llu",
+                          static_cast<unsigned long long>(nanoseconds / 1000),
+                          static_cast<unsigned long long>(nanoseconds % 1000));
+
+            rStream << text;
+        }
+
+        // Profiler identifier and ring of the calling thread, one entry per profiler used
+        struct RingCache
+        {
+            uint64_t profiler;
+            void*    pRing;
+        };
+
+        static thread_local std::vector<RingCache> g_RingCache;
+    } // Profile
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Ring
+
+// Single producer (the owning thread), single consumer (collect under the profiler mutex)
+struct AAPL::Profile::Profiler::Ring
+{
+    std::vector<Event>    events;
+    std::atomic<uint64_t> head;     // Next event to write
+    std::atomic<uint64_t> tail;     // Next event to read
+    uint32_t              thread;
+    std::string           name;
+
+    Ring(const size_t& capacity, const uint32_t& index)
+    : events(capacity), head(0), tail(0), thread(index)
+    {
+        char text[32];
+
+        std::snprintf(text, sizeof(text), "Thread %u", index);
+
+        name = text;
+    }
+};
+
+#pragma mark -
+#pragma mark Public - Histogram
+
+AAPL::Profile::Histogram::Histogram()
+: m_Counts(kBuckets, 0),
+  mnCount(0),
+  mnMin(std::numeric_limits<uint64_t>::max()),
+  mnMax(0),
+  mnSum(0.0)
+{
+}
+
+size_t AAPL::Profile::Histogram::bucket(const uint64_t& value)
+{
+    if(value < kSubBuckets)
+    {
+        return size_t(value);
+    }
+
+    const size_t exponent = highestBit(value);
+    const size_t sub      = size_t(value >> (exponent - 3)) & (kSubBuckets - 1);
+
+    return (exponent - 2) * kSubBuckets + sub;
+}
+
+uint64_t AAPL::Profile::Histogram::upperBound(const size_t& bucket)
+{
+    if(bucket < kSubBuckets)
+    {
+        return bucket;
+    }
+
+    const size_t   exponent = bucket / kSubBuckets + 2;
+    const uint64_t lower    = uint64_t(kSubBuckets + bucket % kSubBuckets) << (exponent - 3);
+
+    return lower + (uint64_t(1) << (exponent - 3)) - 1;
+}
+
+void AAPL::Profile::Histogram::add(const uint64_t& nanoseconds)
+{
+    m_Counts[bucket(nanoseconds)]++;
+
+    mnCount++;
+    mnMin  = std::min(mnMin, nanoseconds);
+    mnMax  = std::max(mnMax, nanoseconds);
+    mnSum += double(nanoseconds);
+}
+
+void AAPL::Profile::Histogram::merge(const Histogram& rOther)
+{
+    for(size_t i = 0; i < kBuckets; ++i)
+    {
+        m_Counts[i] += rOther.m_Counts[i];
+    }
+
+    mnCount += rOther.mnCount;
+    mnMin    = std::min(mnMin, rOther.mnMin);
+    mnMax    = std::max(mnMax, rOther.mnMax);
+    mnSum   += rOther.mnSum;
+}
+
+uint64_t AAPL::Profile::Histogram::count() const
+{
+    return mnCount;
+}
+
+double AAPL::Profile::Histogram::mean() const
+{
+    return (mnCount > 0) ? (mnSum / double(mnCount)) : 0.0;
+}
+
+uint64_t AAPL::Profile::Histogram::min() const
+{
+    return (mnCount > 0) ? mnMin : 0;
+}
+
+uint64_t AAPL::Profile::Histogram::max() const
+{
+    return mnMax;
+}
+
+uint64_t AAPL::Profile::Histogram::percentile(const double& fraction) const
+{
+    if(mnCount == 0)
+    {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::min(1.0, std::max(0.0, fraction)) * double(mnCount) + 0.5));
+
+    uint64_t seen = 0;
+
+    for(size_t i = 0; i < kBuckets; ++i)
+    {
+        seen += m_Counts[i];
+
+        if(seen >= rank)
+        {
+            return std::max(mnMin, std::min(upperBound(i), mnMax));
+        }
+    }
+
+    return mnMax;
+}
+
+#pragma mark -
+#pragma mark Public - Profiler
+
+AAPL::Profile::Profiler::Profiler(const size_t& ringCapacity)
+: mnCapacity(std::max<size_t>(ringCapacity, 16)),
+  mnIdentifier(gnProfilers.fetch_add(1) + 1),
+  mbEnabled(true),
+  mnEpoch(clockNanoseconds()),
+  mnDropped(0),
+  mnTraceLimit(1 << 20)
+{
+    m_Categories.push_back("Semaphore wait");
+    m_Categories.push_back("Update");
+    m_Categories.push_back("Encode");
+    m_Categories.push_back("Frame");
+    m_Categories.push_back("GPU");
+    m_Categories.push_back("Assets");
+
+    m_Histograms.resize(m_Categories.size());
+}
+
+AAPL::Profile::Profiler::~Profiler()
+{
+}
+
+AAPL::Profile::Profiler& AAPL::Profile::Profiler::shared()
+{
+    static Profiler profiler;
+
+    return profiler;
+}
+
+void AAPL::Profile::Profiler::setEnabled(const bool& enabled)
+{
+    mbEnabled.store(enabled);
+}
+
+uint32_t AAPL::Profile::Profiler::category(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    const std::vector<std::string>::iterator found = std::find(m_Categories.begin(), m_Categories.end(), name);
+
+    if(found != m_Categories.end())
+    {
+        return uint32_t(found - m_Categories.begin());
+    }
+
+    m_Categories.push_back(name);
+    m_Histograms.resize(m_Categories.size());
+
+    return uint32_t(m_Categories.size() - 1);
+}
+
+void AAPL::Profile::Profiler::setThreadName(const std::string& name)
+{
+    Ring* pRing = ring();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    pRing->name = name;
+}
+
+uint64_t AAPL::Profile::Profiler::now() const
+{
+    return clockNanoseconds() - mnEpoch;
+}
+
+void AAPL::Profile::Profiler::record(const uint32_t& category, const uint64_t& begin, const uint64_t& end)
+{
+    Ring* pRing = ring();
+
+    const uint64_t head = pRing->head.load(std::memory_order_relaxed);
+
+    if(head - pRing->tail.load(std::memory_order_acquire) >= mnCapacity)
+    {
+        mnDropped.fetch_add(1, std::memory_order_relaxed);
+
+        return;
+    }
+
+    Event& rEvent = pRing->events[size_t(head % mnCapacity)];
+
+    rEvent.begin    = begin;
+    rEvent.end      = std::max(begin, end);
+    rEvent.category = category;
+    rEvent.thread   = pRing->thread;
+
+    pRing->head.store(head + 1, std::memory_order_release);
+}
+
+void AAPL::Profile::Profiler::recordExternal(const uint32_t& category, const uint64_t& begin, const uint64_t& end)
+{
+    if(!isEnabled())
+    {
+        return;
+    }
+
+    const Event event = {begin, std::max(begin, end), category, kExternalThread};
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    append(event);
+}
+
+void AAPL::Profile::Profiler::collect()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for(const std::shared_ptr<Ring>& rRing : m_Rings)
+    {
+        const uint64_t tail = rRing->tail.load(std::memory_order_relaxed);
+        const uint64_t head = rRing->head.load(std::memory_order_acquire);
+
+        for(uint64_t i = tail; i < head; ++i)
+        {
+            append(rRing->events[size_t(i % mnCapacity)]);
+        }
+
+        rRing->tail.store(head, std::memory_order_release);
+    }
+}
+
+AAPL::Profile::Histogram AAPL::Profile::Profiler::histogram(const uint32_t& category) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return (category < m_Histograms.size()) ? m_Histograms[category] : Histogram();
+}
+
+uint64_t AAPL::Profile::Profiler::dropped() const
+{
+    return mnDropped.load();
+}
+
+void AAPL::Profile::Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Histograms.assign(m_Categories.size(), Histogram());
+    m_Trace.clear();
+
+    mnDropped.store(0);
+}
+
+void AAPL::Profile::Profiler::setTraceLimit(const size_t& events)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    mnTraceLimit = events;
+}
+
+void AAPL::Profile::Profiler::exportChromeTrace(std::ostream& rStream) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    rStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    rStream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << kExternalThread
+            << ",\"args\":{\"name\":\"External\"}}";
+
+    for(const std::shared_ptr<Ring>& rRing : m_Rings)
+    {
+        rStream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << rRing->thread << ",\"args\":{\"name\":";
+
+        writeString(rStream, rRing->name);
+
+        rStream << "}}";
+    }
+
+    for(const Event& rEvent : m_Trace)
+    {
+        rStream << ",\n{\"name\":";
+
+        writeString(rStream, m_Categories[rEvent.category]);
+
+        rStream << ",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":" << rEvent.thread << ",\"ts\":";
+
+        writeMicroseconds(rStream, rEvent.begin);
+
+        rStream << ",\"dur\":";
+
+        writeMicroseconds(rStream, rEvent.end - rEvent.begin);
+
+        rStream << "}";
+    }
+
+    rStream << "\n]}\n";
+}
+
+void AAPL::Profile::Profiler::summary(std::ostream& rStream) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    char line[256];
+
+    std::snprintf(line, sizeof(line), "%-20s %8s %9s %9s %9s %9s %9s\n", "category", "count", "mean", "p50", "p90", "p99", "max");
+
+    rStream << line;
+
+    for(size_t i = 0; i < m_Categories.size(); ++i)
+    {
+        const Histogram& rHistogram = m_Histograms[i];
+
+        if(rHistogram.count() == 0)
+        {
+            continue;
+        }
+
+        std::snprintf(line, sizeof(line), "%-20s %8llu %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+                      m_Categories[i].c_str(),
+                      static_cast<unsigned long long>(rHistogram.count()),
+                      rHistogram.mean() * 1e-6,
+                      double(rHistogram.percentile(0.50)) * 1e-6,
+                      double(rHistogram.percentile(0.90)) * 1e-6,
+                      double(rHistogram.percentile(0.99)) * 1e-6,
+                      double(rHistogram.max()) * 1e-6);
+
+        rStream << line;
+    }
+}
+
+#pragma mark -
+#pragma mark Private - Profiler
+
+AAPL::Profile::Profiler::Ring* AAPL::Profile::Profiler::ring()
+{
+    for(const RingCache& rEntry : g_RingCache)
+    {
+        if(rEntry.profiler == mnIdentifier)
+        {
+            return static_cast<Ring*>(rEntry.pRing);
+        }
+    }
+
+    // First event of this thread: the ring is owned by the profiler and outlives the thread
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Rings.push_back(std::make_shared<Ring>(mnCapacity, uint32_t(m_Rings.size() + 1)));
+
+    g_RingCache.push_back({mnIdentifier, m_Rings.back().get()});
+
+    return m_Rings.back().get();
+}
+
+// Called with the mutex held
+void AAPL::Profile::Profiler::append(const Event& rEvent)
+{
+    // Unregistered categories have no name to export
+    if(rEvent.category >= m_Histograms.size())
+    {
+        return;
+    }
+
+    m_Histograms[rEvent.category].add(rEvent.end - rEvent.begin);
+
+    if(mnTraceLimit == 0)
+    {
+        return;
+    }
+
+    // Keep the most recent events
+    if(m_Trace.size() >= mnTraceLimit)
+    {
+        m_Trace.erase(m_Trace.begin(), m_Trace.begin() + std::max<size_t>(1, mnTraceLimit / 4));
+    }
+
+    m_Trace.push_back(rEvent);
+}
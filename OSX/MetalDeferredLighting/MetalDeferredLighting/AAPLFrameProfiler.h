@@ -0,0 +1,195 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Frame pacing and stall instrumentation. Scoped timers record begin and end timestamps into a ring
+ owned by the recording thread (single producer, no locks, no allocation); collect() drains every
+ ring into per-category histograms and a trace that exports to the Chrome trace JSON format
+ (chrome://tracing, Perfetto). Predefined categories cover the in-flight semaphore wait, the
+ scene update, asset uploads and command encoding.
+ */
+
+#ifndef _AAPL_FRAME_PROFILER_H_
+#define _AAPL_FRAME_PROFILER_H_
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace AAPL
+{
+    namespace Profile
+    {
+        // Predefined categories
+        enum Category
+        {
+            eCategorySemaphoreWait = 0,     // Wait for an in-flight frame slot, e.g. FrameRing::beginFrame
+            eCategoryUpdate,                // Scene and constant buffer update
+            eCategoryEncode,                // Command buffer encoding
+            eCategoryFrame,                 // Whole CPU frame
+            eCategoryGPU,                   // GPUStartTime to GPUEndTime of a command buffer
+            eCategoryAssets,                // Asset polling and resource uploads
+            eCategoryCount
+        };
+
+        struct Event
+        {
+            uint64_t begin;         // Nanoseconds since the profiler started
+            uint64_t end;
+            uint32_t category;
+            uint32_t thread;
+        };
+
+        // Log-linear histogram of durations in nanoseconds, 8 sub-buckets per power of two
+        // (at most 12.5% relative error on percentiles)
+        class Histogram
+        {
+        public:
+            Histogram();
+
+            void add(const uint64_t& nanoseconds);
+            void merge(const Histogram& rOther);
+
+            uint64_t count() const;
+            double   mean() const;      // Nanoseconds
+            uint64_t min() const;
+            uint64_t max() const;
+
+            // Upper bound of the bucket holding the given fraction of samples
+            uint64_t percentile(const double& fraction) const;
+
+        private:
+            static const size_t kSubBuckets = 8;
+            static const size_t kBuckets    = 64 * kSubBuckets;
+
+            static size_t   bucket(const uint64_t& value);
+            static uint64_t upperBound(const size_t& bucket);
+
+            std::vector<uint64_t> m_Counts;
+            uint64_t              mnCount;
+            uint64_t              mnMin;
+            uint64_t              mnMax;
+            double                mnSum;
+        }; // Histogram
+
+        class Profiler
+        {
+        public:
+            // Events per thread ring; a full ring drops new events until collect() runs
+            explicit Profiler(const size_t& ringCapacity = 16384);
+
+            virtual ~Profiler();
+
+            Profiler(const Profiler&) = delete;
+            Profiler& operator=(const Profiler&) = delete;
+
+            // Profiler used by the AAPL_PROFILE_SCOPE macro
+            static Profiler& shared();
+
+            void setEnabled(const bool& enabled);
+            bool isEnabled() const { return mbEnabled.load(std::memory_order_relaxed); }
+
+            // Register a category by name (e.g. "Shadow pass"); names are looked up once
+            uint32_t category(const std::string& name);
+
+            // Name the calling thread in the trace
+            void setThreadName(const std::string& name);
+
+            // Current timestamp on the profiler clock
+            uint64_t now() const;
+
+            // Record an interval on the calling thread without locking
+            void record(const uint32_t& category, const uint64_t& begin, const uint64_t& end);
+
+            // Record an interval measured elsewhere, e.g. GPU times of a completed command buffer
+            // converted to the profiler clock; takes a lock and goes to a shared lane of the trace
+            void recordExternal(const uint32_t& category, const uint64_t& begin, const uint64_t& end);
+
+            // Drain every thread ring into the histograms and the trace
+            void collect();
+
+            // Histogram of a category, as of the last collect()
+            Histogram histogram(const uint32_t& category) const;
+
+            // Events dropped because a ring was full
+            uint64_t dropped() const;
+
+            // Discard histograms and trace events
+            void reset();
+
+            // Chrome trace JSON of the collected events (at most traceLimit are kept)
+            void exportChromeTrace(std::ostream& rStream) const;
+
+            // One line per category: count, mean, p50, p90, p99 and max in milliseconds
+            void summary(std::ostream& rStream) const;
+
+            void setTraceLimit(const size_t& events);
+
+        private:
+            struct Ring;
+
+            Ring* ring();
+
+            void append(const Event& rEvent);
+
+            const size_t                       mnCapacity;
+            const uint64_t                     mnIdentifier;   // Never reused, keys the thread local ring cache
+            std::atomic<bool>                  mbEnabled;
+            const uint64_t                     mnEpoch;
+            std::atomic<uint64_t>              mnDropped;
+
+            mutable std::mutex                 m_Mutex;
+            std::vector<std::shared_ptr<Ring>> m_Rings;
+            std::vector<std::string>           m_Categories;
+            std::vector<Histogram>             m_Histograms;
+            std::vector<Event>                 m_Trace;
+            size_t                             mnTraceLimit;
+        }; // Profiler
+
+        // Records the lifetime of the scope
+        class Scope
+        {
+        public:
+            Scope(Profiler& rProfiler, const uint32_t& category)
+            : mpProfiler(rProfiler.isEnabled() ? &rProfiler : nullptr),
+              mnCategory(category),
+              mnBegin(mpProfiler ? rProfiler.now() : 0)
+            {
+            }
+
+            ~Scope()
+            {
+                if(mpProfiler)
+                {
+                    mpProfiler->record(mnCategory, mnBegin, mpProfiler->now());
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Profiler* mpProfiler;
+            uint32_t  mnCategory;
+            uint64_t  mnBegin;
+        }; // Scope
+    } // Profile
+} // AAPL
+
+#define AAPL_PROFILE_CONCAT_(a, b) a##b
+#define AAPL_PROFILE_CONCAT(a, b)  AAPL_PROFILE_CONCAT_(a, b)
+
+// Time the enclosing scope under a predefined category or a registered category id
+#define AAPL_PROFILE_SCOPE(category) \
+    AAPL::Profile::Scope AAPL_PROFILE_CONCAT(_aaplProfileScope, __LINE__)(AAPL::Profile::Profiler::shared(), (category))
+
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Headless harness for the frame profiler, a standalone program that is not part of the app target.
+ It runs the render loop of AAPLRenderer against a synthetic workload: the frame waits for its slot
+ in a frame ring, spins through the asset poll and the update and encodes on two threads, and a
+ mock GPU thread completes every frame a few milliseconds later and records its GPU time. It prints
+ the summary of every category and writes the Chrome trace, then times a scope with the profiler
+ enabled and disabled and checks the histogram percentiles.
+
+     c++ -std=c++11 -O2 -pthread AAPLFrameProfiler.cpp AAPLFrameRing.cpp AAPLFrameProfilerBenchmark.cpp -o benchmark
+     ./benchmark [frames] [trace.json]
+ */
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "AAPLFrameProfiler.h"
+#include "AAPLFrameRing.h"
+
+using namespace AAPL;
+using namespace AAPL::Profile;
+
+namespace
+{
+    // Keep the thread busy, as encoding does
+    void spin(Profiler& rProfiler, const uint64_t& nanoseconds)
+    {
+        const uint64_t end = rProfiler.now() + nanoseconds;
+
+        while(rProfiler.now() < end)
+        {
+        }
+    }
+
+    // Completes the submitted frames 6 to 10 ms after they were submitted, in order
+    class MockGPU
+    {
+    public:
+        MockGPU(Profiler& rProfiler, FrameRing& rRing)
+        : mrProfiler(rProfiler),
+          mrRing(rRing),
+          mbStop(false),
+          m_Thread(&MockGPU::run, this)
+        {
+        }
+
+        ~MockGPU()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                mbStop = true;
+            }
+
+            m_Condition.notify_one();
+            m_Thread.join();
+        }
+
+        void submit(const uint64_t& frame)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                m_Queue.push_back(frame);
+            }
+
+            m_Condition.notify_one();
+        }
+
+    private:
+        void run()
+        {
+            std::mt19937 random(1);
+
+            for(;;)
+            {
+                uint64_t frame = 0;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+
+                    m_Condition.wait(lock, [this] { return mbStop || !m_Queue.empty(); });
+
+                    if(m_Queue.empty())
+                    {
+                        return;
+                    }
+
+                    frame = m_Queue.front();
+
+                    m_Queue.pop_front();
+                }
+
+                const uint64_t begin = mrProfiler.now();
+
+                std::this_thread::sleep_for(std::chrono::microseconds(6000 + random() % 4000));
+
+                // As the completion handler would, from GPUStartTime and GPUEndTime
+                mrProfiler.recordExternal(eCategoryGPU, begin, mrProfiler.now());
+
+                mrRing.complete(frame);
+            }
+        }
+
+        Profiler&                mrProfiler;
+        FrameRing&               mrRing;
+        bool                     mbStop;
+        std::mutex               m_Mutex;
+        std::condition_variable  m_Condition;
+        std::deque<uint64_t>     m_Queue;
+        std::thread              m_Thread;
+    }; // MockGPU
+
+    void runFrames(const size_t& frames)
+    {
+        Profiler& rProfiler = Profiler::shared();
+
+        rProfiler.setThreadName("Render");
+
+        const uint32_t shadow = rProfiler.category("Shadow pass");
+
+        FrameRing ring(3, 1 << 16);
+
+        {
+            MockGPU gpu(rProfiler, ring);
+
+            for(size_t frame = 0; frame < frames; ++frame)
+            {
+                AAPL_PROFILE_SCOPE(eCategoryFrame);
+
+                {
+                    AAPL_PROFILE_SCOPE(eCategorySemaphoreWait);
+
+                    ring.beginFrame();
+                }
+
+                {
+                    AAPL_PROFILE_SCOPE(eCategoryAssets);
+
+                    spin(rProfiler, 300000);
+                }
+
+                {
+                    AAPL_PROFILE_SCOPE(eCategoryUpdate);
+
+                    spin(rProfiler, 1500000);
+                }
+
+                {
+                    AAPL_PROFILE_SCOPE(eCategoryEncode);
+
+                    std::thread encoder([&] {
+                        AAPL_PROFILE_SCOPE(shadow);
+
+                        spin(rProfiler, 500000);
+                    });
+
+                    spin(rProfiler, 1000000);
+
+                    encoder.join();
+                }
+
+                gpu.submit(ring.endFrame());
+
+                if(frame % 60 == 59)
+                {
+                    rProfiler.collect();
+                }
+            }
+        }
+
+        rProfiler.collect();
+    }
+
+    bool checkHistogram()
+    {
+        Histogram histogram;
+
+        for(uint64_t value = 1; value <= 100000; ++value)
+        {
+            histogram.add(value);
+        }
+
+        const uint64_t p50 = histogram.percentile(0.5);
+        const uint64_t p99 = histogram.percentile(0.99);
+
+        std::printf("histogram of 1 to 100000: p50 %llu, p99 %llu, max %llu\n",
+                    (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)histogram.max());
+
+        // Buckets are at most 12.5% wide
+        return (p50 >= 50000) && (p50 <= 56250) && (p99 >= 99000) && (p99 <= 111375) && (histogram.max() == 100000);
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t frames = (argc >= 2) ? size_t(std::atol(argv[1])) : 300;
+
+    runFrames(frames);
+
+    Profiler::shared().summary(std::cout);
+
+    if(argc >= 3)
+    {
+        std::ofstream trace(argv[2]);
+
+        Profiler::shared().exportChromeTrace(trace);
+    }
+
+    // A scope costs two clock reads and a ring write when enabled, one branch when disabled
+    Profiler profiler;
+
+    const int scopes = 1000000;
+
+    uint64_t start = profiler.now();
+
+    for(int i = 0; i < scopes; ++i)
+    {
+        Scope scope(profiler, eCategoryUpdate);
+
+        if((i & 4095) == 0)
+        {
+            profiler.collect();
+        }
+    }
+
+    const double enabled = double(profiler.now() - start) / double(scopes);
+
+    profiler.collect();
+    profiler.setEnabled(false);
+
+    start = profiler.now();
+
+    for(int i = 0; i < scopes; ++i)
+    {
+        Scope scope(profiler, eCategoryUpdate);
+    }
+
+    const double disabled = double(profiler.now() - start) / double(scopes);
+
+    std::printf("scope: %.1f ns enabled, %.1f ns disabled, %llu events dropped\n",
+                enabled, disabled, (unsigned long long)profiler.dropped());
+
+    return checkHistogram() ? 0 : 1;
+}
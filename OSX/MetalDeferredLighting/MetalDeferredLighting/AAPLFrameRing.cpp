@@ -0,0 +1,220 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Frame ring sub-allocator for per-frame uniform data. Instead of one array of kMaxFrameLag buffers
+ per kind of data, every frame slot is one large mapped allocation. Encoding threads bump-allocate
+ from the current slot without locks, each allocation aligned for the kind of data it holds, and a
+ slot is handed out again only after the command buffers of the frame that used it completed.
+ */
+
+#include <algorithm>
+
+#include "AAPLFrameRing.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace AAPL
+{
+    static size_t alignUp(const size_t& value, const size_t& align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Ring
+
+AAPL::FrameRing::FrameRing(const std::vector<Slot>& slots)
+: m_Slots(slots),
+  mnOffset(0),
+  mnSlot(0),
+  mnFrame(0),
+  m_Busy(slots.size(), false),
+  m_SlotFrame(slots.size(), 0),
+  mnAllocations(0),
+  mnFailed(0)
+{
+    m_Stats = Stats();
+
+    m_Stats.slotHighWater.assign(slots.size(), 0);
+}
+
+AAPL::FrameRing::FrameRing(const size_t& slotCount, const size_t& capacity)
+: mnOffset(0),
+  mnSlot(0),
+  mnFrame(0),
+  m_Busy(slotCount, false),
+  m_SlotFrame(slotCount, 0),
+  mnAllocations(0),
+  mnFailed(0)
+{
+    // Every slot starts on a constant alignment boundary, like a fresh MTLBuffer
+    const size_t stride = alignUp(capacity, kConstantAlignment);
+
+    m_Storage.resize(slotCount * stride + kConstantAlignment);
+
+    uint8_t* pBase = m_Storage.data() + (alignUp(reinterpret_cast<uintptr_t>(m_Storage.data()), kConstantAlignment)
+                                         - reinterpret_cast<uintptr_t>(m_Storage.data()));
+
+    for(size_t i = 0; i < slotCount; ++i)
+    {
+        m_Slots.push_back({pBase + i * stride, capacity});
+    }
+
+    m_Stats = Stats();
+
+    m_Stats.slotHighWater.assign(slotCount, 0);
+}
+
+AAPL::FrameRing::~FrameRing()
+{
+}
+
+size_t AAPL::FrameRing::slotCount() const
+{
+    return m_Slots.size();
+}
+
+void AAPL::FrameRing::beginFrame()
+{
+    const size_t slot = size_t(mnFrame % m_Slots.size());
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if(m_Busy[slot])
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        m_Condition.wait(lock, [this, slot] { return !m_Busy[slot]; });
+
+        m_Stats.waits++;
+        m_Stats.waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    acquire(slot);
+}
+
+bool AAPL::FrameRing::tryBeginFrame()
+{
+    const size_t slot = size_t(mnFrame % m_Slots.size());
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if(m_Busy[slot])
+    {
+        return false;
+    }
+
+    acquire(slot);
+
+    return true;
+}
+
+AAPL::FrameRing::Allocation AAPL::FrameRing::allocate(const size_t& size, const size_t& alignment)
+{
+    const Slot& rSlot = m_Slots[mnSlot];
+
+    Allocation allocation = {nullptr, 0, uint32_t(mnSlot)};
+
+    size_t current = mnOffset.load(std::memory_order_relaxed);
+    size_t offset  = 0;
+
+    // Lock-free bump: claim [offset, offset + size) unless another thread moved the pointer first
+    do
+    {
+        offset = alignUp(current, alignment);
+
+        if(offset + size > rSlot.capacity)
+        {
+            mnFailed.fetch_add(1, std::memory_order_relaxed);
+
+            return allocation;
+        }
+    }
+    while(!mnOffset.compare_exchange_weak(current, offset + size, std::memory_order_relaxed));
+
+    mnAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    allocation.pointer = static_cast<uint8_t*>(rSlot.pBase) + offset;
+    allocation.offset  = offset;
+
+    return allocation;
+}
+
+uint64_t AAPL::FrameRing::endFrame()
+{
+    const size_t bytes = mnOffset.load();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Stats.frames++;
+    m_Stats.lastFrameBytes        = bytes;
+    m_Stats.highWater             = std::max(m_Stats.highWater, bytes);
+    m_Stats.slotHighWater[mnSlot] = std::max(m_Stats.slotHighWater[mnSlot], bytes);
+
+    return mnFrame++;
+}
+
+void AAPL::FrameRing::complete(const uint64_t& frame)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    const size_t slot = size_t(frame % m_Slots.size());
+
+    // Only an ended frame that still owns its slot may release it
+    if((frame >= mnFrame) || (m_SlotFrame[slot] != frame))
+    {
+        return;
+    }
+
+    m_Busy[slot] = false;
+
+    // Under the lock, so a thread that returns from drain() and destroys the ring cannot race
+    // with this notification
+    m_Condition.notify_all();
+}
+
+void AAPL::FrameRing::drain()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // The slot of a frame still being encoded is not waited for
+    m_Condition.wait(lock, [this] {
+        for(size_t i = 0; i < m_Slots.size(); ++i)
+        {
+            if(m_Busy[i] && (m_SlotFrame[i] < mnFrame))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    });
+}
+
+AAPL::FrameRing::Stats AAPL::FrameRing::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    Stats result = m_Stats;
+
+    result.allocations       = mnAllocations.load();
+    result.failedAllocations = mnFailed.load();
+
+    return result;
+}
+
+#pragma mark -
+#pragma mark Private - Ring
+
+// Called with the mutex held
+void AAPL::FrameRing::acquire(const size_t& slot)
+{
+    m_Busy[slot]      = true;
+    m_SlotFrame[slot] = mnFrame;
+    mnSlot            = slot;
+
+    mnOffset.store(0);
+}
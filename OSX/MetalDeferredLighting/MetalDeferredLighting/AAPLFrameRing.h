@@ -0,0 +1,143 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Frame ring sub-allocator for per-frame uniform data. Instead of one array of kMaxFrameLag buffers
+ per kind of data, every frame slot is one large mapped allocation. Encoding threads bump-allocate
+ from the current slot without locks, each allocation aligned for the kind of data it holds, and a
+ slot is handed out again only after the command buffers of the frame that used it completed.
+ */
+
+#ifndef _AAPL_FRAME_RING_H_
+#define _AAPL_FRAME_RING_H_
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace AAPL
+{
+    // Buffer offsets of constant data bound with setVertexBuffer:offset: on macOS
+    static const size_t kConstantAlignment = 256;
+
+    // Offset alignment for data of type T, specialise for vertex or index data
+    template <typename T>
+    struct BufferAlignment
+    {
+        static const size_t value = kConstantAlignment;
+    };
+
+    class FrameRing
+    {
+    public:
+        // Memory of one frame slot, e.g. the contents of one shared MTLBuffer
+        struct Slot
+        {
+            void*  pBase;
+            size_t capacity;
+        };
+
+        // pointer is null when the slot is exhausted
+        struct Allocation
+        {
+            void*    pointer;
+            size_t   offset;   // Offset into the slot's buffer
+            uint32_t slot;     // Which buffer to bind
+        };
+
+        struct Stats
+        {
+            uint64_t frames;
+            uint64_t waits;              // beginFrame calls that blocked
+            double   waitSeconds;        // Total time blocked in beginFrame
+            uint64_t allocations;
+            uint64_t failedAllocations;
+            size_t   lastFrameBytes;
+            size_t   highWater;          // Largest frame, including alignment padding
+            std::vector<size_t> slotHighWater;
+        };
+
+        // Slots over caller owned memory
+        explicit FrameRing(const std::vector<Slot>& slots);
+
+        // Slots over memory owned by the ring
+        FrameRing(const size_t& slotCount, const size_t& capacity);
+
+        virtual ~FrameRing();
+
+        FrameRing(const FrameRing&) = delete;
+        FrameRing& operator=(const FrameRing&) = delete;
+
+        size_t slotCount() const;
+
+        // Wait until the next slot is reclaimed and make it current. Replaces the
+        // dispatch_semaphore_wait on the in-flight semaphore.
+        void beginFrame();
+
+        // Same, without blocking; false when the slot is still in use by the GPU
+        bool tryBeginFrame();
+
+        // Thread safe between beginFrame and endFrame
+        Allocation allocate(const size_t& size, const size_t& alignment = kConstantAlignment);
+
+        template <typename T>
+        T* allocate(const size_t& count = 1, size_t* pOffset = nullptr, uint32_t* pSlot = nullptr)
+        {
+            const Allocation allocation = allocate(count * sizeof(T), size_t(BufferAlignment<T>::value));
+
+            if(pOffset != nullptr)
+            {
+                *pOffset = allocation.offset;
+            }
+
+            if(pSlot != nullptr)
+            {
+                *pSlot = allocation.slot;
+            }
+
+            return static_cast<T*>(allocation.pointer);
+        }
+
+        // Close the frame; the returned serial is passed to complete() from the
+        // command buffer's completion handler
+        uint64_t endFrame();
+
+        // Release the slot of a frame. Frames may complete in any order.
+        void complete(const uint64_t& frame);
+
+        // Block until every submitted frame completed
+        void drain();
+
+        Stats stats() const;
+
+    private:
+        void acquire(const size_t& slot);
+
+        std::vector<Slot>                m_Slots;
+        std::vector<uint8_t>             m_Storage;      // Only for ring owned memory
+
+        std::atomic<size_t>              mnOffset;       // Bump pointer of the current slot
+        size_t                           mnSlot;
+        uint64_t                         mnFrame;        // Serial of the next frame
+
+        mutable std::mutex               m_Mutex;
+        std::condition_variable          m_Condition;
+        std::vector<bool>                m_Busy;         // Slot waits for its frame to complete
+        std::vector<uint64_t>            m_SlotFrame;    // Frame that last acquired the slot
+
+        std::atomic<uint64_t>            mnAllocations;
+        std::atomic<uint64_t>            mnFailed;
+        Stats                            m_Stats;
+    }; // FrameRing
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,321 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Tests for the frame ring, a standalone program that is not part of the app target. A mock GPU
+ thread stands in for the command buffer completion handlers: it checks the contents of every
+ allocation of a frame after a random delay and only then completes the frame, while four encoding
+ threads allocate the next frames. The test fails when an allocation is misaligned, two allocations
+ overlap, or a slot is handed out again while the mock GPU still reads it. It then checks that an
+ exhausted slot fails allocations, that tryBeginFrame does not take a busy slot and that a
+ completion for a frame that does not own its slot is ignored, and times an allocation.
+
+     c++ -std=c++11 -O2 -pthread AAPLFrameRing.cpp AAPLFrameRingTests.cpp -o tests
+     ./tests [frames]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <thread>
+
+#include "AAPLFrameRing.h"
+
+namespace
+{
+    // Vertex data, bound at 16 byte offsets
+    struct Vertex
+    {
+        float position[4];
+    };
+} // unnamed
+
+namespace AAPL
+{
+    template <>
+    struct BufferAlignment<Vertex>
+    {
+        static const size_t value = 16;
+    };
+} // AAPL
+
+using namespace AAPL;
+
+namespace
+{
+    // Words of one allocation, all holding the serial of the frame that wrote them
+    struct Range
+    {
+        uint64_t* pWords;
+        size_t    count;
+
+        bool operator<(const Range& rOther) const
+        {
+            return pWords < rOther.pWords;
+        }
+    };
+
+    struct Submission
+    {
+        uint64_t           frame;
+        std::vector<Range> ranges;
+    };
+
+    // Completes the submitted frames in order, as the command queue would
+    class MockGPU
+    {
+    public:
+        explicit MockGPU(FrameRing& rRing)
+        : mrRing(rRing),
+          mbStop(false),
+          mnCorrupted(0),
+          m_Thread(&MockGPU::run, this)
+        {
+        }
+
+        ~MockGPU()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                mbStop = true;
+            }
+
+            m_Condition.notify_one();
+            m_Thread.join();
+        }
+
+        void submit(const Submission& rSubmission)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                m_Queue.push_back(rSubmission);
+            }
+
+            m_Condition.notify_one();
+        }
+
+        size_t corrupted() const
+        {
+            return mnCorrupted.load();
+        }
+
+    private:
+        void run()
+        {
+            std::mt19937 random(3);
+
+            for(;;)
+            {
+                Submission submission;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+
+                    m_Condition.wait(lock, [this] { return mbStop || !m_Queue.empty(); });
+
+                    if(m_Queue.empty())
+                    {
+                        return;
+                    }
+
+                    submission = m_Queue.front();
+
+                    m_Queue.pop_front();
+                }
+
+                // The GPU reads the frame for a while, a later frame must not write over it
+                std::this_thread::sleep_for(std::chrono::microseconds(200 + random() % 800));
+
+                for(const Range& rRange : submission.ranges)
+                {
+                    for(size_t i = 0; i < rRange.count; ++i)
+                    {
+                        if(rRange.pWords[i] != submission.frame)
+                        {
+                            mnCorrupted++;
+                        }
+                    }
+                }
+
+                mrRing.complete(submission.frame);
+            }
+        }
+
+        FrameRing&               mrRing;
+        bool                     mbStop;
+        std::atomic<size_t>      mnCorrupted;
+        std::mutex               m_Mutex;
+        std::condition_variable  m_Condition;
+        std::deque<Submission>   m_Queue;
+        std::thread              m_Thread;
+    }; // MockGPU
+
+    bool checkFrames(const size_t& frames)
+    {
+        FrameRing ring(3, 1 << 20);
+
+        MockGPU gpu(ring);
+
+        size_t misaligned = 0;
+        size_t overlaps   = 0;
+
+        for(size_t frame = 0; frame < frames; ++frame)
+        {
+            ring.beginFrame();
+
+            Submission submission = {frame, std::vector<Range>()};
+
+            std::mutex              mutex;
+            std::atomic<size_t>     badAlignment(0);
+            std::vector<std::thread> encoders;
+
+            for(size_t t = 0; t < 4; ++t)
+            {
+                encoders.emplace_back([&, t] {
+                    std::mt19937 random(uint32_t(frame * 7 + t));
+
+                    for(size_t i = 0; i < 50; ++i)
+                    {
+                        const size_t count     = 1 + random() % 40;
+                        const size_t alignment = (i % 3 == 0) ? 16 : kConstantAlignment;
+
+                        const FrameRing::Allocation allocation = ring.allocate(count * sizeof(uint64_t), alignment);
+
+                        if(allocation.pointer == nullptr)
+                        {
+                            continue;
+                        }
+
+                        if(allocation.offset % alignment != 0)
+                        {
+                            badAlignment++;
+                        }
+
+                        uint64_t* pWords = static_cast<uint64_t*>(allocation.pointer);
+
+                        std::fill(pWords, pWords + count, uint64_t(frame));
+
+                        std::lock_guard<std::mutex> lock(mutex);
+
+                        submission.ranges.push_back({pWords, count});
+                    }
+
+                    size_t offset = 0;
+
+                    if((ring.allocate<Vertex>(3, &offset) != nullptr) && (offset % 16 != 0))
+                    {
+                        badAlignment++;
+                    }
+                });
+            }
+
+            for(std::thread& rEncoder : encoders)
+            {
+                rEncoder.join();
+            }
+
+            misaligned += badAlignment.load();
+
+            std::sort(submission.ranges.begin(), submission.ranges.end());
+
+            for(size_t i = 1; i < submission.ranges.size(); ++i)
+            {
+                const Range& rPrevious = submission.ranges[i - 1];
+
+                if(rPrevious.pWords + rPrevious.count > submission.ranges[i].pWords)
+                {
+                    overlaps++;
+                }
+            }
+
+            if(ring.endFrame() != frame)
+            {
+                std::printf("frames: endFrame returned the wrong serial\n");
+
+                return false;
+            }
+
+            gpu.submit(submission);
+        }
+
+        ring.drain();
+
+        const FrameRing::Stats stats = ring.stats();
+
+        std::printf("frames: %llu frames, %llu waits for %.3f s, %llu allocations, %llu failed, largest frame %zu bytes\n",
+                    (unsigned long long)stats.frames, (unsigned long long)stats.waits, stats.waitSeconds,
+                    (unsigned long long)stats.allocations, (unsigned long long)stats.failedAllocations, stats.highWater);
+
+        std::printf("frames: %zu misaligned, %zu overlapping, %zu words overwritten before completion\n",
+                    misaligned, overlaps, gpu.corrupted());
+
+        return (misaligned == 0) && (overlaps == 0) && (gpu.corrupted() == 0) && (stats.frames == frames);
+    }
+
+    bool checkSlots()
+    {
+        FrameRing ring(2, 1024);
+
+        ring.beginFrame();
+
+        const bool fits      = ring.allocate(1000).pointer != nullptr;
+        const bool exhausted = ring.allocate(100).pointer == nullptr;
+
+        const uint64_t first = ring.endFrame();
+
+        ring.beginFrame();
+
+        const uint64_t second = ring.endFrame();
+
+        // The third frame goes to the first frame's slot
+        const bool busy = !ring.tryBeginFrame();
+
+        ring.complete(second);
+
+        const bool stillBusy = !ring.tryBeginFrame();
+
+        ring.complete(first);
+
+        const bool reclaimed = ring.tryBeginFrame();
+
+        const bool passed = fits && exhausted && busy && stillBusy && reclaimed;
+
+        std::printf("slots: %s\n", passed ? "exhaustion, busy slots and stale completions handled" : "failed");
+
+        return passed;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t frames = (argc >= 2) ? size_t(std::atol(argv[1])) : 2000;
+
+    if(!checkFrames(frames) || !checkSlots())
+    {
+        return 1;
+    }
+
+    FrameRing ring(3, 64 << 20);
+
+    ring.beginFrame();
+
+    const size_t count = 200000;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        ring.allocate(64);
+    }
+
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / double(count);
+
+    std::printf("allocation: %.1f ns\n", ns);
+
+    return 0;
+}
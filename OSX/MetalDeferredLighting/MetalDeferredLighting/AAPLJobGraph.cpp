@@ -0,0 +1,413 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Asset job graph. Loading an asset is split into jobs with explicit dependencies, each on one of
+ three lanes: file reads on the graph's own I/O threads, decoding and mesh processing on a
+ work-stealing pool, and GPU uploads on the render thread.
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include "WorkStealingPool.h"
+
+#include "AAPLJobGraph.h"
+
+#pragma mark -
+#pragma mark Public - Graph
+
+AAPL::Jobs::Graph::Graph(Threads::WorkStealingPool& rPool, const size_t& ioThreads)
+: m_Pool(rPool), mnRemaining(0), mnFirst(-1.0), mnLast(0.0), mbStop(false), m_Origin(std::chrono::steady_clock::now())
+{
+    const size_t count = std::max(ioThreads, size_t(1));
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        m_IOThreads.emplace_back(&Graph::io, this);
+    }
+} // Constructor
+
+AAPL::Jobs::Graph::~Graph()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        mbStop = true;
+
+        // Queued jobs go back through release, which skips them and their dependents
+        std::vector<Job> queued(m_IOQueue.begin(), m_IOQueue.end());
+
+        queued.insert(queued.end(), m_RenderQueue.begin(), m_RenderQueue.end());
+
+        m_IOQueue.clear();
+        m_RenderQueue.clear();
+
+        std::vector<Job> compute;
+
+        release(queued, compute);
+    }
+
+    m_IOCondition.notify_all();
+
+    // Jobs already handed to the pool or running on it still refer to the graph
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        m_Condition.wait(lock, [this] { return mnRemaining == 0; });
+    }
+
+    for(std::thread& rThread : m_IOThreads)
+    {
+        rThread.join();
+    }
+} // Destructor
+
+AAPL::Jobs::Job AAPL::Jobs::Graph::add(const Lane& lane,
+                                       Task task,
+                                       const std::vector<Job>& dependencies,
+                                       const char* pName)
+{
+    std::vector<Job> compute;
+
+    Job job = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        job = m_Nodes.size();
+
+        m_Nodes.emplace_back();
+
+        Node& rNode = m_Nodes.back();
+
+        rNode.lane         = lane;
+        rNode.task         = std::move(task);
+        rNode.name         = (pName != nullptr) ? pName : "";
+        rNode.dependencies = dependencies;
+        rNode.waiting      = 0;
+        rNode.blocked      = false;
+        rNode.state        = eStateWaiting;
+        rNode.start        = 0.0;
+        rNode.end          = 0.0;
+
+        for(const Job& dependency : dependencies)
+        {
+            Node& rDependency = m_Nodes[dependency];
+
+            switch(rDependency.state)
+            {
+                case eStateSucceeded:
+                    break;
+
+                case eStateFailed:
+                case eStateSkipped:
+                    rNode.blocked = true;
+                    break;
+
+                default:
+                    rDependency.dependents.push_back(job);
+
+                    ++rNode.waiting;
+                    break;
+            }
+        }
+
+        if(mnFirst < 0.0)
+        {
+            mnFirst = now();
+        }
+
+        ++mnRemaining;
+
+        if(rNode.waiting == 0)
+        {
+            std::vector<Job> ready(1, job);
+
+            release(ready, compute);
+        }
+    }
+
+    m_Condition.notify_all();
+
+    submit(compute);
+
+    return job;
+}
+
+size_t AAPL::Jobs::Graph::poll()
+{
+    size_t count = 0;
+
+    for(;;)
+    {
+        Job job = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if(m_RenderQueue.empty())
+            {
+                break;
+            }
+
+            job = m_RenderQueue.front();
+
+            m_RenderQueue.pop_front();
+        }
+
+        run(job);
+
+        ++count;
+    }
+
+    return count;
+}
+
+void AAPL::Jobs::Graph::wait()
+{
+    for(;;)
+    {
+        poll();
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        m_Condition.wait(lock, [this] { return (mnRemaining == 0) || !m_RenderQueue.empty(); });
+
+        if(mnRemaining == 0)
+        {
+            return;
+        }
+    }
+}
+
+size_t AAPL::Jobs::Graph::remaining() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return mnRemaining;
+}
+
+const std::string& AAPL::Jobs::Graph::name(const Job& job) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return m_Nodes[job].name;
+}
+
+AAPL::Jobs::Report AAPL::Jobs::Graph::report() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    Report report = {};
+
+    report.jobs = m_Nodes.size();
+    report.wall = (mnFirst < 0.0) ? 0.0 : (std::max(mnLast, mnFirst) - mnFirst);
+
+    // Jobs were added after their dependencies, so the order they were added in is topological
+    std::vector<double> longest(m_Nodes.size(), 0.0);
+    std::vector<Job>    previous(m_Nodes.size(), SIZE_MAX);
+
+    Job last = SIZE_MAX;
+
+    for(Job job = 0; job < m_Nodes.size(); ++job)
+    {
+        const Node& rNode = m_Nodes[job];
+
+        double duration = 0.0;
+
+        if((rNode.state == eStateSucceeded) || (rNode.state == eStateFailed))
+        {
+            duration = rNode.end - rNode.start;
+
+            report.busy[rNode.lane] += duration;
+        }
+
+        report.failed  += (rNode.state == eStateFailed)  ? 1 : 0;
+        report.skipped += (rNode.state == eStateSkipped) ? 1 : 0;
+
+        for(const Job& dependency : rNode.dependencies)
+        {
+            if((previous[job] == SIZE_MAX) || (longest[dependency] > longest[previous[job]]))
+            {
+                previous[job] = dependency;
+            }
+        }
+
+        longest[job] = duration + ((previous[job] != SIZE_MAX) ? longest[previous[job]] : 0.0);
+
+        if((last == SIZE_MAX) || (longest[job] > longest[last]))
+        {
+            last = job;
+        }
+    }
+
+    if(last != SIZE_MAX)
+    {
+        report.criticalPath = longest[last];
+
+        for(Job job = last; job != SIZE_MAX; job = previous[job])
+        {
+            report.path.push_back(job);
+        }
+
+        std::reverse(report.path.begin(), report.path.end());
+    }
+
+    return report;
+}
+
+#pragma mark -
+#pragma mark Private - Graph
+
+double AAPL::Jobs::Graph::now() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Origin).count();
+}
+
+void AAPL::Jobs::Graph::release(std::vector<Job>& rReady, std::vector<Job>& rCompute)
+{
+    while(!rReady.empty())
+    {
+        const Job job = rReady.back();
+
+        rReady.pop_back();
+
+        Node& rNode = m_Nodes[job];
+
+        if(rNode.blocked || mbStop)
+        {
+            rNode.state = eStateSkipped;
+            rNode.task  = nullptr;
+            rNode.start = rNode.end = mnLast = now();
+
+            --mnRemaining;
+
+            for(const Job& dependent : rNode.dependents)
+            {
+                Node& rDependent = m_Nodes[dependent];
+
+                rDependent.blocked = true;
+
+                if(--rDependent.waiting == 0)
+                {
+                    rReady.push_back(dependent);
+                }
+            }
+
+            continue;
+        }
+
+        rNode.state = eStateQueued;
+
+        switch(rNode.lane)
+        {
+            case eLaneIO:
+                m_IOQueue.push_back(job);
+
+                m_IOCondition.notify_one();
+                break;
+
+            case eLaneRender:
+                m_RenderQueue.push_back(job);
+                break;
+
+            default:
+                rCompute.push_back(job);
+                break;
+        }
+    }
+}
+
+void AAPL::Jobs::Graph::run(const Job& job)
+{
+    Task task;
+
+    bool cancelled = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Node& rNode = m_Nodes[job];
+
+        cancelled = mbStop;
+
+        rNode.state = eStateRunning;
+        rNode.start = now();
+
+        task.swap(rNode.task);
+    }
+
+    const bool succeeded = !cancelled && (!task || task());
+
+    // The task's captures go before the dependents run
+    task = nullptr;
+
+    std::vector<Job> compute;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Node& rNode = m_Nodes[job];
+
+        rNode.state = cancelled ? eStateSkipped : (succeeded ? eStateSucceeded : eStateFailed);
+        rNode.end   = mnLast = now();
+
+        --mnRemaining;
+
+        std::vector<Job> ready;
+
+        for(const Job& dependent : rNode.dependents)
+        {
+            Node& rDependent = m_Nodes[dependent];
+
+            rDependent.blocked = rDependent.blocked || !succeeded;
+
+            if(--rDependent.waiting == 0)
+            {
+                ready.push_back(dependent);
+            }
+        }
+
+        release(ready, compute);
+
+        // Notified under the mutex: once the destructor sees nothing remaining the graph is gone.
+        // Jobs in compute still count as remaining, which keeps the graph alive for submit.
+        m_Condition.notify_all();
+    }
+
+    submit(compute);
+}
+
+void AAPL::Jobs::Graph::submit(const std::vector<Job>& compute)
+{
+    for(const Job& job : compute)
+    {
+        m_Pool.submit([this, job] { run(job); });
+    }
+}
+
+void AAPL::Jobs::Graph::io()
+{
+    for(;;)
+    {
+        Job job = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            m_IOCondition.wait(lock, [this] { return mbStop || !m_IOQueue.empty(); });
+
+            if(m_IOQueue.empty())
+            {
+                return;
+            }
+
+            job = m_IOQueue.front();
+
+            m_IOQueue.pop_front();
+        }
+
+        run(job);
+    }
+}
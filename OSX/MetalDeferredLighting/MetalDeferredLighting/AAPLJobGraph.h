@@ -0,0 +1,213 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Asset job graph. Loading an asset is split into jobs with explicit dependencies, each on one of
+ three lanes: file reads on the graph's own I/O threads, so that a read is never queued behind
+ decoding work, decoding and mesh processing on a work-stealing pool, and GPU resource creation
+ and uploads on the render thread, which polls the graph once per frame. A job runs once all of
+ its dependencies succeeded; a job that fails skips everything depending on it. Futures carry the
+ assets to the renderer, which draws with placeholders until they are ready.
+ */
+
+#ifndef _AAPL_JOB_GRAPH_H_
+#define _AAPL_JOB_GRAPH_H_
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace Jobs
+    {
+        enum Lane
+        {
+            eLaneIO = 0,    // Blocking reads, on the graph's I/O threads in the order they were added
+            eLaneCompute,   // Decoding and mesh processing, on the pool
+            eLaneRender,    // Metal resources and uploads, on the thread calling poll() or wait()
+            eLaneCount
+        };
+
+        // Index of a job in the order it was added
+        typedef size_t Job;
+
+        // False fails the job
+        typedef std::function<bool()> Task;
+
+        struct Report
+        {
+            size_t           jobs;
+            size_t           failed;            // Tasks that returned false
+            size_t           skipped;           // Jobs not run because a dependency failed
+            double           wall;              // Seconds from the first job added to the last one finished
+            double           busy[eLaneCount];  // Seconds spent running tasks, per lane
+            double           criticalPath;      // Seconds of the longest chain of run times through the dependencies
+            std::vector<Job> path;              // That chain, first job first
+        };
+
+        // Shared handle to an asset some job produces. Set and read from any thread; get() only
+        // once ready() returned true.
+        template <typename T>
+        class Future
+        {
+        public:
+            Future()
+            : mpState(std::make_shared<State>())
+            {
+            }
+
+            bool ready() const
+            {
+                return mpState->m_Status.load(std::memory_order_acquire) == eReady;
+            }
+
+            bool failed() const
+            {
+                return mpState->m_Status.load(std::memory_order_acquire) == eFailed;
+            }
+
+            const T& get() const
+            {
+                return mpState->m_Value;
+            }
+
+            void set(const T& value)
+            {
+                mpState->m_Value = value;
+
+                mpState->m_Status.store(eReady, std::memory_order_release);
+            }
+
+            void fail()
+            {
+                mpState->m_Status.store(eFailed, std::memory_order_release);
+            }
+
+        private:
+            enum Status
+            {
+                ePending = 0,
+                eReady,
+                eFailed
+            };
+
+            struct State
+            {
+                State()
+                : m_Status(ePending), m_Value()
+                {
+                }
+
+                std::atomic<int> m_Status;
+                T                m_Value;
+            };
+
+            std::shared_ptr<State> mpState;
+        }; // Class Future
+
+        class Graph
+        {
+        public:
+            explicit Graph(Threads::WorkStealingPool& rPool, const size_t& ioThreads = 2);
+
+            // Jobs not started yet are skipped; returns once the running ones finished
+            virtual ~Graph();
+
+            Graph(const Graph&) = delete;
+            Graph& operator=(const Graph&) = delete;
+
+            // Dependencies must have been added before, from any thread and also from within a task.
+            // The job is queued on its lane as soon as every dependency succeeded.
+            Job add(const Lane& lane,
+                    Task task,
+                    const std::vector<Job>& dependencies = std::vector<Job>(),
+                    const char* pName = "");
+
+            // Run the render jobs that are ready on the calling thread; returns how many ran
+            size_t poll();
+
+            // Block until every job finished, running render jobs on the calling thread meanwhile
+            void wait();
+
+            // Jobs added and not finished yet
+            size_t remaining() const;
+
+            const std::string& name(const Job& job) const;
+
+            Report report() const;
+
+        private:
+            enum State
+            {
+                eStateWaiting = 0,
+                eStateQueued,
+                eStateRunning,
+                eStateSucceeded,
+                eStateFailed,
+                eStateSkipped
+            };
+
+            struct Node
+            {
+                Lane                lane;
+                Task                task;
+                std::string         name;
+                std::vector<Job>    dependencies;
+                std::vector<Job>    dependents;
+                size_t              waiting;        // Dependencies not finished yet
+                bool                blocked;        // A dependency failed or was skipped
+                State               state;
+                double              start;
+                double              end;
+            };
+
+            double now() const;
+
+            // Queue or skip jobs whose dependencies all finished; called with m_Mutex held, fills
+            // rCompute with the jobs to submit to the pool once the mutex is released
+            void release(std::vector<Job>& rReady, std::vector<Job>& rCompute);
+
+            void run(const Job& job);
+            void submit(const std::vector<Job>& compute);
+            void io();
+
+        private:
+            Threads::WorkStealingPool&               m_Pool;
+            std::vector<std::thread>                 m_IOThreads;
+
+            mutable std::mutex                       m_Mutex;
+            std::condition_variable                  m_IOCondition;
+            std::condition_variable                  m_Condition;       // A job finished or a render job is ready
+
+            std::deque<Node>                         m_Nodes;
+            std::deque<Job>                          m_IOQueue;
+            std::deque<Job>                          m_RenderQueue;
+            size_t                                   mnRemaining;
+            double                                   mnFirst;           // Time the first job was added
+            double                                   mnLast;            // Time the last job finished
+            bool                                     mbStop;
+
+            std::chrono::steady_clock::time_point    m_Origin;
+        }; // Class Graph
+    } // Jobs
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Harness for the asset job graph, a standalone program that is not part of the app target. It
+ checks the graph on random dependency graphs across all three lanes: every job runs after its
+ dependencies, jobs depending on a failed one are skipped and the report counts both. It then
+ loads a synthetic asset set shaped like the renderer's, the temple model whose nine material
+ textures are only known once it is parsed, the skybox and the fairy, with sleeps for reads and
+ spins for decoding and uploads, while a 60 Hz frame loop polls the graph. It prints the time to
+ the first frame and to the last asset, the frames drawn with placeholders, the busy time per
+ lane and the critical path against loading everything serially.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLJobGraph.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp AAPLJobGraphBenchmark.cpp -o benchmark
+     ./benchmark [threads]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "AAPLJobGraph.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::Jobs;
+
+namespace
+{
+    // Milliseconds of each stage of loading an asset
+    struct Asset
+    {
+        const char* pName;
+        double      read;
+        double      decode;
+        double      upload;
+    };
+
+    double seconds()
+    {
+        static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    // Keep the thread busy, as decoding does
+    void spin(const double& milliseconds)
+    {
+        const double end = seconds() + milliseconds * 1.0e-3;
+
+        while(seconds() < end)
+        {
+        }
+    }
+
+    // Block, as a read does
+    void sleep(const double& milliseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(long(milliseconds * 1.0e3)));
+    }
+
+    bool checkGraphs(Threads::WorkStealingPool& rPool)
+    {
+        const size_t count = 300;
+
+        for(uint32_t round = 0; round < 200; ++round)
+        {
+            std::mt19937 random(round);
+
+            Graph graph(rPool, 2);
+
+            std::vector<std::atomic<int>> ran(count);
+            std::vector<std::vector<Job>> dependencies(count);
+            std::vector<bool>             fails(count);
+            std::vector<bool>             runs(count, true);
+            std::atomic<size_t>           misordered(0);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                ran[i].store(0);
+
+                fails[i] = (random() % 50) == 0;
+
+                const size_t edges = (i == 0) ? 0 : random() % 4;
+
+                for(size_t e = 0; e < edges; ++e)
+                {
+                    dependencies[i].push_back(random() % i);
+                }
+
+                for(const Job& dependency : dependencies[i])
+                {
+                    runs[i] = runs[i] && runs[dependency] && !fails[dependency];
+                }
+
+                graph.add(Lane(random() % eLaneCount), [&, i] {
+                    for(const Job& dependency : dependencies[i])
+                    {
+                        if(ran[dependency].load() != 1)
+                        {
+                            misordered++;
+                        }
+                    }
+
+                    ran[i].store(1);
+
+                    return !fails[i];
+                }, dependencies[i]);
+
+                // Render jobs also run while jobs are still being added
+                if(random() % 7 == 0)
+                {
+                    graph.poll();
+                }
+            }
+
+            graph.wait();
+
+            const Report report = graph.report();
+
+            size_t executed = 0;
+            size_t failed   = 0;
+            size_t wrong    = 0;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                wrong    += (ran[i].load() == 1) != runs[i];
+                executed += ran[i].load();
+                failed   += (ran[i].load() == 1) && fails[i];
+            }
+
+            if((misordered.load() != 0) || (wrong != 0) || (report.failed != failed) ||
+               (report.skipped != count - executed) || (graph.remaining() != 0))
+            {
+                std::printf("graph %u: %zu jobs ran before a dependency, %zu ran or skipped wrongly, "
+                            "report %zu failed and %zu skipped of %zu and %zu\n",
+                            round, misordered.load(), wrong, report.failed, report.skipped, failed, count - executed);
+
+                return false;
+            }
+        }
+
+        std::printf("200 random graphs of %zu jobs: order, failures and skips correct\n", count);
+
+        return true;
+    }
+
+    void loadAssets(Threads::WorkStealingPool& rPool, const size_t& ioThreads)
+    {
+        // Parsing includes the tangents, optimisation and quantisation
+        const Asset model    = {"Temple.obj", 12.0, 140.0, 3.0};
+        const Asset material = {"material", 5.0, 22.0, 2.0};
+
+        const Asset textures[] =
+        {
+            {"skybox.png", 6.0, 45.0, 4.0},
+            {"fairy.png", 0.5, 1.0, 0.2}
+        };
+
+        const size_t materials = 9;
+
+        double serial = model.read + model.decode + model.upload + materials * (material.read + material.decode + material.upload);
+
+        for(const Asset& texture : textures)
+        {
+            serial += texture.read + texture.decode + texture.upload;
+        }
+
+        Graph graph(rPool, ioThreads);
+
+        const double start = seconds();
+
+        std::mutex                  mutex;
+        std::vector<Future<bool>>   loaded;
+
+        const auto load = [&](const Asset& asset, const std::vector<Job>& dependencies) {
+            Future<bool> future;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                loaded.push_back(future);
+            }
+
+            const Job read   = graph.add(eLaneIO, [=] { sleep(asset.read); return true; }, dependencies, asset.pName);
+            const Job decode = graph.add(eLaneCompute, [=] { spin(asset.decode); return true; }, {read}, asset.pName);
+
+            graph.add(eLaneRender, [=]() mutable { spin(asset.upload); future.set(true); return true; }, {decode}, asset.pName);
+        };
+
+        Future<bool> structure;
+
+        const Job read  = graph.add(eLaneIO, [=] { sleep(model.read); return true; }, {}, "read Temple.obj");
+        const Job parse = graph.add(eLaneCompute, [=] { spin(model.decode); return true; }, {read}, "parse Temple.obj");
+
+        // The materials are known once the model is parsed
+        graph.add(eLaneRender, [&, structure, parse]() mutable {
+            spin(model.upload);
+
+            structure.set(true);
+
+            for(size_t i = 0; i < materials; ++i)
+            {
+                load(material, {parse});
+            }
+
+            return true;
+        }, {parse}, "upload Temple.obj");
+
+        for(const Asset& texture : textures)
+        {
+            load(texture, {});
+        }
+
+        // Poll, draw for 2 ms and present at 60 Hz, with placeholders until the assets are ready
+        size_t frames      = 0;
+        size_t placeholder = 0;
+        double firstFrame  = -1.0;
+        double allLoaded   = 0.0;
+
+        for(;;)
+        {
+            const double frameStart = seconds();
+
+            graph.poll();
+
+            spin(2.0);
+
+            bool ready = structure.ready();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                for(const Future<bool>& future : loaded)
+                {
+                    ready = ready && future.ready();
+                }
+            }
+
+            if(firstFrame < 0.0)
+            {
+                firstFrame = seconds() - start;
+            }
+
+            frames++;
+            placeholder += !ready;
+
+            if(ready && (graph.remaining() == 0))
+            {
+                allLoaded = seconds() - start;
+
+                break;
+            }
+
+            const double left = 1.0 / 60.0 - (seconds() - frameStart);
+
+            if(left > 0.0)
+            {
+                sleep(left * 1.0e3);
+            }
+        }
+
+        const Report report = graph.report();
+
+        std::printf("%zu I/O threads, pool of %zu: first frame %.1f ms, all assets %.1f ms over %zu frames (%zu with placeholders), "
+                    "critical path %.1f ms, serial %.1f ms, busy I/O %.1f, compute %.1f, render %.1f ms\n    critical path:",
+                    ioThreads, rPool.concurrency(), firstFrame * 1.0e3, allLoaded * 1.0e3, frames, placeholder,
+                    report.criticalPath * 1.0e3, serial,
+                    report.busy[eLaneIO] * 1.0e3, report.busy[eLaneCompute] * 1.0e3, report.busy[eLaneRender] * 1.0e3);
+
+        for(const Job& job : report.path)
+        {
+            std::printf(" %s", graph.name(job).c_str());
+        }
+
+        std::printf("\n");
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t threads = (argc >= 2) ? size_t(std::atoi(argv[1])) : 0;
+
+    Threads::WorkStealingPool pool(threads);
+
+    if(!checkGraphs(pool))
+    {
+        return 1;
+    }
+
+    const size_t ioThreads[] = {1, 2, 4};
+
+    for(const size_t& count : ioThreads)
+    {
+        loadAssets(pool, count);
+    }
+
+    return 0;
+}
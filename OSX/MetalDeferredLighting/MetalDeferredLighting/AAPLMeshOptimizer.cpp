@@ -0,0 +1,541 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Triangle and vertex reordering for indexed triangle lists. Triangles are reordered for the
+ post-transform vertex cache (Tipsify), the resulting clusters are sorted so that outward facing
+ parts of the mesh draw first (less overdraw), and vertices are renumbered in order of first use
+ so vertex fetch walks memory linearly. Every pass keeps triangles inside their material range.
+ A FIFO cache simulator reports ACMR (transforms per triangle) and ATVR (transforms per vertex).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "AAPLMeshOptimizer.h"
+
+#pragma mark -
+#pragma mark Private - Cache
+
+namespace AAPL
+{
+    namespace MeshOptimizer
+    {
+        static const uint32_t kUnused = 0xffffffff;
+
+        // FIFO post-transform cache: a vertex is resident while fewer than size vertices were
+        // inserted after it. Hits do not move a vertex.
+        class FIFOCache
+        {
+        public:
+            FIFOCache(const size_t& vertexCount, const size_t& size)
+            : m_Stamp(vertexCount, 0),
+              mnSize(uint32_t(size)),
+              mnTime(uint32_t(size) + 1)
+            {
+            }
+
+            // True on a miss
+            bool access(const uint32_t& vertex)
+            {
+                if(mnTime - m_Stamp[vertex] <= mnSize)
+                {
+                    return false;
+                }
+
+                m_Stamp[vertex] = mnTime++;
+
+                return true;
+            }
+
+            void flush()
+            {
+                mnTime += mnSize + 1;
+            }
+
+        private:
+            std::vector<uint32_t> m_Stamp;
+            uint32_t              mnSize;
+            uint32_t              mnTime;
+        }; // FIFOCache
+
+        struct float3
+        {
+            double x, y, z;
+        };
+
+        static inline float3 position(const uint8_t* pPositions, const size_t& stride, const uint32_t& vertex)
+        {
+            float p[3];
+
+            std::memcpy(p, pPositions + vertex * stride, sizeof(p));
+
+            return {p[0], p[1], p[2]};
+        }
+    } // MeshOptimizer
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Metrics
+
+AAPL::MeshOptimizer::CacheStatistics AAPL::MeshOptimizer::simulateCache(const uint32_t* pIndices,
+                                                                        const size_t& indexCount,
+                                                                        const size_t& vertexCount,
+                                                                        const size_t& cacheSize)
+{
+    CacheStatistics statistics = {indexCount / 3, 0, 0, 0.0, 0.0};
+
+    FIFOCache cache(vertexCount, cacheSize);
+
+    std::vector<uint8_t> referenced(vertexCount, 0);
+
+    for(size_t i = 0; i < 3 * statistics.triangles; ++i)
+    {
+        const uint32_t vertex = pIndices[i];
+
+        statistics.transforms += cache.access(vertex) ? 1 : 0;
+
+        if(!referenced[vertex])
+        {
+            referenced[vertex] = 1;
+
+            statistics.vertices++;
+        }
+    }
+
+    if(statistics.triangles)
+    {
+        statistics.acmr = double(statistics.transforms) / double(statistics.triangles);
+        statistics.atvr = double(statistics.transforms) / double(statistics.vertices);
+    }
+
+    return statistics;
+}
+
+#pragma mark -
+#pragma mark Public - Triangle order
+
+void AAPL::MeshOptimizer::optimizeVertexCache(uint32_t* pIndices,
+                                              const size_t& indexCount,
+                                              const size_t& vertexCount,
+                                              const size_t& cacheSize)
+{
+    const size_t triangleCount = indexCount / 3;
+
+    if(triangleCount < 2)
+    {
+        return;
+    }
+
+    // Triangles around every vertex, and how many of them are not emitted yet
+    std::vector<uint32_t> live(vertexCount, 0);
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    std::vector<uint32_t> adjacency(3 * triangleCount);
+
+    for(size_t i = 0; i < 3 * triangleCount; ++i)
+    {
+        live[pIndices[i]]++;
+    }
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        offsets[v + 1] = offsets[v] + live[v];
+    }
+
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+
+        for(size_t i = 0; i < 3 * triangleCount; ++i)
+        {
+            adjacency[cursor[pIndices[i]]++] = uint32_t(i / 3);
+        }
+    }
+
+    const uint32_t k = uint32_t(cacheSize);
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<uint8_t>  emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+
+    deadEnd.reserve(3 * triangleCount);
+    output.reserve(3 * triangleCount);
+
+    uint32_t time    = k + 1;
+    size_t   scan    = 0;
+    uint32_t fanning = pIndices[0];
+
+    for(;;)
+    {
+        candidates.clear();
+
+        // Emit every remaining triangle around the fanning vertex
+        for(uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+        {
+            const uint32_t triangle = adjacency[a];
+
+            if(emitted[triangle])
+            {
+                continue;
+            }
+
+            emitted[triangle] = 1;
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                const uint32_t vertex = pIndices[3 * triangle + c];
+
+                output.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+
+                live[vertex]--;
+
+                if(time - cacheTime[vertex] > k)
+                {
+                    cacheTime[vertex] = time++;
+                }
+            }
+        }
+
+        // Next fanning vertex: the oldest candidate that stays in the cache while its remaining
+        // triangles are emitted, otherwise any candidate with triangles left
+        uint32_t next     = kUnused;
+        int64_t  priority = -1;
+
+        for(uint32_t vertex : candidates)
+        {
+            if(live[vertex] == 0)
+            {
+                continue;
+            }
+
+            int64_t p = 0;
+
+            if(time - cacheTime[vertex] + 2 * live[vertex] <= k)
+            {
+                p = time - cacheTime[vertex];
+            }
+
+            if(p > priority)
+            {
+                priority = p;
+                next     = vertex;
+            }
+        }
+
+        // Dead end: recently used vertices first, then input order
+        while((next == kUnused) && !deadEnd.empty())
+        {
+            const uint32_t vertex = deadEnd.back();
+
+            deadEnd.pop_back();
+
+            if(live[vertex] > 0)
+            {
+                next = vertex;
+            }
+        }
+
+        while((next == kUnused) && (scan < vertexCount))
+        {
+            if(live[scan] > 0)
+            {
+                next = uint32_t(scan);
+            }
+            else
+            {
+                scan++;
+            }
+        }
+
+        if(next == kUnused)
+        {
+            break;
+        }
+
+        fanning = next;
+    }
+
+    std::copy(output.begin(), output.end(), pIndices);
+}
+
+size_t AAPL::MeshOptimizer::optimizeOverdraw(uint32_t* pIndices,
+                                             const size_t& indexCount,
+                                             const void* pPositions,
+                                             const size_t& stride,
+                                             const size_t& vertexCount,
+                                             const float& threshold,
+                                             const size_t& cacheSize)
+{
+    const size_t triangleCount = indexCount / 3;
+
+    if(triangleCount < 2)
+    {
+        return triangleCount;
+    }
+
+    FIFOCache cache(vertexCount, cacheSize);
+
+    std::vector<uint8_t> misses(triangleCount);
+
+    // Hard boundaries where the cache starts over (every vertex of the triangle misses)
+    std::vector<size_t> hard;
+
+    for(size_t t = 0; t < triangleCount; ++t)
+    {
+        misses[t] = uint8_t(cache.access(pIndices[3 * t]) + cache.access(pIndices[3 * t + 1]) + cache.access(pIndices[3 * t + 2]));
+
+        if((t == 0) || (misses[t] == 3))
+        {
+            hard.push_back(t);
+        }
+    }
+
+    hard.push_back(triangleCount);
+
+    // Soft boundaries: split a cluster as soon as its prefix, simulated from a cold cache, is
+    // within the threshold of the ACMR of the whole cluster
+    std::vector<size_t> clusters;
+
+    for(size_t h = 0; h + 1 < hard.size(); ++h)
+    {
+        const size_t first = hard[h];
+        const size_t last  = hard[h + 1];
+
+        size_t total = 0;
+
+        for(size_t t = first; t < last; ++t)
+        {
+            total += misses[t];
+        }
+
+        const double limit = double(threshold) * double(total) / double(last - first);
+
+        size_t start  = first;
+        size_t missed = 0;
+
+        cache.flush();
+
+        clusters.push_back(first);
+
+        for(size_t t = first; t < last; ++t)
+        {
+            missed += cache.access(pIndices[3 * t]) + cache.access(pIndices[3 * t + 1]) + cache.access(pIndices[3 * t + 2]);
+
+            if((t + 1 < last) && (double(missed) <= limit * double(t + 1 - start)))
+            {
+                start  = t + 1;
+                missed = 0;
+
+                cache.flush();
+
+                clusters.push_back(start);
+            }
+        }
+    }
+
+    clusters.push_back(triangleCount);
+
+    const size_t clusterCount = clusters.size() - 1;
+
+    // Area weighted centroid and normal of every cluster
+    const uint8_t* pBase = static_cast<const uint8_t*>(pPositions);
+
+    std::vector<float3> centroids(clusterCount, float3{0.0, 0.0, 0.0});
+    std::vector<float3> normals(clusterCount, float3{0.0, 0.0, 0.0});
+    std::vector<double> areas(clusterCount, 0.0);
+
+    float3 centre     = {0.0, 0.0, 0.0};
+    double centreArea = 0.0;
+
+    for(size_t c = 0; c < clusterCount; ++c)
+    {
+        for(size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const float3 a = position(pBase, stride, pIndices[3 * t]);
+            const float3 b = position(pBase, stride, pIndices[3 * t + 1]);
+            const float3 d = position(pBase, stride, pIndices[3 * t + 2]);
+
+            const float3 u = {b.x - a.x, b.y - a.y, b.z - a.z};
+            const float3 v = {d.x - a.x, d.y - a.y, d.z - a.z};
+            const float3 n = {u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x};
+
+            const double area = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+
+            centroids[c].x += area * (a.x + b.x + d.x) / 3.0;
+            centroids[c].y += area * (a.y + b.y + d.y) / 3.0;
+            centroids[c].z += area * (a.z + b.z + d.z) / 3.0;
+
+            normals[c].x += n.x;
+            normals[c].y += n.y;
+            normals[c].z += n.z;
+
+            areas[c] += area;
+        }
+
+        centre.x   += centroids[c].x;
+        centre.y   += centroids[c].y;
+        centre.z   += centroids[c].z;
+        centreArea += areas[c];
+    }
+
+    if(centreArea > 0.0)
+    {
+        centre = {centre.x / centreArea, centre.y / centreArea, centre.z / centreArea};
+    }
+
+    // Clusters facing away from the centre occlude the rest from most views, draw them first
+    std::vector<double> keys(clusterCount, 0.0);
+
+    for(size_t c = 0; c < clusterCount; ++c)
+    {
+        const double length = std::sqrt(normals[c].x * normals[c].x + normals[c].y * normals[c].y + normals[c].z * normals[c].z);
+
+        if((areas[c] > 0.0) && (length > 0.0))
+        {
+            const float3 p = {centroids[c].x / areas[c] - centre.x, centroids[c].y / areas[c] - centre.y, centroids[c].z / areas[c] - centre.z};
+
+            keys[c] = (p.x * normals[c].x + p.y * normals[c].y + p.z * normals[c].z) / length;
+        }
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+
+    for(size_t c = 0; c < clusterCount; ++c)
+    {
+        order[c] = uint32_t(c);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&keys](const uint32_t& a, const uint32_t& b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> output;
+
+    output.reserve(3 * triangleCount);
+
+    for(uint32_t c : order)
+    {
+        output.insert(output.end(), pIndices + 3 * clusters[c], pIndices + 3 * clusters[c + 1]);
+    }
+
+    std::copy(output.begin(), output.end(), pIndices);
+
+    return clusterCount;
+}
+
+#pragma mark -
+#pragma mark Public - Vertex order
+
+size_t AAPL::MeshOptimizer::optimizeVertexFetch(uint32_t* pIndices,
+                                                const size_t& indexCount,
+                                                const size_t& vertexCount,
+                                                std::vector<uint32_t>& rRemap)
+{
+    rRemap.assign(vertexCount, kUnused);
+
+    uint32_t next = 0;
+
+    for(size_t i = 0; i < indexCount; ++i)
+    {
+        uint32_t& rNew = rRemap[pIndices[i]];
+
+        if(rNew == kUnused)
+        {
+            rNew = next++;
+        }
+
+        pIndices[i] = rNew;
+    }
+
+    const size_t referenced = next;
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        if(rRemap[v] == kUnused)
+        {
+            rRemap[v] = next++;
+        }
+    }
+
+    return referenced;
+}
+
+void AAPL::MeshOptimizer::remapVertices(void* pVertices,
+                                        const size_t& vertexCount,
+                                        const size_t& stride,
+                                        const std::vector<uint32_t>& rRemap)
+{
+    uint8_t* pBytes = static_cast<uint8_t*>(pVertices);
+
+    const std::vector<uint8_t> source(pBytes, pBytes + vertexCount * stride);
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        std::memcpy(pBytes + rRemap[v] * stride, source.data() + v * stride, stride);
+    }
+}
+
+#pragma mark -
+#pragma mark Public - Mesh
+
+AAPL::MeshOptimizer::Report AAPL::MeshOptimizer::optimize(uint32_t* pIndices,
+                                                          const std::vector<Range>& ranges,
+                                                          void* pVertices,
+                                                          const size_t& vertexCount,
+                                                          const size_t& stride,
+                                                          const size_t& positionOffset,
+                                                          const size_t& cacheSize,
+                                                          const float& threshold)
+{
+    Report report;
+
+    std::memset(&report, 0, sizeof(report));
+
+    // Statistics of the ranges drawn back to back
+    std::vector<uint32_t> drawn;
+
+    for(const Range& rRange : ranges)
+    {
+        drawn.insert(drawn.end(), pIndices + rRange.first, pIndices + rRange.first + rRange.count);
+    }
+
+    report.before = simulateCache(drawn.data(), drawn.size(), vertexCount, cacheSize);
+
+    const uint8_t* pPositions = static_cast<const uint8_t*>(pVertices) + positionOffset;
+
+    for(const Range& rRange : ranges)
+    {
+        optimizeVertexCache(pIndices + rRange.first, rRange.count, vertexCount, cacheSize);
+
+        report.clusters += optimizeOverdraw(pIndices + rRange.first, rRange.count, pPositions, stride, vertexCount, threshold, cacheSize);
+    }
+
+    drawn.clear();
+
+    for(const Range& rRange : ranges)
+    {
+        drawn.insert(drawn.end(), pIndices + rRange.first, pIndices + rRange.first + rRange.count);
+    }
+
+    // Fetch order follows the order the ranges are drawn in
+    std::vector<uint32_t> remap;
+
+    optimizeVertexFetch(drawn.data(), drawn.size(), vertexCount, remap);
+
+    remapVertices(pVertices, vertexCount, stride, remap);
+
+    size_t offset = 0;
+
+    for(const Range& rRange : ranges)
+    {
+        std::copy(drawn.begin() + offset, drawn.begin() + offset + rRange.count, pIndices + rRange.first);
+
+        offset += rRange.count;
+    }
+
+    report.after = simulateCache(drawn.data(), drawn.size(), vertexCount, cacheSize);
+
+    return report;
+}
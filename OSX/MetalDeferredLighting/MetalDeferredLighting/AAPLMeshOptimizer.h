@@ -0,0 +1,107 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Triangle and vertex reordering for indexed triangle lists. Triangles are reordered for the
+ post-transform vertex cache (Tipsify), the resulting clusters are sorted so that outward facing
+ parts of the mesh draw first (less overdraw), and vertices are renumbered in order of first use
+ so vertex fetch walks memory linearly. Every pass keeps triangles inside their material range.
+ A FIFO cache simulator reports ACMR (transforms per triangle) and ATVR (transforms per vertex).
+ */
+
+#ifndef _AAPL_MESH_OPTIMIZER_H_
+#define _AAPL_MESH_OPTIMIZER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AAPL
+{
+    namespace MeshOptimizer
+    {
+        // Entries of the simulated post-transform cache
+        static const size_t kDefaultCacheSize = 16;
+
+        // Cluster ACMR may exceed the ACMR of the whole range by this factor to gain overdraw
+        static const float kDefaultOverdrawThreshold = 1.05f;
+
+        // Indices [first, first + count) drawn with one material; count is a multiple of 3
+        struct Range
+        {
+            size_t first;
+            size_t count;
+        };
+
+        struct CacheStatistics
+        {
+            size_t triangles;
+            size_t vertices;        // Distinct vertices referenced
+            size_t transforms;      // Cache misses, i.e. vertex shader invocations
+            double acmr;            // transforms / triangles, 0.5 at best for a regular grid
+            double atvr;            // transforms / vertices, 1.0 at best
+        };
+
+        struct Report
+        {
+            CacheStatistics before;
+            CacheStatistics after;
+            size_t          clusters;       // Clusters sorted by the overdraw pass
+        };
+
+        // FIFO cache of cacheSize entries fed the triangles in order
+        CacheStatistics simulateCache(const uint32_t* pIndices,
+                                      const size_t& indexCount,
+                                      const size_t& vertexCount,
+                                      const size_t& cacheSize = kDefaultCacheSize);
+
+        // Reorder the triangles of one range for the vertex cache (Sander et al., "Fast triangle
+        // reordering for vertex locality and reduced overdraw", 2007)
+        void optimizeVertexCache(uint32_t* pIndices,
+                                 const size_t& indexCount,
+                                 const size_t& vertexCount,
+                                 const size_t& cacheSize = kDefaultCacheSize);
+
+        // Split a cache optimised range into clusters and sort them by how much they face away
+        // from the centre of the range; returns the number of clusters. pPositions points at the
+        // first vertex's position, stride bytes apart.
+        size_t optimizeOverdraw(uint32_t* pIndices,
+                                const size_t& indexCount,
+                                const void* pPositions,
+                                const size_t& stride,
+                                const size_t& vertexCount,
+                                const float& threshold = kDefaultOverdrawThreshold,
+                                const size_t& cacheSize = kDefaultCacheSize);
+
+        // Renumber vertices in order of first use and rewrite the indices. rRemap[old] is the new
+        // index; unreferenced vertices move to the end. Returns the number of referenced vertices.
+        size_t optimizeVertexFetch(uint32_t* pIndices,
+                                   const size_t& indexCount,
+                                   const size_t& vertexCount,
+                                   std::vector<uint32_t>& rRemap);
+
+        // Move vertices of stride bytes to their remapped places
+        void remapVertices(void* pVertices,
+                           const size_t& vertexCount,
+                           const size_t& stride,
+                           const std::vector<uint32_t>& rRemap);
+
+        // All passes: cache and overdraw order per range, then one fetch order over all ranges
+        // (they share the vertex buffer). The ranges must cover every index that refers to the
+        // vertices. The position is the three floats at positionOffset in every vertex.
+        Report optimize(uint32_t* pIndices,
+                        const std::vector<Range>& ranges,
+                        void* pVertices,
+                        const size_t& vertexCount,
+                        const size_t& stride,
+                        const size_t& positionOffset = 0,
+                        const size_t& cacheSize = kDefaultCacheSize,
+                        const float& threshold = kDefaultOverdrawThreshold);
+    } // MeshOptimizer
+} // AAPL
+
+#endif
+
+#endif
@@ -38,6 +38,14 @@ typedef enum _AAPLObjVertexAttributeType
 
 - (id)initWithContentsOfFile:(NSString *)inputFilePath computeTangentSpace:(BOOL)computeTangentSpace normalizeNormals:(BOOL)normalizeNormals;
 
+// When optimizeMeshes is set, triangles are reordered for the vertex cache and overdraw within every
+// material range, and vertices are renumbered in the order they are drawn (see AAPLMeshOptimizer.h)
+- (id)initWithContentsOfFile:(NSString *)inputFilePath computeTangentSpace:(BOOL)computeTangentSpace normalizeNormals:(BOOL)normalizeNormals optimizeMeshes:(BOOL)optimizeMeshes;
+
+// Parses the contents of an obj file that has already been read; material libraries are still read
+// relative to inputFilePath. Safe to call from any thread.
+- (id)initWithString:(NSString *)fileString filePath:(NSString *)inputFilePath computeTangentSpace:(BOOL)computeTangentSpace normalizeNormals:(BOOL)normalizeNormals optimizeMeshes:(BOOL)optimizeMeshes;
+
 
 @property (readonly) size_t vertexDataAllocElementSize;
 
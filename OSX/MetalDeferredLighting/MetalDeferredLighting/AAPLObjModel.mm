@@ -15,6 +15,7 @@
 #include <map>
 
 #import "AAPLOBJModel.h"
+#import "AAPLMeshOptimizer.h"
 
 #define REALLOC_ELEMENT_INCREASE  1000
 
@@ -106,6 +107,7 @@ typedef std::map<FaceVertex, uint32_t> FaceVertexMap;
 - (BOOL)parseObjModeDefinitionArguments:(char *)readBuffer definitionIndex:(int)definitionIndex;
 - (BOOL)parseMtlModeDefinitionArguments:(char *)readBuffer definitionIndex:(int)definitionIndex;
 - (BOOL)constructOpenGLData;
+- (void)optimizeFaceGroups:(NSArray *)faceGroups stride:(size_t)stride;
 @end
 
 @implementation AAPLOBJModel
@@ -113,6 +115,7 @@ typedef std::map<FaceVertex, uint32_t> FaceVertexMap;
     NSString *filePath;
     BOOL shouldComputeTangentSpace;
     BOOL shouldNormalizeNormals;
+    BOOL shouldOptimizeMeshes;
     
     NSMutableArray *comments;
     NSMutableDictionary *objects;
@@ -162,6 +165,23 @@ typedef std::map<FaceVertex, uint32_t> FaceVertexMap;
 @synthesize objects;
 
 - (id)initWithContentsOfFile:(NSString *)inputFilePath computeTangentSpace:(BOOL)computeTangentSpace normalizeNormals:(BOOL)normalizeNormals
+{
+    return [self initWithContentsOfFile:inputFilePath computeTangentSpace:computeTangentSpace normalizeNormals:normalizeNormals optimizeMeshes:NO];
+}
+
+- (id)initWithContentsOfFile:(NSString *)inputFilePath computeTangentSpace:(BOOL)computeTangentSpace normalizeNormals:(BOOL)normalizeNormals optimizeMeshes:(BOOL)optimizeMeshes
+{
+    NSError *error;
+    NSString *fileString = [NSString stringWithContentsOfFile:inputFilePath encoding:NSUTF8StringEncoding error:&error];
+    if (!fileString)
+    {
+        NSLog(@"Failed to open obj file: %@, error: %@", inputFilePath, error);
+    }
+    
+    return [self initWithString:fileString filePath:inputFilePath computeTangentSpace:computeTangentSpace normalizeNormals:normalizeNormals optimizeMeshes:optimizeMeshes];
+}
+
+- (id)initWithString:(NSString *)fileString filePath:(NSString *)inputFilePath computeTangentSpace:(BOOL)computeTangentSpace normalizeNormals:(BOOL)normalizeNormals optimizeMeshes:(BOOL)optimizeMeshes
 {
     self = [super init];
     if (self)
@@ -172,14 +192,9 @@ typedef std::map<FaceVertex, uint32_t> FaceVertexMap;
         
         shouldComputeTangentSpace = computeTangentSpace;
         shouldNormalizeNormals = normalizeNormals;
+        shouldOptimizeMeshes = optimizeMeshes;
         
-        NSError *error;
-        NSString *fileString = [NSString stringWithContentsOfFile:inputFilePath encoding:NSUTF8StringEncoding error:&error];
-        if (!fileString)
-        {
-            NSLog(@"Failed to open obj file: %@, error: %@", inputFilePath, error);
-        }
-        else
+        if (fileString)
         {
             comments = [[NSMutableArray alloc] initWithCapacity:10];
             objects = [[NSMutableDictionary alloc] initWithCapacity:10];
@@ -1403,9 +1418,89 @@ DefType mtlDefTypes[MTL_D_COUNT] =
         } // for
     } // for
     
+    if (shouldOptimizeMeshes && faceDefinedVertex)
+    {
+        [self optimizeFaceGroups:faceGroups stride:stride];
+    } // if
+    
     return YES;
 }
 
+// Reorder triangles for the vertex cache and overdraw within every material range, then renumber
+// the shared vertices in the order the groups draw them
+- (void)optimizeFaceGroups:(NSArray *)faceGroups stride:(size_t)stride
+{
+    CFTimeInterval startTime = CACurrentMediaTime();
+    
+    std::vector<uint32_t> indices;
+    std::vector<AAPL::MeshOptimizer::Range> ranges;
+    
+    for (AAPLOBJModelGroup *group in faceGroups)
+    {
+        size_t first = indices.size();
+        
+        for (size_t i = 0; i < group->indexCount; ++i)
+        {
+            if (group->bytesPerIndex == 2)
+            {
+                indices.push_back(((uint16_t *)(group->indexDataInternal))[i]);
+            }
+            else
+            {
+                indices.push_back(((uint32_t *)(group->indexDataInternal))[i]);
+            }
+        } // for
+        
+        if ([group->materialUsages count] > 0)
+        {
+            for (AAPLObjMaterialUsage *materialUsage in group->materialUsages)
+            {
+                ranges.push_back({first + materialUsage->indexRange.location, materialUsage->indexRange.length});
+            } // for
+        }
+        else
+        {
+            ranges.push_back({first, group->indexCount});
+        } // else
+    } // for
+    
+    // The position is the first attribute of the interleaved vertex
+    AAPL::MeshOptimizer::Report report = AAPL::MeshOptimizer::optimize(indices.data(),
+                                                                       ranges,
+                                                                       vertexDataInternal,
+                                                                       currentVertexDataIndex,
+                                                                       stride);
+    
+    size_t first = 0;
+    
+    for (AAPLOBJModelGroup *group in faceGroups)
+    {
+        for (size_t i = 0; i < group->indexCount; ++i)
+        {
+            if (group->bytesPerIndex == 2)
+            {
+                ((uint16_t *)(group->indexDataInternal))[i] = uint16_t(indices[first + i]);
+            }
+            else
+            {
+                ((uint32_t *)(group->indexDataInternal))[i] = indices[first + i];
+            }
+        } // for
+        
+        first += group->indexCount;
+    } // for
+    
+    NSLog(@"Optimized %lu triangles in %lu ranges (%lu clusters): ACMR %.3f -> %.3f, ATVR %.3f -> %.3f in %f",
+          (unsigned long)report.before.triangles,
+          (unsigned long)ranges.size(),
+          (unsigned long)report.clusters,
+          report.before.acmr,
+          report.after.acmr,
+          report.before.atvr,
+          report.after.atvr,
+          CACurrentMediaTime() - startTime);
+}
+
 @end
 
 #pragma mark -
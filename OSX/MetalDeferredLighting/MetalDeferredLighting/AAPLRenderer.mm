@@ -13,10 +13,20 @@
 #import "AAPLView.h"
 #import "AAPLTransforms.h"
 #import "AAPLUtilities.h"
+#import "AAPLVertexQuantizer.h"
+#import "AAPLJobGraph.h"
+#import "AAPLFrameRing.h"
+#import "AAPLFrameProfiler.h"
+#import "WorkStealingPool.h"
 
 #import "common.h"
 
 #import <simd/simd.h>
+#import <memory>
+#import <sstream>
+#import <string>
+#import <unordered_map>
+#import <vector>
 
 using namespace AAPL;
 
@@ -29,11 +39,97 @@ static const float kLightRadius = 0.5f;
 // total number of frames to preapare in advanced
 static const int kMaxFrameLag = 3;
 
+// draw the temple from 24-byte quantised vertices instead of the 60-byte float ones
+static const bool kQuantizeStructure = true;
+
+// frames between draining the profiler's event rings into its histograms
+static const uint32_t kProfileCollectFrames = 120;
+
+// bytes a constant of the given size takes in a frame slot, including the alignment of its offset
+static size_t FrameConstantBytes(size_t size)
+{
+    return (size + kConstantAlignment - 1) & ~(kConstantAlignment - 1);
+}
+
+// decoding and mesh processing of the assets
+static Threads::WorkStealingPool & assetPool()
+{
+    static Threads::WorkStealingPool pool;
+    
+    return pool;
+}
+
+// shared by the jobs loading the temple
+struct StructureLoad
+{
+    NSString                                *text;
+    AAPLOBJModel                            *model;
+    AAPLOBJModelGroup                       *group;
+    std::vector<VertexQuantizer::Vertex>    quantized;
+    float4x4                                dequantization;
+};
+
+// shared by the jobs loading a texture; the pixels go with the last job holding on to them
+struct TextureLoad
+{
+    TextureLoad()
+    : data(nil)
+    {
+        info.bitmapData = NULL;
+    }
+    
+    ~TextureLoad()
+    {
+        free(info.bitmapData);
+    }
+    
+    NSData    *data;
+    ImageInfo info;
+};
+
+static id<MTLTexture> TextureOrPlaceholder(const Jobs::Future<id<MTLTexture>> &texture, id<MTLTexture> placeholder)
+{
+    return texture.ready() ? texture.get() : placeholder;
+}
+
+static bool QuantizeStructure(StructureLoad &load)
+{
+    VertexQuantizer::Layout layout = {0, VertexQuantizer::kAbsent, VertexQuantizer::kAbsent, VertexQuantizer::kAbsent, VertexQuantizer::kAbsent, VertexQuantizer::kAbsent};
+    for (AAPLObjVertexAttribute *attribute in [load.model vertexDataAttributes])
+    {
+        layout.stride = [attribute stride];
+        switch ([attribute indexType])
+        {
+            case AAPLObjVertexAttributeTypePosition:  layout.position  = [attribute offset]; break;
+            case AAPLObjVertexAttributeTypeNormal:    layout.normal    = [attribute offset]; break;
+            case AAPLObjVertexAttributeTypeTexcoord0: layout.texcoord  = [attribute offset]; break;
+            case AAPLObjVertexAttributeTypeTangent:   layout.tangent   = [attribute offset]; break;
+            case AAPLObjVertexAttributeTypeBitangent: layout.bitangent = [attribute offset]; break;
+            default: break;
+        }
+    }
+    
+    if (layout.stride == 0 || layout.position == VertexQuantizer::kAbsent)
+    {
+        NSLog(@">> ERROR: Structure vertices have no positions to quantize");
+        return false;
+    }
+    
+    const void *vertices = [[load.model vertexData] bytes];
+    size_t count = [[load.model vertexData] length] / layout.stride;
+    
+    VertexQuantizer::Bounds bounds = VertexQuantizer::bounds(vertices, count, layout);
+    load.quantized.resize(count);
+    VertexQuantizer::encode(vertices, count, layout, bounds, load.quantized.data());
+    VertexQuantizer::dequantization(bounds, (float *)&load.dequantization);
+    
+    return true;
+}
+
 @implementation AAPLRenderer {
     id <MTLCommandQueue>           _commandQueue;
     id <MTLLibrary>                _defaultLibrary;
     CFTimeInterval                 _frameTime;
-    dispatch_semaphore_t           _inflight_semaphore;
     
     float4                         _fairyColors[kNumFairies];
     float                          _fairyAngles[kNumFairies];
@@ -48,6 +144,7 @@ static const int kMaxFrameLag = 3;
     float                          _skyboxCameraRotationRate;
     float                          _skyboxScale;
     float                          _structureScale;
+    float4x4                       _structureDequantization;
     float4x4                       _projectionMatrix;
     
     id<MTLDepthStencilState>       _noDepthStencilState;
@@ -70,13 +167,23 @@ static const int kMaxFrameLag = 3;
     id<MTLRenderPipelineState>     _fairy_pipeline;
     id<MTLRenderPipelineState>     _texture_copy_pipeline;
     
-    id<MTLTexture>                 _skyboxTexture;
-    id<MTLTexture>                 _fairyTexture;
-    NSMutableArray*                _structureModelGroupDiffuseTextures;
-    NSMutableArray*                _structureModelGroupSpecularTextures;
-    NSMutableArray*                _structureModelGroupBumpTextures;
+    // textures are drawn with the placeholders until their jobs finished
+    Jobs::Future<id<MTLTexture>>   _skyboxTexture;
+    Jobs::Future<id<MTLTexture>>   _fairyTexture;
+    std::vector<Jobs::Future<id<MTLTexture>>> _structureModelGroupDiffuseTextures;
+    std::vector<Jobs::Future<id<MTLTexture>>> _structureModelGroupSpecularTextures;
+    std::vector<Jobs::Future<id<MTLTexture>>> _structureModelGroupBumpTextures;
+    
+    id<MTLTexture>                 _skyboxPlaceholder;
+    id<MTLTexture>                 _fairyPlaceholder;
+    id<MTLTexture>                 _diffusePlaceholder;
+    id<MTLTexture>                 _specularPlaceholder;
+    id<MTLTexture>                 _bumpPlaceholder;
     
-    NSMutableDictionary*           _texture2DCache;
+    std::unordered_map<std::string, Jobs::Future<id<MTLTexture>>> _texture2DCache;
+    
+    // asset loading, until every job finished
+    std::unique_ptr<Jobs::Graph>   _assetGraph;
 
     id<MTLBuffer>                  _skyboxVertexBuffer;
     id<MTLBuffer>                  _quadPositionBuffer;
@@ -87,13 +194,18 @@ static const int kMaxFrameLag = 3;
     id<MTLBuffer>                  _lightModelIndexBuffer;
     id<MTLBuffer>                  _spriteBuffer;
     
-    NSMutableArray<id<MTLBuffer>>* _lightModelMatrixBuffers;
-    NSMutableArray<id<MTLBuffer>>* _lightDataBuffers;
-    NSMutableArray<id<MTLBuffer>>* _sunDataBuffers;
-    NSMutableArray<id<MTLBuffer>>* _skyboxMatrixBuffers;
-    NSMutableArray<id<MTLBuffer>>* _modelMatricesBuffers;
-    NSMutableArray<id<MTLBuffer>>* _zOnlyProjectionBuffers;
-    NSMutableArray<id<MTLBuffer>>* _fairySpriteBuffers;
+    // one buffer per frame slot, the per-frame constants are sub-allocated from it by the ring
+    NSMutableArray<id<MTLBuffer>>* _frameBuffers;
+    std::unique_ptr<FrameRing>     _frameRing;
+    uint32_t                       _frameSlot;
+    
+    size_t                         _lightModelMatricesOffset;
+    size_t                         _lightDataOffset;
+    size_t                         _sunDataOffset;
+    size_t                         _skyboxMatrixOffset;
+    size_t                         _modelMatricesOffset;
+    size_t                         _zOnlyProjectionOffset;
+    size_t                         _fairySpriteOffset;
     
     id<MTLBuffer>                  _clearColorBuffer1;
     id<MTLBuffer>                  _clearColorBuffer2;
@@ -104,8 +216,7 @@ static const int kMaxFrameLag = 3;
     MTLIndexType                   _structureModelGroupIndexDataType;
     int                            _fairyCount;
     
-    int                            _numFrames;
-    int                            _currFrameIndex;}
+    uint32_t                       _profiledFrames;}
 
 - (instancetype)init {
     self = [super init];
@@ -139,19 +250,9 @@ static const int kMaxFrameLag = 3;
         _skyboxCameraRotationRate = 2.0f;
         _skyboxScale = 10.0f;
         
-        _structureModelGroupBumpTextures = [[NSMutableArray alloc] initWithCapacity: 10];
-        _structureModelGroupDiffuseTextures = [[NSMutableArray alloc] initWithCapacity: 10];
-        _structureModelGroupSpecularTextures = [[NSMutableArray alloc] initWithCapacity: 10];
-        
-        _texture2DCache = [NSMutableDictionary dictionaryWithCapacity:8];
+        _structureDequantization = float4x4(1.0f);
         
-        _lightDataBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
-        _lightModelMatrixBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
-        _sunDataBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
-        _skyboxMatrixBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
-        _modelMatricesBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
-        _zOnlyProjectionBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
-        _fairySpriteBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
+        _frameBuffers = [[NSMutableArray alloc] initWithCapacity: kMaxFrameLag];
         
         _fairyCount = kNumFairies;
         
@@ -162,14 +263,19 @@ static const int kMaxFrameLag = 3;
             _fairyPhases[i] = Utilities::randomFloat(0.0f, 1.0f);
             _fairySpeeds[i] = Utilities::randomFloat(5.0f, 15.0f);
         }
-        
-        _inflight_semaphore = dispatch_semaphore_create(kMaxFrameLag);
-        _numFrames = kMaxFrameLag;
-        _currFrameIndex = 0;
     }
     return self;
 }
 
+- (void)dealloc
+{
+    // the completion handlers of frames still on the GPU release their slots in the ring
+    if (_frameRing)
+    {
+        _frameRing->drain();
+    }
+}
+
 #pragma mark LOAD
 
 - (void)configure:(AAPLView *)view
@@ -231,6 +337,29 @@ static const int kMaxFrameLag = 3;
     
     id<MTLFunction> zOnlyVert = _newFunctionFromLibrary(_defaultLibrary, @"zOnly");
     
+    // quantised temple vertices are fetched through a vertex descriptor
+    MTLVertexDescriptor *quantizedVertexDesc = nil;
+    if (kQuantizeStructure)
+    {
+        gBufferVert = _newFunctionFromLibrary(_defaultLibrary, @"gBufferVertQuantized");
+        zOnlyVert = _newFunctionFromLibrary(_defaultLibrary, @"zOnlyQuantized");
+        
+        quantizedVertexDesc = [MTLVertexDescriptor vertexDescriptor];
+        quantizedVertexDesc.attributes[0].format = MTLVertexFormatShort4Normalized;
+        quantizedVertexDesc.attributes[0].offset = offsetof(VertexQuantizer::Vertex, position);
+        quantizedVertexDesc.attributes[1].format = MTLVertexFormatShort2Normalized;
+        quantizedVertexDesc.attributes[1].offset = offsetof(VertexQuantizer::Vertex, normal);
+        quantizedVertexDesc.attributes[2].format = MTLVertexFormatShort2Normalized;
+        quantizedVertexDesc.attributes[2].offset = offsetof(VertexQuantizer::Vertex, tangent);
+        quantizedVertexDesc.attributes[3].format = MTLVertexFormatShort2Normalized;
+        quantizedVertexDesc.attributes[3].offset = offsetof(VertexQuantizer::Vertex, bitangent);
+        quantizedVertexDesc.attributes[4].format = MTLVertexFormatHalf2;
+        quantizedVertexDesc.attributes[4].offset = offsetof(VertexQuantizer::Vertex, texcoord);
+        for (int i = 0; i <= 4; i++)
+            quantizedVertexDesc.attributes[i].bufferIndex = 0;
+        quantizedVertexDesc.layouts[0].stride = sizeof(VertexQuantizer::Vertex);
+    }
+    
     // Pipeline setup
     //*********************************************************************
     {
@@ -240,6 +369,7 @@ static const int kMaxFrameLag = 3;
         desc.label = @"Shadow Render";
         desc.vertexFunction = zOnlyVert;
         desc.fragmentFunction = nil;
+        desc.vertexDescriptor = quantizedVertexDesc;
         desc.depthAttachmentPixelFormat = _shadow_texture.pixelFormat;
         _shadow_render_pipeline = [_device newRenderPipelineStateWithDescriptor: desc error: &err];
         CheckPipelineError(_shadow_render_pipeline, err);
@@ -247,6 +377,7 @@ static const int kMaxFrameLag = 3;
         desc.label = @"Skybox Render";
         desc.vertexFunction = skyboxVert;
         desc.fragmentFunction = skyboxFrag;
+        desc.vertexDescriptor = nil;
         for (int i = 0; i <= 3; i++)
             desc.colorAttachments[i].pixelFormat = view->colorAttachmentFormat[i];
         desc.depthAttachmentPixelFormat = view->depthPixelFormat;
@@ -258,12 +389,14 @@ static const int kMaxFrameLag = 3;
         desc.label = @"GBuffer Render";
         desc.vertexFunction = gBufferVert;
         desc.fragmentFunction = gBufferFrag;
+        desc.vertexDescriptor = quantizedVertexDesc;
         _gbuffer_render_pipeline = [_device newRenderPipelineStateWithDescriptor: desc error: &err];
         CheckPipelineError(_gbuffer_render_pipeline, err);
 
         desc.label = @"Light Mask Render";
         desc.vertexFunction = lightVert;
         desc.fragmentFunction = nil;
+        desc.vertexDescriptor = nil;
         //Have active rendertargets but don't want to write to color
         //setup a blendsetate with no color writes for light mask pipeline
         for (int i = 0; i <= 3; i++)
@@ -430,22 +563,18 @@ static const int kMaxFrameLag = 3;
     
     NSBundle *bundle = [NSBundle mainBundle];
     NSString *bundlePath = [bundle pathForResource: @"Temple" ofType: @"obj"];
-    _structureModel = [[AAPLOBJModel alloc] initWithContentsOfFile:bundlePath computeTangentSpace: YES normalizeNormals: NO];
-    _structureModelGroup = [[[_structureModel objects] objectForKey: AAPLOBJModelObjectDefaultKey] objectForKey: @"cage_stairs_01"];
     
-    assert(_structureModel);
-    assert(_structureModelGroup);
+    // Assets are loaded by jobs and uploaded from update:, the first frames draw with placeholders
+    _assetGraph.reset(new Jobs::Graph(assetPool()));
     
-    _structureVertexBuffer   =  [_device newBufferWithBytes:[[_structureModel vertexData] bytes] length:[[_structureModel vertexData] length] options:0];
-    [_structureVertexBuffer setLabel:@"structure vertices"];
-    _structureIndexBuffer    =  [_device newBufferWithBytes:[[_structureModelGroup indexData] bytes] length:[[_structureModelGroup indexData] length] options:0];
-    [_structureIndexBuffer setLabel:@"structure indices"];
+    float4 skyColor = _clear_color_buffers.albedo_clear_color * 255.0f;
+    _skyboxPlaceholder = [self newPlaceholderTextureWithPixelFormat:MTLPixelFormatRGBA8Unorm color:0xFF000000 | (uint32_t(skyColor.z) << 16) | (uint32_t(skyColor.y) << 8) | uint32_t(skyColor.x) cube:YES];
+    _fairyPlaceholder = [self newPlaceholderTextureWithPixelFormat:MTLPixelFormatR8Unorm color:0 cube:NO];
+    _diffusePlaceholder = [self newPlaceholderTextureWithPixelFormat:MTLPixelFormatRGBA8Unorm color:0xFF808080 cube:NO];
+    _specularPlaceholder = [self newPlaceholderTextureWithPixelFormat:MTLPixelFormatRGBA8Unorm color:0xFF000000 cube:NO];
+    _bumpPlaceholder = [self newPlaceholderTextureWithPixelFormat:MTLPixelFormatRGBA8Unorm color:0xFFFF8080 cube:NO];
     
-    _structureModelGroupIndexDataType = MTLIndexTypeUInt16;
-    if([_structureModelGroup bytesPerIndex] == 4)
-    {
-        _structureModelGroupIndexDataType = MTLIndexTypeUInt32;
-    }
+    [self loadStructureWithContentsOfFile:bundlePath];
     
     static float vdata[24][4] =
     {
@@ -596,101 +725,256 @@ static const int kMaxFrameLag = 3;
     _clearColorBuffer2 = [_device newBufferWithBytes:&((float&)_clear_color_buffers.light_buffer_clear_color.x) length:sizeof(_clear_color_buffers.light_buffer_clear_color) options:0];
     [_clearColorBuffer2 setLabel:@"clear color buffer 2"];
     
-    //Setup dynamic constant buffers
-    for(int i = 0; i < _numFrames; i++)
+    //Setup dynamic constant buffers, one per frame slot holding every constant of a frame
+    size_t frameBytes = 3 * FrameConstantBytes(sizeof(float4x4))
+                      + FrameConstantBytes(sizeof(ModelMatrices))
+                      + FrameConstantBytes(sizeof(LightModelMatrices) * _fairyCount)
+                      + FrameConstantBytes(sizeof(LightFragmentInputs) * (_fairyCount + 1))
+                      + FrameConstantBytes(sizeof(MaterialSunData));
+    
+    std::vector<FrameRing::Slot> slots;
+    for(int i = 0; i < kMaxFrameLag; i++)
     {
-        [_zOnlyProjectionBuffers addObject: [_device newBufferWithLength: sizeof(float4x4) options:0]];
-        [[_zOnlyProjectionBuffers lastObject] setLabel:@"z-only projection"];
-        [_skyboxMatrixBuffers addObject: [_device newBufferWithLength: sizeof(float4x4) options:0]];
-        [[_skyboxMatrixBuffers lastObject] setLabel:@"skybox matrix"];
-        [_modelMatricesBuffers addObject: [_device newBufferWithLength: sizeof(ModelMatrices) options:0]];
-        [[_modelMatricesBuffers lastObject] setLabel:@"model matrices"];
-        [_lightModelMatrixBuffers addObject: [_device newBufferWithLength: sizeof(LightModelMatrices)* _fairyCount options:0]];
-        [[_lightModelMatrixBuffers lastObject] setLabel:@"light model matrices"];
-        [_lightDataBuffers addObject: [_device newBufferWithLength: sizeof(LightFragmentInputs)*(_fairyCount + 1) options:0]];
-        [[_lightDataBuffers lastObject] setLabel:@"light fragment inputs"];
-        [_sunDataBuffers addObject: [_device newBufferWithLength: sizeof(MaterialSunData) options:0]];
-        [[_sunDataBuffers lastObject] setLabel:@"sun data"];
-        [_fairySpriteBuffers addObject: [_device newBufferWithLength: sizeof(float4x4) options:0]];
-        [[_fairySpriteBuffers lastObject] setLabel:@"fairy sprite transform"];
+        [_frameBuffers addObject: [_device newBufferWithLength: frameBytes options:0]];
+        [[_frameBuffers lastObject] setLabel:@"frame constants"];
+        slots.push_back({[[_frameBuffers lastObject] contents], frameBytes});
     }
+    _frameRing.reset(new FrameRing(slots));
     
     //Load other model data and textures
     bundlePath = [bundle pathForResource:@"skybox" ofType:@"png"];
-    _skyboxTexture = [self loadCubeTextureWithName:[bundlePath UTF8String]];
-    [_skyboxTexture setLabel:@"skybox"];
+    _skyboxTexture = [self loadCubeTextureWithName:bundlePath];
     
     bundlePath = [bundle pathForResource:@"fairy" ofType:@"png"];
-    _fairyTexture = [self load2DTextureWithName:[bundlePath UTF8String] pixelFormat:MTLPixelFormatR8Unorm];
-    [_fairyTexture setLabel:@"fairy"];
-    
-    [self loadModel];
+    _fairyTexture = [self load2DTextureWithName:bundlePath pixelFormat:MTLPixelFormatR8Unorm after:std::vector<Jobs::Job>()];
 }
 
-- (id<MTLTexture>)load2DTextureWithName:(const char *)name pixelFormat:(MTLPixelFormat) format
+- (id<MTLTexture>)newPlaceholderTextureWithPixelFormat:(MTLPixelFormat)format color:(uint32_t)color cube:(BOOL)cube
 {
-    NSString *hashKey = [NSString stringWithFormat:@"%s@%d", name, (int)format];
-    id<MTLTexture> texture = _texture2DCache[hashKey];
-    if (texture)
+    MTLTextureDescriptor *desc = cube ? [MTLTextureDescriptor textureCubeDescriptorWithPixelFormat: format size: 1 mipmapped: NO]
+                                      : [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: format width: 1 height: 1 mipmapped: NO];
+    id<MTLTexture> texture = [_device newTextureWithDescriptor: desc];
+    
+    for (int i = 0; i < (cube ? 6 : 1); i++)
     {
-        return texture;
+        [texture replaceRegion:MTLRegionMake2D(0, 0, 1, 1)
+                   mipmapLevel:0
+                         slice:i
+                     withBytes:&color
+                   bytesPerRow:sizeof(color)
+                 bytesPerImage:sizeof(color)];
     }
     
-    ImageInfo tex_info;
-    CreateImageInfo(name, tex_info);
+    [texture setLabel:@"placeholder"];
     
-    if (tex_info.bitmapData == NULL) return nil;
+    return texture;
+}
+
+// Read on the I/O lane, parsed and quantized on the pool, buffers made on the render thread
+- (void)loadStructureWithContentsOfFile:(NSString *)path
+{
+    std::shared_ptr<StructureLoad> load = std::make_shared<StructureLoad>();
+    __weak AAPLRenderer *weakSelf = self;
+    
+    Jobs::Job read = _assetGraph->add(Jobs::eLaneIO, [load, path] {
+        NSError *error = nil;
+        load->text = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:&error];
+        if (!load->text)
+        {
+            NSLog(@">> ERROR: Failed to read %@: %@", path, error);
+            return false;
+        }
+        return true;
+    }, std::vector<Jobs::Job>(), "read Temple.obj");
+    
+    Jobs::Job parse = _assetGraph->add(Jobs::eLaneCompute, [load, path] {
+        @autoreleasepool
+        {
+            load->model = [[AAPLOBJModel alloc] initWithString:load->text filePath:path computeTangentSpace: YES normalizeNormals: NO optimizeMeshes: YES];
+            load->group = [[[load->model objects] objectForKey: AAPLOBJModelObjectDefaultKey] objectForKey: @"cage_stairs_01"];
+            load->text = nil;
+        }
+        if (!load->group)
+        {
+            NSLog(@">> ERROR: Failed to find group cage_stairs_01 in %@", path);
+            return false;
+        }
+        return true;
+    }, {read}, "parse Temple.obj");
     
-    if (tex_info.hasAlpha == false && tex_info.bitsPerPixel >= 24)
+    Jobs::Job quantize = parse;
+    if (kQuantizeStructure)
     {
-        RGB8ImageToRGBA8(&tex_info);
+        quantize = _assetGraph->add(Jobs::eLaneCompute, [load] {
+            @autoreleasepool
+            {
+                return QuantizeStructure(*load);
+            }
+        }, {parse}, "quantize Temple.obj");
     }
     
-    texture =[_device newTextureWithDescriptor: [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: format width: tex_info.width height: tex_info.height mipmapped: NO]];
+    _assetGraph->add(Jobs::eLaneRender, [load, weakSelf, parse] {
+        return [weakSelf didLoadStructure:*load after:parse] == YES;
+    }, {quantize}, "upload Temple.obj");
+}
+
+// Runs on the render thread; the structure is drawn from the next frame on
+- (BOOL)didLoadStructure:(const StructureLoad &)load after:(Jobs::Job)parse
+{
+    if (kQuantizeStructure)
+    {
+        _structureVertexBuffer = [_device newBufferWithBytes:load.quantized.data() length:load.quantized.size() * sizeof(VertexQuantizer::Vertex) options:0];
+        _structureDequantization = load.dequantization;
+    }
+    else
+    {
+        _structureVertexBuffer = [_device newBufferWithBytes:[[load.model vertexData] bytes] length:[[load.model vertexData] length] options:0];
+    }
+    [_structureVertexBuffer setLabel:@"structure vertices"];
+    _structureIndexBuffer    =  [_device newBufferWithBytes:[[load.group indexData] bytes] length:[[load.group indexData] length] options:0];
+    [_structureIndexBuffer setLabel:@"structure indices"];
     
-    [texture replaceRegion:MTLRegionMake2D(0, 0, tex_info.width, tex_info.height)
-               mipmapLevel:0
-                 withBytes:tex_info.bitmapData
-               bytesPerRow:tex_info.width * tex_info.bitsPerPixel / 8];
+    _structureModelGroupIndexDataType = MTLIndexTypeUInt16;
+    if([load.group bytesPerIndex] == 4)
+    {
+        _structureModelGroupIndexDataType = MTLIndexTypeUInt32;
+    }
     
-    free(tex_info.bitmapData);
+    _structureModel = load.model;
+    _structureModelGroup = load.group;
     
-    _texture2DCache[hashKey] = texture;
+    // the material names are only known once the model is parsed
+    [self loadModelAfter:parse];
     
-    return texture;
+    return YES;
 }
 
-- (id<MTLTexture>)loadCubeTextureWithName:(const char *)name
+// Read on the I/O lane, decoded on the pool, uploaded on the render thread. Cached by name and format.
+- (Jobs::Future<id<MTLTexture>>)load2DTextureWithName:(NSString *)path pixelFormat:(MTLPixelFormat)format after:(const std::vector<Jobs::Job> &)dependencies
 {
-    ImageInfo tex_info;
-    CreateImageInfo(name, tex_info);
-    
-    if (tex_info.bitmapData == NULL) return nil;
-    
-    if (tex_info.hasAlpha == 0)
+    Jobs::Future<id<MTLTexture>> texture;
+    if (!path)
     {
-        RGB8ImageToRGBA8(&tex_info);
+        texture.fail();
+        return texture;
     }
     
-    unsigned Npixels = tex_info.width * tex_info.width;
-    id<MTLTexture> texture = [_device newTextureWithDescriptor: [MTLTextureDescriptor textureCubeDescriptorWithPixelFormat: MTLPixelFormatRGBA8Unorm size: tex_info.width mipmapped: NO]];
-    
-    for (int i = 0; i < 6; i++)
+    std::string hashKey = std::string([path UTF8String]) + "@" + std::to_string((int)format);
+    auto cached = _texture2DCache.find(hashKey);
+    if (cached != _texture2DCache.end())
     {
-        [texture replaceRegion:MTLRegionMake2D(0, 0, tex_info.width, tex_info.width)
-                   mipmapLevel:0
-                         slice:i
-                     withBytes:(uint8_t *)(tex_info.bitmapData) + (i * Npixels * 4)
-                   bytesPerRow:4 * tex_info.width
-                 bytesPerImage:Npixels * 4];
+        return cached->second;
     }
     
-    free(tex_info.bitmapData);
+    _texture2DCache[hashKey] = texture;
+    
+    std::shared_ptr<TextureLoad> load = std::make_shared<TextureLoad>();
+    id<MTLDevice> device = _device;
+    NSString *label = [[path lastPathComponent] stringByDeletingPathExtension];
+    
+    Jobs::Job read = _assetGraph->add(Jobs::eLaneIO, [load, path] {
+        load->data = [NSData dataWithContentsOfFile:path];
+        if (!load->data)
+        {
+            NSLog(@">> ERROR: Failed to read %@", path);
+            return false;
+        }
+        return true;
+    }, dependencies, "read texture");
+    
+    Jobs::Job decode = _assetGraph->add(Jobs::eLaneCompute, [load] {
+        @autoreleasepool
+        {
+            CreateImageInfoFromData(load->data, load->info);
+            load->data = nil;
+        }
+        if (load->info.bitmapData == NULL)
+        {
+            return false;
+        }
+        if (load->info.hasAlpha == false && load->info.bitsPerPixel >= 24)
+        {
+            RGB8ImageToRGBA8(&load->info);
+        }
+        return true;
+    }, {read}, "decode texture");
+    
+    _assetGraph->add(Jobs::eLaneRender, [load, device, format, label, texture]() mutable {
+        const ImageInfo &tex_info = load->info;
+        id<MTLTexture> result = [device newTextureWithDescriptor: [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: format width: tex_info.width height: tex_info.height mipmapped: NO]];
+        
+        [result replaceRegion:MTLRegionMake2D(0, 0, tex_info.width, tex_info.height)
+                  mipmapLevel:0
+                    withBytes:tex_info.bitmapData
+                  bytesPerRow:tex_info.width * tex_info.bitsPerPixel / 8];
+        [result setLabel:label];
+        
+        texture.set(result);
+        return true;
+    }, {decode}, "upload texture");
+    
+    return texture;
+}
+
+// The six faces are stacked vertically in the image
+- (Jobs::Future<id<MTLTexture>>)loadCubeTextureWithName:(NSString *)path
+{
+    Jobs::Future<id<MTLTexture>> texture;
+    
+    std::shared_ptr<TextureLoad> load = std::make_shared<TextureLoad>();
+    id<MTLDevice> device = _device;
+    
+    Jobs::Job read = _assetGraph->add(Jobs::eLaneIO, [load, path] {
+        load->data = [NSData dataWithContentsOfFile:path];
+        if (!load->data)
+        {
+            NSLog(@">> ERROR: Failed to read %@", path);
+            return false;
+        }
+        return true;
+    }, std::vector<Jobs::Job>(), "read cube texture");
+    
+    Jobs::Job decode = _assetGraph->add(Jobs::eLaneCompute, [load] {
+        @autoreleasepool
+        {
+            CreateImageInfoFromData(load->data, load->info);
+            load->data = nil;
+        }
+        if (load->info.bitmapData == NULL)
+        {
+            return false;
+        }
+        if (load->info.hasAlpha == 0)
+        {
+            RGB8ImageToRGBA8(&load->info);
+        }
+        return true;
+    }, {read}, "decode cube texture");
+    
+    _assetGraph->add(Jobs::eLaneRender, [load, device, texture]() mutable {
+        const ImageInfo &tex_info = load->info;
+        unsigned Npixels = tex_info.width * tex_info.width;
+        id<MTLTexture> result = [device newTextureWithDescriptor: [MTLTextureDescriptor textureCubeDescriptorWithPixelFormat: MTLPixelFormatRGBA8Unorm size: tex_info.width mipmapped: NO]];
+        
+        for (int i = 0; i < 6; i++)
+        {
+            [result replaceRegion:MTLRegionMake2D(0, 0, tex_info.width, tex_info.width)
+                      mipmapLevel:0
+                            slice:i
+                        withBytes:(uint8_t *)(tex_info.bitmapData) + (i * Npixels * 4)
+                      bytesPerRow:4 * tex_info.width
+                    bytesPerImage:Npixels * 4];
+        }
+        [result setLabel:@"skybox"];
+        
+        texture.set(result);
+        return true;
+    }, {decode}, "upload cube texture");
     
     return texture;
 }
 
-- (void)loadModel
+- (void)loadModelAfter:(Jobs::Job)parse
 {
     if (_structureModelGroup)
     {
@@ -699,6 +983,8 @@ static const int kMaxFrameLag = 3;
         NSLog(@"IndexData count: %lu", [_structureModelGroup indexCount]);
         
         
+        std::vector<Jobs::Job> dependencies(1, parse);
+        
         int i = 0;
         for (AAPLObjMaterialUsage *materialUsage in [_structureModelGroup materialUsages])
         {
@@ -707,15 +993,16 @@ static const int kMaxFrameLag = 3;
                   (unsigned long)[materialUsage indexRange].location,
                   (unsigned long)[materialUsage indexRange].length);
             
+            // every material gets an entry, missing maps stay placeholders
+            Jobs::Future<id<MTLTexture>> diffuse, specular, bump;
+            
             if ([[materialUsage material] diffuseMapName])
             {
                 NSString *diffuseMapResourceNameAndType = [[materialUsage material] diffuseMapName];
                 NSArray *compAry = [diffuseMapResourceNameAndType componentsSeparatedByString: @"."];
                 NSBundle *bundle = [NSBundle mainBundle];
                 NSString *bundlePath = [bundle pathForResource: [compAry objectAtIndex: 0] ofType: [compAry objectAtIndex: 1]];
-                id<MTLTexture> texture = [self load2DTextureWithName:[bundlePath UTF8String] pixelFormat:MTLPixelFormatRGBA8Unorm];
-                [texture setLabel:[[bundlePath lastPathComponent] stringByDeletingPathExtension]];
-                [_structureModelGroupDiffuseTextures addObject: texture];
+                diffuse = [self load2DTextureWithName:bundlePath pixelFormat:MTLPixelFormatRGBA8Unorm after:dependencies];
             }
             
             if ([[materialUsage material] specularMapName])
@@ -724,9 +1011,7 @@ static const int kMaxFrameLag = 3;
                 NSArray *compAry = [specularMapResourceNameAndType componentsSeparatedByString: @"."];
                 NSBundle *bundle = [NSBundle mainBundle];
                 NSString *bundlePath = [bundle pathForResource: [compAry objectAtIndex: 0] ofType: [compAry objectAtIndex: 1]];
-                id<MTLTexture> texture = [self load2DTextureWithName:[bundlePath UTF8String] pixelFormat:MTLPixelFormatRGBA8Unorm];
-                [texture setLabel:[[bundlePath lastPathComponent] stringByDeletingPathExtension]];
-                [_structureModelGroupSpecularTextures addObject: texture];
+                specular = [self load2DTextureWithName:bundlePath pixelFormat:MTLPixelFormatRGBA8Unorm after:dependencies];
             }
             
             if ([[materialUsage material] bumpMapName])
@@ -735,11 +1020,12 @@ static const int kMaxFrameLag = 3;
                 NSArray *compAry = [bumpMapResourceNameAndType componentsSeparatedByString: @"."];
                 NSBundle *bundle = [NSBundle mainBundle];
                 NSString *bundlePath = [bundle pathForResource: [compAry objectAtIndex: 0] ofType: [compAry objectAtIndex: 1]];
-                id<MTLTexture> texture = [self load2DTextureWithName:[bundlePath UTF8String] pixelFormat:MTLPixelFormatRGBA8Unorm];
-                [texture setLabel:[[bundlePath lastPathComponent] stringByDeletingPathExtension]];
-                [_structureModelGroupBumpTextures addObject: texture];
-                
+                bump = [self load2DTextureWithName:bundlePath pixelFormat:MTLPixelFormatRGBA8Unorm after:dependencies];
             }
+            
+            _structureModelGroupDiffuseTextures.push_back(diffuse);
+            _structureModelGroupSpecularTextures.push_back(specular);
+            _structureModelGroupBumpTextures.push_back(bump);
             i++;
         }
         
@@ -753,11 +1039,45 @@ static const int kMaxFrameLag = 3;
 
 - (void)render:(AAPLView *)view
 {
-    dispatch_semaphore_wait(_inflight_semaphore, DISPATCH_TIME_FOREVER);
+    AAPL_PROFILE_SCOPE(Profile::eCategoryFrame);
+    
+    // wait for the slot of the frame kMaxFrameLag frames back, then fill in this frame's constants
+    {
+        AAPL_PROFILE_SCOPE(Profile::eCategorySemaphoreWait);
+        _frameRing->beginFrame();
+    }
+    {
+        AAPL_PROFILE_SCOPE(Profile::eCategoryUpdate);
+        [self updateFrameConstants];
+    }
     
     // create a new command buffer for each renderpass to the current drawable
     id <MTLCommandBuffer> commandBuffer = [_commandQueue commandBuffer];
     
+    {
+        AAPL_PROFILE_SCOPE(Profile::eCategoryEncode);
+        [self encodeFrameForView:view commandBuffer:commandBuffer];
+    }
+    
+    FrameRing *frameRing = _frameRing.get();
+    uint64_t frame = _frameRing->endFrame();
+    [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+        frameRing->complete(frame);
+    }];
+    
+    // schedule a present once the framebuffer is complete
+    [commandBuffer presentDrawable:view.currentDrawable];
+    [commandBuffer commit];
+    
+    // drain the per-thread event rings before they fill up
+    if (++_profiledFrames % kProfileCollectFrames == 0)
+    {
+        Profile::Profiler::shared().collect();
+    }
+}
+
+- (void)encodeFrameForView:(AAPLView *)view commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+{
     // 1st pass (shadow depth map pass)
     [self renderShadowBufferForTime:_frameTime commandBuffer:commandBuffer];
 
@@ -779,7 +1099,7 @@ static const int kMaxFrameLag = 3;
     [encoder pushDebugGroup:@"sun"];
     [encoder setRenderPipelineState: _composition_pipeline];
     [encoder setCullMode: MTLCullModeNone];
-    [encoder setFragmentBuffer: _sunDataBuffers[_currFrameIndex] offset: 0 atIndex: 0];
+    [encoder setFragmentBuffer: _frameBuffers[_frameSlot] offset: _sunDataOffset atIndex: 0];
     
     [encoder setDepthStencilState: _compositionDepthState];
     [encoder setStencilReferenceValue: 128];
@@ -795,10 +1115,10 @@ static const int kMaxFrameLag = 3;
     [encoder setDepthStencilState: _noDepthStencilState];
     [encoder setCullMode: MTLCullModeNone];
     
-    [encoder setVertexBuffer: _lightDataBuffers[_currFrameIndex] offset: 0 atIndex: 0];
-    [encoder setVertexBuffer: _fairySpriteBuffers[_currFrameIndex] offset: 0 atIndex: 1];
+    [encoder setVertexBuffer: _frameBuffers[_frameSlot] offset: _lightDataOffset atIndex: 0];
+    [encoder setVertexBuffer: _frameBuffers[_frameSlot] offset: _fairySpriteOffset atIndex: 1];
     
-    [encoder setFragmentTexture: _fairyTexture atIndex: 0];
+    [encoder setFragmentTexture: TextureOrPlaceholder(_fairyTexture, _fairyPlaceholder) atIndex: 0];
     [encoder setFragmentBuffer: _spriteBuffer offset: 0 atIndex: 0];
     
     [encoder drawPrimitives: MTLPrimitiveTypePoint vertexStart: 0 vertexCount: _fairyCount];
@@ -809,17 +1129,6 @@ static const int kMaxFrameLag = 3;
     // End 2nd pass (Gbuffer Pass)
     [encoder popDebugGroup];
     [encoder endEncoding];
-    
-    __block dispatch_semaphore_t block_sema = _inflight_semaphore;
-    [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
-        dispatch_semaphore_signal(block_sema);
-    }];
-    
-    _currFrameIndex = (_currFrameIndex + 1)  % _numFrames;
-    
-    // schedule a present once the framebuffer is complete
-    [commandBuffer presentDrawable:view.currentDrawable];
-    [commandBuffer commit];
 }
 
 - (void)drawQuadWithRect:(id<MTLRenderCommandEncoder>) encoder offset:(int)quadOffset useTexture:(bool)textured
@@ -849,7 +1158,7 @@ static const int kMaxFrameLag = 3;
     [encoder setCullMode: MTLCullModeFront];
     [encoder setDepthBias: 0.01 slopeScale: 1.0f clamp: 0.01];
     
-    [encoder setVertexBuffer: _zOnlyProjectionBuffers[_currFrameIndex] offset: 0 atIndex: 1];
+    [encoder setVertexBuffer: _frameBuffers[_frameSlot] offset: _zOnlyProjectionOffset atIndex: 1];
     [encoder setVertexBuffer: _structureVertexBuffer offset: 0 atIndex: 0];
     
     for (AAPLObjMaterialUsage *materialUsage in [_structureModelGroup materialUsages])
@@ -870,9 +1179,9 @@ static const int kMaxFrameLag = 3;
     [encoder setRenderPipelineState: _skybox_render_pipeline];
     
     [encoder setVertexBuffer: _skyboxVertexBuffer offset: 0 atIndex: 0];
-    [encoder setVertexBuffer: _skyboxMatrixBuffers[_currFrameIndex] offset: 0 atIndex: 1];
+    [encoder setVertexBuffer: _frameBuffers[_frameSlot] offset: _skyboxMatrixOffset atIndex: 1];
     
-    [encoder setFragmentTexture: _skyboxTexture atIndex: 0];
+    [encoder setFragmentTexture: TextureOrPlaceholder(_skyboxTexture, _skyboxPlaceholder) atIndex: 0];
     
     //Bind pixel constants
     [encoder setFragmentBuffer: _clearColorBuffer1 offset: 0 atIndex: 0];
@@ -892,7 +1201,7 @@ static const int kMaxFrameLag = 3;
     [encoder setStencilReferenceValue: 128];
     
     [encoder setVertexBuffer: _structureVertexBuffer offset: 0 atIndex: 0];
-    [encoder setVertexBuffer: _modelMatricesBuffers[_currFrameIndex]  offset: 0 atIndex: 1];
+    [encoder setVertexBuffer: _frameBuffers[_frameSlot] offset: _modelMatricesOffset atIndex: 1];
     
     [encoder setFragmentBuffer: _clearColorBuffer2 offset: 0 atIndex: 0];
     
@@ -900,9 +1209,9 @@ static const int kMaxFrameLag = 3;
     for (AAPLObjMaterialUsage *materialUsage in [_structureModelGroup materialUsages])
     {
         
-        [encoder setFragmentTexture: _structureModelGroupBumpTextures[i] atIndex: 0];
-        [encoder setFragmentTexture: _structureModelGroupDiffuseTextures[i] atIndex: 1];
-        [encoder setFragmentTexture: _structureModelGroupSpecularTextures[i] atIndex: 2];
+        [encoder setFragmentTexture: TextureOrPlaceholder(_structureModelGroupBumpTextures[i], _bumpPlaceholder) atIndex: 0];
+        [encoder setFragmentTexture: TextureOrPlaceholder(_structureModelGroupDiffuseTextures[i], _diffusePlaceholder) atIndex: 1];
+        [encoder setFragmentTexture: TextureOrPlaceholder(_structureModelGroupSpecularTextures[i], _specularPlaceholder) atIndex: 2];
         [encoder setFragmentTexture: _shadow_texture atIndex: 3];
         i++;
         
@@ -919,11 +1228,9 @@ static const int kMaxFrameLag = 3;
     
     float near = 0.1f;
 
-    id<MTLBuffer> lightModelMatricesBuffer = _lightModelMatrixBuffers[_currFrameIndex];
-    id<MTLBuffer> lightDataBuffer = _lightDataBuffers[_currFrameIndex];
-    
-    LightFragmentInputs *gpuLights = (LightFragmentInputs *)[lightDataBuffer contents];
-    LightModelMatrices *matrixData = (LightModelMatrices *)[lightModelMatricesBuffer contents];
+    LightFragmentInputs *gpuLights = _frameRing->allocate<LightFragmentInputs>(_fairyCount + 1, &_lightDataOffset, &_frameSlot);
+    LightModelMatrices *matrixData = _frameRing->allocate<LightModelMatrices>(_fairyCount, &_lightModelMatricesOffset, &_frameSlot);
+    id<MTLBuffer> frameBuffer = _frameBuffers[_frameSlot];
     
     LightModelMatrices fairyMatrices[kNumFairies];
     float4x4 structureCameraMatrix = [self cameraMatrixForTime:_frameTime rateOfRotation:_structureCameraRotationRate];
@@ -959,7 +1266,7 @@ static const int kMaxFrameLag = 3;
         [encoder setCullMode: MTLCullModeFront];
         
         [encoder setVertexBuffer: _lightModelVertexBuffer offset: 0 atIndex: 0];
-        [encoder setVertexBuffer: lightModelMatricesBuffer offset: i * sizeof(LightModelMatrices) atIndex: 1];
+        [encoder setVertexBuffer: frameBuffer offset: _lightModelMatricesOffset + i * sizeof(LightModelMatrices) atIndex: 1];
         [encoder drawIndexedPrimitives: MTLPrimitiveTypeTriangle indexCount: 60 indexType: MTLIndexTypeUInt16 indexBuffer: _lightModelIndexBuffer indexBufferOffset: 0];
         
         // end stencil
@@ -983,9 +1290,9 @@ static const int kMaxFrameLag = 3;
         [encoder setStencilReferenceValue: 128];
         
         [encoder setVertexBuffer: _lightModelVertexBuffer offset: 0 atIndex: 0];
-        [encoder setVertexBuffer: lightModelMatricesBuffer offset: i * sizeof(LightModelMatrices) atIndex: 1];
+        [encoder setVertexBuffer: frameBuffer offset: _lightModelMatricesOffset + i * sizeof(LightModelMatrices) atIndex: 1];
         
-        [encoder setFragmentBuffer: lightDataBuffer offset: i * sizeof(LightFragmentInputs) atIndex: 0];
+        [encoder setFragmentBuffer: frameBuffer offset: _lightDataOffset + i * sizeof(LightFragmentInputs) atIndex: 0];
         
         [encoder drawIndexedPrimitives: MTLPrimitiveTypeTriangle indexCount: 60 indexType: MTLIndexTypeUInt16 indexBuffer: _lightModelIndexBuffer indexBufferOffset: 0];
         
@@ -1011,11 +1318,20 @@ static const int kMaxFrameLag = 3;
 {
     _frameTime += controller.timeSinceLastDraw;
     
+    // polling finishes the staged uploads, kept apart from the per-frame constant updates
+    AAPL_PROFILE_SCOPE(Profile::eCategoryAssets);
+    
+    [self pollAssets];
+}
+
+// Called between beginFrame and endFrame of the ring, so the slot the constants go to is no longer read by the GPU
+- (void)updateFrameConstants
+{
     // update shadow matrix for shadow pass
     float4x4 shadowMatrix = [self shadowMatrixForTime:_frameTime];
     float4x4 scaleMatrix = scale(_structureScale, _structureScale, _structureScale);
-    shadowMatrix = shadowMatrix * scaleMatrix;
-    memcpy([_zOnlyProjectionBuffers[_currFrameIndex] contents], &shadowMatrix, sizeof(float4x4));
+    shadowMatrix = shadowMatrix * scaleMatrix * _structureDequantization;
+    memcpy(_frameRing->allocate<float4x4>(1, &_zOnlyProjectionOffset, &_frameSlot), &shadowMatrix, sizeof(float4x4));
     
     // -------- skybox updates -------- //
     float4x4 skyboxCameraMatrix = [self cameraMatrixForTime:_frameTime rateOfRotation:_skyboxCameraRotationRate];
@@ -1025,31 +1341,33 @@ static const int kMaxFrameLag = 3;
     // shadow matrix buffer
     float4x4 skyboxModelViewProjectionMatrix = _projectionMatrix;
     skyboxModelViewProjectionMatrix = skyboxModelViewProjectionMatrix * skyboxCameraMatrix;
-    memcpy([_skyboxMatrixBuffers[_currFrameIndex] contents], &skyboxModelViewProjectionMatrix, sizeof(float4x4));
+    memcpy(_frameRing->allocate<float4x4>(1, &_skyboxMatrixOffset, &_frameSlot), &skyboxModelViewProjectionMatrix, sizeof(float4x4));
     
     // calculate camera matrix
     float4x4 cameraMatrix = [self cameraMatrixForTime:_frameTime rateOfRotation:_structureCameraRotationRate];
     float3x4 normalMatrix(cameraMatrix.columns[0], cameraMatrix.columns[1], cameraMatrix.columns[2]);
 
     // ------- gBuffer structure updates ------- //
-    ModelMatrices* gBuffermatrixState = (ModelMatrices*)[_modelMatricesBuffers[_currFrameIndex] contents];
+    ModelMatrices* gBuffermatrixState = _frameRing->allocate<ModelMatrices>(1, &_modelMatricesOffset, &_frameSlot);
     gBuffermatrixState->mvMatrix = cameraMatrix;
     scaleMatrix = scale(_structureScale, _structureScale, _structureScale);
     gBuffermatrixState->mvMatrix = gBuffermatrixState->mvMatrix * scaleMatrix;
     
     //Inverse and Transpose the model matrix for the normal matrix....but if it's just a rotation and uniform scale
     //Inverse is the transpose so just copy it over.
+    //Normals are decoded in object space, so the dequantization stays out of the normal matrix.
     gBuffermatrixState->normalMatrix = gBuffermatrixState->mvMatrix;
+    gBuffermatrixState->mvMatrix = gBuffermatrixState->mvMatrix * _structureDequantization;
     gBuffermatrixState->mvpMatrix = _projectionMatrix;
     gBuffermatrixState->mvpMatrix = gBuffermatrixState->mvpMatrix * gBuffermatrixState->mvMatrix;
     
     gBuffermatrixState->shadowMatrix = translate(0.5f, 0.5f, 0.0f);
     gBuffermatrixState->shadowMatrix = gBuffermatrixState->shadowMatrix * scale(0.5f, -0.5f, 1.0f);
     gBuffermatrixState->shadowMatrix = gBuffermatrixState->shadowMatrix * [self shadowMatrixForTime:_frameTime];
-    gBuffermatrixState->shadowMatrix = gBuffermatrixState->shadowMatrix * scaleMatrix;
+    gBuffermatrixState->shadowMatrix = gBuffermatrixState->shadowMatrix * scaleMatrix * _structureDequantization;
     
     // ------- sun updates ------- //
-    MaterialSunData* sunData = (MaterialSunData*)[_sunDataBuffers[_currFrameIndex] contents];
+    MaterialSunData* sunData = _frameRing->allocate<MaterialSunData>(1, &_sunDataOffset, &_frameSlot);
     float3 direction = [self sunDirectionForTime:_frameTime];
     sunData->sunDirection = {direction.x, direction.y, direction.z, 0.0f};
     sunData->sunColor = {1.0f, 0.875f, 0.75f, 1.0f};
@@ -1059,7 +1377,44 @@ static const int kMaxFrameLag = 3;
     // ------- fairy sprites ------- //
     float4x4 mvpMatrix = _projectionMatrix;
     mvpMatrix = mvpMatrix * cameraMatrix;
-    memcpy([_fairySpriteBuffers[_currFrameIndex] contents], &mvpMatrix, sizeof(float4x4));
+    memcpy(_frameRing->allocate<float4x4>(1, &_fairySpriteOffset, &_frameSlot), &mvpMatrix, sizeof(float4x4));
+}
+
+// Runs the asset jobs that upload to the GPU and reports the load once every job finished
+- (void)pollAssets
+{
+    if (!_assetGraph)
+    {
+        return;
+    }
+    
+    _assetGraph->poll();
+    
+    if (_assetGraph->remaining() != 0)
+    {
+        return;
+    }
+    
+    Jobs::Report report = _assetGraph->report();
+    
+    NSMutableArray *path = [NSMutableArray arrayWithCapacity: report.path.size()];
+    for (Jobs::Job job : report.path)
+    {
+        [path addObject: [NSString stringWithUTF8String: _assetGraph->name(job).c_str()]];
+    }
+    
+    NSLog(@"Loaded assets in %f s: %lu jobs, %lu failed, %lu skipped. Critical path %f s (%@), busy I/O %f s, compute %f s, render %f s",
+          report.wall,
+          (unsigned long)report.jobs,
+          (unsigned long)report.failed,
+          (unsigned long)report.skipped,
+          report.criticalPath,
+          [path componentsJoinedByString: @" > "],
+          report.busy[Jobs::eLaneIO],
+          report.busy[Jobs::eLaneCompute],
+          report.busy[Jobs::eLaneRender]);
+    
+    _assetGraph.reset();
 }
 
 - (void)updateLightsForTime:(CFTimeInterval) time
@@ -1135,6 +1490,16 @@ static const int kMaxFrameLag = 3;
 {
     // timer is suspended/resumed
     // Can do any non-rendering related background work here when suspended
+    if (pause)
+    {
+        // report the frame pacing of the run so far
+        Profile::Profiler &profiler = Profile::Profiler::shared();
+        profiler.collect();
+        
+        std::ostringstream summary;
+        profiler.summary(summary);
+        NSLog(@"Frame profile:\n%s", summary.str().c_str());
+    }
 }
 
 
@@ -113,11 +113,12 @@ static void RGB8ImageToRGBA8(ImageInfo *tex_info)
     tex_info->bitsPerPixel = 32;
 }
 
-static void CreateImageInfo(const char *name, ImageInfo &tex_info)
+// Decode an image already read into memory; safe to call from any thread
+static void CreateImageInfoFromData(NSData *data, ImageInfo &tex_info)
 {
     tex_info.bitmapData = NULL;
     
-    UIImage* baseImage = [UIImage imageWithContentsOfFile: [NSString stringWithUTF8String: name]];
+    UIImage* baseImage = [UIImage imageWithData: data];
     CGImageRef image = baseImage.CGImage;
     
     if (!image)
@@ -141,4 +142,9 @@ static void CreateImageInfo(const char *name, ImageInfo &tex_info)
     
 }
 
+static void CreateImageInfo(const char *name, ImageInfo &tex_info)
+{
+    CreateImageInfoFromData([NSData dataWithContentsOfFile: [NSString stringWithUTF8String: name]], tex_info);
+}
+
 #endif
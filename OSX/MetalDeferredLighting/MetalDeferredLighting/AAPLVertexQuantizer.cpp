@@ -0,0 +1,390 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Vertex attribute quantisation. Full-float vertices are packed into 24 bytes: the position as
+ 16-bit normalised integers inside the mesh's bounds, the directions of the normal, the tangent
+ and the bitangent as 16-bit octahedral pairs, and the texture coordinates as halves through the
+ batch conversion of Shared/Half. The shaders read the vertices through a vertex descriptor with
+ the formats noted below and fold the position's bounds into the model matrices.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "AAPLVertexQuantizer.h"
+#include "HalfConversion.h"
+
+#pragma mark -
+#pragma mark Private - Vectors
+
+namespace AAPL
+{
+    namespace VertexQuantizer
+    {
+        // Source vertices converted per batch of texture coordinates
+        static const size_t kBatchSize = 256;
+
+        static const float kRadiansToDegrees = 57.29577951f;
+
+        static inline const float* attribute(const void* pVertices, const Layout& layout, const size_t& index, const size_t& offset)
+        {
+            return reinterpret_cast<const float*>(static_cast<const uint8_t*>(pVertices) + index * layout.stride + offset);
+        }
+
+        static inline float dot(const float* a, const float* b)
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        static inline void cross(const float* a, const float* b, float* pResult)
+        {
+            pResult[0] = a[1] * b[2] - a[2] * b[1];
+            pResult[1] = a[2] * b[0] - a[0] * b[2];
+            pResult[2] = a[0] * b[1] - a[1] * b[0];
+        }
+
+        // False, leaving the vector alone, when it has no direction
+        static inline bool normalize(float* pVector)
+        {
+            const float length = std::sqrt(dot(pVector, pVector));
+
+            if(!(length > FLT_MIN))
+            {
+                return false;
+            }
+
+            pVector[0] /= length;
+            pVector[1] /= length;
+            pVector[2] /= length;
+
+            return true;
+        }
+
+        // Angle between two unit vectors, accurate near zero where acos isn't
+        static inline float degrees(const float* a, const float* b)
+        {
+            float c[3];
+
+            cross(a, b, c);
+
+            return std::atan2(std::sqrt(dot(c, c)), dot(a, b)) * kRadiansToDegrees;
+        }
+
+        static inline int16_t snorm(const float& value)
+        {
+            return int16_t(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 32767.0f));
+        }
+
+        // As the vertex fetch converts MTLVertexFormatShort*Normalized
+        static inline float unorm(const int16_t& value)
+        {
+            return std::max(float(value) / 32767.0f, -1.0f);
+        }
+
+        static inline float sign(const float& value)
+        {
+            return (value < 0.0f) ? -1.0f : 1.0f;
+        }
+
+        // Unit normal, +z when there is none
+        static void normal(const void* pVertices, const Layout& layout, const size_t& index, float* pNormal)
+        {
+            if(layout.normal != kAbsent)
+            {
+                std::copy_n(attribute(pVertices, layout, index, layout.normal), 3, pNormal);
+
+                if(normalize(pNormal))
+                {
+                    return;
+                }
+            }
+
+            pNormal[0] = 0.0f;
+            pNormal[1] = 0.0f;
+            pNormal[2] = 1.0f;
+        }
+
+        // Any unit vector orthogonal to the normal, crossed with the axis least aligned with it
+        static void orthogonal(const float* pNormal, float* pResult)
+        {
+            const float axis[3] =
+            {
+                (std::fabs(pNormal[0]) <= std::min(std::fabs(pNormal[1]), std::fabs(pNormal[2]))) ? 1.0f : 0.0f,
+                (std::fabs(pNormal[0]) >  std::fabs(pNormal[1]) && std::fabs(pNormal[1]) <= std::fabs(pNormal[2])) ? 1.0f : 0.0f,
+                0.0f
+            };
+
+            const float fallback[3] = {axis[0], axis[1], (axis[0] + axis[1] == 0.0f) ? 1.0f : 0.0f};
+
+            cross(pNormal, fallback, pResult);
+            normalize(pResult);
+        }
+
+        // Direction of the source tangent, as the float vertices give it to the shaders; any
+        // direction orthogonal to the normal when there is none
+        static void tangent(const void* pVertices, const Layout& layout, const size_t& index, const float* pNormal, float* pTangent)
+        {
+            if(layout.tangent != kAbsent)
+            {
+                std::copy_n(attribute(pVertices, layout, index, layout.tangent), 3, pTangent);
+
+                if(normalize(pTangent))
+                {
+                    return;
+                }
+            }
+
+            orthogonal(pNormal, pTangent);
+        }
+
+        // Direction of the source bitangent, which needn't be orthogonal to the tangent; the
+        // normal crossed with the tangent when there is none
+        static void bitangent(const void* pVertices, const Layout& layout, const size_t& index, const float* pNormal, const float* pTangent, float* pBitangent)
+        {
+            if(layout.bitangent != kAbsent)
+            {
+                std::copy_n(attribute(pVertices, layout, index, layout.bitangent), 3, pBitangent);
+
+                if(normalize(pBitangent))
+                {
+                    return;
+                }
+            }
+
+            cross(pNormal, pTangent, pBitangent);
+
+            if(!normalize(pBitangent))
+            {
+                orthogonal(pNormal, pBitangent);
+            }
+        }
+    } // VertexQuantizer
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Octahedral
+
+void AAPL::VertexQuantizer::encodeOctahedral(const float* pVector, int16_t* pEncoded)
+{
+    const float l1 = std::fabs(pVector[0]) + std::fabs(pVector[1]) + std::fabs(pVector[2]);
+
+    float x = pVector[0] / l1;
+    float y = pVector[1] / l1;
+
+    // The lower hemisphere folds over the diagonals
+    if(pVector[2] < 0.0f)
+    {
+        const float folded = (1.0f - std::fabs(y)) * sign(x);
+
+        y = (1.0f - std::fabs(x)) * sign(y);
+        x = folded;
+    }
+
+    // Rounding each coordinate on its own isn't always closest on the sphere; try all four neighbours
+    const float fx = std::floor(x * 32767.0f);
+    const float fy = std::floor(y * 32767.0f);
+
+    float best = -2.0f;
+
+    for(int32_t i = 0; i < 4; ++i)
+    {
+        const int16_t candidate[2] =
+        {
+            int16_t(std::min(std::max(fx + float(i & 1), -32767.0f), 32767.0f)),
+            int16_t(std::min(std::max(fy + float(i >> 1), -32767.0f), 32767.0f))
+        };
+
+        float decoded[3];
+
+        decodeOctahedral(candidate, decoded);
+
+        const float similarity = dot(decoded, pVector);
+
+        if(similarity > best)
+        {
+            best = similarity;
+
+            pEncoded[0] = candidate[0];
+            pEncoded[1] = candidate[1];
+        }
+    }
+}
+
+void AAPL::VertexQuantizer::decodeOctahedral(const int16_t* pEncoded, float* pVector)
+{
+    // octahedral() in GBuffer.metal
+    const float x = unorm(pEncoded[0]);
+    const float y = unorm(pEncoded[1]);
+    const float z = 1.0f - std::fabs(x) - std::fabs(y);
+    const float t = std::max(-z, 0.0f);
+
+    pVector[0] = x + ((x >= 0.0f) ? -t : t);
+    pVector[1] = y + ((y >= 0.0f) ? -t : t);
+    pVector[2] = z;
+
+    normalize(pVector);
+}
+
+#pragma mark -
+#pragma mark Public - Vertices
+
+AAPL::VertexQuantizer::Bounds AAPL::VertexQuantizer::bounds(const void* pVertices, const size_t& count, const Layout& layout)
+{
+    float lower[3] = { FLT_MAX,  FLT_MAX,  FLT_MAX};
+    float upper[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const float* p = attribute(pVertices, layout, i, layout.position);
+
+        for(size_t c = 0; c < 3; ++c)
+        {
+            lower[c] = std::min(lower[c], p[c]);
+            upper[c] = std::max(upper[c], p[c]);
+        }
+    }
+
+    Bounds result;
+
+    for(size_t c = 0; c < 3; ++c)
+    {
+        const bool empty = (count == 0) || !(upper[c] > lower[c]);
+
+        // A flat axis quantises to zero whatever the extent; one avoids dividing by zero
+        result.center[c] = (count == 0) ? 0.0f : 0.5f * (lower[c] + upper[c]);
+        result.extent[c] = empty ? 1.0f : 0.5f * (upper[c] - lower[c]);
+    }
+
+    return result;
+}
+
+void AAPL::VertexQuantizer::encode(const void* pVertices,
+                                   const size_t& count,
+                                   const Layout& layout,
+                                   const Bounds& bounds,
+                                   Vertex* pQuantized)
+{
+    float    texcoords[2 * kBatchSize];
+    uint16_t halves[2 * kBatchSize];
+
+    for(size_t first = 0; first < count; first += kBatchSize)
+    {
+        const size_t batch = std::min(kBatchSize, count - first);
+
+        for(size_t i = 0; i < batch; ++i)
+        {
+            const size_t index = first + i;
+            const float* p     = attribute(pVertices, layout, index, layout.position);
+
+            Vertex& rVertex = pQuantized[index];
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                rVertex.position[c] = snorm((p[c] - bounds.center[c]) / bounds.extent[c]);
+            }
+
+            // Unused, a w of 1 as the float path's positions have
+            rVertex.position[3] = 32767;
+
+            float n[3];
+            float t[3];
+            float b[3];
+
+            normal(pVertices, layout, index, n);
+            tangent(pVertices, layout, index, n, t);
+            bitangent(pVertices, layout, index, n, t, b);
+
+            encodeOctahedral(n, rVertex.normal);
+            encodeOctahedral(t, rVertex.tangent);
+            encodeOctahedral(b, rVertex.bitangent);
+
+            if(layout.texcoord != kAbsent)
+            {
+                std::copy_n(attribute(pVertices, layout, index, layout.texcoord), 2, &texcoords[2 * i]);
+            }
+            else
+            {
+                texcoords[2 * i]     = 0.0f;
+                texcoords[2 * i + 1] = 0.0f;
+            }
+        }
+
+        Half::fromFloat(texcoords, halves, 2 * batch);
+
+        for(size_t i = 0; i < batch; ++i)
+        {
+            pQuantized[first + i].texcoord[0] = halves[2 * i];
+            pQuantized[first + i].texcoord[1] = halves[2 * i + 1];
+        }
+    }
+}
+
+AAPL::VertexQuantizer::Error AAPL::VertexQuantizer::measure(const void* pVertices,
+                                                            const size_t& count,
+                                                            const Layout& layout,
+                                                            const Bounds& bounds,
+                                                            const Vertex* pQuantized)
+{
+    Error error = {{0.0f, 0.0f, 0.0f}, 0.0f, 0.0f, 0.0f, 0.0f};
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const Vertex& vertex = pQuantized[i];
+        const float*  p      = attribute(pVertices, layout, i, layout.position);
+
+        for(size_t c = 0; c < 3; ++c)
+        {
+            const float decoded = bounds.center[c] + bounds.extent[c] * unorm(vertex.position[c]);
+
+            error.position[c] = std::max(error.position[c], std::fabs(decoded - p[c]));
+        }
+
+        float n[3];
+        float t[3];
+        float b[3];
+        float decodedN[3];
+        float decodedT[3];
+        float decodedB[3];
+
+        normal(pVertices, layout, i, n);
+        tangent(pVertices, layout, i, n, t);
+        bitangent(pVertices, layout, i, n, t, b);
+
+        decodeOctahedral(vertex.normal, decodedN);
+        decodeOctahedral(vertex.tangent, decodedT);
+        decodeOctahedral(vertex.bitangent, decodedB);
+
+        error.normal    = std::max(error.normal, degrees(n, decodedN));
+        error.tangent   = std::max(error.tangent, degrees(t, decodedT));
+        error.bitangent = std::max(error.bitangent, degrees(b, decodedB));
+
+        if(layout.texcoord != kAbsent)
+        {
+            const float* uv = attribute(pVertices, layout, i, layout.texcoord);
+
+            float decoded[2];
+
+            Half::toFloat(vertex.texcoord, decoded, 2);
+
+            error.texcoord = std::max(error.texcoord, std::max(std::fabs(decoded[0] - uv[0]), std::fabs(decoded[1] - uv[1])));
+        }
+    }
+
+    return error;
+}
+
+void AAPL::VertexQuantizer::dequantization(const Bounds& bounds, float* pMatrix)
+{
+    std::fill_n(pMatrix, 16, 0.0f);
+
+    pMatrix[0]  = bounds.extent[0];
+    pMatrix[5]  = bounds.extent[1];
+    pMatrix[10] = bounds.extent[2];
+
+    pMatrix[12] = bounds.center[0];
+    pMatrix[13] = bounds.center[1];
+    pMatrix[14] = bounds.center[2];
+    pMatrix[15] = 1.0f;
+}
@@ -0,0 +1,96 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Vertex attribute quantisation. Full-float vertices are packed into 24 bytes: the position as
+ 16-bit normalised integers inside the mesh's bounds, the directions of the normal, the tangent
+ and the bitangent as 16-bit octahedral pairs, and the texture coordinates as halves. The tangent
+ frame keeps the source's directions, skew included, so the shaders light the quantised vertices
+ as they do the float ones. The shaders read the vertices through a vertex descriptor with the
+ formats noted below and fold the position's bounds into the model matrices.
+ */
+
+#ifndef _AAPL_VERTEX_QUANTIZER_H_
+#define _AAPL_VERTEX_QUANTIZER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AAPL
+{
+    namespace VertexQuantizer
+    {
+        // Offset of an attribute the source vertices don't have
+        static const size_t kAbsent = SIZE_MAX;
+
+        // QuantizedVertex in GBuffer.metal and ZOnly.metal
+        struct Vertex
+        {
+            int16_t  position[4];   // MTLVertexFormatShort4Normalized: xyz in the bounds, w unused
+            int16_t  normal[2];     // MTLVertexFormatShort2Normalized, octahedral
+            int16_t  tangent[2];    // MTLVertexFormatShort2Normalized, octahedral
+            int16_t  bitangent[2];  // MTLVertexFormatShort2Normalized, octahedral
+            uint16_t texcoord[2];   // MTLVertexFormatHalf2
+        };
+
+        static_assert(sizeof(Vertex) == 24, "Vertex must match QuantizedVertex in the shaders");
+
+        // Byte offsets of the float attributes in every source vertex. Position, normal, tangent and
+        // bitangent are three floats, texture coordinates at least two.
+        struct Layout
+        {
+            size_t stride;
+            size_t position;
+            size_t normal;
+            size_t texcoord;
+            size_t tangent;
+            size_t bitangent;
+        };
+
+        // A quantised position q in [-1, 1] is center + extent * q
+        struct Bounds
+        {
+            float center[3];
+            float extent[3];
+        };
+
+        // Worst differences between the source and what the shaders reconstruct
+        struct Error
+        {
+            float position[3];      // Object-space units; at most extent / 65534 plus float rounding
+            float normal;           // Degrees
+            float tangent;          // Degrees
+            float bitangent;        // Degrees
+            float texcoord;         // Texture coordinate units; a relative 2^-11 of the coordinate
+        };
+
+        // Unit vector to the 16-bit octahedral pair that decodes closest to it, and back
+        void encodeOctahedral(const float* pVector, int16_t* pEncoded);
+        void decodeOctahedral(const int16_t* pEncoded, float* pVector);
+
+        Bounds bounds(const void* pVertices, const size_t& count, const Layout& layout);
+
+        // Absent normals encode as +z, absent tangents as any direction orthogonal to the normal and
+        // absent bitangents as the normal crossed with the tangent
+        void encode(const void* pVertices,
+                    const size_t& count,
+                    const Layout& layout,
+                    const Bounds& bounds,
+                    Vertex* pQuantized);
+
+        Error measure(const void* pVertices,
+                      const size_t& count,
+                      const Layout& layout,
+                      const Bounds& bounds,
+                      const Vertex* pQuantized);
+
+        // Column-major matrix taking quantised positions to object space, for the right of the model matrix
+        void dequantization(const Bounds& bounds, float* pMatrix);
+    } // VertexQuantizer
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the vertex quantiser, a standalone program that is not part of the app target. It
+ quantises a synthetic mesh laid out as AAPLObjModel's vertices, whose tangents and bitangents
+ are accumulated per face and so neither unit length nor orthogonal, and checks what the shaders
+ reconstruct against the source: positions within the bounds' resolution, the normal, tangent and
+ bitangent directions within the octahedral pairs' resolution and the texture coordinates within
+ half precision. It then times the encoding, and the batch float to half conversion the texture
+ coordinates go through and its inverse against converting value by value, after checking that
+ both batch directions give the scalar conversions' bits, over the mesh, infinities, NaNs and
+ the rounding edges, and every half.
+
+     c++ -std=c++11 -O2 -I../../../Shared/Half AAPLVertexQuantizer.cpp \
+         ../../../Shared/Half/HalfConversion.cpp AAPLVertexQuantizerBenchmark.cpp -o benchmark
+     ./benchmark [vertices]
+
+ Add -mf16c for the F16C conversions.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "AAPLVertexQuantizer.h"
+#include "HalfConversion.h"
+
+using namespace AAPL;
+
+namespace
+{
+    // Position, normal, texcoord (three floats), tangent and bitangent, as AAPLObjModel lays them out
+    const size_t kFloatsPerVertex = 15;
+
+    const VertexQuantizer::Layout kLayout =
+    {
+        kFloatsPerVertex * sizeof(float),
+        0,
+        3 * sizeof(float),
+        6 * sizeof(float),
+        9 * sizeof(float),
+        12 * sizeof(float)
+    };
+
+    std::vector<float> mesh(const size_t& count)
+    {
+        std::mt19937 random(5);
+
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+        std::vector<float> vertices(count * kFloatsPerVertex);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            float* v = &vertices[i * kFloatsPerVertex];
+
+            v[0] = 1200.0f * uniform(random);
+            v[1] = 300.0f * uniform(random) + 250.0f;
+            v[2] = 1200.0f * uniform(random);
+
+            // Directions anywhere on the sphere, of any length
+            for(size_t k = 3; k < kFloatsPerVertex; ++k)
+            {
+                v[k] = uniform(random);
+            }
+
+            v[6] = 4.0f * uniform(random);
+            v[7] = 4.0f * uniform(random);
+            v[8] = 0.0f;
+        }
+
+        return vertices;
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 5; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+
+    // Batch against scalar conversion of every float of the mesh and the edge cases, then of every half
+    bool checkHalves(const std::vector<float>& rMesh)
+    {
+        std::vector<float> values = rMesh;
+
+        // Infinities, NaNs with payloads, the largest finite half, overflow and the subnormals' edges
+        const uint32_t specials[] =
+        {
+            0x7f800000, 0xff800000, 0x7fc00000, 0x7f800001, 0xffbfffff, 0x7fa5a000,
+            0x477fe000, 0x477ff000, 0x38800000, 0x387fffff, 0x33000000, 0x33000001, 0x80000000
+        };
+
+        for(const uint32_t& bits : specials)
+        {
+            float value;
+
+            std::memcpy(&value, &bits, sizeof(value));
+
+            // Enough copies that the batch paths see every case
+            values.insert(values.end(), 8, value);
+        }
+
+        const std::vector<float>& rValues = values;
+
+        const size_t count = rValues.size();
+
+        std::vector<uint16_t> halves(count);
+        std::vector<float>    floats(count);
+
+        Half::fromFloat(rValues.data(), halves.data(), count);
+        Half::toFloat(halves.data(), floats.data(), count);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            const float scalar = Half::toFloat(halves[i]);
+
+            if((halves[i] != Half::fromFloat(rValues[i])) || (std::memcmp(&floats[i], &scalar, sizeof(float)) != 0))
+            {
+                uint32_t bits;
+
+                std::memcpy(&bits, &rValues[i], sizeof(bits));
+
+                std::printf("batch conversion of 0x%08x differs from the scalar one\n", bits);
+
+                return false;
+            }
+        }
+
+        std::vector<uint16_t> every(65536);
+
+        for(size_t i = 0; i < every.size(); ++i)
+        {
+            every[i] = uint16_t(i);
+        }
+
+        floats.resize(every.size());
+
+        Half::toFloat(every.data(), floats.data(), every.size());
+
+        for(size_t i = 0; i < every.size(); ++i)
+        {
+            const float scalar = Half::toFloat(every[i]);
+
+            if(std::memcmp(&floats[i], &scalar, sizeof(float)) != 0)
+            {
+                std::printf("batch conversion of half 0x%04zx differs from the scalar one\n", i);
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t count = (argc >= 2) ? size_t(std::atol(argv[1])) : 21527;
+
+    const std::vector<float> vertices = mesh(count);
+
+    const VertexQuantizer::Bounds bounds = VertexQuantizer::bounds(vertices.data(), count, kLayout);
+
+    std::vector<VertexQuantizer::Vertex> quantized(count);
+
+    VertexQuantizer::encode(vertices.data(), count, kLayout, bounds, quantized.data());
+
+    const VertexQuantizer::Error error = VertexQuantizer::measure(vertices.data(), count, kLayout, bounds, quantized.data());
+
+    std::printf("%zu vertices from %zu to %zu bytes, position error %g %g %g, normal %g, tangent %g, bitangent %g degrees, texcoord %g\n",
+                count, count * kLayout.stride, count * sizeof(VertexQuantizer::Vertex),
+                error.position[0], error.position[1], error.position[2],
+                error.normal, error.tangent, error.bitangent, error.texcoord);
+
+    bool passed = true;
+
+    for(size_t c = 0; c < 3; ++c)
+    {
+        passed = passed && (error.position[c] <= bounds.extent[c] / 65534.0f * 1.01f);
+    }
+
+    // The octahedral pairs resolve about 0.0075 degrees, halves 2^-11 of coordinates below 4
+    passed = passed && (error.normal < 0.01f) && (error.tangent < 0.01f) && (error.bitangent < 0.01f) && (error.texcoord <= 0.001f);
+
+    if(!passed)
+    {
+        std::printf("errors exceed the quantisation's resolution\n");
+
+        return 1;
+    }
+
+    if(!checkHalves(vertices))
+    {
+        return 1;
+    }
+
+    const double encodeTime = milliseconds([&] { VertexQuantizer::encode(vertices.data(), count, kLayout, bounds, quantized.data()); });
+
+    std::printf("encode: %.2f ms, %.1f Mvertices/s\n", encodeTime, double(count) / encodeTime / 1.0e3);
+
+    // Every float of the mesh, as one stream
+    const size_t values = vertices.size();
+
+    std::vector<uint16_t> halves(values);
+    std::vector<float>    floats(values);
+
+    const double batchTo   = milliseconds([&] { Half::fromFloat(vertices.data(), halves.data(), values); });
+    const double batchFrom = milliseconds([&] { Half::toFloat(halves.data(), floats.data(), values); });
+
+    const double scalarTo = milliseconds([&]
+    {
+        for(size_t i = 0; i < values; ++i)
+        {
+            halves[i] = Half::fromFloat(vertices[i]);
+        }
+    });
+
+    const double scalarFrom = milliseconds([&]
+    {
+        for(size_t i = 0; i < values; ++i)
+        {
+            floats[i] = Half::toFloat(halves[i]);
+        }
+    });
+
+    std::printf("float to half: batch %.3f ms, %.0f Mvalues/s; one by one %.3f ms, %.0f Mvalues/s\n",
+                batchTo, double(values) / batchTo / 1.0e3, scalarTo, double(values) / scalarTo / 1.0e3);
+    std::printf("half to float: batch %.3f ms, %.0f Mvalues/s; one by one %.3f ms, %.0f Mvalues/s\n",
+                batchFrom, double(values) / batchFrom / 1.0e3, scalarFrom, double(values) / scalarFrom / 1.0e3);
+
+    return 0;
+}
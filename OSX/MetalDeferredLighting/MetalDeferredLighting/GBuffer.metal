@@ -36,18 +36,36 @@ struct VertexOutput
 	float v_lineardepth;
 };
 
-vertex VertexOutput gBufferVert(device Vertex *pos_data [[ buffer(0) ]],
-                                constant ModelMatrices *matrices [[ buffer(1) ]],
-                                uint vid [[vertex_id]])
+// QuantizedVertex as AAPL::VertexQuantizer::Vertex lays it out, through the renderer's vertex descriptor
+struct QuantizedVertex
 {
-	VertexOutput output;
+    float4 position [[attribute(0)]];   // Short4Normalized: xyz in the model's bounds, w unused
+    float2 normal [[attribute(1)]];     // Short2Normalized, octahedral
+    float2 tangent [[attribute(2)]];    // Short2Normalized, octahedral
+    float2 bitangent [[attribute(3)]];  // Short2Normalized, octahedral
+    float2 texcoord [[attribute(4)]];   // Half2
+};
 
-    Vertex vData = pos_data[vid];
+// Inverse of the octahedral mapping, as decodeOctahedral in AAPLVertexQuantizer.cpp
+static float3 octahedral(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
     
-	float3 normal = float3(vData.normal);
-	float3 tangent = float3(vData.tangent);
-	float3 bitangent = float3(vData.bitangent);
-	float4 tempPosition = float4(vData.position, 1.0f);
+    return normalize(n);
+}
+
+static VertexOutput gBufferOutput(float4 tempPosition,
+                                  float3 normal,
+                                  float3 tangent,
+                                  float3 bitangent,
+                                  float3 texcoord,
+                                  constant ModelMatrices *matrices)
+{
+	VertexOutput output;
 
 	output.v_normal = normal.xxx * matrices->normalMatrix[0].xyz;
 	output.v_normal += normal.yyy * matrices->normalMatrix[1].xyz;
@@ -66,7 +84,7 @@ vertex VertexOutput gBufferVert(device Vertex *pos_data [[ buffer(0) ]],
 
 	output.v_lineardepth = (matrices->mvMatrix * tempPosition).z;
 
-	output.v_texcoord = float3(vData.texcoord);
+	output.v_texcoord = texcoord;
 
 	output.position = tempPosition.xxxx * matrices->mvpMatrix[0];
 	output.position += tempPosition.yyyy * matrices->mvpMatrix[1];
@@ -78,6 +96,36 @@ vertex VertexOutput gBufferVert(device Vertex *pos_data [[ buffer(0) ]],
 	return output;
 }
 
+vertex VertexOutput gBufferVert(device Vertex *pos_data [[ buffer(0) ]],
+                                constant ModelMatrices *matrices [[ buffer(1) ]],
+                                uint vid [[vertex_id]])
+{
+    Vertex vData = pos_data[vid];
+    
+	return gBufferOutput(float4(vData.position, 1.0f),
+	                     float3(vData.normal),
+	                     float3(vData.tangent),
+	                     float3(vData.bitangent),
+	                     float3(vData.texcoord),
+	                     matrices);
+}
+
+// The matrices' position transforms include the dequantisation of the bounds, the normal matrix doesn't
+vertex VertexOutput gBufferVertQuantized(QuantizedVertex vData [[ stage_in ]],
+                                         constant ModelMatrices *matrices [[ buffer(1) ]])
+{
+	float3 normal = octahedral(vData.normal);
+	float3 tangent = octahedral(vData.tangent);
+	float3 bitangent = octahedral(vData.bitangent);
+
+	return gBufferOutput(float4(vData.position.xyz, 1.0f),
+	                     normal,
+	                     tangent,
+	                     bitangent,
+	                     float3(vData.texcoord, 0.0f),
+	                     matrices);
+}
+
 fragment FragOutput gBufferFrag(VertexOutput in [[stage_in]],
                                                constant float4 &clear_color_gbuffer3 [[buffer(0)]],
                                                texture2d<half> bump_texture [[texture(0)]],
@@ -20,6 +20,12 @@ struct Vertex
 	packed_float3 bitangent;
 };
 
+// Position of QuantizedVertex in GBuffer.metal
+struct QuantizedPosition
+{
+	float4 position [[attribute(0)]];
+};
+
 struct VertexOutput
 {
 	float4 position [[position]];
@@ -36,3 +42,13 @@ vertex VertexOutput zOnly(constant Vertex *pos_data [[buffer(0)]],
 
 	return output;
 }
+
+// The matrix includes the dequantisation of the bounds
+vertex VertexOutput zOnlyQuantized(QuantizedPosition vData [[stage_in]],
+                                   constant float4x4 &mvp [[buffer(1)]])
+{
+	VertexOutput output;
+	output.position = mvp * float4(vData.position.xyz, 1.0f);
+
+	return output;
+}
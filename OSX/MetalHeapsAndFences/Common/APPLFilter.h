@@ -31,6 +31,14 @@
  [1...n] on the provided input input texture.
  */
 @interface APPLGaussianBlurFilter : NSObject <APPLFilter>
+
+/**
+ Size and alignment of the texture the horizontal pass of one mipmap level
+ allocates; the protocol method returns the one of level 1, the largest.
+ */
+- (MTLSizeAndAlign) heapSizeAndAlignWithInputTextureDescriptor:(nonnull MTLTextureDescriptor *)inDescriptor
+                                                   mipmapLevel:(NSUInteger)mipmapLevel;
+
 @end
 
 #endif /* APPLFilter_h */
@@ -130,15 +130,30 @@ typedef NS_ENUM(NSInteger, AAPLSeparablePass) {
     return self;
 }
 
-- (MTLSizeAndAlign) heapSizeAndAlignWithInputTextureDescriptor:(nonnull MTLTextureDescriptor *)inDescriptor {
-    // Создаем дескриптор текстуры меньшего в 2 раза размер
+// Дескриптор текстуры горизонтального прохода для мипмап левела
+static MTLTextureDescriptor *horizontalTextureDescriptor(NSUInteger width, NSUInteger height, NSUInteger mipmapLevel) {
     MTLTextureDescriptor *textureDescriptor = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
-                                                                                    width:(inDescriptor.width >> 1)
-                                                                                   height:(inDescriptor.height >> 1)
-                                                                                mipmapped:NO];
+                                                                                                 width:MAX(width >> mipmapLevel, 1)
+                                                                                                height:MAX(height >> mipmapLevel, 1)
+                                                                                             mipmapped:NO];
+    
+    // Ресурсы в куче должны иметь такой же режим хранения, как у кучи
+    textureDescriptor.storageMode = MTLStorageModePrivate;
+    
     // Используем для записи шейдера
     textureDescriptor.usage |= MTLTextureUsageShaderWrite;
-    return [_device heapTextureSizeAndAlignWithDescriptor:textureDescriptor];
+    
+    return textureDescriptor;
+}
+
+- (MTLSizeAndAlign) heapSizeAndAlignWithInputTextureDescriptor:(nonnull MTLTextureDescriptor *)inDescriptor {
+    // Самая большая текстура - первого левела
+    return [self heapSizeAndAlignWithInputTextureDescriptor:inDescriptor mipmapLevel:1];
+}
+
+- (MTLSizeAndAlign) heapSizeAndAlignWithInputTextureDescriptor:(nonnull MTLTextureDescriptor *)inDescriptor
+                                                   mipmapLevel:(NSUInteger)mipmapLevel {
+    return [_device heapTextureSizeAndAlignWithDescriptor:horizontalTextureDescriptor(inDescriptor.width, inDescriptor.height, mipmapLevel)];
 }
 
 - (_Nullable id <MTLTexture>) executeWithCommandBuffer:(_Nonnull id <MTLCommandBuffer>)commandBuffer
@@ -148,24 +163,7 @@ typedef NS_ENUM(NSInteger, AAPLSeparablePass) {
     // Выполняем блюр для каждого мипмап левела начиная с первого
     for(uint32_t mipmapLevel = 1; mipmapLevel < inTexture.mipmapLevelCount; ++mipmapLevel) {
         // Создаем описание текстуры
-        MTLTextureDescriptor*textureDescriptior = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
-                                                                                                     width:(inTexture.width >> mipmapLevel)
-                                                                                                    height:(inTexture.height >> mipmapLevel)
-                                                                                                 mipmapped:NO];
-        
-        // Ресурсы в куче должны иметь такой же режим хранения, как у кучи
-        textureDescriptior.storageMode = MTLStorageModePrivate;
-        
-        // Использование
-        textureDescriptior.usage |= MTLTextureUsageShaderWrite;
-        
-        // Корректируем размеры
-        if(textureDescriptior.width <= 0) {
-            textureDescriptior.width = 1;
-        }
-        if(textureDescriptior.height <= 0) {
-            textureDescriptior.height = 1;
-        }
+        MTLTextureDescriptor *textureDescriptior = horizontalTextureDescriptor(inTexture.width, inTexture.height, mipmapLevel);
         
         // Создаем текстуру в куче
         id<MTLTexture> horizontalTexture = [heap newTextureWithDescriptor:textureDescriptior];
@@ -0,0 +1,27 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the heap planner in APPLHeapPlanner.h: collects the textures a filter chain
+ allocates from its heap, with the passes that write and read them, and sizes a heap in which
+ textures with disjoint lifetimes share memory.
+ */
+
+#import <Metal/Metal.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface APPLHeapLayout : NSObject
+
+// The first pass writes the texture, later passes up to lastPass read it. A lastPass at or past
+// the pass count keeps the texture alive after the chain.
+- (void)addTextureWithSizeAndAlign:(MTLSizeAndAlign)sizeAndAlign
+                         firstPass:(NSUInteger)firstPass
+                          lastPass:(NSUInteger)lastPass;
+
+// Heap size and alignment for a chain of passCount passes, zero size for an invalid layout
+- (MTLSizeAndAlign)heapSizeAndAlignWithPassCount:(NSUInteger)passCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
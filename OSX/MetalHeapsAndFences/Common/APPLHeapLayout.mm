@@ -0,0 +1,45 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Objective-C face of the heap planner in APPLHeapPlanner.h.
+ */
+
+#import "APPLHeapLayout.h"
+
+#import <vector>
+
+#import "APPLHeapPlanner.h"
+
+@implementation APPLHeapLayout
+{
+    std::vector<APPL::Heap::Resource> _resources;
+}
+
+- (void)addTextureWithSizeAndAlign:(MTLSizeAndAlign)sizeAndAlign
+                         firstPass:(NSUInteger)firstPass
+                          lastPass:(NSUInteger)lastPass
+{
+    APPL::Heap::Resource resource;
+
+    resource.size      = sizeAndAlign.size;
+    resource.alignment = sizeAndAlign.align;
+    resource.firstPass = uint32_t(firstPass);
+    resource.lastPass  = uint32_t(MIN(lastPass, NSUInteger(UINT32_MAX)));
+
+    _resources.push_back(resource);
+}
+
+- (MTLSizeAndAlign)heapSizeAndAlignWithPassCount:(NSUInteger)passCount
+{
+    const APPL::Heap::Plan plan = APPL::Heap::plan(_resources, uint32_t(passCount));
+
+    if(!plan.isValid)
+    {
+        return (MTLSizeAndAlign){ 0, 1 };
+    }
+
+    return (MTLSizeAndAlign){ NSUInteger(plan.heapSize), NSUInteger(plan.alignment) };
+}
+
+@end
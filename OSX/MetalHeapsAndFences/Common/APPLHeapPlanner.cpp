@@ -0,0 +1,359 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Transient resource aliasing planner for heap based filter chains. Summing every filter's requirement
+ reserves memory for resources that are never alive at once. Given the first and last pass that uses
+ each transient resource, the planner instead places resources with disjoint lifetimes at
+ overlapping heap offsets (first-fit colouring of the interval graph of lifetimes), derives the
+ dependencies that aliasing and data flow create, keeps only the fence waits not already implied
+ by earlier ones and recycles fence objects whose waiters have all run.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "APPLHeapPlanner.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace APPL
+{
+    namespace Heap
+    {
+        static uint64_t alignUp(const uint64_t& size, const uint64_t& align)
+        {
+            const uint64_t mask = align - 1;
+
+            return (size + mask) & ~mask;
+        }
+
+        static bool isPowerOfTwo(const uint64_t& value)
+        {
+            return (value != 0) && ((value & (value - 1)) == 0);
+        }
+
+        // Inclusive pass ranges share at least one pass
+        static bool overlaps(const Resource& a, const Resource& b)
+        {
+            return (a.firstPass <= b.lastPass) && (b.firstPass <= a.lastPass);
+        }
+
+        // Place resources in order, each at the lowest aligned offset that does not collide with an
+        // already placed resource whose lifetime overlaps, or with any placed resource when not
+        // aliasing; returns the end of the highest resource
+        static uint64_t place(const std::vector<Resource>& resources,
+                              const std::vector<size_t>& order,
+                              const bool& isAliasing,
+                              std::vector<uint64_t>& rOffsets)
+        {
+            rOffsets.assign(resources.size(), 0);
+
+            std::vector<size_t> placed;
+
+            uint64_t end = 0;
+
+            for(const size_t& index : order)
+            {
+                const Resource& rResource = resources[index];
+
+                std::vector<std::pair<uint64_t, uint64_t>> busy;
+
+                for(const size_t& other : placed)
+                {
+                    if(!isAliasing || overlaps(rResource, resources[other]))
+                    {
+                        busy.push_back({rOffsets[other], rOffsets[other] + resources[other].size});
+                    }
+                }
+
+                std::sort(busy.begin(), busy.end());
+
+                uint64_t offset = 0;
+
+                for(const std::pair<uint64_t, uint64_t>& rRange : busy)
+                {
+                    if(offset + rResource.size <= rRange.first)
+                    {
+                        break;
+                    }
+
+                    offset = std::max(offset, alignUp(rRange.second, rResource.alignment));
+                }
+
+                rOffsets[index] = offset;
+                end             = std::max(end, offset + rResource.size);
+
+                placed.push_back(index);
+            }
+
+            return end;
+        }
+
+        // Set of passes as bits
+        class PassSet
+        {
+        public:
+            PassSet(const uint32_t& count = 0)
+            : m_Words((count + 63) / 64, 0)
+            {
+            }
+
+            void insert(const uint32_t& pass)
+            {
+                m_Words[pass / 64] |= (uint64_t(1) << (pass % 64));
+            }
+
+            bool contains(const uint32_t& pass) const
+            {
+                return (m_Words[pass / 64] >> (pass % 64)) & 1;
+            }
+
+            void merge(const PassSet& rOther)
+            {
+                for(size_t i = 0; i < m_Words.size(); ++i)
+                {
+                    m_Words[i] |= rOther.m_Words[i];
+                }
+            }
+
+        private:
+            std::vector<uint64_t> m_Words;
+        }; // PassSet
+    } // Heap
+} // APPL
+
+#pragma mark -
+#pragma mark Public - Planner
+
+double APPL::Heap::Plan::savings() const
+{
+    return (unaliasedSize > 0) ? (1.0 - double(heapSize) / double(unaliasedSize)) : 0.0;
+}
+
+APPL::Heap::Plan APPL::Heap::plan(const std::vector<Resource>& resources, const uint32_t& passCount)
+{
+    Plan result;
+
+    result.isValid         = false;
+    result.heapSize        = 0;
+    result.alignment       = 1;
+    result.unaliasedSize   = 0;
+    result.liveBound       = 0;
+    result.fenceCount      = 0;
+    result.waitCount       = 0;
+    result.dependencyCount = 0;
+
+    for(const Resource& rResource : resources)
+    {
+        if(!isPowerOfTwo(rResource.alignment) || (rResource.firstPass > rResource.lastPass) || (rResource.firstPass >= passCount))
+        {
+            return result;
+        }
+
+        result.alignment      = std::max(result.alignment, rResource.alignment);
+        result.unaliasedSize += alignUp(rResource.size, rResource.alignment);
+    }
+
+    result.unaliasedSize = alignUp(result.unaliasedSize, result.alignment);
+
+    // Lower bound: the most memory alive during any single pass
+    for(uint32_t pass = 0; pass < passCount; ++pass)
+    {
+        uint64_t live = 0;
+
+        for(const Resource& rResource : resources)
+        {
+            if((rResource.firstPass <= pass) && (pass <= rResource.lastPass))
+            {
+                live += rResource.size;
+            }
+        }
+
+        result.liveBound = std::max(result.liveBound, live);
+    }
+
+    // Placement: first fit with the largest resources first and, separately, the largest
+    // alignments first, which wastes less padding on mixed alignments; the smaller heap wins.
+    // Laid out one after another in alignment order no padding is needed, so should aliasing
+    // still lose to the unaliased size that layout is used instead.
+    std::vector<size_t> bySize(resources.size());
+
+    std::iota(bySize.begin(), bySize.end(), 0);
+
+    std::vector<size_t> byAlignment(bySize);
+
+    std::stable_sort(bySize.begin(), bySize.end(), [&](const size_t& a, const size_t& b) {
+        return resources[a].size > resources[b].size;
+    });
+
+    std::stable_sort(byAlignment.begin(), byAlignment.end(), [&](const size_t& a, const size_t& b) {
+        return (resources[a].alignment != resources[b].alignment) ? (resources[a].alignment > resources[b].alignment)
+                                                                  : (resources[a].size > resources[b].size);
+    });
+
+    std::vector<uint64_t> offsets;
+
+    result.heapSize = place(resources, bySize, true, result.offsets);
+
+    const uint64_t packed = place(resources, byAlignment, true, offsets);
+
+    if(packed < result.heapSize)
+    {
+        result.heapSize = packed;
+        result.offsets.swap(offsets);
+    }
+
+    if(alignUp(result.heapSize, result.alignment) > result.unaliasedSize)
+    {
+        result.heapSize = place(resources, byAlignment, false, result.offsets);
+    }
+
+    result.heapSize = alignUp(result.heapSize, result.alignment);
+
+    // Dependencies between passes
+    std::vector<std::vector<uint32_t>> dependencies(passCount);
+
+    for(size_t i = 0; i < resources.size(); ++i)
+    {
+        const Resource& rResource = resources[i];
+
+        // Readers wait for the writer
+        const uint32_t last = std::min(rResource.lastPass, passCount - 1);
+
+        for(uint32_t pass = rResource.firstPass + 1; pass <= last; ++pass)
+        {
+            dependencies[pass].push_back(rResource.firstPass);
+        }
+
+        // The writer of an aliased resource waits until the previous owner
+        // of the memory is no longer used
+        for(size_t j = 0; j < resources.size(); ++j)
+        {
+            const Resource& rPrevious = resources[j];
+
+            const bool isAliased = (result.offsets[i] < result.offsets[j] + rPrevious.size)
+                                && (result.offsets[j] < result.offsets[i] + rResource.size);
+
+            if((i != j) && isAliased && (rPrevious.lastPass < rResource.firstPass))
+            {
+                dependencies[rResource.firstPass].push_back(rPrevious.lastPass);
+            }
+        }
+    }
+
+    // Reduction: a wait on pass d also orders everything d waited for, so
+    // latest dependencies are taken first and implied ones are skipped
+    std::vector<PassSet> reach(passCount, PassSet(passCount));
+    std::vector<int64_t> lastWaiter(passCount, -1);
+
+    std::vector<std::vector<uint32_t>> waits(passCount);
+
+    for(uint32_t pass = 0; pass < passCount; ++pass)
+    {
+        std::vector<uint32_t>& rDependencies = dependencies[pass];
+
+        std::sort(rDependencies.begin(), rDependencies.end(), std::greater<uint32_t>());
+
+        rDependencies.erase(std::unique(rDependencies.begin(), rDependencies.end()), rDependencies.end());
+
+        result.dependencyCount += uint32_t(rDependencies.size());
+
+        for(const uint32_t& dependency : rDependencies)
+        {
+            if(!reach[pass].contains(dependency))
+            {
+                waits[pass].push_back(dependency);
+
+                reach[pass].insert(dependency);
+                reach[pass].merge(reach[dependency]);
+
+                lastWaiter[dependency] = pass;
+            }
+        }
+
+        result.waitCount += uint32_t(waits[pass].size());
+    }
+
+    // Fence objects: a fence updated by pass d is busy until its last waiter
+    // started, after which another pass may update it again
+    result.passes.assign(passCount, PassSync());
+
+    std::vector<int32_t> fenceOfPass(passCount, -1);
+    std::vector<int64_t> fenceBusyUntil;
+
+    for(uint32_t pass = 0; pass < passCount; ++pass)
+    {
+        PassSync& rSync = result.passes[pass];
+
+        rSync.update = -1;
+
+        for(const uint32_t& dependency : waits[pass])
+        {
+            rSync.waits.push_back(uint32_t(fenceOfPass[dependency]));
+        }
+
+        if(lastWaiter[pass] < 0)
+        {
+            continue;
+        }
+
+        int32_t fence = -1;
+
+        for(size_t f = 0; f < fenceBusyUntil.size(); ++f)
+        {
+            if(fenceBusyUntil[f] <= int64_t(pass))
+            {
+                fence = int32_t(f);
+
+                break;
+            }
+        }
+
+        if(fence < 0)
+        {
+            fence = int32_t(fenceBusyUntil.size());
+
+            fenceBusyUntil.push_back(0);
+        }
+
+        fenceBusyUntil[size_t(fence)] = lastWaiter[pass];
+        fenceOfPass[pass]             = fence;
+        rSync.update                  = fence;
+    }
+
+    result.fenceCount = uint32_t(fenceBusyUntil.size());
+    result.isValid    = validate(resources, result);
+
+    return result;
+}
+
+bool APPL::Heap::validate(const std::vector<Resource>& resources, const Plan& rPlan)
+{
+    if(rPlan.offsets.size() != resources.size())
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < resources.size(); ++i)
+    {
+        if(((rPlan.offsets[i] & (resources[i].alignment - 1)) != 0) || (rPlan.offsets[i] + resources[i].size > rPlan.heapSize))
+        {
+            return false;
+        }
+
+        for(size_t j = i + 1; j < resources.size(); ++j)
+        {
+            const bool isAliased = (rPlan.offsets[i] < rPlan.offsets[j] + resources[j].size)
+                                && (rPlan.offsets[j] < rPlan.offsets[i] + resources[i].size);
+
+            if(isAliased && overlaps(resources[i], resources[j]))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
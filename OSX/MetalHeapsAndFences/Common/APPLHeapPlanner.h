@@ -0,0 +1,74 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Transient resource aliasing planner for heap based filter chains. Summing every filter's requirement
+ reserves memory for resources that are never alive at once. Given the first and last pass that uses
+ each transient resource, the planner instead places resources with disjoint lifetimes at
+ overlapping heap offsets (first-fit colouring of the interval graph of lifetimes), derives the
+ dependencies that aliasing and data flow create, keeps only the fence waits not already implied
+ by earlier ones and recycles fence objects whose waiters have all run.
+ */
+
+#ifndef _APPL_HEAP_PLANNER_H_
+#define _APPL_HEAP_PLANNER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace APPL
+{
+    namespace Heap
+    {
+        // Resource requirement, as returned by heapTextureSizeAndAlignWithDescriptor:.
+        // The first pass writes the resource, later passes up to the last one read it.
+        // A last pass at or past the pass count keeps the resource alive after the graph,
+        // like the blurred texture that stays on screen.
+        struct Resource
+        {
+            std::string name;
+            uint64_t    size;
+            uint64_t    alignment;  // Power of two
+            uint32_t    firstPass;
+            uint32_t    lastPass;
+        };
+
+        // Synchronisation of one pass (one encoder)
+        struct PassSync
+        {
+            std::vector<uint32_t> waits;    // Fences to wait on before the pass
+            int32_t               update;   // Fence to update after the pass, -1 for none
+        };
+
+        struct Plan
+        {
+            bool                  isValid;
+            std::vector<uint64_t> offsets;          // Heap offset per resource
+            uint64_t              heapSize;         // Aliased heap size
+            uint64_t              alignment;        // Largest resource alignment
+            uint64_t              unaliasedSize;    // What setupHeap: would allocate
+            uint64_t              liveBound;        // Largest sum of simultaneously live resources
+            std::vector<PassSync> passes;
+            uint32_t              fenceCount;       // Fence objects to create
+            uint32_t              waitCount;        // Total waits after reduction
+            uint32_t              dependencyCount;  // Pass dependencies before reduction
+
+            // Fraction of the unaliased heap that aliasing saves
+            double savings() const;
+        };
+
+        // Plan a graph of passCount passes
+        Plan plan(const std::vector<Resource>& resources, const uint32_t& passCount);
+
+        // Check that no two resources with overlapping lifetimes overlap in memory
+        bool validate(const std::vector<Resource>& resources, const Plan& rPlan);
+    } // Heap
+} // APPL
+
+#endif
+
+#endif
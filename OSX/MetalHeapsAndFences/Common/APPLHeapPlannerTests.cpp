@@ -0,0 +1,307 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Tests for the heap planner, a standalone program that is not part of the app targets. Plans of
+ the sample's downsample and blur chain, a linear chain and random filter graphs are checked
+ without the planner's own code: resources whose lifetimes overlap must not share memory, the heap
+ must lie between the live bound and the unaliased size, and replaying the fence waits and updates
+ in encoding order must order every reader after its writer and every aliased writer after the
+ last use of the memory's previous owner, with no wait implied by the others.
+
+     c++ -std=c++11 -O2 APPLHeapPlanner.cpp APPLHeapPlannerTests.cpp -o tests && ./tests
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "APPLHeapPlanner.h"
+
+using namespace APPL::Heap;
+
+namespace
+{
+    const uint64_t kMegabyte = 1 << 20;
+
+    bool overlapsInTime(const Resource& a, const Resource& b)
+    {
+        return (a.firstPass <= b.lastPass) && (b.firstPass <= a.lastPass);
+    }
+
+    bool overlapsInMemory(const Resource& a, const uint64_t& offsetA, const Resource& b, const uint64_t& offsetB)
+    {
+        return (offsetA < offsetB + b.size) && (offsetB < offsetA + a.size);
+    }
+
+    // Empty when the plan is correct, otherwise what is wrong with it
+    std::string check(const std::vector<Resource>& resources, const uint32_t& passCount, const Plan& rPlan)
+    {
+        if(!rPlan.isValid || (rPlan.offsets.size() != resources.size()) || (rPlan.passes.size() != passCount))
+        {
+            return "invalid plan";
+        }
+
+        if((rPlan.heapSize < rPlan.liveBound) || (rPlan.heapSize > rPlan.unaliasedSize) || (rPlan.heapSize % rPlan.alignment != 0))
+        {
+            return "heap size out of bounds";
+        }
+
+        // Memory
+        for(size_t i = 0; i < resources.size(); ++i)
+        {
+            if((rPlan.offsets[i] % resources[i].alignment != 0) || (rPlan.offsets[i] + resources[i].size > rPlan.heapSize))
+            {
+                return "resource misplaced";
+            }
+
+            for(size_t j = i + 1; j < resources.size(); ++j)
+            {
+                if(overlapsInTime(resources[i], resources[j]) && overlapsInMemory(resources[i], rPlan.offsets[i], resources[j], rPlan.offsets[j]))
+                {
+                    return "live resources share memory";
+                }
+            }
+        }
+
+        // Ordering by fences: a wait sees the latest update of the fence by an earlier pass
+        std::vector<std::vector<bool>> before(passCount, std::vector<bool>(passCount, false));
+        std::vector<std::vector<uint32_t>> waitedPasses(passCount);
+
+        uint32_t fences = 0;
+
+        for(uint32_t pass = 0; pass < passCount; ++pass)
+        {
+            for(const uint32_t& fence : rPlan.passes[pass].waits)
+            {
+                int64_t updater = -1;
+
+                for(uint32_t earlier = 0; earlier < pass; ++earlier)
+                {
+                    if(rPlan.passes[earlier].update == int32_t(fence))
+                    {
+                        updater = earlier;
+                    }
+                }
+
+                if(updater < 0)
+                {
+                    return "wait on a fence nothing updated";
+                }
+
+                waitedPasses[pass].push_back(uint32_t(updater));
+
+                before[pass][size_t(updater)] = true;
+
+                for(uint32_t earlier = 0; earlier < passCount; ++earlier)
+                {
+                    if(before[size_t(updater)][earlier])
+                    {
+                        before[pass][earlier] = true;
+                    }
+                }
+            }
+
+            if(rPlan.passes[pass].update >= 0)
+            {
+                fences = std::max(fences, uint32_t(rPlan.passes[pass].update) + 1);
+            }
+        }
+
+        if(fences != rPlan.fenceCount)
+        {
+            return "fence count mismatch";
+        }
+
+        // Required orderings
+        for(size_t i = 0; i < resources.size(); ++i)
+        {
+            const Resource& rResource = resources[i];
+
+            for(uint32_t pass = rResource.firstPass + 1; pass <= std::min(rResource.lastPass, passCount - 1); ++pass)
+            {
+                if(!before[pass][rResource.firstPass])
+                {
+                    return "reader not ordered after writer";
+                }
+            }
+
+            for(size_t j = 0; j < resources.size(); ++j)
+            {
+                const Resource& rPrevious = resources[j];
+
+                if((i != j) && (rPrevious.lastPass < rResource.firstPass) &&
+                   overlapsInMemory(rResource, rPlan.offsets[i], rPrevious, rPlan.offsets[j]) &&
+                   !before[rResource.firstPass][rPrevious.lastPass])
+                {
+                    return "aliased writer not ordered after the previous owner";
+                }
+            }
+        }
+
+        // No wait implied by another wait of the same pass
+        for(uint32_t pass = 0; pass < passCount; ++pass)
+        {
+            for(const uint32_t& waited : waitedPasses[pass])
+            {
+                for(const uint32_t& other : waitedPasses[pass])
+                {
+                    if((other != waited) && before[other][waited])
+                    {
+                        return "redundant wait";
+                    }
+                }
+            }
+        }
+
+        return std::string();
+    }
+
+    void report(const char* pName, const Plan& rPlan)
+    {
+        std::printf("%-24s unaliased %8.2f MB, aliased %8.2f MB, live bound %8.2f MB, saves %5.1f%%, "
+                    "%u fences, %u waits for %u dependencies\n",
+                    pName, double(rPlan.unaliasedSize) / kMegabyte, double(rPlan.heapSize) / kMegabyte,
+                    double(rPlan.liveBound) / kMegabyte, 100.0 * rPlan.savings(),
+                    rPlan.fenceCount, rPlan.waitCount, rPlan.dependencyCount);
+    }
+
+    // APPLDownsampleFilter then APPLGaussianBlurFilter on an RGBA8 image: the blit writes the mip
+    // chain, every level from 1 on is blurred horizontally into its own texture and back vertically
+    std::vector<Resource> sampleChain(const uint64_t& width, const uint64_t& height, uint32_t& rPassCount)
+    {
+        uint32_t levels = 1;
+
+        while(((width | height) >> levels) != 0)
+        {
+            levels++;
+        }
+
+        rPassCount = 1 + 2 * (levels - 1);
+
+        uint64_t mipChain = 0;
+
+        for(uint32_t level = 0; level < levels; ++level)
+        {
+            mipChain += std::max<uint64_t>(width >> level, 1) * std::max<uint64_t>(height >> level, 1) * 4;
+        }
+
+        std::vector<Resource> resources;
+
+        resources.push_back({"mip chain", mipChain, 65536, 0, rPassCount});
+
+        for(uint32_t level = 1; level < levels; ++level)
+        {
+            const uint64_t size = std::max<uint64_t>(width >> level, 1) * std::max<uint64_t>(height >> level, 1) * 4;
+
+            resources.push_back({"horizontal", std::max<uint64_t>(size, 4096), 4096, 2 * level - 1, 2 * level});
+        }
+
+        return resources;
+    }
+} // unnamed
+
+int main()
+{
+    size_t failures = 0;
+
+    // The sample's chain
+    uint32_t passCount = 0;
+
+    const std::vector<Resource> chain = sampleChain(2048, 2048, passCount);
+    const Plan                  plan0 = plan(chain, passCount);
+
+    report("downsample + blur 2048", plan0);
+
+    std::string error = check(chain, passCount, plan0);
+
+    if(!error.empty())
+    {
+        std::printf("downsample + blur: %s\n", error.c_str());
+
+        failures++;
+    }
+
+    // Only the largest horizontal texture is ever needed next to the mip chain
+    if(plan0.heapSize != ((chain[0].size + 65535) & ~uint64_t(65535)) + chain[1].size)
+    {
+        std::printf("downsample + blur: horizontal textures not aliased\n");
+
+        failures++;
+    }
+
+    // Ten full-size passes, each reading the previous one's output: two buffers suffice
+    std::vector<Resource> linear;
+
+    for(uint32_t i = 0; i < 10; ++i)
+    {
+        linear.push_back({"target", 8 * kMegabyte, 65536, i, i + 1});
+    }
+
+    const Plan plan1 = plan(linear, 11);
+
+    report("linear chain of 10", plan1);
+
+    error = check(linear, 11, plan1);
+
+    if(!error.empty() || (plan1.heapSize != 16 * kMegabyte))
+    {
+        std::printf("linear chain: %s, %llu bytes\n", error.empty() ? "heap too large" : error.c_str(), (unsigned long long)plan1.heapSize);
+
+        failures++;
+    }
+
+    // Invalid input
+    const std::vector<Resource> misaligned = {{"misaligned", 1024, 48, 0, 1}};
+    const std::vector<Resource> reversed   = {{"reversed", 1024, 256, 2, 1}};
+
+    if(plan(misaligned, 2).isValid || plan(reversed, 3).isValid || plan({{"late", 1024, 256, 3, 4}}, 3).isValid)
+    {
+        std::printf("invalid resources accepted\n");
+
+        failures++;
+    }
+
+    // Random graphs
+    std::mt19937 random(5);
+
+    const size_t graphs = 5000;
+
+    double savings = 0.0;
+
+    for(size_t graph = 0; graph < graphs; ++graph)
+    {
+        const uint32_t passes = 2 + random() % 30;
+        const uint32_t count  = 1 + random() % 40;
+
+        std::vector<Resource> resources;
+
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t first = random() % passes;
+            const uint32_t last  = first + random() % 5;
+
+            resources.push_back({"random", 1 + random() % (4 * kMegabyte), uint64_t(1) << (8 + random() % 9), first, last});
+        }
+
+        const Plan randomPlan = plan(resources, passes);
+
+        error = check(resources, passes, randomPlan);
+
+        if(!error.empty())
+        {
+            std::printf("random graph %zu: %s\n", graph, error.c_str());
+
+            failures++;
+        }
+
+        savings += randomPlan.savings();
+    }
+
+    std::printf("%zu random graphs, %.1f%% mean savings\n", graphs, 100.0 * savings / double(graphs));
+
+    std::printf("%s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,591 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU version of the APPLDownsampleFilter + APPLGaussianBlurFilter chain. The whole mip pyramid is
+ built and every level from 1 on is blurred with the 5-tap kernel of APPLFilter.metal in one
+ streaming pass over the rows of level 0: each produced row is blurred horizontally into a five
+ row ring, emitted vertically blurred as soon as its neighbours exist, and paired with the previous
+ row to produce the next level. No full-size intermediate is ever written.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "APPLMipBlur.h"
+#include "HalfConversion.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace APPL
+{
+    // Same weights as gaussianWeights in APPLFilter.metal
+    static const float kGaussianWeights[5] = { 0.06136f, 0.24477f, 0.38774f, 0.24477f, 0.06136f };
+
+    // One RGBA pixel per register
+    struct float4
+    {
+#if defined(__SSE2__)
+        __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        float32x4_t v;
+#else
+        float v[4];
+#endif
+    };
+
+#if defined(__SSE2__)
+    static inline float4 load(const float* p)             { return {_mm_loadu_ps(p)}; }
+    static inline void   store(float* p, const float4& a) { _mm_storeu_ps(p, a.v); }
+    static inline float4 splat(const float& s)            { return {_mm_set1_ps(s)}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    static inline float4 load(const float* p)             { return {vld1q_f32(p)}; }
+    static inline void   store(float* p, const float4& a) { vst1q_f32(p, a.v); }
+    static inline float4 splat(const float& s)            { return {vdupq_n_f32(s)}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+#else
+    static inline float4 load(const float* p)             { return {{p[0], p[1], p[2], p[3]}}; }
+    static inline void   store(float* p, const float4& a) { std::memcpy(p, a.v, sizeof(a.v)); }
+    static inline float4 splat(const float& s)            { return {{s, s, s, s}}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+#endif
+} // APPL
+
+#pragma mark -
+#pragma mark Private - Pixel conversion
+
+namespace APPL
+{
+    // sRGB transfer tables: exact decode of every 8-bit code, encode through a
+    // 16K entry table of the linear value, well below half an 8-bit step
+    class SRGB
+    {
+    public:
+        static const SRGB& shared()
+        {
+            static const SRGB tables;
+
+            return tables;
+        }
+
+        float decode(const uint8_t& code) const
+        {
+            return m_Decode[code];
+        }
+
+        uint8_t encode(const float& linear) const
+        {
+            const float clamped = std::min(std::max(linear, 0.0f), 1.0f);
+
+            return m_Encode[size_t(clamped * float(kEncodeSize - 1) + 0.5f)];
+        }
+
+    private:
+        static const size_t kEncodeSize = 16384;
+
+        SRGB()
+        : m_Encode(kEncodeSize)
+        {
+            for(int32_t i = 0; i < 256; ++i)
+            {
+                const float c = float(i) / 255.0f;
+
+                m_Decode[i] = (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+
+            for(size_t i = 0; i < kEncodeSize; ++i)
+            {
+                const float l = float(i) / float(kEncodeSize - 1);
+                const float c = (l <= 0.0031308f) ? (12.92f * l) : (1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f);
+
+                m_Encode[i] = uint8_t(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f);
+            }
+        }
+
+        float                m_Decode[256];
+        std::vector<uint8_t> m_Encode;
+    }; // SRGB
+
+    static void decodeRow(const void* pIn, float* pOut, const uint32_t& width, const PixelFormat& format)
+    {
+        const size_t count = 4 * size_t(width);
+
+        switch(format)
+        {
+            case ePixelFormatRGBA8Unorm:
+            {
+                const uint8_t* pBytes = static_cast<const uint8_t*>(pIn);
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    pOut[i] = float(pBytes[i]) * (1.0f / 255.0f);
+                }
+                break;
+            }
+
+            case ePixelFormatRGBA8Unorm_sRGB:
+            {
+                const uint8_t* pBytes = static_cast<const uint8_t*>(pIn);
+                const SRGB&    rSRGB  = SRGB::shared();
+
+                for(size_t i = 0; i < count; i += 4)
+                {
+                    pOut[i + 0] = rSRGB.decode(pBytes[i + 0]);
+                    pOut[i + 1] = rSRGB.decode(pBytes[i + 1]);
+                    pOut[i + 2] = rSRGB.decode(pBytes[i + 2]);
+                    pOut[i + 3] = float(pBytes[i + 3]) * (1.0f / 255.0f);
+                }
+                break;
+            }
+
+            case ePixelFormatRGBA16Float:
+                Half::toFloat(static_cast<const uint16_t*>(pIn), pOut, count);
+                break;
+
+            case ePixelFormatRGBA32Float:
+                std::memcpy(pOut, pIn, count * sizeof(float));
+                break;
+        }
+    }
+
+    static void encodeRow(const float* pIn, void* pOut, const uint32_t& width, const PixelFormat& format)
+    {
+        const size_t count = 4 * size_t(width);
+
+        switch(format)
+        {
+            case ePixelFormatRGBA8Unorm:
+            {
+                uint8_t* pBytes = static_cast<uint8_t*>(pOut);
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    pBytes[i] = uint8_t(std::min(std::max(pIn[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+                }
+                break;
+            }
+
+            case ePixelFormatRGBA8Unorm_sRGB:
+            {
+                uint8_t*    pBytes = static_cast<uint8_t*>(pOut);
+                const SRGB& rSRGB  = SRGB::shared();
+
+                for(size_t i = 0; i < count; i += 4)
+                {
+                    pBytes[i + 0] = rSRGB.encode(pIn[i + 0]);
+                    pBytes[i + 1] = rSRGB.encode(pIn[i + 1]);
+                    pBytes[i + 2] = rSRGB.encode(pIn[i + 2]);
+                    pBytes[i + 3] = uint8_t(std::min(std::max(pIn[i + 3], 0.0f), 1.0f) * 255.0f + 0.5f);
+                }
+                break;
+            }
+
+            case ePixelFormatRGBA16Float:
+                Half::fromFloat(pIn, static_cast<uint16_t*>(pOut), count);
+                break;
+
+            case ePixelFormatRGBA32Float:
+                std::memcpy(pOut, pIn, count * sizeof(float));
+                break;
+        }
+    }
+} // APPL
+
+#pragma mark -
+#pragma mark Private - Kernels
+
+namespace APPL
+{
+    // 2x2 box filter of two rows, clamped at odd widths like generateMipmaps
+    static void downsample(const float* pTop, const float* pBottom, float* pOut, const uint32_t& width, const uint32_t& outWidth)
+    {
+        const float4 quarter = splat(0.25f);
+
+        for(uint32_t x = 0; x < outWidth; ++x)
+        {
+            const size_t x0 = 4 * size_t(std::min(2 * x,     width - 1));
+            const size_t x1 = 4 * size_t(std::min(2 * x + 1, width - 1));
+
+            const float4 sum = (load(pTop + x0) + load(pTop + x1)) + (load(pBottom + x0) + load(pBottom + x1));
+
+            store(pOut + 4 * size_t(x), sum * quarter);
+        }
+    }
+
+    // 5-tap horizontal pass; pPadded receives the row with two clamped pixels on each side
+    static void blurHorizontal(const float* pIn, float* pOut, float* pPadded, const uint32_t& width)
+    {
+        std::memcpy(pPadded + 8, pIn, 4 * size_t(width) * sizeof(float));
+
+        for(int32_t i = 0; i < 2; ++i)
+        {
+            std::memcpy(pPadded + 4 * i, pIn, 4 * sizeof(float));
+            std::memcpy(pPadded + 4 * (size_t(width) + 2 + size_t(i)), pIn + 4 * (size_t(width) - 1), 4 * sizeof(float));
+        }
+
+        const float4 w0 = splat(kGaussianWeights[0]);
+        const float4 w1 = splat(kGaussianWeights[1]);
+        const float4 w2 = splat(kGaussianWeights[2]);
+
+        for(uint32_t x = 0; x < width; ++x)
+        {
+            const float* p = pPadded + 4 * size_t(x);
+
+            const float4 sum = w0 * (load(p) + load(p + 16)) + w1 * (load(p + 4) + load(p + 12)) + w2 * load(p + 8);
+
+            store(pOut + 4 * size_t(x), sum);
+        }
+    }
+
+    // 5-tap vertical pass over five rows; alpha is forced to one like the Metal kernel
+    static void blurVertical(const float* const pRows[5], float* pOut, const uint32_t& width)
+    {
+        const float4 w0 = splat(kGaussianWeights[0]);
+        const float4 w1 = splat(kGaussianWeights[1]);
+        const float4 w2 = splat(kGaussianWeights[2]);
+
+        for(uint32_t x = 0; x < width; ++x)
+        {
+            const size_t i = 4 * size_t(x);
+
+            const float4 sum = w0 * (load(pRows[0] + i) + load(pRows[4] + i))
+                             + w1 * (load(pRows[1] + i) + load(pRows[3] + i))
+                             + w2 * load(pRows[2] + i);
+
+            store(pOut + i, sum);
+
+            pOut[i + 3] = 1.0f;
+        }
+    }
+} // APPL
+
+#pragma mark -
+#pragma mark Public - Mip blur
+
+size_t APPL::bytesPerPixel(const PixelFormat& format)
+{
+    switch(format)
+    {
+        case ePixelFormatRGBA16Float:
+            return 8;
+
+        case ePixelFormatRGBA32Float:
+            return 16;
+
+        default:
+            return 4;
+    }
+}
+
+APPL::MipBlur::MipBlur(const PixelFormat& format)
+: m_Format(format), mnWorkingSet(0)
+{
+}
+
+uint32_t APPL::MipBlur::levelCount(const uint32_t& width, const uint32_t& height)
+{
+    uint32_t size  = std::max(width, height);
+    uint32_t count = 1;
+
+    while(size > 1)
+    {
+        size >>= 1;
+        count += 1;
+    }
+
+    return count;
+}
+
+const std::vector<APPL::MipLevel>& APPL::MipBlur::levels() const
+{
+    return m_Levels;
+}
+
+size_t APPL::MipBlur::workingSetBytes() const
+{
+    return mnWorkingSet;
+}
+
+void APPL::MipBlur::allocate(const uint32_t& width, const uint32_t& height)
+{
+    const uint32_t count = levelCount(width, height);
+
+    m_Levels.resize(count);
+    m_Stages.resize(count);
+
+    size_t floats = 0;
+
+    for(uint32_t level = 0; level < count; ++level)
+    {
+        MipLevel& rLevel = m_Levels[level];
+        Stage&    rStage = m_Stages[level];
+
+        rLevel.width    = std::max<uint32_t>(width  >> level, 1);
+        rLevel.height   = std::max<uint32_t>(height >> level, 1);
+        rLevel.rowBytes = bytesPerPixel(m_Format) * rLevel.width;
+
+        rLevel.pixels.resize(rLevel.rowBytes * rLevel.height);
+
+        const size_t row = 4 * size_t(rLevel.width);
+
+        rStage.width    = rLevel.width;
+        rStage.height   = rLevel.height;
+        rStage.received = 0;
+        rStage.emitted  = 0;
+
+        rStage.pending.resize(row);
+        rStage.next.resize(2 * row);
+
+        // Level 0 is copied through and needs no blur state
+        rStage.ring.resize((level > 0) ? 5 * row : 0);
+        rStage.output.resize((level > 0) ? row : 0);
+
+        floats += rStage.pending.size() + rStage.next.size() + rStage.ring.size() + rStage.output.size();
+    }
+
+    m_Row.resize(4 * size_t(width));
+    m_Padded.resize(4 * (size_t(width) + 4));
+
+    mnWorkingSet = (floats + m_Row.size() + m_Padded.size()) * sizeof(float);
+}
+
+void APPL::MipBlur::emit(const size_t& level, const uint32_t& row)
+{
+    Stage& rStage = m_Stages[level];
+
+    const float* pRows[5];
+
+    for(int32_t k = 0; k < 5; ++k)
+    {
+        const int32_t source = std::min(std::max(int32_t(row) + k - 2, 0), int32_t(rStage.height) - 1);
+
+        pRows[k] = rStage.ring.data() + 4 * size_t(rStage.width) * size_t(source % 5);
+    }
+
+    blurVertical(pRows, rStage.output.data(), rStage.width);
+
+    MipLevel& rLevel = m_Levels[level];
+
+    encodeRow(rStage.output.data(), rLevel.pixels.data() + size_t(row) * rLevel.rowBytes, rLevel.width, m_Format);
+
+    rStage.emitted = row + 1;
+}
+
+void APPL::MipBlur::push(const size_t& level, const float* pRow)
+{
+    Stage& rStage = m_Stages[level];
+
+    const uint32_t row = rStage.received++;
+
+    if(level == 0)
+    {
+        MipLevel& rLevel = m_Levels[0];
+
+        encodeRow(pRow, rLevel.pixels.data() + size_t(row) * rLevel.rowBytes, rLevel.width, m_Format);
+    }
+    else
+    {
+        blurHorizontal(pRow,
+                       rStage.ring.data() + 4 * size_t(rStage.width) * size_t(row % 5),
+                       m_Padded.data(),
+                       rStage.width);
+
+        // A row is final once the two rows below it exist
+        while(rStage.emitted + 2 <= row)
+        {
+            emit(level, rStage.emitted);
+        }
+    }
+
+    if(level + 1 >= m_Stages.size())
+    {
+        return;
+    }
+
+    const Stage& rNext = m_Stages[level + 1];
+
+    if((row & 1) == 0)
+    {
+        const bool isLast = (row + 1 == rStage.height);
+
+        if(isLast && (row / 2 < rNext.height))
+        {
+            // Single row level: pairs with itself
+            downsample(pRow, pRow, rStage.next.data(), rStage.width, rNext.width);
+
+            push(level + 1, rStage.next.data());
+        }
+        else
+        {
+            std::memcpy(rStage.pending.data(), pRow, rStage.pending.size() * sizeof(float));
+        }
+    }
+    else if(row / 2 < rNext.height)
+    {
+        downsample(rStage.pending.data(), pRow, rStage.next.data(), rStage.width, rNext.width);
+
+        push(level + 1, rStage.next.data());
+    }
+}
+
+void APPL::MipBlur::flush(const size_t& level)
+{
+    Stage& rStage = m_Stages[level];
+
+    while(rStage.emitted < rStage.height)
+    {
+        emit(level, rStage.emitted);
+    }
+}
+
+void APPL::MipBlur::build(const void* pPixels,
+                          const uint32_t& width,
+                          const uint32_t& height,
+                          const size_t& rowBytes,
+                          const PixelFormat& format)
+{
+    if((pPixels == nullptr) || (width == 0) || (height == 0))
+    {
+        m_Levels.clear();
+
+        return;
+    }
+
+    allocate(width, height);
+
+    const uint8_t* pSource = static_cast<const uint8_t*>(pPixels);
+
+    for(uint32_t y = 0; y < height; ++y)
+    {
+        decodeRow(pSource + size_t(y) * rowBytes, m_Row.data(), width, format);
+
+        push(0, m_Row.data());
+    }
+
+    // Every level has received all of its rows; emit the bottom rows with clamping
+    for(size_t level = 1; level < m_Stages.size(); ++level)
+    {
+        flush(level);
+    }
+}
+
+void APPL::MipBlur::buildReference(const void* pPixels,
+                                   const uint32_t& width,
+                                   const uint32_t& height,
+                                   const size_t& rowBytes,
+                                   const PixelFormat& format)
+{
+    if((pPixels == nullptr) || (width == 0) || (height == 0))
+    {
+        m_Levels.clear();
+
+        return;
+    }
+
+    const uint32_t count = levelCount(width, height);
+
+    m_Levels.resize(count);
+
+    // APPLDownsampleFilter: full resolution copy plus every mip level
+    std::vector<std::vector<float>> images(count);
+
+    images[0].resize(4 * size_t(width) * size_t(height));
+
+    const uint8_t* pSource = static_cast<const uint8_t*>(pPixels);
+
+    for(uint32_t y = 0; y < height; ++y)
+    {
+        decodeRow(pSource + size_t(y) * rowBytes, images[0].data() + 4 * size_t(y) * width, width, format);
+    }
+
+    for(uint32_t level = 0; level < count; ++level)
+    {
+        MipLevel& rLevel = m_Levels[level];
+
+        rLevel.width    = std::max<uint32_t>(width  >> level, 1);
+        rLevel.height   = std::max<uint32_t>(height >> level, 1);
+        rLevel.rowBytes = bytesPerPixel(m_Format) * rLevel.width;
+
+        rLevel.pixels.resize(rLevel.rowBytes * rLevel.height);
+
+        if(level == 0)
+        {
+            continue;
+        }
+
+        const MipLevel& rParent = m_Levels[level - 1];
+
+        images[level].resize(4 * size_t(rLevel.width) * size_t(rLevel.height));
+
+        for(uint32_t y = 0; y < rLevel.height; ++y)
+        {
+            const uint32_t y0 = std::min(2 * y,     rParent.height - 1);
+            const uint32_t y1 = std::min(2 * y + 1, rParent.height - 1);
+
+            downsample(images[level - 1].data() + 4 * size_t(y0) * rParent.width,
+                       images[level - 1].data() + 4 * size_t(y1) * rParent.width,
+                       images[level].data() + 4 * size_t(y) * rLevel.width,
+                       rParent.width,
+                       rLevel.width);
+        }
+    }
+
+    // APPLGaussianBlurFilter: horizontal pass into an intermediate, vertical pass back
+    std::vector<float> padded;
+    std::vector<float> horizontal;
+    std::vector<float> output;
+
+    for(uint32_t level = 0; level < count; ++level)
+    {
+        MipLevel& rLevel = m_Levels[level];
+
+        const size_t row = 4 * size_t(rLevel.width);
+
+        if(level == 0)
+        {
+            for(uint32_t y = 0; y < rLevel.height; ++y)
+            {
+                encodeRow(images[0].data() + row * y, rLevel.pixels.data() + rLevel.rowBytes * y, rLevel.width, m_Format);
+            }
+
+            continue;
+        }
+
+        padded.resize(row + 16);
+        horizontal.resize(row * rLevel.height);
+        output.resize(row);
+
+        for(uint32_t y = 0; y < rLevel.height; ++y)
+        {
+            blurHorizontal(images[level].data() + row * y, horizontal.data() + row * y, padded.data(), rLevel.width);
+        }
+
+        for(uint32_t y = 0; y < rLevel.height; ++y)
+        {
+            const float* pRows[5];
+
+            for(int32_t k = 0; k < 5; ++k)
+            {
+                const int32_t source = std::min(std::max(int32_t(y) + k - 2, 0), int32_t(rLevel.height) - 1);
+
+                pRows[k] = horizontal.data() + row * size_t(source);
+            }
+
+            blurVertical(pRows, output.data(), rLevel.width);
+
+            encodeRow(output.data(), rLevel.pixels.data() + rLevel.rowBytes * y, rLevel.width, m_Format);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU version of the APPLDownsampleFilter + APPLGaussianBlurFilter chain. The whole mip pyramid is
+ built and every level from 1 on is blurred with the 5-tap kernel of APPLFilter.metal in one
+ streaming pass over the rows of level 0: each produced row is blurred horizontally into a five
+ row ring, emitted vertically blurred as soon as its neighbours exist, and paired with the previous
+ row to produce the next level. No full-size intermediate is ever written.
+ */
+
+#ifndef _APPL_MIP_BLUR_H_
+#define _APPL_MIP_BLUR_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace APPL
+{
+    enum PixelFormat
+    {
+        ePixelFormatRGBA8Unorm = 0,
+        ePixelFormatRGBA8Unorm_sRGB,    // Filtered in linear space
+        ePixelFormatRGBA16Float,
+        ePixelFormatRGBA32Float
+    };
+
+    // Bytes per RGBA pixel of a format
+    size_t bytesPerPixel(const PixelFormat& format);
+
+    struct MipLevel
+    {
+        uint32_t             width;
+        uint32_t             height;
+        size_t               rowBytes;
+        std::vector<uint8_t> pixels;
+    };
+
+    class MipBlur
+    {
+    public:
+        // Output levels use the given format; the input format is passed to build()
+        MipBlur(const PixelFormat& format = ePixelFormatRGBA8Unorm);
+
+        // Number of levels of a full chain, as with MTLTextureDescriptor mipmapped:YES
+        static uint32_t levelCount(const uint32_t& width, const uint32_t& height);
+
+        // Single streaming pass over the rows of the source image
+        void build(const void* pPixels,
+                   const uint32_t& width,
+                   const uint32_t& height,
+                   const size_t& rowBytes,
+                   const PixelFormat& format);
+
+        // Level by level reference: full downsample of every level, then a horizontal
+        // and a vertical pass through an intermediate, like the Metal filters do
+        void buildReference(const void* pPixels,
+                            const uint32_t& width,
+                            const uint32_t& height,
+                            const size_t& rowBytes,
+                            const PixelFormat& format);
+
+        const std::vector<MipLevel>& levels() const;
+
+        // Peak bytes of float row storage used by the last streaming build
+        size_t workingSetBytes() const;
+
+    private:
+        // Streaming state of one level
+        struct Stage
+        {
+            uint32_t           width;
+            uint32_t           height;
+            uint32_t           received;   // Unblurred rows seen so far
+            uint32_t           emitted;    // Blurred rows written so far
+            std::vector<float> pending;    // Even row waiting for its odd partner
+            std::vector<float> ring;       // Five horizontally blurred rows
+            std::vector<float> output;     // Vertical result before conversion
+            std::vector<float> next;       // Downsampled row for the next level
+        };
+
+        void allocate(const uint32_t& width, const uint32_t& height);
+        void push(const size_t& level, const float* pRow);
+        void emit(const size_t& level, const uint32_t& row);
+        void flush(const size_t& level);
+
+        PixelFormat           m_Format;
+        std::vector<MipLevel> m_Levels;
+        std::vector<Stage>    m_Stages;     // One per level, level 0 is not blurred
+        std::vector<float>    m_Row;        // Converted source row
+        std::vector<float>    m_Padded;     // Row with clamped borders for the horizontal taps
+        size_t                mnWorkingSet;
+    }; // MipBlur
+} // APPL
+
+#endif
+
+#endif
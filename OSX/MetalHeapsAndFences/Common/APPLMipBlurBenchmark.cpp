@@ -0,0 +1,226 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the streaming mip blur, a standalone program that is not part of the app targets.
+ It checks that the streaming pass writes the same bytes as the level by level reference for odd
+ and degenerate sizes in every pixel format, and that the batch half conversion matches the scalar
+ one, then times both paths on square images.
+
+     c++ -std=c++11 -O2 -I../../../Shared/Half APPLMipBlur.cpp ../../../Shared/Half/HalfConversion.cpp \
+         APPLMipBlurBenchmark.cpp -o benchmark
+     ./benchmark [size]
+
+ Add -mf16c for the F16C conversions.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+
+#include "APPLMipBlur.h"
+#include "HalfConversion.h"
+
+using namespace APPL;
+
+namespace
+{
+    const char* kFormatNames[] = {"RGBA8Unorm", "RGBA8Unorm_sRGB", "RGBA16Float", "RGBA32Float"};
+
+    std::vector<uint8_t> image(const uint32_t& width, const uint32_t& height, const PixelFormat& format, std::mt19937& rRandom)
+    {
+        const size_t count = 4 * size_t(width) * size_t(height);
+
+        std::vector<uint8_t> pixels(count * bytesPerPixel(format) / 4);
+
+        switch(format)
+        {
+            case ePixelFormatRGBA16Float:
+            {
+                // Halves in [0.5, 1)
+                uint16_t* pHalves = reinterpret_cast<uint16_t*>(pixels.data());
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    pHalves[i] = uint16_t(0x3800 + rRandom() % 1024);
+                }
+                break;
+            }
+
+            case ePixelFormatRGBA32Float:
+            {
+                float* pFloats = reinterpret_cast<float*>(pixels.data());
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    pFloats[i] = float(rRandom() % 1000) / 1000.0f;
+                }
+                break;
+            }
+
+            default:
+                for(uint8_t& rByte : pixels)
+                {
+                    rByte = uint8_t(rRandom());
+                }
+                break;
+        }
+
+        return pixels;
+    }
+
+    bool checkStreaming()
+    {
+        const uint32_t sizes[][2] = {{1, 1}, {1, 7}, {13, 1}, {5, 3}, {64, 64}, {333, 97}, {1024, 768}};
+
+        std::mt19937 random(3);
+
+        bool passed = true;
+
+        for(const auto& size : sizes)
+        {
+            for(int f = 0; f < 4; ++f)
+            {
+                const PixelFormat format = PixelFormat(f);
+
+                const std::vector<uint8_t> pixels = image(size[0], size[1], format, random);
+
+                MipBlur streaming(format);
+                MipBlur reference(format);
+
+                streaming.build(pixels.data(), size[0], size[1], size[0] * bytesPerPixel(format), format);
+                reference.buildReference(pixels.data(), size[0], size[1], size[0] * bytesPerPixel(format), format);
+
+                for(size_t level = 0; level < streaming.levels().size(); ++level)
+                {
+                    if(streaming.levels()[level].pixels != reference.levels()[level].pixels)
+                    {
+                        std::printf("streaming: %ux%u %s level %zu differs from the reference\n",
+                                    size[0], size[1], kFormatNames[f], level);
+
+                        passed = false;
+                    }
+                }
+            }
+        }
+
+        std::printf("streaming: %s\n", passed ? "every level matches the reference" : "failed");
+
+        return passed;
+    }
+
+    bool checkHalves()
+    {
+        // Every half, through float and back
+        std::vector<uint16_t> halves(65536);
+        std::vector<float>    floats(65536);
+        std::vector<uint16_t> result(65536);
+
+        for(size_t i = 0; i < halves.size(); ++i)
+        {
+            halves[i] = uint16_t(i);
+        }
+
+        Half::toFloat(halves.data(), floats.data(), halves.size());
+        Half::fromFloat(floats.data(), result.data(), floats.size());
+
+        size_t wrong = 0;
+
+        for(size_t i = 0; i < halves.size(); ++i)
+        {
+            const bool nan = ((halves[i] & 0x7c00) == 0x7c00) && ((halves[i] & 0x3ff) != 0);
+
+            if(nan ? ((result[i] & 0x7c00) != 0x7c00 || (result[i] & 0x3ff) == 0) : (result[i] != halves[i]))
+            {
+                wrong++;
+            }
+
+            const float scalar = Half::toFloat(halves[i]);
+
+            if(std::memcmp(&scalar, &floats[i], sizeof(float)) != 0 && !nan)
+            {
+                wrong++;
+            }
+        }
+
+        // Random bit patterns, batch against scalar rounding
+        std::mt19937 random(5);
+
+        for(float& rValue : floats)
+        {
+            uint32_t bits = uint32_t(random());
+
+            std::memcpy(&rValue, &bits, sizeof(bits));
+        }
+
+        Half::fromFloat(floats.data(), result.data(), floats.size());
+
+        for(size_t i = 0; i < floats.size(); ++i)
+        {
+            const uint16_t scalar = Half::fromFloat(floats[i]);
+
+            if((result[i] != scalar) && !(floats[i] != floats[i]))
+            {
+                wrong++;
+            }
+        }
+
+        std::printf("halves: %zu conversions differ\n", wrong);
+
+        return wrong == 0;
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 3; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    if(!checkStreaming() || !checkHalves())
+    {
+        return 1;
+    }
+
+    const uint32_t largest = (argc >= 2) ? uint32_t(std::atoi(argv[1])) : 4096;
+
+    std::mt19937 random(7);
+
+    for(uint32_t size = 1024; size <= largest; size *= 2)
+    {
+        for(int f = 0; f < 4; ++f)
+        {
+            const PixelFormat format = PixelFormat(f);
+
+            const std::vector<uint8_t> pixels = image(size, size, format, random);
+
+            const size_t rowBytes = size * bytesPerPixel(format);
+
+            MipBlur blur(format);
+
+            const double streaming = milliseconds([&] { blur.build(pixels.data(), size, size, rowBytes, format); });
+            const double reference = milliseconds([&] { blur.buildReference(pixels.data(), size, size, rowBytes, format); });
+
+            std::printf("%5u %-16s streaming %8.1f ms, level by level %8.1f ms, %.2fx, %zu KB of rows\n",
+                        size, kFormatNames[f], streaming, reference, reference / streaming, blur.workingSetBytes() / 1024);
+        }
+    }
+
+    return 0;
+}
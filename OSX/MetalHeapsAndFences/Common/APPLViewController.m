@@ -9,6 +9,7 @@
 #import <math.h>
 #import "APPLViewController.h"
 #import "APPLFilter.h"
+#import "APPLHeapLayout.h"
 #import "AAPLTexture.h"
 
 @import simd;
@@ -244,15 +245,31 @@ static inline matrix_float4x4 matrix_from_scale(const float x, const float y, co
     // Вычисление размеров кучи
     MTLTextureDescriptor* descriptor = getDescFromTexture(inTexture);
     
-    // Вычисляем размеры для кучи?
-    MTLSizeAndAlign downsampleSizeAndAlignRequirement = [_downsample heapSizeAndAlignWithInputTextureDescriptor:descriptor];
-    MTLSizeAndAlign gaussianBlurSizeAndAlignRequirement = [_gaussianBlur heapSizeAndAlignWithInputTextureDescriptor:descriptor];
+    // Проходы: блит мипмап цепочки, затем горизонтальный и вертикальный блюр каждого левела начиная с первого
+    NSUInteger mipmapLevelCount = 1;
+    while((max(descriptor.width, descriptor.height) >> mipmapLevelCount) != 0) {
+        ++mipmapLevelCount;
+    }
+    NSUInteger passCount = 1 + 2 * (mipmapLevelCount - 1);
+    
+    // Мипмап цепочка остается на экране после графа, горизонтальные текстуры живут два прохода
+    // своего левела и делят память друг с другом, а не складываются
+    APPLHeapLayout *layout = [[APPLHeapLayout alloc] init];
+    [layout addTextureWithSizeAndAlign:[_downsample heapSizeAndAlignWithInputTextureDescriptor:descriptor]
+                             firstPass:0
+                              lastPass:passCount];
+    
+    for(NSUInteger mipmapLevel = 1; mipmapLevel < mipmapLevelCount; ++mipmapLevel) {
+        [layout addTextureWithSizeAndAlign:[_gaussianBlur heapSizeAndAlignWithInputTextureDescriptor:descriptor mipmapLevel:mipmapLevel]
+                                 firstPass:2 * mipmapLevel - 1
+                                  lastPass:2 * mipmapLevel];
+    }
     
-    NSUInteger totalSizeRequirement = downsampleSizeAndAlignRequirement.size + alignUp(gaussianBlurSizeAndAlignRequirement.size, gaussianBlurSizeAndAlignRequirement.align);
-    NSUInteger maxAlignmentRequirement = max(gaussianBlurSizeAndAlignRequirement.align, downsampleSizeAndAlignRequirement.align);
+    MTLSizeAndAlign heapSizeAndAlign = [layout heapSizeAndAlignWithPassCount:passCount];
+    assert(heapSizeAndAlign.size > 0 && "Invalid heap layout");
     
-    // Увеличиваем размерность размера кучи до ближайшего выровненного значения
-    totalSizeRequirement = alignUp(totalSizeRequirement, maxAlignmentRequirement);
+    NSUInteger totalSizeRequirement = heapSizeAndAlign.size;
+    NSUInteger maxAlignmentRequirement = heapSizeAndAlign.align;
     
     if(!_heap || (totalSizeRequirement > [_heap maxAvailableSizeWithAlignment:maxAlignmentRequirement])) {
         MTLHeapDescriptor* heapDesc = [[MTLHeapDescriptor alloc] init];
@@ -0,0 +1,1616 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU counterpart of the image filters in ImageFilters.swift. A filter graph is a chain of point-wise
+ and stencil operators. Consecutive operators are fused and executed tile by tile: every tile is
+ loaded once with the halo the fused operators need, filtered in cache-resident float buffers and
+ written once. Tiles are distributed over a work-stealing pool, so full 8K frames only ever exist
+ in memory as 8-bit images.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#include "CPUFilterGraph.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace CPUFilters
+{
+    // One RGBA pixel per register
+    struct float4
+    {
+#if defined(__SSE2__)
+        __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        float32x4_t v;
+#else
+        float v[4];
+#endif
+    };
+
+#if defined(__SSE2__)
+    static inline float4 load(const float* p)                  { return {_mm_loadu_ps(p)}; }
+    static inline void   store(float* p, const float4& a)      { _mm_storeu_ps(p, a.v); }
+    static inline float4 splat(const float& s)                 { return {_mm_set1_ps(s)}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+    static inline float4 operator-(const float4& a, const float4& b) { return {_mm_sub_ps(a.v, b.v)}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+    static inline float4 min(const float4& a, const float4& b) { return {_mm_min_ps(a.v, b.v)}; }
+    static inline float4 max(const float4& a, const float4& b) { return {_mm_max_ps(a.v, b.v)}; }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    static inline float4 load(const float* p)                  { return {vld1q_f32(p)}; }
+    static inline void   store(float* p, const float4& a)      { vst1q_f32(p, a.v); }
+    static inline float4 splat(const float& s)                 { return {vdupq_n_f32(s)}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+    static inline float4 operator-(const float4& a, const float4& b) { return {vsubq_f32(a.v, b.v)}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+    static inline float4 min(const float4& a, const float4& b) { return {vminq_f32(a.v, b.v)}; }
+    static inline float4 max(const float4& a, const float4& b) { return {vmaxq_f32(a.v, b.v)}; }
+#else
+    static inline float4 load(const float* p)                  { return {{p[0], p[1], p[2], p[3]}}; }
+    static inline void   store(float* p, const float4& a)      { std::memcpy(p, a.v, sizeof(a.v)); }
+    static inline float4 splat(const float& s)                 { return {{s, s, s, s}}; }
+    static inline float4 operator+(const float4& a, const float4& b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    static inline float4 operator-(const float4& a, const float4& b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+    static inline float4 operator*(const float4& a, const float4& b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+    static inline float4 min(const float4& a, const float4& b) { return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}}; }
+    static inline float4 max(const float4& a, const float4& b) { return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}}; }
+#endif
+
+    static inline float4 saturate(const float4& a)
+    {
+        return min(max(a, splat(0.0f)), splat(1.0f));
+    }
+
+    // BT.601 weights, as used by the MPS luminance based kernels
+    static inline float luminance(const float* p, const bool& isBGRA)
+    {
+        return isBGRA
+             ? (0.114f * p[0] + 0.587f * p[1] + 0.299f * p[2])
+             : (0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+    }
+
+    static inline int32_t clamp(const int32_t& v, const int32_t& lo, const int32_t& hi)
+    {
+        return std::min(std::max(v, lo), hi);
+    }
+
+    static Rect grow(const Rect& rRect, const int32_t& rx, const int32_t& ry, const Rect& rBounds)
+    {
+        const int32_t x0 = std::max(rRect.x - rx, rBounds.x);
+        const int32_t y0 = std::max(rRect.y - ry, rBounds.y);
+        const int32_t x1 = std::min(rRect.x + rRect.width  + rx, rBounds.x + rBounds.width);
+        const int32_t y1 = std::min(rRect.y + rRect.height + ry, rBounds.y + rBounds.height);
+
+        return {x0, y0, x1 - x0, y1 - y0};
+    }
+
+    // Clamped source columns/rows for [first, first + count), relative to the source region.
+    // Edge mode clamp, like the MPS kernels configured in ImageFilters.swift.
+    static void indices(std::vector<int32_t>& rIndices,
+                        const int32_t& first,
+                        const int32_t& count,
+                        const int32_t& lo,
+                        const int32_t& hi,
+                        const int32_t& origin)
+    {
+        rIndices.resize(size_t(count));
+
+        for(int32_t i = 0; i < count; ++i)
+        {
+            rIndices[size_t(i)] = clamp(first + i, lo, hi) - origin;
+        }
+    }
+
+    struct Lookup
+    {
+        std::vector<int32_t> columns;   // Index by (x - destination.x + radiusX)
+        std::vector<int32_t> rows;      // Index by (y - destination.y + radiusY)
+
+        void build(const Tile& rSource, const Tile& rDestination, const int32_t& rx, const int32_t& ry)
+        {
+            indices(columns,
+                    rDestination.region.x - rx,
+                    rDestination.region.width + 2 * rx,
+                    rSource.bounds.x,
+                    rSource.bounds.x + rSource.bounds.width - 1,
+                    rSource.region.x);
+
+            indices(rows,
+                    rDestination.region.y - ry,
+                    rDestination.region.height + 2 * ry,
+                    rSource.bounds.y,
+                    rSource.bounds.y + rSource.bounds.height - 1,
+                    rSource.region.y);
+        }
+
+        // Output columns [rFirst, rLast) whose footprint isn't clamped, so every tap is a fixed
+        // offset from the pixel. Clamping only happens at both ends of a row.
+        void interior(const int32_t& width, const int32_t& rx, int32_t& rFirst, int32_t& rLast) const
+        {
+            rFirst = 0;
+            rLast  = width;
+
+            while((rFirst < width) && (columns[size_t(rFirst + 2 * rx)] - columns[size_t(rFirst)] != 2 * rx))
+            {
+                rFirst += 1;
+            }
+
+            while((rLast > rFirst) && (columns[size_t(rLast - 1 + 2 * rx)] - columns[size_t(rLast - 1)] != 2 * rx))
+            {
+                rLast -= 1;
+            }
+        }
+    };
+
+    // Per-thread scratch, grows to the largest tile seen and is then reused
+    static thread_local std::vector<float>     gScratch;
+    static thread_local std::vector<float>     gTiles[2];
+    static thread_local Lookup                 gLookup;
+    static thread_local std::vector<float4>    gValues;
+    static thread_local std::vector<ptrdiff_t> gOffsets;
+
+    static float* reserve(std::vector<float>& rBuffer, const size_t& pixels)
+    {
+        if(rBuffer.size() < 4 * pixels)
+        {
+            rBuffer.resize(4 * pixels);
+        }
+
+        return rBuffer.data();
+    }
+
+    static float4* reserve(std::vector<float4>& rBuffer, const size_t& count)
+    {
+        if(rBuffer.size() < count)
+        {
+            rBuffer.resize(count);
+        }
+
+        return rBuffer.data();
+    }
+} // CPUFilters
+
+#pragma mark -
+#pragma mark Private - Comparator networks
+
+namespace CPUFilters
+{
+    // Min/max network over numbered slots of float4 values, run on four neighbouring pixels at
+    // once: each step is four independent min/max pairs, one per pixel, and all channels of a
+    // pixel share a register. Networks are generated once per operator; the inputs occupy the
+    // first slots and slots are reused as soon as their value is dead.
+    class Network
+    {
+    public:
+        // Sorts count values, outputs() in ascending order
+        static Network sorter(const int32_t& count);
+
+        // Median of diameter sorted columns of diameter values; rank r of column c is input
+        // c * diameter + r. Only the comparators the median depends on are kept.
+        static Network median(const int32_t& diameter);
+
+        size_t slots() const { return mnSlots; }
+        size_t steps() const { return m_Steps.size(); }
+
+        const std::vector<uint16_t>& outputs() const { return m_Outputs; }
+
+        // pValues holds four pixels per slot, slot s of pixel p at 4 * s + p
+        void run(float4* pValues) const
+        {
+            for(const Step& rStep : m_Steps)
+            {
+                const float4* pA = pValues + 4 * rStep.a;
+                const float4* pB = pValues + 4 * rStep.b;
+
+                const float4 low[4]  = {min(pA[0], pB[0]), min(pA[1], pB[1]), min(pA[2], pB[2]), min(pA[3], pB[3])};
+                const float4 high[4] = {max(pA[0], pB[0]), max(pA[1], pB[1]), max(pA[2], pB[2]), max(pA[3], pB[3])};
+
+                if(rStep.low != kUnused)
+                {
+                    std::copy(low, low + 4, pValues + 4 * rStep.low);
+                }
+
+                if(rStep.high != kUnused)
+                {
+                    std::copy(high, high + 4, pValues + 4 * rStep.high);
+                }
+            }
+        }
+
+    private:
+        static const uint16_t kUnused = 0xffff;
+
+        // Comparator on value ids, every output is a new id
+        struct Comparator
+        {
+            int32_t a;
+            int32_t b;
+            int32_t low;
+            int32_t high;
+        };
+
+        // Comparator on slots
+        struct Step
+        {
+            uint16_t a;
+            uint16_t b;
+            uint16_t low;
+            uint16_t high;
+        };
+
+        Network(const int32_t& inputs)
+        : mnSlots(0), mnValues(inputs)
+        {
+        }
+
+        std::vector<int32_t> merge(const std::vector<int32_t>& a, const std::vector<int32_t>& b);
+        std::vector<int32_t> sort(const std::vector<int32_t>& values);
+
+        void allocate(const int32_t& inputs, const std::vector<int32_t>& outputs);
+
+        size_t                  mnSlots;
+        int32_t                 mnValues;
+        std::vector<Comparator> m_Comparators;
+        std::vector<Step>       m_Steps;
+        std::vector<uint16_t>   m_Outputs;
+    }; // Network
+
+    // Batcher's odd-even merge for sorted lists of any length
+    std::vector<int32_t> Network::merge(const std::vector<int32_t>& a, const std::vector<int32_t>& b)
+    {
+        if(a.empty() || b.empty())
+        {
+            return a.empty() ? b : a;
+        }
+
+        if((a.size() == 1) && (b.size() == 1))
+        {
+            m_Comparators.push_back({a[0], b[0], mnValues, mnValues + 1});
+
+            mnValues += 2;
+
+            return {mnValues - 2, mnValues - 1};
+        }
+
+        std::vector<int32_t> halves[2][2];
+
+        for(size_t i = 0; i < a.size(); ++i)
+        {
+            halves[0][i & 1].push_back(a[i]);
+        }
+
+        for(size_t i = 0; i < b.size(); ++i)
+        {
+            halves[1][i & 1].push_back(b[i]);
+        }
+
+        const std::vector<int32_t> even = merge(halves[0][0], halves[1][0]);
+        const std::vector<int32_t> odd  = merge(halves[0][1], halves[1][1]);
+
+        // Only neighbours odd[i] and even[i + 1] can still be out of order
+        std::vector<int32_t> result(1, even[0]);
+
+        size_t i = 0;
+
+        for(; (i < odd.size()) && (i + 1 < even.size()); ++i)
+        {
+            m_Comparators.push_back({odd[i], even[i + 1], mnValues, mnValues + 1});
+
+            result.push_back(mnValues);
+            result.push_back(mnValues + 1);
+
+            mnValues += 2;
+        }
+
+        result.insert(result.end(), odd.begin() + i, odd.end());
+        result.insert(result.end(), even.begin() + std::min(i + 1, even.size()), even.end());
+
+        return result;
+    }
+
+    std::vector<int32_t> Network::sort(const std::vector<int32_t>& values)
+    {
+        if(values.size() <= 1)
+        {
+            return values;
+        }
+
+        const size_t half = values.size() / 2;
+
+        return merge(sort(std::vector<int32_t>(values.begin(), values.begin() + half)),
+                     sort(std::vector<int32_t>(values.begin() + half, values.end())));
+    }
+
+    // Drops comparators no output depends on and maps value ids to as few slots as possible
+    void Network::allocate(const int32_t& inputs, const std::vector<int32_t>& outputs)
+    {
+        std::vector<bool> needed(size_t(mnValues), false);
+
+        for(const int32_t& output : outputs)
+        {
+            needed[size_t(output)] = true;
+        }
+
+        std::vector<Comparator> kept;
+
+        for(size_t i = m_Comparators.size(); i > 0; --i)
+        {
+            Comparator comparator = m_Comparators[i - 1];
+
+            comparator.low  = needed[size_t(comparator.low)]  ? comparator.low  : -1;
+            comparator.high = needed[size_t(comparator.high)] ? comparator.high : -1;
+
+            if((comparator.low >= 0) || (comparator.high >= 0))
+            {
+                needed[size_t(comparator.a)] = true;
+                needed[size_t(comparator.b)] = true;
+
+                kept.push_back(comparator);
+            }
+        }
+
+        std::reverse(kept.begin(), kept.end());
+
+        // Last comparator reading each value; outputs stay alive to the end
+        std::vector<size_t> lastUse(size_t(mnValues), 0);
+
+        for(size_t i = 0; i < kept.size(); ++i)
+        {
+            lastUse[size_t(kept[i].a)] = i;
+            lastUse[size_t(kept[i].b)] = i;
+        }
+
+        for(const int32_t& output : outputs)
+        {
+            lastUse[size_t(output)] = kept.size();
+        }
+
+        std::vector<uint16_t> slot(size_t(mnValues), kUnused);
+        std::vector<uint16_t> free;
+
+        for(int32_t i = 0; i < inputs; ++i)
+        {
+            slot[size_t(i)] = uint16_t(i);
+        }
+
+        mnSlots = size_t(inputs);
+
+        auto acquire = [&](const int32_t& value) {
+            if(value < 0)
+            {
+                return kUnused;
+            }
+
+            if(free.empty())
+            {
+                free.push_back(uint16_t(mnSlots++));
+            }
+
+            slot[size_t(value)] = free.back();
+
+            free.pop_back();
+
+            return slot[size_t(value)];
+        };
+
+        for(size_t i = 0; i < kept.size(); ++i)
+        {
+            const Comparator& rComparator = kept[i];
+
+            const Step step = {slot[size_t(rComparator.a)], slot[size_t(rComparator.b)], 0, 0};
+
+            // run() reads both operands before writing, so dead operands are reused right away
+            if(lastUse[size_t(rComparator.a)] == i)
+            {
+                free.push_back(step.a);
+            }
+
+            if((lastUse[size_t(rComparator.b)] == i) && (rComparator.b != rComparator.a))
+            {
+                free.push_back(step.b);
+            }
+
+            const uint16_t low  = acquire(rComparator.low);
+            const uint16_t high = acquire(rComparator.high);
+
+            m_Steps.push_back({step.a, step.b, low, high});
+        }
+
+        for(const int32_t& output : outputs)
+        {
+            m_Outputs.push_back(slot[size_t(output)]);
+        }
+    }
+
+    Network Network::sorter(const int32_t& count)
+    {
+        Network network(count);
+
+        std::vector<int32_t> values(static_cast<size_t>(count));
+
+        for(int32_t i = 0; i < count; ++i)
+        {
+            values[size_t(i)] = i;
+        }
+
+        network.allocate(count, network.sort(values));
+
+        return network;
+    }
+
+    Network Network::median(const int32_t& diameter)
+    {
+        const int32_t count = diameter * diameter;
+
+        Network network(count);
+
+        // Merging the columns pairwise down a balanced tree, after pruning, needs fewer
+        // comparators than selecting from the unsorted footprint
+        std::function<std::vector<int32_t>(const int32_t&, const int32_t&)> columns = [&](const int32_t& first, const int32_t& last) {
+            if(last - first == 1)
+            {
+                std::vector<int32_t> column(static_cast<size_t>(diameter));
+
+                for(int32_t r = 0; r < diameter; ++r)
+                {
+                    column[size_t(r)] = first * diameter + r;
+                }
+
+                return column;
+            }
+
+            const int32_t half = first + (last - first) / 2;
+
+            return network.merge(columns(first, half), columns(half, last));
+        };
+
+        const std::vector<int32_t> sorted = columns(0, diameter);
+
+        network.allocate(count, std::vector<int32_t>(1, sorted[size_t(count / 2)]));
+
+        return network;
+    }
+} // CPUFilters
+
+#pragma mark -
+#pragma mark Private - Operators
+
+namespace CPUFilters
+{
+    // Weighted taps over a rectangular footprint (MPSImageConvolution, MPSImageLaplacian)
+    class Convolution : public Operator
+    {
+    public:
+        Convolution(const int32_t& width, const int32_t& height, const std::vector<float>& weights)
+        : mnRadiusX(width / 2), mnRadiusY(height / 2)
+        {
+            for(int32_t j = 0; j < height; ++j)
+            {
+                for(int32_t i = 0; i < width; ++i)
+                {
+                    const float weight = weights[size_t(j * width + i)];
+
+                    if(weight != 0.0f)
+                    {
+                        m_Taps.push_back({i - mnRadiusX, j - mnRadiusY, weight});
+                    }
+                }
+            }
+        }
+
+        int32_t radiusX() const { return mnRadiusX; }
+        int32_t radiusY() const { return mnRadiusY; }
+
+        void apply(const Tile& rSource, Tile& rDestination) const
+        {
+            Lookup& rLookup = gLookup;
+
+            rLookup.build(rSource, rDestination, mnRadiusX, mnRadiusY);
+
+            const Rect& rRegion = rDestination.region;
+
+            int32_t first = 0;
+            int32_t last  = 0;
+
+            rLookup.interior(rRegion.width, mnRadiusX, first, last);
+
+            // Offset of every tap from the pixel at output column x, in pixels minus x
+            std::vector<ptrdiff_t>& rOffsets = gOffsets;
+
+            rOffsets.resize(m_Taps.size());
+
+            const ptrdiff_t origin = ptrdiff_t(rRegion.x) - ptrdiff_t(rSource.region.x);
+
+            for(int32_t y = 0; y < rRegion.height; ++y)
+            {
+                float* pOut = rDestination.at(rRegion.x, rRegion.y + y);
+
+                for(size_t t = 0; t < m_Taps.size(); ++t)
+                {
+                    const int32_t row = rLookup.rows[size_t(y + m_Taps[t].dy + mnRadiusY)];
+
+                    rOffsets[t] = ptrdiff_t(row) * ptrdiff_t(rSource.stride) + origin + m_Taps[t].dx;
+                }
+
+                // Clamped columns at both ends look every tap up
+                auto edge = [&](const int32_t& x) {
+                    float4 sum = splat(0.0f);
+
+                    for(const Tap& rTap : m_Taps)
+                    {
+                        const int32_t column = rLookup.columns[size_t(x + rTap.dx + mnRadiusX)];
+                        const int32_t row    = rLookup.rows[size_t(y + rTap.dy + mnRadiusY)];
+
+                        const float* pIn = rSource.pData + 4 * (size_t(row) * rSource.stride + size_t(column));
+
+                        sum = sum + splat(rTap.weight) * load(pIn);
+                    }
+
+                    store(pOut + 4 * x, saturate(sum));
+                };
+
+                int32_t x = 0;
+
+                for(; x < first; ++x)
+                {
+                    edge(x);
+                }
+
+                // Four neighbouring pixels per tap
+                for(; x + 4 <= last; x += 4)
+                {
+                    float4 sum[4] = {splat(0.0f), splat(0.0f), splat(0.0f), splat(0.0f)};
+
+                    for(size_t t = 0; t < m_Taps.size(); ++t)
+                    {
+                        const float* pIn    = rSource.pData + 4 * (rOffsets[t] + x);
+                        const float4 weight = splat(m_Taps[t].weight);
+
+                        sum[0] = sum[0] + weight * load(pIn);
+                        sum[1] = sum[1] + weight * load(pIn + 4);
+                        sum[2] = sum[2] + weight * load(pIn + 8);
+                        sum[3] = sum[3] + weight * load(pIn + 12);
+                    }
+
+                    for(int32_t p = 0; p < 4; ++p)
+                    {
+                        store(pOut + 4 * (x + p), saturate(sum[p]));
+                    }
+                }
+
+                for(; x < rRegion.width; ++x)
+                {
+                    edge(x);
+                }
+            }
+        }
+
+        float cost() const { return float(m_Taps.size()); }
+
+    private:
+        struct Tap
+        {
+            int32_t dx;
+            int32_t dy;
+            float   weight;
+        };
+
+        int32_t          mnRadiusX;
+        int32_t          mnRadiusY;
+        std::vector<Tap> m_Taps;
+    }; // Convolution
+
+    // Two 1-D passes through a per-thread intermediate. Used for the Gaussian blur
+    // (weighted sum) and the rectangular area max/min (MPSImageAreaMax/Min).
+    class Separable : public Operator
+    {
+    public:
+        enum Mode
+        {
+            eSum = 0,
+            eMax,
+            eMin
+        };
+
+        Separable(const Mode& mode, const std::vector<float>& horizontal, const std::vector<float>& vertical)
+        : m_Mode(mode),
+          mnRadiusX(int32_t(horizontal.size()) / 2),
+          mnRadiusY(int32_t(vertical.size()) / 2),
+          m_Horizontal(horizontal),
+          m_Vertical(vertical)
+        {
+        }
+
+        int32_t radiusX() const { return mnRadiusX; }
+        int32_t radiusY() const { return mnRadiusY; }
+
+        void apply(const Tile& rSource, Tile& rDestination) const
+        {
+            Lookup& rLookup = gLookup;
+
+            rLookup.build(rSource, rDestination, mnRadiusX, mnRadiusY);
+
+            const Rect& rRegion = rDestination.region;
+
+            // The intermediate holds the horizontal result for every source row
+            // the vertical pass touches, at destination width
+            const int32_t firstRow = rLookup.rows.front();
+            const int32_t rows     = rLookup.rows.back() - firstRow + 1;
+
+            float* pScratch = reserve(gScratch, size_t(rows) * size_t(rRegion.width));
+
+            const int32_t tapsX = int32_t(m_Horizontal.size());
+            const int32_t tapsY = int32_t(m_Vertical.size());
+
+            int32_t first = 0;
+            int32_t last  = 0;
+
+            rLookup.interior(rRegion.width, mnRadiusX, first, last);
+
+            for(int32_t r = 0; r < rows; ++r)
+            {
+                const float* pRow = rSource.pData + 4 * size_t(firstRow + r) * rSource.stride;
+
+                float* pOut = pScratch + 4 * size_t(r) * size_t(rRegion.width);
+
+                for(int32_t x = 0; x < rRegion.width; ++x, pOut += 4)
+                {
+                    if((x >= first) && (x < last))
+                    {
+                        // Unclamped footprint, the taps are consecutive pixels
+                        const float* pIn = pRow + 4 * rLookup.columns[size_t(x)];
+
+                        store(pOut, reduce(m_Horizontal.data(), tapsX, [&](const int32_t& k) {
+                            return load(pIn + 4 * k);
+                        }));
+                    }
+                    else
+                    {
+                        store(pOut, reduce(m_Horizontal.data(), tapsX, [&](const int32_t& k) {
+                            return load(pRow + 4 * rLookup.columns[size_t(x + k)]);
+                        }));
+                    }
+                }
+            }
+
+            std::vector<ptrdiff_t>& rOffsets = gOffsets;
+
+            rOffsets.resize(size_t(tapsY));
+
+            for(int32_t y = 0; y < rRegion.height; ++y)
+            {
+                float* pOut = rDestination.at(rRegion.x, rRegion.y + y);
+
+                // Intermediate row of every tap, once per output row
+                for(int32_t k = 0; k < tapsY; ++k)
+                {
+                    rOffsets[size_t(k)] = ptrdiff_t(rLookup.rows[size_t(y + k)] - firstRow) * ptrdiff_t(rRegion.width);
+                }
+
+                for(int32_t x = 0; x < rRegion.width; ++x, pOut += 4)
+                {
+                    const float4 value = reduce(m_Vertical.data(), tapsY, [&](const int32_t& k) {
+                        return load(pScratch + 4 * (rOffsets[size_t(k)] + x));
+                    });
+
+                    store(pOut, saturate(value));
+                }
+            }
+        }
+
+        float cost() const { return float(m_Horizontal.size() + m_Vertical.size()); }
+
+    private:
+        template <typename Fetch>
+        inline float4 reduce(const float* pWeights, const int32_t& taps, const Fetch& fetch) const
+        {
+            float4 result = fetch(0);
+
+            switch(m_Mode)
+            {
+                case eSum:
+                    result = result * splat(pWeights[0]);
+
+                    for(int32_t k = 1; k < taps; ++k)
+                    {
+                        result = result + splat(pWeights[k]) * fetch(k);
+                    }
+                    break;
+
+                case eMax:
+                    for(int32_t k = 1; k < taps; ++k)
+                    {
+                        result = max(result, fetch(k));
+                    }
+                    break;
+
+                case eMin:
+                    for(int32_t k = 1; k < taps; ++k)
+                    {
+                        result = min(result, fetch(k));
+                    }
+                    break;
+            }
+
+            return result;
+        }
+
+        Mode               m_Mode;
+        int32_t            mnRadiusX;
+        int32_t            mnRadiusY;
+        std::vector<float> m_Horizontal;
+        std::vector<float> m_Vertical;
+    }; // Separable
+
+    // Maximum of source minus probe over the footprint (MPSImageDilate). Inputs are
+    // saturated, so probe entries of one or more can never win against the centre
+    // entry of zero and are dropped. The rest of the probe is split into runs of equal
+    // value along a row; every source row keeps the maxima over the power-of-two spans
+    // starting at each column, so a run of any length costs two loads per pixel.
+    class Dilate : public Operator
+    {
+    public:
+        Dilate(const int32_t& width, const int32_t& height, const std::vector<float>& probe)
+        : mnRadiusX(width / 2), mnRadiusY(height / 2), mnLevels(1)
+        {
+            for(int32_t j = 0; j < height; ++j)
+            {
+                for(int32_t i = 0; i < width; ++i)
+                {
+                    const float value = probe[size_t(j * width + i)];
+
+                    if(value >= 1.0f)
+                    {
+                        continue;
+                    }
+
+                    if(!m_Runs.empty())
+                    {
+                        Run& rLast = m_Runs.back();
+
+                        if((rLast.dy == j - mnRadiusY) && (rLast.dx + rLast.length == i - mnRadiusX) && (rLast.value == value))
+                        {
+                            rLast.length += 1;
+
+                            continue;
+                        }
+                    }
+
+                    m_Runs.push_back({i - mnRadiusX, j - mnRadiusY, 1, 0, value});
+                }
+            }
+
+            for(Run& rRun : m_Runs)
+            {
+                while((2 << rRun.level) <= rRun.length)
+                {
+                    rRun.level += 1;
+                }
+
+                mnLevels = std::max(mnLevels, rRun.level + 1);
+            }
+        }
+
+        int32_t radiusX() const { return mnRadiusX; }
+        int32_t radiusY() const { return mnRadiusY; }
+
+        void apply(const Tile& rSource, Tile& rDestination) const
+        {
+            Lookup& rLookup = gLookup;
+
+            rLookup.build(rSource, rDestination, mnRadiusX, mnRadiusY);
+
+            const Rect& rRegion = rDestination.region;
+
+            // Span maxima of the last 2 * radiusY + 1 source rows; the rows of one output row
+            // are consecutive, so source row modulo the ring size never collides
+            const size_t  columns = rLookup.columns.size();
+            const int32_t ring    = 2 * mnRadiusY + 1;
+
+            float4* pLevels = reserve(gValues, size_t(ring * mnLevels) * columns);
+
+            std::vector<ptrdiff_t>& rCached = gOffsets;
+
+            rCached.assign(size_t(ring), -1);
+
+            for(int32_t y = 0; y < rRegion.height; ++y)
+            {
+                float* pOut = rDestination.at(rRegion.x, rRegion.y + y);
+
+                for(int32_t x = 0; x < rRegion.width; ++x)
+                {
+                    store(pOut + 4 * x, splat(0.0f));
+                }
+
+                for(const Run& rRun : m_Runs)
+                {
+                    const int32_t row  = rLookup.rows[size_t(y + rRun.dy + mnRadiusY)];
+                    const int32_t slot = row % ring;
+
+                    float4* pRow = pLevels + size_t(slot * mnLevels) * columns;
+
+                    if(rCached[size_t(slot)] != row)
+                    {
+                        levels(rSource.pData + 4 * size_t(row) * rSource.stride, rLookup.columns, pRow);
+
+                        rCached[size_t(slot)] = row;
+                    }
+
+                    // Two overlapping spans of 2^level cover the run
+                    const float4* pA    = pRow + size_t(rRun.level) * columns + size_t(rRun.dx + mnRadiusX);
+                    const float4* pB    = pA + (rRun.length - (1 << rRun.level));
+                    const float4  value = splat(rRun.value);
+
+                    int32_t x = 0;
+
+                    for(; x + 4 <= rRegion.width; x += 4)
+                    {
+                        float* pPixels = pOut + 4 * x;
+
+                        store(pPixels,      max(load(pPixels),      max(pA[x],     pB[x])     - value));
+                        store(pPixels + 4,  max(load(pPixels + 4),  max(pA[x + 1], pB[x + 1]) - value));
+                        store(pPixels + 8,  max(load(pPixels + 8),  max(pA[x + 2], pB[x + 2]) - value));
+                        store(pPixels + 12, max(load(pPixels + 12), max(pA[x + 3], pB[x + 3]) - value));
+                    }
+
+                    for(; x < rRegion.width; ++x)
+                    {
+                        store(pOut + 4 * x, max(load(pOut + 4 * x), max(pA[x], pB[x]) - value));
+                    }
+                }
+
+                for(int32_t x = 0; x < rRegion.width; ++x)
+                {
+                    store(pOut + 4 * x, saturate(load(pOut + 4 * x)));
+                }
+            }
+        }
+
+        float cost() const { return 3.0f * float(m_Runs.size()) / 4.0f + float(mnLevels); }
+
+    private:
+        // Horizontal run of taps with the same probe value
+        struct Run
+        {
+            int32_t dx;         // First tap
+            int32_t dy;
+            int32_t length;
+            int32_t level;      // Largest power of two not above the length
+            float   value;
+        };
+
+        // Level l of pLevels holds the maximum of the 2^l clamped source columns starting at each
+        // column; spans past the end are never read by a run
+        void levels(const float* pRow, const std::vector<int32_t>& rColumns, float4* pLevels) const
+        {
+            const size_t columns = rColumns.size();
+
+            for(size_t i = 0; i < columns; ++i)
+            {
+                pLevels[i] = load(pRow + 4 * rColumns[i]);
+            }
+
+            for(int32_t level = 1; level < mnLevels; ++level)
+            {
+                const float4* pIn  = pLevels + size_t(level - 1) * columns;
+                float4*       pOut = pLevels + size_t(level) * columns;
+
+                const size_t half  = size_t(1) << (level - 1);
+                const size_t count = (columns >= 2 * half) ? columns - 2 * half + 1 : 0;
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    pOut[i] = max(pIn[i], pIn[i + half]);
+                }
+            }
+        }
+
+        int32_t          mnRadiusX;
+        int32_t          mnRadiusY;
+        int32_t          mnLevels;
+        std::vector<Run> m_Runs;
+    }; // Dilate
+
+    // Per-channel median (MPSImageMedian). Every column of the footprint is sorted once per
+    // output row and shared by the neighbouring outputs that read it; a merge network of the
+    // sorted columns, pruned to the median, then runs on four output pixels at once. Every step
+    // is a branch-free min/max on whole pixels, so all four channels are selected together.
+    class Median : public Operator
+    {
+    public:
+        Median(const int32_t& diameter)
+        : mnRadius(std::max(diameter, 1) / 2),
+          m_Sorter(Network::sorter(2 * mnRadius + 1)),
+          m_Median(Network::median(2 * mnRadius + 1))
+        {
+        }
+
+        int32_t radiusX() const { return mnRadius; }
+        int32_t radiusY() const { return mnRadius; }
+
+        void apply(const Tile& rSource, Tile& rDestination) const
+        {
+            Lookup& rLookup = gLookup;
+
+            rLookup.build(rSource, rDestination, mnRadius, mnRadius);
+
+            const Rect&   rRegion  = rDestination.region;
+            const int32_t diameter = 2 * mnRadius + 1;
+            const int32_t columns  = int32_t(rLookup.columns.size());
+
+            // Sorted columns, padded so the last group of four outputs reads valid values,
+            // followed by the network slots of four pixels
+            const size_t sorted = size_t(columns + 3) * size_t(diameter);
+            const size_t slots  = std::max(m_Sorter.slots(), m_Median.slots());
+
+            float4* pSorted = reserve(gValues, sorted + 4 * slots);
+            float4* pValues = pSorted + sorted;
+
+            std::vector<ptrdiff_t>& rRows = gOffsets;
+
+            rRows.resize(size_t(diameter));
+
+            for(int32_t y = 0; y < rRegion.height; ++y)
+            {
+                float* pOut = rDestination.at(rRegion.x, rRegion.y + y);
+
+                for(int32_t j = 0; j < diameter; ++j)
+                {
+                    rRows[size_t(j)] = ptrdiff_t(rLookup.rows[size_t(y + j)]) * ptrdiff_t(rSource.stride);
+                }
+
+                for(int32_t c = 0; c < columns + 3; c += 4)
+                {
+                    for(int32_t j = 0; j < diameter; ++j)
+                    {
+                        for(int32_t p = 0; p < 4; ++p)
+                        {
+                            const int32_t column = rLookup.columns[size_t(std::min(c + p, columns - 1))];
+
+                            pValues[4 * j + p] = load(rSource.pData + 4 * (rRows[size_t(j)] + column));
+                        }
+                    }
+
+                    m_Sorter.run(pValues);
+
+                    for(int32_t p = 0; (p < 4) && (c + p < columns + 3); ++p)
+                    {
+                        for(int32_t j = 0; j < diameter; ++j)
+                        {
+                            pSorted[size_t(c + p) * size_t(diameter) + size_t(j)] = pValues[4 * m_Sorter.outputs()[size_t(j)] + p];
+                        }
+                    }
+                }
+
+                for(int32_t x = 0; x < rRegion.width; x += 4)
+                {
+                    // Input c * diameter + r of pixel p is rank r of column x + p + c
+                    for(int32_t c = 0; c < diameter; ++c)
+                    {
+                        for(int32_t p = 0; p < 4; ++p)
+                        {
+                            const float4* pColumn = pSorted + size_t(x + p + c) * size_t(diameter);
+
+                            for(int32_t r = 0; r < diameter; ++r)
+                            {
+                                pValues[4 * (c * diameter + r) + p] = pColumn[r];
+                            }
+                        }
+                    }
+
+                    m_Median.run(pValues);
+
+                    const float4* pMedian = pValues + 4 * m_Median.outputs()[0];
+
+                    for(int32_t p = 0; (p < 4) && (x + p < rRegion.width); ++p)
+                    {
+                        store(pOut + 4 * (x + p), pMedian[p]);
+                    }
+                }
+            }
+        }
+
+        float cost() const
+        {
+            const int32_t diameter = 2 * mnRadius + 1;
+
+            return float(m_Sorter.steps() + m_Median.steps()) + float(diameter * diameter) / 2.0f;
+        }
+
+    private:
+        int32_t mnRadius;
+        Network m_Sorter;
+        Network m_Median;
+    }; // Median
+
+    // Gradient magnitude of the luminance (MPSImageSobel), replicated to RGB
+    class Sobel : public Operator
+    {
+    public:
+        int32_t radiusX() const { return 1; }
+        int32_t radiusY() const { return 1; }
+
+        void apply(const Tile& rSource, Tile& rDestination) const
+        {
+            Lookup& rLookup = gLookup;
+
+            rLookup.build(rSource, rDestination, 1, 1);
+
+            const Rect& rRegion = rDestination.region;
+
+            auto sample = [&](const int32_t& x, const int32_t& y) {
+                const size_t column = size_t(rLookup.columns[size_t(x)]);
+                const size_t row    = size_t(rLookup.rows[size_t(y)]);
+
+                return luminance(rSource.pData + 4 * (row * rSource.stride + column), rSource.isBGRA);
+            };
+
+            for(int32_t y = 0; y < rRegion.height; ++y)
+            {
+                float* pOut = rDestination.at(rRegion.x, rRegion.y + y);
+
+                for(int32_t x = 0; x < rRegion.width; ++x, pOut += 4)
+                {
+                    const float a = sample(x,     y), b = sample(x + 1, y),     c = sample(x + 2, y);
+                    const float d = sample(x, y + 1),                           f = sample(x + 2, y + 1);
+                    const float g = sample(x, y + 2), h = sample(x + 1, y + 2), k = sample(x + 2, y + 2);
+
+                    const float gx = (c + 2.0f * f + k) - (a + 2.0f * d + g);
+                    const float gy = (g + 2.0f * h + k) - (a + 2.0f * b + c);
+
+                    const float magnitude = std::min(std::sqrt(gx * gx + gy * gy), 1.0f);
+
+                    pOut[0] = magnitude;
+                    pOut[1] = magnitude;
+                    pOut[2] = magnitude;
+                    pOut[3] = 1.0f;
+                }
+            }
+        }
+
+        float cost() const { return 12.0f; }
+    }; // Sobel
+
+    // Luminance above the threshold maps to the maximum, everything else to zero
+    // (MPSImageThresholdBinary with the default gray transform). Alpha is kept.
+    class ThresholdBinary : public Operator
+    {
+    public:
+        ThresholdBinary(const float& threshold, const float& maximum)
+        : mnThreshold(threshold), mnMaximum(std::min(std::max(maximum, 0.0f), 1.0f))
+        {
+        }
+
+        void apply(const Tile& rSource, Tile& rDestination) const
+        {
+            const Rect& rRegion = rDestination.region;
+
+            for(int32_t y = 0; y < rRegion.height; ++y)
+            {
+                const float* pIn  = rSource.at(rRegion.x, rRegion.y + y);
+                float*       pOut = rDestination.at(rRegion.x, rRegion.y + y);
+
+                for(int32_t x = 0; x < rRegion.width; ++x, pIn += 4, pOut += 4)
+                {
+                    const float value = (luminance(pIn, rSource.isBGRA) > mnThreshold) ? mnMaximum : 0.0f;
+
+                    pOut[0] = value;
+                    pOut[1] = value;
+                    pOut[2] = value;
+                    pOut[3] = pIn[3];
+                }
+            }
+        }
+
+    private:
+        float mnThreshold;
+        float mnMaximum;
+    }; // ThresholdBinary
+
+    static std::vector<float> gaussianWeights(const float& sigma)
+    {
+        const int32_t radius = std::max(1, int32_t(std::ceil(3.0f * sigma)));
+
+        std::vector<float> weights(size_t(2 * radius + 1));
+
+        float sum = 0.0f;
+
+        for(int32_t i = -radius; i <= radius; ++i)
+        {
+            const float weight = std::exp(-float(i * i) / (2.0f * sigma * sigma));
+
+            weights[size_t(i + radius)] = weight;
+
+            sum += weight;
+        }
+
+        for(float& rWeight : weights)
+        {
+            rWeight /= sum;
+        }
+
+        return weights;
+    }
+} // CPUFilters
+
+#pragma mark -
+#pragma mark Private - Pixel conversion
+
+namespace CPUFilters
+{
+    static void load(const ImageView& rImage, const Tile& rTile)
+    {
+        const float scale = 1.0f / 255.0f;
+
+        for(int32_t y = 0; y < rTile.region.height; ++y)
+        {
+            const uint8_t* pIn  = rImage.pixels + size_t(rTile.region.y + y) * rImage.rowBytes + 4 * size_t(rTile.region.x);
+            float*         pOut = rTile.at(rTile.region.x, rTile.region.y + y);
+
+            const size_t count = 4 * size_t(rTile.region.width);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                pOut[i] = float(pIn[i]) * scale;
+            }
+        }
+    }
+
+    static void store(const Tile& rTile, const ImageView& rImage)
+    {
+        for(int32_t y = 0; y < rTile.region.height; ++y)
+        {
+            const float* pIn  = rTile.at(rTile.region.x, rTile.region.y + y);
+            uint8_t*     pOut = rImage.pixels + size_t(rTile.region.y + y) * rImage.rowBytes + 4 * size_t(rTile.region.x);
+
+            const size_t count = 4 * size_t(rTile.region.width);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const float value = std::min(std::max(pIn[i], 0.0f), 1.0f);
+
+                pOut[i] = uint8_t(value * 255.0f + 0.5f);
+            }
+        }
+    }
+} // CPUFilters
+
+#pragma mark -
+#pragma mark Public - Images
+
+CPUFilters::Image::Image(const uint32_t& width, const uint32_t& height, const bool& isBGRA)
+: m_Pixels(4 * size_t(width) * size_t(height))
+{
+    m_View.pixels   = m_Pixels.data();
+    m_View.width    = width;
+    m_View.height   = height;
+    m_View.rowBytes = 4 * size_t(width);
+    m_View.isBGRA   = isBGRA;
+}
+
+CPUFilters::ImageView CPUFilters::Image::view()
+{
+    return m_View;
+}
+
+#pragma mark -
+#pragma mark Public - Graph
+
+CPUFilters::Config CPUFilters::defaults()
+{
+    Config config;
+
+    config.cacheBytes   = 1 << 20;
+    config.maxFusedHalo = 16;
+    config.minTileSize  = 32;
+    config.passCost     = 16.0f;
+
+    return config;
+}
+
+CPUFilters::Graph::Graph(const Config& config)
+: m_Config(config)
+{
+}
+
+CPUFilters::Graph& CPUFilters::Graph::append(const std::shared_ptr<Operator>& pOperator)
+{
+    if(pOperator)
+    {
+        m_Operators.push_back(pOperator);
+    }
+
+    return *this;
+}
+
+CPUFilters::Graph& CPUFilters::Graph::gaussianBlur(const float& sigma)
+{
+    const std::vector<float> weights = gaussianWeights(sigma);
+
+    return append(std::make_shared<Separable>(Separable::eSum, weights, weights));
+}
+
+CPUFilters::Graph& CPUFilters::Graph::median(const int32_t& diameter)
+{
+    return append(std::make_shared<Median>(diameter));
+}
+
+CPUFilters::Graph& CPUFilters::Graph::laplacian()
+{
+    return convolution(3, 3, {0.0f, 1.0f, 0.0f, 1.0f, -4.0f, 1.0f, 0.0f, 1.0f, 0.0f});
+}
+
+CPUFilters::Graph& CPUFilters::Graph::sobel()
+{
+    return append(std::make_shared<Sobel>());
+}
+
+CPUFilters::Graph& CPUFilters::Graph::thresholdBinary(const float& threshold, const float& maximum)
+{
+    return append(std::make_shared<ThresholdBinary>(threshold, maximum));
+}
+
+CPUFilters::Graph& CPUFilters::Graph::convolution(const int32_t& width, const int32_t& height, const std::vector<float>& weights)
+{
+    if(weights.size() != size_t(width * height))
+    {
+        return *this;
+    }
+
+    return append(std::make_shared<Convolution>(width, height, weights));
+}
+
+CPUFilters::Graph& CPUFilters::Graph::dilate(const int32_t& width, const int32_t& height, const std::vector<float>& probe)
+{
+    if(probe.size() != size_t(width * height))
+    {
+        return *this;
+    }
+
+    return append(std::make_shared<Dilate>(width, height, probe));
+}
+
+CPUFilters::Graph& CPUFilters::Graph::areaMax(const int32_t& width, const int32_t& height)
+{
+    return append(std::make_shared<Separable>(Separable::eMax,
+                                              std::vector<float>(size_t(width), 1.0f),
+                                              std::vector<float>(size_t(height), 1.0f)));
+}
+
+CPUFilters::Graph& CPUFilters::Graph::areaMin(const int32_t& width, const int32_t& height)
+{
+    return append(std::make_shared<Separable>(Separable::eMin,
+                                              std::vector<float>(size_t(width), 1.0f),
+                                              std::vector<float>(size_t(height), 1.0f)));
+}
+
+std::vector<CPUFilters::Graph::Segment> CPUFilters::Graph::segments() const
+{
+    std::vector<Segment> result;
+
+    for(size_t i = 0; i < m_Operators.size(); ++i)
+    {
+        const int32_t rx = m_Operators[i]->radiusX();
+        const int32_t ry = m_Operators[i]->radiusY();
+
+        if(!result.empty())
+        {
+            Segment& rLast = result.back();
+
+            const int32_t haloX = rLast.haloX + rx;
+            const int32_t haloY = rLast.haloY + ry;
+
+            // Fusing saves a pass, but the operators already in the segment then cover
+            // the tile grown by this operator's radii
+            if((std::max(haloX, haloY) <= m_Config.maxFusedHalo)
+               && (cost(rLast.first, rLast.count + 1) <= cost(rLast.first, rLast.count) + cost(i, 1)))
+            {
+                rLast.count += 1;
+                rLast.haloX  = haloX;
+                rLast.haloY  = haloY;
+
+                continue;
+            }
+        }
+
+        result.push_back({i, 1, rx, ry});
+    }
+
+    return result;
+}
+
+double CPUFilters::Graph::cost(const size_t& first, const size_t& count) const
+{
+    int32_t haloX = 0;
+    int32_t haloY = 0;
+
+    for(size_t k = first; k < first + count; ++k)
+    {
+        haloX += m_Operators[k]->radiusX();
+        haloY += m_Operators[k]->radiusY();
+    }
+
+    const double size = double(tileSize(std::max(haloX, haloY)));
+
+    // Every operator covers the tile grown by the radii of the operators after it,
+    // the input is loaded over the whole halo
+    double work = 0.0;
+
+    haloX = 0;
+    haloY = 0;
+
+    for(size_t k = first + count; k > first; --k)
+    {
+        const Operator& rOperator = *m_Operators[k - 1];
+
+        work += rOperator.cost() * (size + 2.0 * haloX) * (size + 2.0 * haloY);
+
+        haloX += rOperator.radiusX();
+        haloY += rOperator.radiusY();
+    }
+
+    work += m_Config.passCost * (size + 2.0 * haloX) * (size + 2.0 * haloY);
+
+    return work / (size * size);
+}
+
+size_t CPUFilters::Graph::passes() const
+{
+    return std::max<size_t>(segments().size(), 1);
+}
+
+int32_t CPUFilters::Graph::tileSize(const int32_t& halo) const
+{
+    // Two ping-pong tiles plus one separable intermediate, float RGBA
+    const double edge = std::sqrt(double(m_Config.cacheBytes) / (3.0 * 4.0 * sizeof(float)));
+
+    const int32_t size = int32_t(edge) - 2 * halo;
+
+    return std::max(m_Config.minTileSize, size & ~3);
+}
+
+void CPUFilters::Graph::encodeSegment(const Segment& rSegment,
+                                      const ImageView& rSource,
+                                      const ImageView& rDestination,
+                                      Threads::WorkStealingPool* pPool) const
+{
+    const Rect bounds = {0, 0, int32_t(rSource.width), int32_t(rSource.height)};
+
+    const int32_t size   = tileSize(std::max(rSegment.haloX, rSegment.haloY));
+    const int32_t tilesX = (bounds.width  + size - 1) / size;
+    const int32_t tilesY = (bounds.height + size - 1) / size;
+
+    auto body = [&](size_t index) {
+        const int32_t tx = int32_t(index % size_t(tilesX));
+        const int32_t ty = int32_t(index / size_t(tilesX));
+
+        const Rect output = {
+            tx * size,
+            ty * size,
+            std::min(size, bounds.width  - tx * size),
+            std::min(size, bounds.height - ty * size)
+        };
+
+        // Regions of every stage, back to front: each operator needs its
+        // output region grown by its radii, clipped to the image
+        std::vector<Rect> regions(rSegment.count + 1);
+
+        regions[rSegment.count] = output;
+
+        for(size_t k = rSegment.count; k > 0; --k)
+        {
+            const Operator& rOperator = *m_Operators[rSegment.first + k - 1];
+
+            regions[k - 1] = grow(regions[k], rOperator.radiusX(), rOperator.radiusY(), bounds);
+        }
+
+        const size_t pixels = size_t(regions[0].width) * size_t(regions[0].height);
+
+        Tile tiles[2];
+
+        for(int32_t i = 0; i < 2; ++i)
+        {
+            tiles[i].pData  = reserve(gTiles[i], pixels);
+            tiles[i].bounds = bounds;
+            tiles[i].isBGRA = rSource.isBGRA;
+        }
+
+        int32_t current = 0;
+
+        tiles[current].region = regions[0];
+        tiles[current].stride = size_t(regions[0].width);
+
+        load(rSource, tiles[current]);
+
+        for(size_t k = 0; k < rSegment.count; ++k)
+        {
+            const Operator& rOperator = *m_Operators[rSegment.first + k];
+
+            if(rOperator.isPointwise())
+            {
+                // Point-wise operators run in place on the current tile
+                Tile view = tiles[current];
+
+                view.region = regions[k + 1];
+
+                rOperator.apply(view, view);
+            }
+            else
+            {
+                Tile& rTarget = tiles[1 - current];
+
+                rTarget.region = regions[k + 1];
+                rTarget.stride = size_t(regions[k + 1].width);
+
+                rOperator.apply(tiles[current], rTarget);
+
+                current = 1 - current;
+            }
+        }
+
+        Tile result = tiles[current];
+
+        result.region = output;
+
+        store(result, rDestination);
+    };
+
+    const size_t count = size_t(tilesX) * size_t(tilesY);
+
+    if(pPool)
+    {
+        pPool->parallelFor(count, body, 1);
+    }
+    else
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            body(i);
+        }
+    }
+}
+
+void CPUFilters::Graph::encode(const ImageView& rSource,
+                               const ImageView& rDestination,
+                               Threads::WorkStealingPool* pPool) const
+{
+    if((rSource.width != rDestination.width) || (rSource.height != rDestination.height))
+    {
+        return;
+    }
+
+    const std::vector<Segment> plan = segments();
+
+    if(plan.empty())
+    {
+        // PassThrough
+        for(uint32_t y = 0; y < rSource.height; ++y)
+        {
+            std::memcpy(rDestination.pixels + y * rDestination.rowBytes,
+                        rSource.pixels + y * rSource.rowBytes,
+                        4 * size_t(rSource.width));
+        }
+
+        return;
+    }
+
+    // Segments that could not be fused exchange data through 8-bit intermediates
+    std::unique_ptr<Image> pIntermediates[2];
+
+    ImageView input = rSource;
+
+    for(size_t s = 0; s < plan.size(); ++s)
+    {
+        ImageView output = rDestination;
+
+        if(s + 1 < plan.size())
+        {
+            std::unique_ptr<Image>& rpImage = pIntermediates[s & 1];
+
+            if(!rpImage)
+            {
+                rpImage.reset(new Image(rSource.width, rSource.height, rSource.isBGRA));
+            }
+
+            output = rpImage->view();
+        }
+
+        encodeSegment(plan[s], input, output, pPool);
+
+        input = output;
+    }
+}
+
+#pragma mark -
+#pragma mark Public - Presets
+
+std::vector<float> CPUFilters::Presets::bokehProbe(const int32_t& radius)
+{
+    const int32_t size = 2 * radius + 1;
+    const float   mid  = float(size) / 2.0f;
+
+    std::vector<float> probe;
+
+    probe.reserve(size_t(size * size));
+
+    for(int32_t i = 0; i < size; ++i)
+    {
+        for(int32_t j = 0; j < size; ++j)
+        {
+            const float x = std::fabs(float(i) - mid);
+            const float y = std::fabs(float(j) - mid);
+
+            probe.push_back((std::hypot(x, y) < float(radius)) ? 0.0f : 1.0f);
+        }
+    }
+
+    return probe;
+}
+
+CPUFilters::Graph CPUFilters::Presets::passThrough()
+{
+    return Graph();
+}
+
+CPUFilters::Graph CPUFilters::Presets::gaussianBlur()
+{
+    return Graph().gaussianBlur(5.0f);
+}
+
+CPUFilters::Graph CPUFilters::Presets::median()
+{
+    return Graph().median(5);
+}
+
+CPUFilters::Graph CPUFilters::Presets::laplacian()
+{
+    return Graph().laplacian();
+}
+
+CPUFilters::Graph CPUFilters::Presets::sobel()
+{
+    return Graph().sobel();
+}
+
+CPUFilters::Graph CPUFilters::Presets::thresholdBinary()
+{
+    return Graph().thresholdBinary(0.5f, 1.0f);
+}
+
+CPUFilters::Graph CPUFilters::Presets::convolutionEmboss()
+{
+    return Graph().convolution(3, 3, {-2.0f, 0.0f, 0.0f,
+                                       0.0f, 1.0f, 0.0f,
+                                       0.0f, 0.0f, 2.0f});
+}
+
+CPUFilters::Graph CPUFilters::Presets::convolutionSharpen()
+{
+    return Graph().convolution(3, 3, {-0.5f, -1.0f, -0.5f,
+                                      -1.0f,  7.0f, -1.0f,
+                                      -0.5f, -1.0f, -0.5f});
+}
+
+CPUFilters::Graph CPUFilters::Presets::dilateBokeh()
+{
+    const int32_t radius = 7;
+
+    return Graph().dilate(2 * radius + 1, 2 * radius + 1, bokehProbe(radius));
+}
+
+CPUFilters::Graph CPUFilters::Presets::morphologyClosing()
+{
+    return Graph().areaMax(9, 9).areaMin(9, 9);
+}
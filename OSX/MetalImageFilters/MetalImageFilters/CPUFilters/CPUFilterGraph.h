@@ -0,0 +1,178 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU counterpart of the image filters in ImageFilters.swift. A filter graph is a chain of point-wise
+ and stencil operators. Consecutive operators are fused and executed tile by tile: every tile is
+ loaded once with the halo the fused operators need, filtered in cache-resident float buffers and
+ written once. Tiles are distributed over a work-stealing pool, so full 8K frames only ever exist
+ in memory as 8-bit images.
+ */
+
+#ifndef _CPU_FILTER_GRAPH_H_
+#define _CPU_FILTER_GRAPH_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "WorkStealingPool.h"
+
+namespace CPUFilters
+{
+    // Non-owning view of an 8-bit, four channel image
+    struct ImageView
+    {
+        uint8_t* pixels;
+        uint32_t width;
+        uint32_t height;
+        size_t   rowBytes;
+        bool     isBGRA;    // Channel order, only matters for luminance based operators
+    };
+
+    // Owning 8-bit, four channel image
+    class Image
+    {
+    public:
+        Image(const uint32_t& width, const uint32_t& height, const bool& isBGRA = false);
+
+        ImageView view();
+
+    private:
+        std::vector<uint8_t> m_Pixels;
+        ImageView            m_View;
+    }; // Image
+
+    struct Rect
+    {
+        int32_t x;
+        int32_t y;
+        int32_t width;
+        int32_t height;
+    };
+
+    // Float RGBA working buffer covering a region of the image
+    struct Tile
+    {
+        float*  pData;      // 4 floats per pixel
+        Rect    region;     // Region of the image stored in the buffer
+        size_t  stride;     // Pixels per row
+        Rect    bounds;     // Whole image, reads outside are clamped to it
+        bool    isBGRA;
+
+        inline float* at(const int32_t& x, const int32_t& y) const
+        {
+            return pData + 4 * (size_t(y - region.y) * stride + size_t(x - region.x));
+        }
+    };
+
+    class Operator
+    {
+    public:
+        virtual ~Operator() {}
+
+        // Horizontal and vertical reach of the operator; zero for point-wise operators
+        virtual int32_t radiusX() const { return 0; }
+        virtual int32_t radiusY() const { return 0; }
+
+        // Point-wise operators filter in place, everything else reads rSource
+        bool isPointwise() const { return (radiusX() == 0) && (radiusY() == 0); }
+
+        // Filter rDestination.region. rSource covers the region grown by the radii,
+        // clipped to the image bounds. Outputs are saturated like an 8-bit texture write.
+        virtual void apply(const Tile& rSource, Tile& rDestination) const = 0;
+
+        // Work per output pixel, roughly in float4 operations. The graph weighs it against
+        // the halo every fused tile recomputes.
+        virtual float cost() const { return 1.0f; }
+    }; // Operator
+
+    struct Config
+    {
+        size_t  cacheBytes;     // Per-thread budget for the fused tile buffers
+        int32_t maxFusedHalo;   // Operators are fused while the accumulated halo stays below this
+        int32_t minTileSize;
+        float   passCost;       // Per pixel cost of a pass through an 8-bit intermediate, in Operator::cost() units
+    };
+
+    // 1 MB of L2 per thread, halo up to 16 pixels. Within that halo an operator is only fused
+    // when the pass it saves costs more than recomputing the halo of the operators before it.
+    Config defaults();
+
+    class Graph
+    {
+    public:
+        Graph(const Config& config = defaults());
+
+        // Operators matching the MPS kernels used in ImageFilters.swift
+        Graph& gaussianBlur(const float& sigma);
+        Graph& median(const int32_t& diameter);
+        Graph& laplacian();
+        Graph& sobel();
+        Graph& thresholdBinary(const float& threshold, const float& maximum);
+        Graph& convolution(const int32_t& width, const int32_t& height, const std::vector<float>& weights);
+        Graph& dilate(const int32_t& width, const int32_t& height, const std::vector<float>& probe);
+        Graph& areaMax(const int32_t& width, const int32_t& height);
+        Graph& areaMin(const int32_t& width, const int32_t& height);
+
+        // Custom operator
+        Graph& append(const std::shared_ptr<Operator>& pOperator);
+
+        // Filter rSource into rDestination (same size). Runs on the pool when one is given.
+        void encode(const ImageView& rSource,
+                    const ImageView& rDestination,
+                    Threads::WorkStealingPool* pPool = nullptr) const;
+
+        // Number of passes over full images after fusion
+        size_t passes() const;
+
+        // Tile edge used for an accumulated halo
+        int32_t tileSize(const int32_t& halo) const;
+
+    private:
+        struct Segment
+        {
+            size_t  first;
+            size_t  count;
+            int32_t haloX;
+            int32_t haloY;
+        };
+
+        std::vector<Segment> segments() const;
+
+        // Work per output pixel of running operators [first, first + count) as one segment
+        double cost(const size_t& first, const size_t& count) const;
+
+        void encodeSegment(const Segment& rSegment,
+                           const ImageView& rSource,
+                           const ImageView& rDestination,
+                           Threads::WorkStealingPool* pPool) const;
+
+        Config                                 m_Config;
+        std::vector<std::shared_ptr<Operator>> m_Operators;
+    }; // Graph
+
+    namespace Presets
+    {
+        // Probe of DilateBokeh: zero inside the circle, one outside
+        std::vector<float> bokehProbe(const int32_t& radius);
+
+        Graph passThrough();
+        Graph gaussianBlur();           // sigma 5
+        Graph median();                 // diameter 5
+        Graph laplacian();
+        Graph sobel();
+        Graph thresholdBinary();        // threshold 0.5
+        Graph convolutionEmboss();
+        Graph convolutionSharpen();
+        Graph dilateBokeh();            // radius 7
+        Graph morphologyClosing();      // 9x9 max then 9x9 min
+    } // Presets
+} // CPUFilters
+
+#endif
+
+#endif
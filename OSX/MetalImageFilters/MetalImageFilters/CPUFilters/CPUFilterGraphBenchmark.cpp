@@ -0,0 +1,293 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the CPU filter graph, a standalone program that is not part of the app target.
+ It checks that tiling doesn't change the output: a long chain and every operator are run in one
+ image-sized tile and in tiny tiles on the pool, and the medians are compared against sorting.
+ Then every preset and two chains are timed on a frame, one full-image pass per operator against
+ the fused graph. Fusing saves passes over memory but recomputes the halo of every tile; the graph
+ only fuses an operator when the pass it saves costs more than that, so the chain of small stencils
+ runs as one pass and the chain with the median keeps the median in a pass of its own.
+
+     c++ -std=c++11 -O2 -pthread -I../../../../Shared/Threads CPUFilterGraph.cpp \
+         ../../../../Shared/Threads/WorkStealingPool.cpp CPUFilterGraphBenchmark.cpp -o benchmark
+     ./benchmark [width height]
+
+ The frame defaults to 8K, 7680x4320.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+
+#include "CPUFilterGraph.h"
+
+using namespace CPUFilters;
+
+namespace
+{
+    // Every operator in one chain, the halos add up to more than the fusion limit
+    Graph chain(const Config& config)
+    {
+        return Graph(config).median(5)
+                            .convolution(3, 3, {-0.5f, -1.0f, -0.5f, -1.0f, 7.0f, -1.0f, -0.5f, -1.0f, -0.5f})
+                            .thresholdBinary(0.5f, 1.0f)
+                            .gaussianBlur(2.0f)
+                            .dilate(15, 15, Presets::bokehProbe(7))
+                            .areaMax(9, 9)
+                            .areaMin(9, 9)
+                            .sobel()
+                            .laplacian();
+    }
+
+    // Only small stencils, the halos stay below the fusion limit
+    Graph cheapChain(const Config& config)
+    {
+        return Graph(config).convolution(3, 3, {-0.5f, -1.0f, -0.5f, -1.0f, 7.0f, -1.0f, -0.5f, -1.0f, -0.5f})
+                            .thresholdBinary(0.5f, 1.0f)
+                            .sobel()
+                            .laplacian()
+                            .areaMax(3, 3)
+                            .areaMin(3, 3);
+    }
+
+    // One pass over the full image per operator
+    Config unfused()
+    {
+        Config config = defaults();
+
+        config.maxFusedHalo = -1;
+
+        return config;
+    }
+
+    void randomize(const ImageView& rImage)
+    {
+        std::mt19937 random(1);
+
+        for(size_t i = 0; i < rImage.rowBytes * rImage.height; ++i)
+        {
+            rImage.pixels[i] = uint8_t(random() & 0xff);
+        }
+    }
+
+    int difference(const ImageView& rA, const ImageView& rB)
+    {
+        int result = 0;
+
+        for(size_t i = 0; i < rA.rowBytes * rA.height; ++i)
+        {
+            result = std::max(result, std::abs(int(rA.pixels[i]) - int(rB.pixels[i])));
+        }
+
+        return result;
+    }
+
+    double milliseconds(const Graph& rGraph, const ImageView& rSource, const ImageView& rDestination, Threads::WorkStealingPool* pPool)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 3; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            rGraph.encode(rSource, rDestination, pPool);
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+
+    bool checkTiling(Threads::WorkStealingPool& rPool)
+    {
+        const uint32_t width  = 333;
+        const uint32_t height = 251;
+
+        Image source(width, height);
+        Image reference(width, height);
+        Image result(width, height);
+
+        randomize(source.view());
+
+        // Everything fused into one image-sized tile, and into tiny tiles whatever the halo costs
+        Config whole = defaults();
+
+        whole.maxFusedHalo = 100;
+        whole.cacheBytes   = size_t(1) << 30;
+        whole.passCost     = std::numeric_limits<float>::infinity();
+
+        Config tiny = whole;
+
+        tiny.cacheBytes  = 1;
+        tiny.minTileSize = 7;
+
+        chain(whole).encode(source.view(), reference.view());
+        chain(tiny).encode(source.view(), result.view(), &rPool);
+
+        int diff = difference(reference.view(), result.view());
+
+        std::printf("tiling: chain in %d and %d pixel tiles, max difference %d\n", chain(whole).tileSize(100), chain(tiny).tileSize(100), diff);
+
+        bool passed = (diff == 0);
+
+        // Every operator on its own
+        for(size_t i = 0; i < 9; ++i)
+        {
+            Graph single[2] = {Graph(whole), Graph(tiny)};
+
+            for(Graph& rGraph : single)
+            {
+                switch(i)
+                {
+                    case 0: rGraph.median(5); break;
+                    case 1: rGraph.convolution(3, 3, {-0.5f, -1.0f, -0.5f, -1.0f, 7.0f, -1.0f, -0.5f, -1.0f, -0.5f}); break;
+                    case 2: rGraph.thresholdBinary(0.5f, 1.0f); break;
+                    case 3: rGraph.gaussianBlur(5.0f); break;
+                    case 4: rGraph.dilate(15, 15, Presets::bokehProbe(7)); break;
+                    case 5: rGraph.areaMax(8, 9); break;
+                    case 6: rGraph.areaMin(9, 8); break;
+                    case 7: rGraph.sobel(); break;
+                    default: rGraph.laplacian(); break;
+                }
+            }
+
+            single[0].encode(source.view(), reference.view());
+            single[1].encode(source.view(), result.view(), &rPool);
+
+            diff = difference(reference.view(), result.view());
+
+            if(diff != 0)
+            {
+                std::printf("tiling: operator %zu differs by up to %d\n", i, diff);
+
+                passed = false;
+            }
+        }
+
+        // Separate passes round to 8 bits after every operator, fused operators don't
+        chain(unfused()).encode(source.view(), reference.view());
+        chain(defaults()).encode(source.view(), result.view(), &rPool);
+
+        std::printf("fusion: %zu passes instead of %zu, max difference %d from rounding between passes\n",
+                    chain(defaults()).passes(), chain(unfused()).passes(), difference(reference.view(), result.view()));
+
+        // Median against sorting the neighbourhood, for every generated network size
+        const ImageView src = source.view();
+        const ImageView dst = result.view();
+
+        size_t wrong = 0;
+        size_t count = 0;
+
+        for(int32_t diameter = 3; diameter <= 7; diameter += 2)
+        {
+            Graph().median(diameter).encode(source.view(), result.view(), &rPool);
+
+            const int32_t radius = diameter / 2;
+
+            for(int32_t y = radius; y < int32_t(height) - radius; ++y)
+            {
+                for(int32_t x = radius; x < int32_t(width) - radius; ++x)
+                {
+                    for(int32_t c = 0; c < 4; ++c)
+                    {
+                        uint8_t values[49];
+
+                        int32_t k = 0;
+
+                        for(int32_t j = -radius; j <= radius; ++j)
+                        {
+                            for(int32_t i = -radius; i <= radius; ++i, ++k)
+                            {
+                                values[k] = src.pixels[size_t(y + j) * src.rowBytes + size_t(x + i) * 4 + size_t(c)];
+                            }
+                        }
+
+                        std::nth_element(values, values + k / 2, values + k);
+
+                        wrong += (values[k / 2] != dst.pixels[size_t(y) * dst.rowBytes + size_t(x) * 4 + size_t(c)]) ? 1 : 0;
+                        count += 1;
+                    }
+                }
+            }
+        }
+
+        std::printf("median: %zu of %zu values of the 3x3, 5x5 and 7x7 medians differ from sorting\n", wrong, count);
+
+        return passed && (wrong == 0);
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    Threads::WorkStealingPool pool;
+
+    if(!checkTiling(pool))
+    {
+        return 1;
+    }
+
+    const uint32_t width  = (argc >= 3) ? uint32_t(std::atoi(argv[1])) : 7680;
+    const uint32_t height = (argc >= 3) ? uint32_t(std::atoi(argv[2])) : 4320;
+
+    Image source(width, height);
+    Image destination(width, height);
+
+    randomize(source.view());
+
+    struct Entry
+    {
+        const char* pName;
+        Graph     (*build)();
+    };
+
+    const Entry presets[] =
+    {
+        {"GaussianBlur",       &Presets::gaussianBlur},
+        {"Median",             &Presets::median},
+        {"Laplacian",          &Presets::laplacian},
+        {"Sobel",              &Presets::sobel},
+        {"ThresholdBinary",    &Presets::thresholdBinary},
+        {"ConvolutionEmboss",  &Presets::convolutionEmboss},
+        {"ConvolutionSharpen", &Presets::convolutionSharpen},
+        {"DilateBokeh",        &Presets::dilateBokeh},
+        {"MorphologyClosing",  &Presets::morphologyClosing},
+    };
+
+    std::printf("%ux%u, %zu threads\n", width, height, pool.concurrency());
+
+    for(const Entry& entry : presets)
+    {
+        const Graph graph = entry.build();
+
+        std::printf("%-20s %zu passes: %8.1f ms on one thread, %8.1f ms on the pool\n",
+                    entry.pName, graph.passes(),
+                    milliseconds(graph, source.view(), destination.view(), nullptr),
+                    milliseconds(graph, source.view(), destination.view(), &pool));
+    }
+
+    const Graph chains[][2] =
+    {
+        {cheapChain(unfused()), cheapChain(defaults())},
+        {chain(unfused()),      chain(defaults())},
+    };
+
+    const char* names[] = {"cheap chain", "chain"};
+
+    for(size_t i = 0; i < 2; ++i)
+    {
+        for(const Graph& rGraph : chains[i])
+        {
+            std::printf("%-14s %zu passes: %8.1f ms on one thread, %8.1f ms on the pool\n",
+                        names[i], rGraph.passes(),
+                        milliseconds(rGraph, source.view(), destination.view(), nullptr),
+                        milliseconds(rGraph, source.view(), destination.view(), &pool));
+        }
+    }
+
+    return 0;
+}
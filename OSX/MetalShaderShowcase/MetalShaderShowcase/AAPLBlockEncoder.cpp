@@ -0,0 +1,2556 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Block compression of RGBA8 images into BC1, BC3, BC7, ETC2 RGB8 and EAC RGBA8, with decoders for
+ measuring the error and cache files for the encoded blocks.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "AAPLBlockEncoder.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        // The pixels of a block one channel after another
+        struct Block
+        {
+            alignas(16) int16_t channel[4][16];
+        };
+
+        struct Palette
+        {
+            int16_t entry[16][4];
+            size_t  count;
+        };
+
+        static inline void load(const uint8_t* pPixels, Block& rBlock)
+        {
+            for(size_t i = 0; i < 16; ++i)
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    rBlock.channel[c][i] = int16_t(pPixels[4 * i + c]);
+                }
+            }
+        }
+
+        // Closest palette entry to each of the first count pixels (eight or sixteen) by squared
+        // distance over RGB, and alpha if alpha is true. Fills every pixel's index and error and
+        // returns the sum of the errors.
+        static uint32_t fit(const Block& block,
+                            const Palette& palette,
+                            const bool& alpha,
+                            const size_t& count,
+                            uint8_t* pIndices,
+                            uint32_t* pErrors)
+        {
+#if defined(__SSE2__)
+            // Eight pixels per pass: the channel differences are interleaved in pairs so that one
+            // multiply-add squares and sums two channels of four pixels
+            const __m128i zero = _mm_setzero_si128();
+
+            for(size_t h = 0; h < count; h += 8)
+            {
+                const __m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(block.channel[0] + h));
+                const __m128i g = _mm_load_si128(reinterpret_cast<const __m128i*>(block.channel[1] + h));
+                const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(block.channel[2] + h));
+                const __m128i a = alpha ? _mm_load_si128(reinterpret_cast<const __m128i*>(block.channel[3] + h)) : zero;
+
+                __m128i best[2]  = {_mm_set1_epi32(std::numeric_limits<int32_t>::max()), _mm_set1_epi32(std::numeric_limits<int32_t>::max())};
+                __m128i index[2] = {zero, zero};
+
+                for(size_t i = 0; i < palette.count; ++i)
+                {
+                    const int16_t* pEntry = palette.entry[i];
+
+                    const __m128i dr = _mm_sub_epi16(r, _mm_set1_epi16(pEntry[0]));
+                    const __m128i dg = _mm_sub_epi16(g, _mm_set1_epi16(pEntry[1]));
+                    const __m128i db = _mm_sub_epi16(b, _mm_set1_epi16(pEntry[2]));
+                    const __m128i da = alpha ? _mm_sub_epi16(a, _mm_set1_epi16(pEntry[3])) : zero;
+
+                    const __m128i rgLo = _mm_unpacklo_epi16(dr, dg);
+                    const __m128i baLo = _mm_unpacklo_epi16(db, da);
+                    const __m128i rgHi = _mm_unpackhi_epi16(dr, dg);
+                    const __m128i baHi = _mm_unpackhi_epi16(db, da);
+
+                    const __m128i distance[2] =
+                    {
+                        _mm_add_epi32(_mm_madd_epi16(rgLo, rgLo), _mm_madd_epi16(baLo, baLo)),
+                        _mm_add_epi32(_mm_madd_epi16(rgHi, rgHi), _mm_madd_epi16(baHi, baHi))
+                    };
+
+                    const __m128i n = _mm_set1_epi32(int32_t(i));
+
+                    for(size_t k = 0; k < 2; ++k)
+                    {
+                        const __m128i less = _mm_cmplt_epi32(distance[k], best[k]);
+
+                        best[k]  = _mm_or_si128(_mm_and_si128(less, distance[k]), _mm_andnot_si128(less, best[k]));
+                        index[k] = _mm_or_si128(_mm_and_si128(less, n), _mm_andnot_si128(less, index[k]));
+                    }
+                }
+
+                alignas(16) int32_t errors[8];
+                alignas(16) int32_t indices[8];
+
+                _mm_store_si128(reinterpret_cast<__m128i*>(errors),      best[0]);
+                _mm_store_si128(reinterpret_cast<__m128i*>(errors + 4),  best[1]);
+                _mm_store_si128(reinterpret_cast<__m128i*>(indices),     index[0]);
+                _mm_store_si128(reinterpret_cast<__m128i*>(indices + 4), index[1]);
+
+                for(size_t k = 0; k < 8; ++k)
+                {
+                    pErrors[h + k]  = uint32_t(errors[k]);
+                    pIndices[h + k] = uint8_t(indices[k]);
+                }
+            }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            const int16x8_t zero = vdupq_n_s16(0);
+
+            for(size_t h = 0; h < count; h += 8)
+            {
+                const int16x8_t r = vld1q_s16(block.channel[0] + h);
+                const int16x8_t g = vld1q_s16(block.channel[1] + h);
+                const int16x8_t b = vld1q_s16(block.channel[2] + h);
+                const int16x8_t a = alpha ? vld1q_s16(block.channel[3] + h) : zero;
+
+                int32x4_t  best[2]  = {vdupq_n_s32(std::numeric_limits<int32_t>::max()), vdupq_n_s32(std::numeric_limits<int32_t>::max())};
+                uint32x4_t index[2] = {vdupq_n_u32(0), vdupq_n_u32(0)};
+
+                for(size_t i = 0; i < palette.count; ++i)
+                {
+                    const int16_t* pEntry = palette.entry[i];
+
+                    const int16x8_t dr = vsubq_s16(r, vdupq_n_s16(pEntry[0]));
+                    const int16x8_t dg = vsubq_s16(g, vdupq_n_s16(pEntry[1]));
+                    const int16x8_t db = vsubq_s16(b, vdupq_n_s16(pEntry[2]));
+                    const int16x8_t da = alpha ? vsubq_s16(a, vdupq_n_s16(pEntry[3])) : zero;
+
+                    int32x4_t distance[2];
+
+                    distance[0] = vmull_s16(vget_low_s16(dr), vget_low_s16(dr));
+                    distance[0] = vmlal_s16(distance[0], vget_low_s16(dg), vget_low_s16(dg));
+                    distance[0] = vmlal_s16(distance[0], vget_low_s16(db), vget_low_s16(db));
+                    distance[0] = vmlal_s16(distance[0], vget_low_s16(da), vget_low_s16(da));
+
+                    distance[1] = vmull_s16(vget_high_s16(dr), vget_high_s16(dr));
+                    distance[1] = vmlal_s16(distance[1], vget_high_s16(dg), vget_high_s16(dg));
+                    distance[1] = vmlal_s16(distance[1], vget_high_s16(db), vget_high_s16(db));
+                    distance[1] = vmlal_s16(distance[1], vget_high_s16(da), vget_high_s16(da));
+
+                    const uint32x4_t n = vdupq_n_u32(uint32_t(i));
+
+                    for(size_t k = 0; k < 2; ++k)
+                    {
+                        const uint32x4_t less = vcltq_s32(distance[k], best[k]);
+
+                        best[k]  = vbslq_s32(less, distance[k], best[k]);
+                        index[k] = vbslq_u32(less, n, index[k]);
+                    }
+                }
+
+                int32_t  errors[8];
+                uint32_t indices[8];
+
+                vst1q_s32(errors,      best[0]);
+                vst1q_s32(errors + 4,  best[1]);
+                vst1q_u32(indices,     index[0]);
+                vst1q_u32(indices + 4, index[1]);
+
+                for(size_t k = 0; k < 8; ++k)
+                {
+                    pErrors[h + k]  = uint32_t(errors[k]);
+                    pIndices[h + k] = uint8_t(indices[k]);
+                }
+            }
+#else
+            const size_t channels = alpha ? 4 : 3;
+
+            for(size_t p = 0; p < count; ++p)
+            {
+                uint32_t best  = std::numeric_limits<uint32_t>::max();
+                uint8_t  index = 0;
+
+                for(size_t i = 0; i < palette.count; ++i)
+                {
+                    uint32_t distance = 0;
+
+                    for(size_t c = 0; c < channels; ++c)
+                    {
+                        const int32_t d = int32_t(block.channel[c][p]) - int32_t(palette.entry[i][c]);
+
+                        distance += uint32_t(d * d);
+                    }
+
+                    if(distance < best)
+                    {
+                        best  = distance;
+                        index = uint8_t(i);
+                    }
+                }
+
+                pErrors[p]  = best;
+                pIndices[p] = index;
+            }
+#endif
+
+            uint32_t total = 0;
+
+            for(size_t p = 0; p < count; ++p)
+            {
+                total += pErrors[p];
+            }
+
+            return total;
+        }
+    } // BlockEncoder
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Endpoints
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        static const uint16_t kAllPixels = 0xFFFF;
+
+        static inline bool contains(const uint16_t& mask, const size_t& pixel)
+        {
+            return ((mask >> pixel) & 1) != 0;
+        }
+
+        static inline int clamp(const int& value, const int& lower, const int& upper)
+        {
+            return std::min(std::max(value, lower), upper);
+        }
+
+        static inline uint32_t sum(const uint32_t* pErrors, const uint16_t& mask)
+        {
+            uint32_t total = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                total += contains(mask, p) ? pErrors[p] : 0;
+            }
+
+            return total;
+        }
+
+        // Mean and unit principal axis over the first channels (three or four) of the pixels in
+        // mask; a zero axis if they are all the same. Returns the squared distances of the pixels
+        // from the line through the mean along the axis.
+        static float principal(const Block& block,
+                               const uint16_t& mask,
+                               const size_t& channels,
+                               const size_t& iterations,
+                               float* pMean,
+                               float* pAxis)
+        {
+            float count = 0.0f;
+
+            for(size_t c = 0; c < 4; ++c)
+            {
+                pMean[c] = 0.0f;
+                pAxis[c] = 0.0f;
+            }
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                if(contains(mask, p))
+                {
+                    for(size_t c = 0; c < channels; ++c)
+                    {
+                        pMean[c] += float(block.channel[c][p]);
+                    }
+
+                    count += 1.0f;
+                }
+            }
+
+            if(count == 0.0f)
+            {
+                return 0.0f;
+            }
+
+            for(size_t c = 0; c < channels; ++c)
+            {
+                pMean[c] /= count;
+            }
+
+            float covariance[4][4] = {};
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                if(contains(mask, p))
+                {
+                    float d[4];
+
+                    for(size_t c = 0; c < channels; ++c)
+                    {
+                        d[c] = float(block.channel[c][p]) - pMean[c];
+                    }
+
+                    for(size_t i = 0; i < channels; ++i)
+                    {
+                        for(size_t j = i; j < channels; ++j)
+                        {
+                            covariance[i][j] += d[i] * d[j];
+                        }
+                    }
+                }
+            }
+
+            float  trace   = 0.0f;
+            size_t largest = 0;
+
+            for(size_t i = 0; i < channels; ++i)
+            {
+                for(size_t j = 0; j < i; ++j)
+                {
+                    covariance[i][j] = covariance[j][i];
+                }
+
+                trace  += covariance[i][i];
+                largest = (covariance[i][i] > covariance[largest][largest]) ? i : largest;
+            }
+
+            if(trace < 1.0e-3f)
+            {
+                return 0.0f;
+            }
+
+            // Power iteration from the channel that varies most
+            float axis[4] = {};
+
+            axis[largest] = 1.0f;
+
+            for(size_t k = 0; k < iterations; ++k)
+            {
+                float next[4]  = {};
+                float length   = 0.0f;
+
+                for(size_t i = 0; i < channels; ++i)
+                {
+                    for(size_t j = 0; j < channels; ++j)
+                    {
+                        next[i] += covariance[i][j] * axis[j];
+                    }
+
+                    length += next[i] * next[i];
+                }
+
+                if(length <= 0.0f)
+                {
+                    break;
+                }
+
+                length = 1.0f / std::sqrt(length);
+
+                for(size_t i = 0; i < channels; ++i)
+                {
+                    axis[i] = next[i] * length;
+                }
+            }
+
+            // Variance along the axis
+            float along = 0.0f;
+
+            for(size_t i = 0; i < channels; ++i)
+            {
+                float row = 0.0f;
+
+                for(size_t j = 0; j < channels; ++j)
+                {
+                    row += covariance[i][j] * axis[j];
+                }
+
+                along += axis[i] * row;
+
+                pAxis[i] = axis[i];
+            }
+
+            return std::max(trace - along, 0.0f);
+        }
+
+        // Endpoints where the pixels in mask project to the ends of the axis, moved inwards by
+        // inset times the distance between them
+        static void extremes(const Block& block,
+                             const uint16_t& mask,
+                             const size_t& channels,
+                             const float* pMean,
+                             const float* pAxis,
+                             const float& inset,
+                             float* pEndpoint0,
+                             float* pEndpoint1)
+        {
+            float lower = std::numeric_limits<float>::max();
+            float upper = -lower;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                if(contains(mask, p))
+                {
+                    float t = 0.0f;
+
+                    for(size_t c = 0; c < channels; ++c)
+                    {
+                        t += (float(block.channel[c][p]) - pMean[c]) * pAxis[c];
+                    }
+
+                    lower = std::min(lower, t);
+                    upper = std::max(upper, t);
+                }
+            }
+
+            if(lower > upper)
+            {
+                lower = upper = 0.0f;
+            }
+
+            const float shrink = (upper - lower) * inset;
+
+            lower += shrink;
+            upper -= shrink;
+
+            for(size_t c = 0; c < channels; ++c)
+            {
+                pEndpoint0[c] = std::min(std::max(pMean[c] + pAxis[c] * lower, 0.0f), 255.0f);
+                pEndpoint1[c] = std::min(std::max(pMean[c] + pAxis[c] * upper, 0.0f), 255.0f);
+            }
+        }
+
+        // Endpoints minimising the squared error of the pixels in mask for their indices, where
+        // index i blends weights[i] of the second endpoint into the first. False if the indices
+        // don't determine both endpoints.
+        static bool leastSquares(const Block& block,
+                                 const uint16_t& mask,
+                                 const size_t& channels,
+                                 const uint8_t* pIndices,
+                                 const float* pWeights,
+                                 float* pEndpoint0,
+                                 float* pEndpoint1)
+        {
+            float aa = 0.0f;
+            float ab = 0.0f;
+            float bb = 0.0f;
+
+            float ax[4] = {};
+            float bx[4] = {};
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                if(contains(mask, p))
+                {
+                    const float b = pWeights[pIndices[p]];
+                    const float a = 1.0f - b;
+
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+
+                    for(size_t c = 0; c < channels; ++c)
+                    {
+                        ax[c] += a * float(block.channel[c][p]);
+                        bx[c] += b * float(block.channel[c][p]);
+                    }
+                }
+            }
+
+            const float determinant = aa * bb - ab * ab;
+
+            if(std::fabs(determinant) < 1.0e-4f)
+            {
+                return false;
+            }
+
+            const float inverse = 1.0f / determinant;
+
+            for(size_t c = 0; c < channels; ++c)
+            {
+                pEndpoint0[c] = std::min(std::max((ax[c] * bb - bx[c] * ab) * inverse, 0.0f), 255.0f);
+                pEndpoint1[c] = std::min(std::max((bx[c] * aa - ax[c] * ab) * inverse, 0.0f), 255.0f);
+            }
+
+            return true;
+        }
+
+        // Little-endian bit stream, as BC7 blocks are laid out
+        class Bits
+        {
+        public:
+            explicit Bits(uint8_t* pBytes)
+            : mpBytes(pBytes), mnPosition(0)
+            {
+            }
+
+            void write(const uint32_t& value, const size_t& count)
+            {
+                for(size_t i = 0; i < count; ++i, ++mnPosition)
+                {
+                    mpBytes[mnPosition >> 3] |= uint8_t(((value >> i) & 1) << (mnPosition & 7));
+                }
+            }
+
+            uint32_t read(const size_t& count)
+            {
+                uint32_t value = 0;
+
+                for(size_t i = 0; i < count; ++i, ++mnPosition)
+                {
+                    value |= uint32_t((mpBytes[mnPosition >> 3] >> (mnPosition & 7)) & 1) << i;
+                }
+
+                return value;
+            }
+
+        private:
+            uint8_t* mpBytes;
+            size_t   mnPosition;
+        }; // Class Bits
+    } // BlockEncoder
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - BC1
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        // Weight of the second endpoint per index in four-colour mode
+        static const float kWeightsBC1[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+        static const int kBitsBC1[3] = {5, 6, 5};
+
+        static inline int expand(const int& value, const int& bits)
+        {
+            return (value << (8 - bits)) | (value >> (2 * bits - 8));
+        }
+
+        static inline uint16_t pack565(const int* pColor)
+        {
+            return uint16_t((pColor[0] << 11) | (pColor[1] << 5) | pColor[2]);
+        }
+
+        static inline void unpack565(const uint16_t& value, int* pColor)
+        {
+            pColor[0] = expand((value >> 11) & 31, 5);
+            pColor[1] = expand((value >> 5) & 63, 6);
+            pColor[2] = expand(value & 31, 5);
+        }
+
+        // Endpoint pairs whose two-thirds blend comes closest to each 8-bit value, for blocks of a
+        // single colour
+        struct SingleColor
+        {
+            SingleColor()
+            {
+                for(int bits = 5; bits <= 6; ++bits)
+                {
+                    const int levels = 1 << bits;
+
+                    for(int value = 0; value < 256; ++value)
+                    {
+                        int best = std::numeric_limits<int>::max();
+
+                        for(int e0 = 0; e0 < levels; ++e0)
+                        {
+                            for(int e1 = 0; e1 < levels; ++e1)
+                            {
+                                const int blend = (2 * expand(e0, bits) + expand(e1, bits)) / 3;
+                                const int error = std::abs(blend - value) * 256 + std::abs(e0 - e1);
+
+                                if(error < best)
+                                {
+                                    best = error;
+
+                                    endpoints[bits - 5][value][0] = uint8_t(e0);
+                                    endpoints[bits - 5][value][1] = uint8_t(e1);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            uint8_t endpoints[2][256][2];
+        };
+
+        static const SingleColor& singleColor()
+        {
+            static const SingleColor table;
+
+            return table;
+        }
+
+        static void paletteBC1(const uint16_t& c0, const uint16_t& c1, Palette& rPalette)
+        {
+            int e0[3];
+            int e1[3];
+
+            unpack565(c0, e0);
+            unpack565(c1, e1);
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                rPalette.entry[0][c] = int16_t(e0[c]);
+                rPalette.entry[1][c] = int16_t(e1[c]);
+                rPalette.entry[2][c] = int16_t((2 * e0[c] + e1[c]) / 3);
+                rPalette.entry[3][c] = int16_t((e0[c] + 2 * e1[c]) / 3);
+            }
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                rPalette.entry[i][3] = 255;
+            }
+
+            rPalette.count = 4;
+        }
+
+        static inline void quantize565(const float* pEndpoint, int* pQuantized)
+        {
+            for(size_t c = 0; c < 3; ++c)
+            {
+                const int levels = (1 << kBitsBC1[c]) - 1;
+
+                pQuantized[c] = clamp(int(pEndpoint[c] * float(levels) / 255.0f + 0.5f), 0, levels);
+            }
+        }
+
+        static uint32_t evaluateBC1(const Block& block, const int (&quantized)[2][3], uint8_t* pIndices)
+        {
+            Palette  palette;
+            uint32_t errors[16];
+
+            paletteBC1(pack565(quantized[0]), pack565(quantized[1]), palette);
+
+            return fit(block, palette, false, 16, pIndices, errors);
+        }
+
+        // Four-colour BC1 block of the RGB channels; returns the squared error
+        static uint32_t encodeColor(const Block& block, const Quality& quality, uint8_t* pOut)
+        {
+            int     quantized[2][3];
+            uint8_t indices[16];
+
+            bool uniform = true;
+
+            for(size_t p = 1; (p < 16) && uniform; ++p)
+            {
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    uniform = uniform && (block.channel[c][p] == block.channel[c][0]);
+                }
+            }
+
+            if(uniform)
+            {
+                const SingleColor& table = singleColor();
+
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    for(size_t e = 0; e < 2; ++e)
+                    {
+                        quantized[e][c] = table.endpoints[kBitsBC1[c] - 5][block.channel[c][0]][e];
+                    }
+                }
+            }
+            else
+            {
+                float mean[4];
+                float axis[4];
+                float endpoints[2][4];
+
+                principal(block, kAllPixels, 3, 8, mean, axis);
+
+                extremes(block, kAllPixels, 3, mean, axis, 1.0f / 16.0f, endpoints[0], endpoints[1]);
+
+                quantize565(endpoints[0], quantized[0]);
+                quantize565(endpoints[1], quantized[1]);
+            }
+
+            uint32_t error = evaluateBC1(block, quantized, indices);
+
+            const size_t refinements = (quality == eQualityFast) ? 0 : ((quality == eQualityNormal) ? 2 : 4);
+
+            for(size_t k = 0; (k < refinements) && (error > 0); ++k)
+            {
+                float endpoints[2][4];
+
+                if(!leastSquares(block, kAllPixels, 3, indices, kWeightsBC1, endpoints[0], endpoints[1]))
+                {
+                    break;
+                }
+
+                int     candidate[2][3];
+                uint8_t candidateIndices[16];
+
+                quantize565(endpoints[0], candidate[0]);
+                quantize565(endpoints[1], candidate[1]);
+
+                const uint32_t candidateError = evaluateBC1(block, candidate, candidateIndices);
+
+                if(candidateError >= error)
+                {
+                    break;
+                }
+
+                error = candidateError;
+
+                std::memcpy(quantized, candidate, sizeof(quantized));
+                std::memcpy(indices, candidateIndices, sizeof(indices));
+            }
+
+            // One step of every quantised endpoint channel at a time, while any of them helps
+            if(quality == eQualityHigh)
+            {
+                for(bool improved = true; improved && (error > 0);)
+                {
+                    improved = false;
+
+                    for(size_t e = 0; e < 2; ++e)
+                    {
+                        for(size_t c = 0; c < 3; ++c)
+                        {
+                            for(int step = -1; step <= 1; step += 2)
+                            {
+                                const int value = quantized[e][c] + step;
+
+                                if((value < 0) || (value >= (1 << kBitsBC1[c])))
+                                {
+                                    continue;
+                                }
+
+                                int     candidate[2][3];
+                                uint8_t candidateIndices[16];
+
+                                std::memcpy(candidate, quantized, sizeof(candidate));
+
+                                candidate[e][c] = value;
+
+                                const uint32_t candidateError = evaluateBC1(block, candidate, candidateIndices);
+
+                                if(candidateError < error)
+                                {
+                                    error    = candidateError;
+                                    improved = true;
+
+                                    std::memcpy(quantized, candidate, sizeof(quantized));
+                                    std::memcpy(indices, candidateIndices, sizeof(indices));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            uint16_t c0 = pack565(quantized[0]);
+            uint16_t c1 = pack565(quantized[1]);
+
+            // Four-colour mode needs c0 > c1: swapping the endpoints swaps the indices pairwise
+            if(c0 < c1)
+            {
+                std::swap(c0, c1);
+
+                for(size_t p = 0; p < 16; ++p)
+                {
+                    indices[p] ^= 1;
+                }
+            }
+            else if(c0 == c1)
+            {
+                std::memset(indices, 0, sizeof(indices));
+            }
+
+            uint32_t bits = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                bits |= uint32_t(indices[p]) << (2 * p);
+            }
+
+            pOut[0] = uint8_t(c0);
+            pOut[1] = uint8_t(c0 >> 8);
+            pOut[2] = uint8_t(c1);
+            pOut[3] = uint8_t(c1 >> 8);
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                pOut[4 + i] = uint8_t(bits >> (8 * i));
+            }
+
+            return error;
+        }
+
+        static void decodeColor(const uint8_t* pIn, const bool& threeColor, uint8_t* pPixels)
+        {
+            const uint16_t c0 = uint16_t(pIn[0] | (pIn[1] << 8));
+            const uint16_t c1 = uint16_t(pIn[2] | (pIn[3] << 8));
+
+            int colors[4][4];
+
+            unpack565(c0, colors[0]);
+            unpack565(c1, colors[1]);
+
+            colors[0][3] = colors[1][3] = colors[2][3] = colors[3][3] = 255;
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                if(!threeColor || (c0 > c1))
+                {
+                    colors[2][c] = (2 * colors[0][c] + colors[1][c]) / 3;
+                    colors[3][c] = (colors[0][c] + 2 * colors[1][c]) / 3;
+                }
+                else
+                {
+                    colors[2][c] = (colors[0][c] + colors[1][c]) / 2;
+                    colors[3][c] = 0;
+                }
+            }
+
+            if(threeColor && (c0 <= c1))
+            {
+                colors[3][3] = 0;
+            }
+
+            const uint32_t bits = uint32_t(pIn[4]) | (uint32_t(pIn[5]) << 8) | (uint32_t(pIn[6]) << 16) | (uint32_t(pIn[7]) << 24);
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const int* pColor = colors[(bits >> (2 * p)) & 3];
+
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    pPixels[4 * p + c] = uint8_t(pColor[c]);
+                }
+            }
+        }
+    } // BlockEncoder
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - BC3 Alpha
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        // Eight values if a0 > a1, otherwise six and then 0 and 255
+        static void paletteAlpha(const int& a0, const int& a1, int* pValues)
+        {
+            pValues[0] = a0;
+            pValues[1] = a1;
+
+            if(a0 > a1)
+            {
+                for(int i = 2; i < 8; ++i)
+                {
+                    pValues[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+                }
+            }
+            else
+            {
+                for(int i = 2; i < 6; ++i)
+                {
+                    pValues[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+                }
+
+                pValues[6] = 0;
+                pValues[7] = 255;
+            }
+        }
+
+        // A block of the alpha channel alone, in the place of red, for fitting alpha palettes
+        static void alphaBlock(const Block& block, Block& rAlpha)
+        {
+            std::memset(&rAlpha, 0, sizeof(rAlpha));
+            std::memcpy(rAlpha.channel[0], block.channel[3], sizeof(rAlpha.channel[0]));
+        }
+
+        static uint32_t fitAlpha(const Block& alpha, const int* pValues, uint8_t* pIndices)
+        {
+            Palette  palette;
+            uint32_t errors[16];
+
+            std::memset(&palette, 0, sizeof(palette));
+
+            for(size_t i = 0; i < 8; ++i)
+            {
+                palette.entry[i][0] = int16_t(pValues[i]);
+            }
+
+            palette.count = 8;
+
+            return fit(alpha, palette, false, 16, pIndices, errors);
+        }
+
+        static uint32_t fitAlpha(const Block& alpha, const int& a0, const int& a1, uint8_t* pIndices)
+        {
+            int values[8];
+
+            paletteAlpha(a0, a1, values);
+
+            return fitAlpha(alpha, values, pIndices);
+        }
+
+        static void encodeAlpha(const Block& block, const Quality& quality, uint8_t* pOut)
+        {
+            int lower = 255;
+            int upper = 0;
+
+            // Range of the values other than 0 and 255, which six-value blocks have for free
+            int innerLower = 255;
+            int innerUpper = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const int a = block.channel[3][p];
+
+                lower = std::min(lower, a);
+                upper = std::max(upper, a);
+
+                if((a != 0) && (a != 255))
+                {
+                    innerLower = std::min(innerLower, a);
+                    innerUpper = std::max(innerUpper, a);
+                }
+            }
+
+            Block alpha;
+
+            alphaBlock(block, alpha);
+
+            int     a0 = upper;
+            int     a1 = lower;
+            uint8_t indices[16];
+
+            uint32_t error = fitAlpha(alpha, a0, a1, indices);
+
+            auto consider = [&](const int& c0, const int& c1)
+            {
+                uint8_t candidate[16];
+
+                const uint32_t candidateError = fitAlpha(alpha, c0, c1, candidate);
+
+                if(candidateError < error)
+                {
+                    error = candidateError;
+                    a0    = c0;
+                    a1    = c1;
+
+                    std::memcpy(indices, candidate, sizeof(indices));
+                }
+            };
+
+            if((quality != eQualityFast) && (error > 0))
+            {
+                if(innerLower > innerUpper)
+                {
+                    innerLower = innerUpper = 0;
+                }
+
+                consider(innerLower, innerUpper);
+            }
+
+            // Endpoints moved inwards, where the extremes are outliers
+            if((quality == eQualityHigh) && (error > 0))
+            {
+                for(int d0 = 0; d0 <= 4; ++d0)
+                {
+                    for(int d1 = 0; d1 <= 4; ++d1)
+                    {
+                        if((upper - d0) > (lower + d1))
+                        {
+                            consider(upper - d0, lower + d1);
+                        }
+                    }
+                }
+            }
+
+            uint64_t bits = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                bits |= uint64_t(indices[p]) << (3 * p);
+            }
+
+            pOut[0] = uint8_t(a0);
+            pOut[1] = uint8_t(a1);
+
+            for(size_t i = 0; i < 6; ++i)
+            {
+                pOut[2 + i] = uint8_t(bits >> (8 * i));
+            }
+        }
+
+        static void decodeAlpha(const uint8_t* pIn, uint8_t* pPixels)
+        {
+            int values[8];
+
+            paletteAlpha(pIn[0], pIn[1], values);
+
+            uint64_t bits = 0;
+
+            for(size_t i = 0; i < 6; ++i)
+            {
+                bits |= uint64_t(pIn[2 + i]) << (8 * i);
+            }
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                pPixels[4 * p + 3] = uint8_t(values[(bits >> (3 * p)) & 7]);
+            }
+        }
+    } // BlockEncoder
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - BC7
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        static const int kWeights3[8]  = {0, 9, 18, 27, 37, 46, 55, 64};
+        static const int kWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        // Pixels of the second subset of each two-subset partition
+        static const uint16_t kPartitions[64] =
+        {
+            0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+            0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+            0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+            0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+            0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+            0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+            0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+            0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+        };
+
+        // Pixel of the second subset whose index leaves out its top bit
+        static const uint8_t kAnchors[64] =
+        {
+            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+            15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+            15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+             6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+        };
+
+        // Mode 1 partitions tried per quality
+        static const size_t kPartitionCandidates[3] = {0, 2, 16};
+
+        static inline int blend(const int& e0, const int& e1, const int& weight)
+        {
+            return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+        }
+
+        // Mode 6: one subset, RGBA endpoints of seven bits and a p-bit each, four-bit indices
+        struct Mode6
+        {
+            int      endpoints[2][4];   // Seven bits
+            int      pbits[2];
+            uint8_t  indices[16];
+            uint32_t error;
+        };
+
+        static inline void expandMode6(const Mode6& mode, int (&values)[2][4])
+        {
+            for(size_t e = 0; e < 2; ++e)
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    values[e][c] = (mode.endpoints[e][c] << 1) | mode.pbits[e];
+                }
+            }
+        }
+
+        static void evaluateMode6(const Block& block, Mode6& rMode)
+        {
+            int values[2][4];
+
+            expandMode6(rMode, values);
+
+            Palette  palette;
+            uint32_t errors[16];
+
+            for(size_t i = 0; i < 16; ++i)
+            {
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    palette.entry[i][c] = int16_t(blend(values[0][c], values[1][c], kWeights4[i]));
+                }
+            }
+
+            palette.count = 16;
+
+            rMode.error = fit(block, palette, true, 16, rMode.indices, errors);
+        }
+
+        // Seven bits and the p-bit that together come closest to the endpoint
+        static inline void quantizeMode6(const float* pEndpoint, const int& pbit, int* pQuantized)
+        {
+            for(size_t c = 0; c < 4; ++c)
+            {
+                pQuantized[c] = clamp(int((pEndpoint[c] - float(pbit)) / 2.0f + 0.5f), 0, 127);
+            }
+        }
+
+        static float quantizationError(const float* pEndpoint, const int* pQuantized, const int& pbit)
+        {
+            float error = 0.0f;
+
+            for(size_t c = 0; c < 4; ++c)
+            {
+                const float d = float((pQuantized[c] << 1) | pbit) - pEndpoint[c];
+
+                error += d * d;
+            }
+
+            return error;
+        }
+
+        static void encodeMode6(const Block& block,
+                                const Quality& quality,
+                                const float (&endpoints)[2][4],
+                                Mode6& rBest)
+        {
+            Mode6 mode;
+
+            if(quality == eQualityHigh)
+            {
+                // Every combination of p-bits
+                for(int pbits = 0; pbits < 4; ++pbits)
+                {
+                    for(size_t e = 0; e < 2; ++e)
+                    {
+                        mode.pbits[e] = (pbits >> e) & 1;
+
+                        quantizeMode6(endpoints[e], mode.pbits[e], mode.endpoints[e]);
+                    }
+
+                    evaluateMode6(block, mode);
+
+                    if(mode.error < rBest.error)
+                    {
+                        rBest = mode;
+                    }
+                }
+            }
+            else
+            {
+                for(size_t e = 0; e < 2; ++e)
+                {
+                    int candidates[2][4];
+
+                    quantizeMode6(endpoints[e], 0, candidates[0]);
+                    quantizeMode6(endpoints[e], 1, candidates[1]);
+
+                    mode.pbits[e] = (quantizationError(endpoints[e], candidates[1], 1) < quantizationError(endpoints[e], candidates[0], 0)) ? 1 : 0;
+
+                    std::memcpy(mode.endpoints[e], candidates[mode.pbits[e]], sizeof(mode.endpoints[e]));
+                }
+
+                evaluateMode6(block, mode);
+
+                if(mode.error < rBest.error)
+                {
+                    rBest = mode;
+                }
+            }
+        }
+
+        static Mode6 mode6(const Block& block, const Quality& quality)
+        {
+            Mode6 best;
+
+            best.error = std::numeric_limits<uint32_t>::max();
+
+            float mean[4];
+            float axis[4];
+            float endpoints[2][4];
+
+            principal(block, kAllPixels, 4, 8, mean, axis);
+
+            extremes(block, kAllPixels, 4, mean, axis, 0.0f, endpoints[0], endpoints[1]);
+
+            encodeMode6(block, quality, endpoints, best);
+
+            float weights[16];
+
+            for(size_t i = 0; i < 16; ++i)
+            {
+                weights[i] = float(kWeights4[i]) / 64.0f;
+            }
+
+            const size_t refinements = (quality == eQualityFast) ? 1 : ((quality == eQualityNormal) ? 2 : 3);
+
+            for(size_t k = 0; (k < refinements) && (best.error > 0); ++k)
+            {
+                const uint32_t previous = best.error;
+
+                if(!leastSquares(block, kAllPixels, 4, best.indices, weights, endpoints[0], endpoints[1]))
+                {
+                    break;
+                }
+
+                encodeMode6(block, quality, endpoints, best);
+
+                if(best.error >= previous)
+                {
+                    break;
+                }
+            }
+
+            return best;
+        }
+
+        // Mode 1: two subsets, RGB endpoints of six bits, a p-bit shared per subset, three-bit indices
+        struct Mode1
+        {
+            size_t   partition;
+            int      endpoints[2][2][3];    // Subset, endpoint, six bits
+            int      pbits[2];
+            uint8_t  indices[16];
+            uint32_t error;
+        };
+
+        static inline int expandMode1(const int& value, const int& pbit)
+        {
+            const int seven = (value << 1) | pbit;
+
+            return (seven << 1) | (seven >> 6);
+        }
+
+        // Endpoints and shared p-bit of one subset, and its pixels' indices and error
+        static uint32_t evaluateSubset(const Block& block,
+                                       const uint16_t& mask,
+                                       const float (&endpoints)[2][4],
+                                       int (&quantized)[2][3],
+                                       int& rPbit,
+                                       uint8_t* pIndices)
+        {
+            float best = std::numeric_limits<float>::max();
+
+            for(int pbit = 0; pbit < 2; ++pbit)
+            {
+                int   candidate[2][3];
+                float error = 0.0f;
+
+                for(size_t e = 0; e < 2; ++e)
+                {
+                    for(size_t c = 0; c < 3; ++c)
+                    {
+                        candidate[e][c] = clamp(int((endpoints[e][c] - float(2 * pbit)) / 4.0f + 0.5f), 0, 63);
+
+                        const float d = float(expandMode1(candidate[e][c], pbit)) - endpoints[e][c];
+
+                        error += d * d;
+                    }
+                }
+
+                if(error < best)
+                {
+                    best  = error;
+                    rPbit = pbit;
+
+                    std::memcpy(quantized, candidate, sizeof(candidate));
+                }
+            }
+
+            Palette  palette;
+            uint32_t errors[16];
+            uint8_t  indices[16];
+
+            for(size_t i = 0; i < 8; ++i)
+            {
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    palette.entry[i][c] = int16_t(blend(expandMode1(quantized[0][c], rPbit), expandMode1(quantized[1][c], rPbit), kWeights3[i]));
+                }
+
+                palette.entry[i][3] = 255;
+            }
+
+            palette.count = 8;
+
+            fit(block, palette, false, 16, indices, errors);
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                if(contains(mask, p))
+                {
+                    pIndices[p] = indices[p];
+                }
+            }
+
+            return sum(errors, mask);
+        }
+
+        // Sums over a subset's pixels of 1, r, g, b and the products rr, rg, rb, gg, gb and bb
+        struct Moments
+        {
+            int32_t values[10];
+        };
+
+        static void moments(const Block& block, const uint16_t& mask, Moments& rMoments)
+        {
+            std::memset(&rMoments, 0, sizeof(rMoments));
+
+            for(uint32_t bits = mask; bits != 0; bits &= bits - 1)
+            {
+                const size_t p = size_t(__builtin_ctz(bits));
+
+                const int32_t r = block.channel[0][p];
+                const int32_t g = block.channel[1][p];
+                const int32_t b = block.channel[2][p];
+
+                rMoments.values[0] += 1;
+                rMoments.values[1] += r;
+                rMoments.values[2] += g;
+                rMoments.values[3] += b;
+                rMoments.values[4] += r * r;
+                rMoments.values[5] += r * g;
+                rMoments.values[6] += r * b;
+                rMoments.values[7] += g * g;
+                rMoments.values[8] += g * b;
+                rMoments.values[9] += b * b;
+            }
+        }
+
+        // Estimate of the squared distances of the pixels from their principal line, for ranking
+        // partitions: the largest eigenvalue comes from the Rayleigh quotient after two steps of
+        // power iteration from the axis of the channel that varies most
+        static float lineError(const Moments& moments)
+        {
+            const int32_t* pValues = moments.values;
+
+            if(pValues[0] == 0)
+            {
+                return 0.0f;
+            }
+
+            const float inverse = 1.0f / float(pValues[0]);
+
+            const float r = float(pValues[1]);
+            const float g = float(pValues[2]);
+            const float b = float(pValues[3]);
+
+            const float covariance[3][3] =
+            {
+                {float(pValues[4]) - r * r * inverse, float(pValues[5]) - r * g * inverse, float(pValues[6]) - r * b * inverse},
+                {float(pValues[5]) - r * g * inverse, float(pValues[7]) - g * g * inverse, float(pValues[8]) - g * b * inverse},
+                {float(pValues[6]) - r * b * inverse, float(pValues[8]) - g * b * inverse, float(pValues[9]) - b * b * inverse}
+            };
+
+            const float trace = covariance[0][0] + covariance[1][1] + covariance[2][2];
+
+            size_t largest = (covariance[1][1] > covariance[0][0]) ? 1 : 0;
+
+            largest = (covariance[2][2] > covariance[largest][largest]) ? 2 : largest;
+
+            // One step is the covariance row itself
+            const float* pAxis = covariance[largest];
+
+            const float length = pAxis[0] * pAxis[0] + pAxis[1] * pAxis[1] + pAxis[2] * pAxis[2];
+
+            if(length < 1.0e-6f)
+            {
+                return 0.0f;
+            }
+
+            float along = 0.0f;
+
+            for(size_t i = 0; i < 3; ++i)
+            {
+                along += pAxis[i] * (covariance[i][0] * pAxis[0] + covariance[i][1] * pAxis[1] + covariance[i][2] * pAxis[2]);
+            }
+
+            return std::max(trace - along / length, 0.0f);
+        }
+
+        static Mode1 mode1(const Block& block, const Quality& quality)
+        {
+            Mode1 best;
+
+            best.error = std::numeric_limits<uint32_t>::max();
+
+            // Partitions ranked by how far their subsets' pixels are from a line; the first
+            // subset's moments are the block's less the second's
+            Moments all;
+
+            moments(block, kAllPixels, all);
+
+            std::pair<float, size_t> ranks[64];
+
+            for(size_t partition = 0; partition < 64; ++partition)
+            {
+                Moments second;
+                Moments first;
+
+                moments(block, kPartitions[partition], second);
+
+                for(size_t i = 0; i < 10; ++i)
+                {
+                    first.values[i] = all.values[i] - second.values[i];
+                }
+
+                ranks[partition].first  = lineError(first) + lineError(second);
+                ranks[partition].second = partition;
+            }
+
+            const size_t candidates = kPartitionCandidates[quality];
+
+            std::partial_sort(ranks, ranks + candidates, ranks + 64);
+
+            float weights[8];
+
+            for(size_t i = 0; i < 8; ++i)
+            {
+                weights[i] = float(kWeights3[i]) / 64.0f;
+            }
+
+            const size_t refinements = (quality == eQualityNormal) ? 1 : 2;
+
+            for(size_t k = 0; k < candidates; ++k)
+            {
+                Mode1 mode;
+
+                mode.partition = ranks[k].second;
+                mode.error     = 0;
+
+                for(size_t s = 0; s < 2; ++s)
+                {
+                    const uint16_t mask = (s == 0) ? uint16_t(~kPartitions[mode.partition]) : kPartitions[mode.partition];
+
+                    float mean[4];
+                    float axis[4];
+                    float endpoints[2][4];
+
+                    principal(block, mask, 3, 8, mean, axis);
+
+                    extremes(block, mask, 3, mean, axis, 0.0f, endpoints[0], endpoints[1]);
+
+                    uint32_t error = evaluateSubset(block, mask, endpoints, mode.endpoints[s], mode.pbits[s], mode.indices);
+
+                    for(size_t r = 0; (r < refinements) && (error > 0); ++r)
+                    {
+                        if(!leastSquares(block, mask, 3, mode.indices, weights, endpoints[0], endpoints[1]))
+                        {
+                            break;
+                        }
+
+                        int     quantized[2][3];
+                        int     pbit = 0;
+                        uint8_t indices[16];
+
+                        const uint32_t candidateError = evaluateSubset(block, mask, endpoints, quantized, pbit, indices);
+
+                        if(candidateError >= error)
+                        {
+                            break;
+                        }
+
+                        error = candidateError;
+
+                        std::memcpy(mode.endpoints[s], quantized, sizeof(quantized));
+
+                        mode.pbits[s] = pbit;
+
+                        for(size_t p = 0; p < 16; ++p)
+                        {
+                            mode.indices[p] = contains(mask, p) ? indices[p] : mode.indices[p];
+                        }
+                    }
+
+                    mode.error += error;
+                }
+
+                if(mode.error < best.error)
+                {
+                    best = mode;
+                }
+            }
+
+            return best;
+        }
+
+        static void writeMode6(Mode6& rMode, uint8_t* pOut)
+        {
+            // The first pixel's index leaves out its top bit
+            if(rMode.indices[0] & 8)
+            {
+                std::swap(rMode.endpoints[0], rMode.endpoints[1]);
+                std::swap(rMode.pbits[0], rMode.pbits[1]);
+
+                for(size_t p = 0; p < 16; ++p)
+                {
+                    rMode.indices[p] = uint8_t(15 - rMode.indices[p]);
+                }
+            }
+
+            Bits bits(pOut);
+
+            bits.write(1 << 6, 7);
+
+            for(size_t c = 0; c < 4; ++c)
+            {
+                bits.write(uint32_t(rMode.endpoints[0][c]), 7);
+                bits.write(uint32_t(rMode.endpoints[1][c]), 7);
+            }
+
+            bits.write(uint32_t(rMode.pbits[0]), 1);
+            bits.write(uint32_t(rMode.pbits[1]), 1);
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                bits.write(rMode.indices[p], (p == 0) ? 3 : 4);
+            }
+        }
+
+        static void writeMode1(Mode1& rMode, uint8_t* pOut)
+        {
+            const uint16_t mask   = kPartitions[rMode.partition];
+            const size_t   anchor = kAnchors[rMode.partition];
+
+            // The anchor pixels of both subsets leave out the top bit of their indices
+            for(size_t s = 0; s < 2; ++s)
+            {
+                if(rMode.indices[(s == 0) ? 0 : anchor] & 4)
+                {
+                    std::swap(rMode.endpoints[s][0], rMode.endpoints[s][1]);
+
+                    for(size_t p = 0; p < 16; ++p)
+                    {
+                        if(contains(mask, p) == (s == 1))
+                        {
+                            rMode.indices[p] = uint8_t(7 - rMode.indices[p]);
+                        }
+                    }
+                }
+            }
+
+            Bits bits(pOut);
+
+            bits.write(1 << 1, 2);
+            bits.write(uint32_t(rMode.partition), 6);
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                for(size_t s = 0; s < 2; ++s)
+                {
+                    bits.write(uint32_t(rMode.endpoints[s][0][c]), 6);
+                    bits.write(uint32_t(rMode.endpoints[s][1][c]), 6);
+                }
+            }
+
+            bits.write(uint32_t(rMode.pbits[0]), 1);
+            bits.write(uint32_t(rMode.pbits[1]), 1);
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                bits.write(rMode.indices[p], ((p == 0) || (p == anchor)) ? 2 : 3);
+            }
+        }
+
+        static void encodeBC7(const Block& block, const Quality& quality, uint8_t* pOut)
+        {
+            std::memset(pOut, 0, 16);
+
+            Mode6 best6 = mode6(block, quality);
+
+            bool opaque = true;
+
+            for(size_t p = 0; (p < 16) && opaque; ++p)
+            {
+                opaque = (block.channel[3][p] == 255);
+            }
+
+            // Mode 1 has no alpha
+            if(opaque && (quality != eQualityFast) && (best6.error > 0))
+            {
+                Mode1 best1 = mode1(block, quality);
+
+                if(best1.error < best6.error)
+                {
+                    writeMode1(best1, pOut);
+
+                    return;
+                }
+            }
+
+            writeMode6(best6, pOut);
+        }
+
+        static bool decodeBC7(const uint8_t* pIn, uint8_t* pPixels)
+        {
+            Bits bits(const_cast<uint8_t*>(pIn));
+
+            size_t mode = 0;
+
+            while((mode < 8) && (bits.read(1) == 0))
+            {
+                ++mode;
+            }
+
+            if(mode == 6)
+            {
+                int values[2][4];
+
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    values[0][c] = int(bits.read(7)) << 1;
+                    values[1][c] = int(bits.read(7)) << 1;
+                }
+
+                for(size_t e = 0; e < 2; ++e)
+                {
+                    const int pbit = int(bits.read(1));
+
+                    for(size_t c = 0; c < 4; ++c)
+                    {
+                        values[e][c] |= pbit;
+                    }
+                }
+
+                for(size_t p = 0; p < 16; ++p)
+                {
+                    const int weight = kWeights4[bits.read((p == 0) ? 3 : 4)];
+
+                    for(size_t c = 0; c < 4; ++c)
+                    {
+                        pPixels[4 * p + c] = uint8_t(blend(values[0][c], values[1][c], weight));
+                    }
+                }
+
+                return true;
+            }
+
+            if(mode == 1)
+            {
+                const size_t partition = bits.read(6);
+
+                int quantized[2][2][3];
+                int values[2][2][3];
+
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    for(size_t s = 0; s < 2; ++s)
+                    {
+                        quantized[s][0][c] = int(bits.read(6));
+                        quantized[s][1][c] = int(bits.read(6));
+                    }
+                }
+
+                for(size_t s = 0; s < 2; ++s)
+                {
+                    const int pbit = int(bits.read(1));
+
+                    for(size_t e = 0; e < 2; ++e)
+                    {
+                        for(size_t c = 0; c < 3; ++c)
+                        {
+                            values[s][e][c] = expandMode1(quantized[s][e][c], pbit);
+                        }
+                    }
+                }
+
+                for(size_t p = 0; p < 16; ++p)
+                {
+                    const size_t s      = contains(kPartitions[partition], p) ? 1 : 0;
+                    const int    weight = kWeights3[bits.read(((p == 0) || (p == kAnchors[partition])) ? 2 : 3)];
+
+                    for(size_t c = 0; c < 3; ++c)
+                    {
+                        pPixels[4 * p + c] = uint8_t(blend(values[s][0][c], values[s][1][c], weight));
+                    }
+
+                    pPixels[4 * p + 3] = 255;
+                }
+
+                return true;
+            }
+
+            std::memset(pPixels, 0, 64);
+
+            return false;
+        }
+    } // BlockEncoder
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - ETC2
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        // Small and large modifier of each table; indices 0 to 3 stand for +small, +large,
+        // -small and -large
+        static const int kModifiers[8][2] =
+        {
+            {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+        };
+
+        static const int kAlphaModifiers[16][8] =
+        {
+            {-3, -6,  -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5,  -8, -13, 1, 4, 7, 12},
+            {-2, -4,  -6, -13, 1, 3, 5, 12},
+            {-3, -6,  -8, -12, 2, 5, 7, 11},
+            {-3, -7,  -9, -11, 2, 6, 8, 10},
+            {-4, -7,  -8, -11, 3, 6, 7, 10},
+            {-3, -5,  -8, -11, 2, 4, 7, 10},
+            {-2, -6,  -8, -10, 1, 5, 7,  9},
+            {-2, -5,  -8, -10, 1, 4, 7,  9},
+            {-2, -4,  -8, -10, 1, 3, 7,  9},
+            {-2, -5,  -7, -10, 1, 4, 6,  9},
+            {-3, -4,  -7, -10, 2, 3, 6,  9},
+            {-1, -2,  -3, -10, 0, 1, 2,  9},
+            {-4, -6,  -8,  -9, 3, 5, 7,  8},
+            {-3, -5,  -7,  -9, 2, 4, 6,  8}
+        };
+
+        // Table whose fifth modifier is zero, for blocks of a single alpha
+        static const int kAlphaExact = 13;
+
+        // Sub-blocks of the two flip settings: left and right halves, then top and bottom halves
+        static const uint16_t kSubBlocks[2][2] =
+        {
+            {0x3333, 0xCCCC},
+            {0x00FF, 0xFF00}
+        };
+
+        // Steps of the quantised base colour tried around a sub-block's average
+        static const int kShifts = 1;
+
+        struct SubBlock
+        {
+            int      quantized[3];
+            int      table;
+            uint8_t  indices[8];
+            uint32_t error;
+        };
+
+        struct Candidate
+        {
+            bool     differential;
+            int      flip;
+            SubBlock subBlocks[2];
+            uint32_t error;
+        };
+
+        static inline int expandETC(const int& value, const bool& differential)
+        {
+            return differential ? expand(value, 5) : (value * 17);
+        }
+
+        // The pixels of a sub-block, in order, as the first eight pixels of rPixels
+        static void gather(const Block& block, const uint16_t& mask, Block& rPixels)
+        {
+            size_t k = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                if(contains(mask, p))
+                {
+                    for(size_t c = 0; c < 4; ++c)
+                    {
+                        rPixels.channel[c][k] = block.channel[c][p];
+                    }
+
+                    ++k;
+                }
+            }
+        }
+
+        static void paletteETC(const int* pBase, const int& table, Palette& rPalette)
+        {
+            const int modifiers[4] = {kModifiers[table][0], kModifiers[table][1], -kModifiers[table][0], -kModifiers[table][1]};
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    rPalette.entry[i][c] = int16_t(clamp(pBase[c] + modifiers[i], 0, 255));
+                }
+
+                rPalette.entry[i][3] = 255;
+            }
+
+            rPalette.count = 4;
+        }
+
+        // Best of the tables first to last for a sub-block's base colour
+        static void fitSubBlock(const Block& pixels,
+                                const bool& differential,
+                                const int& first,
+                                const int& last,
+                                SubBlock& rSubBlock)
+        {
+            int base[3];
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                base[c] = expandETC(rSubBlock.quantized[c], differential);
+            }
+
+            rSubBlock.error = std::numeric_limits<uint32_t>::max();
+
+            for(int table = first; table <= last; ++table)
+            {
+                Palette  palette;
+                uint8_t  indices[16];
+                uint32_t errors[16];
+
+                paletteETC(base, table, palette);
+
+                const uint32_t error = fit(pixels, palette, false, 8, indices, errors);
+
+                if(error < rSubBlock.error)
+                {
+                    rSubBlock.error = error;
+                    rSubBlock.table = table;
+
+                    std::memcpy(rSubBlock.indices, indices, sizeof(rSubBlock.indices));
+                }
+            }
+        }
+
+        // Fits the sub-block's quantised average and, above fast quality, base colours a step
+        // away from it with the tables next to the average's best one. In differential mode the
+        // second sub-block's base must stay within -4 and 3 of the first's.
+        static void searchSubBlock(const Block& pixels,
+                                   const Quality& quality,
+                                   const bool& differential,
+                                   const int* pReference,
+                                   SubBlock& rSubBlock)
+        {
+            const int levels = differential ? 31 : 15;
+
+            fitSubBlock(pixels, differential, 0, 7, rSubBlock);
+
+            const SubBlock start = rSubBlock;
+
+            auto consider = [&](const int& r, const int& g, const int& b)
+            {
+                SubBlock candidate;
+
+                candidate.quantized[0] = start.quantized[0] + r;
+                candidate.quantized[1] = start.quantized[1] + g;
+                candidate.quantized[2] = start.quantized[2] + b;
+
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    if((candidate.quantized[c] < 0) || (candidate.quantized[c] > levels))
+                    {
+                        return;
+                    }
+
+                    if(pReference && ((candidate.quantized[c] - pReference[c] < -4) || (candidate.quantized[c] - pReference[c] > 3)))
+                    {
+                        return;
+                    }
+                }
+
+                fitSubBlock(pixels, differential, std::max(start.table - 1, 0), std::min(start.table + 1, 7), candidate);
+
+                if(candidate.error < rSubBlock.error)
+                {
+                    rSubBlock = candidate;
+                }
+            };
+
+            if(quality == eQualityNormal)
+            {
+                // All channels together, which moves the colour along the modifiers
+                for(int shift = -kShifts; shift <= kShifts; ++shift)
+                {
+                    if(shift != 0)
+                    {
+                        consider(shift, shift, shift);
+                    }
+                }
+            }
+            else if(quality == eQualityHigh)
+            {
+                for(int r = -kShifts; r <= kShifts; ++r)
+                {
+                    for(int g = -kShifts; g <= kShifts; ++g)
+                    {
+                        for(int b = -kShifts; b <= kShifts; ++b)
+                        {
+                            if((r != 0) || (g != 0) || (b != 0))
+                            {
+                                consider(r, g, b);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // ETC1 individual and differential blocks, which ETC2 decodes the same way
+        static uint32_t encodeETC(const Block& block, const Quality& quality, uint8_t* pOut)
+        {
+            Candidate best = {};
+
+            best.error = std::numeric_limits<uint32_t>::max();
+
+            for(int flip = 0; flip < 2; ++flip)
+            {
+                Block pixels[2];
+                float averages[2][3] = {};
+
+                for(size_t s = 0; s < 2; ++s)
+                {
+                    gather(block, kSubBlocks[flip][s], pixels[s]);
+
+                    for(size_t k = 0; k < 8; ++k)
+                    {
+                        for(size_t c = 0; c < 3; ++c)
+                        {
+                            averages[s][c] += float(pixels[s].channel[c][k]) / 8.0f;
+                        }
+                    }
+                }
+
+                for(int differential = 0; differential < 2; ++differential)
+                {
+                    const int levels = differential ? 31 : 15;
+
+                    Candidate candidate;
+
+                    candidate.differential = (differential != 0);
+                    candidate.flip         = flip;
+
+                    for(size_t s = 0; s < 2; ++s)
+                    {
+                        for(size_t c = 0; c < 3; ++c)
+                        {
+                            candidate.subBlocks[s].quantized[c] = clamp(int(averages[s][c] * float(levels) / 255.0f + 0.5f), 0, levels);
+                        }
+                    }
+
+                    searchSubBlock(pixels[0], quality, candidate.differential, nullptr, candidate.subBlocks[0]);
+
+                    // The second base is the first plus a three-bit difference
+                    if(differential)
+                    {
+                        for(size_t c = 0; c < 3; ++c)
+                        {
+                            const int base = candidate.subBlocks[0].quantized[c];
+
+                            candidate.subBlocks[1].quantized[c] = clamp(candidate.subBlocks[1].quantized[c], std::max(base - 4, 0), std::min(base + 3, 31));
+                        }
+                    }
+
+                    searchSubBlock(pixels[1], quality, candidate.differential,
+                                   differential ? candidate.subBlocks[0].quantized : nullptr,
+                                   candidate.subBlocks[1]);
+
+                    candidate.error = candidate.subBlocks[0].error + candidate.subBlocks[1].error;
+
+                    if(candidate.error < best.error)
+                    {
+                        best = candidate;
+                    }
+                }
+            }
+
+            const int (&first)[3]  = best.subBlocks[0].quantized;
+            const int (&second)[3] = best.subBlocks[1].quantized;
+
+            uint32_t high = 0;
+            uint32_t low  = 0;
+
+            if(best.differential)
+            {
+                high = (uint32_t(first[0]) << 27) | (uint32_t((second[0] - first[0]) & 7) << 24)
+                     | (uint32_t(first[1]) << 19) | (uint32_t((second[1] - first[1]) & 7) << 16)
+                     | (uint32_t(first[2]) << 11) | (uint32_t((second[2] - first[2]) & 7) << 8)
+                     | (1u << 1);
+            }
+            else
+            {
+                high = (uint32_t(first[0]) << 28) | (uint32_t(second[0]) << 24)
+                     | (uint32_t(first[1]) << 20) | (uint32_t(second[1]) << 16)
+                     | (uint32_t(first[2]) << 12) | (uint32_t(second[2]) << 8);
+            }
+
+            high |= (uint32_t(best.subBlocks[0].table) << 5) | (uint32_t(best.subBlocks[1].table) << 2) | uint32_t(best.flip);
+
+            // Index bits go down the columns
+            size_t next[2] = {0, 0};
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const size_t  s     = contains(kSubBlocks[best.flip][1], p) ? 1 : 0;
+                const size_t  bit   = (p & 3) * 4 + (p >> 2);
+                const uint8_t index = best.subBlocks[s].indices[next[s]++];
+
+                low |= (uint32_t(index >> 1) << (16 + bit)) | (uint32_t(index & 1) << bit);
+            }
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                pOut[i]     = uint8_t(high >> (24 - 8 * i));
+                pOut[4 + i] = uint8_t(low >> (24 - 8 * i));
+            }
+
+            return best.error;
+        }
+
+        static bool decodeETC(const uint8_t* pIn, uint8_t* pPixels)
+        {
+            const uint32_t high = (uint32_t(pIn[0]) << 24) | (uint32_t(pIn[1]) << 16) | (uint32_t(pIn[2]) << 8) | pIn[3];
+            const uint32_t low  = (uint32_t(pIn[4]) << 24) | (uint32_t(pIn[5]) << 16) | (uint32_t(pIn[6]) << 8) | pIn[7];
+
+            const bool differential = ((high >> 1) & 1) != 0;
+            const int  flip         = int(high & 1);
+
+            int bases[2][3];
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                const int shift = 27 - 8 * int(c);
+
+                if(differential)
+                {
+                    const int first = int((high >> shift) & 31);
+                    const int delta = int((high >> (shift - 3)) & 7) - ((((high >> (shift - 3)) & 4) != 0) ? 8 : 0);
+
+                    // Out of range sums select the T, H and planar modes
+                    if((first + delta < 0) || (first + delta > 31))
+                    {
+                        std::memset(pPixels, 0, 64);
+
+                        return false;
+                    }
+
+                    bases[0][c] = expandETC(first, true);
+                    bases[1][c] = expandETC(first + delta, true);
+                }
+                else
+                {
+                    bases[0][c] = expandETC(int((high >> (shift + 1)) & 15), false);
+                    bases[1][c] = expandETC(int((high >> (shift - 3)) & 15), false);
+                }
+            }
+
+            const int tables[2] = {int((high >> 5) & 7), int((high >> 2) & 7)};
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const size_t s     = contains(kSubBlocks[flip][1], p) ? 1 : 0;
+                const size_t bit   = (p & 3) * 4 + (p >> 2);
+                const size_t index = (((low >> (16 + bit)) & 1) << 1) | ((low >> bit) & 1);
+
+                const int modifier = ((index & 2) ? -1 : 1) * kModifiers[tables[s]][index & 1];
+
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    pPixels[4 * p + c] = uint8_t(clamp(bases[s][c] + modifier, 0, 255));
+                }
+
+                pPixels[4 * p + 3] = 255;
+            }
+
+            return true;
+        }
+
+        static uint32_t fitEAC(const Block& alpha,
+                               const int& base,
+                               const int& multiplier,
+                               const int& table,
+                               uint8_t* pIndices)
+        {
+            int values[8];
+
+            for(size_t i = 0; i < 8; ++i)
+            {
+                values[i] = clamp(base + kAlphaModifiers[table][i] * multiplier, 0, 255);
+            }
+
+            return fitAlpha(alpha, values, pIndices);
+        }
+
+        static void encodeEAC(const Block& block, const Quality& quality, uint8_t* pOut)
+        {
+            int lower = 255;
+            int upper = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                lower = std::min(lower, int(block.channel[3][p]));
+                upper = std::max(upper, int(block.channel[3][p]));
+            }
+
+            Block alpha;
+
+            alphaBlock(block, alpha);
+
+            int      base       = lower;
+            int      multiplier = 1;
+            int      table      = kAlphaExact;
+            uint8_t  indices[16];
+            uint32_t error      = fitEAC(alpha, base, multiplier, table, indices);
+
+            // Multipliers and bases tried around the ones spanning the block's range
+            const int spread = (quality == eQualityFast) ? 0 : ((quality == eQualityNormal) ? 1 : 2);
+
+            for(int t = 0; (t < 16) && (error > 0); ++t)
+            {
+                const int low   = kAlphaModifiers[t][3];
+                const int range = kAlphaModifiers[t][7] - low;
+
+                const int m = clamp(int(float(upper - lower) / float(range) + 0.5f), 1, 15);
+
+                for(int dm = -spread; dm <= spread; ++dm)
+                {
+                    const int candidateMultiplier = m + dm;
+
+                    if((candidateMultiplier < 1) || (candidateMultiplier > 15))
+                    {
+                        continue;
+                    }
+
+                    const int b = clamp(lower - low * candidateMultiplier, 0, 255);
+
+                    for(int db = -spread; db <= spread; ++db)
+                    {
+                        const int candidateBase = b + db;
+
+                        if((candidateBase < 0) || (candidateBase > 255))
+                        {
+                            continue;
+                        }
+
+                        uint8_t candidate[16];
+
+                        const uint32_t candidateError = fitEAC(alpha, candidateBase, candidateMultiplier, t, candidate);
+
+                        if(candidateError < error)
+                        {
+                            error      = candidateError;
+                            base       = candidateBase;
+                            multiplier = candidateMultiplier;
+                            table      = t;
+
+                            std::memcpy(indices, candidate, sizeof(indices));
+                        }
+                    }
+                }
+            }
+
+            // Index bits go down the columns, the first pixel in the top bits
+            uint64_t bits = 0;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const size_t position = (p & 3) * 4 + (p >> 2);
+
+                bits |= uint64_t(indices[p]) << (45 - 3 * position);
+            }
+
+            pOut[0] = uint8_t(base);
+            pOut[1] = uint8_t((multiplier << 4) | table);
+
+            for(size_t i = 0; i < 6; ++i)
+            {
+                pOut[2 + i] = uint8_t(bits >> (40 - 8 * i));
+            }
+        }
+
+        static void decodeEAC(const uint8_t* pIn, uint8_t* pPixels)
+        {
+            const int base       = pIn[0];
+            const int multiplier = pIn[1] >> 4;
+            const int table      = pIn[1] & 15;
+
+            uint64_t bits = 0;
+
+            for(size_t i = 0; i < 6; ++i)
+            {
+                bits = (bits << 8) | pIn[2 + i];
+            }
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const size_t position = (p & 3) * 4 + (p >> 2);
+                const size_t index    = size_t(bits >> (45 - 3 * position)) & 7;
+
+                pPixels[4 * p + 3] = uint8_t(clamp(base + kAlphaModifiers[table][index] * multiplier, 0, 255));
+            }
+        }
+    } // BlockEncoder
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Blocks
+
+size_t AAPL::BlockEncoder::blockSize(const Format& format)
+{
+    return ((format == eFormatBC1) || (format == eFormatETC2RGB8)) ? 8 : 16;
+}
+
+size_t AAPL::BlockEncoder::bytesPerRow(const Format& format, const uint32_t& width)
+{
+    return size_t((width + 3) / 4) * blockSize(format);
+}
+
+size_t AAPL::BlockEncoder::encodedSize(const Format& format, const uint32_t& width, const uint32_t& height)
+{
+    return bytesPerRow(format, width) * size_t((height + 3) / 4);
+}
+
+void AAPL::BlockEncoder::encodeBlock(const Format& format,
+                                     const Quality& quality,
+                                     const uint8_t* pPixels,
+                                     uint8_t* pBlock)
+{
+    Block block;
+
+    load(pPixels, block);
+
+    switch(format)
+    {
+        case eFormatBC1:
+            encodeColor(block, quality, pBlock);
+            break;
+
+        case eFormatBC3:
+            encodeAlpha(block, quality, pBlock);
+            encodeColor(block, quality, pBlock + 8);
+            break;
+
+        case eFormatBC7:
+            encodeBC7(block, quality, pBlock);
+            break;
+
+        case eFormatETC2RGB8:
+            encodeETC(block, quality, pBlock);
+            break;
+
+        case eFormatETC2RGBA8:
+            encodeEAC(block, quality, pBlock);
+            encodeETC(block, quality, pBlock + 8);
+            break;
+    }
+}
+
+bool AAPL::BlockEncoder::decodeBlock(const Format& format,
+                                     const uint8_t* pBlock,
+                                     uint8_t* pPixels)
+{
+    switch(format)
+    {
+        case eFormatBC1:
+            decodeColor(pBlock, true, pPixels);
+            return true;
+
+        case eFormatBC3:
+            decodeColor(pBlock + 8, false, pPixels);
+            decodeAlpha(pBlock, pPixels);
+            return true;
+
+        case eFormatBC7:
+            return decodeBC7(pBlock, pPixels);
+
+        case eFormatETC2RGB8:
+            return decodeETC(pBlock, pPixels);
+
+        case eFormatETC2RGBA8:
+            if(!decodeETC(pBlock + 8, pPixels))
+            {
+                return false;
+            }
+
+            decodeEAC(pBlock, pPixels);
+            return true;
+    }
+
+    return false;
+}
+
+#pragma mark -
+#pragma mark Public - Images
+
+void AAPL::BlockEncoder::encode(const Format& format,
+                                const Quality& quality,
+                                const uint8_t* pPixels,
+                                const uint32_t& width,
+                                const uint32_t& height,
+                                const size_t& bytesPerRow,
+                                uint8_t* pBlocks,
+                                Threads::WorkStealingPool* pPool)
+{
+    const size_t blocksWide = (width + 3) / 4;
+    const size_t blocksHigh = (height + 3) / 4;
+    const size_t size       = blockSize(format);
+
+    if((width == 0) || (height == 0))
+    {
+        return;
+    }
+
+    // One row of blocks per task
+    auto encodeRow = [&](size_t row)
+    {
+        uint8_t pixels[64];
+
+        for(size_t column = 0; column < blocksWide; ++column)
+        {
+            for(size_t y = 0; y < 4; ++y)
+            {
+                const uint8_t* pRow = pPixels + std::min(row * 4 + y, size_t(height - 1)) * bytesPerRow;
+
+                for(size_t x = 0; x < 4; ++x)
+                {
+                    std::memcpy(pixels + 4 * (4 * y + x), pRow + 4 * std::min(column * 4 + x, size_t(width - 1)), 4);
+                }
+            }
+
+            encodeBlock(format, quality, pixels, pBlocks + (row * blocksWide + column) * size);
+        }
+    };
+
+    if(pPool)
+    {
+        pPool->parallelFor(blocksHigh, encodeRow, 1);
+    }
+    else
+    {
+        for(size_t row = 0; row < blocksHigh; ++row)
+        {
+            encodeRow(row);
+        }
+    }
+}
+
+bool AAPL::BlockEncoder::decode(const Format& format,
+                                const uint8_t* pBlocks,
+                                const uint32_t& width,
+                                const uint32_t& height,
+                                uint8_t* pPixels,
+                                const size_t& bytesPerRow)
+{
+    const size_t blocksWide = (width + 3) / 4;
+    const size_t blocksHigh = (height + 3) / 4;
+    const size_t size       = blockSize(format);
+
+    bool result = true;
+
+    uint8_t pixels[64];
+
+    for(size_t row = 0; row < blocksHigh; ++row)
+    {
+        for(size_t column = 0; column < blocksWide; ++column)
+        {
+            result = decodeBlock(format, pBlocks + (row * blocksWide + column) * size, pixels) && result;
+
+            for(size_t y = 0; (y < 4) && (row * 4 + y < height); ++y)
+            {
+                for(size_t x = 0; (x < 4) && (column * 4 + x < width); ++x)
+                {
+                    std::memcpy(pPixels + (row * 4 + y) * bytesPerRow + 4 * (column * 4 + x), pixels + 4 * (4 * y + x), 4);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+#pragma mark -
+#pragma mark Public - Error
+
+AAPL::BlockEncoder::Error AAPL::BlockEncoder::measure(const uint8_t* pPixels,
+                                                      const uint8_t* pDecoded,
+                                                      const uint32_t& width,
+                                                      const uint32_t& height,
+                                                      const size_t& bytesPerRow)
+{
+    double rgb   = 0.0;
+    double alpha = 0.0;
+
+    for(uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* pA = pPixels  + y * bytesPerRow;
+        const uint8_t* pB = pDecoded + y * bytesPerRow;
+
+        for(uint32_t i = 0; i < 4 * width; ++i)
+        {
+            const double d = double(pA[i]) - double(pB[i]);
+
+            ((i & 3) == 3 ? alpha : rgb) += d * d;
+        }
+    }
+
+    const double pixels = double(width) * double(height);
+
+    auto psnr = [](const double& squares, const double& count)
+    {
+        return (squares > 0.0) ? 10.0 * std::log10(255.0 * 255.0 * count / squares) : std::numeric_limits<double>::infinity();
+    };
+
+    Error error = {psnr(rgb, 3.0 * pixels), psnr(alpha, pixels)};
+
+    return error;
+}
+
+#pragma mark -
+#pragma mark Public - Cache
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        // Changes whenever the encoder writes different blocks for the same pixels
+        static const uint32_t kVersion = 1;
+
+        struct Header
+        {
+            char     magic[4];
+            uint32_t version;
+            uint32_t format;
+            uint32_t quality;
+            uint32_t width;
+            uint32_t height;
+            uint64_t fingerprint;
+            uint64_t size;
+        };
+
+        static Header header(const Format& format,
+                             const Quality& quality,
+                             const uint32_t& width,
+                             const uint32_t& height,
+                             const uint64_t& fingerprint)
+        {
+            Header result = {{'A', 'B', 'L', 'K'}, kVersion, uint32_t(format), uint32_t(quality), width, height, fingerprint,
+                             uint64_t(encodedSize(format, width, height))};
+
+            return result;
+        }
+    } // BlockEncoder
+} // AAPL
+
+uint64_t AAPL::BlockEncoder::fingerprint(const uint8_t* pPixels,
+                                         const uint32_t& width,
+                                         const uint32_t& height,
+                                         const size_t& bytesPerRow)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    auto add = [&hash](const uint8_t* pBytes, const size_t& count)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            hash = (hash ^ pBytes[i]) * 1099511628211ull;
+        }
+    };
+
+    add(reinterpret_cast<const uint8_t*>(&width),  sizeof(width));
+    add(reinterpret_cast<const uint8_t*>(&height), sizeof(height));
+
+    for(uint32_t y = 0; y < height; ++y)
+    {
+        add(pPixels + y * bytesPerRow, 4 * size_t(width));
+    }
+
+    return hash;
+}
+
+bool AAPL::BlockEncoder::read(const std::string& path,
+                              const Format& format,
+                              const Quality& quality,
+                              const uint32_t& width,
+                              const uint32_t& height,
+                              const uint64_t& fingerprint,
+                              std::vector<uint8_t>& rBlocks)
+{
+    FILE* pFile = std::fopen(path.c_str(), "rb");
+
+    if(!pFile)
+    {
+        return false;
+    }
+
+    const Header expected = header(format, quality, width, height, fingerprint);
+
+    Header found;
+
+    bool result = (std::fread(&found, sizeof(found), 1, pFile) == 1) && (std::memcmp(&found, &expected, sizeof(found)) == 0);
+
+    if(result)
+    {
+        rBlocks.resize(size_t(expected.size));
+
+        result = std::fread(rBlocks.data(), 1, rBlocks.size(), pFile) == rBlocks.size();
+    }
+
+    std::fclose(pFile);
+
+    return result;
+}
+
+bool AAPL::BlockEncoder::write(const std::string& path,
+                               const Format& format,
+                               const Quality& quality,
+                               const uint32_t& width,
+                               const uint32_t& height,
+                               const uint64_t& fingerprint,
+                               const std::vector<uint8_t>& blocks)
+{
+    const Header contents = header(format, quality, width, height, fingerprint);
+
+    if(blocks.size() != contents.size)
+    {
+        return false;
+    }
+
+    // Readers never see a partly written file
+    const std::string temporary = path + ".tmp";
+
+    FILE* pFile = std::fopen(temporary.c_str(), "wb");
+
+    if(!pFile)
+    {
+        return false;
+    }
+
+    bool result = (std::fwrite(&contents, sizeof(contents), 1, pFile) == 1)
+               && (std::fwrite(blocks.data(), 1, blocks.size(), pFile) == blocks.size());
+
+    result = (std::fclose(pFile) == 0) && result;
+
+    if(result)
+    {
+        result = std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+    if(!result)
+    {
+        std::remove(temporary.c_str());
+    }
+
+    return result;
+}
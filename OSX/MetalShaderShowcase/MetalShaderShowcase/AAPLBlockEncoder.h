@@ -0,0 +1,129 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Block compression of RGBA8 images into BC1, BC3 and BC7 for Macs and ETC2 RGB8 and EAC RGBA8 for
+ iOS GPUs, cutting a texture's memory and bandwidth four to eight times. Endpoints come from the
+ principal axis of each block and are refined by least squares against the palette indices; the
+ search that picks every pixel's palette entry runs eight pixels at a time (SSE2 or NEON). Rows of
+ blocks are spread over a thread pool. Encoded images can be kept in cache files, so a texture is
+ only encoded the first time it is loaded.
+ */
+
+#ifndef _AAPL_BLOCK_ENCODER_H_
+#define _AAPL_BLOCK_ENCODER_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace BlockEncoder
+    {
+        enum Format
+        {
+            eFormatBC1 = 0,     // MTLPixelFormatBC1_RGBA, 8 bytes per block, opaque
+            eFormatBC3,         // MTLPixelFormatBC3_RGBA, 16 bytes per block
+            eFormatBC7,         // MTLPixelFormatBC7_RGBAUnorm, 16 bytes per block
+            eFormatETC2RGB8,    // MTLPixelFormatETC2_RGB8, 8 bytes per block, opaque
+            eFormatETC2RGBA8    // MTLPixelFormatEAC_RGBA8, 16 bytes per block
+        };
+
+        enum Quality
+        {
+            eQualityFast = 0,   // Principal axis endpoints only; BC7 mode 6 only
+            eQualityNormal,     // Least squares refinement; BC7 tries the two best partitions of mode 1
+            eQualityHigh        // More refinement, endpoint and base colour searches; BC7 tries sixteen partitions
+        };
+
+        // Bytes per 4x4 block
+        size_t blockSize(const Format& format);
+
+        // Bytes per row of blocks, for replaceRegion
+        size_t bytesPerRow(const Format& format, const uint32_t& width);
+
+        size_t encodedSize(const Format& format, const uint32_t& width, const uint32_t& height);
+
+        // A block of sixteen RGBA8 pixels, row after row
+        void encodeBlock(const Format& format,
+                         const Quality& quality,
+                         const uint8_t* pPixels,
+                         uint8_t* pBlock);
+
+        // Decodes what encodeBlock writes: false for the BC7 modes other than 1 and 6 and the
+        // ETC2 T, H and planar modes, which it never writes
+        bool decodeBlock(const Format& format,
+                         const uint8_t* pBlock,
+                         uint8_t* pPixels);
+
+        // Blocks past the right or bottom edge of sizes that aren't multiples of four repeat the
+        // last column and row. Rows of blocks are spread over the pool if there is one.
+        void encode(const Format& format,
+                    const Quality& quality,
+                    const uint8_t* pPixels,
+                    const uint32_t& width,
+                    const uint32_t& height,
+                    const size_t& bytesPerRow,
+                    uint8_t* pBlocks,
+                    Threads::WorkStealingPool* pPool = nullptr);
+
+        bool decode(const Format& format,
+                    const uint8_t* pBlocks,
+                    const uint32_t& width,
+                    const uint32_t& height,
+                    uint8_t* pPixels,
+                    const size_t& bytesPerRow);
+
+        // Peak signal to noise ratios in dB, infinite for identical images
+        struct Error
+        {
+            double rgb;
+            double alpha;
+        };
+
+        Error measure(const uint8_t* pPixels,
+                      const uint8_t* pDecoded,
+                      const uint32_t& width,
+                      const uint32_t& height,
+                      const size_t& bytesPerRow);
+
+        // 64-bit FNV-1a of the image's size and pixels
+        uint64_t fingerprint(const uint8_t* pPixels,
+                             const uint32_t& width,
+                             const uint32_t& height,
+                             const size_t& bytesPerRow);
+
+        // A cache file holds the blocks of one image together with the format, quality, size and
+        // fingerprint of the pixels they were encoded from. read fails if any of them differs or
+        // the file was written by another version of the encoder; write replaces the file
+        // atomically.
+        bool read(const std::string& path,
+                  const Format& format,
+                  const Quality& quality,
+                  const uint32_t& width,
+                  const uint32_t& height,
+                  const uint64_t& fingerprint,
+                  std::vector<uint8_t>& rBlocks);
+
+        bool write(const std::string& path,
+                   const Format& format,
+                   const Quality& quality,
+                   const uint32_t& width,
+                   const uint32_t& height,
+                   const uint64_t& fingerprint,
+                   const std::vector<uint8_t>& blocks);
+    } // BlockEncoder
+} // AAPL
+
+#endif
+
+#endif
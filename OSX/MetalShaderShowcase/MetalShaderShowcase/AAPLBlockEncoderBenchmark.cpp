@@ -0,0 +1,956 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the block encoder, a standalone program that is not part of the app target. It
+ cross-checks the encoder's decoder against reference decoders written from the format
+ specifications: on random blocks, where decodeBlock must agree with the reference or, for the
+ BC7 modes and ETC2 T, H and planar modes it never writes, turn the block down; on blocks it
+ encodes itself, where solid colours must also come back close to the original; and on whole
+ images, where decode must agree block by block. BC1 and BC3 leave the rounding of interpolated
+ colours and alphas to the GPU, so those may differ by one step; everything else must match
+ exactly. It then encodes every image in every format and quality on the calling thread and on a
+ pool, which must write the same blocks, and reports the peak signal to noise ratio, the time and
+ the megabytes of RGBA8 encoded per second. Last it writes a cache file and reads it back, and
+ checks that reading fails for another format, quality or fingerprint, a missing file and a
+ truncated one.
+
+ The images are a shaded sphere, a normal map and an odd-sized gradient with a noisy alpha, or raw
+ RGBA8 files such as dumps of the sample's SphereMap.jpg and NormalMap.png given on the command line.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLBlockEncoder.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp AAPLBlockEncoderBenchmark.cpp -o benchmark
+     ./benchmark [image.rgba width height]...
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AAPLBlockEncoder.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::BlockEncoder;
+
+namespace
+{
+    const char* kFormatNames[]  = {"BC1", "BC3", "BC7", "ETC2RGB8", "ETC2RGBA8"};
+    const char* kQualityNames[] = {"fast", "normal", "high"};
+
+    const int kFormats   = 5;
+    const int kQualities = 3;
+
+    // Steps the decoders may differ by, per format
+    const int kTolerances[kFormats] = {1, 1, 0, 0, 0};
+
+    // Largest difference of a solid colour after encoding and decoding, per format
+    const int kSolidErrors[kFormats] = {1, 1, 1, 6, 6};
+
+    // Lowest peak signal to noise ratios in dB; alpha only counts for the formats that keep it
+    const double kLowestRGB   = 28.0;
+    const double kLowestAlpha = 40.0;
+
+    const char* kCachePath = "AAPLBlockEncoderBenchmark.blk";
+
+    struct Image
+    {
+        std::string          name;
+        uint32_t             width;
+        uint32_t             height;
+        std::vector<uint8_t> pixels;
+    };
+
+    uint32_t next(uint32_t& rState)
+    {
+        rState = rState * 1664525u + 1013904223u;
+
+        return rState >> 8;
+    }
+
+    uint8_t saturate(const double& value)
+    {
+        return uint8_t(std::min(std::max(value + 0.5, 0.0), 255.0));
+    }
+
+    bool hasAlpha(const Format& format)
+    {
+        return (format != eFormatBC1) && (format != eFormatETC2RGB8);
+    }
+
+#pragma mark -
+#pragma mark Reference Decoders
+
+    // Bits first to first + count - 1 of a block read as a little endian number
+    uint32_t littleBits(const uint8_t* pBlock, const size_t& first, const size_t& count)
+    {
+        uint32_t value = 0;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            const size_t bit = first + i;
+
+            value |= uint32_t((pBlock[bit >> 3] >> (bit & 7)) & 1) << i;
+        }
+
+        return value;
+    }
+
+    uint64_t bigEndian(const uint8_t* pBlock)
+    {
+        uint64_t value = 0;
+
+        for(size_t i = 0; i < 8; ++i)
+        {
+            value = (value << 8) | pBlock[i];
+        }
+
+        return value;
+    }
+
+    // BC1 colours, in four-colour mode only for BC3
+    void referenceBC1(const uint8_t* pBlock, const bool& threeColor, uint8_t* pPixels)
+    {
+        const uint32_t c0 = littleBits(pBlock, 0, 16);
+        const uint32_t c1 = littleBits(pBlock, 16, 16);
+
+        double colors[4][4];
+
+        for(int e = 0; e < 2; ++e)
+        {
+            const uint32_t c = e ? c1 : c0;
+
+            colors[e][0] = double((c >> 11) & 31) * 255.0 / 31.0;
+            colors[e][1] = double((c >> 5) & 63) * 255.0 / 63.0;
+            colors[e][2] = double(c & 31) * 255.0 / 31.0;
+            colors[e][3] = 255.0;
+        }
+
+        const bool fourColor = !threeColor || (c0 > c1);
+
+        for(int c = 0; c < 4; ++c)
+        {
+            colors[2][c] = fourColor ? (2.0 * colors[0][c] + colors[1][c]) / 3.0 : (colors[0][c] + colors[1][c]) / 2.0;
+            colors[3][c] = fourColor ? (colors[0][c] + 2.0 * colors[1][c]) / 3.0 : 0.0;
+        }
+
+        for(size_t p = 0; p < 16; ++p)
+        {
+            const uint32_t index = littleBits(pBlock, 32 + 2 * p, 2);
+
+            for(int c = 0; c < 4; ++c)
+            {
+                pPixels[4 * p + c] = saturate(colors[index][c]);
+            }
+        }
+    }
+
+    void referenceBC3Alpha(const uint8_t* pBlock, uint8_t* pPixels)
+    {
+        const double a0 = pBlock[0];
+        const double a1 = pBlock[1];
+
+        double alphas[8] = {a0, a1, 0.0, 0.0, 0.0, 0.0, 0.0, 255.0};
+
+        if(a0 > a1)
+        {
+            for(int i = 1; i < 7; ++i)
+            {
+                alphas[i + 1] = ((7 - i) * a0 + i * a1) / 7.0;
+            }
+        }
+        else
+        {
+            for(int i = 1; i < 5; ++i)
+            {
+                alphas[i + 1] = ((5 - i) * a0 + i * a1) / 5.0;
+            }
+        }
+
+        for(size_t p = 0; p < 16; ++p)
+        {
+            pPixels[4 * p + 3] = saturate(alphas[littleBits(pBlock, 16 + 3 * p, 3)]);
+        }
+    }
+
+    // The two-subset partitions of BC7, subset by pixel
+    const char* kBC7Partitions[64] =
+    {
+        "0011001100110011", "0001000100010001", "0111011101110111", "0001001100110111",
+        "0000000100010011", "0011011101111111", "0001001101111111", "0000000100110111",
+        "0000000000010011", "0011011111111111", "0000000101111111", "0000000000010111",
+        "0001011111111111", "0000000011111111", "0000111111111111", "0000000000001111",
+        "0000100011101111", "0111000100000000", "0000000010001110", "0111001100010000",
+        "0011000100000000", "0000100011001110", "0000000010001100", "0111001100110001",
+        "0011000100010000", "0000100010001100", "0110011001100110", "0011011001101100",
+        "0001011111101000", "0000111111110000", "0111000110001110", "0011100110011100",
+        "0101010101010101", "0000111100001111", "0101101001011010", "0011001111001100",
+        "0011110000111100", "0101010110101010", "0110100101101001", "0101101010100101",
+        "0111001111001110", "0001001111001000", "0011001001001100", "0011101111011100",
+        "0110100110010110", "0011110011000011", "0110011010011001", "0000011001100000",
+        "0100111001000000", "0010011100100000", "0000001001110010", "0000010011100100",
+        "0110110010010011", "0011011011001001", "0110001110011100", "0011100111000110",
+        "0110110011001001", "0110001100111001", "0111111010000001", "0001100011100111",
+        "0000111100110011", "0011001111110000", "0010001011101110", "0100010001110111"
+    };
+
+    // Pixel of the second subset whose index is a bit short
+    const size_t kBC7Anchors[64] =
+    {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+    };
+
+    int interpolateBC7(const int& e0, const int& e1, const int& index, const int& bits)
+    {
+        static const int weights2[4]  = {0, 21, 43, 64};
+        static const int weights3[8]  = {0, 9, 18, 27, 37, 46, 55, 64};
+        static const int weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        const int weight = (bits == 2) ? weights2[index] : ((bits == 3) ? weights3[index] : weights4[index]);
+
+        return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+    }
+
+    // Modes 1 and 6, the only ones the encoder writes; false for the others
+    bool referenceBC7(const uint8_t* pBlock, uint8_t* pPixels)
+    {
+        std::memset(pPixels, 0, 64);
+
+        if((pBlock[0] & 0x7F) == 0x40)
+        {
+            // Mode 6: RGBA endpoints of seven bits and a p-bit each, four-bit indices
+            int endpoints[2][4];
+
+            for(int c = 0; c < 4; ++c)
+            {
+                for(int e = 0; e < 2; ++e)
+                {
+                    endpoints[e][c] = int(littleBits(pBlock, 7 + 14 * c + 7 * e, 7) << 1) | int(littleBits(pBlock, 63 + e, 1));
+                }
+            }
+
+            size_t bit = 65;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const size_t bits  = (p == 0) ? 3 : 4;
+                const int    index = int(littleBits(pBlock, bit, bits));
+
+                bit += bits;
+
+                for(int c = 0; c < 4; ++c)
+                {
+                    pPixels[4 * p + c] = uint8_t(interpolateBC7(endpoints[0][c], endpoints[1][c], index, 4));
+                }
+            }
+
+            return true;
+        }
+
+        if((pBlock[0] & 0x03) == 0x02)
+        {
+            // Mode 1: two subsets of RGB endpoints of six bits and a p-bit per subset, three-bit indices
+            const size_t partition = littleBits(pBlock, 2, 6);
+
+            int endpoints[2][2][3];
+
+            for(int c = 0; c < 3; ++c)
+            {
+                for(int s = 0; s < 2; ++s)
+                {
+                    for(int e = 0; e < 2; ++e)
+                    {
+                        const int value = int(littleBits(pBlock, 8 + 24 * c + 12 * s + 6 * e, 6) << 1) | int(littleBits(pBlock, 80 + s, 1));
+
+                        endpoints[s][e][c] = (value << 1) | (value >> 6);
+                    }
+                }
+            }
+
+            size_t bit = 82;
+
+            for(size_t p = 0; p < 16; ++p)
+            {
+                const int    s     = kBC7Partitions[partition][p] - '0';
+                const size_t bits  = ((p == 0) || (p == kBC7Anchors[partition])) ? 2 : 3;
+                const int    index = int(littleBits(pBlock, bit, bits));
+
+                bit += bits;
+
+                for(int c = 0; c < 3; ++c)
+                {
+                    pPixels[4 * p + c] = uint8_t(interpolateBC7(endpoints[s][0][c], endpoints[s][1][c], index, 3));
+                }
+
+                pPixels[4 * p + 3] = 255;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // Individual and differential ETC2 RGB8 blocks; false for the T, H and planar modes
+    bool referenceETC2(const uint8_t* pBlock, uint8_t* pPixels)
+    {
+        static const int modifiers[8][4] =
+        {
+            {2, 8, -2, -8},       {5, 17, -5, -17},     {9, 29, -9, -29},     {13, 42, -13, -42},
+            {18, 60, -18, -60},   {24, 80, -24, -80},   {33, 106, -33, -106}, {47, 183, -47, -183}
+        };
+
+        const uint64_t bits = bigEndian(pBlock);
+
+        auto field = [bits](const int& last, const int& count)
+        {
+            return int((bits >> (last - count + 1)) & ((1u << count) - 1));
+        };
+
+        std::memset(pPixels, 0, 64);
+
+        int bases[2][3];
+
+        if(field(33, 1) == 0)
+        {
+            for(int c = 0; c < 3; ++c)
+            {
+                bases[0][c] = field(63 - 8 * c, 4) * 17;
+                bases[1][c] = field(59 - 8 * c, 4) * 17;
+            }
+        }
+        else
+        {
+            for(int c = 0; c < 3; ++c)
+            {
+                const int base  = field(63 - 8 * c, 5);
+                const int delta = (field(58 - 8 * c, 3) ^ 4) - 4;
+
+                if((base + delta < 0) || (base + delta > 31))
+                {
+                    return false;
+                }
+
+                bases[0][c] = (base << 3) | (base >> 2);
+                bases[1][c] = ((base + delta) << 3) | ((base + delta) >> 2);
+            }
+        }
+
+        const int  tables[2] = {field(39, 3), field(36, 3)};
+        const bool flipped   = field(32, 1) != 0;
+
+        for(int y = 0; y < 4; ++y)
+        {
+            for(int x = 0; x < 4; ++x)
+            {
+                const int j     = 4 * x + y;
+                const int s     = flipped ? (y >> 1) : (x >> 1);
+                const int index = (field(16 + j, 1) << 1) | field(j, 1);
+
+                for(int c = 0; c < 3; ++c)
+                {
+                    pPixels[4 * (4 * y + x) + c] = uint8_t(std::min(std::max(bases[s][c] + modifiers[tables[s]][index], 0), 255));
+                }
+
+                pPixels[4 * (4 * y + x) + 3] = 255;
+            }
+        }
+
+        return true;
+    }
+
+    void referenceEAC(const uint8_t* pBlock, uint8_t* pPixels)
+    {
+        static const int modifiers[16][8] =
+        {
+            {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},  {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},   {-3, -5, -7, -9, 2, 4, 6, 8}
+        };
+
+        const uint64_t bits = bigEndian(pBlock);
+
+        const int base       = int(bits >> 56);
+        const int multiplier = int((bits >> 52) & 15);
+        const int table      = int((bits >> 48) & 15);
+
+        for(int y = 0; y < 4; ++y)
+        {
+            for(int x = 0; x < 4; ++x)
+            {
+                const int index = int((bits >> (45 - 3 * (4 * x + y))) & 7);
+
+                pPixels[4 * (4 * y + x) + 3] = uint8_t(std::min(std::max(base + modifiers[table][index] * multiplier, 0), 255));
+            }
+        }
+    }
+
+    bool referenceDecode(const Format& format, const uint8_t* pBlock, uint8_t* pPixels)
+    {
+        switch(format)
+        {
+            case eFormatBC1:
+                referenceBC1(pBlock, true, pPixels);
+                return true;
+
+            case eFormatBC3:
+                referenceBC1(pBlock + 8, false, pPixels);
+                referenceBC3Alpha(pBlock, pPixels);
+                return true;
+
+            case eFormatBC7:
+                return referenceBC7(pBlock, pPixels);
+
+            case eFormatETC2RGB8:
+                return referenceETC2(pBlock, pPixels);
+
+            case eFormatETC2RGBA8:
+                if(!referenceETC2(pBlock + 8, pPixels))
+                {
+                    return false;
+                }
+
+                referenceEAC(pBlock, pPixels);
+                return true;
+        }
+
+        return false;
+    }
+
+    // Largest difference between two runs of RGBA8 pixels
+    int difference(const uint8_t* pPixels, const uint8_t* pOther, const size_t& count)
+    {
+        int largest = 0;
+
+        for(size_t i = 0; i < 4 * count; ++i)
+        {
+            largest = std::max(largest, std::abs(int(pPixels[i]) - int(pOther[i])));
+        }
+
+        return largest;
+    }
+
+#pragma mark -
+#pragma mark Checks
+
+    // Random blocks, and blocks the encoder writes for random, solid, two-colour and gradient pixels
+    bool checkBlocks()
+    {
+        uint32_t state = 1;
+
+        bool passed = true;
+
+        for(int f = 0; f < kFormats; ++f)
+        {
+            const Format format = Format(f);
+
+            size_t tried = 0;
+            size_t refused = 0;
+            size_t mismatches = 0;
+
+            for(int i = 0; i < 20000; ++i)
+            {
+                uint8_t block[16];
+                uint8_t decoded[64];
+                uint8_t reference[64];
+
+                for(uint8_t& rByte : block)
+                {
+                    rByte = uint8_t(next(state));
+                }
+
+                // Most random BC7 blocks are of the modes the encoder never writes
+                if((format == eFormatBC7) && (i & 1))
+                {
+                    block[0] = (i & 2) ? uint8_t((block[0] & 0xFC) | 0x02) : uint8_t((block[0] & 0x80) | 0x40);
+                }
+
+                const bool supported = referenceDecode(format, block, reference);
+
+                tried++;
+                refused += supported ? 0 : 1;
+
+                if((decodeBlock(format, block, decoded) != supported) ||
+                   (supported && (difference(decoded, reference, 16) > kTolerances[f])))
+                {
+                    mismatches++;
+                }
+            }
+
+            std::printf("%-9s %zu random blocks, %zu of modes the encoder never writes: %zu mismatches against the reference decoder\n",
+                        kFormatNames[f], tried, refused, mismatches);
+
+            passed = passed && (mismatches == 0);
+
+            for(int q = 0; q < kQualities; ++q)
+            {
+                const Quality quality = Quality(q);
+
+                size_t encoded = 0;
+                int    solid   = 0;
+
+                mismatches = 0;
+
+                for(int i = 0; i < 2000; ++i)
+                {
+                    uint8_t pixels[64];
+                    uint8_t block[16];
+                    uint8_t decoded[64];
+                    uint8_t reference[64];
+
+                    uint8_t colors[2][4];
+
+                    for(int c = 0; c < 4; ++c)
+                    {
+                        colors[0][c] = uint8_t(next(state));
+                        colors[1][c] = uint8_t(next(state));
+                    }
+
+                    const int kind = i % 4;
+
+                    for(int p = 0; p < 16; ++p)
+                    {
+                        for(int c = 0; c < 4; ++c)
+                        {
+                            switch(kind)
+                            {
+                                case 0:
+                                    pixels[4 * p + c] = uint8_t(next(state));
+                                    break;
+
+                                case 1:
+                                    pixels[4 * p + c] = colors[0][c];
+                                    break;
+
+                                case 2:
+                                    pixels[4 * p + c] = colors[(next(state) >> 4) & 1][c];
+                                    break;
+
+                                default:
+                                    pixels[4 * p + c] = uint8_t((colors[0][c] * (15 - p) + colors[1][c] * p) / 15);
+                                    break;
+                            }
+                        }
+
+                        // Opaque formats drop alpha, so their solid colours are compared opaque
+                        if(!hasAlpha(format))
+                        {
+                            pixels[4 * p + 3] = 255;
+                        }
+                    }
+
+                    encodeBlock(format, quality, pixels, block);
+
+                    const bool supported = referenceDecode(format, block, reference);
+
+                    encoded++;
+
+                    if(!supported || !decodeBlock(format, block, decoded) || (difference(decoded, reference, 16) > kTolerances[f]))
+                    {
+                        mismatches++;
+                    }
+                    else if(kind == 1)
+                    {
+                        solid = std::max(solid, difference(decoded, pixels, 16));
+                    }
+                }
+
+                std::printf("%-9s %-6s %zu encoded blocks: %zu mismatches against the reference decoder, solid colours within %d\n",
+                            kFormatNames[f], kQualityNames[q], encoded, mismatches, solid);
+
+                passed = passed && (mismatches == 0) && (solid <= kSolidErrors[f]);
+            }
+        }
+
+        return passed;
+    }
+
+    // Whole images decoded with the reference block by block, edge blocks cut to the image
+    int checkImage(const Format& format, const std::vector<uint8_t>& blocks, const Image& image, const std::vector<uint8_t>& decoded)
+    {
+        const size_t size = blockSize(format);
+
+        int largest = 0;
+
+        for(uint32_t by = 0; by < (image.height + 3) / 4; ++by)
+        {
+            for(uint32_t bx = 0; bx < (image.width + 3) / 4; ++bx)
+            {
+                uint8_t reference[64];
+
+                const uint8_t* pBlock = &blocks[(size_t(by) * ((image.width + 3) / 4) + bx) * size];
+
+                if(!referenceDecode(format, pBlock, reference))
+                {
+                    return 256;
+                }
+
+                for(uint32_t y = 4 * by; y < std::min(4 * by + 4, image.height); ++y)
+                {
+                    const size_t columns = std::min(4 * bx + 4, image.width) - 4 * bx;
+
+                    largest = std::max(largest, difference(&decoded[(size_t(y) * image.width + 4 * bx) * 4], &reference[(y - 4 * by) * 16], columns));
+                }
+            }
+        }
+
+        return largest;
+    }
+
+    double milliseconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool run(const Image& image, Threads::WorkStealingPool& rPool)
+    {
+        const size_t bytesPerRow = size_t(image.width) * 4;
+        const double megabytes   = double(image.pixels.size()) * 1.0e-6;
+
+        bool passed = true;
+
+        std::printf("\n%s, %ux%u: format    quality     RGB   alpha   one thread        %zu threads        ratio\n",
+                    image.name.c_str(), image.width, image.height, rPool.concurrency());
+
+        for(int f = 0; f < kFormats; ++f)
+        {
+            const Format format = Format(f);
+
+            double previous = 0.0;
+
+            for(int q = 0; q < kQualities; ++q)
+            {
+                const Quality quality = Quality(q);
+
+                std::vector<uint8_t> serial(encodedSize(format, image.width, image.height));
+                std::vector<uint8_t> pooled(serial.size());
+                std::vector<uint8_t> decoded(image.pixels.size());
+
+                auto start = std::chrono::steady_clock::now();
+
+                encode(format, quality, image.pixels.data(), image.width, image.height, bytesPerRow, serial.data());
+
+                const double serialTime = milliseconds(start);
+
+                start = std::chrono::steady_clock::now();
+
+                encode(format, quality, image.pixels.data(), image.width, image.height, bytesPerRow, pooled.data(), &rPool);
+
+                const double pooledTime = milliseconds(start);
+
+                const bool  decodable = decode(format, serial.data(), image.width, image.height, decoded.data(), bytesPerRow);
+                const Error error     = measure(image.pixels.data(), decoded.data(), image.width, image.height, bytesPerRow);
+
+                char alpha[16] = "-";
+
+                if(hasAlpha(format))
+                {
+                    std::snprintf(alpha, sizeof(alpha), "%.2f", error.alpha);
+                }
+
+                std::printf("%*s %-9s %-6s %7.2f %7s %8.1f ms %6.1f MB/s %8.1f ms %6.1f MB/s %3.0fx\n",
+                            int(image.name.size()) + 1, "", kFormatNames[f], kQualityNames[q], error.rgb, alpha,
+                            serialTime, megabytes * 1.0e3 / serialTime, pooledTime, megabytes * 1.0e3 / pooledTime,
+                            double(image.pixels.size()) / double(serial.size()));
+
+                if(serial != pooled)
+                {
+                    std::printf("The pool wrote other blocks than the calling thread\n");
+
+                    passed = false;
+                }
+
+                const int mismatch = decodable ? checkImage(format, serial, image, decoded) : 256;
+
+                if(mismatch > kTolerances[f])
+                {
+                    std::printf("decode differs from the reference decoder by %d\n", mismatch);
+
+                    passed = false;
+                }
+
+                if((error.rgb < kLowestRGB) || (hasAlpha(format) && (error.alpha < kLowestAlpha)))
+                {
+                    std::printf("The signal to noise ratio is below %.0f dB for RGB or %.0f dB for alpha\n", kLowestRGB, kLowestAlpha);
+
+                    passed = false;
+                }
+
+                // A higher quality tries all the lower one does, so it may not do worse
+                if(error.rgb < previous - 0.01)
+                {
+                    std::printf("The RGB signal to noise ratio is below that of the lower quality\n");
+
+                    passed = false;
+                }
+
+                previous = error.rgb;
+            }
+        }
+
+        return passed;
+    }
+
+    bool checkCache(const Image& image)
+    {
+        const uint32_t& width       = image.width;
+        const uint32_t& height      = image.height;
+        const size_t    bytesPerRow = size_t(width) * 4;
+
+        std::vector<uint8_t> blocks(encodedSize(eFormatBC7, width, height));
+        std::vector<uint8_t> found;
+
+        encode(eFormatBC7, eQualityFast, image.pixels.data(), width, height, bytesPerRow, blocks.data());
+
+        const uint64_t print = fingerprint(image.pixels.data(), width, height, bytesPerRow);
+
+        std::vector<uint8_t> pixels(image.pixels);
+
+        pixels[pixels.size() / 2] ^= 1;
+
+        const bool changed = fingerprint(pixels.data(), width, height, bytesPerRow) != print;
+
+        // Blocks of the wrong size aren't written
+        const bool misfit = !write(kCachePath, eFormatBC7, eQualityFast, width, height, print, std::vector<uint8_t>(blocks.size() - 1));
+        const bool absent = !read(kCachePath, eFormatBC7, eQualityFast, width, height, print, found);
+
+        const bool written = write(kCachePath, eFormatBC7, eQualityFast, width, height, print, blocks);
+        const bool same    = read(kCachePath, eFormatBC7, eQualityFast, width, height, print, found) && (found == blocks);
+
+        const bool others = !read(kCachePath, eFormatBC3, eQualityFast, width, height, print, found) &&
+                            !read(kCachePath, eFormatBC7, eQualityHigh, width, height, print, found) &&
+                            !read(kCachePath, eFormatBC7, eQualityFast, width, height, print + 1, found) &&
+                            !read(kCachePath, eFormatBC7, eQualityFast, width + 1, height, print, found);
+
+        // The file less its last byte
+        bool truncated = false;
+
+        if(FILE* pFile = std::fopen(kCachePath, "rb"))
+        {
+            std::vector<char> contents;
+
+            char buffer[4096];
+
+            for(size_t count; (count = std::fread(buffer, 1, sizeof(buffer), pFile)) > 0;)
+            {
+                contents.insert(contents.end(), buffer, buffer + count);
+            }
+
+            std::fclose(pFile);
+
+            pFile = std::fopen(kCachePath, "wb");
+
+            if(pFile && !contents.empty())
+            {
+                std::fwrite(contents.data(), 1, contents.size() - 1, pFile);
+                std::fclose(pFile);
+
+                truncated = !read(kCachePath, eFormatBC7, eQualityFast, width, height, print, found);
+            }
+        }
+
+        std::remove(kCachePath);
+
+        std::printf("\nCache: fingerprint changes with a pixel %s, wrong size refused %s, written and read back %s, other format, quality, fingerprint or size refused %s, truncated file refused %s\n",
+                    changed ? "yes" : "no", (misfit && absent) ? "yes" : "no", (written && same) ? "yes" : "no",
+                    others ? "yes" : "no", truncated ? "yes" : "no");
+
+        return changed && misfit && absent && written && same && others && truncated;
+    }
+
+#pragma mark -
+#pragma mark Images
+
+    // Lit sphere with a checkered surface against a sky gradient
+    Image sphere(const uint32_t& size)
+    {
+        Image image = {"Sphere", size, size, std::vector<uint8_t>(size_t(size) * size * 4)};
+
+        const double radius = 0.4 * size;
+
+        for(uint32_t y = 0; y < size; ++y)
+        {
+            for(uint32_t x = 0; x < size; ++x)
+            {
+                uint8_t* pPixel = &image.pixels[(size_t(y) * size + x) * 4];
+
+                const double u = (x + 0.5 - 0.5 * size) / radius;
+                const double v = (y + 0.5 - 0.5 * size) / radius;
+                const double r = u * u + v * v;
+
+                double color[3] = {0.35 + 0.3 * y / size, 0.55 + 0.25 * y / size, 0.9};
+
+                if(r < 1.0)
+                {
+                    const double w       = std::sqrt(1.0 - r);
+                    const double diffuse = std::max(0.0, -0.4 * u - 0.5 * v + 0.77 * w);
+                    const double shine   = std::pow(std::max(0.0, -0.2 * u - 0.25 * v + 0.95 * w), 40.0);
+
+                    const bool checker = ((int(std::floor(4.0 * std::atan2(u, w))) + int(std::floor(6.0 * v))) & 1) != 0;
+
+                    const double albedo[3] = {checker ? 0.9 : 0.7, checker ? 0.45 : 0.2, checker ? 0.1 : 0.15};
+
+                    for(int c = 0; c < 3; ++c)
+                    {
+                        color[c] = 0.08 + albedo[c] * diffuse + shine;
+                    }
+                }
+
+                for(int c = 0; c < 3; ++c)
+                {
+                    pPixel[c] = saturate(255.0 * color[c]);
+                }
+
+                pPixel[3] = 255;
+            }
+        }
+
+        return image;
+    }
+
+    // Tangent space normals of overlapping waves and bumps
+    Image normalMap(const uint32_t& size)
+    {
+        Image image = {"Normals", size, size, std::vector<uint8_t>(size_t(size) * size * 4)};
+
+        auto height = [size](const double& x, const double& y)
+        {
+            const double u = 2.0 * x / size - 1.0;
+            const double v = 2.0 * y / size - 1.0;
+
+            double h = 0.02 * std::sin(23.0 * u + 3.0 * v) + 0.015 * std::cos(31.0 * v - 7.0 * u);
+
+            for(int i = 0; i < 7; ++i)
+            {
+                const double cu = std::sin(2.1 * i + 0.3);
+                const double cv = std::cos(1.3 * i + 0.7);
+
+                h += 0.1 * std::exp(-((u - cu) * (u - cu) + (v - cv) * (v - cv)) * 40.0);
+            }
+
+            return h * size;
+        };
+
+        for(uint32_t y = 0; y < size; ++y)
+        {
+            for(uint32_t x = 0; x < size; ++x)
+            {
+                uint8_t* pPixel = &image.pixels[(size_t(y) * size + x) * 4];
+
+                const double dx = 0.5 * (height(x + 1.0, y) - height(x - 1.0, y));
+                const double dy = 0.5 * (height(x, y + 1.0) - height(x, y - 1.0));
+                const double n  = std::sqrt(dx * dx + dy * dy + 1.0);
+
+                pPixel[0] = saturate(127.5 - 127.5 * dx / n);
+                pPixel[1] = saturate(127.5 - 127.5 * dy / n);
+                pPixel[2] = saturate(127.5 + 127.5 / n);
+                pPixel[3] = 255;
+            }
+        }
+
+        return image;
+    }
+
+    // Gradients with a noisy alpha wave, at a size that leaves partial blocks on both edges
+    Image gradient(const uint32_t& width, const uint32_t& height)
+    {
+        Image image = {"Gradient", width, height, std::vector<uint8_t>(size_t(width) * height * 4)};
+
+        uint32_t state = 7;
+
+        for(uint32_t y = 0; y < height; ++y)
+        {
+            for(uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* pPixel = &image.pixels[(size_t(y) * width + x) * 4];
+
+                const double noise = double(next(state) % 17) - 8.0;
+
+                pPixel[0] = uint8_t(x * 255 / (width - 1));
+                pPixel[1] = uint8_t(y * 255 / (height - 1));
+                pPixel[2] = uint8_t((x + y) % 256);
+                pPixel[3] = saturate(128.0 + 127.0 * std::sin(x / 17.0) * std::cos(y / 23.0) + noise);
+            }
+        }
+
+        return image;
+    }
+
+    bool load(const char* pPath, const uint32_t& width, const uint32_t& height, Image& rImage)
+    {
+        rImage.name   = pPath;
+        rImage.width  = width;
+        rImage.height = height;
+
+        rImage.pixels.resize(size_t(width) * height * 4);
+
+        FILE* pFile = std::fopen(pPath, "rb");
+
+        if(!pFile)
+        {
+            return false;
+        }
+
+        const bool result = std::fread(rImage.pixels.data(), 1, rImage.pixels.size(), pFile) == rImage.pixels.size();
+
+        std::fclose(pFile);
+
+        return result;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    std::vector<Image> images;
+
+    if(argc >= 4)
+    {
+        for(int i = 1; i + 2 < argc; i += 3)
+        {
+            Image image;
+
+            const uint32_t width  = uint32_t(std::strtoul(argv[i + 1], nullptr, 10));
+            const uint32_t height = uint32_t(std::strtoul(argv[i + 2], nullptr, 10));
+
+            if((width == 0) || (height == 0) || !load(argv[i], width, height, image))
+            {
+                std::printf("Couldn't read %ux%u RGBA8 pixels from %s\n", width, height, argv[i]);
+
+                return 1;
+            }
+
+            images.push_back(image);
+        }
+    }
+    else
+    {
+        images.push_back(sphere(512));
+        images.push_back(normalMap(512));
+        images.push_back(gradient(513, 259));
+    }
+
+    bool passed = checkBlocks();
+
+    Threads::WorkStealingPool pool;
+
+    for(const Image& image : images)
+    {
+        passed = run(image, pool) && passed;
+    }
+
+    passed = checkCache(images.back()) && passed;
+
+    return passed ? 0 : 1;
+}
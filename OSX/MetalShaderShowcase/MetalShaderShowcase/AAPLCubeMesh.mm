@@ -7,234 +7,7 @@
  */
 
 #import "AAPLCubeMesh.h"
-
-const int num_cube_indices = 36;
-const int num_cube_vertices = 24;
-const int num_cube_normals = 24;
-const int num_cube_uvs = 24;
-
-float cube_vertices[] = {
-    //Left
-    -1, -1, -1,
-    -1, 1, -1,
-    -1, 1, 1,
-    -1, -1, 1,
-    
-    //Right
-    1, -1, 1,
-    1, 1, 1,
-    1, 1, -1,
-    1, -1, -1,
-    
-    //Bottom
-    -1, -1, -1,
-    -1, -1, 1,
-    1, -1, 1,
-    1, -1, -1,
-    
-    //Top
-    -1, 1, -1,
-    1, 1, -1,
-    1, 1, 1,
-    -1, 1, 1,
-    
-    //Back
-    1, -1, -1,
-    1, 1, -1,
-    -1, 1, -1,
-    -1, -1, -1,
-    
-    //Front
-    -1, -1, 1,
-    -1, 1, 1,
-    1, 1, 1,
-    1, -1, 1
-};
-
-float cube_uvs[] = {
-    //Left
-    0, 0,
-    0, 1,
-    1, 1,
-    1, 0,
-    
-    //Right
-    0, 0,
-    0, 1,
-    1, 1,
-    1, 0,
-    
-    //Bottom
-    0, 0,
-    0, 1,
-    1, 1,
-    1, 0,
-    
-    //Top
-    0, 0,
-    0, 1,
-    1, 1,
-    1, 0,
-    
-    //Back
-    0, 0,
-    0, 1,
-    1, 1,
-    1, 0,
-    
-    //Front
-    0, 0,
-    0, 1,
-    1, 1,
-    1, 0,
-};
-
-short cube_indices[] = {
-    //Left
-    0, 1, 2,
-    0, 2, 3,
-    
-    //Right
-    4, 5, 6,
-    4, 6, 7,
-    
-    //Bottom
-    8, 9, 10,
-    8, 10, 11,
-    
-    //Top
-    12, 13, 14,
-    12, 14, 15,
-    
-    //Back
-    16, 17, 18,
-    16, 18, 19,
-    
-    //Front
-    20, 21, 22,
-    20, 22, 23
-};
-
-float cube_tangents[] = {
-    //Left
-    0, 0, 1,
-    0, 0, 1,
-    0, 0, 1,
-    0, 0, 1,
-    
-    //Right
-    0, 0, -1,
-    0, 0, -1,
-    0, 0, -1,
-    0, 0, -1,
-    
-    //Bottom
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    
-    //Top
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    
-    //Back
-    -1, 0, 0,
-    -1, 0, 0,
-    -1, 0, 0,
-    -1, 0, 0,
-    
-    //Front
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0
-};
-
-float cube_bitangents[] = {
-    //Left
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    
-    //Right
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    
-    //Bottom
-    0, 0, 1,
-    0, 0, 1,
-    0, 0, 1,
-    0, 0, 1,
-    
-    //Top
-    0, 0, -1,
-    0, 0, -1,
-    0, 0, -1,
-    0, 0, -1,
-    
-    //Back
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    
-    //Front
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0
-};
-
-float cube_normals[] = {
-    //Left
-    -1, 0, 0,
-    -1, 0, 0,
-    -1, 0, 0,
-    -1, 0, 0,
-    
-    //Right
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    1, 0, 0,
-    
-    //Bottom
-    0, -1, 0,
-    0, -1, 0,
-    0, -1, 0,
-    0, -1, 0,
-    
-    //Top
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    0, 1, 0,
-    
-    //Back
-    0, 0, -1,
-    0, 0, -1,
-    0, 0, -1,
-    0, 0, -1,
-    
-    //Front
-    0, 0, 1,
-    0, 0, 1,
-    0, 0, 1,
-    0, 0, 1
-};
-
-unsigned int sizeof_cube_vertices = sizeof(cube_vertices);
-unsigned int sizeof_cube_normals = sizeof(cube_normals);
-unsigned int sizeof_cube_uvs = sizeof(cube_uvs);
-unsigned int sizeof_cube_indices = sizeof(cube_indices);
-unsigned int sizeof_cube_tangents = sizeof(cube_tangents);
-unsigned int sizeof_cube_bitangents = sizeof(cube_bitangents);
+#import "AAPLMeshAsset.h"
 
 
 @interface AAPLCubeMesh ()
@@ -260,38 +33,73 @@ unsigned int sizeof_cube_bitangents = sizeof(cube_bitangents);
 {
     self = [super init];
     
-    self.vertex_buffer = [device newBufferWithBytes:cube_vertices  length:sizeof_cube_vertices  options:MTLResourceOptionCPUCacheModeDefault];
+    // All five attributes and triangle list indices (cube.amesh, see AAPLMeshAsset.h); the cube's
+    // components are all -1, 0 or 1 and quantise exactly
+    NSString *path = [[NSBundle mainBundle] pathForResource:@"cube" ofType:@"amesh"];
+    NSData *asset = path ? [NSData dataWithContentsOfFile:path] : nil;
+    
+    const uint16_t attributes = AAPL::MeshAsset::eAttributeNormal | AAPL::MeshAsset::eAttributeUV
+                              | AAPL::MeshAsset::eAttributeTangent | AAPL::MeshAsset::eAttributeBitangent;
+    
+    AAPL::MeshAsset::Header header;
+    
+    if(!asset || !AAPL::MeshAsset::header(asset.bytes, asset.length, header) || (header.indexSize != 2)
+       || ((header.attributes & attributes) != attributes))
+    {
+        NSLog(@">> ERROR: Failed to load the cube mesh asset");
+        
+        return nil;
+    }
+    
+    // Decode straight into the packed_float3 and float2 streams the shaders read
+    self.vertex_buffer = [device newBufferWithLength:header.vertexCount * 3 * sizeof(float) options:MTLResourceOptionCPUCacheModeDefault];
     self.vertex_buffer.label = @"Vertices";
     
-    self.normal_buffer = [device newBufferWithBytes:cube_normals  length:sizeof_cube_normals  options:MTLResourceOptionCPUCacheModeDefault];
+    self.normal_buffer = [device newBufferWithLength:header.vertexCount * 3 * sizeof(float) options:MTLResourceOptionCPUCacheModeDefault];
     self.normal_buffer.label = @"Normals";
     
-    self.tangents_buffer = [device newBufferWithBytes:cube_tangents  length:sizeof_cube_tangents  options:MTLResourceOptionCPUCacheModeDefault];
+    self.tangents_buffer = [device newBufferWithLength:header.vertexCount * 3 * sizeof(float) options:MTLResourceOptionCPUCacheModeDefault];
     self.tangents_buffer.label = @"Tangents";
     
-    self.bitangents_buffer = [device newBufferWithBytes:cube_bitangents  length:sizeof_cube_bitangents  options:MTLResourceOptionCPUCacheModeDefault];
+    self.bitangents_buffer = [device newBufferWithLength:header.vertexCount * 3 * sizeof(float) options:MTLResourceOptionCPUCacheModeDefault];
     self.bitangents_buffer.label = @"Bitangents";
     
-    self.uv_buffer = [device newBufferWithBytes:cube_uvs  length:sizeof_cube_uvs  options:MTLResourceOptionCPUCacheModeDefault];
+    self.uv_buffer = [device newBufferWithLength:header.vertexCount * 2 * sizeof(float) options:MTLResourceOptionCPUCacheModeDefault];
     self.uv_buffer.label = @"UVs";
     
-    self.index_buffer = [device newBufferWithBytes:cube_indices  length:sizeof_cube_indices  options:MTLResourceOptionCPUCacheModeDefault];
+    self.index_buffer = [device newBufferWithLength:header.indexCount * sizeof(short) options:MTLResourceOptionCPUCacheModeDefault];
     self.index_buffer.label = @"Indices";
     
-    self.index_count = num_cube_indices;
-    self.vertex_count = num_cube_vertices;
+    AAPL::MeshAsset::Layout layout;
+    
+    layout.positions  = {self.vertex_buffer.contents, 3 * sizeof(float)};
+    layout.normals    = {self.normal_buffer.contents, 3 * sizeof(float)};
+    layout.tangents   = {self.tangents_buffer.contents, 3 * sizeof(float)};
+    layout.bitangents = {self.bitangents_buffer.contents, 3 * sizeof(float)};
+    layout.uvs        = {self.uv_buffer.contents, 2 * sizeof(float)};
+    layout.pIndices   = self.index_buffer.contents;
+    
+    if(!AAPL::MeshAsset::decode(asset.bytes, asset.length, layout))
+    {
+        NSLog(@">> ERROR: Failed to decode the cube mesh asset");
+        
+        return nil;
+    }
+    
+    self.index_count = header.indexCount;
+    self.vertex_count = header.vertexCount;
     self.primitive_type = MTLPrimitiveTypeTriangle;
     
     self.translate_x = 0.0f;
     self.translate_y = 0.0f;
     self.translate_z = 6.0f;
     
-    self.indices = cube_indices;
-    self.vertices = cube_vertices;
-    self.normals = cube_normals;
-    self.uvs = cube_uvs;
-    self.tangents = cube_tangents;
-    self.bitangents = cube_bitangents;
+    self.indices = (short *)self.index_buffer.contents;
+    self.vertices = (float *)self.vertex_buffer.contents;
+    self.normals = (float *)self.normal_buffer.contents;
+    self.uvs = (float *)self.uv_buffer.contents;
+    self.tangents = (float *)self.tangents_buffer.contents;
+    self.bitangents = (float *)self.bitangents_buffer.contents;
     
     return self;
 }
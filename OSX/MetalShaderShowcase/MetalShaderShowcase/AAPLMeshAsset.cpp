@@ -0,0 +1,1153 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Compact binary mesh asset. Positions are stored as 16-bit integers normalised to the mesh bounds,
+ normals, tangents and bitangents as 16-bit octahedral pairs, texture coordinates as 16-bit
+ integers normalised to their range, and indices as zigzag deltas in variable length bytes. The
+ decoder writes each attribute straight into a caller supplied layout (separate streams or one
+ interleaved vertex), four vertices at a time with SIMD.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#include "AAPLMeshAsset.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+// Assets are read and written in host byte order; every Apple platform is little endian
+static_assert(sizeof(AAPL::MeshAsset::Header) == 64, "Mesh asset header must be 64 bytes");
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace AAPL
+{
+    namespace MeshAsset
+    {
+        // Four vertices per register
+        struct float4
+        {
+#if defined(__SSE2__)
+            __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            float32x4_t v;
+#else
+            float v[4];
+#endif
+        };
+
+#if defined(__SSE2__)
+        static inline float4 unorm16(const uint16_t* p)
+        {
+            const __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+
+            return {_mm_cvtepi32_ps(_mm_unpacklo_epi16(q, _mm_setzero_si128()))};
+        }
+
+        static inline float4 snorm16(const int16_t* p)
+        {
+            const __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+
+            return {_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(q, q), 16))};
+        }
+
+        static inline float4 splat(const float& s)                       { return {_mm_set1_ps(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {_mm_sub_ps(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+        static inline float4 max(const float4& a, const float4& b)       { return {_mm_max_ps(a.v, b.v)}; }
+        static inline float4 abs(const float4& a)                        { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+
+        // |a| with the sign of b
+        static inline float4 copysign(const float4& a, const float4& b)
+        {
+            const __m128 sign = _mm_set1_ps(-0.0f);
+
+            return {_mm_or_ps(_mm_andnot_ps(sign, a.v), _mm_and_ps(sign, b.v))};
+        }
+
+        static inline float4 rsqrt(const float4& a)
+        {
+            return {_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a.v))};
+        }
+
+        static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+        {
+            _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+        }
+
+        // First three lanes, without touching the fourth float after p
+        static inline void store3(float* p, const float4& a)
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(p), a.v);
+            _mm_store_ss(p + 2, _mm_movehl_ps(a.v, a.v));
+        }
+
+        static inline void store2(float* p, const float4& a)
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(p), a.v);
+        }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        static inline float4 unorm16(const uint16_t* p) { return {vcvtq_f32_u32(vmovl_u16(vld1_u16(p)))}; }
+        static inline float4 snorm16(const int16_t* p)  { return {vcvtq_f32_s32(vmovl_s16(vld1_s16(p)))}; }
+
+        static inline float4 splat(const float& s)                       { return {vdupq_n_f32(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {vsubq_f32(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+        static inline float4 max(const float4& a, const float4& b)       { return {vmaxq_f32(a.v, b.v)}; }
+        static inline float4 abs(const float4& a)                        { return {vabsq_f32(a.v)}; }
+
+        static inline float4 copysign(const float4& a, const float4& b)
+        {
+            return {vbslq_f32(vdupq_n_u32(0x80000000), b.v, vabsq_f32(a.v))};
+        }
+
+        // Estimate refined by two Newton-Raphson steps
+        static inline float4 rsqrt(const float4& a)
+        {
+            float32x4_t e = vrsqrteq_f32(a.v);
+
+            e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a.v, e), e));
+            e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a.v, e), e));
+
+            return {e};
+        }
+
+        static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+        {
+            const float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+            const float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+
+            a.v = vcombine_f32(vget_low_f32(ab.val[0]),  vget_low_f32(cd.val[0]));
+            b.v = vcombine_f32(vget_low_f32(ab.val[1]),  vget_low_f32(cd.val[1]));
+            c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+            d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+        }
+
+        static inline void store3(float* p, const float4& a)
+        {
+            vst1_f32(p, vget_low_f32(a.v));
+            vst1q_lane_f32(p + 2, a.v, 2);
+        }
+
+        static inline void store2(float* p, const float4& a)
+        {
+            vst1_f32(p, vget_low_f32(a.v));
+        }
+#else
+        static inline float4 unorm16(const uint16_t* p) { return {{float(p[0]), float(p[1]), float(p[2]), float(p[3])}}; }
+        static inline float4 snorm16(const int16_t* p)  { return {{float(p[0]), float(p[1]), float(p[2]), float(p[3])}}; }
+
+        static inline float4 splat(const float& s) { return {{s, s, s, s}}; }
+
+        static inline float4 operator+(const float4& a, const float4& b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+
+        static inline float4 max(const float4& a, const float4& b)
+        {
+            return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+        }
+
+        static inline float4 abs(const float4& a)
+        {
+            return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}};
+        }
+
+        static inline float4 copysign(const float4& a, const float4& b)
+        {
+            return {{std::copysign(a.v[0], b.v[0]), std::copysign(a.v[1], b.v[1]), std::copysign(a.v[2], b.v[2]), std::copysign(a.v[3], b.v[3])}};
+        }
+
+        static inline float4 rsqrt(const float4& a)
+        {
+            return {{1.0f / std::sqrt(a.v[0]), 1.0f / std::sqrt(a.v[1]), 1.0f / std::sqrt(a.v[2]), 1.0f / std::sqrt(a.v[3])}};
+        }
+
+        static inline void transpose(float4& a, float4& b, float4& c, float4& d)
+        {
+            for(size_t i = 0; i < 4; ++i)
+            {
+                for(size_t j = i + 1; j < 4; ++j)
+                {
+                    float4* rows[4] = {&a, &b, &c, &d};
+
+                    std::swap(rows[i]->v[j], rows[j]->v[i]);
+                }
+            }
+        }
+
+        static inline void store3(float* p, const float4& a) { std::memcpy(p, a.v, 3 * sizeof(float)); }
+        static inline void store2(float* p, const float4& a) { std::memcpy(p, a.v, 2 * sizeof(float)); }
+#endif
+    } // MeshAsset
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Quantisation
+
+namespace AAPL
+{
+    namespace MeshAsset
+    {
+        static const float kUnorm16 = 65535.0f;
+        static const float kSnorm16 = 32767.0f;
+
+        // Planes of vertexCount 16-bit values per attribute
+        static size_t planes(const uint16_t& attribute)
+        {
+            switch(attribute)
+            {
+                case eAttributePosition:
+                    return 3;
+
+                case eAttributeNormal:
+                case eAttributeUV:
+                case eAttributeTangent:
+                case eAttributeBitangent:
+                    return 2;
+
+                default:
+                    return 0;
+            }
+        }
+
+        static const uint16_t kAttributes[] =
+        {
+            eAttributePosition, eAttributeNormal, eAttributeUV, eAttributeTangent, eAttributeBitangent
+        };
+
+        static uint16_t quantiseUnorm(const float& value, const float& min, const float& extent)
+        {
+            if(extent <= 0.0f)
+            {
+                return 0;
+            }
+
+            const float q = std::round((value - min) / extent * kUnorm16);
+
+            return uint16_t(std::min(std::max(q, 0.0f), kUnorm16));
+        }
+
+        static void octahedral(const float* pVector, float& rU, float& rV)
+        {
+            const float length = std::fabs(pVector[0]) + std::fabs(pVector[1]) + std::fabs(pVector[2]);
+
+            if(length <= 0.0f)
+            {
+                rU = 0.0f;
+                rV = 0.0f;
+
+                return;
+            }
+
+            const float x = pVector[0] / length;
+            const float y = pVector[1] / length;
+
+            if(pVector[2] >= 0.0f)
+            {
+                rU = x;
+                rV = y;
+            }
+            else
+            {
+                rU = (1.0f - std::fabs(y)) * std::copysign(1.0f, x);
+                rV = (1.0f - std::fabs(x)) * std::copysign(1.0f, y);
+            }
+        }
+
+        static void unoctahedral(const float& u, const float& v, float* pVector)
+        {
+            float x = u;
+            float y = v;
+
+            const float z = 1.0f - std::fabs(x) - std::fabs(y);
+            const float t = std::max(-z, 0.0f);
+
+            x -= std::copysign(t, x);
+            y -= std::copysign(t, y);
+
+            const float scale = 1.0f / std::sqrt(x * x + y * y + z * z);
+
+            pVector[0] = x * scale;
+            pVector[1] = y * scale;
+            pVector[2] = z * scale;
+        }
+
+        // Of the four snorm16 pairs around the exact encoding, the one decoding closest to the vector
+        static void quantiseOctahedral(const float* pVector, int16_t& rU, int16_t& rV)
+        {
+            float u = 0.0f;
+            float v = 0.0f;
+
+            octahedral(pVector, u, v);
+
+            const float fu = std::floor(u * kSnorm16);
+            const float fv = std::floor(v * kSnorm16);
+
+            float best = -2.0f;
+
+            for(int i = 0; i < 4; ++i)
+            {
+                const float qu = std::min(std::max(fu + float(i & 1), -kSnorm16), kSnorm16);
+                const float qv = std::min(std::max(fv + float(i >> 1), -kSnorm16), kSnorm16);
+
+                float decoded[3];
+
+                unoctahedral(qu / kSnorm16, qv / kSnorm16, decoded);
+
+                const float cosine = decoded[0] * pVector[0] + decoded[1] * pVector[1] + decoded[2] * pVector[2];
+
+                if(cosine > best)
+                {
+                    best = cosine;
+                    rU   = int16_t(qu);
+                    rV   = int16_t(qv);
+                }
+            }
+        }
+
+        static const std::vector<float>& attribute(const Mesh& rMesh, const uint16_t& attribute)
+        {
+            switch(attribute)
+            {
+                case eAttributeNormal:    return rMesh.normals;
+                case eAttributeUV:        return rMesh.uvs;
+                case eAttributeTangent:   return rMesh.tangents;
+                case eAttributeBitangent: return rMesh.bitangents;
+                default:                  return rMesh.positions;
+            }
+        }
+
+        static const Stream& stream(const Layout& rLayout, const uint16_t& attribute)
+        {
+            switch(attribute)
+            {
+                case eAttributeNormal:    return rLayout.normals;
+                case eAttributeUV:        return rLayout.uvs;
+                case eAttributeTangent:   return rLayout.tangents;
+                case eAttributeBitangent: return rLayout.bitangents;
+                default:                  return rLayout.positions;
+            }
+        }
+    } // MeshAsset
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Indices
+
+namespace AAPL
+{
+    namespace MeshAsset
+    {
+        // Strips are predicted from the index two back (the other end of the shared edge), lists
+        // from the same corner of the previous triangle. Code 0 restarts a strip, any other code
+        // is the zigzag delta to the prediction plus one.
+        static size_t predictionLag(const uint8_t& primitive)
+        {
+            return (primitive == ePrimitiveTriangleStrip) ? 2 : 3;
+        }
+
+        static void writeVarint(uint64_t value, std::vector<uint8_t>& rBytes)
+        {
+            while(value >= 0x80)
+            {
+                rBytes.push_back(uint8_t(value | 0x80));
+
+                value >>= 7;
+            }
+
+            rBytes.push_back(uint8_t(value));
+        }
+
+        static void encodeIndices(const Mesh& rMesh, std::vector<uint8_t>& rBytes)
+        {
+            const size_t lag = predictionLag(uint8_t(rMesh.primitive));
+
+            uint32_t history[3] = {0, 0, 0};
+
+            for(uint32_t index : rMesh.indices)
+            {
+                if(index == kRestartIndex)
+                {
+                    rBytes.push_back(0);
+
+                    continue;
+                }
+
+                const int64_t delta = int64_t(index) - int64_t(history[lag - 1]);
+
+                writeVarint((delta >= 0) ? (uint64_t(delta) << 1) + 1 : (uint64_t(-delta) << 1), rBytes);
+
+                history[2] = history[1];
+                history[1] = history[0];
+                history[0] = index;
+            }
+        }
+
+        // Indices are validated against the vertex count, so a corrupt stream never yields an
+        // out of range vertex fetch
+        template <typename T, size_t lag>
+        static bool decodeIndices(const uint8_t* pBytes, const size_t& size, const Header& rHeader, T* pIndices)
+        {
+            const uint8_t* pEnd = pBytes + size;
+
+            const uint32_t count       = rHeader.indexCount;
+            const uint32_t vertexCount = rHeader.vertexCount;
+
+            uint32_t history[3] = {0, 0, 0};
+
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                if(pBytes == pEnd)
+                {
+                    return false;
+                }
+
+                uint32_t code = *pBytes++;
+
+                // Most deltas fit one byte
+                if(code & 0x80)
+                {
+                    code &= 0x7f;
+
+                    for(uint32_t shift = 7; ; shift += 7)
+                    {
+                        if((pBytes == pEnd) || (shift > 28))
+                        {
+                            return false;
+                        }
+
+                        const uint32_t byte = *pBytes++;
+
+                        code |= (byte & 0x7f) << shift;
+
+                        if(!(byte & 0x80))
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                if(code == 0)
+                {
+                    pIndices[i] = T(kRestartIndex);
+
+                    continue;
+                }
+
+                // Wraps around for negative deltas; anything past the vertex count is rejected
+                const uint32_t delta = (code & 1) ? (code >> 1) : (0u - (code >> 1));
+                const uint32_t index = history[lag - 1] + delta;
+
+                if(index >= vertexCount)
+                {
+                    return false;
+                }
+
+                pIndices[i] = T(index);
+
+                history[2] = history[1];
+                history[1] = history[0];
+                history[0] = index;
+            }
+
+            return pBytes == pEnd;
+        }
+
+        static bool decodeIndices(const uint8_t* pBytes,
+                                  const size_t& size,
+                                  const Header& rHeader,
+                                  const uint32_t& indexSize,
+                                  void* pIndices)
+        {
+            const bool strip = (predictionLag(rHeader.primitive) == 2);
+
+            if(indexSize == 2)
+            {
+                uint16_t* pShort = static_cast<uint16_t*>(pIndices);
+
+                return strip ? decodeIndices<uint16_t, 2>(pBytes, size, rHeader, pShort)
+                             : decodeIndices<uint16_t, 3>(pBytes, size, rHeader, pShort);
+            }
+
+            uint32_t* pLong = static_cast<uint32_t*>(pIndices);
+
+            return strip ? decodeIndices<uint32_t, 2>(pBytes, size, rHeader, pLong)
+                         : decodeIndices<uint32_t, 3>(pBytes, size, rHeader, pLong);
+        }
+    } // MeshAsset
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Vertices
+
+namespace AAPL
+{
+    namespace MeshAsset
+    {
+        // Vertices decoded per pass over the attributes, so every attribute of an interleaved
+        // vertex is written while its cache line is still resident
+        static const size_t kBlockVertices = 256;
+
+        static inline float* address(const Stream& rStream, const size_t& vertex)
+        {
+            return reinterpret_cast<float*>(static_cast<uint8_t*>(rStream.pData) + vertex * rStream.stride);
+        }
+
+        static void decodePositions(const uint16_t* pPlanes,
+                                    const Header& rHeader,
+                                    const Stream& rStream,
+                                    const size_t& first,
+                                    const size_t& last)
+        {
+            const size_t count = rHeader.vertexCount;
+
+            const uint16_t* pX = pPlanes;
+            const uint16_t* pY = pPlanes + count;
+            const uint16_t* pZ = pPlanes + 2 * count;
+
+            float min[3];
+            float scale[3];
+
+            for(size_t axis = 0; axis < 3; ++axis)
+            {
+                min[axis]   = rHeader.positionMin[axis];
+                scale[axis] = (rHeader.positionMax[axis] - rHeader.positionMin[axis]) / kUnorm16;
+            }
+
+            const float4 minX = splat(min[0]), minY = splat(min[1]), minZ = splat(min[2]);
+            const float4 scaleX = splat(scale[0]), scaleY = splat(scale[1]), scaleZ = splat(scale[2]);
+
+            size_t i = first;
+
+            for(; i + 4 <= last; i += 4)
+            {
+                float4 x = minX + unorm16(pX + i) * scaleX;
+                float4 y = minY + unorm16(pY + i) * scaleY;
+                float4 z = minZ + unorm16(pZ + i) * scaleZ;
+                float4 w = splat(0.0f);
+
+                transpose(x, y, z, w);
+
+                store3(address(rStream, i),     x);
+                store3(address(rStream, i + 1), y);
+                store3(address(rStream, i + 2), z);
+                store3(address(rStream, i + 3), w);
+            }
+
+            for(; i < last; ++i)
+            {
+                float* pOut = address(rStream, i);
+
+                pOut[0] = min[0] + float(pX[i]) * scale[0];
+                pOut[1] = min[1] + float(pY[i]) * scale[1];
+                pOut[2] = min[2] + float(pZ[i]) * scale[2];
+            }
+        }
+
+        static void decodeOctahedral(const uint16_t* pPlanes,
+                                     const Header& rHeader,
+                                     const Stream& rStream,
+                                     const size_t& first,
+                                     const size_t& last)
+        {
+            const int16_t* pU = reinterpret_cast<const int16_t*>(pPlanes);
+            const int16_t* pV = pU + rHeader.vertexCount;
+
+            const float4 one   = splat(1.0f);
+            const float4 zero  = splat(0.0f);
+            const float4 scale = splat(1.0f / kSnorm16);
+
+            size_t i = first;
+
+            for(; i + 4 <= last; i += 4)
+            {
+                // -32768 decodes slightly past -1; the fold and normalisation absorb it
+                float4 x = snorm16(pU + i) * scale;
+                float4 y = snorm16(pV + i) * scale;
+                float4 z = one - abs(x) - abs(y);
+
+                const float4 t = max(zero - z, zero);
+
+                x = x - copysign(t, x);
+                y = y - copysign(t, y);
+
+                const float4 length = rsqrt(x * x + y * y + z * z);
+
+                x = x * length;
+                y = y * length;
+                z = z * length;
+
+                float4 w = zero;
+
+                transpose(x, y, z, w);
+
+                store3(address(rStream, i),     x);
+                store3(address(rStream, i + 1), y);
+                store3(address(rStream, i + 2), z);
+                store3(address(rStream, i + 3), w);
+            }
+
+            for(; i < last; ++i)
+            {
+                unoctahedral(float(pU[i]) / kSnorm16, float(pV[i]) / kSnorm16, address(rStream, i));
+            }
+        }
+
+        static void decodeUVs(const uint16_t* pPlanes,
+                              const Header& rHeader,
+                              const Stream& rStream,
+                              const size_t& first,
+                              const size_t& last)
+        {
+            const uint16_t* pU = pPlanes;
+            const uint16_t* pV = pPlanes + rHeader.vertexCount;
+
+            const float scaleU = (rHeader.uvMax[0] - rHeader.uvMin[0]) / kUnorm16;
+            const float scaleV = (rHeader.uvMax[1] - rHeader.uvMin[1]) / kUnorm16;
+
+            const float4 minU = splat(rHeader.uvMin[0]), minV = splat(rHeader.uvMin[1]);
+
+            size_t i = first;
+
+            for(; i + 4 <= last; i += 4)
+            {
+                float4 u = minU + unorm16(pU + i) * splat(scaleU);
+                float4 v = minV + unorm16(pV + i) * splat(scaleV);
+                float4 c = splat(0.0f);
+                float4 d = splat(0.0f);
+
+                transpose(u, v, c, d);
+
+                store2(address(rStream, i),     u);
+                store2(address(rStream, i + 1), v);
+                store2(address(rStream, i + 2), c);
+                store2(address(rStream, i + 3), d);
+            }
+
+            for(; i < last; ++i)
+            {
+                float* pOut = address(rStream, i);
+
+                pOut[0] = rHeader.uvMin[0] + float(pU[i]) * scaleU;
+                pOut[1] = rHeader.uvMin[1] + float(pV[i]) * scaleV;
+            }
+        }
+    } // MeshAsset
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Mesh
+
+AAPL::MeshAsset::Mesh::Mesh()
+: primitive(ePrimitiveTriangle),
+  indexSize(2)
+{
+}
+
+size_t AAPL::MeshAsset::Mesh::vertexCount() const
+{
+    return positions.size() / 3;
+}
+
+AAPL::MeshAsset::Layout::Layout()
+: positions{nullptr, 0},
+  normals{nullptr, 0},
+  uvs{nullptr, 0},
+  tangents{nullptr, 0},
+  bitangents{nullptr, 0},
+  pIndices(nullptr)
+{
+}
+
+#pragma mark -
+#pragma mark Public - Encoding
+
+std::vector<uint8_t> AAPL::MeshAsset::encode(const Mesh& rMesh)
+{
+    std::vector<uint8_t> asset;
+
+    const size_t count = rMesh.vertexCount();
+
+    if((count == 0) || (rMesh.positions.size() != 3 * count) || (count > 0x7fffffff))
+    {
+        return asset;
+    }
+
+    Header header;
+
+    std::memset(&header, 0, sizeof(header));
+
+    header.magic       = kMagic;
+    header.version     = kVersion;
+    header.vertexCount = uint32_t(count);
+    header.indexCount  = uint32_t(rMesh.indices.size());
+    header.primitive   = uint8_t(rMesh.primitive);
+
+    for(uint16_t flag : kAttributes)
+    {
+        const std::vector<float>& rValues = attribute(rMesh, flag);
+
+        if(rValues.empty())
+        {
+            continue;
+        }
+
+        const size_t components = (flag == eAttributeUV) ? 2 : 3;
+
+        if(rValues.size() != components * count)
+        {
+            return asset;
+        }
+
+        header.attributes |= flag;
+    }
+
+    // 16-bit indices reserve 0xffff for restarts
+    header.indexSize = uint8_t((rMesh.indexSize == 4) || (count > 0xffff) ? 4 : 2);
+
+    for(uint32_t index : rMesh.indices)
+    {
+        if((index != kRestartIndex) && (index >= count))
+        {
+            return asset;
+        }
+    }
+
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+        header.positionMin[axis] =  INFINITY;
+        header.positionMax[axis] = -INFINITY;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            header.positionMin[axis] = std::min(header.positionMin[axis], rMesh.positions[3 * i + axis]);
+            header.positionMax[axis] = std::max(header.positionMax[axis], rMesh.positions[3 * i + axis]);
+        }
+    }
+
+    if(!rMesh.uvs.empty())
+    {
+        for(size_t axis = 0; axis < 2; ++axis)
+        {
+            header.uvMin[axis] =  INFINITY;
+            header.uvMax[axis] = -INFINITY;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                header.uvMin[axis] = std::min(header.uvMin[axis], rMesh.uvs[2 * i + axis]);
+                header.uvMax[axis] = std::max(header.uvMax[axis], rMesh.uvs[2 * i + axis]);
+            }
+        }
+    }
+
+    std::vector<uint16_t> quantised;
+
+    for(uint16_t flag : kAttributes)
+    {
+        if(!(header.attributes & flag))
+        {
+            continue;
+        }
+
+        const std::vector<float>& rValues = attribute(rMesh, flag);
+
+        const size_t first = quantised.size();
+
+        quantised.resize(first + planes(flag) * count);
+
+        uint16_t* pPlanes = quantised.data() + first;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            if(flag == eAttributePosition)
+            {
+                for(size_t axis = 0; axis < 3; ++axis)
+                {
+                    const float extent = header.positionMax[axis] - header.positionMin[axis];
+
+                    pPlanes[axis * count + i] = quantiseUnorm(rValues[3 * i + axis], header.positionMin[axis], extent);
+                }
+            }
+            else if(flag == eAttributeUV)
+            {
+                for(size_t axis = 0; axis < 2; ++axis)
+                {
+                    const float extent = header.uvMax[axis] - header.uvMin[axis];
+
+                    pPlanes[axis * count + i] = quantiseUnorm(rValues[2 * i + axis], header.uvMin[axis], extent);
+                }
+            }
+            else
+            {
+                int16_t u = 0;
+                int16_t v = 0;
+
+                quantiseOctahedral(&rValues[3 * i], u, v);
+
+                pPlanes[i]         = uint16_t(u);
+                pPlanes[count + i] = uint16_t(v);
+            }
+        }
+    }
+
+    std::vector<uint8_t> indices;
+
+    encodeIndices(rMesh, indices);
+
+    header.indexBytes = uint32_t(indices.size());
+
+    asset.resize(sizeof(Header) + quantised.size() * sizeof(uint16_t) + indices.size());
+
+    std::memcpy(asset.data(), &header, sizeof(Header));
+    std::memcpy(asset.data() + sizeof(Header), quantised.data(), quantised.size() * sizeof(uint16_t));
+
+    if(!indices.empty())
+    {
+        std::memcpy(asset.data() + sizeof(Header) + quantised.size() * sizeof(uint16_t), indices.data(), indices.size());
+    }
+
+    return asset;
+}
+
+#pragma mark -
+#pragma mark Public - Decoding
+
+bool AAPL::MeshAsset::header(const void* pAsset, const size_t& size, Header& rHeader)
+{
+    if((pAsset == nullptr) || (size < sizeof(Header)))
+    {
+        return false;
+    }
+
+    std::memcpy(&rHeader, pAsset, sizeof(Header));
+
+    if((rHeader.magic != kMagic) || (rHeader.version != kVersion) || !(rHeader.attributes & eAttributePosition))
+    {
+        return false;
+    }
+
+    if((rHeader.primitive > ePrimitiveTriangleStrip) || ((rHeader.indexSize != 2) && (rHeader.indexSize != 4)))
+    {
+        return false;
+    }
+
+    // Every index takes at least one byte, so a larger count is corrupt; checked before the
+    // decoders size anything from it
+    if(rHeader.indexCount > rHeader.indexBytes)
+    {
+        return false;
+    }
+
+    uint64_t expected = sizeof(Header) + uint64_t(rHeader.indexBytes);
+
+    for(uint16_t flag : kAttributes)
+    {
+        if(rHeader.attributes & flag)
+        {
+            expected += uint64_t(planes(flag)) * rHeader.vertexCount * sizeof(uint16_t);
+        }
+    }
+
+    return expected == size;
+}
+
+bool AAPL::MeshAsset::decode(const void* pAsset, const size_t& size, const Layout& rLayout)
+{
+    Header header;
+
+    if(!MeshAsset::header(pAsset, size, header))
+    {
+        return false;
+    }
+
+    const uint16_t* pPlanes = reinterpret_cast<const uint16_t*>(static_cast<const uint8_t*>(pAsset) + sizeof(Header));
+
+    const uint16_t* pAttributes[5] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+
+    for(size_t k = 0; k < 5; ++k)
+    {
+        if(header.attributes & kAttributes[k])
+        {
+            pAttributes[k] = pPlanes;
+            pPlanes       += planes(kAttributes[k]) * header.vertexCount;
+        }
+    }
+
+    // Indices first, so a corrupt asset fails before any vertex is written
+    if(rLayout.pIndices != nullptr)
+    {
+        const uint8_t* pIndexBytes = reinterpret_cast<const uint8_t*>(pPlanes);
+
+        if(!decodeIndices(pIndexBytes, header.indexBytes, header, header.indexSize, rLayout.pIndices))
+        {
+            return false;
+        }
+    }
+
+    for(size_t first = 0; first < header.vertexCount; first += kBlockVertices)
+    {
+        const size_t last = std::min(first + kBlockVertices, size_t(header.vertexCount));
+
+        for(size_t k = 0; k < 5; ++k)
+        {
+            const Stream& rStream = stream(rLayout, kAttributes[k]);
+
+            if((pAttributes[k] == nullptr) || (rStream.pData == nullptr))
+            {
+                continue;
+            }
+
+            if(kAttributes[k] == eAttributePosition)
+            {
+                decodePositions(pAttributes[k], header, rStream, first, last);
+            }
+            else if(kAttributes[k] == eAttributeUV)
+            {
+                decodeUVs(pAttributes[k], header, rStream, first, last);
+            }
+            else
+            {
+                decodeOctahedral(pAttributes[k], header, rStream, first, last);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool AAPL::MeshAsset::decode(const void* pAsset, const size_t& size, Mesh& rMesh)
+{
+    Header header;
+
+    if(!MeshAsset::header(pAsset, size, header))
+    {
+        return false;
+    }
+
+    const size_t count = header.vertexCount;
+
+    rMesh           = Mesh();
+    rMesh.primitive = Primitive(header.primitive);
+    rMesh.indexSize = header.indexSize;
+
+    Layout layout;
+
+    rMesh.positions.resize(3 * count);
+
+    layout.positions = {rMesh.positions.data(), 3 * sizeof(float)};
+
+    if(header.attributes & eAttributeNormal)
+    {
+        rMesh.normals.resize(3 * count);
+
+        layout.normals = {rMesh.normals.data(), 3 * sizeof(float)};
+    }
+
+    if(header.attributes & eAttributeUV)
+    {
+        rMesh.uvs.resize(2 * count);
+
+        layout.uvs = {rMesh.uvs.data(), 2 * sizeof(float)};
+    }
+
+    if(header.attributes & eAttributeTangent)
+    {
+        rMesh.tangents.resize(3 * count);
+
+        layout.tangents = {rMesh.tangents.data(), 3 * sizeof(float)};
+    }
+
+    if(header.attributes & eAttributeBitangent)
+    {
+        rMesh.bitangents.resize(3 * count);
+
+        layout.bitangents = {rMesh.bitangents.data(), 3 * sizeof(float)};
+    }
+
+    if(!decode(pAsset, size, layout))
+    {
+        return false;
+    }
+
+    // Indices widened to 32 bits, restarts as kRestartIndex
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pAsset) + size - header.indexBytes;
+
+    rMesh.indices.resize(header.indexCount);
+
+    return decodeIndices(pBytes, header.indexBytes, header, 4, rMesh.indices.data());
+}
+
+#pragma mark -
+#pragma mark Public - OBJ
+
+bool AAPL::MeshAsset::readOBJ(const std::string& text, Mesh& rMesh)
+{
+    std::vector<float> positions;
+    std::vector<float> uvs;
+    std::vector<float> normals;
+
+    // Distinct position/uv/normal triples, -1 when a face omits the uv or normal
+    std::map<std::array<int64_t, 3>, uint32_t> vertices;
+
+    bool hasUVs     = false;
+    bool hasNormals = false;
+
+    rMesh = Mesh();
+
+    std::istringstream lines(text);
+    std::string        line;
+
+    while(std::getline(lines, line))
+    {
+        std::istringstream record(line);
+        std::string        type;
+
+        record >> type;
+
+        if(type == "v")
+        {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+
+            record >> x >> y >> z;
+
+            positions.insert(positions.end(), {x, y, z});
+        }
+        else if(type == "vt")
+        {
+            float u = 0.0f, v = 0.0f;
+
+            record >> u >> v;
+
+            uvs.insert(uvs.end(), {u, v});
+        }
+        else if(type == "vn")
+        {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+
+            record >> x >> y >> z;
+
+            normals.insert(normals.end(), {x, y, z});
+        }
+        else if(type == "f")
+        {
+            std::vector<uint32_t> polygon;
+            std::string           corner;
+
+            while(record >> corner)
+            {
+                // v, v/vt, v//vn or v/vt/vn; negative references count back from the last record
+                std::array<int64_t, 3> key = {{-1, -1, -1}};
+
+                const size_t counts[3] = {positions.size() / 3, uvs.size() / 2, normals.size() / 3};
+                size_t       start     = 0;
+
+                for(size_t k = 0; k < 3; ++k)
+                {
+                    const size_t end   = corner.find('/', start);
+                    const std::string field = corner.substr(start, (end == std::string::npos) ? std::string::npos : end - start);
+
+                    if(!field.empty())
+                    {
+                        const int64_t reference = std::strtoll(field.c_str(), nullptr, 10);
+                        const int64_t index     = (reference < 0) ? int64_t(counts[k]) + reference : reference - 1;
+
+                        if((index < 0) || (index >= int64_t(counts[k])))
+                        {
+                            return false;
+                        }
+
+                        key[k] = index;
+                    }
+
+                    if(end == std::string::npos)
+                    {
+                        break;
+                    }
+
+                    start = end + 1;
+                }
+
+                if(key[0] < 0)
+                {
+                    return false;
+                }
+
+                hasUVs     = hasUVs     || (key[1] >= 0);
+                hasNormals = hasNormals || (key[2] >= 0);
+
+                const auto found = vertices.find(key);
+
+                if(found != vertices.end())
+                {
+                    polygon.push_back(found->second);
+
+                    continue;
+                }
+
+                const uint32_t vertex = uint32_t(vertices.size());
+
+                vertices.emplace(key, vertex);
+                polygon.push_back(vertex);
+            }
+
+            for(size_t k = 2; k < polygon.size(); ++k)
+            {
+                rMesh.indices.insert(rMesh.indices.end(), {polygon[0], polygon[k - 1], polygon[k]});
+            }
+        }
+    }
+
+    if(vertices.empty())
+    {
+        return false;
+    }
+
+    rMesh.positions.resize(3 * vertices.size());
+
+    if(hasUVs)
+    {
+        rMesh.uvs.assign(2 * vertices.size(), 0.0f);
+    }
+
+    if(hasNormals)
+    {
+        rMesh.normals.assign(3 * vertices.size(), 0.0f);
+    }
+
+    for(const auto& rVertex : vertices)
+    {
+        const std::array<int64_t, 3>& rKey = rVertex.first;
+        const size_t                  i    = rVertex.second;
+
+        std::copy(&positions[3 * rKey[0]], &positions[3 * rKey[0]] + 3, &rMesh.positions[3 * i]);
+
+        if(hasUVs && (rKey[1] >= 0))
+        {
+            std::copy(&uvs[2 * rKey[1]], &uvs[2 * rKey[1]] + 2, &rMesh.uvs[2 * i]);
+        }
+
+        if(hasNormals && (rKey[2] >= 0))
+        {
+            std::copy(&normals[3 * rKey[2]], &normals[3 * rKey[2]] + 3, &rMesh.normals[3 * i]);
+        }
+    }
+
+    rMesh.primitive = ePrimitiveTriangle;
+    rMesh.indexSize = (vertices.size() > 0xffff) ? 4 : 2;
+
+    return true;
+}
@@ -0,0 +1,127 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Compact binary mesh asset. Positions are stored as 16-bit integers normalised to the mesh bounds,
+ normals, tangents and bitangents as 16-bit octahedral pairs, texture coordinates as 16-bit
+ integers normalised to their range, and indices as zigzag deltas in variable length bytes. The
+ decoder writes each attribute straight into a caller supplied layout (separate streams or one
+ interleaved vertex), four vertices at a time with SIMD.
+ */
+
+#ifndef _AAPL_MESH_ASSET_H_
+#define _AAPL_MESH_ASSET_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AAPL
+{
+    namespace MeshAsset
+    {
+        // "AMSH"
+        static const uint32_t kMagic   = 0x48534d41;
+        static const uint16_t kVersion = 1;
+
+        // Index value that restarts a strip
+        static const uint32_t kRestartIndex = 0xffffffff;
+
+        enum Attribute
+        {
+            eAttributePosition  = 1 << 0,
+            eAttributeNormal    = 1 << 1,
+            eAttributeUV        = 1 << 2,
+            eAttributeTangent   = 1 << 3,
+            eAttributeBitangent = 1 << 4
+        };
+
+        enum Primitive
+        {
+            ePrimitiveTriangle = 0,
+            ePrimitiveTriangleStrip
+        };
+
+        // Fixed size header at the start of an asset, little endian
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t attributes;
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            uint8_t  primitive;
+            uint8_t  indexSize;         // 2 or 4, bytes per index in the decoded index buffer
+            uint16_t reserved;
+            uint32_t indexBytes;        // Length of the compressed index stream
+            float    positionMin[3];
+            float    positionMax[3];
+            float    uvMin[2];
+            float    uvMax[2];
+        };
+
+        // Uncompressed mesh: 3 floats per position, normal, tangent and bitangent, 2 per uv.
+        // Empty attributes are absent from the asset.
+        struct Mesh
+        {
+            std::vector<float>    positions;
+            std::vector<float>    normals;
+            std::vector<float>    uvs;
+            std::vector<float>    tangents;
+            std::vector<float>    bitangents;
+            std::vector<uint32_t> indices;      // kRestartIndex restarts a strip
+            Primitive             primitive;
+            uint32_t              indexSize;
+
+            Mesh();
+
+            size_t vertexCount() const;
+        };
+
+        // Where the decoder writes one attribute: float3 (float2 for uvs) at pData, stride bytes
+        // apart. Leave pData null to skip the attribute.
+        struct Stream
+        {
+            void*  pData;
+            size_t stride;
+        };
+
+        // E.g. separate packed_float3 streams ({p, 12}, {n, 12}) or one interleaved vertex
+        // ({v, 24}, {v + 12, 24})
+        struct Layout
+        {
+            Stream positions;
+            Stream normals;
+            Stream uvs;
+            Stream tangents;
+            Stream bitangents;
+            void*  pIndices;            // header.indexSize bytes per index, restarts as all ones
+
+            Layout();
+        };
+
+        // Serialise a mesh; an empty result means the mesh is malformed (no positions, attribute
+        // counts that disagree or an index out of range)
+        std::vector<uint8_t> encode(const Mesh& rMesh);
+
+        // Validate the header and section sizes of an asset
+        bool header(const void* pAsset, const size_t& size, Header& rHeader);
+
+        // Decode an asset into the layout; false when the asset is truncated or corrupt
+        bool decode(const void* pAsset, const size_t& size, const Layout& rLayout);
+
+        // Decode into separate float arrays
+        bool decode(const void* pAsset, const size_t& size, Mesh& rMesh);
+
+        // Triangulated mesh from Wavefront OBJ text (v, vt, vn and f records, polygons fanned),
+        // one vertex per distinct position/uv/normal triple
+        bool readOBJ(const std::string& text, Mesh& rMesh);
+    } // MeshAsset
+} // AAPL
+
+#endif
+
+#endif
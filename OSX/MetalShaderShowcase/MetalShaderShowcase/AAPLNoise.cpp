@@ -0,0 +1,606 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU version of the wood shader's noise: the same lattice hash, trilinear smooth noise and octave
+ sum, with the hash vectorised eight lanes at a time. Volumes of the octave sum are baked row by
+ row (each row blends the lattice in y and z once, then interpolates along x) in slices spread
+ over a thread pool, and quantised to 8 or 16 bits for a 3D texture the shader samples instead of
+ evaluating the noise per fragment.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "AAPLNoise.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #if defined(__SSE4_1__)
+        #include <smmintrin.h>
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace AAPL
+{
+    namespace Noise
+    {
+        // Metal's mix
+        static inline float mix(const float& x, const float& y, const float& a)
+        {
+            return x + (y - x) * a;
+        }
+
+        // The shader's hash in 32-bit wrapping arithmetic; int overflow is undefined in C++
+        static inline uint32_t hash(const uint32_t& seed)
+        {
+            const uint32_t s = (seed << 13) ^ seed;
+
+            return (s * (s * s * 15731u + 789221u) + 1376312589u) & 2147483647u;
+        }
+
+        static inline float unit(const uint32_t& hash)
+        {
+            return ((1.0f - float(int32_t(hash)) / 1073741824.0f) + 1.0f) / 2.0f;
+        }
+
+#if defined(__SSE2__)
+        // Four lanes per register, two registers per batch
+        static inline __m128i mullo(const __m128i& a, const __m128i& b)
+        {
+#if defined(__SSE4_1__)
+            return _mm_mullo_epi32(a, b);
+#else
+            const __m128i even = _mm_mul_epu32(a, b);
+            const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                      _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+        }
+
+        static inline __m128 rand4(const int32_t* pX, const __m128i& c)
+        {
+            const __m128i seed = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pX)), c);
+            const __m128i s    = _mm_xor_si128(_mm_slli_epi32(seed, 13), seed);
+
+            __m128i h = _mm_add_epi32(mullo(mullo(s, s), _mm_set1_epi32(15731)), _mm_set1_epi32(789221));
+
+            h = _mm_add_epi32(mullo(s, h), _mm_set1_epi32(1376312589));
+            h = _mm_and_si128(h, _mm_set1_epi32(2147483647));
+
+            const __m128 a = _mm_div_ps(_mm_cvtepi32_ps(h), _mm_set1_ps(1073741824.0f));
+
+            return _mm_div_ps(_mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a), _mm_set1_ps(1.0f)), _mm_set1_ps(2.0f));
+        }
+
+        static inline void rand8(const int32_t* pX, const int32_t& c, float* pValues)
+        {
+            const __m128i splat = _mm_set1_epi32(c);
+
+            _mm_storeu_ps(pValues,     rand4(pX,     splat));
+            _mm_storeu_ps(pValues + 4, rand4(pX + 4, splat));
+        }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        static inline float32x4_t rand4(const int32_t* pX, const uint32x4_t& c)
+        {
+            const uint32x4_t seed = vaddq_u32(vreinterpretq_u32_s32(vld1q_s32(pX)), c);
+            const uint32x4_t s    = veorq_u32(vshlq_n_u32(seed, 13), seed);
+
+            uint32x4_t h = vmlaq_u32(vdupq_n_u32(789221u), vmulq_u32(s, s), vdupq_n_u32(15731u));
+
+            h = vmlaq_u32(vdupq_n_u32(1376312589u), s, h);
+            h = vandq_u32(h, vdupq_n_u32(2147483647u));
+
+            const float32x4_t a   = vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(h)), 1.0f / 1073741824.0f);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+
+            return vmulq_n_f32(vaddq_f32(vsubq_f32(one, a), one), 0.5f);
+        }
+
+        static inline void rand8(const int32_t* pX, const int32_t& c, float* pValues)
+        {
+            const uint32x4_t splat = vdupq_n_u32(uint32_t(c));
+
+            vst1q_f32(pValues,     rand4(pX,     splat));
+            vst1q_f32(pValues + 4, rand4(pX + 4, splat));
+        }
+#else
+        static inline void rand8(const int32_t* pX, const int32_t& c, float* pValues)
+        {
+            for(size_t i = 0; i < kLanes; ++i)
+            {
+                pValues[i] = unit(hash(uint32_t(pX[i]) + uint32_t(c)));
+            }
+        }
+#endif
+    } // Noise
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Baking
+
+namespace AAPL
+{
+    namespace Noise
+    {
+        // Where the voxels along one axis fall on the lattice of one octave
+        struct Axis
+        {
+            float                 size;         // Lattice cells per noise cell
+            int32_t               period;       // Noise cells before the lattice repeats
+
+            std::vector<int32_t>  cells;        // Distinct noise cells the voxels touch, in order
+            std::vector<uint32_t> positions;    // Per voxel, index of its upper cell in cells
+            std::vector<int32_t>  upper;        // Per voxel, upper cell (x1 in the shader)
+            std::vector<int32_t>  lower;        // Per voxel, lower cell (x2 in the shader)
+            std::vector<float>    fractions;    // Per voxel, weight of the upper cell
+        };
+
+        // Per thread buffers for one row
+        struct Scratch
+        {
+            std::vector<float> corners[4];      // Hashes of the cells at the four (y, z) corners
+            std::vector<float> cells;           // Hashes blended in y and z
+            std::vector<float> sums;            // Octave sum per voxel
+        };
+
+        static inline int32_t wrap(const int32_t& cell, const int32_t& period)
+        {
+            return ((cell % period) + period) % period;
+        }
+
+        static Axis axis(const Volume& rVolume, const float& size, const int32_t& period)
+        {
+            const uint32_t resolution = rVolume.resolution();
+
+            Axis result;
+
+            result.size   = size;
+            result.period = period;
+
+            result.positions.resize(resolution);
+            result.upper.resize(resolution);
+            result.lower.resize(resolution);
+            result.fractions.resize(resolution);
+
+            std::vector<int32_t> unwrapped;
+
+            for(uint32_t i = 0; i < resolution; ++i)
+            {
+                // Same float division and truncation as the shader, so cells agree at their edges
+                const float   q    = rVolume.coordinate(i) / size;
+                const int32_t cell = int32_t(q);
+
+                // The lower cell of every voxel directly precedes its upper cell in cells
+                if(unwrapped.empty() || (unwrapped.back() < cell - 1))
+                {
+                    unwrapped.push_back(cell - 1);
+                }
+
+                if(unwrapped.back() < cell)
+                {
+                    unwrapped.push_back(cell);
+                }
+
+                result.positions[i] = uint32_t(unwrapped.size() - 1);
+                result.upper[i]     = wrap(cell, period);
+                result.lower[i]     = wrap(result.upper[i] + period - 1, period);
+                result.fractions[i] = q - float(cell);
+            }
+
+            // Pad to whole batches of the hash
+            result.cells.resize((unwrapped.size() + kLanes - 1) / kLanes * kLanes, 0);
+
+            for(size_t i = 0; i < unwrapped.size(); ++i)
+            {
+                result.cells[i] = wrap(unwrapped[i], period);
+            }
+
+            return result;
+        }
+
+        static void hashCells(const Axis& rAxis, const int32_t& y, const int32_t& z, float* pValues)
+        {
+            const int32_t c = y * 57 + z * 241;
+
+            for(size_t i = 0; i < rAxis.cells.size(); i += kLanes)
+            {
+                rand8(&rAxis.cells[i], c, pValues + i);
+            }
+        }
+
+        // Octave sums of the voxels of row (y, z)
+        static void bakeRow(const std::vector<Axis>& rAxes,
+                            const uint32_t& y,
+                            const uint32_t& z,
+                            Scratch& rScratch)
+        {
+            const size_t resolution = rScratch.sums.size();
+
+            std::fill(rScratch.sums.begin(), rScratch.sums.end(), 0.0f);
+
+            float div = 0.0f;
+
+            for(const Axis& rAxis : rAxes)
+            {
+                const size_t count = rAxis.cells.size();
+
+                for(size_t k = 0; k < 4; ++k)
+                {
+                    rScratch.corners[k].resize(count);
+                }
+
+                rScratch.cells.resize(count);
+
+                hashCells(rAxis, rAxis.lower[y], rAxis.lower[z], rScratch.corners[0].data());
+                hashCells(rAxis, rAxis.upper[y], rAxis.lower[z], rScratch.corners[1].data());
+                hashCells(rAxis, rAxis.lower[y], rAxis.upper[z], rScratch.corners[2].data());
+                hashCells(rAxis, rAxis.upper[y], rAxis.upper[z], rScratch.corners[3].data());
+
+                const float  fy     = rAxis.fractions[y];
+                const float  fz     = rAxis.fractions[z];
+                const float* pY2Z2  = rScratch.corners[0].data();
+                const float* pY1Z2  = rScratch.corners[1].data();
+                const float* pY2Z1  = rScratch.corners[2].data();
+                const float* pY1Z1  = rScratch.corners[3].data();
+                float*       pCells = rScratch.cells.data();
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    pCells[i] = mix(mix(pY2Z2[i], pY1Z2[i], fy), mix(pY2Z1[i], pY1Z1[i], fy), fz);
+                }
+
+                float* pSums = rScratch.sums.data();
+
+                for(size_t i = 0; i < resolution; ++i)
+                {
+                    const uint32_t p = rAxis.positions[i];
+
+                    pSums[i] += mix(pCells[p - 1], pCells[p], rAxis.fractions[i]) * rAxis.size;
+                }
+
+                div += rAxis.size;
+            }
+
+            for(size_t i = 0; i < resolution; ++i)
+            {
+                rScratch.sums[i] /= div;
+            }
+        }
+    } // Noise
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Noise
+
+float AAPL::Noise::rand(const int32_t& x, const int32_t& y, const int32_t& z)
+{
+    return unit(hash(uint32_t(x) + uint32_t(y) * 57u + uint32_t(z) * 241u));
+}
+
+void AAPL::Noise::rand(const int32_t* pX,
+                       const size_t& count,
+                       const int32_t& y,
+                       const int32_t& z,
+                       float* pValues)
+{
+    const int32_t c = y * 57 + z * 241;
+
+    size_t i = 0;
+
+    for(; i + kLanes <= count; i += kLanes)
+    {
+        rand8(pX + i, c, pValues + i);
+    }
+
+    for(; i < count; ++i)
+    {
+        pValues[i] = rand(pX[i], y, z);
+    }
+}
+
+float AAPL::Noise::smoothNoise(const float& x,
+                               const float& y,
+                               const float& z,
+                               const int32_t& period)
+{
+    const int32_t intX = int32_t(x);
+    const int32_t intY = int32_t(y);
+    const int32_t intZ = int32_t(z);
+
+    const float fractX = x - float(intX);
+    const float fractY = y - float(intY);
+    const float fractZ = z - float(intZ);
+
+    const int32_t x1 = wrap(intX, period);
+    const int32_t y1 = wrap(intY, period);
+    const int32_t z1 = wrap(intZ, period);
+
+    const int32_t x2 = (x1 + period - 1) % period;
+    const int32_t y2 = (y1 + period - 1) % period;
+    const int32_t z2 = (z1 + period - 1) % period;
+
+    const float sumY1Z1 = mix(rand(x2, y1, z1), rand(x1, y1, z1), fractX);
+    const float sumY1Z2 = mix(rand(x2, y1, z2), rand(x1, y1, z2), fractX);
+    const float sumY2Z1 = mix(rand(x2, y2, z1), rand(x1, y2, z1), fractX);
+    const float sumY2Z2 = mix(rand(x2, y2, z2), rand(x1, y2, z2), fractX);
+
+    const float sumZ1 = mix(sumY2Z1, sumY1Z1, fractY);
+    const float sumZ2 = mix(sumY2Z2, sumY1Z2, fractY);
+
+    return mix(sumZ2, sumZ1, fractZ);
+}
+
+float AAPL::Noise::noise3D(const float& x,
+                           const float& y,
+                           const float& z,
+                           const uint32_t& octaves,
+                           const bool& tileable)
+{
+    float value = 0.0f;
+    float size  = float(kLargestOctave);
+    float div   = 0.0f;
+
+    for(uint32_t octave = 0; octave < octaves; ++octave)
+    {
+        const int32_t period = tileable ? int32_t(float(kLatticeSize) / size) : int32_t(kLatticeSize);
+
+        value += smoothNoise(x / size, y / size, z / size, period) * size;
+        div   += size;
+        size  /= 2.0f;
+    }
+
+    return value / div;
+}
+
+#pragma mark -
+#pragma mark Public - Volume
+
+AAPL::Noise::Volume::Volume()
+: mnResolution(0),
+  mnOctaves(0),
+  mnFormat(eFormatR8),
+  mbTileable(false)
+{
+} // Constructor
+
+AAPL::Noise::Volume::~Volume()
+{
+} // Destructor
+
+uint32_t AAPL::Noise::Volume::resolution() const
+{
+    return mnResolution;
+}
+
+uint32_t AAPL::Noise::Volume::octaves() const
+{
+    return mnOctaves;
+}
+
+AAPL::Noise::Format AAPL::Noise::Volume::format() const
+{
+    return mnFormat;
+}
+
+bool AAPL::Noise::Volume::tileable() const
+{
+    return mbTileable;
+}
+
+const void* AAPL::Noise::Volume::data() const
+{
+    return m_Data.data();
+}
+
+size_t AAPL::Noise::Volume::length() const
+{
+    return m_Data.size();
+}
+
+size_t AAPL::Noise::Volume::bytesPerRow() const
+{
+    return size_t(mnResolution) * mnFormat;
+}
+
+size_t AAPL::Noise::Volume::bytesPerImage() const
+{
+    return bytesPerRow() * mnResolution;
+}
+
+float AAPL::Noise::Volume::coordinate(const uint32_t& i) const
+{
+    const uint32_t cells = mbTileable ? mnResolution : mnResolution - 1;
+
+    return float(i) * float(kLatticeSize) / float(cells);
+}
+
+float AAPL::Noise::Volume::voxel(const uint32_t& x, const uint32_t& y, const uint32_t& z) const
+{
+    const size_t index = (size_t(z) * mnResolution + y) * mnResolution + x;
+
+    if(mnFormat == eFormatR16)
+    {
+        return float(reinterpret_cast<const uint16_t*>(m_Data.data())[index]) / 65535.0f;
+    }
+
+    return float(m_Data[index]) / 255.0f;
+}
+
+float AAPL::Noise::Volume::sample(const float& x, const float& y, const float& z) const
+{
+    const float coordinates[3] = {x, y, z};
+
+    uint32_t lower[3];
+    uint32_t upper[3];
+    float    weights[3];
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+        if(mbTileable)
+        {
+            const float t = coordinates[k] / float(kLatticeSize) * float(mnResolution);
+            const float f = std::floor(t);
+
+            lower[k]   = uint32_t(int64_t(f) % mnResolution + mnResolution) % mnResolution;
+            upper[k]   = (lower[k] + 1) % mnResolution;
+            weights[k] = t - f;
+        }
+        else
+        {
+            const float t = std::min(std::max(coordinates[k] / float(kLatticeSize), 0.0f), 1.0f) * float(mnResolution - 1);
+
+            lower[k]   = std::min(uint32_t(t), mnResolution - 2);
+            upper[k]   = lower[k] + 1;
+            weights[k] = t - float(lower[k]);
+        }
+    }
+
+    float value = 0.0f;
+
+    for(uint32_t corner = 0; corner < 8; ++corner)
+    {
+        float weight = 1.0f;
+
+        uint32_t voxels[3];
+
+        for(size_t k = 0; k < 3; ++k)
+        {
+            const bool isUpper = (corner >> k) & 1;
+
+            voxels[k] = isUpper ? upper[k] : lower[k];
+            weight   *= isUpper ? weights[k] : 1.0f - weights[k];
+        }
+
+        value += weight * voxel(voxels[0], voxels[1], voxels[2]);
+    }
+
+    return value;
+}
+
+bool AAPL::Noise::Volume::bake(const uint32_t& resolution,
+                               const uint32_t& octaves,
+                               const Format& format,
+                               const bool& tileable,
+                               Threads::WorkStealingPool* pPool)
+{
+    if((resolution < (tileable ? 1u : 2u)) || (octaves < 1) || (octaves > kMaxOctaves))
+    {
+        return false;
+    }
+
+    mnResolution = resolution;
+    mnOctaves    = octaves;
+    mnFormat     = format;
+    mbTileable   = tileable;
+
+    m_Data.assign(bytesPerImage() * resolution, 0);
+
+    // The same table serves x, y and z
+    std::vector<Axis> axes;
+
+    float size = float(kLargestOctave);
+
+    for(uint32_t octave = 0; octave < octaves; ++octave)
+    {
+        const int32_t period = tileable ? int32_t(float(kLatticeSize) / size) : int32_t(kLatticeSize);
+
+        axes.push_back(axis(*this, size, period));
+
+        size /= 2.0f;
+    }
+
+    // One slice of rows per task
+    auto bakeSlice = [&](size_t z)
+    {
+        Scratch scratch;
+
+        scratch.sums.resize(resolution);
+
+        for(uint32_t y = 0; y < resolution; ++y)
+        {
+            bakeRow(axes, y, uint32_t(z), scratch);
+
+            const size_t first = (z * resolution + y) * resolution;
+
+            if(format == eFormatR16)
+            {
+                uint16_t* pRow = reinterpret_cast<uint16_t*>(m_Data.data()) + first;
+
+                for(uint32_t x = 0; x < resolution; ++x)
+                {
+                    pRow[x] = uint16_t(scratch.sums[x] * 65535.0f + 0.5f);
+                }
+            }
+            else
+            {
+                uint8_t* pRow = m_Data.data() + first;
+
+                for(uint32_t x = 0; x < resolution; ++x)
+                {
+                    pRow[x] = uint8_t(scratch.sums[x] * 255.0f + 0.5f);
+                }
+            }
+        }
+    };
+
+    if(pPool)
+    {
+        pPool->parallelFor(resolution, bakeSlice, 1);
+    }
+    else
+    {
+        for(size_t z = 0; z < resolution; ++z)
+        {
+            bakeSlice(z);
+        }
+    }
+
+    return true;
+}
+
+#pragma mark -
+#pragma mark Public - Error
+
+AAPL::Noise::Error AAPL::Noise::measure(const Volume& rVolume,
+                                        const size_t& samples,
+                                        const uint32_t& seed)
+{
+    Error result = {samples, 0.0, 0.0};
+
+    if((rVolume.resolution() == 0) || (samples == 0))
+    {
+        return result;
+    }
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(0.0f, float(kLatticeSize));
+
+    double sum = 0.0;
+
+    for(size_t i = 0; i < samples; ++i)
+    {
+        const float x = distribution(generator);
+        const float y = distribution(generator);
+        const float z = distribution(generator);
+
+        const double error = std::fabs(double(rVolume.sample(x, y, z)) -
+                                       double(noise3D(x, y, z, rVolume.octaves(), rVolume.tileable())));
+
+        result.maxError = std::max(result.maxError, error);
+
+        sum += error * error;
+    }
+
+    result.rmsError = std::sqrt(sum / double(samples));
+
+    return result;
+}
@@ -0,0 +1,136 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU version of the wood shader's noise: the same lattice hash, trilinear smooth noise and octave
+ sum, with the hash vectorised eight lanes at a time. Volumes of the octave sum are baked row by
+ row (each row blends the lattice in y and z once, then interpolates along x) in slices spread
+ over a thread pool, and quantised to 8 or 16 bits for a 3D texture the shader samples instead of
+ evaluating the noise per fragment.
+ */
+
+#ifndef _AAPL_NOISE_H_
+#define _AAPL_NOISE_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace Noise
+    {
+        // Lattice cells across the noise domain (NOISE_DIM in the shader); lattice coordinates of
+        // the domain are in [0, kLatticeSize]
+        static const uint32_t kLatticeSize = 512;
+
+        // Lattice cells per noise cell of the largest octave (NOISE_SIZE); every next octave halves
+        static const uint32_t kLargestOctave = 64;
+
+        // Octaves down to one lattice cell per noise cell, as summed by the shader
+        static const uint32_t kMaxOctaves = 7;
+
+        // Hashes computed per batch
+        static const size_t kLanes = 8;
+
+        // Bytes per voxel
+        enum Format
+        {
+            eFormatR8  = 1,
+            eFormatR16 = 2
+        };
+
+        // Lattice hash in (0, 1]
+        float rand(const int32_t& x, const int32_t& y, const int32_t& z);
+
+        // Lattice hash of x[i] + 57 y + 241 z for count values of x
+        void rand(const int32_t* pX,
+                  const size_t& count,
+                  const int32_t& y,
+                  const int32_t& z,
+                  float* pValues);
+
+        // Trilinear noise at lattice coordinates, the lattice repeating every period cells
+        float smoothNoise(const float& x,
+                          const float& y,
+                          const float& z,
+                          const int32_t& period = kLatticeSize);
+
+        // Octave sum at lattice coordinates in [0, kLatticeSize]. A tileable sum repeats every
+        // kLatticeSize cells in every direction; otherwise it is the shader's noise3D.
+        float noise3D(const float& x,
+                      const float& y,
+                      const float& z,
+                      const uint32_t& octaves = kMaxOctaves,
+                      const bool& tileable = false);
+
+        class Volume
+        {
+        public:
+            Volume();
+
+            virtual ~Volume();
+
+            // Voxels per side; a volume that doesn't tile needs at least two
+            uint32_t resolution() const;
+            uint32_t octaves() const;
+            Format   format() const;
+            bool     tileable() const;
+
+            // resolution^3 voxels, x varying fastest
+            const void* data() const;
+            size_t      length() const;
+            size_t      bytesPerRow() const;
+            size_t      bytesPerImage() const;
+
+            // Voxel centres of a volume that doesn't tile sit on lattice coordinates
+            // i * kLatticeSize / (resolution - 1), so that clamped sampling covers the domain
+            // exactly; those of a tileable volume at i * kLatticeSize / resolution.
+            float coordinate(const uint32_t& i) const;
+
+            // Normalised value of a voxel
+            float voxel(const uint32_t& x, const uint32_t& y, const uint32_t& z) const;
+
+            // Trilinear sample at lattice coordinates, clamped or repeated like a GPU sampler
+            float sample(const float& x, const float& y, const float& z) const;
+
+            // False for a resolution below 2 (below 1 when tileable) or an octave count outside
+            // [1, kMaxOctaves]. The pool, when given, bakes slices in parallel.
+            bool bake(const uint32_t& resolution,
+                      const uint32_t& octaves,
+                      const Format& format,
+                      const bool& tileable,
+                      Threads::WorkStealingPool* pPool = nullptr);
+
+        private:
+            uint32_t             mnResolution;
+            uint32_t             mnOctaves;
+            Format               mnFormat;
+            bool                 mbTileable;
+            std::vector<uint8_t> m_Data;
+        }; // Class Volume
+
+        struct Error
+        {
+            size_t samples;
+            double maxError;        // Largest |sample - noise3D|
+            double rmsError;
+        };
+
+        // Compare trilinear samples of a volume with the octave sum at random lattice coordinates
+        Error measure(const Volume& rVolume,
+                      const size_t& samples,
+                      const uint32_t& seed = 1);
+    } // Noise
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,612 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU particle engine. Particles live in a fixed pool of structure-of-arrays slots; emitters spawn
+ into slots taken from a free list and expired particles return to it. Every frame the pool is
+ integrated four slots per SIMD register in blocks spread over a thread pool, then the living
+ particles are radix sorted back to front by their depth in the view and packed into a vertex
+ stream for blending.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "AAPLParticleEngine.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace AAPL
+{
+    namespace Particles
+    {
+        // Four slots per register
+        struct float4
+        {
+#if defined(__SSE2__)
+            __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            float32x4_t v;
+#else
+            float v[4];
+#endif
+        };
+
+#if defined(__SSE2__)
+        static inline float4 load(const float* p)                        { return {_mm_loadu_ps(p)}; }
+        static inline void   store(float* p, const float4& a)            { _mm_storeu_ps(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {_mm_set1_ps(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+        static inline float4 min(const float4& a, const float4& b)       { return {_mm_min_ps(a.v, b.v)}; }
+        static inline float4 max(const float4& a, const float4& b)       { return {_mm_max_ps(a.v, b.v)}; }
+
+        // All ones in the lanes where a < b
+        static inline float4 less(const float4& a, const float4& b)      { return {_mm_cmplt_ps(a.v, b.v)}; }
+        static inline float4 notBoth(const float4& a, const float4& b)   { return {_mm_andnot_ps(b.v, a.v)}; }
+
+        // Lanes of mask from a, the others from b
+        static inline float4 select(const float4& mask, const float4& a, const float4& b)
+        {
+            return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+        }
+
+        // One bit per lane
+        static inline uint32_t bits(const float4& mask) { return uint32_t(_mm_movemask_ps(mask.v)); }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        static inline float4 load(const float* p)                        { return {vld1q_f32(p)}; }
+        static inline void   store(float* p, const float4& a)            { vst1q_f32(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {vdupq_n_f32(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+        static inline float4 min(const float4& a, const float4& b)       { return {vminq_f32(a.v, b.v)}; }
+        static inline float4 max(const float4& a, const float4& b)       { return {vmaxq_f32(a.v, b.v)}; }
+
+        static inline float4 less(const float4& a, const float4& b)
+        {
+            return {vreinterpretq_f32_u32(vcltq_f32(a.v, b.v))};
+        }
+
+        {
+            return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+        }
+
+        static inline float4 notBoth(const float4& a, const float4& b)
+        {
+            return {vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+        }
+
+        static inline float4 select(const float4& mask, const float4& a, const float4& b)
+        {
+            return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+        }
+
+        static inline uint32_t bits(const float4& mask)
+        {
+            static const uint32_t weights[4] = {1, 2, 4, 8};
+
+            return vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask.v), vld1q_u32(weights)));
+        }
+#else
+        static inline float4 load(const float* p)             { return {{p[0], p[1], p[2], p[3]}}; }
+        static inline void   store(float* p, const float4& a) { std::copy(a.v, a.v + 4, p); }
+        static inline float4 splat(const float& s)            { return {{s, s, s, s}}; }
+
+        static inline float4 operator+(const float4& a, const float4& b)
+        {
+            return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+        }
+
+        static inline float4 operator*(const float4& a, const float4& b)
+        {
+            return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+        }
+
+        static inline float4 min(const float4& a, const float4& b)
+        {
+            return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}};
+        }
+
+        static inline float4 max(const float4& a, const float4& b)
+        {
+            return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+        }
+
+        // Masks hold 1 or 0 per lane
+        static inline float4 less(const float4& a, const float4& b)
+        {
+            return {{float(a.v[0] < b.v[0]), float(a.v[1] < b.v[1]), float(a.v[2] < b.v[2]), float(a.v[3] < b.v[3])}};
+        }
+
+        static inline float4 notBoth(const float4& a, const float4& b) { return a * (splat(1.0f) + b * splat(-1.0f)); }
+
+        static inline float4 select(const float4& mask, const float4& a, const float4& b)
+        {
+            return {{mask.v[0] != 0.0f ? a.v[0] : b.v[0], mask.v[1] != 0.0f ? a.v[1] : b.v[1],
+                     mask.v[2] != 0.0f ? a.v[2] : b.v[2], mask.v[3] != 0.0f ? a.v[3] : b.v[3]}};
+        }
+
+        static inline uint32_t bits(const float4& mask)
+        {
+            return uint32_t(mask.v[0] != 0.0f) | (uint32_t(mask.v[1] != 0.0f) << 1) |
+                   (uint32_t(mask.v[2] != 0.0f) << 2) | (uint32_t(mask.v[3] != 0.0f) << 3);
+        }
+#endif
+
+        // Counter based random numbers in [0, 1), so that spawns can be initialised in any order
+        static inline float random(uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+
+            return float(x >> 8) * (1.0f / 16777216.0f);
+        }
+
+        static inline uint32_t seed(const uint32_t& frame, const uint32_t& emitter, const uint32_t& index)
+        {
+            return (frame * 0x9e3779b9u) ^ (emitter * 0x85ebca6bu) ^ (index * 3u);
+        }
+    } // Particles
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Engine
+
+void AAPL::Particles::Engine::parallelFor(const size_t& count, const std::function<void(size_t)>& rBody)
+{
+    if(mpPool)
+    {
+        mpPool->parallelFor(count, rBody, 1);
+    }
+    else
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            rBody(i);
+        }
+    }
+}
+
+// Move every slot, living or not, and collect the slots whose lifespan ends in this step
+void AAPL::Particles::Engine::integrate(const float& dt, Statistics& rStatistics)
+{
+    const size_t blocks = m_Retired.size();
+
+    parallelFor(blocks, [&](size_t block)
+    {
+        const size_t first = block * kBlockSize;
+        const size_t last  = std::min(first + kBlockSize, m_Ages.size());
+
+        const float4 step = splat(dt);
+        const float4 a[3] = {splat(m_Acceleration[0]), splat(m_Acceleration[1]), splat(m_Acceleration[2])};
+
+        // Exact for constant acceleration: p += v dt + a dt^2 / 2, v += a dt
+        const float4 half[3] = {a[0] * splat(0.5f * dt * dt), a[1] * splat(0.5f * dt * dt), a[2] * splat(0.5f * dt * dt)};
+
+        std::vector<uint32_t>& rRetired = m_Retired[block];
+
+        rRetired.clear();
+
+        for(size_t i = first; i < last; i += 4)
+        {
+            for(size_t k = 0; k < 3; ++k)
+            {
+                const float4 v = load(&m_Velocities[k][i]);
+
+                store(&m_Positions[k][i], load(&m_Positions[k][i]) + v * step + half[k]);
+                store(&m_Velocities[k][i], v + a[k] * step);
+            }
+
+            const float4 age      = load(&m_Ages[i]);
+            const float4 lifespan = load(&m_Lifespans[i]);
+            const float4 aged     = age + step;
+
+            store(&m_Ages[i], aged);
+
+            // Alive before the step and not after it
+            uint32_t expired = bits(notBoth(less(age, lifespan), less(aged, lifespan)));
+
+            while(expired)
+            {
+                const uint32_t lane = uint32_t(__builtin_ctz(expired));
+
+                rRetired.push_back(uint32_t(i + lane));
+
+                expired &= expired - 1;
+            }
+        }
+    });
+
+    for(const std::vector<uint32_t>& rRetired : m_Retired)
+    {
+        m_Free.insert(m_Free.end(), rRetired.begin(), rRetired.end());
+
+        rStatistics.retired += rRetired.size();
+    }
+}
+
+// Take slots from the free list for every emitter's new particles and start them at their
+// emitter, each at its own point in the step
+void AAPL::Particles::Engine::spawn(const float& dt, Statistics& rStatistics)
+{
+    std::vector<size_t> counts(m_Emitters.size());
+    std::vector<size_t> offsets(m_Emitters.size() + 1, 0);
+
+    for(size_t e = 0; e < m_Emitters.size(); ++e)
+    {
+        m_Pending[e] += m_Emitters[e].rate * dt;
+
+        counts[e]     = size_t(m_Pending[e]);
+        m_Pending[e] -= float(counts[e]);
+
+        const size_t available = m_Free.size() - offsets[e];
+        const size_t taken     = std::min(counts[e], available);
+
+        rStatistics.dropped += counts[e] - taken;
+
+        counts[e]      = taken;
+        offsets[e + 1] = offsets[e] + taken;
+    }
+
+    const size_t total = offsets.back();
+
+    if(total == 0)
+    {
+        return;
+    }
+
+    // The newest free slots, in stack order
+    const uint32_t* pSlots = m_Free.data() + m_Free.size() - total;
+
+    const size_t blocks = (total + kBlockSize - 1) / kBlockSize;
+
+    parallelFor(blocks, [&](size_t block)
+    {
+        const size_t first = block * kBlockSize;
+        const size_t last  = std::min(first + kBlockSize, total);
+
+        size_t e = size_t(std::upper_bound(offsets.begin(), offsets.end(), first) - offsets.begin()) - 1;
+
+        for(size_t j = first; j < last; ++j)
+        {
+            while(j >= offsets[e + 1])
+            {
+                ++e;
+            }
+
+            const Emitter& rEmitter = m_Emitters[e];
+
+            const uint32_t index = uint32_t(j - offsets[e]);
+            const uint32_t s     = seed(mnFrame, uint32_t(e), index);
+
+            // A direction mostly along the emitter's, pushed sideways by up to spread
+            const float* d = rEmitter.direction;
+
+            const float helper[3] = {std::fabs(d[0]) < 0.9f ? 1.0f : 0.0f, std::fabs(d[0]) < 0.9f ? 0.0f : 1.0f, 0.0f};
+
+            float t1[3] = {d[1] * helper[2] - d[2] * helper[1], d[2] * helper[0] - d[0] * helper[2], d[0] * helper[1] - d[1] * helper[0]};
+
+            const float l1 = std::sqrt(t1[0] * t1[0] + t1[1] * t1[1] + t1[2] * t1[2]);
+
+            for(size_t k = 0; k < 3; ++k)
+            {
+                t1[k] /= l1;
+            }
+
+            const float t2[3] = {d[1] * t1[2] - d[2] * t1[1], d[2] * t1[0] - d[0] * t1[2], d[0] * t1[1] - d[1] * t1[0]};
+
+            const float along = random(s);
+            const float side1 = (2.0f * random(s + 1) - 1.0f) * rEmitter.spread;
+            const float side2 = (2.0f * random(s + 2) - 1.0f) * rEmitter.spread;
+
+            float v[3];
+
+            for(size_t k = 0; k < 3; ++k)
+            {
+                v[k] = d[k] * along + t1[k] * side1 + t2[k] * side2;
+            }
+
+            const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            const float scale  = (length > 0.0f) ? rEmitter.speed / length : 0.0f;
+
+            // Born (index + 1) / count of the way back into the step, so a steady rate doesn't
+            // release particles in bursts once per frame. A step longer than the lifespan still
+            // has to leave the particle alive, or its slot would never be retired.
+            const float age = std::min(dt * float(counts[e] - index) / float(counts[e]), 0.5f * rEmitter.lifespan);
+
+            const uint32_t slot = pSlots[total - 1 - j];
+
+            for(size_t k = 0; k < 3; ++k)
+            {
+                v[k] *= scale;
+
+                m_Positions[k][slot]  = rEmitter.position[k] + v[k] * age + 0.5f * m_Acceleration[k] * age * age;
+                m_Velocities[k][slot] = v[k] + m_Acceleration[k] * age;
+            }
+
+            m_Ages[slot]      = age;
+            m_Lifespans[slot] = rEmitter.lifespan;
+        }
+    });
+
+    m_Free.resize(m_Free.size() - total);
+
+    rStatistics.spawned += total;
+}
+
+// Compact the living slots into vertices, in slot order, keyed by their depth quantised over the
+// range of this frame and inverted so that ascending keys run back to front, then sort the
+// vertices themselves with stable passes of eight bits, the last writing to pVertices. Moving
+// whole vertices keeps every read sequential; gathering from the slots in depth order instead
+// would miss the cache for nearly every particle.
+void AAPL::Particles::Engine::sort(const float* pModelViewProjection, const size_t& count, Vertex* pVertices)
+{
+    const size_t blocks = m_BlockCounts.size();
+
+    // Clip space w of a point is the fourth row of the matrix
+    const float row[4] = {pModelViewProjection[3], pModelViewProjection[7], pModelViewProjection[11], pModelViewProjection[15]};
+
+    parallelFor(blocks, [&](size_t block)
+    {
+        const size_t first = block * kBlockSize;
+        const size_t last  = std::min(first + kBlockSize, m_Ages.size());
+
+        const float4 m[4] = {splat(row[0]), splat(row[1]), splat(row[2]), splat(row[3])};
+
+        float4 nearest  = splat(FLT_MAX);
+        float4 farthest = splat(-FLT_MAX);
+
+        uint32_t living = 0;
+
+        for(size_t i = first; i < last; i += 4)
+        {
+            const float4 w = m[0] * load(&m_Positions[0][i]) + m[1] * load(&m_Positions[1][i]) +
+                             m[2] * load(&m_Positions[2][i]) + m[3];
+
+            const float4 alive = less(load(&m_Ages[i]), load(&m_Lifespans[i]));
+
+            store(&m_Depths[i], w);
+
+            nearest  = min(nearest,  select(alive, w, splat(FLT_MAX)));
+            farthest = max(farthest, select(alive, w, splat(-FLT_MAX)));
+
+            living += uint32_t(__builtin_popcount(bits(alive)));
+        }
+
+        float lanes[2][4];
+
+        store(lanes[0], nearest);
+        store(lanes[1], farthest);
+
+        m_BlockCounts[block]          = living;
+        m_BlockRanges[2 * block]      = *std::min_element(lanes[0], lanes[0] + 4);
+        m_BlockRanges[2 * block + 1]  = *std::max_element(lanes[1], lanes[1] + 4);
+    });
+
+    float nearest  = FLT_MAX;
+    float farthest = -FLT_MAX;
+
+    std::vector<uint32_t> offsets(blocks + 1, 0);
+
+    for(size_t block = 0; block < blocks; ++block)
+    {
+        offsets[block + 1] = offsets[block] + m_BlockCounts[block];
+
+        nearest  = std::min(nearest,  m_BlockRanges[2 * block]);
+        farthest = std::max(farthest, m_BlockRanges[2 * block + 1]);
+    }
+
+    const float range = farthest - nearest;
+    const float scale = (range > 0.0f) ? float((1u << kDepthBits) - 1) / range : 0.0f;
+
+    parallelFor(blocks, [&](size_t block)
+    {
+        const size_t first = block * kBlockSize;
+        const size_t last  = std::min(first + kBlockSize, m_Ages.size());
+
+        size_t out = offsets[block];
+
+        for(size_t i = first; i < last; ++i)
+        {
+            if(m_Ages[i] < m_Lifespans[i])
+            {
+                Vertex& rVertex = m_Vertices[0][out];
+
+                rVertex.position[0] = m_Positions[0][i];
+                rVertex.position[1] = m_Positions[1][i];
+                rVertex.position[2] = m_Positions[2][i];
+                rVertex.age         = m_Ages[i] / m_Lifespans[i];
+
+                m_Keys[0][out] = uint16_t((farthest - m_Depths[i]) * scale + 0.5f);
+
+                ++out;
+            }
+        }
+    });
+
+    // Radix passes over chunks of the compacted slots
+    const size_t chunks = (count + kBlockSize - 1) / kBlockSize;
+
+    m_Histograms.resize(chunks * 256);
+
+    for(uint32_t shift = 0; shift < kDepthBits; shift += 8)
+    {
+        const bool last = (shift + 8 >= kDepthBits);
+
+        const uint16_t* pKeys        = m_Keys[0].data();
+        const Vertex*   pSources     = m_Vertices[0].data();
+        uint16_t*       pOutKeys     = m_Keys[1].data();
+        Vertex*         pDestination = last ? pVertices : m_Vertices[1].data();
+
+        parallelFor(chunks, [&](size_t chunk)
+        {
+            uint32_t* pHistogram = &m_Histograms[chunk * 256];
+
+            std::fill(pHistogram, pHistogram + 256, 0);
+
+            const size_t last = std::min((chunk + 1) * kBlockSize, count);
+
+            for(size_t i = chunk * kBlockSize; i < last; ++i)
+            {
+                ++pHistogram[(pKeys[i] >> shift) & 0xff];
+            }
+        });
+
+        // Exclusive prefix over digits, then chunks, so that every pass stays stable
+        uint32_t sum = 0;
+
+        for(size_t digit = 0; digit < 256; ++digit)
+        {
+            for(size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                const uint32_t n = m_Histograms[chunk * 256 + digit];
+
+                m_Histograms[chunk * 256 + digit] = sum;
+
+                sum += n;
+            }
+        }
+
+        parallelFor(chunks, [&](size_t chunk)
+        {
+            uint32_t* pOffsets = &m_Histograms[chunk * 256];
+
+            const size_t last = std::min((chunk + 1) * kBlockSize, count);
+
+            for(size_t i = chunk * kBlockSize; i < last; ++i)
+            {
+                const uint32_t to = pOffsets[(pKeys[i] >> shift) & 0xff]++;
+
+                pOutKeys[to]     = pKeys[i];
+                pDestination[to] = pSources[i];
+            }
+        });
+
+        m_Keys[0].swap(m_Keys[1]);
+        m_Vertices[0].swap(m_Vertices[1]);
+    }
+}
+
+#pragma mark -
+#pragma mark Public - Engine
+
+AAPL::Particles::Engine::Engine(const size_t& capacity, Threads::WorkStealingPool* pPool)
+: mpPool(pPool),
+  mnCapacity(capacity),
+  mnFrame(0)
+{
+    // Whole registers; the padding slots never live
+    const size_t slots  = (capacity + 3) & ~size_t(3);
+    const size_t blocks = (slots + kBlockSize - 1) / kBlockSize;
+
+    for(size_t k = 0; k < 3; ++k)
+    {
+        m_Positions[k].assign(slots, 0.0f);
+        m_Velocities[k].assign(slots, 0.0f);
+        m_Acceleration[k] = 0.0f;
+    }
+
+    m_Ages.assign(slots, 0.0f);
+    m_Lifespans.assign(slots, 0.0f);
+    m_Depths.assign(slots, 0.0f);
+
+    m_Retired.resize(blocks);
+    m_BlockCounts.resize(blocks);
+    m_BlockRanges.resize(2 * blocks);
+
+    for(size_t k = 0; k < 2; ++k)
+    {
+        m_Keys[k].resize(capacity);
+        m_Vertices[k].resize(capacity);
+    }
+
+    // Slot 0 on top of the stack
+    m_Free.resize(capacity);
+
+    for(size_t i = 0; i < capacity; ++i)
+    {
+        m_Free[i] = uint32_t(capacity - 1 - i);
+    }
+} // Constructor
+
+AAPL::Particles::Engine::~Engine()
+{
+} // Destructor
+
+size_t AAPL::Particles::Engine::capacity() const
+{
+    return mnCapacity;
+}
+
+size_t AAPL::Particles::Engine::alive() const
+{
+    return mnCapacity - m_Free.size();
+}
+
+void AAPL::Particles::Engine::setAcceleration(const float& x, const float& y, const float& z)
+{
+    m_Acceleration[0] = x;
+    m_Acceleration[1] = y;
+    m_Acceleration[2] = z;
+}
+
+size_t AAPL::Particles::Engine::addEmitter(const Emitter& rEmitter)
+{
+    m_Emitters.push_back(rEmitter);
+    m_Pending.push_back(0.0f);
+
+    return m_Emitters.size() - 1;
+}
+
+size_t AAPL::Particles::Engine::emitterCount() const
+{
+    return m_Emitters.size();
+}
+
+AAPL::Particles::Emitter& AAPL::Particles::Engine::emitter(const size_t& index)
+{
+    return m_Emitters[index];
+}
+
+AAPL::Particles::Statistics AAPL::Particles::Engine::update(const float& dt)
+{
+    Statistics statistics = {0, 0, 0, 0};
+
+    if(dt > 0.0f)
+    {
+        integrate(dt, statistics);
+        spawn(dt, statistics);
+
+        ++mnFrame;
+    }
+
+    statistics.alive = alive();
+
+    return statistics;
+}
+
+size_t AAPL::Particles::Engine::pack(const float* pModelViewProjection, Vertex* pVertices)
+{
+    const size_t count = alive();
+
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    sort(pModelViewProjection, count, pVertices);
+
+    return count;
+}
@@ -0,0 +1,129 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU particle engine. Particles live in a fixed pool of structure-of-arrays slots; emitters spawn
+ into slots taken from a free list and expired particles return to it. Every frame the pool is
+ integrated four slots per SIMD register in blocks spread over a thread pool, then the living
+ particles are radix sorted back to front by their depth in the view and packed into a vertex
+ stream for blending.
+ */
+
+#ifndef _AAPL_PARTICLE_ENGINE_H_
+#define _AAPL_PARTICLE_ENGINE_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace Particles
+    {
+        // Slots per task when integrating, sorting and packing
+        static const size_t kBlockSize = 16384;
+
+        // Bits of the quantised depth the particles are sorted by, eight per radix pass
+        static const uint32_t kDepthBits = 16;
+
+        struct Emitter
+        {
+            float position[3];
+            float direction[3];     // Unit vector the particles leave along
+            float spread;           // Largest sideways component before normalising, e.g. 0.1
+            float speed;            // Units per second
+            float rate;             // Particles per second
+            float lifespan;         // Seconds, greater than 0
+        };
+
+        // One point of the vertex stream
+        struct Vertex
+        {
+            float position[3];
+            float age;              // Fraction of the lifespan in [0, 1]
+        };
+
+        struct Statistics
+        {
+            size_t alive;
+            size_t spawned;
+            size_t retired;
+            size_t dropped;         // Spawns that found no free slot
+        };
+
+        class Engine
+        {
+        public:
+            // The pool, when given, runs integration, sorting and packing in parallel
+            explicit Engine(const size_t& capacity, Threads::WorkStealingPool* pPool = nullptr);
+
+            virtual ~Engine();
+
+            size_t capacity() const;
+            size_t alive() const;
+
+            // Acceleration shared by every particle, e.g. gravity
+            void setAcceleration(const float& x, const float& y, const float& z);
+
+            size_t addEmitter(const Emitter& rEmitter);
+
+            size_t   emitterCount() const;
+            Emitter& emitter(const size_t& index);
+
+            // Advance dt seconds: move every particle, retire the ones past their lifespan and
+            // spawn the emitters' new particles, spread over the step
+            Statistics update(const float& dt);
+
+            // Write the living particles to pVertices (room for capacity() vertices), farthest
+            // first by their clip space w under a column major model-view-projection matrix.
+            // Returns the number of vertices.
+            size_t pack(const float* pModelViewProjection, Vertex* pVertices);
+
+        private:
+            void parallelFor(const size_t& count, const std::function<void(size_t)>& rBody);
+
+            void integrate(const float& dt, Statistics& rStatistics);
+            void spawn(const float& dt, Statistics& rStatistics);
+            void sort(const float* pModelViewProjection, const size_t& count, Vertex* pVertices);
+
+        private:
+            Threads::WorkStealingPool*         mpPool;
+
+            size_t                             mnCapacity;
+            float                              m_Acceleration[3];
+            uint32_t                           mnFrame;
+
+            // Slots, structure of arrays
+            std::vector<float>                 m_Positions[3];
+            std::vector<float>                 m_Velocities[3];
+            std::vector<float>                 m_Ages;
+            std::vector<float>                 m_Lifespans;
+
+            std::vector<uint32_t>              m_Free;             // Stack of free slots
+            std::vector<std::vector<uint32_t>> m_Retired;          // Per block, slots expired this step
+
+            std::vector<Emitter>               m_Emitters;
+            std::vector<float>                 m_Pending;          // Per emitter, fraction of a particle
+
+            // Sorting
+            std::vector<float>                 m_Depths;           // Per slot
+            std::vector<uint32_t>              m_BlockCounts;      // Living slots per block
+            std::vector<float>                 m_BlockRanges;      // Least and greatest depth per block
+            std::vector<uint16_t>              m_Keys[2];
+            std::vector<Vertex>                m_Vertices[2];
+            std::vector<uint32_t>              m_Histograms;       // 256 per block
+        }; // Class Engine
+    } // Particles
+} // AAPL
+
+#endif
+
+#endif
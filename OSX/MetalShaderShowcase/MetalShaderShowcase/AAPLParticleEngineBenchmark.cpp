@@ -0,0 +1,188 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the particle engine, a standalone program that is not part of the app target. It
+ fills a pool of 5 million particles from three fountains that together spawn a little faster
+ than the particles expire, so that the pool runs full and the free list is exercised at both
+ ends. Every frame it checks that the free list balances, i.e. that the particles alive equal
+ those spawned less those retired and that the engine packs exactly that many vertices, that
+ every age lies in [0, 1] and that the vertices run back to front by their clip space w to within
+ one step of the quantised depth. It then reports the time per frame of the update and of the
+ sort and pack, on a pool and on the calling thread alone.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLParticleEngine.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp AAPLParticleEngineBenchmark.cpp -o benchmark
+     ./benchmark [capacity]
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "AAPLParticleEngine.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::Particles;
+
+namespace
+{
+    const int   kFrames        = 150;
+    const int   kWarmUpFrames  = 90;     // Until the pool has run full
+    const float kFrameDuration = 1.0f / 60.0f;
+
+    // Column major model-view-projection of a camera 4 units out, turned so that both x and z
+    // move the depth; only the fourth row, the clip space w, matters to the sort
+    const float kModelViewProjection[16] =
+    {
+        1.2f,  0.0f, 0.0f,  -0.6f,
+        0.0f,  1.8f, 0.0f,   0.0f,
+        -0.9f, 0.0f, -1.0f, -0.8f,
+        0.0f,  0.0f, 3.8f,   4.0f
+    };
+
+    float depth(const Vertex& rVertex)
+    {
+        const float* m = kModelViewProjection;
+
+        return m[3] * rVertex.position[0] + m[7] * rVertex.position[1] + m[11] * rVertex.position[2] + m[15];
+    }
+
+    // Index of the first vertex out of back to front order or with an age outside [0, 1], or
+    // count when there is none
+    size_t firstMisordered(const Vertex* pVertices, const size_t& count)
+    {
+        float nearest  = FLT_MAX;
+        float farthest = -FLT_MAX;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            nearest  = std::min(nearest, depth(pVertices[i]));
+            farthest = std::max(farthest, depth(pVertices[i]));
+        }
+
+        // One step of the quantised depth, and rounding of w itself
+        const float tolerance = (farthest - nearest) / float((1u << kDepthBits) - 1) + 1.0e-5f * std::max(std::abs(nearest), std::abs(farthest));
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            const bool ordered = (i == 0) || (depth(pVertices[i]) <= depth(pVertices[i - 1]) + tolerance);
+            const bool aged    = (pVertices[i].age >= 0.0f) && (pVertices[i].age <= 1.0f);
+
+            if(!ordered || !aged)
+            {
+                return i;
+            }
+        }
+
+        return count;
+    }
+
+    bool run(const size_t& capacity, Threads::WorkStealingPool* pPool, const char* pLabel)
+    {
+        Engine engine(capacity, pPool);
+
+        engine.setAcceleration(0.0f, -1.8f, 0.0f);
+
+        // One second lifespans, so the fountains together spawn 5% more than the pool holds
+        for(int e = 0; e < 3; ++e)
+        {
+            const Emitter emitter = {{float(e) - 1.0f, 0.1f, 0.0f}, {0.0f, 1.0f, 0.0f}, 0.1f, 1.5f, float(capacity) / 3.0f * 1.05f, 1.0f};
+
+            engine.addEmitter(emitter);
+        }
+
+        std::vector<Vertex> vertices(capacity);
+
+        Statistics totals     = {};
+        Statistics statistics = {};
+
+        double updateTime = 0.0;
+        double packTime   = 0.0;
+
+        for(int frame = 0; frame < kFrames; ++frame)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            statistics = engine.update(kFrameDuration);
+
+            const auto updated = std::chrono::steady_clock::now();
+
+            const size_t count = engine.pack(kModelViewProjection, vertices.data());
+
+            const auto packed = std::chrono::steady_clock::now();
+
+            totals.spawned += statistics.spawned;
+            totals.retired += statistics.retired;
+            totals.dropped += statistics.dropped;
+
+            if((totals.spawned - totals.retired != engine.alive()) || (statistics.alive != engine.alive()) || (count != engine.alive()))
+            {
+                std::printf("%s, frame %d: %zu spawned less %zu retired, but %zu alive and %zu packed\n",
+                            pLabel, frame, totals.spawned, totals.retired, engine.alive(), count);
+
+                return false;
+            }
+
+            const size_t misordered = firstMisordered(vertices.data(), count);
+
+            if(misordered != count)
+            {
+                std::printf("%s, frame %d: vertex %zu of %zu is out of order or has age %g\n", pLabel, frame, misordered, count, vertices[misordered].age);
+
+                return false;
+            }
+
+            if(frame >= kWarmUpFrames)
+            {
+                updateTime += std::chrono::duration<double, std::milli>(updated - start).count();
+                packTime   += std::chrono::duration<double, std::milli>(packed - updated).count();
+            }
+        }
+
+        const int measured = kFrames - kWarmUpFrames;
+
+        std::printf("%-16s %zu alive, %zu spawned, %zu retired, %zu dropped in the last frame; update %.2f ms, sort and pack %.2f ms per frame\n",
+                    pLabel, statistics.alive, statistics.spawned, statistics.retired, statistics.dropped,
+                    updateTime / measured, packTime / measured);
+
+        // The pool runs full, so some spawns must have found no slot
+        if(totals.dropped == 0)
+        {
+            std::printf("%s: the pool never ran full\n", pLabel);
+
+            return false;
+        }
+
+        return true;
+    }
+} // unnamed
+
+int main(int argc, char** argv)
+{
+    const size_t capacity = (argc >= 2) ? size_t(std::strtoul(argv[1], nullptr, 10)) : 5000000;
+
+    if(capacity == 0)
+    {
+        std::printf("The capacity must be greater than 0\n");
+
+        return 1;
+    }
+
+    Threads::WorkStealingPool pool;
+
+    std::printf("%zu particles, %zu threads\n", capacity, pool.concurrency());
+
+    char label[32];
+
+    std::snprintf(label, sizeof(label), "%zu threads", pool.concurrency());
+
+    const bool pooled = run(capacity, &pool, label);
+    const bool serial = run(capacity, nullptr, "calling thread");
+
+    return (pooled && serial) ? 0 : 1;
+}
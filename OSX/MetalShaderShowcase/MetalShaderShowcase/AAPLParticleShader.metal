@@ -3,7 +3,7 @@
  See LICENSE.txt for this sample’s licensing information
  
  Abstract:
- A shader representing a particle system for the Metal Shader Showcase. Particles are a common effect implemented in many 3D applications.  Each particle's initial random direction and birth offset is passed into the vertex shader. It uses these values to calculate the particles position based on the current time. Then the fragment shader uses these points and colors them as circles that fade out at the edges.
+ A shader representing a particle system for the Metal Shader Showcase. Particles are a common effect implemented in many 3D applications.  The particles are simulated on the CPU (see AAPLParticleEngine.h), which passes each particle's position and the fraction of its lifespan it has lived to the vertex shader, sorted back to front. Then the fragment shader uses these points and colors them as circles that fade out at the edges.
  */
 
 #include <metal_stdlib>
@@ -16,20 +16,16 @@ using namespace metal;
 struct ColorInOut {
     float4 position [[position]];
     float point_size [[point_size]];
-    float t;
-    float lifespan;
+    float age;
 };
 
 // Global constants
 constant float POINT_SIZE = 60.0f;
-constant float3 a = float3(0.0, -1.8f, 0.0);
-constant float3 x_0 = float3(0.0, 0.1, 0.0);
 
 
 // Phong vertex shader function
-vertex ColorInOut particle_vertex(device packed_float3* initialDirection [[ buffer(0) ]],
-                                  device float* birthOffsets [[ buffer(1) ]],
-                                  constant AAPL::uniforms_t& uniforms [[ buffer(2) ]],
+vertex ColorInOut particle_vertex(device const AAPL::particle_t* particles [[ buffer(0) ]],
+                                  constant AAPL::uniforms_t& uniforms [[ buffer(1) ]],
                                   unsigned int vid [[ vertex_id ]])
 {
     ColorInOut out;
@@ -39,19 +35,13 @@ vertex ColorInOut particle_vertex(device packed_float3* initialDirection [[ buff
     float4x4 projection_matrix = uniforms.projection_matrix;
     float4x4 mvp_matrix = projection_matrix * view_matrix * model_matrix;
     
-    // Have the particles repeat their movement by keeping their time between 0 and their
-    // lifespan.
-    float t = fmod(uniforms.t + birthOffsets[vid], uniforms.lifespan);
-    
-    // Calculate the position of the particle based on the physics equation for motion:
-    // x = x_0 + (v_0 * t) + (1/2)(a * t^2)
-    float3 v_0 = float3( initialDirection[vid] );
-    float3 vertex_position_modelspace =  x_0 + (v_0 * t) + (0.5f * a * t * t);
+    // The CPU has already moved the particle; its age is the fraction of its lifespan lived
+    device const AAPL::particle_t& particle = particles[vid];
+    float3 vertex_position_modelspace = float3(particle.position[0], particle.position[1], particle.position[2]);
     out.position = mvp_matrix * float4(vertex_position_modelspace, 1.0f);
     
     out.point_size = POINT_SIZE;
-    out.t = t;
-    out.lifespan = uniforms.lifespan;
+    out.age = particle.age;
     return out;
 }
 
@@ -62,7 +52,7 @@ fragment half4 particle_fragment(ColorInOut in [[stage_in]], float2 uv[[point_co
     
     // Make the particle fade off as it gets older by multiplying the percentage of life
     // left for the particle by it's color.
-    float lifeAlpha = (in.lifespan - in.t) / in.lifespan;
+    float lifeAlpha = 1.0f - in.age;
     color *= lifeAlpha;
     
     // Make the particles circular by using the uv coordinate to calculate the distance
@@ -1,9 +1,9 @@
 /*
  Copyright (C) 2016 Apple Inc. All Rights Reserved.
  See LICENSE.txt for this sample’s licensing information
- 
+
  Abstract:
- Metal Particle System for Metal Shader Showpiece. Initializes the particle system data that is sent to the GPU.
+ Metal Particle System for Metal Shader Showpiece. Runs the CPU particle engine and packs its particles, sorted back to front, into the vertex buffers sent to the GPU.
  */
 
 #import <Foundation/Foundation.h>
@@ -12,10 +12,17 @@
 
 @interface AAPLParticleSystem : NSObject
 
-@property (nonatomic) id <MTLBuffer> initial_direction_buffer;
-@property (nonatomic) id <MTLBuffer> birth_offsets_buffer;
+// Particles in the buffer last returned by vertexBufferForModelViewProjection:
 @property (nonatomic, readonly) unsigned int num_particles;
 @property (nonatomic, readonly) float lifespan;
 
 - (instancetype)initWithDevice:(id <MTLDevice>)device;
+
+// Advance the simulation by dt seconds
+- (void)update:(float)dt;
+
+// Pack the living particles, farthest first, into the next of kInFlightCommandBuffers vertex
+// buffers of AAPL::particle_t. Call once per frame after waiting for a buffer to come free.
+- (id <MTLBuffer>)vertexBufferForModelViewProjection:(simd::float4x4)mvp;
+
 @end
@@ -1,21 +1,32 @@
 /*
  Copyright (C) 2016 Apple Inc. All Rights Reserved.
  See LICENSE.txt for this sample’s licensing information
- 
+
  Abstract:
- Metal Particle System for Metal Shader Showpiece. Initializes the particle system data that is sent to the GPU.
+ Metal Particle System for Metal Shader Showpiece. Runs the CPU particle engine and packs its particles, sorted back to front, into the vertex buffers sent to the GPU.
  */
 
+#import <memory>
+
 #import "AAPLParticleSystem.h"
+#import "AAPLRenderer.h"
+#import "AAPLParticleEngine.h"
+#import "WorkStealingPool.h"
 
-static const unsigned int NUM_PARTICLES = 200;
+static const unsigned int MAX_PARTICLES = 4096;
+static const unsigned int NUM_EMITTERS = 3;
+static const float EMITTER_RATE = 400.0f;
 static const float SPREAD = 0.1f;
 static const float LIFESPAN = 1.0f;
 
+static_assert(sizeof(AAPL::particle_t) == sizeof(AAPL::Particles::Vertex), "particle_t must match the engine's vertices");
+
 @implementation AAPLParticleSystem
 {
-    float* _initialDirection;
-    float* _birthOffsets;
+    std::unique_ptr<AAPL::Particles::Engine> _engine;
+
+    id <MTLBuffer> _vertexBuffers[kInFlightCommandBuffers];
+    unsigned int _vertexBufferIndex;
 }
 
 - (instancetype)initWithDevice:(id <MTLDevice>)device
@@ -23,48 +34,56 @@ static const float LIFESPAN = 1.0f;
     self = [super init];
     if (self)
     {
-        // Allocate and initialize the initial direction buffer
-        unsigned int initialDirectionDataSize = NUM_PARTICLES * 3 * sizeof(float);
-        _initialDirection = (float*) malloc(initialDirectionDataSize);
-        
-        // Set the initial direction as a random vector mostly pointing up with the variable
-        // SPREAD controlling the ammount the particles go out from the center.
-        for (unsigned int i = 0; i < NUM_PARTICLES; i++) {
-            
-            float d_0_x = ( (2.0f * ( (float)rand()/RAND_MAX ) ) - 1.0f) * SPREAD;
-            float d_0_y = ( (float)rand()/RAND_MAX );
-            float d_0_z = ( (2.0f * ( (float)rand()/RAND_MAX ) ) - 1.0f) * SPREAD;
-            float length = sqrtf(d_0_x*d_0_x + d_0_y*d_0_y + d_0_z*d_0_z);
-            
-            // Normalize the initial direction vector so the length of the vectoris always
-            // one.
-            _initialDirection[i*3] = d_0_x / length;
-            _initialDirection[i*3+1] = d_0_y / length;
-            _initialDirection[i*3+2] = d_0_z / length;
-            
+        // The engine's integration and sorting run on a pool shared by every particle system
+        static Threads::WorkStealingPool pool;
+
+        _engine.reset(new AAPL::Particles::Engine(MAX_PARTICLES, &pool));
+        _engine->setAcceleration(0.0f, -1.8f, 0.0f);
+
+        // A row of emitters shooting up, with SPREAD controlling the amount the particles go
+        // out from the center of each.
+        for (unsigned int i = 0; i < NUM_EMITTERS; i++) {
+
+            AAPL::Particles::Emitter emitter = {};
+
+            emitter.position[0] = 0.3f * (float(i) - 0.5f * float(NUM_EMITTERS - 1));
+            emitter.position[1] = 0.1f;
+            emitter.direction[1] = 1.0f;
+            emitter.spread = SPREAD;
+            emitter.speed = 1.0f;
+            emitter.rate = EMITTER_RATE;
+            emitter.lifespan = LIFESPAN;
+
+            _engine->addEmitter(emitter);
         }
-        
-        _initial_direction_buffer = [device newBufferWithBytes:_initialDirection  length:initialDirectionDataSize  options:MTLResourceOptionCPUCacheModeDefault];
-        _initial_direction_buffer.label = @"Velocities";
-        
-        // Allocate and initialize the birth offsets. These are random numbers between 0 and
-        // the lifespan that make it so all the particles don't come out of the emitter at
-        // the same time.
-        unsigned int birthOffsetsDataSize = NUM_PARTICLES * sizeof(float);
-        _birthOffsets = (float*) malloc(birthOffsetsDataSize);
-        
-        for (unsigned int i = 0; i < NUM_PARTICLES; i++) {
-            _birthOffsets[i] = ( (float)rand()/RAND_MAX ) * LIFESPAN;
+
+        for (unsigned int i = 0; i < kInFlightCommandBuffers; i++) {
+            _vertexBuffers[i] = [device newBufferWithLength:MAX_PARTICLES * sizeof(AAPL::particle_t) options:MTLResourceOptionCPUCacheModeDefault];
+            _vertexBuffers[i].label = @"Particles";
         }
-        
-        _birth_offsets_buffer = [device newBufferWithBytes:_birthOffsets  length:birthOffsetsDataSize  options:MTLResourceOptionCPUCacheModeDefault];
-        _birth_offsets_buffer.label = @"Birth Offsets";
-        
-        
-        _num_particles = NUM_PARTICLES;
+
+        _vertexBufferIndex = 0;
+        _num_particles = 0;
         _lifespan = LIFESPAN;
     }
     return self;
 }
 
+- (void)update:(float)dt
+{
+    // Clamp long stalls so that a hitch doesn't release a second's worth of particles at once
+    _engine->update(MIN(dt, 0.1f));
+}
+
+- (id <MTLBuffer>)vertexBufferForModelViewProjection:(simd::float4x4)mvp
+{
+    id <MTLBuffer> buffer = _vertexBuffers[_vertexBufferIndex];
+
+    _vertexBufferIndex = (_vertexBufferIndex + 1) % kInFlightCommandBuffers;
+
+    _num_particles = (unsigned int)_engine->pack((const float *)&mvp, (AAPL::Particles::Vertex *)[buffer contents]);
+
+    return buffer;
+}
+
 @end
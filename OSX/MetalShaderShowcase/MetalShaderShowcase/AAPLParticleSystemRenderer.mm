@@ -20,7 +20,6 @@
 @implementation AAPLParticleSystemRenderer
 {
     // particle system data
-    NSDate* _startTime;
     AAPLParticleSystem* _particleSystem;
 }
 
@@ -40,12 +39,11 @@
 
 #pragma mark RENDER VIEW DELEGATE METHODS
 
-// Overriding base class method to create the particle system, it's timer, and to set the particle's lifespan
+// Overriding base class method to create the particle system and to set the particle's lifespan
 - (void)configure:(AAPLView *)view
 {
     [super configure:view];
 
-    _startTime = [NSDate date];
     _particleSystem = [[AAPLParticleSystem alloc] initWithDevice:self.device];
     
     AAPL::uniforms_t* bufferPointer = (AAPL::uniforms_t *)[_dynamicConstantBuffer contents];
@@ -58,16 +56,17 @@
     [renderEncoder pushDebugGroup:name];
     [renderEncoder setRenderPipelineState:_pipelineState];
     
+    // Sort the particles back to front for this frame's view so that they blend in order
+    AAPL::uniforms_t* bufferPointer = (AAPL::uniforms_t *)[_dynamicConstantBuffer contents];
+    simd::float4x4 mvp_matrix = bufferPointer->projection_matrix * bufferPointer->view_matrix * bufferPointer->model_matrix;
+    id <MTLBuffer> particles = [_particleSystem vertexBufferForModelViewProjection:mvp_matrix];
+    
     // Go through the reflection items and set the buffers
     for (MTLArgument *arg in _reflection.vertexArguments)
     {
-        if ([arg.name isEqualToString:@"initialDirection"])
-        {
-            [renderEncoder setVertexBuffer:_particleSystem.initial_direction_buffer offset:0 atIndex:arg.index];
-        }
-        else if ([arg.name isEqualToString:@"birthOffsets"])
+        if ([arg.name isEqualToString:@"particles"])
         {
-            [renderEncoder setVertexBuffer:_particleSystem.birth_offsets_buffer offset:0 atIndex:arg.index];
+            [renderEncoder setVertexBuffer:particles offset:0 atIndex:arg.index];
         }
         else if ([arg.name isEqualToString:@"uniforms"])
         {
@@ -82,16 +81,15 @@
 
 #pragma mark VIEW CONTROLLER DELEGATE METHODS
 
-// Overriding base class method to update the time of the particle system and make it not rotate
+// Overriding base class method to step the particle system and make it not rotate
 - (void)update:(AAPLViewController *)controller
 {
     AAPL::uniforms_t* bufferPointer = (AAPL::uniforms_t *)[_dynamicConstantBuffer contents];
     simd::float4x4 model_matrix = AAPL::translate(0.0f, -0.2f, 1.0f);
     bufferPointer->model_matrix = model_matrix;
     
-    // Update the time for our paticle system
-    NSDate* currentTime = [NSDate date];
-    bufferPointer->t = [currentTime timeIntervalSinceDate:_startTime];
+    // Move, retire and spawn the particles on the CPU
+    [_particleSystem update:controller.timeSinceLastDraw];
 }
 
 
@@ -0,0 +1,869 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Bicubic Bézier patch meshes. A patch set is loaded from Newell's text format or built from the
+ classic 32-patch Utah teapot, then evaluated at any density: the Bernstein basis and its
+ derivative are tabulated once per density, every row of a patch contracts the control points
+ along v, and the row is finished four u values per SIMD register into positions and unit
+ normals. Patches are spread over a thread pool. The control points can also be exported as is
+ for a post-tessellation vertex function that evaluates the patches on the GPU.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+#include "AAPLPatchMesh.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SIMD
+
+namespace AAPL
+{
+    namespace PatchMesh
+    {
+        // Four u values per register
+        struct float4
+        {
+#if defined(__SSE2__)
+            __m128 v;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            float32x4_t v;
+#else
+            float v[4];
+#endif
+        };
+
+#if defined(__SSE2__)
+        static inline float4 load(const float* p)                        { return {_mm_loadu_ps(p)}; }
+        static inline void   store(float* p, const float4& a)            { _mm_storeu_ps(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {_mm_set1_ps(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {_mm_add_ps(a.v, b.v)}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {_mm_sub_ps(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {_mm_mul_ps(a.v, b.v)}; }
+
+        static inline float4 rsqrt(const float4& a)
+        {
+            return {_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a.v))};
+        }
+
+        // One bit per lane where a < b
+        static inline uint32_t less(const float4& a, const float4& b)
+        {
+            return uint32_t(_mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)));
+        }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        static inline float4 load(const float* p)                        { return {vld1q_f32(p)}; }
+        static inline void   store(float* p, const float4& a)            { vst1q_f32(p, a.v); }
+        static inline float4 splat(const float& s)                       { return {vdupq_n_f32(s)}; }
+        static inline float4 operator+(const float4& a, const float4& b) { return {vaddq_f32(a.v, b.v)}; }
+        static inline float4 operator-(const float4& a, const float4& b) { return {vsubq_f32(a.v, b.v)}; }
+        static inline float4 operator*(const float4& a, const float4& b) { return {vmulq_f32(a.v, b.v)}; }
+
+        static inline float4 rsqrt(const float4& a)
+        {
+            return {vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(a.v))};
+        }
+
+        static inline uint32_t less(const float4& a, const float4& b)
+        {
+            static const uint32_t weights[4] = {1, 2, 4, 8};
+
+            return vaddvq_u32(vandq_u32(vcltq_f32(a.v, b.v), vld1q_u32(weights)));
+        }
+#else
+        static inline float4 load(const float* p)             { return {{p[0], p[1], p[2], p[3]}}; }
+        static inline void   store(float* p, const float4& a) { std::copy(a.v, a.v + 4, p); }
+        static inline float4 splat(const float& s)            { return {{s, s, s, s}}; }
+
+        static inline float4 operator+(const float4& a, const float4& b)
+        {
+            return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+        }
+
+        static inline float4 operator-(const float4& a, const float4& b)
+        {
+            return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+        }
+
+        static inline float4 operator*(const float4& a, const float4& b)
+        {
+            return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+        }
+
+        static inline float4 rsqrt(const float4& a)
+        {
+            return {{1.0f / std::sqrt(a.v[0]), 1.0f / std::sqrt(a.v[1]), 1.0f / std::sqrt(a.v[2]), 1.0f / std::sqrt(a.v[3])}};
+        }
+
+        static inline uint32_t less(const float4& a, const float4& b)
+        {
+            return (a.v[0] < b.v[0] ? 1u : 0u) | (a.v[1] < b.v[1] ? 2u : 0u) |
+                   (a.v[2] < b.v[2] ? 4u : 0u) | (a.v[3] < b.v[3] ? 8u : 0u);
+        }
+#endif
+
+        // Sums the outer and the inner pair of terms first. A neighbour walking the shared edge the
+        // other way adds the same products in swapped order, which rounds identically.
+        static inline float4 blend(const float4* pWeights, const float4* pValues)
+        {
+            return (pWeights[0] * pValues[0] + pWeights[3] * pValues[3]) +
+                   (pWeights[1] * pValues[1] + pWeights[2] * pValues[2]);
+        }
+    } // PatchMesh
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Curves
+
+namespace AAPL
+{
+    namespace PatchMesh
+    {
+        // A cross product this small, relative to the tangents or to the patch's size (both squared
+        // twice), has lost its direction to rounding and the normal is taken beside the point
+        static const float kDegenerate = 1.0e-10f;
+
+        // How far beside the point, in parameter space
+        static const float kNudge = 1.0e-3f;
+
+        // Cubic Bernstein polynomials at t, with s = 1 - t computed by the caller. B_1 and B_2 are the
+        // same expression with t and s swapped, so t and 1 - t give mirrored values bit for bit.
+        static inline void bernstein(const float& t, const float& s, float* pBasis, float* pDerivative)
+        {
+            pBasis[0] = s * s * s;
+            pBasis[1] = 3.0f * t * s * s;
+            pBasis[2] = 3.0f * s * t * t;
+            pBasis[3] = t * t * t;
+
+            pDerivative[0] = -3.0f * s * s;
+            pDerivative[1] = 3.0f * s * s - 6.0f * t * s;
+            pDerivative[2] = 6.0f * s * t - 3.0f * t * t;
+            pDerivative[3] = 3.0f * t * t;
+        }
+
+        // De Casteljau on a cubic of three-component points, with the tangent from the last level
+        static void curve(const float (*pPoints)[3], const float& t, float* pPoint, float* pTangent)
+        {
+            float p[4][3];
+
+            std::copy(&pPoints[0][0], &pPoints[0][0] + 12, &p[0][0]);
+
+            for(size_t level = 3; level > 1; --level)
+            {
+                for(size_t i = 0; i < level; ++i)
+                {
+                    for(size_t c = 0; c < 3; ++c)
+                    {
+                        p[i][c] += t * (p[i + 1][c] - p[i][c]);
+                    }
+                }
+            }
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                pTangent[c] = 3.0f * (p[1][c] - p[0][c]);
+                pPoint[c]   = p[0][c] + t * (p[1][c] - p[0][c]);
+            }
+        }
+
+        // Position and both tangents at (u, v)
+        static void point(const PatchSet& set,
+                          const Patch& patch,
+                          const float& u,
+                          const float& v,
+                          float* pPosition,
+                          float* pDu,
+                          float* pDv)
+        {
+            float rows[4][3];
+            float tangents[4][3];
+
+            for(size_t row = 0; row < 4; ++row)
+            {
+                float points[4][3];
+
+                for(size_t column = 0; column < 4; ++column)
+                {
+                    std::copy_n(&set.points[3 * patch.indices[4 * row + column]], 3, points[column]);
+                }
+
+                curve(points, u, rows[row], tangents[row]);
+            }
+
+            float unused[3];
+
+            curve(rows, v, pPosition, pDv);
+            curve(tangents, v, pDu, unused);
+        }
+
+        static inline void cross(const float* a, const float* b, float* pResult)
+        {
+            pResult[0] = a[1] * b[2] - a[2] * b[1];
+            pResult[1] = a[2] * b[0] - a[0] * b[2];
+            pResult[2] = a[0] * b[1] - a[1] * b[0];
+        }
+
+        static inline float dot(const float* a, const float* b)
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        // Smallest |dP/du x dP/dv|^2 left to rounding: the squared diagonal of the control points'
+        // bounds, squared again
+        static float threshold(const PatchSet& set, const Patch& patch)
+        {
+            float lower[3] = { FLT_MAX,  FLT_MAX,  FLT_MAX};
+            float upper[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+            for(const uint32_t& index : patch.indices)
+            {
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    lower[c] = std::min(lower[c], set.points[3 * index + c]);
+                    upper[c] = std::max(upper[c], set.points[3 * index + c]);
+                }
+            }
+
+            const float diagonal[3] = {upper[0] - lower[0], upper[1] - lower[1], upper[2] - lower[2]};
+            const float size2       = dot(diagonal, diagonal);
+
+            return kDegenerate * size2 * size2;
+        }
+
+        static inline void normalize(float* pVector)
+        {
+            const float length = std::sqrt(dot(pVector, pVector));
+
+            if(length > 0.0f)
+            {
+                pVector[0] /= length;
+                pVector[1] /= length;
+                pVector[2] /= length;
+            }
+        }
+
+        // Where an edge collapses into a pole the cross product vanishes; the limit is taken from a
+        // point slightly inside the patch
+        static void poleNormal(const PatchSet& set, const Patch& patch, const float& u, const float& v, float* pNormal)
+        {
+            const float inside[2] =
+            {
+                (u < 0.5f) ? (u + kNudge) : (u - kNudge),
+                (v < 0.5f) ? (v + kNudge) : (v - kNudge)
+            };
+
+            float position[3];
+            float du[3];
+            float dv[3];
+
+            point(set, patch, inside[0], inside[1], position, du, dv);
+            cross(du, dv, pNormal);
+            normalize(pNormal);
+        }
+
+        static inline float* element(const Stream& stream, const size_t& index)
+        {
+            return reinterpret_cast<float*>(static_cast<uint8_t*>(stream.pData) + index * stream.stride);
+        }
+    } // PatchMesh
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Teapot
+
+namespace AAPL
+{
+    namespace PatchMesh
+    {
+        // The compact form of Newell's data: ten patches of one quadrant, rim, body, lid and bottom
+        // mirrored into the other three, handle and spout across the xz plane
+        static const uint32_t kTeapotPatches[10][16] =
+        {
+            // Rim
+            {102, 103, 104, 105,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15},
+
+            // Body
+            { 12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27},
+            { 24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40},
+
+            // Lid
+            { 96,  96,  96,  96,  97,  98,  99, 100, 101, 101, 101, 101,   0,   1,   2,   3},
+            {  0,   1,   2,   3, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117},
+
+            // Bottom
+            {118, 118, 118, 118, 124, 122, 119, 121, 123, 126, 125, 120,  40,  39,  38,  37},
+
+            // Handle
+            { 41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56},
+            { 53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  28,  65,  66,  67},
+
+            // Spout
+            { 68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83},
+            { 80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95}
+        };
+
+        // Patches mirrored into all four quadrants; the others only across the xz plane
+        static const size_t kTeapotSymmetric = 6;
+
+        static const float kTeapotPoints[127][3] =
+        {
+            {0.2f, 0.0f, 2.7f},         {0.2f, -0.112f, 2.7f},      {0.112f, -0.2f, 2.7f},      {0.0f, -0.2f, 2.7f},
+            {1.3375f, 0.0f, 2.53125f},  {1.3375f, -0.749f, 2.53125f}, {0.749f, -1.3375f, 2.53125f}, {0.0f, -1.3375f, 2.53125f},
+            {1.4375f, 0.0f, 2.53125f},  {1.4375f, -0.805f, 2.53125f}, {0.805f, -1.4375f, 2.53125f}, {0.0f, -1.4375f, 2.53125f},
+            {1.5f, 0.0f, 2.4f},         {1.5f, -0.84f, 2.4f},       {0.84f, -1.5f, 2.4f},       {0.0f, -1.5f, 2.4f},
+            {1.75f, 0.0f, 1.875f},      {1.75f, -0.98f, 1.875f},    {0.98f, -1.75f, 1.875f},    {0.0f, -1.75f, 1.875f},
+            {2.0f, 0.0f, 1.35f},        {2.0f, -1.12f, 1.35f},      {1.12f, -2.0f, 1.35f},      {0.0f, -2.0f, 1.35f},
+            {2.0f, 0.0f, 0.9f},         {2.0f, -1.12f, 0.9f},       {1.12f, -2.0f, 0.9f},       {0.0f, -2.0f, 0.9f},
+            {-2.0f, 0.0f, 0.9f},        {2.0f, 0.0f, 0.45f},        {2.0f, -1.12f, 0.45f},      {1.12f, -2.0f, 0.45f},
+            {0.0f, -2.0f, 0.45f},       {1.5f, 0.0f, 0.225f},       {1.5f, -0.84f, 0.225f},     {0.84f, -1.5f, 0.225f},
+            {0.0f, -1.5f, 0.225f},      {1.5f, 0.0f, 0.15f},        {1.5f, -0.84f, 0.15f},      {0.84f, -1.5f, 0.15f},
+            {0.0f, -1.5f, 0.15f},       {-1.6f, 0.0f, 2.025f},      {-1.6f, -0.3f, 2.025f},     {-1.5f, -0.3f, 2.25f},
+            {-1.5f, 0.0f, 2.25f},       {-2.3f, 0.0f, 2.025f},      {-2.3f, -0.3f, 2.025f},     {-2.5f, -0.3f, 2.25f},
+            {-2.5f, 0.0f, 2.25f},       {-2.7f, 0.0f, 2.025f},      {-2.7f, -0.3f, 2.025f},     {-3.0f, -0.3f, 2.25f},
+            {-3.0f, 0.0f, 2.25f},       {-2.7f, 0.0f, 1.8f},        {-2.7f, -0.3f, 1.8f},       {-3.0f, -0.3f, 1.8f},
+            {-3.0f, 0.0f, 1.8f},        {-2.7f, 0.0f, 1.575f},      {-2.7f, -0.3f, 1.575f},     {-3.0f, -0.3f, 1.35f},
+            {-3.0f, 0.0f, 1.35f},       {-2.5f, 0.0f, 1.125f},      {-2.5f, -0.3f, 1.125f},     {-2.65f, -0.3f, 0.9375f},
+            {-2.65f, 0.0f, 0.9375f},    {-2.0f, -0.3f, 0.9f},       {-1.9f, -0.3f, 0.6f},       {-1.9f, 0.0f, 0.6f},
+            {1.7f, 0.0f, 1.425f},       {1.7f, -0.66f, 1.425f},     {1.7f, -0.66f, 0.6f},       {1.7f, 0.0f, 0.6f},
+            {2.6f, 0.0f, 1.425f},       {2.6f, -0.66f, 1.425f},     {3.1f, -0.66f, 0.825f},     {3.1f, 0.0f, 0.825f},
+            {2.3f, 0.0f, 2.1f},         {2.3f, -0.25f, 2.1f},       {2.4f, -0.25f, 2.025f},     {2.4f, 0.0f, 2.025f},
+            {2.7f, 0.0f, 2.4f},         {2.7f, -0.25f, 2.4f},       {3.3f, -0.25f, 2.4f},       {3.3f, 0.0f, 2.4f},
+            {2.8f, 0.0f, 2.475f},       {2.8f, -0.25f, 2.475f},     {3.525f, -0.25f, 2.49375f}, {3.525f, 0.0f, 2.49375f},
+            {2.9f, 0.0f, 2.475f},       {2.9f, -0.15f, 2.475f},     {3.45f, -0.15f, 2.5125f},   {3.45f, 0.0f, 2.5125f},
+            {2.8f, 0.0f, 2.4f},         {2.8f, -0.15f, 2.4f},       {3.2f, -0.15f, 2.4f},       {3.2f, 0.0f, 2.4f},
+            {0.0f, 0.0f, 3.15f},        {0.8f, 0.0f, 3.15f},        {0.8f, -0.45f, 3.15f},      {0.45f, -0.8f, 3.15f},
+            {0.0f, -0.8f, 3.15f},       {0.0f, 0.0f, 2.85f},        {1.4f, 0.0f, 2.4f},         {1.4f, -0.784f, 2.4f},
+            {0.784f, -1.4f, 2.4f},      {0.0f, -1.4f, 2.4f},        {0.4f, 0.0f, 2.55f},        {0.4f, -0.224f, 2.55f},
+            {0.224f, -0.4f, 2.55f},     {0.0f, -0.4f, 2.55f},       {1.3f, 0.0f, 2.55f},        {1.3f, -0.728f, 2.55f},
+            {0.728f, -1.3f, 2.55f},     {0.0f, -1.3f, 2.55f},       {1.3f, 0.0f, 2.4f},         {1.3f, -0.728f, 2.4f},
+            {0.728f, -1.3f, 2.4f},      {0.0f, -1.3f, 2.4f},        {0.0f, 0.0f, 0.0f},         {1.425f, -0.798f, 0.0f},
+            {1.5f, 0.0f, 0.075f},       {1.425f, 0.0f, 0.0f},       {0.798f, -1.425f, 0.0f},    {0.0f, -1.5f, 0.075f},
+            {0.0f, -1.425f, 0.0f},      {1.5f, -0.84f, 0.075f},     {0.84f, -1.5f, 0.075f}
+        };
+
+        // Mirror images of the quadrant: signs of x and y, and whether the mirror turns the patch
+        // inside out, which reversing its rows undoes
+        struct Mirror
+        {
+            float x;
+            float y;
+            bool  reverse;
+        };
+
+        static const Mirror kTeapotMirrors[4] =
+        {
+            { 1.0f,  1.0f, false},
+            { 1.0f, -1.0f, true},
+            {-1.0f,  1.0f, true},
+            {-1.0f, -1.0f, false}
+        };
+    } // PatchMesh
+} // AAPL
+
+#pragma mark -
+#pragma mark Private - Evaluator
+
+void AAPL::PatchMesh::Evaluator::tabulate()
+{
+    const size_t count = mnSegments + 1;
+
+    mnPadded = (count + 3) & ~size_t(3);
+
+    m_Basis.assign(4 * mnPadded, 0.0f);
+    m_Derivative.assign(4 * mnPadded, 0.0f);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        // Both from the integers, so parameter i of one patch mirrors parameter n - i of another exactly
+        const float t = float(i) / float(mnSegments);
+        const float s = float(mnSegments - i) / float(mnSegments);
+
+        float basis[4];
+        float derivative[4];
+
+        bernstein(t, s, basis, derivative);
+
+        for(size_t k = 0; k < 4; ++k)
+        {
+            m_Basis[k * mnPadded + i]      = basis[k];
+            m_Derivative[k * mnPadded + i] = derivative[k];
+        }
+    }
+}
+
+void AAPL::PatchMesh::Evaluator::evaluate(const PatchSet& set,
+                                          const size_t& index,
+                                          const Stream& positions,
+                                          const Stream& normals) const
+{
+    const Patch& patch = set.patches[index];
+    const size_t count = mnSegments + 1;
+    const size_t first = index * count * count;
+
+    const float4 minimum = splat(threshold(set, patch));
+
+    float4 points[4][4][3];
+
+    for(size_t row = 0; row < 4; ++row)
+    {
+        for(size_t column = 0; column < 4; ++column)
+        {
+            const float* p = &set.points[3 * patch.indices[4 * row + column]];
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                points[row][column][c] = splat(p[c]);
+            }
+        }
+    }
+
+    for(size_t j = 0; j < count; ++j)
+    {
+        // The row's curve and its v derivative: control points contracted along v
+        const float4 bv[4] = {splat(m_Basis[j]), splat(m_Basis[mnPadded + j]),
+                              splat(m_Basis[2 * mnPadded + j]), splat(m_Basis[3 * mnPadded + j])};
+        const float4 dv[4] = {splat(m_Derivative[j]), splat(m_Derivative[mnPadded + j]),
+                              splat(m_Derivative[2 * mnPadded + j]), splat(m_Derivative[3 * mnPadded + j])};
+
+        float4 curve[3][4];
+        float4 slope[3][4];
+
+        for(size_t column = 0; column < 4; ++column)
+        {
+            for(size_t c = 0; c < 3; ++c)
+            {
+                const float4 values[4] = {points[0][column][c], points[1][column][c], points[2][column][c], points[3][column][c]};
+
+                curve[c][column] = blend(bv, values);
+                slope[c][column] = blend(dv, values);
+            }
+        }
+
+        for(size_t i = 0; i < count; i += 4)
+        {
+            const float4 bu[4] = {load(&m_Basis[i]), load(&m_Basis[mnPadded + i]),
+                                  load(&m_Basis[2 * mnPadded + i]), load(&m_Basis[3 * mnPadded + i])};
+            const float4 du[4] = {load(&m_Derivative[i]), load(&m_Derivative[mnPadded + i]),
+                                  load(&m_Derivative[2 * mnPadded + i]), load(&m_Derivative[3 * mnPadded + i])};
+
+            const size_t lanes = std::min(count - i, size_t(4));
+
+            float position[3][4];
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                store(position[c], blend(bu, curve[c]));
+            }
+
+            for(size_t lane = 0; lane < lanes; ++lane)
+            {
+                float* p = element(positions, first + j * count + i + lane);
+
+                p[0] = position[0][lane];
+                p[1] = position[1][lane];
+                p[2] = position[2][lane];
+            }
+
+            if(!normals.pData)
+            {
+                continue;
+            }
+
+            const float4 tu[3] = {blend(du, curve[0]), blend(du, curve[1]), blend(du, curve[2])};
+            const float4 tv[3] = {blend(bu, slope[0]), blend(bu, slope[1]), blend(bu, slope[2])};
+
+            const float4 n[3] =
+            {
+                tu[1] * tv[2] - tu[2] * tv[1],
+                tu[2] * tv[0] - tu[0] * tv[2],
+                tu[0] * tv[1] - tu[1] * tv[0]
+            };
+
+            const float4 length2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+            const float4 scale   = (tu[0] * tu[0] + tu[1] * tu[1] + tu[2] * tu[2]) *
+                                   (tv[0] * tv[0] + tv[1] * tv[1] + tv[2] * tv[2]);
+
+            // |n|^2 = |tu|^2 |tv|^2 sin^2; at a pole the vanishing tangent is rounding noise of any direction
+            const uint32_t regular = less(scale * splat(kDegenerate), length2) & less(minimum, length2);
+
+            const float4 inverse = rsqrt(length2);
+
+            float normal[3][4];
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                store(normal[c], n[c] * inverse);
+            }
+
+            for(size_t lane = 0; lane < lanes; ++lane)
+            {
+                float* p = element(normals, first + j * count + i + lane);
+
+                if(regular & (1u << lane))
+                {
+                    p[0] = normal[0][lane];
+                    p[1] = normal[1][lane];
+                    p[2] = normal[2][lane];
+                }
+                else
+                {
+                    poleNormal(set, patch, float(i + lane) / float(mnSegments), float(j) / float(mnSegments), p);
+                }
+            }
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Public - Patch Sets
+
+bool AAPL::PatchMesh::parse(const char* pText, const size_t& length, PatchSet& rSet)
+{
+    rSet.points.clear();
+    rSet.patches.clear();
+
+    if(!pText)
+    {
+        return false;
+    }
+
+    // strtol and strtof need a terminated string
+    const std::string text(pText, length);
+
+    const char* pCursor = text.c_str();
+
+    auto skip = [&]()
+    {
+        while(*pCursor == ',' || std::isspace(static_cast<unsigned char>(*pCursor)))
+        {
+            ++pCursor;
+        }
+    };
+
+    auto integer = [&](long& rValue) -> bool
+    {
+        skip();
+
+        char* pEnd = nullptr;
+
+        rValue = std::strtol(pCursor, &pEnd, 10);
+
+        const bool valid = (pEnd != pCursor);
+
+        pCursor = pEnd;
+
+        return valid;
+    };
+
+    auto real = [&](float& rValue) -> bool
+    {
+        skip();
+
+        char* pEnd = nullptr;
+
+        rValue = std::strtof(pCursor, &pEnd);
+
+        const bool valid = (pEnd != pCursor) && std::isfinite(rValue);
+
+        pCursor = pEnd;
+
+        return valid;
+    };
+
+    long patches = 0;
+
+    if(!integer(patches) || (patches <= 0) || (size_t(patches) > length / 16))
+    {
+        return false;
+    }
+
+    std::vector<Patch> set(patches);
+
+    for(Patch& rPatch : set)
+    {
+        for(uint32_t& rIndex : rPatch.indices)
+        {
+            long index = 0;
+
+            if(!integer(index) || (index < 1) || (index > long(UINT32_MAX)))
+            {
+                return false;
+            }
+
+            rIndex = uint32_t(index - 1);
+        }
+    }
+
+    long points = 0;
+
+    if(!integer(points) || (points <= 0) || (size_t(points) > length / 3))
+    {
+        return false;
+    }
+
+    std::vector<float> coordinates(3 * size_t(points));
+
+    for(float& rCoordinate : coordinates)
+    {
+        if(!real(rCoordinate))
+        {
+            return false;
+        }
+    }
+
+    for(const Patch& patch : set)
+    {
+        for(const uint32_t& index : patch.indices)
+        {
+            if(index >= size_t(points))
+            {
+                return false;
+            }
+        }
+    }
+
+    rSet.points.swap(coordinates);
+    rSet.patches.swap(set);
+
+    return true;
+}
+
+void AAPL::PatchMesh::teapot(PatchSet& rSet)
+{
+    rSet.points.clear();
+    rSet.patches.clear();
+
+    // Mirror images of points on the planes of symmetry coincide, and must share an index so the
+    // patches meeting there evaluate the same edge
+    std::map<std::array<float, 3>, uint32_t> indices;
+
+    auto add = [&](const float* pPoint, const Mirror& mirror) -> uint32_t
+    {
+        // Adding zero turns -0 into +0
+        const std::array<float, 3> key = {pPoint[0] * mirror.x + 0.0f, pPoint[1] * mirror.y + 0.0f, pPoint[2] + 0.0f};
+
+        auto result = indices.emplace(key, uint32_t(indices.size()));
+
+        if(result.second)
+        {
+            rSet.points.insert(rSet.points.end(), key.begin(), key.end());
+        }
+
+        return result.first->second;
+    };
+
+    for(size_t source = 0; source < 10; ++source)
+    {
+        const size_t mirrors = (source < kTeapotSymmetric) ? 4 : 2;
+
+        for(size_t m = 0; m < mirrors; ++m)
+        {
+            const Mirror& mirror = kTeapotMirrors[m];
+
+            Patch patch;
+
+            for(size_t row = 0; row < 4; ++row)
+            {
+                for(size_t column = 0; column < 4; ++column)
+                {
+                    const size_t from = 4 * row + (mirror.reverse ? 3 - column : column);
+
+                    patch.indices[4 * row + column] = add(kTeapotPoints[kTeapotPatches[source][from]], mirror);
+                }
+            }
+
+            rSet.patches.push_back(patch);
+        }
+    }
+}
+
+void AAPL::PatchMesh::transform(PatchSet& rSet, const float* pMatrix)
+{
+    const float* m = pMatrix;
+
+    for(size_t i = 0; i < rSet.points.size(); i += 3)
+    {
+        const float x = rSet.points[i];
+        const float y = rSet.points[i + 1];
+        const float z = rSet.points[i + 2];
+
+        rSet.points[i]     = m[0] * x + m[1] * y + m[2]  * z + m[3];
+        rSet.points[i + 1] = m[4] * x + m[5] * y + m[6]  * z + m[7];
+        rSet.points[i + 2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+    }
+}
+
+void AAPL::PatchMesh::controlPoints(const PatchSet& set, float* pControlPoints)
+{
+    for(const Patch& patch : set.patches)
+    {
+        for(const uint32_t& index : patch.indices)
+        {
+            std::copy_n(&set.points[3 * index], 3, pControlPoints);
+
+            pControlPoints[3] = 1.0f;
+            pControlPoints   += 4;
+        }
+    }
+}
+
+void AAPL::PatchMesh::evaluate(const PatchSet& set,
+                               const size_t& index,
+                               const float& u,
+                               const float& v,
+                               float* pPosition,
+                               float* pNormal)
+{
+    const Patch& patch = set.patches[index];
+
+    float du[3];
+    float dv[3];
+    float normal[3];
+
+    point(set, patch, u, v, pPosition, du, dv);
+    cross(du, dv, normal);
+
+    // The evaluator's test
+    const float length2 = dot(normal, normal);
+
+    if((dot(du, du) * dot(dv, dv) * kDegenerate < length2) && (threshold(set, patch) < length2))
+    {
+        normalize(normal);
+
+        std::copy_n(normal, 3, pNormal);
+
+        return;
+    }
+
+    poleNormal(set, patch, u, v, pNormal);
+}
+
+#pragma mark -
+#pragma mark Public - Evaluator
+
+AAPL::PatchMesh::Evaluator::Evaluator(const uint32_t& segments, Threads::WorkStealingPool* pPool)
+: mnSegments(std::max(segments, 1u)),
+  mnPadded(0),
+  mpPool(pPool)
+{
+    tabulate();
+} // Constructor
+
+AAPL::PatchMesh::Evaluator::~Evaluator()
+{
+} // Destructor
+
+void AAPL::PatchMesh::Evaluator::setSegments(const uint32_t& segments)
+{
+    const uint32_t clamped = std::max(segments, 1u);
+
+    if(clamped != mnSegments)
+    {
+        mnSegments = clamped;
+
+        tabulate();
+    }
+}
+
+uint32_t AAPL::PatchMesh::Evaluator::segments() const
+{
+    return mnSegments;
+}
+
+size_t AAPL::PatchMesh::Evaluator::vertexCount(const PatchSet& set) const
+{
+    const size_t count = mnSegments + 1;
+
+    return set.patches.size() * count * count;
+}
+
+size_t AAPL::PatchMesh::Evaluator::indexCount(const PatchSet& set) const
+{
+    return set.patches.size() * mnSegments * (2 * (mnSegments + 1) + 1);
+}
+
+void AAPL::PatchMesh::Evaluator::evaluate(const PatchSet& set, const Stream& positions, const Stream& normals) const
+{
+    const size_t patches = set.patches.size();
+
+    if(mpPool)
+    {
+        mpPool->parallelFor(patches, [&](size_t patch)
+        {
+            evaluate(set, patch, positions, normals);
+        }, 1);
+    }
+    else
+    {
+        for(size_t patch = 0; patch < patches; ++patch)
+        {
+            evaluate(set, patch, positions, normals);
+        }
+    }
+}
+
+bool AAPL::PatchMesh::Evaluator::indices(const PatchSet& set, void* pIndices, const size_t& indexSize) const
+{
+    const size_t vertices = vertexCount(set);
+
+    // All ones restarts the strip and mustn't be a vertex
+    const bool fits = ((indexSize == 2) && (vertices <= UINT16_MAX)) ||
+                      ((indexSize == 4) && (vertices <= UINT32_MAX));
+
+    if(!fits)
+    {
+        return false;
+    }
+
+    const size_t count = mnSegments + 1;
+
+    uint16_t* pShort = static_cast<uint16_t*>(pIndices);
+    uint32_t* pLong  = static_cast<uint32_t*>(pIndices);
+
+    size_t cursor = 0;
+
+    auto emit = [&](const uint32_t& index)
+    {
+        if(indexSize == 2)
+        {
+            pShort[cursor++] = uint16_t(index);
+        }
+        else
+        {
+            pLong[cursor++] = index;
+        }
+    };
+
+    for(size_t patch = 0; patch < set.patches.size(); ++patch)
+    {
+        const size_t first = patch * count * count;
+
+        for(size_t j = 0; j < mnSegments; ++j)
+        {
+            // Next row first: (j + 1, i), (j, i), (j + 1, i + 1) turns counterclockwise about dP/du x dP/dv
+            for(size_t i = 0; i < count; ++i)
+            {
+                emit(uint32_t(first + (j + 1) * count + i));
+                emit(uint32_t(first + j * count + i));
+            }
+
+            emit(UINT32_MAX);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,122 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Bicubic Bézier patch meshes. A patch set is loaded from Newell's text format or built from the
+ classic 32-patch Utah teapot, then evaluated at any density: the Bernstein basis and its
+ derivative are tabulated once per density, every row of a patch contracts the control points
+ along v, and the row is finished four u values per SIMD register into positions and unit
+ normals. Patches are spread over a thread pool. The control points can also be exported as is
+ for a post-tessellation vertex function that evaluates the patches on the GPU.
+ */
+
+#ifndef _AAPL_PATCH_MESH_H_
+#define _AAPL_PATCH_MESH_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace PatchMesh
+    {
+        // Control point (row, column) is indices[4 * row + column]; u runs along a row, v down a column
+        struct Patch
+        {
+            uint32_t indices[16];
+        };
+
+        struct PatchSet
+        {
+            std::vector<float> points;      // Three per control point
+            std::vector<Patch> patches;
+        };
+
+        // Interleaved output: pData is advanced by stride bytes per vertex
+        struct Stream
+        {
+            void*  pData;
+            size_t stride;
+        };
+
+        // Newell's format: the patch count, a line of 16 one-based indices per patch, the point
+        // count and a line of x, y, z per point, separated by commas or white space. False when
+        // the text is malformed or an index is out of range, and rSet is left empty.
+        bool parse(const char* pText, const size_t& length, PatchSet& rSet);
+
+        // The 32 patches of the Utah teapot, z up, spout towards +x, 3.15 units tall
+        void teapot(PatchSet& rSet);
+
+        // Row-major 3x4 affine matrix applied to every control point
+        void transform(PatchSet& rSet, const float* pMatrix);
+
+        // 16 float4 per patch, w = 1, in the order of the patch's indices, for a [[patch(quad, 16)]]
+        // post-tessellation vertex function
+        void controlPoints(const PatchSet& set, float* pControlPoints);
+
+        // De Casteljau's reference for a single point; the normal is the unit cross product of
+        // dP/du and dP/dv, taken next to the point where a patch edge collapses into a pole
+        void evaluate(const PatchSet& set,
+                      const size_t& patch,
+                      const float& u,
+                      const float& v,
+                      float* pPosition,
+                      float* pNormal);
+
+        class Evaluator
+        {
+        public:
+            // The pool, when given, evaluates the patches in parallel
+            explicit Evaluator(const uint32_t& segments = 16, Threads::WorkStealingPool* pPool = nullptr);
+
+            virtual ~Evaluator();
+
+            // Segments along u and along v of every patch, at least 1
+            void setSegments(const uint32_t& segments);
+
+            uint32_t segments() const;
+
+            // (segments + 1)^2 per patch, patch after patch, row after row of constant v
+            size_t vertexCount(const PatchSet& set) const;
+
+            // A triangle strip per row of quads, each followed by a restart index of all ones
+            size_t indexCount(const PatchSet& set) const;
+
+            // Positions and normals, three floats each; a null normal stream skips the normals.
+            // Edges shared by two patches get the same positions on both.
+            void evaluate(const PatchSet& set, const Stream& positions, const Stream& normals) const;
+
+            // Strips winding counterclockwise about the normals, indexSize being 2 or 4 bytes. False
+            // when the indices can't address every vertex.
+            bool indices(const PatchSet& set, void* pIndices, const size_t& indexSize) const;
+
+        private:
+            // Bernstein basis and derivative at every parameter of the density
+            void tabulate();
+
+            void evaluate(const PatchSet& set,
+                          const size_t& patch,
+                          const Stream& positions,
+                          const Stream& normals) const;
+
+        private:
+            uint32_t                    mnSegments;
+            size_t                      mnPadded;       // Parameters rounded up to whole registers
+            std::vector<float>          m_Basis;        // B_k(t_i) at [k * mnPadded + i]
+            std::vector<float>          m_Derivative;   // B_k'(t_i), same layout
+            Threads::WorkStealingPool*  mpPool;
+        }; // Class Evaluator
+    } // PatchMesh
+} // AAPL
+
+#endif
+
+#endif
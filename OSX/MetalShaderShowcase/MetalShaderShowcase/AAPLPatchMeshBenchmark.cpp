@@ -0,0 +1,304 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Benchmark for the patch evaluator, a standalone program that is not part of the app target. It
+ checks the evaluated teapot against de Casteljau's reference at every vertex, that edges shared
+ by two patches get identical positions and that the strips wind counterclockwise about the
+ normals. It then measures the throughput of positions and normals in millions of vertices per
+ second at several densities, on the calling thread alone and on pools of 2 and 4 threads, against
+ the reference evaluated point by point.
+
+     c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLPatchMesh.cpp \
+         ../../../Shared/Threads/WorkStealingPool.cpp AAPLPatchMeshBenchmark.cpp -o benchmark
+     ./benchmark
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+#include "AAPLPatchMesh.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::PatchMesh;
+
+namespace
+{
+    const uint32_t kRestart = 0xFFFFFFFFu;
+
+    // Newell's z up teapot to the shared instance's y up frame, as AAPLTeapotMesh does
+    void teapotMesh(PatchSet& rSet)
+    {
+        const float toMesh[12] =
+        {
+            0.048f, 0.0f,    0.0f,   0.0f,
+            0.0f,   0.0f,    0.048f, 0.0f,
+            0.0f,   -0.048f, 0.0f,   0.0f
+        };
+
+        teapot(rSet);
+        transform(rSet, toMesh);
+    }
+
+    bool checkSurface(const PatchSet& set, const uint32_t& segments)
+    {
+        Evaluator evaluator(segments);
+
+        const size_t vertexCount = evaluator.vertexCount(set);
+        const size_t side        = segments + 1;
+
+        std::vector<float> positions(3 * vertexCount);
+        std::vector<float> normals(3 * vertexCount);
+
+        evaluator.evaluate(set, {positions.data(), 3 * sizeof(float)}, {normals.data(), 3 * sizeof(float)});
+
+        float worstPosition = 0.0f;
+        float worstNormal   = 0.0f;
+
+        for(size_t patch = 0; patch < set.patches.size(); ++patch)
+        {
+            for(size_t j = 0; j < side; ++j)
+            {
+                for(size_t i = 0; i < side; ++i)
+                {
+                    const size_t vertex = (patch * side + j) * side + i;
+
+                    float position[3];
+                    float normal[3];
+
+                    evaluate(set, patch, float(i) / float(segments), float(j) / float(segments), position, normal);
+
+                    for(size_t c = 0; c < 3; ++c)
+                    {
+                        worstPosition = std::max(worstPosition, std::fabs(position[c] - positions[3 * vertex + c]));
+                        worstNormal   = std::max(worstNormal, std::fabs(normal[c] - normals[3 * vertex + c]));
+                    }
+                }
+            }
+        }
+
+        // Vertices of different patches within rounding of each other lie on a shared edge, and must match
+        std::vector<std::pair<std::array<long, 3>, size_t>> keys(vertexCount);
+
+        for(size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            keys[vertex].first  = {std::lround(positions[3 * vertex] * 1.0e4f),
+                                   std::lround(positions[3 * vertex + 1] * 1.0e4f),
+                                   std::lround(positions[3 * vertex + 2] * 1.0e4f)};
+            keys[vertex].second = vertex;
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        size_t cracks = 0;
+
+        for(size_t k = 1; k < vertexCount; ++k)
+        {
+            const size_t a = keys[k - 1].second;
+            const size_t b = keys[k].second;
+
+            if((keys[k - 1].first != keys[k].first) || (a / (side * side) == b / (side * side)))
+            {
+                continue;
+            }
+
+            float distance = 0.0f;
+
+            for(size_t c = 0; c < 3; ++c)
+            {
+                distance += (positions[3 * a + c] - positions[3 * b + c]) * (positions[3 * a + c] - positions[3 * b + c]);
+            }
+
+            // Near the spout's tip neighbouring grid points of the edge fall in one bucket, farther
+            // apart than the evaluation's rounding, and +0 and -0 compare equal
+            if((distance > 0.0f) && (distance < 1.0e-12f))
+            {
+                ++cracks;
+            }
+        }
+
+        // Every strip triangle, its odd ones swapped back, must face along its vertex normals
+        std::vector<uint32_t> indices(evaluator.indexCount(set));
+
+        evaluator.indices(set, indices.data(), sizeof(uint32_t));
+
+        size_t triangles = 0;
+        size_t reversed  = 0;
+        size_t start     = 0;
+
+        for(size_t k = 0; k + 2 < indices.size(); ++k)
+        {
+            if(indices[k] == kRestart)
+            {
+                start = k + 1;
+
+                continue;
+            }
+
+            if((indices[k + 1] == kRestart) || (indices[k + 2] == kRestart))
+            {
+                continue;
+            }
+
+            uint32_t a = indices[k];
+            uint32_t b = indices[k + 1];
+
+            const uint32_t c = indices[k + 2];
+
+            if((k - start) % 2 != 0)
+            {
+                std::swap(a, b);
+            }
+
+            float ab[3];
+            float ac[3];
+            float n[3];
+
+            for(size_t d = 0; d < 3; ++d)
+            {
+                ab[d] = positions[3 * b + d] - positions[3 * a + d];
+                ac[d] = positions[3 * c + d] - positions[3 * a + d];
+                n[d]  = normals[3 * a + d] + normals[3 * b + d] + normals[3 * c + d];
+            }
+
+            const float cross[3] =
+            {
+                ab[1] * ac[2] - ab[2] * ac[1],
+                ab[2] * ac[0] - ab[0] * ac[2],
+                ab[0] * ac[1] - ab[1] * ac[0]
+            };
+
+            // Degenerate triangles at the poles have no winding
+            if(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2] < 1.0e-18f)
+            {
+                continue;
+            }
+
+            ++triangles;
+
+            if(cross[0] * n[0] + cross[1] * n[1] + cross[2] * n[2] < 0.0f)
+            {
+                ++reversed;
+            }
+        }
+
+        const bool passed = (worstPosition < 1.0e-6f) && (worstNormal < 1.0e-4f) && (cracks == 0) && (reversed == 0);
+
+        std::printf("%2u segments: %6zu vertices, position error %.2g, normal error %.2g, %zu cracks, %zu of %zu triangles reversed\n",
+                    segments, vertexCount, worstPosition, worstNormal, cracks, reversed, triangles);
+
+        return passed;
+    }
+
+    double milliseconds(const std::function<void()>& work)
+    {
+        double best = 1.0e30;
+
+        for(int run = 0; run < 5; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            work();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        return best;
+    }
+} // unnamed
+
+int main()
+{
+    PatchSet set;
+
+    teapotMesh(set);
+
+    // Below 3 segments a few flat triangles across the concave handle face away from the curved
+    // surface's normals, which is the surface's shape rather than the winding
+    const uint32_t checked[] = {3, 8, 16, 44};
+
+    for(const uint32_t& segments : checked)
+    {
+        if(!checkSurface(set, segments))
+        {
+            return 1;
+        }
+    }
+
+    // The renderer's 16-bit indices stop at 44 segments
+    {
+        std::vector<uint16_t> indices(Evaluator(45).indexCount(set));
+
+        if(!Evaluator(44).indices(set, indices.data(), sizeof(uint16_t)) || Evaluator(45).indices(set, indices.data(), sizeof(uint16_t)))
+        {
+            std::printf("16-bit indices: limit is not 44 segments\n");
+
+            return 1;
+        }
+    }
+
+    const uint32_t densities[] = {8, 16, 44, 128, 256};
+
+    // Pools of 1 and 3 workers beside the calling thread
+    Threads::WorkStealingPool twoThreads(1);
+    Threads::WorkStealingPool fourThreads(3);
+
+    std::printf("Mvert/s   segments  vertices   1 thread  2 threads  4 threads\n");
+
+    for(const uint32_t& segments : densities)
+    {
+        Evaluator serial(segments);
+        Evaluator onTwo(segments, &twoThreads);
+        Evaluator onFour(segments, &fourThreads);
+
+        const size_t vertexCount = serial.vertexCount(set);
+
+        std::vector<float> positions(3 * vertexCount);
+        std::vector<float> normals(3 * vertexCount);
+
+        const Stream p = {positions.data(), 3 * sizeof(float)};
+        const Stream n = {normals.data(), 3 * sizeof(float)};
+
+        const double one  = milliseconds([&] { serial.evaluate(set, p, n); });
+        const double two  = milliseconds([&] { onTwo.evaluate(set, p, n); });
+        const double four = milliseconds([&] { onFour.evaluate(set, p, n); });
+
+        std::printf("          %8u %9zu %10.1f %10.1f %10.1f\n", segments, vertexCount,
+                    vertexCount / one / 1.0e3, vertexCount / two / 1.0e3, vertexCount / four / 1.0e3);
+    }
+
+    // De Casteljau point by point, as a baseline
+    {
+        const uint32_t segments = 64;
+        const size_t   side     = segments + 1;
+
+        float sum = 0.0f;
+
+        const double reference = milliseconds([&] {
+            for(size_t patch = 0; patch < set.patches.size(); ++patch)
+            {
+                for(size_t j = 0; j < side; ++j)
+                {
+                    for(size_t i = 0; i < side; ++i)
+                    {
+                        float position[3];
+                        float normal[3];
+
+                        evaluate(set, patch, float(i) / float(segments), float(j) / float(segments), position, normal);
+
+                        sum += position[0] + normal[0];
+                    }
+                }
+            }
+        });
+
+        std::printf("de Casteljau at %u segments: %.1f Mvert/s (%g)\n", segments,
+                    double(set.patches.size() * side * side) / reference / 1.0e3, sum);
+    }
+
+    return 0;
+}
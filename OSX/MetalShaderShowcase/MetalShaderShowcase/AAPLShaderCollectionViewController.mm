@@ -23,9 +23,28 @@
     AAPLCubeMesh *_cubeMesh;
     AAPLTexture *_sphereMapTexture;
     AAPLTexture *_normalMapTexture;
+    AAPLTexture *_woodNoiseTexture;
 }
 @end
 
+// Voxels per side of the wood shader's baked noise. One more than a power of two puts voxels on
+// every fourth lattice point, so octaves of four or more lattice cells resample exactly.
+static const uint32_t kWoodNoiseResolution = 129;
+static const uint32_t kWoodNoiseOctaves    = 7;
+
+// Quads per side of each of the teapot's 32 Bézier patches, 9248 vertices in all
+static const NSUInteger kTeapotPatchSegments = 16;
+
+// Block compression of the image textures, in the formats of the platform's GPUs. The normal map
+// gets BC7 on Macs, where BC1's 5:6:5 endpoints band its smooth gradients.
+#if TARGET_OS_IPHONE
+static const AAPLTextureCompression kSphereMapCompression = AAPLTextureCompressionETC2RGB8;
+static const AAPLTextureCompression kNormalMapCompression = AAPLTextureCompressionETC2RGB8;
+#else
+static const AAPLTextureCompression kSphereMapCompression = AAPLTextureCompressionBC1;
+static const AAPLTextureCompression kNormalMapCompression = AAPLTextureCompressionBC7;
+#endif
+
 @implementation AAPLShaderCollectionViewController
 
 static NSString * const reuseIdentifier = @"Cell";
@@ -75,7 +94,15 @@ static NSString * const reuseIdentifier = @"Cell";
         
         _controller = (AAPLViewController *)[segue destinationViewController];
         _device = MTLCreateSystemDefaultDevice();
-        _teapotMesh = [AAPLTeapotMesh sharedInstance];
+        // Evaluated once from the patches; the decoded asset if that fails
+        if(!_teapotMesh)
+        {
+            _teapotMesh = [AAPLTeapotMesh patchInstanceWithDevice:_device segments:kTeapotPatchSegments];
+        }
+        if(!_teapotMesh)
+        {
+            _teapotMesh = [AAPLTeapotMesh sharedInstance];
+        }
         _cubeMesh = [AAPLCubeMesh sharedInstance];
         
         if(!_controller)
@@ -84,6 +111,7 @@ static NSString * const reuseIdentifier = @"Cell";
         }
         
         _sphereMapTexture = [[AAPLTexture alloc] initWithResourceName:@"SphereMap" extension:@"jpg"];
+        _sphereMapTexture.compression = kSphereMapCompression;
         BOOL isAcquired = [_sphereMapTexture finalize:_device];
         if(!isAcquired)
         {
@@ -91,6 +119,7 @@ static NSString * const reuseIdentifier = @"Cell";
             assert(0);
         }
         _normalMapTexture = [[AAPLTexture alloc] initWithResourceName:@"NormalMap" extension:@"png"];
+        _normalMapTexture.compression = kNormalMapCompression;
         isAcquired = [_normalMapTexture finalize:_device];
         if(!isAcquired)
         {
@@ -104,7 +133,17 @@ static NSString * const reuseIdentifier = @"Cell";
                 _renderer = [[AAPLRenderer alloc] initWithName:@"Phong Shader" vertexShader:@"phong_vertex" fragmentShader:@"phong_fragment" mesh:_teapotMesh];
                 break;
             case Wood:
-                _renderer = [[AAPLRenderer alloc] initWithName:@"Wood Shader" vertexShader:@"wood_vertex" fragmentShader:@"wood_fragment" mesh:_teapotMesh];
+                // Sample baked noise rather than evaluating it per fragment (wood_fragment)
+                if(!_woodNoiseTexture)
+                {
+                    _woodNoiseTexture = [[AAPLTexture alloc] initNoiseVolumeWithResolution:kWoodNoiseResolution octaves:kWoodNoiseOctaves];
+                    if(![_woodNoiseTexture finalize:_device])
+                    {
+                        NSLog(@">> ERROR: Failed creating the wood noise volume!");
+                        assert(0);
+                    }
+                }
+                _renderer = [[AAPLRenderer alloc] initWithName:@"Wood Shader" vertexShader:@"wood_vertex" fragmentShader:@"wood_baked_fragment" mesh:_teapotMesh texture:_woodNoiseTexture];
                 break;
             case Fog:
                 _renderer = [[AAPLRenderer alloc] initWithName:@"Fog Shader" vertexShader:@"fog_vertex" fragmentShader:@"fog_fragment" mesh:_teapotMesh];
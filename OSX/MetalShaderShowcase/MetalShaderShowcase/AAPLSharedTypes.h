@@ -23,6 +23,13 @@ namespace AAPL
         float t;
         float lifespan;
     } uniforms_t;
+    
+    // A particle packed by the CPU engine, see AAPLParticleEngine.h
+    typedef struct
+    {
+        float position[3];
+        float age;
+    } particle_t;
 }
 
 #endif
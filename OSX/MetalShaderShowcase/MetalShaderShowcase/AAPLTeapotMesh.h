@@ -12,4 +12,8 @@
 
 + (instancetype)sharedInstance;
 
+// The teapot evaluated from its 32 Bézier patches, segments by segments quads each, in the same
+// place and size as the shared instance. At most 44 segments fit 16-bit indices.
++ (instancetype)patchInstanceWithDevice:(id <MTLDevice>)device segments:(NSUInteger)segments;
+
 @end
@@ -3,12 +3,31 @@
  See LICENSE.txt for this sample’s licensing information
  
  Abstract:
- Simple Utility class for creating a 2d texture
+ Simple Utility class for creating a 2d texture, or a 3d texture of baked noise
  */
 
 #import <UIKit/UIKit.h>
 #import <Metal/Metal.h>
 
+// Block compression of 2d textures (see AAPLBlockEncoder.h): BC formats on Macs, ETC2 and EAC on
+// iOS GPUs
+typedef NS_ENUM(NSUInteger, AAPLTextureCompression)
+{
+    AAPLTextureCompressionNone = 0,
+    AAPLTextureCompressionBC1,
+    AAPLTextureCompressionBC3,
+    AAPLTextureCompressionBC7,
+    AAPLTextureCompressionETC2RGB8,
+    AAPLTextureCompressionETC2RGBA8
+};
+
+typedef NS_ENUM(NSUInteger, AAPLTextureQuality)
+{
+    AAPLTextureQualityFast = 0,
+    AAPLTextureQualityNormal,
+    AAPLTextureQualityHigh
+};
+
 @interface AAPLTexture : NSObject
 
 @property (nonatomic, readonly)  id <MTLTexture>  texture;
@@ -21,9 +40,19 @@
 @property (nonatomic, readonly)  BOOL             hasAlpha;
 @property (nonatomic, readwrite) BOOL             flip;
 
+// Set before finalizing. Encoded blocks are kept in the caches directory, keyed by the image's
+// pixels; a format the device doesn't support loads the texture uncompressed.
+@property (nonatomic, readwrite) AAPLTextureCompression  compression;
+@property (nonatomic, readwrite) AAPLTextureQuality      quality;
+
 - (id) initWithResourceName:(NSString *)name
                   extension:(NSString *)ext;
 
+// An R8 volume of the wood shader's noise, resolution voxels per side, summing the given number
+// of octaves (see AAPLNoise.h); baked when finalized
+- (id) initNoiseVolumeWithResolution:(uint32_t)resolution
+                             octaves:(uint32_t)octaves;
+
 - (BOOL) finalize:(id<MTLDevice>)device;
 
 @end
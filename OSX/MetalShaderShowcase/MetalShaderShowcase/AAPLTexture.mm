@@ -3,10 +3,71 @@
  See LICENSE.txt for this sample’s licensing information
  
  Abstract:
- Simple Utility class for creating a 2d texture
+ Simple Utility class for creating a 2d texture, or a 3d texture of baked noise
  */
 
+#import <QuartzCore/QuartzCore.h>
+
+#import <string>
+#import <vector>
+
 #import "AAPLTexture.h"
+#import "AAPLBlockEncoder.h"
+#import "AAPLNoise.h"
+#import "WorkStealingPool.h"
+
+// Random lattice points compared against the analytic noise after baking a volume
+static const size_t kNoiseErrorSamples = 4096;
+
+// Subdirectory of the caches directory holding encoded blocks
+static NSString * const kBlockCacheDirectory = @"BlockEncoder";
+
+// Shared by noise baking and block encoding
+static Threads::WorkStealingPool & AAPLTexturePool()
+{
+    static Threads::WorkStealingPool pool;
+    
+    return pool;
+} // AAPLTexturePool
+
+// Encoder format and Metal pixel format of a compression; only the formats of the platform's GPUs
+static BOOL AAPLTextureBlockFormat(AAPLTextureCompression compression,
+                                   AAPL::BlockEncoder::Format &rFormat,
+                                   MTLPixelFormat &rPixelFormat)
+{
+    switch(compression)
+    {
+#if TARGET_OS_IPHONE
+        case AAPLTextureCompressionETC2RGB8:
+            rFormat      = AAPL::BlockEncoder::eFormatETC2RGB8;
+            rPixelFormat = MTLPixelFormatETC2_RGB8;
+            return YES;
+            
+        case AAPLTextureCompressionETC2RGBA8:
+            rFormat      = AAPL::BlockEncoder::eFormatETC2RGBA8;
+            rPixelFormat = MTLPixelFormatEAC_RGBA8;
+            return YES;
+#else
+        case AAPLTextureCompressionBC1:
+            rFormat      = AAPL::BlockEncoder::eFormatBC1;
+            rPixelFormat = MTLPixelFormatBC1_RGBA;
+            return YES;
+            
+        case AAPLTextureCompressionBC3:
+            rFormat      = AAPL::BlockEncoder::eFormatBC3;
+            rPixelFormat = MTLPixelFormatBC3_RGBA;
+            return YES;
+            
+        case AAPLTextureCompressionBC7:
+            rFormat      = AAPL::BlockEncoder::eFormatBC7;
+            rPixelFormat = MTLPixelFormatBC7_RGBAUnorm;
+            return YES;
+#endif
+            
+        default:
+            return NO;
+    } // switch
+} // AAPLTextureBlockFormat
 
 @implementation AAPLTexture
 {
@@ -17,9 +78,13 @@
     uint32_t         _height;
     uint32_t         _depth;
     uint32_t         _format;
+    uint32_t         _octaves;
     BOOL             _hasAlpha;
     BOOL             _flip;
     NSString        *_path;
+    
+    AAPLTextureCompression  _compression;
+    AAPLTextureQuality      _quality;
 }
 
 - (instancetype) initWithResourceName:(NSString *)name
@@ -46,11 +111,39 @@
         _texture  = nil;
         _hasAlpha = NO;
         _flip     = YES;
+        
+        _compression = AAPLTextureCompressionNone;
+        _quality     = AAPLTextureQualityNormal;
     } // if
     
     return self;
 } // initWithResourceName
 
+- (instancetype) initNoiseVolumeWithResolution:(uint32_t)resolution
+                                       octaves:(uint32_t)octaves
+{
+    self = [super init];
+    
+    if(self)
+    {
+        _path     = nil;
+        _width    = resolution;
+        _height   = resolution;
+        _depth    = resolution;
+        _octaves  = octaves;
+        _format   = MTLPixelFormatR8Unorm;
+        _target   = MTLTextureType3D;
+        _texture  = nil;
+        _hasAlpha = NO;
+        _flip     = NO;
+        
+        _compression = AAPLTextureCompressionNone;
+        _quality     = AAPLTextureQualityNormal;
+    } // if
+    
+    return self;
+} // initNoiseVolumeWithResolution
+
 - (void) dealloc
 {
     _path    = nil;
@@ -62,9 +155,125 @@
     _flip = flip;
 } // setFlip
 
-// assumes png file
+- (void) setCompression:(AAPLTextureCompression)compression
+{
+    _compression = compression;
+} // setCompression
+
+- (void) setQuality:(AAPLTextureQuality)quality
+{
+    _quality = quality;
+} // setQuality
+
+- (BOOL) finalizeNoiseVolume:(id <MTLDevice>)device
+{
+    AAPL::Noise::Volume volume;
+    
+    CFTimeInterval start = CACurrentMediaTime();
+    
+    if(!volume.bake(_width, _octaves, AAPL::Noise::eFormatR8, false, &AAPLTexturePool()))
+    {
+        return NO;
+    } // if
+    
+    CFTimeInterval elapsed = CACurrentMediaTime() - start;
+    
+    AAPL::Noise::Error error = AAPL::Noise::measure(volume, kNoiseErrorSamples);
+    
+    NSLog(@">> Baked %u^3 noise volume (%u octaves) in %.1f ms, %.1f Mvoxels/s, max error %.4f, rms %.4f",
+          _width, _octaves, elapsed * 1000.0, double(volume.length()) / elapsed * 1.0e-6,
+          error.maxError, error.rmsError);
+    
+    MTLTextureDescriptor *pTexDesc = [[MTLTextureDescriptor alloc] init];
+    
+    pTexDesc.textureType = MTLTextureType3D;
+    pTexDesc.pixelFormat = MTLPixelFormatR8Unorm;
+    pTexDesc.width       = _width;
+    pTexDesc.height      = _height;
+    pTexDesc.depth       = _depth;
+    
+    _texture = [device newTextureWithDescriptor:pTexDesc];
+    
+    pTexDesc = nil;
+    
+    if(!_texture)
+    {
+        return NO;
+    } // if
+    
+    [_texture replaceRegion:MTLRegionMake3D(0, 0, 0, _width, _height, _depth)
+                mipmapLevel:0
+                      slice:0
+                  withBytes:volume.data()
+                bytesPerRow:volume.bytesPerRow()
+              bytesPerImage:volume.bytesPerImage()];
+    
+    return YES;
+} // finalizeNoiseVolume
+
+// Blocks of the bitmap, read from the cache if they were encoded from the same pixels before
+- (void) encodePixels:(const uint8_t *)pPixels
+             rowBytes:(size_t)rowBytes
+               format:(AAPL::BlockEncoder::Format)format
+               blocks:(std::vector<uint8_t> &)rBlocks
+{
+    const AAPL::BlockEncoder::Quality quality = AAPL::BlockEncoder::Quality(_quality);
+    
+    const uint64_t fingerprint = AAPL::BlockEncoder::fingerprint(pPixels, _width, _height, rowBytes);
+    
+    NSString *pDirectory = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+    
+    pDirectory = [pDirectory stringByAppendingPathComponent:kBlockCacheDirectory];
+    
+    NSString *pName = [NSString stringWithFormat:@"%@-%lu-%lu.blk",
+                       [[_path lastPathComponent] stringByDeletingPathExtension],
+                       (unsigned long)_compression,
+                       (unsigned long)_quality];
+    
+    const std::string path([[pDirectory stringByAppendingPathComponent:pName] UTF8String]);
+    
+    if(AAPL::BlockEncoder::read(path, format, quality, _width, _height, fingerprint, rBlocks))
+    {
+        return;
+    } // if
+    
+    rBlocks.resize(AAPL::BlockEncoder::encodedSize(format, _width, _height));
+    
+    CFTimeInterval start = CACurrentMediaTime();
+    
+    AAPL::BlockEncoder::encode(format, quality, pPixels, _width, _height, rowBytes, rBlocks.data(), &AAPLTexturePool());
+    
+    CFTimeInterval elapsed = CACurrentMediaTime() - start;
+    
+    std::vector<uint8_t> decoded(rowBytes * _height);
+    
+    AAPL::BlockEncoder::decode(format, rBlocks.data(), _width, _height, decoded.data(), rowBytes);
+    
+    AAPL::BlockEncoder::Error error = AAPL::BlockEncoder::measure(pPixels, decoded.data(), _width, _height, rowBytes);
+    
+    NSLog(@">> Encoded %@ (%ux%u) in %.1f ms, %.1f MB/s, %.0fx smaller, PSNR rgb %.2f dB, alpha %.2f dB",
+          pName, _width, _height, elapsed * 1000.0, double(rowBytes * _height) / elapsed * 1.0e-6,
+          double(rowBytes * _height) / double(rBlocks.size()), error.rgb, error.alpha);
+    
+    [[NSFileManager defaultManager] createDirectoryAtPath:pDirectory
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:nil];
+    
+    if(!AAPL::BlockEncoder::write(path, format, quality, _width, _height, fingerprint, rBlocks))
+    {
+        NSLog(@">> ERROR: Failed writing the block cache %s", path.c_str());
+    } // if
+} // encodePixels
+
+// assumes png file, unless the texture is a noise volume
 - (BOOL) finalize:(id <MTLDevice>)device
 {
+    if(_target == MTLTextureType3D)
+    {
+        return [self finalizeNoiseVolume:device];
+    } // if
+    
     UIImage *pImage = [UIImage imageWithContentsOfFile:_path];
     
     if(!pImage)
@@ -120,7 +329,31 @@
     
     pImage = nil;
     
-    MTLTextureDescriptor *pTexDesc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
+    const uint8_t *pPixels = static_cast<const uint8_t *>(CGBitmapContextGetData(pContext));
+    
+    MTLPixelFormat             pixelFormat = MTLPixelFormatRGBA8Unorm;
+    AAPL::BlockEncoder::Format blockFormat = AAPL::BlockEncoder::eFormatBC1;
+    std::vector<uint8_t>       blocks;
+    
+    if((_compression != AAPLTextureCompressionNone) && (pPixels != NULL))
+    {
+        if(AAPLTextureBlockFormat(_compression, blockFormat, pixelFormat))
+        {
+            [self encodePixels:pPixels
+                      rowBytes:rowBytes
+                        format:blockFormat
+                        blocks:blocks];
+        } // if
+        else
+        {
+            NSLog(@">> ERROR: Compression %lu isn't available on this platform, loading %@ uncompressed",
+                  (unsigned long)_compression, [_path lastPathComponent]);
+        } // else
+    } // if
+    
+    _format = uint32_t(pixelFormat);
+    
+    MTLTextureDescriptor *pTexDesc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:pixelFormat
                                                                                         width:width
                                                                                        height:height
                                                                                     mipmapped:NO];
@@ -136,17 +369,22 @@
         return NO;
     } // if
     
-    const void *pPixels = CGBitmapContextGetData(pContext);
+    MTLRegion region = MTLRegionMake2D(0, 0, width, height);
     
-    if(pPixels != NULL)
+    if(!blocks.empty())
+    {
+        [_texture replaceRegion:region
+                    mipmapLevel:0
+                      withBytes:blocks.data()
+                    bytesPerRow:AAPL::BlockEncoder::bytesPerRow(blockFormat, width)];
+    } // if
+    else if(pPixels != NULL)
     {
-        MTLRegion region = MTLRegionMake2D(0, 0, width, height);
-        
         [_texture replaceRegion:region
                     mipmapLevel:0
                       withBytes:pPixels
                     bytesPerRow:rowBytes];
-    } // if
+    } // else if
     
     CGContextRelease(pContext);
     
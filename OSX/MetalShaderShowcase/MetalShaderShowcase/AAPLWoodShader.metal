@@ -26,7 +26,10 @@ struct ColorInOut {
 float rand(int x, int y, int z);
 float smoothNoise(float x, float y, float z);
 float noise3D(float unscaledX, float unscaledY, float unscaledZ);
+float bakedNoise3D(texture3d<float> noiseVolume, float3 position);
+float3 ringColor(float3 position, float noise);
 float3 woodColor(float3 position);
+half4 shadeWood(ColorInOut in, float3 baseColor);
 
 // Global constants
 constant float3 light_position = float3(-1.0, 1.0, -1.0);
@@ -115,22 +118,41 @@ float noise3D(float unscaledX, float unscaledY, float unscaledZ)
     return value;
 }
 
-// Calculate the wood color given the position
-float3 woodColor(float3 position)
+// Look up noise3D in a volume baked on the CPU (see AAPLNoise.h). The volume's voxel centres sit on
+// the lattice coordinates i * NOISE_DIM / (size - 1), so the teapot's bounds map onto the first
+// and last voxel centres and clamped trilinear filtering reproduces the noise between them.
+float bakedNoise3D(texture3d<float> noiseVolume, float3 position)
+{
+    constexpr sampler noiseSampler(filter::linear, address::clamp_to_edge);
+    
+    float3 size = float3(noiseVolume.get_width(), noiseVolume.get_height(), noiseVolume.get_depth());
+    float3 coordinate = ((position - teapotMin) / scaleLength * (size - 1.0f) + 0.5f) / size;
+    
+    return noiseVolume.sample(noiseSampler, coordinate).r;
+}
+
+// Calculate the wood color given the position and the noise at that position
+float3 ringColor(float3 position, float noise)
 {
-    float x = position.x, y = position.y, z = position.z;
+    float x = position.x, z = position.z;
     
     // Get the distance of the point from the y-axis to identify whether it will be a ring or not.
     // Get the smooth value for that point to add some randomness to the rings and scale the
     // randomness by a factor called turbulence. Use the cosine function to make the rings and
     // interpolate between the two wood ring colors.
-    float distanceValue = sqrt(x*x + z*z) + turbulence * noise3D(x, y, z);
+    float distanceValue = sqrt(x*x + z*z) + turbulence * noise;
     float cosineValue = fabs(cos(2.0f * numberOfRings * distanceValue * PI));
     
     float3 finalColor = darkBrown + cosineValue * lightBrown;
     return finalColor;
 }
 
+// Calculate the wood color given the position
+float3 woodColor(float3 position)
+{
+    return ringColor(position, noise3D(position.x, position.y, position.z));
+}
+
 // Wood vertex shader function
 vertex ColorInOut wood_vertex(device packed_float3* vertices [[ buffer(0) ]],
                               device packed_float3* normals [[ buffer(1) ]],
@@ -165,14 +187,11 @@ vertex ColorInOut wood_vertex(device packed_float3* vertices [[ buffer(0) ]],
     return out;
 }
 
-// Wood fragment shader function
-fragment half4 wood_fragment(ColorInOut in [[stage_in]])
+// Light the wood's base color
+half4 shadeWood(ColorInOut in, float3 baseColor)
 {
     half4 color(1.0f);
     
-    // Get the woods base color using the woodColor function
-    float3 baseColor = woodColor(in.position_modelspace);
-    
     // Generate material ambient, difuse, and specular colors derived from the base color of the wood
     float3 material_ambient_color = 0.5f * baseColor;
     float3 material_diffuse_color = baseColor;
@@ -198,4 +217,20 @@ fragment half4 wood_fragment(ColorInOut in [[stage_in]])
     color.rgb = half3(ambient_component + diffuse_component + specular_component);
     
     return color;
+}
+
+// Wood fragment shader function
+fragment half4 wood_fragment(ColorInOut in [[stage_in]])
+{
+    // Get the woods base color using the woodColor function
+    return shadeWood(in, woodColor(in.position_modelspace));
+}
+
+// Wood fragment shader function sampling baked noise instead of evaluating it
+fragment half4 wood_baked_fragment(ColorInOut in [[stage_in]],
+                                   texture3d<float> noiseVolume [[ texture(0) ]])
+{
+    float noise = bakedNoise3D(noiseVolume, in.position_modelspace);
+    
+    return shadeWood(in, ringColor(in.position_modelspace, noise));
 };
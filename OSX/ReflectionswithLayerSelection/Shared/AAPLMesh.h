@@ -9,6 +9,8 @@ Header for mesh and submesh objects used for managing models
 #import <MetalKit/MetalKit.h>
 #import <simd/simd.h>
 
+#include "AAPLMeshlets.h"
+
 
 // App specific submesh class containing data to draw a submesh
 @interface AAPLSubmesh : NSObject
@@ -21,6 +23,10 @@ Header for mesh and submesh objects used for managing models
 //  before drawing the submesh
 @property (nonatomic, readonly, nonnull) NSArray<id<MTLTexture>> *textures;
 
+// Clusters of the submesh's triangles with their bounds, in the mesh's model space, to cull it
+//   more finely than with its actor's bounding sphere
+@property (nonatomic, readonly, nonnull) const AAPL::Meshlets::MeshletMesh *meshlets;
+
 @end
 
 // App specific mesh class containing vertex data describing the mesh and submesh object describing
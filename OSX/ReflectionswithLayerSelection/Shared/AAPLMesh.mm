@@ -8,11 +8,15 @@ Implementation for Mesh and Submesh objects
 #import <ModelIO/ModelIO.h>
 #import <MetalKit/MetalKit.h>
 
+#import <vector>
+
 #import "AAPLMesh.h"
 #import "AAPLShaderTypes.h"
 
 @implementation AAPLSubmesh {
     NSArray <id <MTLTexture>>* _textures;
+
+    AAPL::Meshlets::MeshletMesh _meshlets;
 }
 
 @synthesize textures = _textures;
@@ -111,9 +115,53 @@ Implementation for Mesh and Submesh objects
 }
 
 
+/// Split the submesh's triangles into meshlets. Positions are read through Model I/O since the
+///   mesh's own vertex layout may store them in a format the builder cannot read
+- (void) buildMeshletsWithModelIOSubmesh:(nonnull MDLSubmesh *)modelIOSubmesh
+                               positions:(nullable MDLVertexAttributeData *)positions
+                             vertexCount:(NSUInteger)vertexCount
+{
+    if (positions == nil || modelIOSubmesh.geometryType != MDLGeometryTypeTriangles)
+    {
+        return;
+    }
+
+    const NSUInteger indexCount = modelIOSubmesh.indexCount;
+    std::vector<uint32_t> indices (indexCount);
+
+    MDLMeshBufferMap *indexMap = [modelIOSubmesh.indexBuffer map];
+
+    switch (modelIOSubmesh.indexType)
+    {
+        case MDLIndexBitDepthUInt8:
+            std::copy ((const uint8_t*)indexMap.bytes, (const uint8_t*)indexMap.bytes + indexCount, indices.begin());
+            break;
+        case MDLIndexBitDepthUInt16:
+            std::copy ((const uint16_t*)indexMap.bytes, (const uint16_t*)indexMap.bytes + indexCount, indices.begin());
+            break;
+        case MDLIndexBitDepthUInt32:
+            std::copy ((const uint32_t*)indexMap.bytes, (const uint32_t*)indexMap.bytes + indexCount, indices.begin());
+            break;
+        default:
+            return;
+    }
+
+    if (!AAPL::Meshlets::build (indices.data(), indexCount, positions.dataStart, positions.stride, vertexCount, _meshlets))
+    {
+        NSLog(@"Could not build meshlets for submesh %@", modelIOSubmesh.name);
+    }
+}
+
+- (const AAPL::Meshlets::MeshletMesh *) meshlets
+{
+    return &_meshlets;
+}
+
 - (nonnull instancetype) initWithModelIOSubmesh:(nonnull MDLSubmesh *)modelIOSubmesh
                                 metalKitSubmesh:(nonnull MTKSubmesh *)metalKitSubmesh
                           metalKitTextureLoader:(nonnull MTKTextureLoader *)textureLoader
+                                      positions:(nullable MDLVertexAttributeData *)positions
+                                    vertexCount:(NSUInteger)vertexCount
 {
     self = [super init];
     if(self)
@@ -157,6 +205,10 @@ Implementation for Mesh and Submesh objects
         static_assert (TextureIndexNormal == 2, "");
         
         _textures = mutableTextures;
+
+        [self buildMeshletsWithModelIOSubmesh:modelIOSubmesh
+                                    positions:positions
+                                  vertexCount:vertexCount];
     }
     return self;
 }
@@ -217,6 +269,11 @@ Implementation for Mesh and Submesh objects
     //   are Model I/O submeshes in the Model I/O mesh
     assert(metalKitMesh.submeshes.count == modelIOMesh.submeshes.count);
 
+    // Positions as 32-bit floats for the meshlet builder, whatever the vertex descriptor's format
+    MDLVertexAttributeData *positions =
+        [modelIOMesh vertexAttributeDataForAttributeNamed:MDLVertexAttributePosition
+                                                 asFormat:MDLVertexFormatFloat3];
+
     // Create an array to hold this AAPLMesh object's AAPLSubmesh objects
     NSMutableArray<AAPLSubmesh*>* mutableSubmeshes =
         [[NSMutableArray alloc] initWithCapacity:metalKitMesh.submeshes.count];
@@ -228,7 +285,9 @@ Implementation for Mesh and Submesh objects
         AAPLSubmesh *submesh =
         [[AAPLSubmesh alloc] initWithModelIOSubmesh:modelIOMesh.submeshes[index]
                                     metalKitSubmesh:metalKitMesh.submeshes[index]
-                              metalKitTextureLoader:textureLoader];
+                              metalKitTextureLoader:textureLoader
+                                          positions:positions
+                                        vertexCount:modelIOMesh.vertexCount];
 
         [mutableSubmeshes addObject:submesh];
     }
@@ -0,0 +1,537 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Meshlet builder and CPU cluster culling. An indexed triangle list is split into clusters of at
+most 64 vertices and 124 triangles; each cluster keeps its vertices as indices into the mesh's
+vertex buffer and its triangles as 8-bit indices into that list. Every cluster carries a bounding
+sphere and a normal cone, so a view can reject clusters that are outside its frustum or whose
+triangles all face away from the camera, at a finer grain than the actor's bSphere.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "AAPLMeshlets.h"
+
+//----------------------------------------------------------------------------------------
+
+namespace AAPL
+{
+    namespace Meshlets
+    {
+        static const uint32_t kNone = 0xffffffff;
+
+        struct float3
+        {
+            float x, y, z;
+        };
+
+        static inline float3 operator+(const float3& a, const float3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+        static inline float3 operator-(const float3& a, const float3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+        static inline float3 operator*(const float3& a, const float& s)  { return {a.x * s, a.y * s, a.z * s}; }
+
+        static inline float dot(const float3& a, const float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+        static inline float length(const float3& a)               { return std::sqrt(dot(a, a)); }
+
+        static inline float3 cross(const float3& a, const float3& b)
+        {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        static inline float3 position(const uint8_t* pPositions, const size_t& stride, const uint32_t& vertex)
+        {
+            float3 p;
+
+            std::memcpy(&p, pPositions + vertex * stride, sizeof(p));
+
+            return p;
+        }
+
+        // Ritter's sphere: the two mutually far points seed it, then it grows to cover the rest
+        static void boundingSphere(const std::vector<float3>& rPoints, Bounds& rBounds)
+        {
+            size_t a = 0;
+            size_t b = 0;
+
+            for(size_t i = 1; i < rPoints.size(); ++i)
+            {
+                if(dot(rPoints[i] - rPoints[0], rPoints[i] - rPoints[0]) > dot(rPoints[a] - rPoints[0], rPoints[a] - rPoints[0]))
+                {
+                    a = i;
+                }
+            }
+
+            for(size_t i = 0; i < rPoints.size(); ++i)
+            {
+                if(dot(rPoints[i] - rPoints[a], rPoints[i] - rPoints[a]) > dot(rPoints[b] - rPoints[a], rPoints[b] - rPoints[a]))
+                {
+                    b = i;
+                }
+            }
+
+            float3 center = (rPoints[a] + rPoints[b]) * 0.5f;
+            float  radius = length(rPoints[b] - rPoints[a]) * 0.5f;
+
+            for(const float3& rPoint : rPoints)
+            {
+                const float distance = length(rPoint - center);
+
+                if(distance > radius)
+                {
+                    const float grown = (radius + distance) * 0.5f;
+
+                    center = center + (rPoint - center) * ((grown - radius) / distance);
+                    radius = grown;
+                }
+            }
+
+            rBounds.center[0] = center.x;
+            rBounds.center[1] = center.y;
+            rBounds.center[2] = center.z;
+            rBounds.radius    = radius;
+        }
+
+        // Average of the unit face normals; the cutoff is the sine of the widest angle between the
+        // axis and a face normal. Degenerate triangles do not face anywhere and are ignored.
+        static void normalCone(const std::vector<float3>& rNormals, Bounds& rBounds)
+        {
+            float3 axis = {0.0f, 0.0f, 0.0f};
+
+            for(const float3& rNormal : rNormals)
+            {
+                axis = axis + rNormal;
+            }
+
+            const float axisLength = length(axis);
+
+            rBounds.coneAxis[0] = 0.0f;
+            rBounds.coneAxis[1] = 0.0f;
+            rBounds.coneAxis[2] = 0.0f;
+            rBounds.coneCutoff  = 2.0f;
+
+            if(rNormals.empty() || (axisLength <= 0.0f))
+            {
+                return;
+            }
+
+            axis = axis * (1.0f / axisLength);
+
+            float minimum = 1.0f;
+
+            for(const float3& rNormal : rNormals)
+            {
+                minimum = std::min(minimum, dot(axis, rNormal));
+            }
+
+            rBounds.coneAxis[0] = axis.x;
+            rBounds.coneAxis[1] = axis.y;
+            rBounds.coneAxis[2] = axis.z;
+
+            // A cone of 90 degrees or more faces the camera from every side
+            if(minimum > 0.0f)
+            {
+                rBounds.coneCutoff = std::sqrt(std::max(0.0f, 1.0f - minimum * minimum));
+            }
+        }
+    } // Meshlets
+} // AAPL
+
+//----------------------------------------------------------------------------------------
+
+size_t AAPL::Meshlets::MeshletMesh::triangleCount() const
+{
+    return triangles.size() / 3;
+}
+
+bool AAPL::Meshlets::build(const uint32_t* pIndices,
+                           const size_t& indexCount,
+                           const void* pPositions,
+                           const size_t& stride,
+                           const size_t& vertexCount,
+                           MeshletMesh& rMesh,
+                           const size_t& maxVertices,
+                           const size_t& maxTriangles,
+                           const float& minFacing)
+{
+    rMesh = MeshletMesh();
+
+    // Local triangle indices are 8 bits
+    if((maxVertices < 3) || (maxVertices > 256) || (maxTriangles < 1))
+    {
+        return false;
+    }
+
+    const size_t triangleCount = indexCount / 3;
+
+    for(size_t i = 0; i < 3 * triangleCount; ++i)
+    {
+        if(pIndices[i] >= vertexCount)
+        {
+            return false;
+        }
+    }
+
+    const uint8_t* pBase = static_cast<const uint8_t*>(pPositions);
+
+    // Triangles around every vertex
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    std::vector<uint32_t> adjacency(3 * triangleCount);
+
+    for(size_t i = 0; i < 3 * triangleCount; ++i)
+    {
+        offsets[pIndices[i] + 1]++;
+    }
+
+    for(size_t v = 0; v < vertexCount; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+
+        for(size_t i = 0; i < 3 * triangleCount; ++i)
+        {
+            adjacency[cursor[pIndices[i]]++] = uint32_t(i / 3);
+        }
+    }
+
+    // Centroid and unit normal of every triangle
+    std::vector<float3> centroids(triangleCount);
+    std::vector<float3> normals(triangleCount);
+
+    for(size_t t = 0; t < triangleCount; ++t)
+    {
+        const float3 a = position(pBase, stride, pIndices[3 * t]);
+        const float3 b = position(pBase, stride, pIndices[3 * t + 1]);
+        const float3 c = position(pBase, stride, pIndices[3 * t + 2]);
+
+        const float3 n    = cross(b - a, c - a);
+        const float  area = length(n);
+
+        centroids[t] = (a + b + c) * (1.0f / 3.0f);
+        normals[t]   = (area > 0.0f) ? n * (1.0f / area) : float3{0.0f, 0.0f, 0.0f};
+    }
+
+    std::vector<uint8_t>  emitted(triangleCount, 0);
+    std::vector<uint32_t> queued(triangleCount, kNone);     // Meshlet that listed the triangle
+    std::vector<uint32_t> local(vertexCount, kNone);        // Vertex index within the current meshlet
+    std::vector<uint32_t> candidates;
+
+    std::vector<float3> points;
+    std::vector<float3> faceNormals;
+
+    Meshlet current  = {0, 0, 0, 0};
+    float3  centroid = {0.0f, 0.0f, 0.0f};     // Sum of the triangle centroids
+    float3  normal   = {0.0f, 0.0f, 0.0f};     // Sum of the triangle normals
+    size_t  scan     = 0;
+
+    const auto flush = [&]()
+    {
+        if(current.triangleCount == 0)
+        {
+            return;
+        }
+
+        Bounds bounds;
+
+        points.clear();
+        faceNormals.clear();
+
+        for(uint32_t v = 0; v < current.vertexCount; ++v)
+        {
+            const uint32_t vertex = rMesh.vertices[current.vertexOffset + v];
+
+            points.push_back(position(pBase, stride, vertex));
+
+            local[vertex] = kNone;
+        }
+
+        for(uint32_t t = 0; t < current.triangleCount; ++t)
+        {
+            const uint8_t* pTriangle = &rMesh.triangles[current.triangleOffset + 3 * t];
+
+            const float3 a = points[pTriangle[0]];
+            const float3 n = cross(points[pTriangle[1]] - a, points[pTriangle[2]] - a);
+            const float  l = length(n);
+
+            if(l > 0.0f)
+            {
+                faceNormals.push_back(n * (1.0f / l));
+            }
+        }
+
+        boundingSphere(points, bounds);
+        normalCone(faceNormals, bounds);
+
+        rMesh.meshlets.push_back(current);
+        rMesh.bounds.push_back(bounds);
+
+        current  = {uint32_t(rMesh.vertices.size()), uint32_t(rMesh.triangles.size()), 0, 0};
+        centroid = {0.0f, 0.0f, 0.0f};
+        normal   = {0.0f, 0.0f, 0.0f};
+
+        candidates.clear();
+    };
+
+    for(size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        uint32_t best = kNone;
+
+        if(current.triangleCount > 0)
+        {
+            const float3 center = centroid * (1.0f / float(current.triangleCount));
+            const float  spread = length(normal);
+            const float3 axis   = (spread > 0.0f) ? normal * (1.0f / spread) : normal;
+
+            size_t bestNew      = 4;
+            float  bestDistance = 0.0f;
+            size_t kept         = 0;
+
+            for(size_t c = 0; c < candidates.size(); ++c)
+            {
+                const uint32_t triangle = candidates[c];
+
+                if(emitted[triangle])
+                {
+                    continue;
+                }
+
+                candidates[kept++] = triangle;
+
+                size_t added = 0;
+
+                for(size_t k = 0; k < 3; ++k)
+                {
+                    added += (local[pIndices[3 * triangle + k]] == kNone) ? 1 : 0;
+                }
+
+                if(current.vertexCount + added > maxVertices)
+                {
+                    continue;
+                }
+
+                // A triangle turned too far from the cluster would widen its cone
+                if((spread > 0.0f) && (dot(normals[triangle], normals[triangle]) > 0.0f) && (dot(normals[triangle], axis) < minFacing))
+                {
+                    continue;
+                }
+
+                const float3 offset   = centroids[triangle] - center;
+                const float  distance = dot(offset, offset);
+
+                if((added < bestNew) || ((added == bestNew) && (distance < bestDistance)))
+                {
+                    best         = triangle;
+                    bestNew      = added;
+                    bestDistance = distance;
+                }
+            }
+
+            candidates.resize(kept);
+
+            // Nothing fits next to the cluster, start a new one
+            if(best == kNone)
+            {
+                flush();
+            }
+        }
+
+        if(best == kNone)
+        {
+            while(emitted[scan])
+            {
+                scan++;
+            }
+
+            best = uint32_t(scan);
+        }
+
+        emitted[best] = 1;
+
+        for(size_t k = 0; k < 3; ++k)
+        {
+            const uint32_t vertex = pIndices[3 * best + k];
+
+            if(local[vertex] == kNone)
+            {
+                local[vertex] = current.vertexCount++;
+
+                rMesh.vertices.push_back(vertex);
+
+                // Triangles sharing the new vertex become candidates
+                const uint32_t meshlet = uint32_t(rMesh.meshlets.size());
+
+                for(uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; ++a)
+                {
+                    const uint32_t neighbour = adjacency[a];
+
+                    if(!emitted[neighbour] && (queued[neighbour] != meshlet))
+                    {
+                        queued[neighbour] = meshlet;
+
+                        candidates.push_back(neighbour);
+                    }
+                }
+            }
+
+            rMesh.triangles.push_back(uint8_t(local[vertex]));
+        }
+
+        current.triangleCount++;
+
+        centroid = centroid + centroids[best];
+        normal   = normal + normals[best];
+
+        if(current.triangleCount == maxTriangles)
+        {
+            flush();
+        }
+    }
+
+    flush();
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+
+AAPL::Meshlets::View::View()
+{
+    std::memset(planes, 0, sizeof(planes));
+    std::memset(camera, 0, sizeof(camera));
+}
+
+AAPL::Meshlets::View::View(const float* pModelViewProjection, const float* pCamera)
+{
+    // Rows of the matrix (Gribb and Hartmann); clip space z runs from 0 to w
+    float rows[4][4];
+
+    for(size_t r = 0; r < 4; ++r)
+    {
+        for(size_t c = 0; c < 4; ++c)
+        {
+            rows[r][c] = pModelViewProjection[4 * c + r];
+        }
+    }
+
+    for(size_t c = 0; c < 4; ++c)
+    {
+        planes[0][c] = rows[3][c] + rows[0][c];     // Left
+        planes[1][c] = rows[3][c] - rows[0][c];     // Right
+        planes[2][c] = rows[3][c] + rows[1][c];     // Bottom
+        planes[3][c] = rows[3][c] - rows[1][c];     // Top
+        planes[4][c] = rows[2][c];                  // Near
+        planes[5][c] = rows[3][c] - rows[2][c];     // Far
+    }
+
+    for(size_t p = 0; p < 6; ++p)
+    {
+        const float length = std::sqrt(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+
+        if(length > 0.0f)
+        {
+            for(size_t c = 0; c < 4; ++c)
+            {
+                planes[p][c] /= length;
+            }
+        }
+    }
+
+    std::memcpy(camera, pCamera, sizeof(camera));
+}
+
+AAPL::Meshlets::Statistics::Statistics()
+: meshlets(0),
+  triangles(0),
+  frustumRejected(0),
+  backfaceRejected(0)
+{
+}
+
+AAPL::Meshlets::Statistics& AAPL::Meshlets::Statistics::operator+=(const Statistics& rOther)
+{
+    meshlets         += rOther.meshlets;
+    triangles        += rOther.triangles;
+    frustumRejected  += rOther.frustumRejected;
+    backfaceRejected += rOther.backfaceRejected;
+
+    return *this;
+}
+
+AAPL::Meshlets::Statistics AAPL::Meshlets::cull(const MeshletMesh& rMesh,
+                                                const View& rView,
+                                                std::vector<uint32_t>& rVisible)
+{
+    Statistics statistics;
+
+    const float3 camera = {rView.camera[0], rView.camera[1], rView.camera[2]};
+
+    statistics.meshlets = rMesh.meshlets.size();
+
+    for(size_t m = 0; m < rMesh.meshlets.size(); ++m)
+    {
+        const Bounds&  rBounds   = rMesh.bounds[m];
+        const uint32_t triangles = rMesh.meshlets[m].triangleCount;
+
+        statistics.triangles += triangles;
+
+        const float3 center = {rBounds.center[0], rBounds.center[1], rBounds.center[2]};
+
+        bool outside = false;
+
+        for(size_t p = 0; (p < 6) && !outside; ++p)
+        {
+            const float* pPlane = rView.planes[p];
+
+            outside = (pPlane[0] * center.x + pPlane[1] * center.y + pPlane[2] * center.z + pPlane[3]) < -rBounds.radius;
+        }
+
+        if(outside)
+        {
+            statistics.frustumRejected += triangles;
+
+            continue;
+        }
+
+        // Every point p of the sphere is seen within 90 degrees minus the cone angle of the
+        // axis, so every triangle faces away: dot(d, axis) >= |d| sin + r (1 + sin), d = c - camera
+        if(rBounds.coneCutoff <= 1.0f)
+        {
+            const float3 axis = {rBounds.coneAxis[0], rBounds.coneAxis[1], rBounds.coneAxis[2]};
+            const float3 d    = center - camera;
+
+            if(dot(d, axis) >= length(d) * rBounds.coneCutoff + rBounds.radius * (1.0f + rBounds.coneCutoff))
+            {
+                statistics.backfaceRejected += triangles;
+
+                continue;
+            }
+        }
+
+        rVisible.push_back(uint32_t(m));
+    }
+
+    return statistics;
+}
+
+void AAPL::Meshlets::appendIndices(const MeshletMesh& rMesh,
+                                   const uint32_t* pMeshlets,
+                                   const size_t& count,
+                                   std::vector<uint32_t>& rIndices)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        const Meshlet& rMeshlet = rMesh.meshlets[pMeshlets[i]];
+
+        const uint32_t* pVertices  = &rMesh.vertices[rMeshlet.vertexOffset];
+        const uint8_t*  pTriangles = &rMesh.triangles[rMeshlet.triangleOffset];
+
+        for(uint32_t t = 0; t < 3 * rMeshlet.triangleCount; ++t)
+        {
+            rIndices.push_back(pVertices[pTriangles[t]]);
+        }
+    }
+}
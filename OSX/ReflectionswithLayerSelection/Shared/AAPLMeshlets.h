@@ -0,0 +1,116 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Meshlet builder and CPU cluster culling. An indexed triangle list is split into clusters of at
+most 64 vertices and 124 triangles; each cluster keeps its vertices as indices into the mesh's
+vertex buffer and its triangles as 8-bit indices into that list. Every cluster carries a bounding
+sphere and a normal cone, so a view can reject clusters that are outside its frustum or whose
+triangles all face away from the camera, at a finer grain than the actor's bSphere.
+*/
+
+#ifndef _AAPL_MESHLETS_H_
+#define _AAPL_MESHLETS_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AAPL
+{
+    namespace Meshlets
+    {
+        static const size_t kMaxVertices  = 64;
+        static const size_t kMaxTriangles = 124;
+
+        // Least cosine between a triangle's normal and the mean normal of the cluster it joins
+        static const float kDefaultMinFacing = 0.0f;
+
+        struct Meshlet
+        {
+            uint32_t vertexOffset;      // First entry in MeshletMesh::vertices
+            uint32_t triangleOffset;    // First byte in MeshletMesh::triangles, 3 per triangle
+            uint32_t vertexCount;
+            uint32_t triangleCount;
+        };
+
+        // Normals follow cross(b - a, c - a): towards the viewer for clockwise front faces in a
+        // left handed space (this sample) and counter-clockwise ones in a right handed space
+        struct Bounds
+        {
+            float center[3];
+            float radius;
+            float coneAxis[3];
+            float coneCutoff;           // Sine of the cone's half angle, 2 when the cone is open
+        };
+
+        struct MeshletMesh
+        {
+            std::vector<Meshlet>  meshlets;
+            std::vector<Bounds>   bounds;       // One per meshlet
+            std::vector<uint32_t> vertices;     // Mesh vertex indices
+            std::vector<uint8_t>  triangles;    // Local indices into a meshlet's vertices
+
+            size_t triangleCount() const;
+        };
+
+        // Clusters grow across shared edges, preferring triangles that add the fewest vertices and
+        // then the one nearest the cluster. Triangles facing further than acos(minFacing) from the
+        // cluster's mean normal are left for another cluster: -1 packs clusters tightest but leaves
+        // few of them cullable by their cone, higher values cull more at the cost of smaller
+        // clusters. pPositions points at the first vertex's position, stride bytes apart. False
+        // when a limit is out of range or an index is past vertexCount.
+        bool build(const uint32_t* pIndices,
+                   const size_t& indexCount,
+                   const void* pPositions,
+                   const size_t& stride,
+                   const size_t& vertexCount,
+                   MeshletMesh& rMesh,
+                   const size_t& maxVertices = kMaxVertices,
+                   const size_t& maxTriangles = kMaxTriangles,
+                   const float& minFacing = kDefaultMinFacing);
+
+        // A view in the mesh's model space: frustum planes from a model-view-projection matrix
+        // (column major, Metal clip space with z in [0, w]) and the camera position. The model
+        // transform must be rigid, or scale uniformly.
+        struct View
+        {
+            float planes[6][4];         // Unit normals pointing inside
+            float camera[3];
+
+            View();
+
+            View(const float* pModelViewProjection, const float* pCamera);
+        };
+
+        struct Statistics
+        {
+            size_t meshlets;
+            size_t triangles;
+            size_t frustumRejected;     // Triangles in clusters outside the frustum
+            size_t backfaceRejected;    // Triangles in clusters facing away from the camera
+
+            Statistics();
+
+            Statistics& operator+=(const Statistics& rOther);
+        };
+
+        // Indices of the meshlets the view may see, appended to rVisible
+        Statistics cull(const MeshletMesh& rMesh,
+                        const View& rView,
+                        std::vector<uint32_t>& rVisible);
+
+        // Expand meshlets to a triangle list of mesh vertex indices, e.g. to draw the visible
+        // clusters without mesh shaders
+        void appendIndices(const MeshletMesh& rMesh,
+                           const uint32_t* pMeshlets,
+                           const size_t& count,
+                           std::vector<uint32_t>& rIndices);
+    } // Meshlets
+} // AAPL
+
+#endif
+
+#endif
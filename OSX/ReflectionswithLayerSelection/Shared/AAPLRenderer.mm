@@ -27,6 +27,60 @@ static const vector_float3 SceneCenter              = (vector_float3){0.f, -250.
 static const vector_float3 CameraDistanceFromCenter = (vector_float3){0.f, 300.f, -550.f};
 static const vector_float3 CameraRotationAxis       = (vector_float3){0,1,0};
 static const float         CameraRotationSpeed      = 0.0025f;
+static const NSUInteger    MeshletReportFrames      = 256; // Frames between meshlet culling reports
+
+// Final pass draw of one submesh: the triangles of its visible meshlets in the frame's meshlet
+//   index buffer, or the submesh's own indices when it has no meshlets
+struct MeshletDraw
+{
+    NSUInteger indexOffset;     // Bytes into the meshlet index buffer
+    NSUInteger indexCount;
+    bool       wholeSubmesh;
+};
+
+// Cull the meshlets of an actor's submeshes for one view and append the triangles of the visible
+//   ones to indices, one draw per submesh. The view and camera are moved into the actor's model
+//   space, which the meshlet bounds are in
+static AAPL::Meshlets::Statistics CullMeshlets (AAPLActorData*             actor,
+                                                const matrix_float4x4      modelMatrix,
+                                                const matrix_float4x4      viewProjectionMatrix,
+                                                const vector_float3        cameraPosition,
+                                                std::vector<uint32_t>&     visibleMeshlets,
+                                                std::vector<uint32_t>&     indices,
+                                                std::vector<MeshletDraw>&  draws)
+{
+    const matrix_float4x4 modelViewProjectionMatrix = matrix_multiply (viewProjectionMatrix, modelMatrix);
+    const vector_float4   modelCameraPosition       =
+        matrix_multiply (matrix_invert (modelMatrix), (vector_float4) {cameraPosition.x, cameraPosition.y, cameraPosition.z, 1.f});
+
+    const AAPL::Meshlets::View view ((const float*) &modelViewProjectionMatrix, (const float*) &modelCameraPosition);
+
+    AAPL::Meshlets::Statistics statistics;
+
+    for (AAPLMesh* mesh in actor.meshes)
+    {
+        for (AAPLSubmesh* submesh in mesh.submeshes)
+        {
+            const AAPL::Meshlets::MeshletMesh& meshlets = *submesh.meshlets;
+
+            if (meshlets.meshlets.empty())
+            {
+                draws.push_back ({0, 0, true});
+                continue;
+            }
+
+            visibleMeshlets.clear();
+            statistics += AAPL::Meshlets::cull (meshlets, view, visibleMeshlets);
+
+            const size_t first = indices.size();
+            AAPL::Meshlets::appendIndices (meshlets, visibleMeshlets.data(), visibleMeshlets.size(), indices);
+
+            draws.push_back ({first * sizeof(uint32_t), indices.size() - first, false});
+        }
+    }
+
+    return statistics;
+}
 
 // Main class performing the rendering
 @implementation AAPLRenderer
@@ -56,6 +110,17 @@ static const float         CameraRotationSpeed      = 0.0025f;
     id <MTLDepthStencilState> _depthState;
     id <MTLTexture>           _reflectionCubeMap;
     id <MTLTexture>           _reflectionCubeMapDepth;
+
+    // Triangles of the visible meshlets of the actors in the final pass
+    id <MTLBuffer>           _meshletIndexBuffers [MaxBuffersInFlight];
+    std::vector<MeshletDraw> _meshletDraws [MaxActors];     // one per submesh of the actor
+    std::vector<uint32_t>    _meshletIndices;
+    std::vector<uint32_t>    _visibleMeshlets;
+
+    // Meshlet culling of the final pass, accumulated between reports
+    AAPL::Meshlets::Statistics _meshletStatistics;
+    CFTimeInterval             _meshletCullTime;
+    NSUInteger                 _meshletFrames;
 }
 
 - (nonnull instancetype) initWithMetalKitView:(nonnull MTKView *)mtkView
@@ -432,6 +497,28 @@ static const float         CameraRotationSpeed      = 0.0025f;
     _actorData.lastObject.gpuProg           = chromePipelineState;
     _actorData.lastObject.meshes            = sphereMeshes;
     _actorData.lastObject.passFlags         = EPassFlags::Final;
+
+    // Room for every meshlet triangle of the actors in the final pass, for when they are all visible
+    NSUInteger meshletIndexBufferLength = sizeof(uint32_t);
+    for (AAPLActorData* actor in _actorData)
+    {
+        if ((actor.passFlags & EPassFlags::Final) == 0) continue;
+
+        for (AAPLMesh* mesh in actor.meshes)
+        {
+            for (AAPLSubmesh* submesh in mesh.submeshes)
+            {
+                meshletIndexBufferLength += 3 * submesh.meshlets->triangleCount() * sizeof(uint32_t);
+            }
+        }
+    }
+
+    for (int i = 0; i < MaxBuffersInFlight; i++)
+    {
+        _meshletIndexBuffers[i] = [_device newBufferWithLength: meshletIndexBufferLength
+                                                       options: MTLResourceStorageModeShared];
+        _meshletIndexBuffers[i].label = [NSString stringWithFormat:@"meshletIndices[%i]", i];
+    }
 }
 
 - (void) updateGameState
@@ -439,6 +526,9 @@ static const float         CameraRotationSpeed      = 0.0025f;
     FrustumCuller culler_final;
     FrustumCuller culler_probe [6];
 
+    matrix_float4x4 modelMatrices [MaxActors];
+    matrix_float4x4 viewProjectionMatrix_final;
+
     // Update each actor's position and parameter buffer
     {
         ActorParams *actorParams  =
@@ -455,6 +545,7 @@ static const float         CameraRotationSpeed      = 0.0025f;
             modelMatrix = matrix_multiply(modelPositionMatrix, modelMatrix);
 
             _actorData[i].modelPosition = matrix_multiply(modelMatrix, (vector_float4) {0, 0, 0, 1});
+            modelMatrices[i] = modelMatrix;
 
             // we update the actor's rotation for next frame (cpu side) :
             _actorData[i].rotationAmount += 0.004 * _actorData[i].rotationSpeed;
@@ -511,7 +602,8 @@ static const float         CameraRotationSpeed      = 0.0025f;
 
         ViewportParams *viewportBuffer = (ViewportParams *)_viewportsParamsBuffers_final[_uniformBufferIndex].contents;
         viewportBuffer[0].cameraPos            = _cameraFinal.position;
-        viewportBuffer[0].viewProjectionMatrix = matrix_multiply (projectionMatrix, viewMatrix);
+        viewProjectionMatrix_final = matrix_multiply (projectionMatrix, viewMatrix);
+        viewportBuffer[0].viewProjectionMatrix = viewProjectionMatrix_final;
     }
     // We update the shader parameters - frame constants :
     {
@@ -561,6 +653,51 @@ static const float         CameraRotationSpeed      = 0.0025f;
             }
         }
     }
+    // Cull the meshlets of the actors visible in the final pass, which draws the triangles of the
+    //   visible ones. The reflection pass draws each actor once for all the probe faces it is
+    //   visible in, so it keeps drawing whole submeshes
+    {
+        const CFTimeInterval start = CACurrentMediaTime();
+
+        _meshletIndices.clear();
+
+        for (int actorIdx = 0; actorIdx < _actorData.count; actorIdx++)
+        {
+            AAPLActorData* actor = _actorData[actorIdx];
+
+            _meshletDraws[actorIdx].clear();
+
+            if (actor.visibleInFinal && (actor.passFlags & EPassFlags::Final))
+            {
+                _meshletStatistics += CullMeshlets (actor, modelMatrices[actorIdx], viewProjectionMatrix_final,
+                                                    _cameraFinal.position, _visibleMeshlets, _meshletIndices, _meshletDraws[actorIdx]);
+            }
+        }
+
+        _meshletCullTime += CACurrentMediaTime() - start;
+
+        memcpy (_meshletIndexBuffers[_uniformBufferIndex].contents, _meshletIndices.data(),
+                _meshletIndices.size() * sizeof(uint32_t));
+
+        // Report and restart the window every MeshletReportFrames frames, whether or not any
+        //   meshlet triangles were in view
+        if (++_meshletFrames == MeshletReportFrames)
+        {
+            if (_meshletStatistics.triangles > 0)
+            {
+                const double triangles = (double) _meshletStatistics.triangles;
+
+                NSLog (@"Meshlets: %.1f%% of triangles outside the frustum, %.1f%% back facing, %.3f ms per million triangles",
+                       100.0 * _meshletStatistics.frustumRejected / triangles,
+                       100.0 * _meshletStatistics.backfaceRejected / triangles,
+                       1000.0 * _meshletCullTime / (triangles / 1e6));
+            }
+
+            _meshletStatistics = AAPL::Meshlets::Statistics();
+            _meshletCullTime   = 0;
+            _meshletFrames     = 0;
+        }
+    }
 }
 
 - (void) drawActors: (id <MTLRenderCommandEncoder>) renderEncoder
@@ -636,6 +773,8 @@ static const float         CameraRotationSpeed      = 0.0025f;
 
         [renderEncoder setRenderPipelineState:lActor.gpuProg];
 
+        NSUInteger submeshIdx = 0;
+
         for (AAPLMesh *mesh in lActor.meshes)
         {
             MTKMesh *metalKitMesh = mesh.metalKitMesh;
@@ -655,6 +794,13 @@ static const float         CameraRotationSpeed      = 0.0025f;
             // Draw each submesh of our mesh
             for(AAPLSubmesh *submesh in mesh.submeshes)
             {
+                const MeshletDraw* meshletDraw =
+                    (pass == EPassFlags::Final) ? &_meshletDraws[actorIdx][submeshIdx] : nullptr;
+                submeshIdx++;
+
+                // All of the submesh's meshlets were culled
+                if (meshletDraw && !meshletDraw->wholeSubmesh && meshletDraw->indexCount == 0) continue;
+
                 // Set any textures read/sampled from our render pipeline
                 id <MTLTexture> tex;
 
@@ -680,6 +826,19 @@ static const float         CameraRotationSpeed      = 0.0025f;
 
                 MTKSubmesh *metalKitSubmesh = submesh.metalKitSubmmesh;
 
+                if (meshletDraw && !meshletDraw->wholeSubmesh)
+                {
+                    [renderEncoder drawIndexedPrimitives: MTLPrimitiveTypeTriangle
+                                              indexCount: meshletDraw->indexCount
+                                               indexType: MTLIndexTypeUInt32
+                                             indexBuffer: _meshletIndexBuffers[_uniformBufferIndex]
+                                       indexBufferOffset: meshletDraw->indexOffset
+                                           instanceCount: visibleVpCount
+                                              baseVertex: 0
+                                            baseInstance: actorIdx * MaxVisibleFaces];
+                    continue;
+                }
+
                 [renderEncoder drawIndexedPrimitives: metalKitSubmesh.primitiveType
                                           indexCount: metalKitSubmesh.indexCount
                                            indexType: metalKitSubmesh.indexType
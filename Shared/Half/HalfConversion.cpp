@@ -0,0 +1,234 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ IEEE half precision conversion.
+ */
+
+#include <cstring>
+
+#include "HalfConversion.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #if defined(__F16C__)
+        #include <immintrin.h>
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - SSE2
+
+namespace Half
+{
+#if defined(__SSE2__) && !defined(__F16C__)
+    // The scalar conversions four at a time in integer arithmetic, results identical
+    static inline __m128i fromFloat4(const __m128& f)
+    {
+        const __m128i sign     = _mm_and_si128(_mm_castps_si128(f), _mm_set1_epi32(int32_t(0x80000000)));
+        const __m128i bits     = _mm_xor_si128(_mm_castps_si128(f), sign);
+        const __m128  absolute = _mm_castsi128_ps(bits);
+
+        // NaN comes out quiet with the top of its payload, everything from 65520 up turns into infinity
+        const __m128i nan     = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+        const __m128i payload = _mm_or_si128(_mm_set1_epi32(0x200), _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(0x3ff)));
+        const __m128i special = _mm_or_si128(_mm_and_si128(nan, payload), _mm_set1_epi32(0x7c00));
+        const __m128i regular = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), bits);
+
+        // Below the smallest normal half: 0.5 has an ulp of 2^-24, the subnormal half's step, so
+        // adding it makes the FPU round the mantissa, which then sits in the low bits
+        const __m128i magic     = _mm_set1_epi32(0x3f000000);
+        const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(magic))), magic);
+        const __m128i small     = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), bits);
+
+        // Normal: rebias the exponent and round the mantissa to nearest even
+        const __m128i odd    = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+        const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(int32_t(0xfff - 0x38000000))), odd), 13);
+
+        const __m128i finite = _mm_or_si128(_mm_and_si128(small, subnormal), _mm_andnot_si128(small, normal));
+        const __m128i joined = _mm_or_si128(_mm_and_si128(regular, finite), _mm_andnot_si128(regular, special));
+
+        return _mm_or_si128(joined, _mm_srli_epi32(sign, 16));
+    }
+
+    static inline __m128 toFloat4(const __m128i& h)
+    {
+        const __m128i magnitude = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+        const __m128i sign      = _mm_slli_epi32(_mm_xor_si128(h, magnitude), 16);
+
+        // Shifted into a float's exponent and mantissa, 2^112 rebiases the exponent and renormalises subnormals
+        const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(magnitude, 13)),
+                                         _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));
+
+        // Infinity and NaN take the top exponent, NaN quiet as the hardware conversions leave it
+        const __m128i infinite = _mm_and_si128(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7bff)), _mm_set1_epi32(0x7f800000));
+        const __m128i quiet    = _mm_and_si128(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7c00)), _mm_set1_epi32(0x400000));
+
+        return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, _mm_or_si128(infinite, quiet))));
+    }
+#endif
+} // Half
+
+#pragma mark -
+#pragma mark Public - Half conversion
+
+float Half::toFloat(const uint16_t& h)
+{
+    const uint32_t sign     = uint32_t(h & 0x8000) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1f;
+    const uint32_t mantissa = h & 0x3ff;
+
+    uint32_t bits;
+
+    if(exponent == 0)
+    {
+        if(mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // Subnormal, renormalise
+            uint32_t e = 113;
+            uint32_t m = mantissa;
+
+            while((m & 0x400) == 0)
+            {
+                m <<= 1;
+                e  -= 1;
+            }
+
+            bits = sign | (e << 23) | ((m & 0x3ff) << 13);
+        }
+    }
+    else if(exponent == 0x1f)
+    {
+        // NaN comes out quiet, as F16C and NEON leave it
+        bits = sign | 0x7f800000 | (mantissa << 13) | ((mantissa != 0) ? 0x400000 : 0);
+    }
+    else
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float f;
+
+    std::memcpy(&f, &bits, sizeof(f));
+
+    return f;
+}
+
+uint16_t Half::fromFloat(const float& f)
+{
+    // Round to nearest even, overflow to infinity
+    uint32_t bits;
+
+    std::memcpy(&bits, &f, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+
+    bits &= 0x7fffffff;
+
+    if(bits >= 0x7f800000)
+    {
+        // NaN comes out quiet with the top of its payload
+        return uint16_t(sign | 0x7c00 | ((bits > 0x7f800000) ? (0x200 | ((bits >> 13) & 0x3ff)) : 0));
+    }
+
+    if(bits >= 0x477ff000)
+    {
+        return uint16_t(sign | 0x7c00);
+    }
+
+    if(bits < 0x38800000)
+    {
+        // Subnormal or zero: add the implicit bit and shift into place
+        if(bits < 0x33000000)
+        {
+            return uint16_t(sign);
+        }
+
+        const uint32_t exponent = bits >> 23;
+        const uint32_t mantissa = (bits & 0x7fffff) | 0x800000;
+        const uint32_t shift    = 126 - exponent;
+        const uint32_t half     = mantissa >> shift;
+        const uint32_t rest     = mantissa & ((1u << shift) - 1);
+        const uint32_t midpoint = 1u << (shift - 1);
+
+        const uint32_t rounded = half + (((rest > midpoint) || ((rest == midpoint) && (half & 1))) ? 1 : 0);
+
+        return uint16_t(sign | rounded);
+    }
+
+    const uint32_t rounded = bits + 0xfff + ((bits >> 13) & 1);
+
+    return uint16_t(sign | ((rounded - 0x38000000) >> 13));
+}
+
+void Half::fromFloat(const float* pIn, uint16_t* pOut, const size_t& count)
+{
+    size_t i = 0;
+
+#if defined(__F16C__)
+    for(; i + 8 <= count; i += 8)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(pIn + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+#elif defined(__SSE2__)
+    for(; i + 8 <= count; i += 8)
+    {
+        // Halves have the sign in bit 15; sign extending keeps the signed saturating pack from clamping
+        const __m128i lower = fromFloat4(_mm_loadu_ps(pIn + i));
+        const __m128i upper = fromFloat4(_mm_loadu_ps(pIn + i + 4));
+
+        const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lower, 16), 16),
+                                               _mm_srai_epi32(_mm_slli_epi32(upper, 16), 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), packed);
+    }
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+    for(; i + 4 <= count; i += 4)
+    {
+        vst1_u16(pOut + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(pIn + i))));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        pOut[i] = fromFloat(pIn[i]);
+    }
+}
+
+void Half::toFloat(const uint16_t* pIn, float* pOut, const size_t& count)
+{
+    size_t i = 0;
+
+#if defined(__F16C__)
+    for(; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(pOut + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i))));
+    }
+#elif defined(__SSE2__)
+    for(; i + 8 <= count; i += 8)
+    {
+        const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+        const __m128i zero   = _mm_setzero_si128();
+
+        _mm_storeu_ps(pOut + i,     toFloat4(_mm_unpacklo_epi16(halves, zero)));
+        _mm_storeu_ps(pOut + i + 4, toFloat4(_mm_unpackhi_epi16(halves, zero)));
+    }
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+    for(; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(pOut + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(pIn + i))));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        pOut[i] = toFloat(pIn[i]);
+    }
+}
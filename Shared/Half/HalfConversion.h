@@ -0,0 +1,31 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ IEEE half precision conversion, rounding to nearest even and overflowing to infinity. NaNs come
+ out quiet and keep the top of their payload, as the hardware conversions leave them. The batch
+ conversions use F16C, NEON on arm64 or four values at a time in SSE2 integer arithmetic, with
+ results identical to the scalar conversions.
+ */
+
+#ifndef _HALF_HALF_CONVERSION_H_
+#define _HALF_HALF_CONVERSION_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Half
+{
+    uint16_t fromFloat(const float& value);
+    float    toFloat(const uint16_t& value);
+
+    // Conversion of count values
+    void fromFloat(const float* pIn, uint16_t* pOut, const size_t& count);
+    void toFloat(const uint16_t* pIn, float* pOut, const size_t& count);
+} // Half
+
+#endif
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Work-stealing thread pool. Every worker owns a task deque; owners pop from the back, idle workers
+ steal from the front of the other deques. Threads blocked in parallelFor help executing tasks.
+ */
+
+#include <algorithm>
+
+#include "WorkStealingPool.h"
+
+#pragma mark -
+#pragma mark Private - Worker identity
+
+namespace Threads
+{
+    // Pool and index of the worker running on this thread
+    static thread_local const WorkStealingPool* gpPool   = nullptr;
+    static thread_local int                     gnWorker = -1;
+} // Threads
+
+#pragma mark -
+#pragma mark Public - Pool
+
+Threads::WorkStealingPool::WorkStealingPool(const size_t& threads)
+: mnPending(0), mnNext(0), mbStop(false)
+{
+    size_t count = threads;
+
+    if(count == 0)
+    {
+        const size_t hardware = std::thread::hardware_concurrency();
+
+        count = (hardware > 1) ? (hardware - 1) : 1;
+    }
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        m_Queues.emplace_back(new Queue);
+    }
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        m_Workers.emplace_back(&WorkStealingPool::worker, this, i);
+    }
+}
+
+Threads::WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        mbStop = true;
+    }
+
+    m_Condition.notify_all();
+
+    for(std::thread& rWorker : m_Workers)
+    {
+        rWorker.join();
+    }
+}
+
+size_t Threads::WorkStealingPool::concurrency() const
+{
+    return m_Workers.size() + 1;
+}
+
+int Threads::WorkStealingPool::workerIndex()
+{
+    return gnWorker;
+}
+
+void Threads::WorkStealingPool::submit(Task task)
+{
+    const size_t target = ((gpPool == this) && (gnWorker >= 0))
+                        ? size_t(gnWorker)
+                        : (mnNext.fetch_add(1, std::memory_order_relaxed) % m_Queues.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_Queues[target]->m_Mutex);
+
+        m_Queues[target]->m_Tasks.push_back(std::move(task));
+    }
+
+    // Publish under the pool mutex so a worker about to sleep cannot miss it
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        mnPending.fetch_add(1);
+    }
+
+    m_Condition.notify_one();
+}
+
+bool Threads::WorkStealingPool::pop(const size_t& home, Task& rTask)
+{
+    const size_t count = m_Queues.size();
+
+    // Own deque first, newest task (LIFO keeps the working set warm)
+    if(home < count)
+    {
+        Queue& rQueue = *m_Queues[home];
+
+        std::lock_guard<std::mutex> lock(rQueue.m_Mutex);
+
+        if(!rQueue.m_Tasks.empty())
+        {
+            rTask = std::move(rQueue.m_Tasks.back());
+
+            rQueue.m_Tasks.pop_back();
+
+            mnPending.fetch_sub(1);
+
+            return true;
+        }
+    }
+
+    // Steal the oldest task from somebody else
+    for(size_t i = 1; i <= count; ++i)
+    {
+        Queue& rQueue = *m_Queues[(home + i) % count];
+
+        std::unique_lock<std::mutex> lock(rQueue.m_Mutex, std::try_to_lock);
+
+        if(lock.owns_lock() && !rQueue.m_Tasks.empty())
+        {
+            rTask = std::move(rQueue.m_Tasks.front());
+
+            rQueue.m_Tasks.pop_front();
+
+            mnPending.fetch_sub(1);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Threads::WorkStealingPool::worker(const size_t& index)
+{
+    gpPool   = this;
+    gnWorker = int(index);
+
+    Task task;
+
+    for(;;)
+    {
+        if(pop(index, task))
+        {
+            task();
+
+            task = nullptr;
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        if(mnPending.load() > 0)
+        {
+            // Lost a try_lock race, retry the steal
+            continue;
+        }
+
+        if(mbStop)
+        {
+            return;
+        }
+
+        m_Condition.wait(lock, [this] { return mbStop || (mnPending.load() > 0); });
+    }
+}
+
+void Threads::WorkStealingPool::parallelFor(const size_t& count,
+                                            const std::function<void(size_t)>& body,
+                                            const size_t& grain)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    size_t chunk = grain;
+
+    if(chunk == 0)
+    {
+        // A few chunks per thread leaves room for stealing without flooding the deques
+        chunk = std::max<size_t>(1, count / (4 * concurrency()));
+    }
+
+    const size_t chunks = (count + chunk - 1) / chunk;
+
+    if(chunks == 1)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            body(i);
+        }
+
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+
+    for(size_t c = 0; c < chunks; ++c)
+    {
+        const size_t begin = c * chunk;
+        const size_t end   = std::min(count, begin + chunk);
+
+        submit([&body, &remaining, begin, end] {
+            for(size_t i = begin; i < end; ++i)
+            {
+                body(i);
+            }
+
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    // Help until our chunks are done; may run unrelated tasks as well
+    const size_t home = ((gpPool == this) && (gnWorker >= 0)) ? size_t(gnWorker) : m_Queues.size();
+
+    Task task;
+
+    while(remaining.load(std::memory_order_acquire) > 0)
+    {
+        if(pop(home, task))
+        {
+            task();
+
+            task = nullptr;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Work-stealing thread pool. Every worker owns a task deque; owners pop from the back, idle workers
+ steal from the front of the other deques. Threads blocked in parallelFor help executing tasks.
+ */
+
+#ifndef _THREADS_WORK_STEALING_POOL_H_
+#define _THREADS_WORK_STEALING_POOL_H_
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        // Zero threads means one worker per hardware thread minus the calling thread
+        explicit WorkStealingPool(const size_t& threads = 0);
+
+        // Finishes queued tasks and joins the workers
+        virtual ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // Number of threads that execute tasks, including a thread waiting in parallelFor
+        size_t concurrency() const;
+
+        // Enqueue a task; from a worker it goes to the worker's own deque
+        void submit(Task task);
+
+        // Run body(i) for every i in [0, count), blocking until all calls returned.
+        // Indices are handed out in chunks of grain (zero picks a size automatically).
+        void parallelFor(const size_t& count,
+                         const std::function<void(size_t)>& body,
+                         const size_t& grain = 0);
+
+        // Index of the current worker in [0, concurrency() - 1) or -1 for foreign threads
+        static int workerIndex();
+
+    private:
+        struct Queue
+        {
+            std::mutex       m_Mutex;
+            std::deque<Task> m_Tasks;
+        };
+
+        bool pop(const size_t& home, Task& rTask);
+        void worker(const size_t& index);
+
+        std::vector<std::unique_ptr<Queue>> m_Queues;
+        std::vector<std::thread>            m_Workers;
+
+        std::mutex                          m_Mutex;
+        std::condition_variable             m_Condition;
+        std::atomic<size_t>                 mnPending;
+        std::atomic<size_t>                 mnNext;     // Round robin target for foreign submits
+        bool                                mbStop;
+    }; // WorkStealingPool
+} // Threads
+
+#endif
+
+#endif
@@ -5,7 +5,7 @@ Abstract:
 Header for renderer class which performs Metal setup and per frame rendering
 */
 
-@import MetalKit;
+#import <MetalKit/MetalKit.h>
 
 // Our platform independent render class
 @interface AAPLRenderer : NSObject<MTKViewDelegate>
@@ -1,50 +1,21 @@
-@import MetalKit;
+#import <MetalKit/MetalKit.h>
+
+#import <memory>
 
 #import "AAPLRenderer.h"
 
 // Константы и общие типы данных для шейдера
 #import "AAPLShaderTypes.h"
 
+// Хранилище спрайтов
+#import "AAPLSpriteStore.h"
+
 // Максимальное количество буфферов в обработке
 static const NSUInteger MaxBuffersInFlight = 3;
 
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-// Простой класс, представляющий из себя объект спрайта
-@interface AAPLSprite : NSObject
-@property (nonatomic) vector_float2 position;
-@property (nonatomic) vector_float4 color;
-+(const AAPLVertex*)vertices;
-+(NSUInteger)vertexCount;
-@end
-
-
-@implementation AAPLSprite
-
-// Метод, возвращающий вершины квадрата спрайта
-+(const AAPLVertex *)vertices {
-    const float SpriteSize = 5;
-    static const AAPLVertex spriteVertices[] =
-    {
-        //Pixel Positions,                 RGBA colors
-        { { -SpriteSize,   SpriteSize },   { 0, 0, 0, 1 } },
-        { {  SpriteSize,   SpriteSize },   { 0, 0, 0, 1 } },
-        { { -SpriteSize,  -SpriteSize },   { 0, 0, 0, 1 } },
-
-        { {  SpriteSize,  -SpriteSize },   { 0, 0, 0, 1 } },
-        { { -SpriteSize,  -SpriteSize },   { 0, 0, 0, 1 } },
-        { {  SpriteSize,   SpriteSize },   { 0, 0, 1, 1 } },
-    };
-
-    return spriteVertices;
-}
-
-// The number of vertices for each sprite
-+(NSUInteger)vertexCount{
-    return 6;
-}
-@end
+// Записи инстансов и вершины пишутся хранилищем прямо в буфферы шейдера
+static_assert(sizeof(AAPLSpriteInstance) == sizeof(AAPL::Sprites::Instance), "Instance layouts differ");
+static_assert(sizeof(AAPLVertex) == sizeof(AAPL::Sprites::Vertex), "Vertex layouts differ");
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -65,12 +36,11 @@ static const NSUInteger MaxBuffersInFlight = 3;
     // Индекс текущего активного буффера
     NSUInteger _currentBuffer;
 
-    // Массив спрайтов
-    NSArray<AAPLSprite*>* _sprites;
+    // Спрайты: позиции и цвета хранятся раздельными массивами
+    std::unique_ptr<AAPL::Sprites::Store> _sprites;
 
     NSUInteger _spritesPerRow;
     NSUInteger _spritesPerColumn;
-    NSUInteger _totalSpriteVertexCount;
 }
 
 // Создание рендера на основании вьюшки
@@ -86,7 +56,7 @@ static const NSUInteger MaxBuffersInFlight = 3;
         id<MTLLibrary> defaultLibrary = [_device newDefaultLibrary];
 
         // Вершинный шейдер
-        id<MTLFunction> vertexFunction = [defaultLibrary newFunctionWithName:@"vertexShader"];
+        id<MTLFunction> vertexFunction = [defaultLibrary newFunctionWithName:@"spriteVertexShader"];
 
         // Фрагментный шейдер
         id<MTLFunction> fragmentFunction1 = [defaultLibrary newFunctionWithName:@"fragmentShader1"];
@@ -122,11 +92,8 @@ static const NSUInteger MaxBuffersInFlight = 3;
         // Создаем спрайты
         [self generateSprites];
 
-        // Количество вершин для всех спрайтов
-        _totalSpriteVertexCount = AAPLSprite.vertexCount * _sprites.count;
-
-        // размер буффера вершин для спрайта
-        NSUInteger spriteVertexBufferSize = _totalSpriteVertexCount * sizeof(AAPLVertex);
+        // Одна компактная запись на спрайт вместо шести вершин
+        NSUInteger spriteVertexBufferSize = _sprites->count() * sizeof(AAPLSpriteInstance);
 
         // Создание буфферов данных вершин для каждого кадра
         for(NSUInteger bufferIndex = 0; bufferIndex < MaxBuffersInFlight; bufferIndex++) {
@@ -166,7 +133,7 @@ static const NSUInteger MaxBuffersInFlight = 3;
     _spritesPerRow = SpritesPerRow;
     _spritesPerColumn = RowsOfSprites;
 
-    NSMutableArray *sprites = [[NSMutableArray alloc] initWithCapacity:_spritesPerColumn * _spritesPerRow];
+    _sprites.reset(new AAPL::Sprites::Store(_spritesPerRow, _spritesPerColumn));
 
     // Create a grid of 'sprite' objects
     for(NSUInteger row = 0; row < _spritesPerColumn; row++)
@@ -182,16 +149,13 @@ static const NSUInteger MaxBuffersInFlight = 3;
             // Displace the height of this sprite using a sin wave
             spritePosition.y += (sin(spritePosition.x/WaveMagnitude) * WaveMagnitude);
 
-            // Create our sprite, set its properties and add it to our list
-            AAPLSprite * sprite = [AAPLSprite new];
-
-            sprite.position = spritePosition;
-            sprite.color = Colors[row%NumColors];
+            // Store our sprite's position and color
+            const vector_float4 color = Colors[row%NumColors];
 
-            [sprites addObject:sprite];
+            _sprites->set(row, column, spritePosition.x, spritePosition.y,
+                          AAPL::Sprites::pack(color.x, color.y, color.z, color.w));
         }
     }
-    _sprites = sprites;
 }
 
 /// Called whenever view changes orientation or is resized
@@ -204,35 +168,11 @@ static const NSUInteger MaxBuffersInFlight = 3;
 
 // Обновляем позицию каждого спрайта в очередном буффере на отрисовку
 - (void)updateState {
-    // Получаем указатель на данные текущего буффера
-    AAPLVertex* currentSpriteVertices = _vertexBuffers[_currentBuffer].contents;
-    
-    NSUInteger  currentVertex = _totalSpriteVertexCount-1;
-    NSUInteger  spriteIdx = (_spritesPerColumn * _spritesPerRow)-1;
-    
-    for(NSInteger row = _spritesPerColumn - 1; row >= 0; row--) {
-        float startY = _sprites[spriteIdx].position.y;
-        for(NSInteger spriteInRow = _spritesPerRow-1; spriteInRow >= 0; spriteInRow--) {
-            // Update the position of our sprite
-            vector_float2 updatedPosition = _sprites[spriteIdx].position;
-            
-            if(spriteInRow == 0) {
-                updatedPosition.y = startY;
-            }else{
-                updatedPosition.y = _sprites[spriteIdx-1].position.y;
-            }
-            
-            _sprites[spriteIdx].position = updatedPosition;
-            
-            // Обновляем вершины в текущем буффере вершин с новыми позициями спрайтов
-            for(NSInteger vertexOfSprite = AAPLSprite.vertexCount-1; vertexOfSprite >= 0 ; vertexOfSprite--){
-                currentSpriteVertices[currentVertex].position = AAPLSprite.vertices[vertexOfSprite].position + _sprites[spriteIdx].position;
-                currentSpriteVertices[currentVertex].color = _sprites[spriteIdx].color;
-                currentVertex--;
-            }
-            spriteIdx--;
-        }
-    }
+    // Каждый спрайт получает высоту соседа слева; хранилище лишь сдвигает смещение кольца
+    _sprites->shift();
+
+    // Записываем спрайты в текущий буффер
+    _sprites->instances((AAPL::Sprites::Instance *)_vertexBuffers[_currentBuffer].contents);
 }
 
 // Вызывается для рендеринга
@@ -289,7 +229,8 @@ static const NSUInteger MaxBuffersInFlight = 3;
         // Вызываем отрисовку
         [renderEncoder drawPrimitives:MTLPrimitiveTypeTriangle
                           vertexStart:0
-                          vertexCount:_totalSpriteVertexCount];
+                          vertexCount:AAPL::Sprites::kVerticesPerSprite
+                        instanceCount:_sprites->count()];
         
         // Выставляем пайплайн 2
         [renderEncoder setRenderPipelineState:_pipelineState2];
@@ -305,7 +246,8 @@ static const NSUInteger MaxBuffersInFlight = 3;
         // Вызываем отрисовку
         [renderEncoder drawPrimitives:MTLPrimitiveTypeTriangle
                           vertexStart:0
-                          vertexCount:_totalSpriteVertexCount];
+                          vertexCount:AAPL::Sprites::kVerticesPerSprite
+                        instanceCount:_sprites->count()];
 
         // Заканчиваем кодирование комманд
         [renderEncoder endEncoding];
@@ -20,4 +20,17 @@ typedef struct
     vector_float4 color;
 } AAPLVertex;
 
+// Половина стороны квадрата спрайта в пикселях
+#define AAPLSpriteHalfSize 5.0f
+
+// Компактная запись спрайта для инстансной отрисовки, по одной на спрайт
+typedef struct
+{
+    // Позиция центра в пиксельных координатах
+    float position[2];
+
+    // Цвет RGBA8, красный в младшем байте
+    uint32_t color;
+} AAPLSpriteInstance;
+
 #endif
@@ -41,6 +41,38 @@ vertex RasterizerData vertexShader(uint vertexID [[vertex_id]],	// ID верши
     return out;
 }
 
+// Vertex Function для инстансной отрисовки: вершины квадрата строятся из записи спрайта
+vertex RasterizerData spriteVertexShader(uint vertexID [[vertex_id]],		// ID вершины в спрайте
+                                         uint instanceID [[instance_id]],	// ID спрайта
+                                         const device AAPLSpriteInstance* sprites [[buffer(AAPLVertexInputIndexVertices)]], // Записи спрайтов под индексом 0
+                                         constant vector_uint2* viewportSizePointer [[buffer(AAPLVertexInputIndexViewportSize)]]) // Входной буффер под индексом 1
+{
+    // Углы двух треугольников в том же порядке, что и у вершин спрайта
+    const float2 corners[] =
+    {
+        float2(-1.0,  1.0), float2( 1.0,  1.0), float2(-1.0, -1.0),
+        float2( 1.0, -1.0), float2(-1.0, -1.0), float2( 1.0,  1.0),
+    };
+
+    RasterizerData out;
+
+    const device AAPLSpriteInstance& sprite = sprites[instanceID];
+
+    // Позиция вершины в пиксельных координатах
+    float2 pixelSpacePosition = float2(sprite.position[0], sprite.position[1]) + corners[vertexID] * AAPLSpriteHalfSize;
+
+    // Приводим буффер вьюпорта к float2, исходные данные были в uint2
+    vector_float2 viewportSize = vector_float2(*viewportSizePointer);
+
+    // Вычисляем позицию в пространстве Metal
+    out.clipSpacePosition = vector_float4(pixelSpacePosition / (viewportSize / 2.0), 0.0, 1.0);
+
+    // Распаковываем цвет
+    out.color = unpack_unorm4x8_to_float(sprite.color);
+
+    return out;
+}
+
 // Fragment function
 fragment float4 fragmentShader1(RasterizerData in [[stage_in]]){
     return in.color * vector_float4(1.0, 0.0, 0.0, 1.0);
@@ -0,0 +1,383 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Sprite grid kept as structure of arrays. Every frame each sprite takes the height of its left
+neighbour, the first of a row taking the last's, so the heights of a row only ever rotate: the
+store keeps them where they started and advances a ring offset instead of moving them. Sprites
+are written out as one compact instance record each, or expanded to six vertices each.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#include "AAPLSpriteStore.h"
+#include "WorkStealingPool.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace AAPL
+{
+    namespace Sprites
+    {
+        // Sprites a task writes at least
+        static const size_t kSpritesPerTask = 4096;
+
+        // Vertex output past which stores bypass the cache, as it couldn't hold it anyway
+        static const size_t kStreamingBytes = size_t(4) << 20;
+
+        // Corners of the two triangles, in the order the sample has always drawn them
+        static const float kCorners[kVerticesPerSprite][2] =
+        {
+            { -1.0f,  1.0f },
+            {  1.0f,  1.0f },
+            { -1.0f, -1.0f },
+
+            {  1.0f, -1.0f },
+            { -1.0f, -1.0f },
+            {  1.0f,  1.0f },
+        };
+
+        static void parallelFor(Threads::WorkStealingPool* pPool,
+                                const size_t& count,
+                                const std::function<void(size_t)>& body)
+        {
+            if(pPool && count > 1)
+            {
+                pPool->parallelFor(count, body, 1);
+            }
+            else
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    body(i);
+                }
+            }
+        }
+
+        // Interleave count sprites whose arrays are contiguous
+        static void writeInstances(const float* pX,
+                                   const float* pY,
+                                   const uint32_t* pColors,
+                                   const size_t& count,
+                                   Instance* pInstances)
+        {
+            static_assert(sizeof(Instance) == 3 * sizeof(float), "Instances are three packed words");
+
+            size_t i = 0;
+
+#if defined(__SSE2__)
+            float* pOut = reinterpret_cast<float*>(pInstances);
+
+            for(; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(pX + i);
+                const __m128 y = _mm_loadu_ps(pY + i);
+                const __m128 c = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pColors + i)));
+
+                const __m128 xyLow  = _mm_unpacklo_ps(x, y);    // x0 y0 x1 y1
+                const __m128 xyHigh = _mm_unpackhi_ps(x, y);    // x2 y2 x3 y3
+
+                const __m128 c0x1 = _mm_shuffle_ps(c, xyLow, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m128 y1c1 = _mm_shuffle_ps(xyLow, c, _MM_SHUFFLE(1, 1, 3, 3));
+                const __m128 c2x3 = _mm_shuffle_ps(c, xyHigh, _MM_SHUFFLE(2, 2, 2, 2));
+                const __m128 y3c3 = _mm_shuffle_ps(xyHigh, c, _MM_SHUFFLE(3, 3, 3, 3));
+
+                _mm_storeu_ps(pOut + 3 * i + 0, _mm_shuffle_ps(xyLow, c0x1, _MM_SHUFFLE(2, 0, 1, 0)));
+                _mm_storeu_ps(pOut + 3 * i + 4, _mm_shuffle_ps(y1c1, xyHigh, _MM_SHUFFLE(1, 0, 2, 0)));
+                _mm_storeu_ps(pOut + 3 * i + 8, _mm_shuffle_ps(c2x3, y3c3, _MM_SHUFFLE(2, 0, 2, 0)));
+            }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            float* pOut = reinterpret_cast<float*>(pInstances);
+
+            for(; i + 4 <= count; i += 4)
+            {
+                float32x4x3_t records;
+
+                records.val[0] = vld1q_f32(pX + i);
+                records.val[1] = vld1q_f32(pY + i);
+                records.val[2] = vreinterpretq_f32_u32(vld1q_u32(pColors + i));
+
+                vst3q_f32(pOut + 3 * i, records);
+            }
+#endif
+
+            for(; i < count; ++i)
+            {
+                pInstances[i].position[0] = pX[i];
+                pInstances[i].position[1] = pY[i];
+                pInstances[i].color       = pColors[i];
+            }
+        }
+
+        // Expand count sprites whose arrays are contiguous
+        static void writeVertices(const float* pX,
+                                  const float* pY,
+                                  const uint32_t* pColors,
+                                  const size_t& count,
+                                  const float& halfSize,
+                                  const bool& stream,
+                                  Vertex* pVertices)
+        {
+            static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertices are a float2 and a float4 in 32 bytes");
+
+#if defined(__SSE2__)
+            __m128 corners[kVerticesPerSprite];
+
+            for(size_t k = 0; k < kVerticesPerSprite; ++k)
+            {
+                corners[k] = _mm_setr_ps(kCorners[k][0] * halfSize, kCorners[k][1] * halfSize, 0.0f, 0.0f);
+            }
+
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128  scale = _mm_set1_ps(1.0f / 255.0f);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const __m128i bytes = _mm_cvtsi32_si128(int32_t(pColors[i]));
+                const __m128  color = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero)), scale);
+
+                const __m128 position = _mm_setr_ps(pX[i], pY[i], 0.0f, 0.0f);
+
+                float* pOut = pVertices[i * kVerticesPerSprite].position;
+
+                if(stream)
+                {
+                    for(size_t k = 0; k < kVerticesPerSprite; ++k, pOut += 8)
+                    {
+                        _mm_stream_ps(pOut + 0, _mm_add_ps(position, corners[k]));
+                        _mm_stream_ps(pOut + 4, color);
+                    }
+                }
+                else
+                {
+                    for(size_t k = 0; k < kVerticesPerSprite; ++k, pOut += 8)
+                    {
+                        _mm_storeu_ps(pOut + 0, _mm_add_ps(position, corners[k]));
+                        _mm_storeu_ps(pOut + 4, color);
+                    }
+                }
+            }
+
+            if(stream)
+            {
+                _mm_sfence();
+            }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            // Plain stores only
+            (void)stream;
+
+            float32x4_t corners[kVerticesPerSprite];
+
+            for(size_t k = 0; k < kVerticesPerSprite; ++k)
+            {
+                const float corner[4] = { kCorners[k][0] * halfSize, kCorners[k][1] * halfSize, 0.0f, 0.0f };
+
+                corners[k] = vld1q_f32(corner);
+            }
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const uint16x8_t  words = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pColors[i])));
+                const float32x4_t color = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))), 1.0f / 255.0f);
+
+                const float32x4_t position = vcombine_f32(vset_lane_f32(pY[i], vdup_n_f32(pX[i]), 1), vdup_n_f32(0.0f));
+
+                float* pOut = pVertices[i * kVerticesPerSprite].position;
+
+                for(size_t k = 0; k < kVerticesPerSprite; ++k, pOut += 8)
+                {
+                    vst1q_f32(pOut + 0, vaddq_f32(position, corners[k]));
+                    vst1q_f32(pOut + 4, color);
+                }
+            }
+#else
+            (void)stream;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                float color[4];
+
+                for(size_t c = 0; c < 4; ++c)
+                {
+                    color[c] = float((pColors[i] >> (8 * c)) & 0xFFu) * (1.0f / 255.0f);
+                }
+
+                for(size_t k = 0; k < kVerticesPerSprite; ++k)
+                {
+                    Vertex& rVertex = pVertices[i * kVerticesPerSprite + k];
+
+                    rVertex.position[0] = pX[i] + kCorners[k][0] * halfSize;
+                    rVertex.position[1] = pY[i] + kCorners[k][1] * halfSize;
+                    rVertex.padding[0]  = 0.0f;
+                    rVertex.padding[1]  = 0.0f;
+
+                    std::memcpy(rVertex.color, color, sizeof(color));
+                }
+            }
+#endif
+        }
+    } // Sprites
+} // AAPL
+
+#pragma mark -
+#pragma mark Public - Utilities
+
+uint32_t AAPL::Sprites::pack(const float& red, const float& green, const float& blue, const float& alpha)
+{
+    const float components[4] = { red, green, blue, alpha };
+
+    uint32_t color = 0;
+
+    for(size_t c = 0; c < 4; ++c)
+    {
+        const float value = std::min(std::max(components[c], 0.0f), 1.0f);
+
+        color |= uint32_t(std::lround(value * 255.0f)) << (8 * c);
+    }
+
+    return color;
+}
+
+#pragma mark -
+#pragma mark Public - Store
+
+AAPL::Sprites::Store::Store(const size_t& columns, const size_t& rows)
+: mnColumns(std::max<size_t>(columns, 1)),
+  mnRows(rows),
+  mnOffset(0),
+  m_X(mnColumns * rows, 0.0f),
+  m_Y(mnColumns * rows, 0.0f),
+  m_Colors(mnColumns * rows, 0)
+{
+} // Constructor
+
+AAPL::Sprites::Store::~Store()
+{
+} // Destructor
+
+size_t AAPL::Sprites::Store::columns() const
+{
+    return mnColumns;
+}
+
+size_t AAPL::Sprites::Store::rows() const
+{
+    return mnRows;
+}
+
+size_t AAPL::Sprites::Store::count() const
+{
+    return mnColumns * mnRows;
+}
+
+void AAPL::Sprites::Store::set(const size_t& row,
+                               const size_t& column,
+                               const float& x,
+                               const float& y,
+                               const uint32_t& color)
+{
+    const size_t index = row * mnColumns;
+
+    m_X[index + column]      = x;
+    m_Colors[index + column] = color;
+
+    // Where the ring offset will find it
+    m_Y[index + (column + mnColumns - mnOffset) % mnColumns] = y;
+}
+
+float AAPL::Sprites::Store::x(const size_t& row, const size_t& column) const
+{
+    return m_X[row * mnColumns + column];
+}
+
+float AAPL::Sprites::Store::y(const size_t& row, const size_t& column) const
+{
+    return m_Y[row * mnColumns + (column + mnColumns - mnOffset) % mnColumns];
+}
+
+uint32_t AAPL::Sprites::Store::color(const size_t& row, const size_t& column) const
+{
+    return m_Colors[row * mnColumns + column];
+}
+
+void AAPL::Sprites::Store::shift()
+{
+    mnOffset = (mnOffset + 1) % mnColumns;
+}
+
+void AAPL::Sprites::Store::instances(Instance* pInstances, Threads::WorkStealingPool* pPool) const
+{
+    const size_t rowsPerTask = std::max<size_t>(kSpritesPerTask / mnColumns, 1);
+    const size_t tasks       = (mnRows + rowsPerTask - 1) / rowsPerTask;
+
+    parallelFor(pPool, tasks, [&](size_t task)
+    {
+        const size_t last = std::min(mnRows, (task + 1) * rowsPerTask);
+
+        for(size_t row = task * rowsPerTask; row < last; ++row)
+        {
+            const size_t index = row * mnColumns;
+
+            // Columns before the offset read heights from the end of the row, the rest from its start
+            writeInstances(m_X.data() + index,
+                           m_Y.data() + index + mnColumns - mnOffset,
+                           m_Colors.data() + index,
+                           mnOffset,
+                           pInstances + index);
+
+            writeInstances(m_X.data() + index + mnOffset,
+                           m_Y.data() + index,
+                           m_Colors.data() + index + mnOffset,
+                           mnColumns - mnOffset,
+                           pInstances + index + mnOffset);
+        }
+    });
+}
+
+void AAPL::Sprites::Store::vertices(const float& halfSize,
+                                    Vertex* pVertices,
+                                    Threads::WorkStealingPool* pPool) const
+{
+    const size_t rowsPerTask = std::max<size_t>(kSpritesPerTask / mnColumns, 1);
+    const size_t tasks       = (mnRows + rowsPerTask - 1) / rowsPerTask;
+
+    // Streaming stores need 16 byte alignment, which buffer contents always have
+    const bool stream = (count() * kVerticesPerSprite * sizeof(Vertex) >= kStreamingBytes) &&
+                        (reinterpret_cast<uintptr_t>(pVertices) % 16 == 0);
+
+    parallelFor(pPool, tasks, [&](size_t task)
+    {
+        const size_t last = std::min(mnRows, (task + 1) * rowsPerTask);
+
+        for(size_t row = task * rowsPerTask; row < last; ++row)
+        {
+            const size_t index = row * mnColumns;
+
+            writeVertices(m_X.data() + index,
+                          m_Y.data() + index + mnColumns - mnOffset,
+                          m_Colors.data() + index,
+                          mnOffset,
+                          halfSize,
+                          stream,
+                          pVertices + index * kVerticesPerSprite);
+
+            writeVertices(m_X.data() + index + mnOffset,
+                          m_Y.data() + index,
+                          m_Colors.data() + index + mnOffset,
+                          mnColumns - mnOffset,
+                          halfSize,
+                          stream,
+                          pVertices + (index + mnOffset) * kVerticesPerSprite);
+        }
+    });
+}
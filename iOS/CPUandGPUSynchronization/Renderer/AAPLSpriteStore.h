@@ -0,0 +1,97 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Sprite grid kept as structure of arrays. Every frame each sprite takes the height of its left
+neighbour, the first of a row taking the last's, so the heights of a row only ever rotate: the
+store keeps them where they started and advances a ring offset instead of moving them. Sprites
+are written out as one compact instance record each, or expanded to six vertices each.
+*/
+
+#ifndef _AAPL_SPRITE_STORE_H_
+#define _AAPL_SPRITE_STORE_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace AAPL
+{
+    namespace Sprites
+    {
+        // Vertices of a sprite's two triangles
+        static const size_t kVerticesPerSprite = 6;
+
+        // Per sprite record an instanced draw reads; the colour is RGBA8, red in the lowest byte
+        struct Instance
+        {
+            float    position[2];
+            uint32_t color;
+        };
+
+        // Same layout as AAPLVertex, a float2 position then a 16 byte aligned float4 colour
+        struct alignas(16) Vertex
+        {
+            float position[2];
+            float padding[2];
+            float color[4];
+        };
+
+        // Pack a colour with components in [0, 1] to RGBA8
+        uint32_t pack(const float& red, const float& green, const float& blue, const float& alpha);
+
+        class Store
+        {
+        public:
+            Store(const size_t& columns, const size_t& rows);
+
+            virtual ~Store();
+
+            size_t columns() const;
+            size_t rows()    const;
+            size_t count()   const;
+
+            void set(const size_t& row,
+                     const size_t& column,
+                     const float& x,
+                     const float& y,
+                     const uint32_t& color);
+
+            float    x(const size_t& row, const size_t& column) const;
+            float    y(const size_t& row, const size_t& column) const;
+            uint32_t color(const size_t& row, const size_t& column) const;
+
+            // Every sprite takes the height of its left neighbour, the first of a row the last's
+            void shift();
+
+            // One record per sprite, row after row. Rows are split across the pool if there is one.
+            void instances(Instance* pInstances, Threads::WorkStealingPool* pPool = nullptr) const;
+
+            // Six vertices per sprite, a square of halfSize around its position, for renderers
+            // that draw without instancing. Rows are split across the pool if there is one.
+            void vertices(const float& halfSize,
+                          Vertex* pVertices,
+                          Threads::WorkStealingPool* pPool = nullptr) const;
+
+        private:
+            size_t                 mnColumns;
+            size_t                 mnRows;
+            size_t                 mnOffset;     // Columns the heights have rotated right by
+
+            std::vector<float>     m_X;
+            std::vector<float>     m_Y;          // As set, before rotating
+            std::vector<uint32_t>  m_Colors;
+        }; // Class Store
+    } // Sprites
+} // AAPL
+
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+/*
+See LICENSE folder for this sample’s licensing information.
+
+Abstract:
+Benchmark for the sprite store, a standalone program that is not part of the app target. It lays
+out the sample's grid and replays the renderer's original per-sprite loop next to the store: every
+frame each sprite object takes its left neighbour's height and is written out as six vertices. After
+every frame the store's instances must hold the same positions and the colours packed from the
+objects', and its expanded vertices the same positions and colours to within the rounding to RGBA8.
+It then times shift() with instances() and vertices() against the original loop per frame, on the
+sample's 110x50 grid and on 1000x1000, on the calling thread alone and split across a pool.
+
+    c++ -std=c++11 -O2 -pthread -I../../../Shared/Threads AAPLSpriteStore.cpp \
+        ../../../Shared/Threads/WorkStealingPool.cpp AAPLSpriteStoreBenchmark.cpp -o benchmark
+    ./benchmark
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "AAPLSpriteStore.h"
+#include "WorkStealingPool.h"
+
+using namespace AAPL::Sprites;
+
+namespace
+{
+    const float kSpriteSize = 5.0f;
+
+    // Corners of the original AAPLSprite's quad
+    const float kCorners[kVerticesPerSprite][2] =
+    {
+        {-1.0f,  1.0f}, { 1.0f,  1.0f}, {-1.0f, -1.0f},
+        { 1.0f, -1.0f}, {-1.0f, -1.0f}, { 1.0f,  1.0f}
+    };
+
+    const float kColors[][4] =
+    {
+        {1.0f,  0.0f, 0.0f,  0.8f},     // Red
+        {0.0f,  1.0f, 1.0f,  0.8f},     // Cyan
+        {0.0f,  1.0f, 0.0f,  0.8f},     // Green
+        {1.0f,  0.5f, 0.0f,  0.8f},     // Orange
+        {1.0f,  0.0f, 1.0f,  0.8f},     // Magenta
+        {0.0f,  0.0f, 1.0f,  0.8f},     // Blue
+        {1.0f,  1.0f, 0.0f,  0.8f},     // Yellow
+        {0.75f, 0.5f, 0.25f, 0.8f},     // Brown
+        {1.0f,  1.0f, 1.0f,  0.8f}      // White
+    };
+
+    const size_t kColorCount = sizeof(kColors) / sizeof(kColors[0]);
+
+    // Stand-in for the original AAPLSprite object
+    struct Sprite
+    {
+        float position[2];
+        float color[4];
+    };
+
+    struct Timings
+    {
+        double original;
+        double instances;
+        double vertices;
+    };
+
+    // The grid generateSprites laid out
+    void layout(const size_t& columns, const size_t& rows, std::vector<Sprite>& rSprites, Store& rStore)
+    {
+        const float XSpacing      = 12.0f;
+        const float YSpacing      = 16.0f;
+        const float WaveMagnitude = 30.0f;
+
+        rSprites.resize(columns * rows);
+
+        for(size_t row = 0; row < rows; ++row)
+        {
+            for(size_t column = 0; column < columns; ++column)
+            {
+                Sprite& rSprite = rSprites[row * columns + column];
+
+                rSprite.position[0] = ((-float(columns) / 2.0f) + float(column)) * XSpacing;
+                rSprite.position[1] = ((-float(rows) / 2.0f) + float(row)) * YSpacing + WaveMagnitude;
+                rSprite.position[1] += std::sin(rSprite.position[0] / WaveMagnitude) * WaveMagnitude;
+
+                std::memcpy(rSprite.color, kColors[row % kColorCount], sizeof(rSprite.color));
+
+                const float* pColor = rSprite.color;
+
+                rStore.set(row, column, rSprite.position[0], rSprite.position[1], pack(pColor[0], pColor[1], pColor[2], pColor[3]));
+            }
+        }
+    }
+
+    // The renderer's updateState before the store, back to front as it ran
+    void originalUpdate(const size_t& columns, const size_t& rows, std::vector<Sprite>& rSprites, Vertex* pVertices)
+    {
+        size_t vertex = columns * rows * kVerticesPerSprite - 1;
+        size_t index  = columns * rows - 1;
+
+        for(size_t row = rows; row-- > 0;)
+        {
+            const float startY = rSprites[index].position[1];
+
+            for(size_t column = columns; column-- > 0;)
+            {
+                rSprites[index].position[1] = (column == 0) ? startY : rSprites[index - 1].position[1];
+
+                for(size_t corner = kVerticesPerSprite; corner-- > 0;)
+                {
+                    Vertex& rVertex = pVertices[vertex--];
+
+                    rVertex.position[0] = kCorners[corner][0] * kSpriteSize + rSprites[index].position[0];
+                    rVertex.position[1] = kCorners[corner][1] * kSpriteSize + rSprites[index].position[1];
+
+                    std::memcpy(rVertex.color, rSprites[index].color, sizeof(rVertex.color));
+                }
+
+                index--;
+            }
+        }
+    }
+
+    // Index of the first sprite whose instance or vertices differ from the original's, or the
+    // sprite count when there is none
+    size_t firstMismatch(const std::vector<Sprite>& rSprites,
+                         const std::vector<Vertex>& rOriginal,
+                         const std::vector<Instance>& rInstances,
+                         const std::vector<Vertex>& rVertices)
+    {
+        // Half a step of RGBA8, and rounding
+        const float tolerance = 0.5f / 255.0f + 1.0e-6f;
+
+        for(size_t i = 0; i < rSprites.size(); ++i)
+        {
+            const Sprite&   rSprite   = rSprites[i];
+            const Instance& rInstance = rInstances[i];
+
+            bool same = (rInstance.position[0] == rSprite.position[0]) &&
+                        (rInstance.position[1] == rSprite.position[1]) &&
+                        (rInstance.color == pack(rSprite.color[0], rSprite.color[1], rSprite.color[2], rSprite.color[3]));
+
+            for(size_t v = i * kVerticesPerSprite; same && (v < (i + 1) * kVerticesPerSprite); ++v)
+            {
+                same = (rVertices[v].position[0] == rOriginal[v].position[0]) &&
+                       (rVertices[v].position[1] == rOriginal[v].position[1]);
+
+                for(int k = 0; same && (k < 4); ++k)
+                {
+                    same = (std::abs(rVertices[v].color[k] - rOriginal[v].color[k]) <= tolerance);
+                }
+            }
+
+            if(!same)
+            {
+                return i;
+            }
+        }
+
+        return rSprites.size();
+    }
+
+    bool run(const size_t& columns,
+             const size_t& rows,
+             const int& frames,
+             const bool& verify,
+             Threads::WorkStealingPool* pPool)
+    {
+        const size_t count = columns * rows;
+
+        std::vector<Sprite> sprites;
+        Store               store(columns, rows);
+
+        layout(columns, rows, sprites, store);
+
+        std::vector<Vertex>   original(count * kVerticesPerSprite);
+        std::vector<Vertex>   vertices(count * kVerticesPerSprite);
+        std::vector<Instance> instances(count);
+
+        Timings timings = {0.0, 0.0, 0.0};
+
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            originalUpdate(columns, rows, sprites, original.data());
+
+            auto end = std::chrono::steady_clock::now();
+
+            timings.original += std::chrono::duration<double, std::milli>(end - start).count();
+
+            start = end;
+
+            store.shift();
+            store.instances(instances.data(), pPool);
+
+            end = std::chrono::steady_clock::now();
+
+            timings.instances += std::chrono::duration<double, std::milli>(end - start).count();
+
+            start = end;
+
+            store.vertices(kSpriteSize, vertices.data(), pPool);
+
+            timings.vertices += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if(verify)
+            {
+                const size_t mismatch = firstMismatch(sprites, original, instances, vertices);
+
+                if(mismatch != count)
+                {
+                    std::printf("%zux%zu, frame %d: sprite %zu differs from the original loop\n", columns, rows, frame, mismatch);
+
+                    return false;
+                }
+            }
+        }
+
+        std::printf("%4zux%-4zu %-15s original %7.3f ms, shift and instances %7.3f ms, vertices %7.3f ms per frame%s\n",
+                    columns, rows, pPool ? "on the pool," : "on one thread,",
+                    timings.original / frames, timings.instances / frames, timings.vertices / frames,
+                    verify ? ", checked every frame" : "");
+
+        return true;
+    }
+} // unnamed
+
+int main()
+{
+    Threads::WorkStealingPool pool;
+
+    std::printf("%zu threads\n", pool.concurrency());
+
+    bool passed = true;
+
+    // Odd sizes, the sample's grid, then a large one timed without the checks in the way
+    passed = run(7, 3, 40, true, nullptr) && passed;
+    passed = run(110, 50, 300, true, nullptr) && passed;
+    passed = run(110, 50, 300, true, &pool) && passed;
+    passed = run(1000, 1000, 3, true, &pool) && passed;
+    passed = run(1000, 1000, 20, false, nullptr) && passed;
+    passed = run(1000, 1000, 20, false, &pool) && passed;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,351 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Headless N-body scenarios. A scenario takes the globals and one parameter set of the app's
+ preferences, lays out the bodies the way NBodyURDGenerator does for the chosen config, advances
+ them on the CPU simulator or integrator and streams every so many steps to a snapshot file, with
+ no drawable involved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "NBodySnapshot.h"
+
+#include "NBodyHeadless.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace NBody
+{
+    namespace Headless
+    {
+        // NBodyURDGenerator's scale of the particle count
+        static const float kScale = 1.0f / 1024.0f;
+
+        struct float3
+        {
+            float x;
+            float y;
+            float z;
+        };
+
+        static inline float length(const float3& v)
+        {
+            return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        }
+
+        static inline float3 normalize(const float3& v)
+        {
+            const float s = 1.0f / length(v);
+
+            return {v.x * s, v.y * s, v.z * s};
+        }
+
+        // The generator's two distributions: the unit cube's corner, and the unit ball
+        class Distribution
+        {
+        public:
+            explicit Distribution(const uint32_t& seed)
+            : m_Generator(seed),
+              m_Unit(0.0f, 1.0f),
+              m_Signed(-1.0f, 1.0f)
+            {
+            } // Constructor
+
+            float3 rand0()
+            {
+                const float x = m_Unit(m_Generator);
+                const float y = m_Unit(m_Generator);
+                const float z = m_Unit(m_Generator);
+
+                return {x, y, z};
+            }
+
+            float3 rand1()
+            {
+                float3 v;
+
+                do
+                {
+                    v.x = m_Signed(m_Generator);
+                    v.y = m_Signed(m_Generator);
+                    v.z = m_Signed(m_Generator);
+                }
+                while(length(v) > 1.0f);
+
+                return v;
+            }
+
+            float3 nrand1()
+            {
+                float3 v;
+
+                // The bounded generator may return the origin, which has no direction
+                do
+                {
+                    v = rand1();
+                }
+                while(length(v) < 1.0e-6f);
+
+                return normalize(v);
+            }
+
+        private:
+            std::mt19937                           m_Generator;
+            std::uniform_real_distribution<float>  m_Unit;
+            std::uniform_real_distribution<float>  m_Signed;
+        }; // Class Distribution
+
+        static void configureRandom(Distribution& rDistribution,
+                                    const float& particles,
+                                    const Parameters& parameters,
+                                    const size_t& count,
+                                    CPU::float4* pPosition,
+                                    CPU::float4* pVelocity)
+        {
+            const float pscale = parameters.clusterScale  * std::max(1.0f, particles);
+            const float vscale = parameters.velocityScale * pscale;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const float3 point    = rDistribution.nrand1();
+                const float3 velocity = rDistribution.nrand1();
+
+                pPosition[i] = {pscale * point.x, pscale * point.y, pscale * point.z, 1.0f};
+                pVelocity[i] = {vscale * velocity.x, vscale * velocity.y, vscale * velocity.z, 1.0f};
+            }
+        }
+
+        static void configureShell(Distribution& rDistribution,
+                                   const Parameters& parameters,
+                                   const float3& axis,
+                                   const size_t& count,
+                                   CPU::float4* pPosition,
+                                   CPU::float4* pVelocity)
+        {
+            const float pscale = parameters.clusterScale;
+            const float vscale = pscale * parameters.velocityScale;
+            const float inner  = 2.5f * pscale;
+            const float outer  = 4.0f * pscale;
+            const float length = outer - inner;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const float3 nrpos = rDistribution.nrand1();
+                const float3 rpos  = rDistribution.rand0();
+
+                const float3 position = {nrpos.x * (inner + length * rpos.x),
+                                         nrpos.y * (inner + length * rpos.y),
+                                         nrpos.z * (inner + length * rpos.z)};
+
+                float3 spin = axis;
+
+                const float scalar = nrpos.x * spin.x + nrpos.y * spin.y + nrpos.z * spin.z;
+
+                if((1.0f - scalar) < 1e-6f)
+                {
+                    spin.x = nrpos.y;
+                    spin.y = nrpos.x;
+                    spin   = normalize(spin);
+                }
+
+                const float3 velocity = {position.y * spin.z - position.z * spin.y,
+                                         position.z * spin.x - position.x * spin.z,
+                                         position.x * spin.y - position.y * spin.x};
+
+                pPosition[i] = {position.x, position.y, position.z, 1.0f};
+                pVelocity[i] = {velocity.x * vscale, velocity.y * vscale, velocity.z * vscale, 1.0f};
+            }
+        }
+
+        static void configureExpand(Distribution& rDistribution,
+                                    const float& particles,
+                                    const Parameters& parameters,
+                                    const size_t& count,
+                                    CPU::float4* pPosition,
+                                    CPU::float4* pVelocity)
+        {
+            const float pscale = parameters.clusterScale * std::max(1.0f, particles);
+            const float vscale = pscale * parameters.velocityScale;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const float3 point = rDistribution.rand1();
+
+                pPosition[i] = {point.x * pscale, point.y * pscale, point.z * pscale, 1.0f};
+                pVelocity[i] = {point.x * vscale, point.y * vscale, point.z * vscale, 1.0f};
+            }
+        }
+
+        static double seconds()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    } // Headless
+} // NBody
+
+#pragma mark -
+#pragma mark Public - Scenarios
+
+void NBody::Headless::generate(const uint32_t& config,
+                               const Globals& globals,
+                               const Parameters& parameters,
+                               const Settings& settings,
+                               CPU::float4* pPosition,
+                               CPU::float4* pVelocity)
+{
+    Distribution distribution(settings.seed);
+
+    const float particles = kScale * float(globals.particles);
+
+    switch(config)
+    {
+        case Defaults::Configs::eExpand:
+            configureExpand(distribution, particles, parameters, globals.particles, pPosition, pVelocity);
+            break;
+
+        case Defaults::Configs::eRandom:
+            configureRandom(distribution, particles, parameters, globals.particles, pPosition, pVelocity);
+            break;
+
+        case Defaults::Configs::eShell:
+        default:
+        {
+            const float3 axis = normalize({settings.axis[0], settings.axis[1], settings.axis[2]});
+
+            configureShell(distribution, parameters, axis, globals.particles, pPosition, pVelocity);
+        }
+            break;
+    }
+}
+
+NBody::Compute::Prefs NBody::Headless::prefs(const Globals& globals, const Parameters& parameters)
+{
+    Compute::Prefs prefs;
+
+    prefs.timestep     = parameters.timestep;
+    prefs.damping      = parameters.damping;
+    prefs.softeningSqr = parameters.softening * parameters.softening;
+    prefs.particles    = globals.particles;
+
+    return prefs;
+}
+
+bool NBody::Headless::run(const Globals& globals,
+                          const Parameters& parameters,
+                          const Settings& settings,
+                          const std::string& path,
+                          Threads::WorkStealingPool* pPool,
+                          Report& rReport)
+{
+    rReport = Report();
+
+    if(!globals.particles || !settings.frames)
+    {
+        return false;
+    }
+
+    const double start = seconds();
+
+    const Compute::Prefs computePrefs = prefs(globals, parameters);
+
+    std::unique_ptr<CPU::Simulator>  pSimulator;
+    std::unique_ptr<CPU::Integrator> pIntegrator;
+
+    CPU::float4* pPosition = nullptr;
+    CPU::float4* pVelocity = nullptr;
+
+    if(settings.integrator == CPU::Integrators::eEuler)
+    {
+        pSimulator.reset(new CPU::Simulator(globals.particles, pPool));
+
+        pPosition = pSimulator->position();
+        pVelocity = pSimulator->velocity();
+    }
+    else
+    {
+        pIntegrator.reset(new CPU::Integrator(globals.particles, pPool));
+
+        pIntegrator->setLevels((settings.integrator == CPU::Integrators::eBlock) ? settings.levels : 0);
+        pIntegrator->setAccuracy(settings.accuracy);
+
+        pPosition = pIntegrator->position();
+        pVelocity = pIntegrator->velocity();
+    }
+
+    generate(settings.config, globals, parameters, settings, pPosition, pVelocity);
+
+    const CPU::Diagnostics initial = CPU::diagnose(pPosition, pVelocity, globals.particles, computePrefs.softeningSqr, pPool);
+
+    if(pSimulator)
+    {
+        pSimulator->setPrefs(computePrefs);
+    }
+    else
+    {
+        pIntegrator->setPrefs(computePrefs);
+    }
+
+    Snapshot::Header header;
+
+    header.particles        = globals.particles;
+    header.frames           = 0;
+    header.keyFrameInterval = settings.keyFrameInterval;
+    header.step             = settings.precision;
+    header.timestep         = parameters.timestep;
+    header.config           = settings.config;
+    header.indexOffset      = 0;
+
+    Snapshot::Writer writer;
+
+    if(!writer.open(path, header))
+    {
+        return false;
+    }
+
+    bool written = writer.append(pPosition, 0.0f);
+
+    for(uint32_t frame = 1; written && frame < settings.frames; ++frame)
+    {
+        for(uint32_t step = 0; step < settings.stepsPerFrame; ++step)
+        {
+            if(pSimulator)
+            {
+                pSimulator->step();
+            }
+            else
+            {
+                pIntegrator->step();
+            }
+
+            rReport.steps++;
+        }
+
+        const double time = pSimulator ? pSimulator->time() : pIntegrator->time();
+
+        // Copied into a staging buffer; encoding and writing overlap the next steps
+        written = writer.append(pPosition, float(time));
+    }
+
+    written = writer.close() && written;
+
+    rReport.frames   = writer.frames();
+    rReport.seconds  = seconds() - start;
+    rReport.stalled  = writer.stalled();
+    rReport.bytes    = writer.bytes();
+    rReport.rawBytes = uint64_t(rReport.frames) * globals.particles * sizeof(CPU::float4);
+
+    rReport.evaluations = pIntegrator ? pIntegrator->evaluations() : (rReport.steps * globals.particles);
+
+    const CPU::Diagnostics final = CPU::diagnose(pPosition, pVelocity, globals.particles, computePrefs.softeningSqr, pPool);
+
+    rReport.energyError = (final.energy - initial.energy) / std::fabs(initial.energy);
+
+    return written;
+}
@@ -0,0 +1,103 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Headless N-body scenarios. A scenario takes the globals and one parameter set of the app's
+ preferences, lays out the bodies the way NBodyURDGenerator does for the chosen config, advances
+ them on the CPU simulator or integrator and streams every so many steps to a snapshot file, with
+ no drawable involved.
+ */
+
+#ifndef _NBODY_HEADLESS_H_
+#define _NBODY_HEADLESS_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "NBodyDefaults.h"
+#include "NBodyIntegrator.h"
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace NBody
+{
+    namespace Headless
+    {
+        // The "NBody_Globals" dictionary
+        struct Globals
+        {
+            uint32_t particles = Defaults::kParticles;
+            uint32_t texRes    = Defaults::kTexRes;
+            uint32_t channels  = Defaults::kChannels;
+        };
+
+        // One dictionary of the "NBody_Parameters" array
+        struct Parameters
+        {
+            float timestep      = Defaults::kTimestep;
+            float clusterScale  = Defaults::Scale::kCluster;
+            float velocityScale = Defaults::Scale::kVelocity;
+            float softening     = 1.0f;
+            float damping       = Defaults::kDamping;
+            float pointSize     = Defaults::kPointSz;
+        };
+
+        struct Settings
+        {
+            uint32_t frames           = Defaults::kFrames;      // Snapshots, the initial state included
+            uint32_t stepsPerFrame    = 1;                      // Simulation steps between snapshots
+            uint32_t config           = Defaults::Configs::eShell;
+            uint32_t seed             = 1;
+            float    precision        = 1.0f / 1024.0f;         // Quantisation step of the positions
+            uint32_t keyFrameInterval = 32;
+            float    axis[3]          = {0.0f, 0.0f, 1.0f};     // Spin axis of the shell
+            uint32_t integrator       = CPU::Integrators::eEuler;
+            uint32_t levels           = 6;                      // Block timestep levels below the timestep
+            float    accuracy         = 0.025f;                 // Block timestep accuracy
+        };
+
+        struct Report
+        {
+            uint64_t steps    = 0;
+            uint32_t frames   = 0;
+            double   seconds  = 0.0;    // Wall time of the whole run
+            double   stalled  = 0.0;    // Of which waiting for the snapshot writer
+            uint64_t bytes    = 0;      // Snapshot file size
+            uint64_t rawBytes = 0;      // The same frames as float4 arrays
+
+            uint64_t evaluations = 0;   // Bodies whose force was summed over every source
+            double   energyError = 0.0; // Relative change in total energy over the run
+        };
+
+        // Initial positions and velocities for a config, as NBodyURDGenerator lays them out but
+        // from a seeded generator, so a scenario can be run again
+        void generate(const uint32_t& config,
+                      const Globals& globals,
+                      const Parameters& parameters,
+                      const Settings& settings,
+                      CPU::float4* pPosition,
+                      CPU::float4* pVelocity);
+
+        // The compute stage's mapping of a parameter set
+        Compute::Prefs prefs(const Globals& globals, const Parameters& parameters);
+
+        // Simulate one scenario into a snapshot file. Bodies are split across the pool when there
+        // is one; the snapshot writer has its own thread either way.
+        bool run(const Globals& globals,
+                 const Parameters& parameters,
+                 const Settings& settings,
+                 const std::string& path,
+                 Threads::WorkStealingPool* pPool,
+                 Report& rReport);
+    } // Headless
+} // NBody
+
+#endif
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Runs the app's N-body scenarios without a drawable, writing each one's trajectory to a snapshot file.
+ */
+
+#import <Foundation/Foundation.h>
+
+@interface NBodyHeadlessRunner : NSObject
+
+// Количество наборов параметров в конфиге
+@property (readonly) uint32_t simulationsTotalCount;
+
+// Количество партиклов, по умолчанию из конфига
+@property (nonatomic) uint32_t particles;
+
+// Тип начальной конфигурации, по умолчанию eShell
+@property (nonatomic) uint32_t config;
+
+// Количество снапшотов на симуляцию, начальное состояние включительно
+@property (nonatomic) uint32_t frames;
+
+// Шагов симуляции между снапшотами
+@property (nonatomic) uint32_t stepsPerFrame;
+
+// Шаг квантования позиций в снапшотах
+@property (nonatomic) float precision;
+
+// Интегратор: эйлер как в ядре, leapfrog или иерархия блочных шагов
+@property (nonatomic) uint32_t integrator;
+
+// Зерно генератора начальных условий
+@property (nonatomic) uint32_t seed;
+
+// Загрузка параметров из plist или эквивалентного JSON
+- (nullable instancetype)initWithFile:(nonnull NSString *)path;
+
+// Симуляция одного набора параметров в файл снапшотов
+- (BOOL)runSimulation:(uint32_t)index toFile:(nonnull NSString *)path;
+
+// Все наборы параметров, по файлу "nbody-<index>.nbss" на каждый
+- (BOOL)runAllToDirectory:(nonnull NSString *)directory;
+
+@end
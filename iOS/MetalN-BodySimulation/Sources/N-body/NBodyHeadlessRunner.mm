@@ -0,0 +1,230 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Runs the app's N-body scenarios without a drawable, writing each one's trajectory to a snapshot file.
+ */
+
+#import <vector>
+
+#import "WorkStealingPool.h"
+
+#import "NBodyDefaults.h"
+#import "NBodyHeadless.h"
+#import "NBodyPreferencesKeys.h"
+#import "NBodyHeadlessRunner.h"
+
+// Общий пул потоков для всех симуляций
+static Threads::WorkStealingPool& simulationPool() {
+    static Threads::WorkStealingPool pool;
+    
+    return pool;
+}
+
+@implementation NBodyHeadlessRunner {
+@private
+    NBody::Headless::Globals _globals;
+    NBody::Headless::Settings _settings;
+    
+    std::vector<NBody::Headless::Parameters> _parameters;
+}
+
+// Конфиг в формате plist, либо JSON с теми же ключами
+- (nullable NSDictionary *) _newProperties:(nonnull NSString *)path {
+    NSData* pData = [NSData dataWithContentsOfFile:path];
+    if(!pData){
+        NSLog(@">> ERROR: Failed instantiating a data from the contents of a file!");
+        return nil;
+    }
+    
+    NSError* pError = nil;
+    id pProperties = [NSPropertyListSerialization propertyListWithData:pData
+                                                               options:NSPropertyListImmutable
+                                                                format:nil
+                                                                 error:&pError];
+    
+    if(!pProperties){
+        pError = nil;
+        pProperties = [NSJSONSerialization JSONObjectWithData:pData options:0 error:&pError];
+    }
+    
+    if(pError){
+        NSLog(@">> ERROR: \"%@\"", pError.description);
+    }
+    
+    return [pProperties isKindOfClass:[NSDictionary class]] ? pProperties : nil;
+}
+
+// Значение по ключу, если оно есть
+static float NBodyFloat(NSDictionary* pDictionary, NSString* pKey, float value) {
+    id pValue = pDictionary[pKey];
+    
+    return [pValue isKindOfClass:[NSNumber class]] ? [pValue floatValue] : value;
+}
+
+static uint32_t NBodyUnsigned(NSDictionary* pDictionary, NSString* pKey, uint32_t value) {
+    id pValue = pDictionary[pKey];
+    
+    return [pValue isKindOfClass:[NSNumber class]] ? [pValue unsignedIntValue] : value;
+}
+
+- (nullable instancetype) initWithFile:(nonnull NSString *)path {
+    self = [super init];
+    
+    if(self){
+        NSDictionary* pProperties = [self _newProperties:path];
+        
+        if(!pProperties){
+            return nil;
+        }
+        
+        // Глобальные настройки
+        NSDictionary* pGlobals = pProperties[kNBodyGlobals];
+        
+        if([pGlobals isKindOfClass:[NSDictionary class]]){
+            _globals.particles = NBodyUnsigned(pGlobals, kNBodyParticles, _globals.particles);
+            _globals.texRes    = NBodyUnsigned(pGlobals, kNBodyTexRes,    _globals.texRes);
+            _globals.channels  = NBodyUnsigned(pGlobals, kNBodyChannels,  _globals.channels);
+        }
+        
+        // Параметры каждой отдельной симуляции
+        NSArray* pParameters = pProperties[kNBodyParameters];
+        
+        if([pParameters isKindOfClass:[NSArray class]]){
+            for(NSDictionary* pSimulation in pParameters){
+                if(![pSimulation isKindOfClass:[NSDictionary class]]){
+                    continue;
+                }
+                
+                NBody::Headless::Parameters parameters;
+                
+                parameters.timestep      = NBodyFloat(pSimulation, kNBodyTimestep,      parameters.timestep);
+                parameters.clusterScale  = NBodyFloat(pSimulation, kNBodyClusterScale,  parameters.clusterScale);
+                parameters.velocityScale = NBodyFloat(pSimulation, kNBodyVelocityScale, parameters.velocityScale);
+                parameters.softening     = NBodyFloat(pSimulation, kNBodySoftening,     parameters.softening);
+                parameters.damping       = NBodyFloat(pSimulation, kNBodyDamping,       parameters.damping);
+                parameters.pointSize     = NBodyFloat(pSimulation, kNBodyPointSize,     parameters.pointSize);
+                
+                _parameters.push_back(parameters);
+            }
+        }
+        
+        if(_parameters.empty()){
+            NSLog(@">> ERROR: No simulation parameters in \"%@\"!", path);
+            return nil;
+        }
+    }
+    
+    return self;
+}
+
+- (uint32_t) simulationsTotalCount {
+    return uint32_t(_parameters.size());
+}
+
+- (uint32_t) particles {
+    return _globals.particles;
+}
+
+- (void) setParticles:(uint32_t)particles {
+    _globals.particles = particles ? particles : NBody::Defaults::kParticles;
+}
+
+- (uint32_t) config {
+    return _settings.config;
+}
+
+- (void) setConfig:(uint32_t)config {
+    _settings.config = config;
+}
+
+- (uint32_t) frames {
+    return _settings.frames;
+}
+
+- (void) setFrames:(uint32_t)frames {
+    _settings.frames = frames;
+}
+
+- (uint32_t) stepsPerFrame {
+    return _settings.stepsPerFrame;
+}
+
+- (void) setStepsPerFrame:(uint32_t)stepsPerFrame {
+    _settings.stepsPerFrame = stepsPerFrame ? stepsPerFrame : 1;
+}
+
+- (float) precision {
+    return _settings.precision;
+}
+
+- (void) setPrecision:(float)precision {
+    _settings.precision = precision;
+}
+
+- (uint32_t) integrator {
+    return _settings.integrator;
+}
+
+- (void) setIntegrator:(uint32_t)integrator {
+    _settings.integrator = (integrator < NBody::CPU::Integrators::eCount) ? integrator : NBody::CPU::Integrators::eEuler;
+}
+
+- (uint32_t) seed {
+    return _settings.seed;
+}
+
+- (void) setSeed:(uint32_t)seed {
+    _settings.seed = seed;
+}
+
+- (BOOL) runSimulation:(uint32_t)index toFile:(nonnull NSString *)path {
+    if(index >= _parameters.size()){
+        NSLog(@">> ERROR: No simulation parameters at index %u!", index);
+        return NO;
+    }
+    
+    NBody::Headless::Report report;
+    
+    const bool written = NBody::Headless::run(_globals,
+                                              _parameters[index],
+                                              _settings,
+                                              path.fileSystemRepresentation,
+                                              &simulationPool(),
+                                              report);
+    
+    if(!written){
+        NSLog(@">> ERROR: Failed writing the snapshots to \"%@\"!", path);
+        return NO;
+    }
+    
+    NSLog(@">> N-body simulation %u: %u frames, %llu steps in %.2f s (%.3f s waiting on disk), %llu bytes (%.1f%% of raw)",
+          index,
+          report.frames,
+          report.steps,
+          report.seconds,
+          report.stalled,
+          report.bytes,
+          100.0 * double(report.bytes) / double(report.rawBytes));
+    
+    NSLog(@">> N-body simulation %u: %llu force evaluations, energy changed by %.3g",
+          index,
+          report.evaluations,
+          report.energyError);
+    
+    return YES;
+}
+
+- (BOOL) runAllToDirectory:(nonnull NSString *)directory {
+    BOOL written = YES;
+    
+    for(uint32_t i = 0; i < _parameters.size(); ++i){
+        NSString* pPath = [directory stringByAppendingPathComponent:[NSString stringWithFormat:@"nbody-%u.nbss", i]];
+        
+        written = [self runSimulation:i toFile:pPath] && written;
+    }
+    
+    return written;
+}
+
+@end
@@ -0,0 +1,409 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Symplectic integrator for the N-body simulation: kick-drift-kick leapfrog over a power-of-two
+ hierarchy of block timesteps. Every body takes the largest step of the hierarchy its own
+ acceleration allows; all of them drift from one substep where some step ends to the next, and
+ forces are evaluated only for the bodies whose step ends there. With no levels below the
+ timestep it is a plain leapfrog. Energy and momentum diagnostics check the result.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "WorkStealingPool.h"
+
+#include "NBodyIntegrator.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace NBody
+{
+    namespace CPU
+    {
+        // Bodies a task kicks, drifts or sums the forces on
+        static const size_t kBodiesPerTask = 64;
+
+        // Deep enough for a step a million times finer than the timestep
+        static const uint32_t kMaxLevels = 20;
+
+        static void parallelFor(Threads::WorkStealingPool* pPool,
+                                const size_t& count,
+                                const std::function<void(size_t)>& body)
+        {
+            if(pPool && count > 1)
+            {
+                pPool->parallelFor(count, body, 1);
+            }
+            else
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    body(i);
+                }
+            }
+        }
+
+        static inline size_t tasks(const size_t& count)
+        {
+            return (count + kBodiesPerTask - 1) / kBodiesPerTask;
+        }
+    } // CPU
+} // NBody
+
+#pragma mark -
+#pragma mark Public - Diagnostics
+
+NBody::CPU::Diagnostics NBody::CPU::diagnose(const float4* pPosition,
+                                             const float4* pVelocity,
+                                             const size_t& count,
+                                             const float& softeningSqr,
+                                             Threads::WorkStealingPool* pPool)
+{
+    Diagnostics diagnostics = {};
+
+    // Each body's share of the pair potentials, summed in order afterwards so the total
+    // doesn't depend on how the pool split the work
+    std::vector<double> potential(count, 0.0);
+
+    parallelFor(pPool, tasks(count), [&](size_t task)
+    {
+        const size_t last = std::min(count, (task + 1) * kBodiesPerTask);
+
+        for(size_t i = task * kBodiesPerTask; i < last; ++i)
+        {
+            double sum = 0.0;
+
+            for(size_t j = i + 1; j < count; ++j)
+            {
+                const double dx = double(pPosition[j].x) - double(pPosition[i].x);
+                const double dy = double(pPosition[j].y) - double(pPosition[i].y);
+                const double dz = double(pPosition[j].z) - double(pPosition[i].z);
+
+                sum += double(pPosition[j].w) / std::sqrt(dx * dx + dy * dy + dz * dz + double(softeningSqr));
+            }
+
+            potential[i] = -double(pPosition[i].w) * sum;
+        }
+    });
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const double m  = pPosition[i].w;
+        const double x  = pPosition[i].x;
+        const double y  = pPosition[i].y;
+        const double z  = pPosition[i].z;
+        const double vx = pVelocity[i].x;
+        const double vy = pVelocity[i].y;
+        const double vz = pVelocity[i].z;
+
+        diagnostics.kinetic   += 0.5 * m * (vx * vx + vy * vy + vz * vz);
+        diagnostics.potential += potential[i];
+
+        diagnostics.momentum[0] += m * vx;
+        diagnostics.momentum[1] += m * vy;
+        diagnostics.momentum[2] += m * vz;
+
+        diagnostics.angularMomentum[0] += m * (y * vz - z * vy);
+        diagnostics.angularMomentum[1] += m * (z * vx - x * vz);
+        diagnostics.angularMomentum[2] += m * (x * vy - y * vx);
+    }
+
+    diagnostics.energy = diagnostics.kinetic + diagnostics.potential;
+
+    return diagnostics;
+}
+
+#pragma mark -
+#pragma mark Private - Integrator
+
+uint32_t NBody::CPU::Integrator::level(const float4& acceleration) const
+{
+    const float magnitude = std::sqrt(acceleration.x * acceleration.x +
+                                      acceleration.y * acceleration.y +
+                                      acceleration.z * acceleration.z);
+
+    if(!(magnitude > 0.0f))
+    {
+        return 0;
+    }
+
+    const float softening = std::sqrt(m_Prefs.softeningSqr);
+    const float dt        = std::sqrt(2.0f * mnAccuracy * softening / magnitude);
+    const float ratio     = m_Prefs.timestep / dt;
+
+    if(!(ratio > 1.0f))
+    {
+        return 0;
+    }
+
+    // The coarsest level whose step is no longer than the body's own
+    const float level = std::ceil(std::log2(ratio));
+
+    return (level < float(mnLevels)) ? uint32_t(level) : mnLevels;
+}
+
+void NBody::CPU::Integrator::accelerate(const std::vector<uint32_t>& active)
+{
+    // Every source is where the last drift left it, active or not
+    m_Field.assign(m_Position.data(), mnParticles);
+
+    const float softeningSqr = m_Prefs.softeningSqr;
+
+    parallelFor(mpPool, tasks(active.size()), [&](size_t task)
+    {
+        const size_t last = std::min(active.size(), (task + 1) * kBodiesPerTask);
+
+        for(size_t k = task * kBodiesPerTask; k < last; ++k)
+        {
+            const uint32_t i = active[k];
+
+            m_Acceleration[i] = m_Field.acceleration(m_Position[i], softeningSqr);
+        }
+    });
+
+    mnEvaluations += active.size();
+}
+
+void NBody::CPU::Integrator::kick(const std::vector<uint32_t>& active)
+{
+    // Half of each body's own step
+    const float half = 0.5f * m_Prefs.timestep;
+
+    for(const uint32_t& i : active)
+    {
+        const float dt = std::ldexp(half, -int(m_Level[i]));
+
+        m_Velocity[i].x += m_Acceleration[i].x * dt;
+        m_Velocity[i].y += m_Acceleration[i].y * dt;
+        m_Velocity[i].z += m_Acceleration[i].z * dt;
+    }
+}
+
+void NBody::CPU::Integrator::drift(const float& dt)
+{
+    parallelFor(mpPool, tasks(mnParticles), [&](size_t task)
+    {
+        const size_t last = std::min(mnParticles, (task + 1) * kBodiesPerTask);
+
+        for(size_t i = task * kBodiesPerTask; i < last; ++i)
+        {
+            m_Position[i].x += m_Velocity[i].x * dt;
+            m_Position[i].y += m_Velocity[i].y * dt;
+            m_Position[i].z += m_Velocity[i].z * dt;
+        }
+    });
+}
+
+#pragma mark -
+#pragma mark Public - Integrator
+
+NBody::CPU::Integrator::Integrator(const size_t& particles, Threads::WorkStealingPool* pPool)
+: mnParticles(particles),
+  mpPool(pPool),
+  mnLevels(0),
+  mnAccuracy(0.025f),
+  mnTime(0.0),
+  mnEvaluations(0),
+  mbStarted(false),
+  m_Position(particles, float4{0.0f, 0.0f, 0.0f, 1.0f}),
+  m_Velocity(particles, float4{0.0f, 0.0f, 0.0f, 1.0f}),
+  m_Acceleration(particles, float4{0.0f, 0.0f, 0.0f, 0.0f}),
+  m_Level(particles, 0)
+{
+    m_Prefs.timestep     = 0.0f;
+    m_Prefs.damping      = 0.0f;
+    m_Prefs.softeningSqr = 1.0f;
+    m_Prefs.particles    = (unsigned int)particles;
+
+    m_Active.reserve(particles);
+} // Constructor
+
+NBody::CPU::Integrator::~Integrator()
+{
+} // Destructor
+
+size_t NBody::CPU::Integrator::particles() const
+{
+    return mnParticles;
+}
+
+void NBody::CPU::Integrator::setPrefs(const Compute::Prefs& prefs)
+{
+    m_Prefs = prefs;
+
+    m_Prefs.damping   = 0.0f;
+    m_Prefs.particles = (unsigned int)mnParticles;
+
+    mbStarted = false;
+}
+
+const NBody::Compute::Prefs& NBody::CPU::Integrator::prefs() const
+{
+    return m_Prefs;
+}
+
+void NBody::CPU::Integrator::setLevels(const uint32_t& levels)
+{
+    mnLevels = std::min(levels, kMaxLevels);
+
+    mbStarted = false;
+}
+
+uint32_t NBody::CPU::Integrator::levels() const
+{
+    return mnLevels;
+}
+
+void NBody::CPU::Integrator::setAccuracy(const float& accuracy)
+{
+    mnAccuracy = accuracy;
+
+    mbStarted = false;
+}
+
+float NBody::CPU::Integrator::accuracy() const
+{
+    return mnAccuracy;
+}
+
+NBody::CPU::float4* NBody::CPU::Integrator::position()
+{
+    return m_Position.data();
+}
+
+const NBody::CPU::float4* NBody::CPU::Integrator::position() const
+{
+    return m_Position.data();
+}
+
+NBody::CPU::float4* NBody::CPU::Integrator::velocity()
+{
+    return m_Velocity.data();
+}
+
+const NBody::CPU::float4* NBody::CPU::Integrator::velocity() const
+{
+    return m_Velocity.data();
+}
+
+void NBody::CPU::Integrator::reset()
+{
+    mbStarted = false;
+}
+
+double NBody::CPU::Integrator::time() const
+{
+    return mnTime;
+}
+
+void NBody::CPU::Integrator::setTime(const double& time)
+{
+    mnTime = time;
+}
+
+void NBody::CPU::Integrator::step()
+{
+    if(!mnParticles)
+    {
+        return;
+    }
+
+    const uint32_t substeps = 1u << mnLevels;
+    const float    dt       = std::ldexp(m_Prefs.timestep, -int(mnLevels));
+
+    m_Active.resize(mnParticles);
+
+    for(size_t i = 0; i < mnParticles; ++i)
+    {
+        m_Active[i] = uint32_t(i);
+    }
+
+    if(!mbStarted)
+    {
+        accelerate(m_Active);
+
+        for(size_t i = 0; i < mnParticles; ++i)
+        {
+            m_Level[i] = level(m_Acceleration[i]);
+        }
+
+        mbStarted = true;
+    }
+
+    uint32_t finest = *std::max_element(m_Level.begin(), m_Level.end());
+
+    // Every body starts its step here
+    kick(m_Active);
+
+    for(uint32_t tick = 0; tick < substeps;)
+    {
+        // Straight on to the next substep where some step ends; on the last one all of them do
+        const uint32_t stride = substeps >> finest;
+        const uint32_t next   = (tick / stride + 1) * stride;
+
+        drift(dt * float(next - tick));
+
+        tick = next;
+
+        m_Active.clear();
+
+        for(size_t i = 0; i < mnParticles; ++i)
+        {
+            if((tick & ((substeps >> m_Level[i]) - 1)) == 0)
+            {
+                m_Active.push_back(uint32_t(i));
+            }
+        }
+
+        accelerate(m_Active);
+        kick(m_Active);
+
+        for(const uint32_t& i : m_Active)
+        {
+            uint32_t level = this->level(m_Acceleration[i]);
+
+            // A coarser step has to start where that level's steps do
+            while(level < m_Level[i] && (tick & ((substeps >> level) - 1)) != 0)
+            {
+                ++level;
+            }
+
+            m_Level[i] = level;
+        }
+
+        if(tick < substeps)
+        {
+            kick(m_Active);
+        }
+
+        finest = *std::max_element(m_Level.begin(), m_Level.end());
+    }
+
+    mnTime += m_Prefs.timestep;
+}
+
+uint64_t NBody::CPU::Integrator::evaluations() const
+{
+    return mnEvaluations;
+}
+
+std::vector<size_t> NBody::CPU::Integrator::census() const
+{
+    std::vector<size_t> census(mnLevels + 1, 0);
+
+    for(size_t i = 0; i < mnParticles; ++i)
+    {
+        census[m_Level[i]]++;
+    }
+
+    return census;
+}
+
+NBody::CPU::Diagnostics NBody::CPU::Integrator::diagnostics() const
+{
+    return diagnose(m_Position.data(), m_Velocity.data(), mnParticles, m_Prefs.softeningSqr, mpPool);
+}
@@ -0,0 +1,143 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Symplectic integrator for the N-body simulation: kick-drift-kick leapfrog over a power-of-two
+ hierarchy of block timesteps. Every body takes the largest step of the hierarchy its own
+ acceleration allows; all of them drift from one substep where some step ends to the next, and
+ forces are evaluated only for the bodies whose step ends there. With no levels below the
+ timestep it is a plain leapfrog. Energy and momentum diagnostics check the result.
+ */
+
+#ifndef _NBODY_INTEGRATOR_H_
+#define _NBODY_INTEGRATOR_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "NBodyComputePrefs.h"
+#include "NBodySimulator.h"
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace NBody
+{
+    namespace CPU
+    {
+        namespace Integrators
+        {
+            enum : uint32_t
+            {
+                eEuler = 0,     // Simulator, the kernel's semi-implicit Euler step
+                eLeapfrog,      // Integrator with no levels below the timestep
+                eBlock,         // Integrator with block timesteps
+                eCount
+            };
+        } // Integrators
+
+        // Totals in the kernel's units, where G is one and w holds the mass
+        struct Diagnostics
+        {
+            double kinetic;
+            double potential;           // Of the softened force the kernel applies
+            double energy;
+            double momentum[3];
+            double angularMomentum[3];
+        };
+
+        Diagnostics diagnose(const float4* pPosition,
+                             const float4* pVelocity,
+                             const size_t& count,
+                             const float& softeningSqr,
+                             Threads::WorkStealingPool* pPool = nullptr);
+
+        class Integrator
+        {
+        public:
+            // Bodies are split across the pool when there is one
+            Integrator(const size_t& particles, Threads::WorkStealingPool* pPool = nullptr);
+
+            virtual ~Integrator();
+
+            Integrator(const Integrator&) = delete;
+            Integrator& operator=(const Integrator&) = delete;
+
+            size_t particles() const;
+
+            // Prefs' timestep is the largest step of the hierarchy. Damping isn't a force and
+            // has no place in a symplectic scheme, so it is ignored, as is the particle count.
+            void setPrefs(const Compute::Prefs& prefs);
+
+            const Compute::Prefs& prefs() const;
+
+            // Levels below the timestep; a body on level l steps timestep / 2^l
+            void setLevels(const uint32_t& levels);
+
+            uint32_t levels() const;
+
+            // A body's step is sqrt(2 * accuracy * softening / |a|), rounded down to a level
+            void setAccuracy(const float& accuracy);
+
+            float accuracy() const;
+
+            // Positions and velocities, synchronised at the end of a step
+            float4*       position();
+            const float4* position() const;
+            float4*       velocity();
+            const float4* velocity() const;
+
+            // Restart the hierarchy, after changing positions or velocities between steps
+            void reset();
+
+            double time() const;
+
+            void setTime(const double& time);
+
+            // Advance by the prefs' timestep
+            void step();
+
+            // Bodies whose force was summed over every source, so far
+            uint64_t evaluations() const;
+
+            // Bodies on each level after the last step
+            std::vector<size_t> census() const;
+
+            Diagnostics diagnostics() const;
+
+        private:
+            uint32_t level(const float4& acceleration) const;
+
+            void accelerate(const std::vector<uint32_t>& active);
+            void kick(const std::vector<uint32_t>& active);
+            void drift(const float& dt);
+
+        private:
+            size_t                      mnParticles;
+            Threads::WorkStealingPool*  mpPool;
+            Compute::Prefs              m_Prefs;
+            uint32_t                    mnLevels;
+            float                       mnAccuracy;
+            double                      mnTime;
+            uint64_t                    mnEvaluations;
+            bool                        mbStarted;      // Accelerations and levels are current
+
+            std::vector<float4>         m_Position;
+            std::vector<float4>         m_Velocity;
+            std::vector<float4>         m_Acceleration;
+            std::vector<uint32_t>       m_Level;
+            std::vector<uint32_t>       m_Active;
+
+            Field                       m_Field;
+        }; // Class Integrator
+    } // CPU
+} // NBody
+
+#endif
+
+#endif
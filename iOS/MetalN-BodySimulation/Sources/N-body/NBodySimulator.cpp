@@ -0,0 +1,304 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU backend for the N-body simulation. It advances the same float4 position and velocity
+ arrays, with the same NBody::Compute::Prefs, as the NBodyIntegrateSystem kernel: every body
+ attracts every other through a softened inverse square law, then velocities and positions take
+ a semi-implicit Euler step. Forces are summed four sources at a time with SIMD, and targets
+ are split across a thread pool.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "WorkStealingPool.h"
+
+#include "NBodySimulator.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace NBody
+{
+    namespace CPU
+    {
+        // Bodies a task integrates
+        static const size_t kBodiesPerTask = 64;
+
+        static void parallelFor(Threads::WorkStealingPool* pPool,
+                                const size_t& count,
+                                const std::function<void(size_t)>& body)
+        {
+            if(pPool && count > 1)
+            {
+                pPool->parallelFor(count, body, 1);
+            }
+            else
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    body(i);
+                }
+            }
+        }
+    } // CPU
+} // NBody
+
+#pragma mark -
+#pragma mark Public - Field
+
+NBody::CPU::Field::Field()
+: mnCount(0)
+{
+} // Constructor
+
+NBody::CPU::Field::~Field()
+{
+} // Destructor
+
+void NBody::CPU::Field::assign(const float4* pPosition, const size_t& count)
+{
+    const size_t padded = (count + 3) & ~size_t(3);
+
+    mnCount = count;
+
+    m_X.assign(padded, 0.0f);
+    m_Y.assign(padded, 0.0f);
+    m_Z.assign(padded, 0.0f);
+    m_Mass.assign(padded, 0.0f);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        m_X[i]    = pPosition[i].x;
+        m_Y[i]    = pPosition[i].y;
+        m_Z[i]    = pPosition[i].z;
+        m_Mass[i] = pPosition[i].w;
+    }
+}
+
+size_t NBody::CPU::Field::count() const
+{
+    return mnCount;
+}
+
+NBody::CPU::float4 NBody::CPU::Field::acceleration(const float4& position, const float& softeningSqr) const
+{
+    const size_t padded = m_X.size();
+
+    float4 acceleration = {0.0f, 0.0f, 0.0f, 0.0f};
+
+#if defined(__SSE2__)
+    const __m128 px    = _mm_set1_ps(position.x);
+    const __m128 py    = _mm_set1_ps(position.y);
+    const __m128 pz    = _mm_set1_ps(position.z);
+    const __m128 eps   = _mm_set1_ps(softeningSqr);
+    const __m128 half  = _mm_set1_ps(0.5f);
+    const __m128 three = _mm_set1_ps(3.0f);
+
+    __m128 ax = _mm_setzero_ps();
+    __m128 ay = _mm_setzero_ps();
+    __m128 az = _mm_setzero_ps();
+
+    for(size_t j = 0; j < padded; j += 4)
+    {
+        const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_X[j]), px);
+        const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_Y[j]), py);
+        const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&m_Z[j]), pz);
+
+        const __m128 distSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                          _mm_add_ps(_mm_mul_ps(dz, dz), eps));
+
+        // Estimate refined by a Newton step, close to the kernel's rsqrt
+        __m128 invDist = _mm_rsqrt_ps(distSqr);
+
+        invDist = _mm_mul_ps(_mm_mul_ps(half, invDist),
+                             _mm_sub_ps(three, _mm_mul_ps(distSqr, _mm_mul_ps(invDist, invDist))));
+
+        const __m128 s = _mm_mul_ps(_mm_loadu_ps(&m_Mass[j]), _mm_mul_ps(invDist, _mm_mul_ps(invDist, invDist)));
+
+        ax = _mm_add_ps(ax, _mm_mul_ps(dx, s));
+        ay = _mm_add_ps(ay, _mm_mul_ps(dy, s));
+        az = _mm_add_ps(az, _mm_mul_ps(dz, s));
+    }
+
+    float sums[3][4];
+
+    _mm_storeu_ps(sums[0], ax);
+    _mm_storeu_ps(sums[1], ay);
+    _mm_storeu_ps(sums[2], az);
+
+    acceleration.x = (sums[0][0] + sums[0][1]) + (sums[0][2] + sums[0][3]);
+    acceleration.y = (sums[1][0] + sums[1][1]) + (sums[1][2] + sums[1][3]);
+    acceleration.z = (sums[2][0] + sums[2][1]) + (sums[2][2] + sums[2][3]);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const float32x4_t px  = vdupq_n_f32(position.x);
+    const float32x4_t py  = vdupq_n_f32(position.y);
+    const float32x4_t pz  = vdupq_n_f32(position.z);
+    const float32x4_t eps = vdupq_n_f32(softeningSqr);
+
+    float32x4_t ax = vdupq_n_f32(0.0f);
+    float32x4_t ay = vdupq_n_f32(0.0f);
+    float32x4_t az = vdupq_n_f32(0.0f);
+
+    for(size_t j = 0; j < padded; j += 4)
+    {
+        const float32x4_t dx = vsubq_f32(vld1q_f32(&m_X[j]), px);
+        const float32x4_t dy = vsubq_f32(vld1q_f32(&m_Y[j]), py);
+        const float32x4_t dz = vsubq_f32(vld1q_f32(&m_Z[j]), pz);
+
+        const float32x4_t distSqr = vaddq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz), eps);
+
+        // Estimate refined by two Newton steps
+        float32x4_t invDist = vrsqrteq_f32(distSqr);
+
+        invDist = vmulq_f32(invDist, vrsqrtsq_f32(vmulq_f32(distSqr, invDist), invDist));
+        invDist = vmulq_f32(invDist, vrsqrtsq_f32(vmulq_f32(distSqr, invDist), invDist));
+
+        const float32x4_t s = vmulq_f32(vld1q_f32(&m_Mass[j]), vmulq_f32(invDist, vmulq_f32(invDist, invDist)));
+
+        ax = vmlaq_f32(ax, dx, s);
+        ay = vmlaq_f32(ay, dy, s);
+        az = vmlaq_f32(az, dz, s);
+    }
+
+    float sums[3][4];
+
+    vst1q_f32(sums[0], ax);
+    vst1q_f32(sums[1], ay);
+    vst1q_f32(sums[2], az);
+
+    acceleration.x = (sums[0][0] + sums[0][1]) + (sums[0][2] + sums[0][3]);
+    acceleration.y = (sums[1][0] + sums[1][1]) + (sums[1][2] + sums[1][3]);
+    acceleration.z = (sums[2][0] + sums[2][1]) + (sums[2][2] + sums[2][3]);
+#else
+    for(size_t j = 0; j < padded; ++j)
+    {
+        const float dx = m_X[j] - position.x;
+        const float dy = m_Y[j] - position.y;
+        const float dz = m_Z[j] - position.z;
+
+        const float invDist = 1.0f / std::sqrt(dx * dx + dy * dy + dz * dz + softeningSqr);
+        const float s       = m_Mass[j] * invDist * invDist * invDist;
+
+        acceleration.x += dx * s;
+        acceleration.y += dy * s;
+        acceleration.z += dz * s;
+    }
+#endif
+
+    return acceleration;
+}
+
+#pragma mark -
+#pragma mark Public - Simulator
+
+NBody::CPU::Simulator::Simulator(const size_t& particles, Threads::WorkStealingPool* pPool)
+: mnParticles(particles),
+  mpPool(pPool),
+  mnTime(0.0),
+  m_Position(particles, float4{0.0f, 0.0f, 0.0f, 1.0f}),
+  m_Velocity(particles, float4{0.0f, 0.0f, 0.0f, 1.0f})
+{
+    m_Prefs.timestep     = 0.0f;
+    m_Prefs.damping      = 0.0f;
+    m_Prefs.softeningSqr = 1.0f;
+    m_Prefs.particles    = (unsigned int)particles;
+} // Constructor
+
+NBody::CPU::Simulator::~Simulator()
+{
+} // Destructor
+
+size_t NBody::CPU::Simulator::particles() const
+{
+    return mnParticles;
+}
+
+void NBody::CPU::Simulator::setPrefs(const Compute::Prefs& prefs)
+{
+    m_Prefs = prefs;
+
+    m_Prefs.particles = (unsigned int)mnParticles;
+}
+
+const NBody::Compute::Prefs& NBody::CPU::Simulator::prefs() const
+{
+    return m_Prefs;
+}
+
+NBody::CPU::float4* NBody::CPU::Simulator::position()
+{
+    return m_Position.data();
+}
+
+const NBody::CPU::float4* NBody::CPU::Simulator::position() const
+{
+    return m_Position.data();
+}
+
+NBody::CPU::float4* NBody::CPU::Simulator::velocity()
+{
+    return m_Velocity.data();
+}
+
+const NBody::CPU::float4* NBody::CPU::Simulator::velocity() const
+{
+    return m_Velocity.data();
+}
+
+double NBody::CPU::Simulator::time() const
+{
+    return mnTime;
+}
+
+void NBody::CPU::Simulator::setTime(const double& time)
+{
+    mnTime = time;
+}
+
+void NBody::CPU::Simulator::step()
+{
+    // Every body reads the positions of the previous step, as the kernel's separate buffers do
+    m_Field.assign(m_Position.data(), mnParticles);
+
+    const float timestep     = m_Prefs.timestep;
+    const float damping      = m_Prefs.damping;
+    const float softeningSqr = m_Prefs.softeningSqr;
+
+    const size_t tasks = (mnParticles + kBodiesPerTask - 1) / kBodiesPerTask;
+
+    parallelFor(mpPool, tasks, [&](size_t task)
+    {
+        const size_t last = std::min(mnParticles, (task + 1) * kBodiesPerTask);
+
+        for(size_t i = task * kBodiesPerTask; i < last; ++i)
+        {
+            const float4 acceleration = m_Field.acceleration(m_Position[i], softeningSqr);
+
+            float4& rVelocity = m_Velocity[i];
+            float4& rPosition = m_Position[i];
+
+            rVelocity.x += acceleration.x * timestep;
+            rVelocity.y += acceleration.y * timestep;
+            rVelocity.z += acceleration.z * timestep;
+
+            rVelocity.x += rVelocity.x * damping * timestep;
+            rVelocity.y += rVelocity.y * damping * timestep;
+            rVelocity.z += rVelocity.z * damping * timestep;
+
+            rPosition.x += rVelocity.x * timestep;
+            rPosition.y += rVelocity.y * timestep;
+            rPosition.z += rVelocity.z * timestep;
+        }
+    });
+
+    mnTime += timestep;
+}
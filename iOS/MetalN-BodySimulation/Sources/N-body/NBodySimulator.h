@@ -0,0 +1,111 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ CPU backend for the N-body simulation. It advances the same float4 position and velocity
+ arrays, with the same NBody::Compute::Prefs, as the NBodyIntegrateSystem kernel: every body
+ attracts every other through a softened inverse square law, then velocities and positions take
+ a semi-implicit Euler step. Forces are summed four sources at a time with SIMD, and targets
+ are split across a thread pool.
+ */
+
+#ifndef _NBODY_SIMULATOR_H_
+#define _NBODY_SIMULATOR_H_
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "NBodyComputePrefs.h"
+
+namespace Threads
+{
+    class WorkStealingPool;
+} // Threads
+
+namespace NBody
+{
+    namespace CPU
+    {
+        // Layout of simd::float4 and the kernel's float4; w is the mass of a position
+        struct alignas(16) float4
+        {
+            float x;
+            float y;
+            float z;
+            float w;
+        };
+
+        // Source positions as structure of arrays, padded to whole SIMD blocks with massless bodies
+        class Field
+        {
+        public:
+            Field();
+
+            virtual ~Field();
+
+            void assign(const float4* pPosition, const size_t& count);
+
+            size_t count() const;
+
+            // Sum of the pulls of every source on a body at position; w is left zero
+            float4 acceleration(const float4& position, const float& softeningSqr) const;
+
+        private:
+            size_t              mnCount;
+            std::vector<float>  m_X;
+            std::vector<float>  m_Y;
+            std::vector<float>  m_Z;
+            std::vector<float>  m_Mass;
+        }; // Class Field
+
+        class Simulator
+        {
+        public:
+            // Bodies are split across the pool when there is one
+            Simulator(const size_t& particles, Threads::WorkStealingPool* pPool = nullptr);
+
+            virtual ~Simulator();
+
+            Simulator(const Simulator&) = delete;
+            Simulator& operator=(const Simulator&) = delete;
+
+            size_t particles() const;
+
+            // Prefs' particle count is ignored; the simulator's own is used
+            void setPrefs(const Compute::Prefs& prefs);
+
+            const Compute::Prefs& prefs() const;
+
+            float4*       position();
+            const float4* position() const;
+            float4*       velocity();
+            const float4* velocity() const;
+
+            // Seconds simulated so far
+            double time() const;
+
+            void setTime(const double& time);
+
+            // One dispatch of NBodyIntegrateSystem
+            void step();
+
+        private:
+            size_t                      mnParticles;
+            Threads::WorkStealingPool*  mpPool;
+            Compute::Prefs              m_Prefs;
+            double                      mnTime;
+
+            std::vector<float4>         m_Position;
+            std::vector<float4>         m_Velocity;
+
+            Field                       m_Field;
+        }; // Class Simulator
+    } // CPU
+} // NBody
+
+#endif
+
+#endif
@@ -0,0 +1,736 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Streaming snapshot files for N-body trajectories. Positions are quantised to a fixed step and
+ written one chunk per frame: key frames hold the quantised values, the frames between hold the
+ residual from a prediction made of the frames before, both as zigzag varints per axis. An index
+ of chunk offsets closes the file, so any frame is read by decoding from the key frame at or
+ before it. The writer encodes and writes on its own thread from two staging buffers, so a
+ simulation handing it frames only waits when it gets a whole frame ahead of the disk.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "NBodySnapshot.h"
+
+#pragma mark -
+#pragma mark Private - Utilities
+
+namespace NBody
+{
+    namespace Snapshot
+    {
+        static const uint32_t kHeaderTag = 0x5353424E;  // "NBSS"
+        static const uint32_t kChunkTag  = 0x4D415246;  // "FRAM"
+        static const uint32_t kIndexTag  = 0x58444E49;  // "INDX"
+
+        static const uint32_t kKeyFrame = 1;
+        static const uint32_t kLinear   = 2;
+
+        static const size_t kHeaderSize = 40;
+        static const size_t kChunkSize  = 20;
+        static const size_t kEntrySize  = 12;
+
+        // Quantised values stay well inside what a double represents exactly
+        static const double kLimit = 4503599627370496.0;
+
+        static void put(std::vector<uint8_t>& rBytes, const uint32_t& value)
+        {
+            for(size_t i = 0; i < 4; ++i)
+            {
+                rBytes.push_back(uint8_t(value >> (8 * i)));
+            }
+        }
+
+        static void put(std::vector<uint8_t>& rBytes, const uint64_t& value)
+        {
+            for(size_t i = 0; i < 8; ++i)
+            {
+                rBytes.push_back(uint8_t(value >> (8 * i)));
+            }
+        }
+
+        static void put(std::vector<uint8_t>& rBytes, const float& value)
+        {
+            uint32_t bits;
+
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            put(rBytes, bits);
+        }
+
+        static uint32_t getU32(const uint8_t* pBytes)
+        {
+            uint32_t value = 0;
+
+            for(size_t i = 0; i < 4; ++i)
+            {
+                value |= uint32_t(pBytes[i]) << (8 * i);
+            }
+
+            return value;
+        }
+
+        static uint64_t getU64(const uint8_t* pBytes)
+        {
+            uint64_t value = 0;
+
+            for(size_t i = 0; i < 8; ++i)
+            {
+                value |= uint64_t(pBytes[i]) << (8 * i);
+            }
+
+            return value;
+        }
+
+        static float getF32(const uint8_t* pBytes)
+        {
+            const uint32_t bits = getU32(pBytes);
+
+            float value;
+
+            std::memcpy(&value, &bits, sizeof(value));
+
+            return value;
+        }
+
+        static std::vector<uint8_t> serialize(const Header& header)
+        {
+            std::vector<uint8_t> bytes;
+
+            bytes.reserve(kHeaderSize);
+
+            put(bytes, kHeaderTag);
+            put(bytes, kVersion);
+            put(bytes, header.particles);
+            put(bytes, header.frames);
+            put(bytes, header.keyFrameInterval);
+            put(bytes, header.step);
+            put(bytes, header.timestep);
+            put(bytes, header.config);
+            put(bytes, header.indexOffset);
+
+            return bytes;
+        }
+
+        static inline int64_t quantise(const float& value, const double& scale)
+        {
+            double q = double(value) * scale;
+
+            // NaN goes to the origin, infinities to the limit
+            if(!(q == q))
+            {
+                q = 0.0;
+            }
+
+            return int64_t(std::llround(std::min(std::max(q, -kLimit), kLimit)));
+        }
+
+        static inline void putVarint(std::vector<uint8_t>& rBytes, const int64_t& value)
+        {
+            // Zigzag, so small differences of either sign take few bytes
+            uint64_t bits = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+
+            while(bits >= 0x80)
+            {
+                rBytes.push_back(uint8_t(bits) | 0x80);
+
+                bits >>= 7;
+            }
+
+            rBytes.push_back(uint8_t(bits));
+        }
+
+        static inline bool getVarint(const uint8_t*& rpBytes, const uint8_t* pEnd, int64_t& rValue)
+        {
+            uint64_t bits  = 0;
+            uint32_t shift = 0;
+
+            while(rpBytes < pEnd && shift < 64)
+            {
+                const uint8_t byte = *rpBytes++;
+
+                bits |= uint64_t(byte & 0x7F) << shift;
+
+                if(!(byte & 0x80))
+                {
+                    rValue = int64_t(bits >> 1) ^ -int64_t(bits & 1);
+
+                    return true;
+                }
+
+                shift += 7;
+            }
+
+            return false;
+        }
+
+        // The frame before, or with the one before that too, their linear extrapolation: bodies
+        // coast between snapshots, so what's left is mostly the change in velocity
+        static void predict(const std::vector<int64_t>& previous,
+                            const std::vector<int64_t>* pBefore,
+                            std::vector<int64_t>& rPrediction)
+        {
+            rPrediction.resize(previous.size());
+
+            if(pBefore)
+            {
+                for(size_t i = 0; i < previous.size(); ++i)
+                {
+                    rPrediction[i] = 2 * previous[i] - (*pBefore)[i];
+                }
+            }
+            else
+            {
+                std::copy(previous.begin(), previous.end(), rPrediction.begin());
+            }
+        }
+
+        static double seconds()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    } // Snapshot
+} // NBody
+
+#pragma mark -
+#pragma mark Public - Coding
+
+void NBody::Snapshot::encode(const CPU::float4* pPositions,
+                             const size_t& count,
+                             const float& step,
+                             const std::vector<int64_t>* pPrediction,
+                             std::vector<int64_t>& rQuantised,
+                             std::vector<uint8_t>& rPayload)
+{
+    const double scale = 1.0 / double(step);
+
+    rQuantised.resize(3 * count);
+    rPayload.clear();
+
+    // One axis after another, so neighbouring varints tend to share a length
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+        const float* pValues = &pPositions[0].x + axis;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            const int64_t q = quantise(pValues[4 * i], scale);
+
+            rQuantised[3 * i + axis] = q;
+
+            putVarint(rPayload, pPrediction ? (q - (*pPrediction)[3 * i + axis]) : q);
+        }
+    }
+}
+
+bool NBody::Snapshot::decode(const uint8_t* pPayload,
+                             const size_t& bytes,
+                             const size_t& count,
+                             const std::vector<int64_t>* pPrediction,
+                             std::vector<int64_t>& rQuantised)
+{
+    if(pPrediction && pPrediction->size() != 3 * count)
+    {
+        return false;
+    }
+
+    rQuantised.resize(3 * count);
+
+    const uint8_t* pBytes = pPayload;
+    const uint8_t* pEnd   = pPayload + bytes;
+
+    for(size_t axis = 0; axis < 3; ++axis)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            int64_t value;
+
+            if(!getVarint(pBytes, pEnd, value))
+            {
+                return false;
+            }
+
+            rQuantised[3 * i + axis] = pPrediction ? ((*pPrediction)[3 * i + axis] + value) : value;
+        }
+    }
+
+    return pBytes == pEnd;
+}
+
+#pragma mark -
+#pragma mark Private - Writer
+
+void NBody::Snapshot::Writer::run()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    for(;;)
+    {
+        m_Condition.wait(lock, [this]() { return m_Staging[mnDrain].full || mbClosing; });
+
+        if(!m_Staging[mnDrain].full)
+        {
+            break;
+        }
+
+        Staging& rStaging = m_Staging[mnDrain];
+
+        // append() leaves a full buffer alone, so it's written without holding the lock
+        lock.unlock();
+
+        const bool written = !mbFailed && write(rStaging);
+
+        lock.lock();
+
+        mbFailed = mbFailed || !written;
+
+        rStaging.full = false;
+
+        mnDrain = 1 - mnDrain;
+        mnWritten = mnOffset;
+
+        m_Condition.notify_all();
+    }
+}
+
+bool NBody::Snapshot::Writer::write(const Staging& rStaging)
+{
+    const uint32_t since = rStaging.frame % m_Header.keyFrameInterval;
+    const uint32_t flags = (since == 0) ? kKeyFrame : ((since == 1) ? 0 : kLinear);
+
+    if(since)
+    {
+        predict(m_Previous, (since > 1) ? &m_Before : nullptr, m_Prediction);
+    }
+
+    encode(rStaging.positions.data(),
+           rStaging.positions.size(),
+           m_Header.step,
+           since ? &m_Prediction : nullptr,
+           m_Quantised,
+           m_Payload);
+
+    m_Chunk.clear();
+
+    put(m_Chunk, kChunkTag);
+    put(m_Chunk, rStaging.frame);
+    put(m_Chunk, rStaging.time);
+    put(m_Chunk, flags);
+    put(m_Chunk, uint32_t(m_Payload.size()));
+
+    const bool written = (std::fwrite(m_Chunk.data(), 1, m_Chunk.size(), mpFile) == m_Chunk.size()) &&
+                         (std::fwrite(m_Payload.data(), 1, m_Payload.size(), mpFile) == m_Payload.size());
+
+    m_Index.push_back({mnOffset, rStaging.time});
+
+    mnOffset += m_Chunk.size() + m_Payload.size();
+
+    m_Before.swap(m_Previous);
+    m_Previous.swap(m_Quantised);
+
+    return written;
+}
+
+#pragma mark -
+#pragma mark Public - Writer
+
+NBody::Snapshot::Writer::Writer()
+: mpFile(nullptr),
+  mnFill(0),
+  mnDrain(0),
+  mnFrames(0),
+  mbClosing(false),
+  mbFailed(false),
+  mnStalled(0.0),
+  mnWritten(0),
+  mnOffset(0)
+{
+    std::memset(&m_Header, 0, sizeof(m_Header));
+} // Constructor
+
+NBody::Snapshot::Writer::~Writer()
+{
+    close();
+} // Destructor
+
+bool NBody::Snapshot::Writer::open(const std::string& path, const Header& header)
+{
+    if(mpFile || !header.particles || !(header.step > 0.0f))
+    {
+        return false;
+    }
+
+    mpFile = std::fopen(path.c_str(), "wb");
+
+    if(!mpFile)
+    {
+        return false;
+    }
+
+    m_Header = header;
+
+    m_Header.frames           = 0;
+    m_Header.indexOffset      = 0;
+    m_Header.keyFrameInterval = std::max(header.keyFrameInterval, 1u);
+
+    // Rewritten with the frame count and index offset on close
+    const std::vector<uint8_t> bytes = serialize(m_Header);
+
+    if(std::fwrite(bytes.data(), 1, bytes.size(), mpFile) != bytes.size())
+    {
+        std::fclose(mpFile);
+
+        mpFile = nullptr;
+
+        return false;
+    }
+
+    for(Staging& rStaging : m_Staging)
+    {
+        rStaging.positions.resize(header.particles);
+        rStaging.frame = 0;
+        rStaging.time  = 0.0f;
+        rStaging.full  = false;
+    }
+
+    mnFill    = 0;
+    mnDrain   = 0;
+    mnFrames  = 0;
+    mbClosing = false;
+    mbFailed  = false;
+    mnStalled = 0.0;
+    mnOffset  = kHeaderSize;
+    mnWritten = kHeaderSize;
+
+    m_Before.clear();
+    m_Previous.clear();
+    m_Index.clear();
+
+    m_Thread = std::thread(&Writer::run, this);
+
+    return true;
+}
+
+bool NBody::Snapshot::Writer::append(const CPU::float4* pPositions, const float& time)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if(!mpFile || mbClosing)
+    {
+        return false;
+    }
+
+    Staging& rStaging = m_Staging[mnFill];
+
+    if(rStaging.full)
+    {
+        const double start = seconds();
+
+        m_Condition.wait(lock, [&rStaging, this]() { return !rStaging.full || mbFailed; });
+
+        mnStalled += seconds() - start;
+    }
+
+    if(mbFailed)
+    {
+        return false;
+    }
+
+    // The writer thread leaves an empty buffer alone
+    lock.unlock();
+
+    std::copy(pPositions, pPositions + rStaging.positions.size(), rStaging.positions.begin());
+
+    lock.lock();
+
+    rStaging.frame = mnFrames++;
+    rStaging.time  = time;
+    rStaging.full  = true;
+
+    mnFill = 1 - mnFill;
+
+    m_Condition.notify_all();
+
+    return true;
+}
+
+bool NBody::Snapshot::Writer::close()
+{
+    if(!mpFile)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        mbClosing = true;
+
+        m_Condition.notify_all();
+    }
+
+    m_Thread.join();
+
+    bool written = !mbFailed;
+
+    if(written)
+    {
+        std::vector<uint8_t> bytes;
+
+        bytes.reserve(8 + m_Index.size() * kEntrySize);
+
+        put(bytes, kIndexTag);
+        put(bytes, uint32_t(m_Index.size()));
+
+        for(const Entry& rEntry : m_Index)
+        {
+            put(bytes, rEntry.offset);
+            put(bytes, rEntry.time);
+        }
+
+        m_Header.frames      = uint32_t(m_Index.size());
+        m_Header.indexOffset = mnOffset;
+
+        const std::vector<uint8_t> header = serialize(m_Header);
+
+        written = (std::fwrite(bytes.data(), 1, bytes.size(), mpFile) == bytes.size()) &&
+                  (std::fseek(mpFile, 0, SEEK_SET) == 0) &&
+                  (std::fwrite(header.data(), 1, header.size(), mpFile) == header.size());
+
+        mnOffset += bytes.size();
+    }
+
+    written = (std::fclose(mpFile) == 0) && written;
+
+    mpFile = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    mnWritten = mnOffset;
+    mbFailed  = !written;
+
+    return written;
+}
+
+uint32_t NBody::Snapshot::Writer::frames() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return mnFrames;
+}
+
+uint64_t NBody::Snapshot::Writer::bytes() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return mnWritten;
+}
+
+double NBody::Snapshot::Writer::stalled() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return mnStalled;
+}
+
+#pragma mark -
+#pragma mark Private - Reader
+
+bool NBody::Snapshot::Reader::chunk(const uint32_t& frame, bool& rKey)
+{
+    uint8_t bytes[kChunkSize];
+
+    if(std::fseek(mpFile, long(m_Offsets[frame]), SEEK_SET) != 0 ||
+       std::fread(bytes, 1, kChunkSize, mpFile) != kChunkSize ||
+       getU32(bytes) != kChunkTag ||
+       getU32(bytes + 4) != frame)
+    {
+        return false;
+    }
+
+    const uint32_t flags = getU32(bytes + 12);
+
+    rKey = (flags & kKeyFrame) != 0;
+
+    m_Payload.resize(getU32(bytes + 16));
+
+    if(std::fread(m_Payload.data(), 1, m_Payload.size(), mpFile) != m_Payload.size())
+    {
+        return false;
+    }
+
+    if(!rKey)
+    {
+        const bool linear = (flags & kLinear) != 0;
+
+        if(m_Quantised.empty() || (linear && m_Before.size() != m_Quantised.size()))
+        {
+            return false;
+        }
+
+        predict(m_Quantised, linear ? &m_Before : nullptr, m_Prediction);
+    }
+
+    if(!decode(m_Payload.data(), m_Payload.size(), m_Header.particles, rKey ? nullptr : &m_Prediction, m_Decoded))
+    {
+        return false;
+    }
+
+    m_Before.swap(m_Quantised);
+    m_Quantised.swap(m_Decoded);
+
+    return true;
+}
+
+#pragma mark -
+#pragma mark Public - Reader
+
+NBody::Snapshot::Reader::Reader()
+: mpFile(nullptr),
+  mnCurrent(-1)
+{
+    std::memset(&m_Header, 0, sizeof(m_Header));
+} // Constructor
+
+NBody::Snapshot::Reader::~Reader()
+{
+    close();
+} // Destructor
+
+bool NBody::Snapshot::Reader::open(const std::string& path)
+{
+    close();
+
+    mpFile = std::fopen(path.c_str(), "rb");
+
+    if(!mpFile)
+    {
+        return false;
+    }
+
+    uint8_t bytes[kHeaderSize];
+
+    bool valid = (std::fread(bytes, 1, kHeaderSize, mpFile) == kHeaderSize) &&
+                 (getU32(bytes) == kHeaderTag) &&
+                 (getU32(bytes + 4) == kVersion);
+
+    if(valid)
+    {
+        m_Header.particles        = getU32(bytes + 8);
+        m_Header.frames           = getU32(bytes + 12);
+        m_Header.keyFrameInterval = getU32(bytes + 16);
+        m_Header.step             = getF32(bytes + 20);
+        m_Header.timestep         = getF32(bytes + 24);
+        m_Header.config           = getU32(bytes + 28);
+        m_Header.indexOffset      = getU64(bytes + 32);
+
+        // A file that was never closed has no index
+        valid = (m_Header.indexOffset != 0) &&
+                (std::fseek(mpFile, long(m_Header.indexOffset), SEEK_SET) == 0) &&
+                (std::fread(bytes, 1, 8, mpFile) == 8) &&
+                (getU32(bytes) == kIndexTag) &&
+                (getU32(bytes + 4) == m_Header.frames);
+    }
+
+    if(valid)
+    {
+        std::vector<uint8_t> index(size_t(m_Header.frames) * kEntrySize);
+
+        valid = (std::fread(index.data(), 1, index.size(), mpFile) == index.size());
+
+        m_Offsets.resize(m_Header.frames);
+        m_Times.resize(m_Header.frames);
+
+        for(size_t i = 0; valid && i < m_Header.frames; ++i)
+        {
+            m_Offsets[i] = getU64(&index[i * kEntrySize]);
+            m_Times[i]   = getF32(&index[i * kEntrySize + 8]);
+        }
+    }
+
+    if(!valid)
+    {
+        close();
+    }
+
+    return valid;
+}
+
+void NBody::Snapshot::Reader::close()
+{
+    if(mpFile)
+    {
+        std::fclose(mpFile);
+
+        mpFile = nullptr;
+    }
+
+    m_Offsets.clear();
+    m_Times.clear();
+    m_Before.clear();
+    m_Quantised.clear();
+
+    mnCurrent = -1;
+}
+
+const NBody::Snapshot::Header& NBody::Snapshot::Reader::header() const
+{
+    return m_Header;
+}
+
+uint32_t NBody::Snapshot::Reader::frames() const
+{
+    return uint32_t(m_Offsets.size());
+}
+
+float NBody::Snapshot::Reader::time(const uint32_t& frame) const
+{
+    return (frame < m_Times.size()) ? m_Times[frame] : 0.0f;
+}
+
+bool NBody::Snapshot::Reader::read(const uint32_t& frame, CPU::float4* pPositions)
+{
+    if(!mpFile || frame >= m_Offsets.size())
+    {
+        return false;
+    }
+
+    if(int64_t(frame) != mnCurrent)
+    {
+        // Carry on from the frame before, or start over from the key frame
+        const uint32_t key = frame - (frame % m_Header.keyFrameInterval);
+
+        const uint32_t first = (mnCurrent >= 0 && int64_t(frame) == mnCurrent + 1) ? frame : key;
+
+        mnCurrent = -1;
+
+        for(uint32_t i = first; i <= frame; ++i)
+        {
+            bool isKey = false;
+
+            if(!chunk(i, isKey) || (i == key && !isKey))
+            {
+                return false;
+            }
+        }
+
+        mnCurrent = frame;
+    }
+
+    const double step = m_Header.step;
+
+    for(size_t i = 0; i < m_Header.particles; ++i)
+    {
+        pPositions[i].x = float(double(m_Quantised[3 * i + 0]) * step);
+        pPositions[i].y = float(double(m_Quantised[3 * i + 1]) * step);
+        pPositions[i].z = float(double(m_Quantised[3 * i + 2]) * step);
+        pPositions[i].w = 1.0f;
+    }
+
+    return true;
+}
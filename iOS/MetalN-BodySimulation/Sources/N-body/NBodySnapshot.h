@@ -0,0 +1,191 @@
+/*
+ See LICENSE.txt for this sample’s licensing information
+
+ Abstract:
+ Streaming snapshot files for N-body trajectories. Positions are quantised to a fixed step and
+ written one chunk per frame: key frames hold the quantised values, the frames between hold the
+ residual from a prediction made of the frames before, both as zigzag varints per axis. An index
+ of chunk offsets closes the file, so any frame is read by decoding from the key frame at or
+ before it. The writer encodes and writes on its own thread from two staging buffers, so a
+ simulation handing it frames only waits when it gets a whole frame ahead of the disk.
+
+ File layout, little endian:
+     Header  "NBSS", version, particles, frames, key frame interval, quantisation step,
+             timestep, config, index offset
+     Chunk   "FRAM", frame, time, flags, payload bytes, payload
+     Index   "INDX", frames, then per frame its chunk's offset and time
+
+ Flags are 1 for a key frame, 2 when the prediction extrapolates the two frames before; otherwise
+ the prediction is the frame before.
+ */
+
+#ifndef _NBODY_SNAPSHOT_H_
+#define _NBODY_SNAPSHOT_H_
+
+#ifdef __cplusplus
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "NBodySimulator.h"
+
+namespace NBody
+{
+    namespace Snapshot
+    {
+        static const uint32_t kVersion = 1;
+
+        struct Header
+        {
+            uint32_t particles;
+            uint32_t frames;
+            uint32_t keyFrameInterval;  // A key frame every so many frames
+            float    step;              // Quantisation step, in simulation units
+            float    timestep;
+            uint32_t config;
+            uint64_t indexOffset;
+        };
+
+        // Encode a frame's positions quantised by step. With a prediction the payload holds the
+        // residuals, otherwise the values themselves. rQuantised gets this frame's quantised values.
+        void encode(const CPU::float4* pPositions,
+                    const size_t& count,
+                    const float& step,
+                    const std::vector<int64_t>* pPrediction,
+                    std::vector<int64_t>& rQuantised,
+                    std::vector<uint8_t>& rPayload);
+
+        // Decode a payload into rQuantised, adding the prediction it was encoded against if there
+        // was one. Returns false for a truncated or overlong payload.
+        bool decode(const uint8_t* pPayload,
+                    const size_t& bytes,
+                    const size_t& count,
+                    const std::vector<int64_t>* pPrediction,
+                    std::vector<int64_t>& rQuantised);
+
+        class Writer
+        {
+        public:
+            Writer();
+
+            // Closes the file
+            virtual ~Writer();
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            // Header's frames and index offset are filled in on close
+            bool open(const std::string& path, const Header& header);
+
+            // Copy a frame's positions into a staging buffer, waiting only while both buffers
+            // are still being written. False once a write has failed.
+            bool append(const CPU::float4* pPositions, const float& time);
+
+            // Write the remaining frames, the index and the final header
+            bool close();
+
+            uint32_t frames() const;
+
+            // Bytes written so far
+            uint64_t bytes() const;
+
+            // Seconds append() spent waiting for a staging buffer
+            double stalled() const;
+
+        private:
+            struct Staging
+            {
+                std::vector<CPU::float4> positions;
+                uint32_t                 frame;
+                float                    time;
+                bool                     full;
+            };
+
+            struct Entry
+            {
+                uint64_t offset;
+                float    time;
+            };
+
+            void run();
+            bool write(const Staging& rStaging);
+
+        private:
+            std::FILE*               mpFile;
+            Header                   m_Header;
+            std::thread              m_Thread;
+
+            mutable std::mutex       m_Mutex;
+            std::condition_variable  m_Condition;
+            Staging                  m_Staging[2];
+            size_t                   mnFill;        // Buffer append() fills next
+            size_t                   mnDrain;       // Buffer the writer thread writes next
+            uint32_t                 mnFrames;      // Frames appended
+            bool                     mbClosing;
+            bool                     mbFailed;
+            double                   mnStalled;
+            uint64_t                 mnWritten;     // Bytes of the chunks written so far
+
+            // Writer thread only
+            std::vector<int64_t>     m_Before;
+            std::vector<int64_t>     m_Previous;
+            std::vector<int64_t>     m_Prediction;
+            std::vector<int64_t>     m_Quantised;
+            std::vector<uint8_t>     m_Chunk;
+            std::vector<uint8_t>     m_Payload;
+            std::vector<Entry>       m_Index;
+            uint64_t                 mnOffset;
+        }; // Class Writer
+
+        class Reader
+        {
+        public:
+            Reader();
+
+            virtual ~Reader();
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            // Reads the header and the index
+            bool open(const std::string& path);
+
+            void close();
+
+            const Header& header() const;
+
+            uint32_t frames() const;
+
+            float time(const uint32_t& frame) const;
+
+            // Positions of any frame, with unit mass in w. Reading the frame after the last one
+            // read only decodes that frame; anything else decodes from the key frame before it.
+            bool read(const uint32_t& frame, CPU::float4* pPositions);
+
+        private:
+            bool chunk(const uint32_t& frame, bool& rKey);
+
+        private:
+            std::FILE*             mpFile;
+            Header                 m_Header;
+            std::vector<uint64_t>  m_Offsets;
+            std::vector<float>     m_Times;
+            std::vector<int64_t>   m_Before;
+            std::vector<int64_t>   m_Quantised;
+            std::vector<int64_t>   m_Prediction;
+            std::vector<int64_t>   m_Decoded;
+            std::vector<uint8_t>   m_Payload;
+            int64_t                mnCurrent;      // Frame m_Quantised holds, -1 for none
+        }; // Class Reader
+    } // Snapshot
+} // NBody
+
+#endif
+
+#endif